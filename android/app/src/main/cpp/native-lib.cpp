@@ -4,14 +4,15 @@
 #include <unordered_map>
 #include <mutex>
 #include <thread>
-#include <queue>
-#include <condition_variable>
 #include <android/log.h>
 
 // Include cross-platform terminal core
 #include "../../../../../src/core/terminal_engine.h"
 #include "../../../../../src/hardware/android/android_hardware.h"
 #include "../../../../../src/platform/android/android_platform.h"
+#include "../../../../../src/core/session_manager.h"
+#include "../../../../../src/memory/lock_free_queue.h"
+#include "../../../../../src/memory/memory_budget.h"
 
 #define LOG_TAG "CrossTerminal"
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
@@ -24,19 +25,40 @@ static std::unordered_map<jlong, std::unique_ptr<TerminalEngine>> g_engines;
 static std::mutex g_engines_mutex;
 static jlong g_next_handle = 1;
 
+// Output chunk handed from reactor threads to nativeGetOutput
+struct OutputChunk : cross_terminal::memory::MpscNode {
+    std::string text;
+};
+
 // Session management
 struct TerminalSession {
     int sessionId;
     std::unique_ptr<TerminalSession> session;
-    std::queue<std::string> outputBuffer;
-    std::mutex outputMutex;
-    std::condition_variable outputCondition;
+    std::shared_ptr<cross_terminal::core::IShell> shell;
+    int foregroundPid = -1;
+    // Reactor threads push without locking; the only consumer is
+    // nativeGetOutput, serialized by g_sessions_mutex
+    cross_terminal::memory::MpscQueue<OutputChunk> outputBuffer;
     bool isActive = true;
+    
+    ~TerminalSession() {
+        while (OutputChunk* chunk = outputBuffer.pop()) {
+            delete chunk;
+        }
+    }
 };
 
 static std::unordered_map<jlong, std::unordered_map<int, std::unique_ptr<TerminalSession>>> g_sessions;
 static std::mutex g_sessions_mutex;
 
+// All sessions of all engines share one reactor and worker pool
+static cross_terminal::core::SessionManager& sessionManager() {
+    static cross_terminal::core::SessionManager manager;
+    static std::once_flag init_flag;
+    std::call_once(init_flag, []() { manager.initialize(); });
+    return manager;
+}
+
 extern "C" {
 
 JNIEXPORT jlong JNICALL
@@ -76,19 +98,38 @@ Java_com_crossplatform_terminal_terminal_TerminalController_nativeInitialize(JNI
 JNIEXPORT void JNICALL
 Java_com_crossplatform_terminal_terminal_TerminalController_nativeDestroy(JNIEnv *env, jclass clazz, jlong handle) {
     try {
-        std::lock_guard<std::mutex> lock(g_engines_mutex);
-        
-        auto it = g_engines.find(handle);
-        if (it != g_engines.end()) {
-            it->second->cleanup();
-            g_engines.erase(it);
-            LOGD("Terminal engine destroyed: %lld", handle);
+        {
+            std::lock_guard<std::mutex> lock(g_engines_mutex);
+            auto it = g_engines.find(handle);
+            if (it != g_engines.end()) {
+                it->second->cleanup();
+                g_engines.erase(it);
+                LOGD("Terminal engine destroyed: %lld", handle);
+            }
         }
         
-        // Clean up sessions
+        // Taken out under the lock and closed after it: closing waits up to
+        // the shutdown grace period, which must not block the other calls
+        std::unordered_map<int, std::unique_ptr<TerminalSession>> sessions;
         {
             std::lock_guard<std::mutex> sessions_lock(g_sessions_mutex);
-            g_sessions.erase(handle);
+            auto handle_it = g_sessions.find(handle);
+            if (handle_it != g_sessions.end()) {
+                sessions = std::move(handle_it->second);
+                g_sessions.erase(handle_it);
+            }
+        }
+        if (!sessions.empty()) {
+            std::vector<int> sessionIds;
+            for (auto& [id, session] : sessions) {
+                sessionIds.push_back(session->sessionId);
+            }
+            // Output callbacks hold raw TerminalSession pointers: drain
+            // them before the sessions are freed
+            auto report = sessionManager().closeSessions(sessionIds);
+            LOGD("Closed %zu sessions: %zu processes, %zu exited, %zu killed in %llu us",
+                 sessionIds.size(), report.processes, report.exited, report.killed,
+                 static_cast<unsigned long long>(report.duration_us));
         }
         
     } catch (const std::exception& e) {
@@ -107,13 +148,17 @@ Java_com_crossplatform_terminal_terminal_TerminalController_nativeCreateSession(
             return -1;
         }
         
-        // Create new session
-        static int next_session_id = 1;
-        int sessionId = next_session_id++;
+        // Create new session on the shared runtime (no new threads)
+        int sessionId = sessionManager().createSession();
+        if (sessionId < 0) {
+            LOGE("Failed to create shell session for handle: %lld", handle);
+            return -1;
+        }
         
         std::lock_guard<std::mutex> sessions_lock(g_sessions_mutex);
         auto session = std::make_unique<TerminalSession>();
         session->sessionId = sessionId;
+        session->shell = sessionManager().getSession(sessionId);
         session->isActive = true;
         
         g_sessions[handle][sessionId] = std::move(session);
@@ -144,20 +189,25 @@ Java_com_crossplatform_terminal_terminal_TerminalController_nativeExecuteCommand
         std::string cmd_str(cmd_chars);
         env->ReleaseStringUTFChars(command, cmd_chars);
         
-        // Execute command through terminal engine
-        std::string output;
-        bool success = engine_it->second->executeCommand(cmd_str, output);
-        
-        // Store output in session buffer
+        // Execute command in the session shell; output arrives on the
+        // shared reactor and is queued for nativeGetOutput
+        bool success = false;
         {
             std::lock_guard<std::mutex> sessions_lock(g_sessions_mutex);
             auto& sessions = g_sessions[handle];
             auto session_it = sessions.find(sessionId);
             
-            if (session_it != sessions.end()) {
-                std::lock_guard<std::mutex> output_lock(session_it->second->outputMutex);
-                session_it->second->outputBuffer.push(output);
-                session_it->second->outputCondition.notify_one();
+            if (session_it != sessions.end() && session_it->second->shell) {
+                TerminalSession* session = session_it->second.get();
+                int pid = session->shell->executeAsync(cmd_str, cross_terminal::core::ExecutionOptions(),
+                    [session](const std::string& output, bool) {
+                        auto* chunk = new OutputChunk();
+                        chunk->text = output;
+                        session->outputBuffer.push(chunk);
+                    },
+                    nullptr);
+                session->foregroundPid = pid;
+                success = pid > 0;
             }
         }
         
@@ -187,8 +237,17 @@ Java_com_crossplatform_terminal_terminal_TerminalController_nativeSendInput(JNIE
         std::string input_str(input_chars);
         env->ReleaseStringUTFChars(input, input_chars);
         
-        // Send input to terminal engine
-        bool success = engine_it->second->sendInput(input_str);
+        // Send input to the session's foreground process
+        bool success = false;
+        {
+            std::lock_guard<std::mutex> sessions_lock(g_sessions_mutex);
+            auto& sessions = g_sessions[handle];
+            auto session_it = sessions.find(sessionId);
+            if (session_it != sessions.end() && session_it->second->shell) {
+                success = session_it->second->shell->sendInput(
+                    session_it->second->foregroundPid, input_str);
+            }
+        }
         
         LOGD("Sent input: %s, success: %d", input_str.c_str(), success);
         return success ? JNI_TRUE : JNI_FALSE;
@@ -217,12 +276,10 @@ Java_com_crossplatform_terminal_terminal_TerminalController_nativeGetOutput(JNIE
             return env->NewStringUTF("");
         }
         
-        std::lock_guard<std::mutex> output_lock(session_it->second->outputMutex);
-        
         std::string combined_output;
-        while (!session_it->second->outputBuffer.empty()) {
-            combined_output += session_it->second->outputBuffer.front();
-            session_it->second->outputBuffer.pop();
+        while (OutputChunk* chunk = session_it->second->outputBuffer.pop()) {
+            combined_output += chunk->text;
+            delete chunk;
         }
         
         return env->NewStringUTF(combined_output.c_str());
@@ -289,4 +346,18 @@ Java_com_crossplatform_terminal_terminal_TerminalController_nativeGetHardwareInf
     }
 }
 
+JNIEXPORT void JNICALL
+Java_com_crossplatform_terminal_terminal_TerminalController_nativeOnTrimMemory(JNIEnv *env, jclass clazz,
+                                                                              jint level) {
+    try {
+        auto& budget = cross_terminal::memory::MemoryBudget::instance();
+        const size_t before = budget.total_usage();
+        budget.on_trim_memory(level);
+        LOGD("onTrimMemory(%d): %zu bytes accounted before shrink", level, before);
+        
+    } catch (const std::exception& e) {
+        LOGE("Exception in nativeOnTrimMemory: %s", e.what());
+    }
+}
+
 } // extern "C"
\ No newline at end of file
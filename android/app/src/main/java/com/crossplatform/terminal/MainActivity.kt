@@ -333,6 +333,11 @@ class MainActivity : AppCompatActivity() {
         terminalController.onPause()
     }
     
+    override fun onTrimMemory(level: Int) {
+        super.onTrimMemory(level)
+        terminalController.onTrimMemory(level)
+    }
+    
     override fun onDestroy() {
         super.onDestroy()
         terminalController.cleanup()
@@ -55,6 +55,9 @@ class TerminalController(private val context: Context) {
         @JvmStatic
         external fun nativeGetHardwareInfo(handle: Long): String
         
+        @JvmStatic
+        external fun nativeOnTrimMemory(level: Int)
+        
         // Native library loading disabled for initial build
         // init {
         //     System.loadLibrary("cross-terminal")
@@ -291,6 +294,15 @@ class TerminalController(private val context: Context) {
         // Pause terminal operations to save battery
     }
     
+    /**
+     * Forward system memory pressure so native caches shrink before we are killed
+     */
+    fun onTrimMemory(level: Int) {
+        if (isInitialized.get()) {
+            nativeOnTrimMemory(level)
+        }
+    }
+    
     /**
      * Cleanup resources
      */
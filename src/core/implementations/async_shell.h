@@ -0,0 +1,368 @@
+#pragma once
+
+#include "core/implementations/command_operation.h"
+
+/**
+ * @file async_shell.h
+ * @brief Awaitable (C++20 coroutine) front-end for IShell
+ *
+ * Lets command sequences, pipelines of decisions and timeouts be written
+ * as straight-line code instead of nested callbacks:
+ *
+ * @code
+ * Task<void> deploy(AsyncShell& shell) {
+ *     auto build = co_await shell.run("make", ExecutionOptions(), 60000);
+ *     if (!build.succeeded()) co_return;
+ *     auto log = shell.lines("tail -n 20 build.log");
+ *     while (auto line = co_await log.next()) { ... }
+ * }
+ * @endcode
+ *
+ * Coroutines are resumed on reactor threads and never block one; the
+ * callback-based IShell API is untouched. The header is empty unless the
+ * translation unit is compiled as C++20 or later, so the C++17 build of the
+ * project is unaffected. CommandOperation offers the same behaviour with
+ * plain continuations.
+ */
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace cross_terminal {
+namespace core {
+
+template<typename T = void>
+class Task;
+
+namespace detail {
+
+// Resumes whoever awaited the task, or returns to the resumer
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        std::coroutine_handle<> continuation = handle.promise().continuation_;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation_;
+    std::exception_ptr exception_;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+    void rethrowIfFailed() const {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value_;
+
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U&& value) { value_.emplace(std::forward<U>(value)); }
+
+    T result() {
+        rethrowIfFailed();
+        return std::move(*value_);
+    }
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+    void result() const { rethrowIfFailed(); }
+};
+
+// Fire-and-forget coroutine that frees itself when it finishes
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+/**
+ * @brief Lazily started coroutine producing a T
+ *
+ * Starts when awaited (or handed to spawn()/syncWait()) and resumes its
+ * awaiter by symmetric transfer, so long chains do not grow the stack.
+ * Exceptions propagate to the awaiter.
+ */
+template<typename T>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { reset(); }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+                handle.promise().continuation_ = awaiter;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().result(); }
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    friend promise_type;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    void reset() noexcept {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = {};
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+/**
+ * @brief Start a task without waiting for it
+ * @note Runs on the calling thread until its first suspension; an
+ *       exception escaping the task terminates the program
+ */
+inline void spawn(Task<void> task) {
+    [](Task<void> owned) -> detail::DetachedTask {
+        co_await std::move(owned);
+    }(std::move(task));
+}
+
+/**
+ * @brief Block the calling thread until a task finishes
+ * @warning Never call from a reactor thread: the task needs the reactor
+ *          to make progress
+ */
+template<typename T>
+T syncWait(Task<T> task) {
+    std::promise<T> promise;
+    std::future<T> future = promise.get_future();
+    [](Task<T> owned, std::promise<T>& done) -> detail::DetachedTask {
+        try {
+            if constexpr (std::is_void<T>::value) {
+                co_await std::move(owned);
+                done.set_value();
+            } else {
+                done.set_value(co_await std::move(owned));
+            }
+        } catch (...) {
+            done.set_exception(std::current_exception());
+        }
+    }(std::move(task), promise);
+    return future.get();
+}
+
+/**
+ * @brief Awaitable wrapper around a shell and its reactor
+ *
+ * @thread_safe Yes; each awaitable must be awaited by one coroutine
+ */
+class AsyncShell {
+public:
+    /**
+     * @brief Awaitable result of run()
+     */
+    class CommandAwaiter {
+    public:
+        explicit CommandAwaiter(std::shared_ptr<CommandOperation> operation)
+            : operation_(std::move(operation)) {}
+
+        bool await_ready() const { return operation_->isDone(); }
+
+        void await_suspend(std::coroutine_handle<> awaiter) {
+            operation_->onComplete([awaiter]() { awaiter.resume(); });
+        }
+
+        CommandResult await_resume() { return operation_->takeResult(); }
+
+        /// @brief Kill the command before it is awaited
+        void cancel() { operation_->cancel(); }
+
+    private:
+        std::shared_ptr<CommandOperation> operation_;
+    };
+
+    /**
+     * @brief Output of a running command, one line at a time
+     *
+     * Destroying the stream before the command finished kills it.
+     */
+    class LineStream {
+    public:
+        explicit LineStream(std::shared_ptr<CommandOperation> operation)
+            : operation_(std::move(operation)) {}
+
+        LineStream(LineStream&&) noexcept = default;
+        LineStream& operator=(LineStream&&) = delete;
+
+        ~LineStream() {
+            if (operation_) {
+                operation_->cancel();
+            }
+        }
+
+        /**
+         * @brief Next stdout/stderr line, std::nullopt once the command exited
+         */
+        Task<std::optional<std::string>> next() {
+            for (;;) {
+                // Check for completion first: the final partial line is
+                // queued before the operation is marked done
+                const bool done = operation_->isDone();
+                std::string line;
+                if (operation_->takeLine(line)) {
+                    co_return line;
+                }
+                if (done) {
+                    co_return std::nullopt;
+                }
+                co_await LineAwaiter{operation_.get()};
+            }
+        }
+
+        /// @brief Exit status; meaningful once next() returned std::nullopt
+        CommandResult result() { return operation_->takeResult(); }
+
+    private:
+        struct LineAwaiter {
+            CommandOperation* operation;
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> awaiter) {
+                operation->onLineOrComplete([awaiter]() { awaiter.resume(); });
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        std::shared_ptr<CommandOperation> operation_;
+    };
+
+    /**
+     * @brief Awaitable reactor timer
+     */
+    class SleepAwaiter {
+    public:
+        SleepAwaiter(IoReactor& reactor, uint32_t delay_ms)
+            : reactor_(reactor), delay_ms_(delay_ms) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> awaiter) {
+            reactor_.schedule(delay_ms_, [awaiter]() { awaiter.resume(); });
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        IoReactor& reactor_;
+        uint32_t delay_ms_;
+    };
+
+    /**
+     * @brief Constructor
+     * @param shell Shell running the commands, must outlive this object
+     * @param reactor Reactor resuming the coroutines
+     */
+    AsyncShell(IShell& shell, IoReactor& reactor) : shell_(shell), reactor_(reactor) {}
+
+    /**
+     * @brief Run a command; co_await yields its CommandResult
+     * @param timeout_ms Kill the command after this delay (0 = no timeout)
+     * @note The command starts immediately, not when awaited
+     */
+    CommandAwaiter run(const std::string& command,
+                       const ExecutionOptions& options = ExecutionOptions(),
+                       uint32_t timeout_ms = 0) {
+        return CommandAwaiter(CommandOperation::start(shell_, reactor_, command, options,
+                                                      timeout_ms,
+                                                      CommandOperation::OutputMode::Collect));
+    }
+
+    /**
+     * @brief Run a command and stream its output line by line
+     */
+    LineStream lines(const std::string& command,
+                     const ExecutionOptions& options = ExecutionOptions(),
+                     uint32_t timeout_ms = 0) {
+        return LineStream(CommandOperation::start(shell_, reactor_, command, options,
+                                                  timeout_ms,
+                                                  CommandOperation::OutputMode::Lines));
+    }
+
+    /// @brief Suspend for a delay without blocking a thread
+    SleepAwaiter sleep(uint32_t delay_ms) { return SleepAwaiter(reactor_, delay_ms); }
+
+    IShell& shell() noexcept { return shell_; }
+    IoReactor& reactor() noexcept { return reactor_; }
+
+private:
+    IShell& shell_;
+    IoReactor& reactor_;
+};
+
+} // namespace core
+} // namespace cross_terminal
+
+#endif // __cpp_impl_coroutine
@@ -0,0 +1,105 @@
+#include "builtin_job.h"
+#include <chrono>
+#include <csignal>
+
+namespace cross_terminal {
+namespace core {
+
+BuiltinJob::BuiltinJob(int id, std::string command, IShell::CompletionCallback completion)
+    : id_(id)
+    , command_(std::move(command))
+    , completion_(std::move(completion))
+    , state_(State::Queued)
+    , cancelled_(false)
+    , handler_calls_(0) {
+}
+
+bool BuiltinJob::begin() {
+    std::lock_guard lock(mutex_);
+    if (state_ != State::Queued) {
+        return false;
+    }
+    state_ = State::Running;
+    return true;
+}
+
+void BuiltinJob::setCancelHandler(std::function<void()> handler) {
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this]() { return handler_calls_ == 0; });
+    if (state_ == State::Completing || state_ == State::Done) {
+        return;
+    }
+    cancel_handler_ = std::move(handler);
+    if (cancel_handler_ && cancelled_) {
+        callHandler(lock, cancel_handler_);
+    }
+}
+
+void BuiltinJob::cancel() {
+    {
+        std::unique_lock lock(mutex_);
+        if (cancelled_) {
+            return;
+        }
+        cancelled_ = true;
+        if (state_ != State::Queued) {
+            if (cancel_handler_) {
+                callHandler(lock, cancel_handler_);
+            }
+            return;
+        }
+        state_ = State::Running;   // Claimed: begin() now fails
+    }
+
+    // Never started: nothing to stop, report it killed
+    ProcessInfo info;
+    info.pid = id_;
+    info.command = command_;
+    info.state = ProcessState::Terminated;
+    info.exit_code = SIGTERM;
+    info.start_time = info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    complete(info);
+}
+
+bool BuiltinJob::isCancelled() const {
+    std::lock_guard lock(mutex_);
+    return cancelled_;
+}
+
+void BuiltinJob::complete(const ProcessInfo& info) {
+    IShell::CompletionCallback completion;
+    {
+        std::lock_guard lock(mutex_);
+        if (state_ == State::Completing || state_ == State::Done) {
+            return;
+        }
+        state_ = State::Completing;
+        cancel_handler_ = nullptr;
+        completion = std::move(completion_);
+    }
+    if (completion) {
+        completion(info);
+    }
+    std::lock_guard lock(mutex_);
+    state_ = State::Done;
+    done_.notify_all();
+}
+
+void BuiltinJob::callHandler(std::unique_lock<std::mutex>& lock, const std::function<void()>& handler) {
+    const std::function<void()> call = handler;
+    ++handler_calls_;
+    lock.unlock();
+    call();
+    lock.lock();
+    --handler_calls_;
+    done_.notify_all();
+}
+
+void BuiltinJob::wait() {
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this]() { return state_ == State::Done; });
+}
+
+} // namespace core
+} // namespace cross_terminal
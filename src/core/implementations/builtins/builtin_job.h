@@ -0,0 +1,94 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * @file builtin_job.h
+ * @brief A builtin running as a job of its shell
+ *
+ * Long builtins (cp, mv, rm, find, du, onchange) run off the thread that
+ * called executeAsync(), under a job id from the shell's process ids.
+ * The job ties the three parties together: the worker or watch doing the
+ * work claims it and reports its result, kill cancels it through the
+ * handler the work installed, and shutdown waits for it to be complete.
+ * Most jobs complete when their builtin returns; onchange completes its
+ * own when the watch is stopped.
+ *
+ * @thread_safety All methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+class BuiltinJob : public std::enable_shared_from_this<BuiltinJob> {
+public:
+    /**
+     * @param id Job id, as returned by executeAsync()
+     * @param command Builtin name, reported if the job never runs
+     * @param completion Called once with the result, from whichever thread
+     *        completes the job
+     */
+    BuiltinJob(int id, std::string command, IShell::CompletionCallback completion);
+
+    // Non-copyable, non-movable
+    BuiltinJob(const BuiltinJob&) = delete;
+    BuiltinJob& operator=(const BuiltinJob&) = delete;
+
+    int id() const noexcept { return id_; }
+
+    /**
+     * @brief Claim the job to run it
+     * @return false if it was cancelled while queued (and is complete)
+     */
+    bool begin();
+
+    /**
+     * @brief Install the handler cancel() runs while the job runs
+     *
+     * Once a null handler is installed no call of the old one is still
+     * running, so the work may drop what it references. Runs the handler
+     * at once if the job was already cancelled.
+     */
+    void setCancelHandler(std::function<void()> handler);
+
+    /**
+     * @brief kill: stop the job
+     *
+     * A queued job completes at once as terminated; a running one is
+     * stopped through its cancel handler and completes when its work
+     * returns.
+     */
+    void cancel();
+    bool isCancelled() const;
+
+    /// @brief Report the result; only the first report counts
+    void complete(const ProcessInfo& info);
+
+    /// @brief Block until the completion callback has returned
+    void wait();
+
+private:
+    enum class State { Queued, Running, Completing, Done };
+
+    const int id_;
+    const std::string command_;
+    IShell::CompletionCallback completion_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable done_;
+    State state_;
+    bool cancelled_;
+    std::function<void()> cancel_handler_;
+    int handler_calls_;   // Running outside the lock; setCancelHandler() waits for them
+
+    // Call handler with the lock released, which lets it complete the job
+    void callHandler(std::unique_lock<std::mutex>& lock, const std::function<void()>& handler);
+};
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,116 @@
+#include "file_builtins.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+
+namespace cross_terminal {
+namespace core {
+namespace builtins {
+
+namespace {
+
+std::string formatProgress(const std::string& command, const FileOperationProgress& progress) {
+    char line[128];
+    snprintf(line, sizeof(line), "%s: %llu files, %llu directories, %.1f MiB\n", command.c_str(),
+             static_cast<unsigned long long>(progress.files),
+             static_cast<unsigned long long>(progress.directories),
+             static_cast<double>(progress.bytes) / (1024.0 * 1024.0));
+    return line;
+}
+
+} // namespace
+
+bool parseFileOperationArguments(const std::string& command, const ArgumentList& args,
+                                 FileOperationOptions& options,
+                                 std::vector<std::string>& operands) {
+    bool flags_done = false;
+    for (const auto& arg : args) {
+        if (flags_done || arg.size() < 2 || arg[0] != '-') {
+            operands.push_back(arg);
+            continue;
+        }
+        if (arg == "--") {
+            flags_done = true;
+            continue;
+        }
+        for (size_t i = 1; i < arg.size(); ++i) {
+            if ((arg[i] == 'r' || arg[i] == 'R') && command != "mv") {
+                options.recursive = true;
+            } else if (arg[i] == 'f') {
+                options.force = true;
+            } else {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+ProcessInfo runFileOperation(const std::string& command, const ArgumentList& args,
+                             FsContext& fs, std::shared_ptr<WorkStealingPool> pool,
+                             const IShell::OutputCallback& output, BuiltinJob* job) {
+    ProcessInfo info;
+    info.command = command;
+    info.arguments.assign(args.begin(), args.end());
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    auto emit = [&output](const std::string& text, bool is_error) {
+        if (output) {
+            output(text, is_error);
+        }
+    };
+    
+    FileOperationOptions file_options;
+    std::vector<std::string> operands;
+    bool cancelled = false;
+    parseFileOperationArguments(command, args, file_options, operands);
+    const size_t required = command == "rm" ? 1 : 2;
+    if (operands.size() < required) {
+        emit(command == "rm" ? "usage: rm [-rf] PATH...\n"
+                             : "usage: " + command + (command == "cp" ? " [-rf]" : " [-f]") +
+                                   " SOURCE... DESTINATION\n", true);
+        info.exit_code = 2;
+    } else {
+        // Progress goes to stderr, like a progress meter, while the walk runs
+        FileOperations operations(fs, file_options, std::move(pool));
+        if (job) {
+            job->setCancelHandler([&operations]() { operations.cancel(); });
+        }
+        auto progress = [&emit, &command](const FileOperationProgress& totals) {
+            emit(formatProgress(command, totals), true);
+        };
+        FileOperationResult result;
+        if (command == "rm") {
+            result = operations.remove(operands, progress);
+        } else {
+            const std::string destination = operands.back();
+            operands.pop_back();
+            result = command == "cp" ? operations.copy(operands, destination, progress)
+                                     : operations.move(operands, destination, progress);
+        }
+        if (job) {
+            job->setCancelHandler(nullptr);
+        }
+        for (const auto& error : result.errors) {
+            emit(command + ": " + error + "\n", true);
+        }
+        info.exit_code = result.succeeded() ? 0 : 1;
+        cancelled = result.cancelled;
+    }
+    
+    info.state = info.exit_code == 0 ? ProcessState::Completed : ProcessState::Failed;
+    if (cancelled) {
+        // Stopped by kill, reported like a process it terminated
+        info.state = ProcessState::Terminated;
+        info.exit_code = SIGTERM;
+    }
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    return info;
+}
+
+} // namespace builtins
+} // namespace core
+} // namespace cross_terminal
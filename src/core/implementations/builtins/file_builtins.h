@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+#include "core/implementations/builtins/builtin_job.h"
+#include "core/implementations/file_operations.h"
+#include "core/implementations/work_stealing_pool.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file file_builtins.h
+ * @brief cp, mv and rm on FileOperations
+ *
+ * Only the flags FileOperations implements are taken (-r/-R, -f); the
+ * shell leaves any other invocation to the external command.
+ *
+ * @thread_safety Stateless; one call per FileOperations walk
+ */
+
+namespace cross_terminal {
+namespace core {
+namespace builtins {
+
+inline bool isFileOperation(const std::string& command) noexcept {
+    return command == "cp" || command == "mv" || command == "rm";
+}
+
+/**
+ * @brief Split cp/mv/rm arguments into flags and operands
+ * @return false for a flag the builtins lack, left to the external command
+ */
+bool parseFileOperationArguments(const std::string& command, const ArgumentList& args,
+                                 FileOperationOptions& options,
+                                 std::vector<std::string>& operands);
+
+/**
+ * @brief cp [-rf] SOURCE... DESTINATION, mv [-f] ..., rm [-rf] PATH...
+ *
+ * Progress goes to stderr while the walk runs. With a job, kill cancels
+ * the walk and the result is reported as terminated by SIGTERM.
+ *
+ * @param fs Resolves the operands against the session directory
+ * @param pool Workers shared with the session's other file builtins
+ * @param job The job the builtin runs as, or null when run inline
+ */
+ProcessInfo runFileOperation(const std::string& command, const ArgumentList& args,
+                             FsContext& fs, std::shared_ptr<WorkStealingPool> pool,
+                             const IShell::OutputCallback& output, BuiltinJob* job);
+
+} // namespace builtins
+} // namespace core
+} // namespace cross_terminal
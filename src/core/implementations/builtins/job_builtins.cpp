@@ -0,0 +1,82 @@
+#include "job_builtins.h"
+#include <cctype>
+#include <ctime>
+#include <sstream>
+#include <stdexcept>
+
+namespace cross_terminal {
+namespace core {
+namespace builtins {
+
+int listJobHistory(const std::shared_ptr<JobHistory>& history, const ArgumentList& args,
+                   uint64_t now, const IShell::OutputCallback& output) {
+    auto emit = [&output](const std::string& text, bool is_error) {
+        if (output) {
+            output(text, is_error);
+        }
+    };
+    
+    JobQuery query;
+    query.limit = HISTORY_DEFAULT_LIMIT;
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        const bool has_value = i + 1 < args.size();
+        uint64_t duration = 0;
+        try {
+            if (arg == "--history") {
+                continue;
+            } else if (arg == "--failed") {
+                query.failed_only = true;
+            } else if (arg == "--since" && has_value && JobHistory::parseDuration(args[i + 1], duration)) {
+                query.since = now > duration ? now - duration : 0;
+                ++i;
+            } else if (arg == "--command" && has_value) {
+                query.command = args[++i];
+            } else if (arg == "--exit" && has_value) {
+                query.match_exit_code = true;
+                query.exit_code = std::stoi(args[++i]);
+            } else if (arg == "--limit" && has_value) {
+                // stoul would wrap "-1" around to an unlimited query
+                const std::string& value = args[++i];
+                if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0]))) {
+                    throw std::invalid_argument(value);
+                }
+                query.limit = std::stoul(value);
+            } else {
+                emit("jobs: invalid option: " + arg + "\n", true);
+                return 2;
+            }
+        } catch (const std::exception&) {
+            emit("jobs: invalid value for " + arg + "\n", true);
+            return 2;
+        }
+    }
+    
+    if (!history || !history->isOpen()) {
+        emit("jobs: job history is not enabled\n", true);
+        return 1;
+    }
+    
+    std::ostringstream listing;
+    for (const auto& job : history->query(query)) {
+        const time_t end_seconds = static_cast<time_t>(job.end_time / 1000);
+        struct tm local_time;
+        char timestamp[32] = "";
+        if (localtime_r(&end_seconds, &local_time)) {
+            strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &local_time);
+        }
+        
+        listing << timestamp << "  " << job.getDuration() << "ms  exit " << job.exit_code
+                << "  " << job.command;
+        for (const auto& argument : job.arguments) {
+            listing << ' ' << argument;
+        }
+        listing << '\n';
+    }
+    emit(listing.str(), false);
+    return 0;
+}
+
+} // namespace builtins
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+#include "core/implementations/job_history.h"
+#include <cstdint>
+#include <memory>
+
+/**
+ * @file job_builtins.h
+ * @brief jobs --history: queries of the archived job log
+ *
+ * @thread_safety Stateless; JobHistory is internally synchronized
+ */
+
+namespace cross_terminal {
+namespace core {
+namespace builtins {
+
+/// Jobs listed by jobs --history without --limit
+constexpr size_t HISTORY_DEFAULT_LIMIT = 50;
+
+/**
+ * @brief jobs --history [--failed] [--since DURATION] [--command NAME]
+ *                       [--exit CODE] [--limit N]
+ * @param history The shell's job log; null or closed when not enabled
+ * @param now Milliseconds since epoch that --since counts back from
+ * @return Exit code: 0, 1 without a history, 2 for invalid options
+ */
+int listJobHistory(const std::shared_ptr<JobHistory>& history, const ArgumentList& args,
+                   uint64_t now, const IShell::OutputCallback& output);
+
+} // namespace builtins
+} // namespace core
+} // namespace cross_terminal
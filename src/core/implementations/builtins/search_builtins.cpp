@@ -0,0 +1,243 @@
+#include "search_builtins.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <iterator>
+
+namespace cross_terminal {
+namespace core {
+namespace builtins {
+
+namespace {
+
+// "+n", "-n" or "n", with an optional unit suffix left in suffix
+bool parseComparison(const std::string& text, FindOptions::Compare& compare, uint64_t& value,
+                     std::string& suffix) {
+    size_t start = 0;
+    compare = FindOptions::Compare::Equal;
+    if (!text.empty() && (text[0] == '+' || text[0] == '-')) {
+        compare = text[0] == '+' ? FindOptions::Compare::Greater : FindOptions::Compare::Less;
+        start = 1;
+    }
+    size_t end = start;
+    while (end < text.size() && std::isdigit(static_cast<unsigned char>(text[end]))) {
+        ++end;
+    }
+    if (end == start || end - start > 18) {
+        return false;
+    }
+    value = std::stoull(text.substr(start, end - start));
+    suffix = text.substr(end);
+    return true;
+}
+
+bool parseDepth(const std::string& text, int& depth) {
+    if (text.empty() || text.size() > 9 ||
+        !std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        return false;
+    }
+    depth = std::stoi(text);
+    return true;
+}
+
+// du -h: 1023, 1.5K, 12M; rounded up, as du rounds
+std::string formatSize(uint64_t bytes) {
+    if (bytes < 1024) {
+        return std::to_string(bytes);
+    }
+    static const char units[] = "KMGTPE";
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    for (value /= 1024; value >= 1024 && unit + 1 < sizeof(units) - 1; value /= 1024) {
+        ++unit;
+    }
+    char text[32];
+    if (value < 10) {
+        snprintf(text, sizeof(text), "%.1f%c", std::ceil(value * 10) / 10, units[unit]);
+    } else {
+        snprintf(text, sizeof(text), "%.0f%c", std::ceil(value), units[unit]);
+    }
+    return text;
+}
+
+} // namespace
+
+bool parseFindArguments(const ArgumentList& args, std::vector<std::string>& roots, FindOptions& options) {
+    size_t i = 0;
+    for (; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        if (!arg.empty() && (arg[0] == '-' || arg == "(" || arg == "!")) {
+            break;
+        }
+        roots.push_back(arg);
+    }
+    if (roots.empty()) {
+        roots.push_back(".");
+    }
+    bool named = false;
+    bool sized = false;
+    bool aged = false;
+    bool typed = false;
+    for (; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        if (arg == "-print") {
+            continue;
+        }
+        if (i + 1 >= args.size()) {
+            return false;
+        }
+        const std::string& value = args[++i];
+        std::string suffix;
+        if ((arg == "-name" || arg == "-iname") && !named) {
+            options.name = value;
+            options.ignore_case = arg == "-iname";
+            named = true;
+        } else if (arg == "-type" && !typed && value.size() == 1) {
+            typed = true;
+            switch (value[0]) {
+                case 'f': options.type = FsEntryType::Regular; break;
+                case 'd': options.type = FsEntryType::Directory; break;
+                case 'l': options.type = FsEntryType::Symlink; break;
+                default: return false;
+            }
+        } else if (arg == "-size" && !sized &&
+                   parseComparison(value, options.size_compare, options.size, suffix)) {
+            sized = true;
+            static const std::pair<const char*, uint64_t> units[] = {
+                {"", 512}, {"b", 512}, {"c", 1}, {"w", 2}, {"k", 1024},
+                {"M", 1024 * 1024}, {"G", 1024 * 1024 * 1024}
+            };
+            auto unit = std::find_if(std::begin(units), std::end(units),
+                                     [&suffix](const auto& u) { return suffix == u.first; });
+            if (unit == std::end(units)) {
+                return false;
+            }
+            options.size_unit = unit->second;
+        } else if ((arg == "-mtime" || arg == "-mmin") && !aged &&
+                   parseComparison(value, options.age_compare, options.age, suffix) && suffix.empty()) {
+            aged = true;
+            options.age_unit_s = arg == "-mtime" ? 86400 : 60;
+        } else if (arg == "-mindepth" && parseDepth(value, options.min_depth)) {
+            continue;
+        } else if (arg == "-maxdepth" && parseDepth(value, options.max_depth)) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseDiskUsageArguments(const ArgumentList& args, std::vector<std::string>& roots,
+                             DiskUsageOptions& options, bool& human) {
+    bool flags_done = false;
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        if (flags_done || arg.size() < 2 || arg[0] != '-') {
+            roots.push_back(arg);
+        } else if (arg == "--") {
+            flags_done = true;
+        } else if (arg.compare(0, 12, "--max-depth=") == 0) {
+            if (!parseDepth(arg.substr(12), options.max_depth)) {
+                return false;
+            }
+        } else if (arg == "-d") {
+            if (i + 1 >= args.size() || !parseDepth(args[++i], options.max_depth)) {
+                return false;
+            }
+        } else {
+            for (size_t j = 1; j < arg.size(); ++j) {
+                switch (arg[j]) {
+                    case 'a': options.all = true; break;
+                    case 's': options.max_depth = 0; break;
+                    case 'h': human = true; break;
+                    case 'b': options.apparent_size = true; break;
+                    case 'k': break;
+                    default: return false;
+                }
+            }
+        }
+    }
+    if (roots.empty()) {
+        roots.push_back(".");
+    }
+    return true;
+}
+
+ProcessInfo runTreeSearch(const std::string& command, const ArgumentList& args,
+                          FsContext& fs, std::shared_ptr<WorkStealingPool> pool,
+                          const IShell::OutputCallback& output, BuiltinJob* job) {
+    ProcessInfo info;
+    info.command = command;
+    info.arguments.assign(args.begin(), args.end());
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    auto emit = [&output](const std::string& text, bool is_error) {
+        if (output) {
+            output(text, is_error);
+        }
+    };
+    
+    // Each batch of results is written as one chunk, from whichever
+    // worker filled it
+    TreeSearch search(fs, std::move(pool));
+    if (job) {
+        job->setCancelHandler([&search]() { search.cancel(); });
+    }
+    std::vector<std::string> roots;
+    TreeSearchResult result;
+    if (command == "find") {
+        FindOptions find_options;
+        parseFindArguments(args, roots, find_options);
+        result = search.find(roots, find_options, [&emit](const std::vector<std::string>& paths) {
+            std::string text;
+            for (const auto& path : paths) {
+                text += path;
+                text += '\n';
+            }
+            emit(text, false);
+        });
+    } else {
+        DiskUsageOptions usage_options;
+        bool human = false;
+        parseDiskUsageArguments(args, roots, usage_options, human);
+        const bool bytes = usage_options.apparent_size;
+        result = search.diskUsage(roots, usage_options,
+                                  [&emit, human, bytes](const std::vector<DiskUsageEntry>& usage) {
+            std::string text;
+            for (const auto& entry : usage) {
+                text += human ? formatSize(entry.bytes)
+                              : std::to_string(bytes ? entry.bytes : (entry.bytes + 1023) / 1024);
+                text += '\t';
+                text += entry.path;
+                text += '\n';
+            }
+            emit(text, false);
+        });
+    }
+    if (job) {
+        job->setCancelHandler(nullptr);
+    }
+    for (const auto& error : result.errors) {
+        emit(command + ": " + error + "\n", true);
+    }
+    info.exit_code = result.succeeded() ? 0 : 1;
+    
+    info.state = info.exit_code == 0 ? ProcessState::Completed : ProcessState::Failed;
+    if (result.cancelled) {
+        info.state = ProcessState::Terminated;
+        info.exit_code = SIGTERM;
+    }
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    return info;
+}
+
+} // namespace builtins
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+#include "core/implementations/builtins/builtin_job.h"
+#include "core/implementations/tree_search.h"
+#include "core/implementations/work_stealing_pool.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file search_builtins.h
+ * @brief find and du on TreeSearch
+ *
+ * Only the expressions TreeSearch evaluates are taken; the shell leaves
+ * any other invocation (-o, !, -exec, ...) to the external command.
+ *
+ * @thread_safety Stateless; one call per TreeSearch walk
+ */
+
+namespace cross_terminal {
+namespace core {
+namespace builtins {
+
+/**
+ * @brief find [root...] with -name, -iname, -type, -size, -mtime, -mmin,
+ *        -mindepth, -maxdepth and -print, each at most once
+ * @return false for anything else
+ */
+bool parseFindArguments(const ArgumentList& args, std::vector<std::string>& roots, FindOptions& options);
+
+/**
+ * @brief du [-ashbk] [-d N | --max-depth=N] [path...]
+ * @return false for other flags
+ */
+bool parseDiskUsageArguments(const ArgumentList& args, std::vector<std::string>& roots,
+                             DiskUsageOptions& options, bool& human);
+
+/**
+ * @brief find or du, streaming each batch of results as one chunk
+ *
+ * With a job, kill cancels the walk and the result is reported as
+ * terminated by SIGTERM.
+ *
+ * @param fs Resolves the roots against the session directory
+ * @param pool Workers shared with the session's other file builtins
+ * @param job The job the builtin runs as, or null when run inline
+ */
+ProcessInfo runTreeSearch(const std::string& command, const ArgumentList& args,
+                          FsContext& fs, std::shared_ptr<WorkStealingPool> pool,
+                          const IShell::OutputCallback& output, BuiltinJob* job);
+
+} // namespace builtins
+} // namespace core
+} // namespace cross_terminal
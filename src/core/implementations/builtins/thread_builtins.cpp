@@ -0,0 +1,55 @@
+#include "thread_builtins.h"
+#include "core/implementations/thread_registry.h"
+#include <chrono>
+
+namespace cross_terminal {
+namespace core {
+namespace builtins {
+
+ProcessInfo runThreads(const ArgumentList& args, const IShell::OutputCallback& output) {
+    ProcessInfo info;
+    info.command = "threads";
+    info.arguments.assign(args.begin(), args.end());
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    auto emit = [&output](const std::string& text, bool is_error) {
+        if (output) {
+            output(text, is_error);
+        }
+    };
+    
+    // threads                      print the layout
+    // threads set SETTING...       install role settings and re-apply them
+    auto& registry = ThreadRegistry::instance();
+    info.exit_code = 0;
+    if (!args.empty() && args[0] == "set") {
+        std::string spec;
+        for (size_t i = 1; i < args.size(); ++i) {
+            spec += args[i] + " ";
+        }
+        std::string invalid;
+        if (registry.configure(spec, &invalid)) {
+            registry.reapply();
+        } else {
+            emit("threads: invalid setting: " + invalid + "\n", true);
+            info.exit_code = 1;
+        }
+    } else if (!args.empty()) {
+        emit("usage: threads [set ROLE.KEY=VALUE...]\n", true);
+        info.exit_code = 2;
+    }
+    if (info.exit_code == 0) {
+        emit(registry.describe(), false);
+    }
+    
+    info.state = info.exit_code == 0 ? ProcessState::Completed : ProcessState::Failed;
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    return info;
+}
+
+} // namespace builtins
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+
+/**
+ * @file thread_builtins.h
+ * @brief threads: the ThreadRegistry layout and its role settings
+ *
+ * @thread_safety Stateless; ThreadRegistry is internally synchronized
+ */
+
+namespace cross_terminal {
+namespace core {
+namespace builtins {
+
+/**
+ * @brief threads [set ROLE.KEY=VALUE...]
+ *
+ * Prints the layout (CPU classes, then one line per thread); with set,
+ * first installs the settings and re-applies them to live threads.
+ */
+ProcessInfo runThreads(const ArgumentList& args, const IShell::OutputCallback& output);
+
+} // namespace builtins
+} // namespace core
+} // namespace cross_terminal
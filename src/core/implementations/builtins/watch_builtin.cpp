@@ -0,0 +1,281 @@
+#include "watch_builtin.h"
+#include "core/implementations/file_watcher.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <vector>
+
+namespace cross_terminal {
+namespace core {
+namespace builtins {
+
+namespace {
+
+// A word the command parser reads back unchanged
+std::string quoteWord(const std::string& word) {
+    const bool plain = !word.empty() && std::all_of(word.begin(), word.end(), [](unsigned char c) {
+        return std::isalnum(c) || std::strchr("_-./=:,+@%", c) != nullptr;
+    });
+    if (plain) {
+        return word;
+    }
+    std::string quoted = "'";
+    for (char c : word) {
+        quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+    }
+    return quoted + "'";
+}
+
+} // namespace
+
+// A command rerun whenever its watched paths change
+struct CommandWatches::Watch {
+    // Where every run writes: the onchange job's output until end() closes
+    // it, so no run writes to it once the job has completed
+    struct Output {
+        std::mutex mutex;
+        IShell::OutputCallback callback;   // Null once closed
+    };
+
+    std::unique_ptr<FileWatcher> watcher;
+    std::string command;
+    std::string directory;   // Session directory when the watch began
+    bool merge_stderr = false;
+    std::shared_ptr<Output> output;
+    std::shared_ptr<BuiltinJob> job;
+    uint64_t start_time = 0;
+
+    std::mutex mutex;
+    int running = -1;        // Shell pid of the current run
+    uint64_t runs = 0;
+    uint64_t finished = 0;   // Last run whose completion arrived
+    bool stopped = false;
+};
+
+CommandWatches::CommandWatches(IShell& shell, std::shared_ptr<IoReactor> reactor, Post post,
+                               EndRun end_run)
+    : shell_(shell)
+    , reactor_(std::move(reactor))
+    , post_(std::move(post))
+    , end_run_(std::move(end_run)) {
+}
+
+CommandWatches::~CommandWatches() {
+    stopAll();
+}
+
+ProcessInfo CommandWatches::start(const ArgumentList& args, FsContext& fs,
+                                  const std::string& directory, bool merge_stderr,
+                                  const IShell::OutputCallback& output, BuiltinJob* job) {
+    ProcessInfo info;
+    info.command = "onchange";
+    info.arguments.assign(args.begin(), args.end());
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    auto emit = [&output](const std::string& text, bool is_error) {
+        if (output) {
+            output(text, is_error);
+        }
+    };
+
+    // onchange [-s] [-d MS] PATH... -- COMMAND [ARG...]
+    FileWatchOptions watch_options;
+    std::vector<std::string> paths;
+    std::string command;
+    bool valid = true;
+    size_t i = 0;
+    for (; i < args.size() && args[i] != "--"; ++i) {
+        const std::string& arg = args[i];
+        if (arg == "-s") {
+            watch_options.recursive = false;
+        } else if (arg == "-d" && i + 1 < args.size() && !args[i + 1].empty() &&
+                   args[i + 1].size() < 7 &&
+                   std::all_of(args[i + 1].begin(), args[i + 1].end(),
+                               [](unsigned char c) { return std::isdigit(c); })) {
+            watch_options.debounce_ms = static_cast<uint32_t>(std::stoul(args[++i]));
+            watch_options.max_delay_ms = std::max(watch_options.max_delay_ms, watch_options.debounce_ms);
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            valid = false;
+        } else {
+            paths.push_back(fs.absolute(arg));
+        }
+    }
+    for (size_t j = i + 1; j < args.size(); ++j) {
+        command += (command.empty() ? "" : " ") + quoteWord(args[j]);
+    }
+
+    if (!valid || paths.empty() || command.empty()) {
+        emit("usage: onchange [-s] [-d MS] PATH... -- COMMAND [ARG...]\n", true);
+        info.exit_code = 2;
+    } else if (!reactor_ || !job) {
+        // The watch lives on the reactor and reruns on the workers, as a
+        // job of a shell on the runtime; a standalone shell has neither
+        emit("onchange: needs a shell on the session runtime\n", true);
+        info.exit_code = 1;
+    } else {
+        auto watch = std::make_shared<Watch>();
+        watch->watcher = std::make_unique<FileWatcher>(reactor_, watch_options);
+        watch->command = command;
+        watch->directory = directory;
+        watch->merge_stderr = merge_stderr;
+        watch->output = std::make_shared<Watch::Output>();
+        watch->output->callback = output;
+        watch->job = job->shared_from_this();
+        watch->start_time = info.start_time;
+
+        // Changes arrive on the reactor thread, which must not start
+        // processes: each rerun is handed to the workers
+        std::weak_ptr<Watch> weak = watch;
+        auto rerun = [this, weak]() {
+            if (auto current = weak.lock()) {
+                run(current);
+            }
+        };
+        auto post = [this, rerun]() { post_(rerun); };
+        int error = watch->watcher->start(paths, [post](const std::vector<std::string>&) { post(); });
+        if (error != 0) {
+            emit(std::string("onchange: cannot watch: ") + strerror(error) + "\n", true);
+            info.exit_code = 1;
+        } else {
+            const int id = job->id();
+            emit("onchange: job " + std::to_string(id) + " watching " +
+                 std::to_string(watch->watcher->getMetrics().watches) + " directories; kill " +
+                 std::to_string(id) + " to stop\n", true);
+            {
+                std::lock_guard lock(mutex_);
+                watches_[id] = watch;
+            }
+            // Like entr, run once up front
+            post();
+            // The job runs until the watch is stopped, by kill or shutdown
+            job->setCancelHandler([this, id]() { stop(id); });
+            info.pid = id;
+            info.state = ProcessState::Running;
+            return info;
+        }
+    }
+
+    info.state = info.exit_code == 0 ? ProcessState::Completed : ProcessState::Failed;
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    return info;
+}
+
+bool CommandWatches::stop(int id) noexcept {
+    std::shared_ptr<Watch> watch;
+    {
+        std::lock_guard lock(mutex_);
+        auto it = watches_.find(id);
+        if (it == watches_.end()) {
+            return false;
+        }
+        watch = std::move(it->second);
+        watches_.erase(it);
+    }
+    end(*watch, true);
+    return true;
+}
+
+void CommandWatches::stopAll() noexcept {
+    std::unordered_map<int, std::shared_ptr<Watch>> watches;
+    {
+        std::lock_guard lock(mutex_);
+        watches.swap(watches_);
+    }
+    for (auto& [id, watch] : watches) {
+        end(*watch, false);
+    }
+}
+
+void CommandWatches::run(const std::shared_ptr<Watch>& watch) {
+    uint64_t run;
+    int previous;
+    {
+        std::lock_guard lock(watch->mutex);
+        if (watch->stopped) {
+            return;
+        }
+        run = ++watch->runs;
+        previous = watch->running;
+        watch->running = -1;
+    }
+    if (previous >= 0) {
+        // Signalled, not awaited: the new run does not depend on the old
+        // one's exit
+        end_run_(previous);
+    }
+
+    ExecutionOptions options;
+    options.working_directory = watch->directory;
+    options.merge_stderr = watch->merge_stderr;
+    std::weak_ptr<Watch> weak = watch;
+    auto sink = watch->output;
+    auto output = [sink](const std::string& data, bool is_error) {
+        std::lock_guard lock(sink->mutex);
+        if (sink->callback) {
+            sink->callback(data, is_error);
+        }
+    };
+    int pid = shell_.executeAsync(watch->command, options, output, [weak, run](const ProcessInfo&) {
+        if (auto current = weak.lock()) {
+            std::lock_guard lock(current->mutex);
+            current->finished = std::max(current->finished, run);
+            if (current->runs == run) {
+                current->running = -1;
+            }
+        }
+    });
+
+    // Inline builtins complete before executeAsync() returns
+    {
+        std::lock_guard lock(watch->mutex);
+        if (!watch->stopped) {
+            if (watch->runs == run && watch->finished != run && pid >= 0) {
+                watch->running = pid;
+            }
+            return;
+        }
+    }
+    // Stopped while this run started: it outlives nothing
+    if (pid >= 0) {
+        shell_.terminateProcess(pid);
+    }
+}
+
+void CommandWatches::end(Watch& watch, bool end_run) noexcept {
+    watch.watcher->stop();
+
+    int running;
+    {
+        std::lock_guard lock(watch.mutex);
+        watch.stopped = true;
+        running = watch.running;
+        watch.running = -1;
+    }
+    if (end_run && running >= 0) {
+        end_run_(running);
+    }
+    {
+        std::lock_guard lock(watch.output->mutex);
+        watch.output->callback = nullptr;
+    }
+
+    // Reported like a process kill terminated
+    ProcessInfo info;
+    info.pid = watch.job->id();
+    info.command = "onchange";
+    info.state = ProcessState::Terminated;
+    info.exit_code = SIGTERM;
+    info.start_time = watch.start_time;
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    watch.job->complete(info);
+}
+
+} // namespace builtins
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+#include "core/implementations/builtins/builtin_job.h"
+#include "core/implementations/fs_context.h"
+#include "core/implementations/io_reactor.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @file watch_builtin.h
+ * @brief onchange: rerun a command whenever watched paths change
+ *
+ * Each watch runs as a builtin job until kill or shutdown stops it. The
+ * FileWatcher lives on the reactor; reruns go through the shell on the
+ * workers, each first ending the previous run's process group.
+ *
+ * @thread_safety All methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+namespace builtins {
+
+class CommandWatches {
+public:
+    // Runs a task on the workers, dropped once the shell is released
+    using Post = std::function<void(std::function<void()>)>;
+    // Signals a run's process group without waiting for it
+    using EndRun = std::function<void(int pid)>;
+
+    /**
+     * @param shell Runs each rerun; must outlive the watches
+     * @param reactor Hosts the watchers; null for a standalone shell,
+     *        where onchange is refused
+     */
+    CommandWatches(IShell& shell, std::shared_ptr<IoReactor> reactor, Post post, EndRun end_run);
+    ~CommandWatches();
+
+    CommandWatches(const CommandWatches&) = delete;
+    CommandWatches& operator=(const CommandWatches&) = delete;
+
+    /**
+     * @brief onchange [-s] [-d MS] PATH... -- COMMAND [ARG...]
+     *
+     * Watches under the job's id and runs the command once up front.
+     *
+     * @param fs Resolves the paths against the session directory
+     * @param directory Where every run starts
+     * @param job The job the watch runs as; null is refused
+     * @return Running with the job id, or the failure
+     */
+    ProcessInfo start(const ArgumentList& args, FsContext& fs, const std::string& directory,
+                      bool merge_stderr, const IShell::OutputCallback& output, BuiltinJob* job);
+
+    /**
+     * @brief Stop the watch of job id, ending its current run
+     * @return false if there is no such watch
+     */
+    bool stop(int id) noexcept;
+
+    // Stop every watch; their current runs are left to the caller
+    void stopAll() noexcept;
+
+private:
+    struct Watch;
+
+    // Start a run, first ending the previous one's process group
+    void run(const std::shared_ptr<Watch>& watch);
+    // Stop watching, close the output and complete the watch's job
+    void end(Watch& watch, bool end_run) noexcept;
+
+    IShell& shell_;
+    std::shared_ptr<IoReactor> reactor_;
+    Post post_;
+    EndRun end_run_;
+
+    std::unordered_map<int, std::shared_ptr<Watch>> watches_;
+    std::mutex mutex_;
+};
+
+} // namespace builtins
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,178 @@
+#include "callback_executor.h"
+#include <chrono>
+
+namespace cross_terminal {
+namespace core {
+
+namespace {
+
+// Executor whose callbacks run on this thread, so drain() cannot deadlock
+thread_local const CallbackExecutor* current_executor = nullptr;
+
+uint64_t steadyMicros() noexcept {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+CallbackExecutor::CallbackExecutor(std::shared_ptr<WorkerPool> workers, size_t max_pending_bytes)
+    : workers_(std::move(workers)), max_pending_bytes_(max_pending_bytes) {
+}
+
+bool CallbackExecutor::postOutput(const ChannelPtr& channel, const char* data, size_t size,
+                                  bool is_error) {
+    if (size == 0) {
+        return true;
+    }
+    chunks_.fetch_add(1, std::memory_order_relaxed);
+
+    std::unique_lock lock(mutex_);
+    Event* tail = queue_.empty() ? nullptr : &queue_.back();
+    if (tail && !tail->completion && tail->channel == channel && tail->is_error == is_error &&
+        tail->data.size() + size <= MAX_COALESCED_BYTES) {
+        // The consumer has not picked this chunk up yet: extend it
+        tail->data.append(data, size);
+        ++tail->chunks;
+    } else {
+        Event event;
+        event.channel = channel;
+        event.data.assign(data, size);
+        event.chunks = 1;
+        event.is_error = is_error;
+        queue_.push_back(std::move(event));
+    }
+
+    pending_bytes_ += size;
+    if (pending_bytes_ > peak_pending_bytes_.load(std::memory_order_relaxed)) {
+        peak_pending_bytes_.store(pending_bytes_, std::memory_order_relaxed);
+    }
+    const bool accepting = pending_bytes_ <= max_pending_bytes_;
+    schedule(lock);
+    return accepting;
+}
+
+void CallbackExecutor::postCompletion(const ChannelPtr& channel, const ProcessInfo& info) {
+    Event event;
+    event.channel = channel;
+    event.completion = std::make_unique<ProcessInfo>(info);
+
+    std::unique_lock lock(mutex_);
+    queue_.push_back(std::move(event));
+    schedule(lock);
+}
+
+void CallbackExecutor::awaitDrain(const ChannelPtr& channel) {
+    pauses_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard lock(mutex_);
+        if (pending_bytes_ > max_pending_bytes_ / 2) {
+            paused_.push_back(channel);
+            return;
+        }
+    }
+    if (channel->resume) {
+        channel->resume();
+    }
+}
+
+void CallbackExecutor::drain() {
+    if (current_executor == this) {
+        return;
+    }
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this]() { return queue_.empty() && !scheduled_; });
+}
+
+size_t CallbackExecutor::pendingBytes() const noexcept {
+    std::lock_guard lock(mutex_);
+    return pending_bytes_;
+}
+
+CallbackMetrics CallbackExecutor::getMetrics() const noexcept {
+    CallbackMetrics metrics;
+    metrics.chunks = chunks_.load(std::memory_order_relaxed);
+    metrics.invocations = invocations_.load(std::memory_order_relaxed);
+    metrics.bytes = bytes_.load(std::memory_order_relaxed);
+    metrics.completions = completions_.load(std::memory_order_relaxed);
+    metrics.pauses = pauses_.load(std::memory_order_relaxed);
+    metrics.peak_pending_bytes = peak_pending_bytes_.load(std::memory_order_relaxed);
+    metrics.duration_p50_us = durations_.percentile(50.0);
+    metrics.duration_p99_us = durations_.percentile(99.0);
+    metrics.duration_max_us = durations_.max();
+    return metrics;
+}
+
+void CallbackExecutor::schedule(std::unique_lock<std::mutex>& lock) {
+    if (scheduled_) {
+        return;
+    }
+    scheduled_ = true;
+    lock.unlock();
+
+    auto self = shared_from_this();
+    if (!workers_ || !workers_->submit([self]() { self->runBatch(); })) {
+        runBatch();
+    }
+}
+
+void CallbackExecutor::runBatch() {
+    std::deque<Event> batch;
+    {
+        std::lock_guard lock(mutex_);
+        batch.swap(queue_);
+    }
+
+    const CallbackExecutor* previous = current_executor;
+    current_executor = this;
+    for (auto& event : batch) {
+        invoke(event);
+        if (event.completion) {
+            continue;
+        }
+
+        std::vector<ChannelPtr> resumable;
+        {
+            std::lock_guard lock(mutex_);
+            pending_bytes_ -= event.data.size();
+            if (pending_bytes_ <= max_pending_bytes_ / 2) {
+                resumable.swap(paused_);
+            }
+        }
+        for (auto& channel : resumable) {
+            if (channel->resume) {
+                channel->resume();
+            }
+        }
+    }
+    current_executor = previous;
+
+    std::unique_lock lock(mutex_);
+    scheduled_ = false;
+    if (queue_.empty()) {
+        idle_.notify_all();
+        return;
+    }
+    // More arrived meanwhile: requeue behind the other consumers' batches
+    schedule(lock);
+}
+
+void CallbackExecutor::invoke(Event& event) {
+    const uint64_t start = steadyMicros();
+    if (event.completion) {
+        if (event.channel->completion) {
+            event.channel->completion(*event.completion);
+        }
+        completions_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        if (event.channel->output) {
+            event.channel->output(event.data, event.is_error);
+        }
+        invocations_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(event.data.size(), std::memory_order_relaxed);
+    }
+    durations_.record(steadyMicros() - start);
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+#include "core/implementations/worker_pool.h"
+#include "core/utils/latency_histogram.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file callback_executor.h
+ * @brief Delivers process callbacks off the I/O path
+ *
+ * Output and completion callbacks are queued by the reactor threads and
+ * invoked on the shared WorkerPool, one batch at a time per executor, so
+ * a slow consumer never delays reading from a child. Chunks queued for
+ * the same process and stream while the consumer is busy are coalesced
+ * into a single invocation. The queue is bounded in bytes: past the limit
+ * the producer stops reading the pipe until the consumer catches up, so
+ * the backpressure reaches the child instead of growing memory.
+ *
+ * @performance One worker task per batch, one invocation per coalesced run
+ * @thread_safety All public methods are thread-safe; callbacks of one
+ *                executor run one at a time, in posting order
+ */
+
+namespace cross_terminal {
+namespace core {
+
+/**
+ * @brief Snapshot of callback delivery metrics
+ */
+struct CallbackMetrics {
+    uint64_t chunks = 0;            ///< Output chunks posted
+    uint64_t invocations = 0;       ///< Output callback invocations
+    uint64_t bytes = 0;             ///< Output bytes delivered
+    uint64_t completions = 0;       ///< Completion callbacks delivered
+    uint64_t pauses = 0;            ///< Times a producer was paused by the byte limit
+    uint64_t peak_pending_bytes = 0;
+    uint64_t duration_p50_us = 0;   ///< Time spent inside callbacks
+    uint64_t duration_p99_us = 0;
+    uint64_t duration_max_us = 0;
+};
+
+/**
+ * @brief Per-consumer callback queue drained on a worker pool
+ */
+class CallbackExecutor : public std::enable_shared_from_this<CallbackExecutor> {
+public:
+    static constexpr size_t DEFAULT_MAX_PENDING_BYTES = 1024 * 1024;
+    static constexpr size_t MAX_COALESCED_BYTES = 64 * 1024;   // Below malloc's mmap threshold
+
+    /**
+     * @brief Callbacks of one process
+     *
+     * `resume` is invoked (on a worker thread) when a producer paused by
+     * the byte limit may read again.
+     */
+    struct Channel {
+        IShell::OutputCallback output;
+        IShell::CompletionCallback completion;
+        std::function<void()> resume;
+    };
+
+    using ChannelPtr = std::shared_ptr<Channel>;
+
+    /**
+     * @brief Constructor
+     * @param workers Pool running the callbacks (null: invoke inline)
+     * @param max_pending_bytes Queued output above which producers pause
+     */
+    explicit CallbackExecutor(std::shared_ptr<WorkerPool> workers,
+                              size_t max_pending_bytes = DEFAULT_MAX_PENDING_BYTES);
+
+    // Non-copyable, non-movable
+    CallbackExecutor(const CallbackExecutor&) = delete;
+    CallbackExecutor& operator=(const CallbackExecutor&) = delete;
+    CallbackExecutor(CallbackExecutor&&) = delete;
+    CallbackExecutor& operator=(CallbackExecutor&&) = delete;
+
+    /**
+     * @brief Queue output for a channel's output callback
+     * @return false if the byte limit is exceeded; the producer should stop
+     *         reading and call awaitDrain()
+     * @thread_safe Yes
+     * @performance O(1), appends to the previous chunk when possible
+     */
+    bool postOutput(const ChannelPtr& channel, const char* data, size_t size, bool is_error);
+
+    /**
+     * @brief Queue a channel's completion callback, after its output
+     * @thread_safe Yes
+     */
+    void postCompletion(const ChannelPtr& channel, const ProcessInfo& info);
+
+    /**
+     * @brief Call channel->resume once queued output fell below half the limit
+     *
+     * Called by a producer after it stopped reading; resumes immediately if
+     * the queue already drained in the meantime.
+     *
+     * @thread_safe Yes
+     */
+    void awaitDrain(const ChannelPtr& channel);
+
+    /**
+     * @brief Wait until every queued callback has run
+     * @thread_safe Yes - returns immediately when called from a callback
+     */
+    void drain();
+
+    /// @brief Bytes of output waiting for delivery
+    size_t pendingBytes() const noexcept;
+
+    /// @brief Current delivery metrics
+    CallbackMetrics getMetrics() const noexcept;
+
+private:
+    struct Event {
+        ChannelPtr channel;
+        std::string data;
+        std::unique_ptr<ProcessInfo> completion;   ///< Set for completion events
+        uint32_t chunks = 0;
+        bool is_error = false;
+    };
+
+    std::shared_ptr<WorkerPool> workers_;
+    const size_t max_pending_bytes_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable idle_;
+    std::deque<Event> queue_;
+    std::vector<ChannelPtr> paused_;
+    size_t pending_bytes_ = 0;
+    bool scheduled_ = false;
+
+    std::atomic<uint64_t> chunks_{0};
+    std::atomic<uint64_t> invocations_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> completions_{0};
+    std::atomic<uint64_t> pauses_{0};
+    std::atomic<uint64_t> peak_pending_bytes_{0};
+    LatencyHistogram durations_;
+
+    void schedule(std::unique_lock<std::mutex>& lock);
+    void runBatch();
+    void invoke(Event& event);
+};
+
+} // namespace core
+} // namespace cross_terminal
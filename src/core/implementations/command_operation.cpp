@@ -0,0 +1,173 @@
+#include "command_operation.h"
+
+namespace cross_terminal {
+namespace core {
+
+CommandOperation::CommandOperation(IShell& shell, IoReactor& reactor, OutputMode mode)
+    : shell_(shell), reactor_(reactor), mode_(mode) {
+}
+
+std::shared_ptr<CommandOperation> CommandOperation::start(IShell& shell, IoReactor& reactor,
+                                                          const std::string& command,
+                                                          const ExecutionOptions& options,
+                                                          uint32_t timeout_ms,
+                                                          OutputMode mode) {
+    std::shared_ptr<CommandOperation> operation(new CommandOperation(shell, reactor, mode));
+
+    // The callbacks keep the operation alive until the process is done.
+    // Builtins complete inline, before executeAsync() returns.
+    int pid = shell.executeAsync(command, options,
+        [operation](const std::string& output, bool is_error) {
+            operation->append(output, is_error);
+        },
+        [operation](const ProcessInfo& info) {
+            operation->complete(info, true);
+        });
+
+    if (pid < 0) {
+        operation->complete(ProcessInfo(), false);
+        return operation;
+    }
+
+    std::lock_guard lock(operation->mutex_);
+    operation->pid_ = pid;
+    if (timeout_ms > 0 && !operation->done_) {
+        std::weak_ptr<CommandOperation> weak = operation;
+        operation->timer_ = reactor.schedule(timeout_ms, [weak]() {
+            if (auto expired = weak.lock()) {
+                expired->expire();
+            }
+        });
+    }
+    return operation;
+}
+
+bool CommandOperation::isDone() const {
+    std::lock_guard lock(mutex_);
+    return done_;
+}
+
+int CommandOperation::pid() const {
+    std::lock_guard lock(mutex_);
+    return pid_;
+}
+
+void CommandOperation::onComplete(Continuation continuation) {
+    std::unique_lock lock(mutex_);
+    if (done_) {
+        lock.unlock();
+        reactor_.post(std::move(continuation));
+        return;
+    }
+    waiter_ = std::move(continuation);
+    waiter_wants_lines_ = false;
+}
+
+void CommandOperation::onLineOrComplete(Continuation continuation) {
+    std::unique_lock lock(mutex_);
+    if (done_ || !lines_.empty()) {
+        lock.unlock();
+        reactor_.post(std::move(continuation));
+        return;
+    }
+    waiter_ = std::move(continuation);
+    waiter_wants_lines_ = true;
+}
+
+bool CommandOperation::takeLine(std::string& line) {
+    std::lock_guard lock(mutex_);
+    if (lines_.empty()) {
+        return false;
+    }
+    line = std::move(lines_.front());
+    lines_.pop_front();
+    return true;
+}
+
+CommandResult CommandOperation::takeResult() {
+    std::lock_guard lock(mutex_);
+    return std::move(result_);
+}
+
+void CommandOperation::cancel() {
+    int pid;
+    {
+        std::lock_guard lock(mutex_);
+        if (done_ || pid_ < 0) {
+            return;
+        }
+        pid = pid_;
+    }
+    shell_.terminateProcess(pid, true);
+}
+
+void CommandOperation::append(const std::string& output, bool is_error) {
+    std::unique_lock lock(mutex_);
+    if (mode_ == OutputMode::Collect) {
+        (is_error ? result_.error_output : result_.output) += output;
+        return;
+    }
+
+    partial_line_ += output;
+    size_t start = 0;
+    size_t newline;
+    while ((newline = partial_line_.find('\n', start)) != std::string::npos) {
+        lines_.emplace_back(partial_line_, start, newline - start);
+        start = newline + 1;
+    }
+    if (start == 0) {
+        return;
+    }
+    partial_line_.erase(0, start);
+    if (waiter_wants_lines_) {
+        wake(lock);
+    }
+}
+
+void CommandOperation::complete(const ProcessInfo& info, bool started) {
+    std::unique_lock lock(mutex_);
+    if (done_) {
+        return;
+    }
+    done_ = true;
+    result_.info = info;
+    result_.started = started;
+    if (!partial_line_.empty()) {
+        lines_.push_back(std::move(partial_line_));
+        partial_line_.clear();
+    }
+
+    const IoReactor::TimerId timer = timer_;
+    timer_ = 0;
+    wake(lock);
+    if (timer != 0) {
+        reactor_.cancel(timer);
+    }
+}
+
+void CommandOperation::expire() {
+    int pid;
+    {
+        std::lock_guard lock(mutex_);
+        if (done_) {
+            return;
+        }
+        result_.timed_out = true;
+        pid = pid_;
+    }
+    shell_.terminateProcess(pid, true);
+}
+
+void CommandOperation::wake(std::unique_lock<std::mutex>& lock) {
+    Continuation waiter = std::move(waiter_);
+    waiter_ = nullptr;
+    lock.unlock();
+    if (waiter) {
+        // Never resume on the shell's callback stack: the waiter may
+        // start new commands or destroy this operation
+        reactor_.post(std::move(waiter));
+    }
+}
+
+} // namespace core
+} // namespace cross_terminal
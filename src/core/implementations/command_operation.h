@@ -0,0 +1,146 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+#include "core/implementations/io_reactor.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * @file command_operation.h
+ * @brief Shared state of one asynchronous command run
+ *
+ * Bridges the IShell callbacks, which fire on reactor threads, to a single
+ * waiter that is resumed through the reactor once the command produced a
+ * line or finished. It is the building block of the awaitable shell API
+ * (async_shell.h) and can be used directly with continuations in C++17.
+ *
+ * @performance No thread per command: waiting costs one registered
+ *              continuation, timeouts are reactor timers
+ * @thread_safety All public methods are thread-safe; at most one waiter
+ *                may be registered at a time
+ */
+
+namespace cross_terminal {
+namespace core {
+
+/**
+ * @brief Outcome of an asynchronous command
+ */
+struct CommandResult {
+    ProcessInfo info;          ///< Final process state and exit code
+    std::string output;        ///< Captured stdout (not filled in line mode)
+    std::string error_output;  ///< Captured stderr (not filled in line mode)
+    bool started = false;      ///< False if the shell rejected the command
+    bool timed_out = false;    ///< Killed because the timeout expired
+
+    /// @brief Started, not timed out and exited with status 0
+    bool succeeded() const noexcept {
+        return started && !timed_out && info.state == ProcessState::Completed &&
+               info.exit_code == 0;
+    }
+};
+
+/**
+ * @brief One command started through IShell::executeAsync
+ */
+class CommandOperation : public std::enable_shared_from_this<CommandOperation> {
+public:
+    /// @brief Resumption callback, always invoked on a reactor thread
+    using Continuation = std::function<void()>;
+
+    /// @brief How output is delivered to the waiter
+    enum class OutputMode {
+        Collect,   ///< Accumulate into CommandResult::output / error_output
+        Lines      ///< Split stdout and stderr into lines for takeLine()
+    };
+
+    /**
+     * @brief Start a command
+     * @param shell Shell running the command, must outlive the operation
+     * @param reactor Reactor resuming waiters and running the timeout
+     * @param command Command line
+     * @param options Execution options
+     * @param timeout_ms Kill the process after this delay (0 = no timeout)
+     * @param mode Output delivery mode
+     * @return Operation, already finished if the shell rejected the command
+     * @thread_safe Yes
+     */
+    static std::shared_ptr<CommandOperation> start(IShell& shell, IoReactor& reactor,
+                                                   const std::string& command,
+                                                   const ExecutionOptions& options = ExecutionOptions(),
+                                                   uint32_t timeout_ms = 0,
+                                                   OutputMode mode = OutputMode::Collect);
+
+    // Non-copyable, non-movable
+    CommandOperation(const CommandOperation&) = delete;
+    CommandOperation& operator=(const CommandOperation&) = delete;
+    CommandOperation(CommandOperation&&) = delete;
+    CommandOperation& operator=(CommandOperation&&) = delete;
+
+    /// @brief Whether the process has finished (or never started)
+    bool isDone() const;
+
+    /// @brief Shell process id, -1 if the command was rejected
+    int pid() const;
+
+    /**
+     * @brief Resume once the command has finished
+     * @param continuation Posted to the reactor, immediately if already done
+     * @thread_safe Yes
+     */
+    void onComplete(Continuation continuation);
+
+    /**
+     * @brief Resume once a line is available or the command has finished
+     * @param continuation Posted to the reactor, immediately if ready
+     * @thread_safe Yes
+     */
+    void onLineOrComplete(Continuation continuation);
+
+    /**
+     * @brief Take the next complete output line (without its newline)
+     * @return false if no line is buffered
+     * @thread_safe Yes
+     */
+    bool takeLine(std::string& line);
+
+    /**
+     * @brief Move the result out; valid once isDone()
+     * @thread_safe Yes
+     */
+    CommandResult takeResult();
+
+    /**
+     * @brief Kill the process; the operation completes as usual
+     * @thread_safe Yes
+     */
+    void cancel();
+
+private:
+    CommandOperation(IShell& shell, IoReactor& reactor, OutputMode mode);
+
+    void append(const std::string& output, bool is_error);
+    void complete(const ProcessInfo& info, bool started);
+    void expire();
+    void wake(std::unique_lock<std::mutex>& lock);
+
+    IShell& shell_;
+    IoReactor& reactor_;
+    const OutputMode mode_;
+
+    mutable std::mutex mutex_;
+    CommandResult result_;
+    bool done_ = false;
+    int pid_ = -1;
+    IoReactor::TimerId timer_ = 0;
+    std::string partial_line_;
+    std::deque<std::string> lines_;
+    Continuation waiter_;
+    bool waiter_wants_lines_ = false;
+};
+
+} // namespace core
+} // namespace cross_terminal
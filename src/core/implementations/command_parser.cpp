@@ -0,0 +1,251 @@
+#include "command_parser.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace cross_terminal {
+namespace core {
+
+CommandParser::TokenPool CommandParser::token_pool_;
+
+namespace {
+
+bool isOperatorChar(char c) noexcept {
+    return c == '|' || c == '&' || c == ';' || c == '<' || c == '>';
+}
+
+bool isNameChar(char c, bool first) noexcept {
+    return c == '_' || std::isalpha(static_cast<unsigned char>(c)) ||
+           (!first && std::isdigit(static_cast<unsigned char>(c)));
+}
+
+// Words without quotes, escapes or variables are used as-is
+bool needsExpansion(const std::string& word) noexcept {
+    return word.find_first_of("$'\"\\") != std::string::npos;
+}
+
+// Only plain words are globbed; quoting a pattern keeps it literal
+bool isGlobPattern(const std::string& word) noexcept {
+    return !needsExpansion(word) && word.find_first_of("*?[") != std::string::npos;
+}
+
+} // namespace
+
+CommandParser::TokenList CommandParser::tokenize(const std::string& command) const {
+    TokenList tokens;
+    const size_t length = command.size();
+    size_t i = 0;
+    
+    while (i < length) {
+        const char c = command[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+            continue;
+        }
+        
+        const size_t start = i;
+        if (isOperatorChar(c)) {
+            const bool doubled = i + 1 < length && command[i + 1] == c;
+            switch (c) {
+                case '|':
+                    tokens.emplace_back(doubled ? TokenType::Or : TokenType::Pipe,
+                                        doubled ? "||" : "|", start);
+                    break;
+                case '&':
+                    tokens.emplace_back(doubled ? TokenType::And : TokenType::Background,
+                                        doubled ? "&&" : "&", start);
+                    break;
+                case ';':
+                    tokens.emplace_back(TokenType::Semicolon, ";", start);
+                    break;
+                case '<':
+                    tokens.emplace_back(TokenType::Redirect, "<", start);
+                    break;
+                default:
+                    tokens.emplace_back(TokenType::Redirect, doubled ? ">>" : ">", start);
+                    break;
+            }
+            i += (doubled && c != ';' && c != '<') ? 2 : 1;
+            continue;
+        }
+        
+        // Word: runs to the first unquoted blank or operator. Quotes and
+        // escapes stay in the token, parse() resolves them after expansion
+        char quote = 0;
+        while (i < length) {
+            const char ch = command[i];
+            if (quote == '\'') {
+                if (ch == '\'') quote = 0;
+            } else if (ch == '\\' && i + 1 < length) {
+                ++i;
+            } else if (quote == '"') {
+                if (ch == '"') quote = 0;
+            } else if (ch == '\'' || ch == '"') {
+                quote = ch;
+            } else if (std::isspace(static_cast<unsigned char>(ch)) || isOperatorChar(ch)) {
+                break;
+            }
+            ++i;
+        }
+        tokens.emplace_back(TokenType::Word, command.substr(start, i - start), start);
+    }
+    
+    return tokens;
+}
+
+bool CommandParser::isQuoted(const std::string& str) const noexcept {
+    return str.size() >= 2 && (str.front() == '\'' || str.front() == '"') &&
+           str.back() == str.front();
+}
+
+std::string CommandParser::removeQuotes(const std::string& str) const {
+    std::string result;
+    result.reserve(str.size());
+    
+    char quote = 0;
+    for (size_t i = 0; i < str.size(); ++i) {
+        const char c = str[i];
+        if (quote == '\'') {
+            if (c == '\'') quote = 0;
+            else result += c;
+        } else if (quote == '"') {
+            if (c == '"') {
+                quote = 0;
+            } else if (c == '\\' && i + 1 < str.size() &&
+                       std::strchr("$`\"\\", str[i + 1]) != nullptr) {
+                result += str[++i];
+            } else {
+                result += c;
+            }
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+        } else if (c == '\\' && i + 1 < str.size()) {
+            result += str[++i];
+        } else {
+            result += c;
+        }
+    }
+    
+    return result;
+}
+
+std::string CommandParser::expandVariables(const std::string& str, const Environment& env) const {
+    std::string result;
+    result.reserve(str.size());
+    
+    char quote = 0;
+    for (size_t i = 0; i < str.size(); ++i) {
+        const char c = str[i];
+        if (quote == '\'') {
+            if (c == '\'') quote = 0;
+            result += c;
+            continue;
+        }
+        if (c == '\\' && i + 1 < str.size()) {
+            result += c;
+            result += str[++i];
+            continue;
+        }
+        if (c == '\'' || c == '"') {
+            if (quote == 0 && c == '\'') quote = c;
+            else if (c == '"') quote = quote ? 0 : c;
+            result += c;
+            continue;
+        }
+        if (c != '$' || i + 1 >= str.size()) {
+            result += c;
+            continue;
+        }
+        
+        // $NAME or ${NAME}; anything else is a literal dollar sign
+        const bool braced = str[i + 1] == '{';
+        size_t name_start = i + (braced ? 2 : 1);
+        size_t name_end = name_start;
+        while (name_end < str.size() && isNameChar(str[name_end], name_end == name_start)) {
+            ++name_end;
+        }
+        if (name_end == name_start || (braced && (name_end >= str.size() || str[name_end] != '}'))) {
+            result += c;
+            continue;
+        }
+        
+        // Escape the value so removeQuotes() keeps it literal
+        const char* special = quote ? "$`\"\\" : "$`\"\\'";
+        for (char v : env.get(str.substr(name_start, name_end - name_start))) {
+            if (std::strchr(special, v) != nullptr) {
+                result += '\\';
+            }
+            result += v;
+        }
+        i = braced ? name_end : name_end - 1;
+    }
+    
+    return result;
+}
+
+ParsedCommand CommandParser::parse(const std::string& command,
+                                              const Environment& env,
+                                              FsContext* fs) const {
+    ParsedCommand result;
+    TokenList tokens = tokenize(command);
+    
+    auto word = [&](Token& token) {
+        return needsExpansion(token.value) ? removeQuotes(expandVariables(token.value, env))
+                                           : std::move(token.value);
+    };
+    
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        Token& token = tokens[i];
+        switch (token.type) {
+            case TokenType::Word:
+                if (result.executable.empty()) {
+                    result.executable = word(token);
+                } else if (fs && isGlobPattern(token.value)) {
+                    auto matches = fs->glob(token.value);
+                    if (matches.empty()) {
+                        result.arguments.push_back(std::move(token.value));
+                    }
+                    for (auto& match : matches) {
+                        result.arguments.push_back(std::move(match));
+                    }
+                } else {
+                    result.arguments.push_back(word(token));
+                }
+                break;
+                
+            default:
+                // Pipelines, command lists, redirections and '&' need a real
+                // shell; reject them rather than run the command without them
+                return ParsedCommand();
+        }
+    }
+    
+    return result;
+}
+
+std::vector<std::string> CommandParser::getCompletions(const std::string& partial_command,
+                                                       const Environment& env,
+                                                       FsContext& fs) const {
+    (void)env;
+    
+    // The word being completed runs from the last blank to the end
+    size_t start = partial_command.find_last_of(" \t");
+    start = start == std::string::npos ? 0 : start + 1;
+    const std::string word = partial_command.substr(start);
+    const bool first_word = partial_command.find_first_not_of(" \t") >= start;
+    
+    if (first_word && word.find('/') == std::string::npos) {
+        std::vector<std::string> candidates;
+        for (const char* builtin : BUILTIN_COMMANDS) {
+            if (std::strncmp(builtin, word.c_str(), word.size()) == 0) {
+                candidates.emplace_back(builtin);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        return candidates;
+    }
+    return fs.complete(word);
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+#include "core/implementations/fs_context.h"
+#include "memory/memory_manager.h"
+#include "memory/small_vector.h"
+#include <string>
+#include <vector>
+
+/**
+ * @file command_parser.h
+ * @brief Tokenizing, expansion and completion of simple shell commands
+ *
+ * @thread_safety All methods are const and thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+/// Commands ShellImpl runs itself; completed like executables
+inline constexpr const char* BUILTIN_COMMANDS[] = {
+    "cd", "pwd", "echo", "exit", "export", "jobs", "kill", "help", "threads",
+    "cp", "mv", "rm", "find", "du", "onchange"
+};
+
+/**
+ * @brief A simple command: the executable and its expanded arguments
+ */
+struct ParsedCommand {
+    std::string executable;
+    ArgumentList arguments;
+    
+    bool isValid() const noexcept {
+        return !executable.empty();
+    }
+};
+
+/**
+ * @brief Command parser utility
+ * 
+ * Parses shell command strings into structured command objects:
+ * quoting, escapes and variable expansion on simple commands.
+ */
+class CommandParser {
+private:
+    using TokenPool = memory::MemoryPool<std::string, 256>;
+    static TokenPool token_pool_;
+    
+    enum class TokenType {
+        Word,
+        Pipe,
+        Redirect,
+        Background,
+        Semicolon,
+        And,
+        Or
+    };
+    
+    struct Token {
+        TokenType type;
+        std::string value;
+        size_t position;
+        
+        Token(TokenType t, std::string v, size_t pos)
+            : type(t), value(std::move(v)), position(pos) {}
+    };
+    
+    // Typical commands fit inline: no allocation beyond long words
+    using TokenList = memory::SmallVector<Token, 8>;
+    
+    TokenList tokenize(const std::string& command) const;
+    bool isQuoted(const std::string& str) const noexcept;
+    std::string removeQuotes(const std::string& str) const;
+    std::string expandVariables(const std::string& str, const Environment& env) const;
+    
+public:
+    /**
+     * @brief Parse command string into structured representation
+     * @param command Command string to parse
+     * @param env Environment for variable expansion
+     * @param fs When set, unquoted arguments with * ? or [ are expanded
+     *           against it; a pattern without matches stays literal
+     * @return Parsed command structure
+     * @thread_safe Yes
+     * @performance O(n) where n is command length
+     */
+    ParsedCommand parse(const std::string& command,
+                        const Environment& env,
+                        FsContext* fs = nullptr) const;
+    
+    /**
+     * @brief Validate command syntax
+     * @param command Command string to validate
+     * @return true if syntax is valid
+     * @thread_safe Yes
+     * @performance O(n) where n is command length
+     */
+    bool validate(const std::string& command) const noexcept;
+    
+    /**
+     * @brief Get completion suggestions for partial command
+     * @param partial_command Incomplete command string
+     * @param env Environment for context
+     * @param fs Filesystem context paths are completed against
+     * @return Vector of completion suggestions
+     * @thread_safe Yes
+     * @performance One directory listing for path completions
+     */
+    std::vector<std::string> getCompletions(const std::string& partial_command,
+                                          const Environment& env,
+                                          FsContext& fs) const;
+};
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,105 @@
+#include "core/interfaces/i_shell.h"
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <string_view>
+
+#ifdef _WIN32
+#include <stdlib.h>
+#define environ _environ
+#else
+#include <unistd.h>
+extern char** environ;
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+// Lookups go through StringInterner::find(): a name that was never
+// interned cannot be a key, and a miss must not create an entry
+
+void Environment::set(const std::string& name, const std::string& value) {
+    memory::InternedString key(name);
+    std::unique_lock lock(mutex_);
+    variables_.insert_or_assign(std::move(key), value);
+}
+
+std::string Environment::get(const std::string& name) const {
+    auto key = memory::StringInterner::instance().find(name);
+    if (key.empty()) {
+        return "";
+    }
+    std::shared_lock lock(mutex_);
+    auto it = variables_.find(key);
+    return it != variables_.end() ? it->second : std::string();
+}
+
+bool Environment::has(const std::string& name) const noexcept {
+    auto key = memory::StringInterner::instance().find(name);
+    if (key.empty()) {
+        return false;
+    }
+    std::shared_lock lock(mutex_);
+    return variables_.find(key) != variables_.end();
+}
+
+bool Environment::remove(const std::string& name) {
+    auto key = memory::StringInterner::instance().find(name);
+    if (key.empty()) {
+        return false;
+    }
+    std::unique_lock lock(mutex_);
+    return variables_.erase(key) > 0;
+}
+
+std::vector<std::pair<std::string, std::string>> Environment::getAll() const {
+    std::vector<std::pair<std::string, std::string>> all;
+    {
+        std::shared_lock lock(mutex_);
+        all.reserve(variables_.size());
+        for (const auto& [name, value] : variables_) {
+            all.emplace_back(name.str(), value);
+        }
+    }
+    // The map is ordered by entry address; callers list by name
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+void Environment::clear() {
+    std::unique_lock lock(mutex_);
+    variables_.clear();
+}
+
+void Environment::exportToSystem() const {
+    std::shared_lock lock(mutex_);
+    for (const auto& [name, value] : variables_) {
+#ifdef _WIN32
+        _putenv_s(name.c_str(), value.c_str());
+#else
+        setenv(name.c_str(), value.c_str(), 1);
+#endif
+    }
+}
+
+void Environment::importFromSystem() {
+    // Interned outside the lock: interning takes the interner's shard locks
+    std::vector<std::pair<memory::InternedString, std::string>> imported;
+    for (char** entry = environ; entry && *entry; ++entry) {
+        std::string_view variable(*entry);
+        const size_t equals = variable.find('=');
+        // Windows keeps per-drive directories as "=C:=C:\..."; skip them
+        if (equals == std::string_view::npos || equals == 0) {
+            continue;
+        }
+        imported.emplace_back(variable.substr(0, equals), std::string(variable.substr(equals + 1)));
+    }
+
+    std::unique_lock lock(mutex_);
+    for (auto& [name, value] : imported) {
+        variables_.insert_or_assign(std::move(name), std::move(value));
+    }
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,637 @@
+#include "file_operations.h"
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/syscall.h>
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+namespace {
+
+// Per copy_file_range() call; also how often a large copy updates progress
+constexpr size_t COPY_CHUNK = 8 * 1024 * 1024;
+// read()/write() fallback buffer, on the worker's stack
+constexpr size_t BUFFER_SIZE = 64 * 1024;
+// Files unlinked per rm task: enough to amortize the task, few enough to spread
+constexpr size_t REMOVE_BATCH = 128;
+
+class Fd {
+public:
+    explicit Fd(int fd) : fd_(fd) {}
+    ~Fd() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+    Fd(const Fd&) = delete;
+    Fd& operator=(const Fd&) = delete;
+    int get() const noexcept { return fd_; }
+private:
+    int fd_;
+};
+using FdPtr = std::shared_ptr<Fd>;
+
+// Counts the outstanding entries of a directory; whoever finishes the
+// last one runs done() and then releases the parent directory
+struct Pending {
+    std::atomic<size_t> remaining{1};
+    std::function<void()> done;
+    std::shared_ptr<Pending> parent;
+};
+using PendingPtr = std::shared_ptr<Pending>;
+
+void release(PendingPtr node) {
+    while (node && node->remaining.fetch_sub(1) == 1) {
+        if (node->done) {
+            node->done();
+        }
+        node = node->parent;
+    }
+}
+
+std::string join(const std::string& directory, const std::string& name) {
+    if (directory.empty()) {
+        return name;
+    }
+    return directory.back() == '/' ? directory + name : directory + "/" + name;
+}
+
+std::string parentOf(const std::string& absolute) {
+    size_t slash = absolute.rfind('/');
+    return slash == 0 || slash == std::string::npos ? std::string("/") : absolute.substr(0, slash);
+}
+
+std::string baseName(const std::string& absolute) {
+    return absolute.substr(absolute.rfind('/') + 1);
+}
+
+// The path as the user wrote it, without trailing slashes
+std::string displayPath(const std::string& path) {
+    size_t end = path.find_last_not_of('/');
+    return end == std::string::npos ? path : path.substr(0, end + 1);
+}
+
+FdPtr openDirectory(FsContext& fs, const std::string& path) {
+    int fd = fs.openFile(path, O_RDONLY | O_DIRECTORY);
+    return fd < 0 ? nullptr : std::make_shared<Fd>(fd);
+}
+
+// Contents of in to out, cheapest method first; 0 or an errno value
+int copyContents(int in, int out, uint64_t size, bool& cloned, std::atomic<uint64_t>& bytes) {
+#ifdef FICLONE
+    if (size > 0 && ioctl(out, FICLONE, in) == 0) {
+        cloned = true;
+        bytes.fetch_add(size, std::memory_order_relaxed);
+        return 0;
+    }
+#endif
+#ifdef SYS_copy_file_range
+    // Only for files that report a size: procfs and sysfs files claim 0
+    // bytes, and copy_file_range() copies nothing from them
+    if (size > 0) {
+        uint64_t copied = 0;
+        for (;;) {
+            long n = syscall(SYS_copy_file_range, in, nullptr, out, nullptr, COPY_CHUNK, 0);
+            if (n > 0) {
+                copied += static_cast<uint64_t>(n);
+                bytes.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+                continue;
+            }
+            if (n == 0 && copied > 0) {
+                return 0;
+            }
+            if (n < 0 && copied > 0) {
+                return errno;
+            }
+            if (n < 0 && errno != EXDEV && errno != ENOSYS && errno != EINVAL &&
+                errno != EOPNOTSUPP && errno != EBADF) {
+                return errno;
+            }
+            break;   // Unsupported here, nothing written yet: fall back
+        }
+    }
+#endif
+    char buffer[BUFFER_SIZE];
+    for (;;) {
+        ssize_t n = ::read(in, buffer, BUFFER_SIZE);
+        if (n == 0) {
+            return 0;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        for (ssize_t written = 0; written < n;) {
+            ssize_t w = ::write(out, buffer + written, static_cast<size_t>(n - written));
+            if (w < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return errno;
+            }
+            written += w;
+        }
+        bytes.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+struct FileOperations::Operation {
+    // Source and target directory of copy tasks, shared by their entries
+    struct CopyDirectory {
+        FdPtr source;
+        FdPtr target;
+        std::string path;      // Source as displayed in errors
+        PendingPtr pending;    // Null for the parents of top-level sources
+    };
+    using CopyPtr = std::shared_ptr<const CopyDirectory>;
+
+    struct RemoveDirectory {
+        FdPtr dir;
+        std::string path;
+        PendingPtr pending;
+    };
+    using RemovePtr = std::shared_ptr<const RemoveDirectory>;
+
+    FileOperationOptions options;
+    std::atomic<uint64_t> files{0};
+    std::atomic<uint64_t> directories{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> reflinked{0};
+    std::mutex errors_mutex;
+    std::vector<std::string> errors;
+    TaskGroup tasks;   // Last: its destructor waits for tasks using the rest
+
+    Operation(const FileOperationOptions& opts, WorkStealingPool& pool)
+        : options(opts), tasks(pool) {}
+
+    void fail(std::string message) {
+        std::lock_guard lock(errors_mutex);
+        errors.push_back(std::move(message));
+    }
+
+    void fail(const char* action, const std::string& path, int error) {
+        fail(std::string("cannot ") + action + " '" + path + "': " + strerror(error));
+    }
+
+    size_t errorCount() {
+        std::lock_guard lock(errors_mutex);
+        return errors.size();
+    }
+
+    FileOperationProgress snapshot() const {
+        FileOperationProgress progress;
+        progress.files = files.load(std::memory_order_relaxed);
+        progress.directories = directories.load(std::memory_order_relaxed);
+        progress.bytes = bytes.load(std::memory_order_relaxed);
+        progress.reflinked = reflinked.load(std::memory_order_relaxed);
+        return progress;
+    }
+
+    void copyEntry(const CopyPtr& parent, const std::string& name, const std::string& target_name,
+                   FsEntryType type, const std::string& path) {
+        if (type == FsEntryType::Unknown) {
+            FsStat info;
+            int error = statAt(parent->source->get(), name.c_str(), info, false);
+            if (error != 0) {
+                fail("stat", path, error);
+                release(parent->pending);
+                return;
+            }
+            type = info.type;
+        }
+        switch (type) {
+            case FsEntryType::Directory:
+                copyDirectory(parent, name, target_name, path);
+                return;   // Releases the parent when its own entries are done
+            case FsEntryType::Regular:
+                copyFile(parent, name, target_name, path);
+                break;
+            case FsEntryType::Symlink:
+                copySymlink(parent, name, target_name, path);
+                break;
+            default:
+                fail("copy special file", path, EOPNOTSUPP);
+                break;
+        }
+        release(parent->pending);
+    }
+
+    void copyFile(const CopyPtr& parent, const std::string& name, const std::string& target_name,
+                  const std::string& path) {
+        Fd in(openat(parent->source->get(), name.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC));
+        struct stat info;
+        if (in.get() < 0 || fstat(in.get(), &info) != 0) {
+            fail("open", path, errno);
+            return;
+        }
+        const int target_dir = parent->target->get();
+        const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+        int fd = openat(target_dir, target_name.c_str(), flags, info.st_mode & 07777);
+        if (fd < 0 && options.force && (errno == EACCES || errno == EPERM)) {
+            unlinkat(target_dir, target_name.c_str(), 0);
+            fd = openat(target_dir, target_name.c_str(), flags, info.st_mode & 07777);
+        }
+        Fd out(fd);
+        if (out.get() < 0) {
+            fail("create", path, errno);
+            return;
+        }
+        bool cloned = false;
+        int error = copyContents(in.get(), out.get(), static_cast<uint64_t>(info.st_size), cloned, bytes);
+        if (error != 0) {
+            fail("copy", path, error);
+            return;
+        }
+        files.fetch_add(1, std::memory_order_relaxed);
+        if (cloned) {
+            reflinked.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void copySymlink(const CopyPtr& parent, const std::string& name, const std::string& target_name,
+                     const std::string& path) {
+        char link[PATH_MAX];
+        ssize_t length = readlinkat(parent->source->get(), name.c_str(), link, sizeof(link) - 1);
+        if (length < 0) {
+            fail("read link", path, errno);
+            return;
+        }
+        link[length] = '\0';
+        const int target_dir = parent->target->get();
+        int result = symlinkat(link, target_dir, target_name.c_str());
+        if (result != 0 && errno == EEXIST && options.force) {
+            unlinkat(target_dir, target_name.c_str(), 0);
+            result = symlinkat(link, target_dir, target_name.c_str());
+        }
+        if (result != 0) {
+            fail("create link", path, errno);
+            return;
+        }
+        files.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void copyDirectory(const CopyPtr& parent, const std::string& name, const std::string& target_name,
+                       const std::string& path) {
+        const int source_fd = openat(parent->source->get(), name.c_str(),
+                                     O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        struct stat info;
+        if (source_fd < 0 || fstat(source_fd, &info) != 0) {
+            fail("open", path, errno);
+            if (source_fd >= 0) {
+                ::close(source_fd);
+            }
+            release(parent->pending);
+            return;
+        }
+        auto source = std::make_shared<Fd>(source_fd);
+
+        // Writable until its entries are in; the real mode comes last
+        const FdPtr target_parent = parent->target;
+        if (mkdirat(target_parent->get(), target_name.c_str(), (info.st_mode & 07777) | S_IRWXU) != 0 &&
+            errno != EEXIST) {
+            fail("create directory", path, errno);
+            release(parent->pending);
+            return;
+        }
+        auto target = std::make_shared<Fd>(openat(target_parent->get(), target_name.c_str(),
+                                                  O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+        if (target->get() < 0) {
+            fail("create directory", path, errno);
+            release(parent->pending);
+            return;
+        }
+
+        std::vector<FsEntry> entries;
+        int error = listDirectoryAt(source_fd, ".", entries);
+        if (error != 0) {
+            fail("read directory", path, error);
+        }
+
+        auto pending = std::make_shared<Pending>();
+        pending->remaining.store(entries.size() + 1);
+        pending->parent = parent->pending;
+        const mode_t mode = info.st_mode & 07777;
+        pending->done = [this, target_parent, target_name, mode]() {
+            fchmodat(target_parent->get(), target_name.c_str(), mode, 0);
+            directories.fetch_add(1, std::memory_order_relaxed);
+        };
+        CopyPtr directory = std::make_shared<const CopyDirectory>(
+            CopyDirectory{std::move(source), std::move(target), path, pending});
+        for (auto& entry : entries) {
+            tasks.spawn([this, directory, entry = std::move(entry)]() {
+                copyEntry(directory, entry.name, entry.name, entry.type, join(directory->path, entry.name));
+            });
+        }
+        release(pending);
+    }
+
+    void removeDirectory(const RemovePtr& parent, const std::string& name, const std::string& path) {
+        const int fd = openat(parent->dir->get(), name.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        if (fd < 0) {
+            fail("remove", path, errno);
+            release(parent->pending);
+            return;
+        }
+        auto dir = std::make_shared<Fd>(fd);
+        std::vector<FsEntry> entries;
+        int error = listDirectoryAt(fd, ".", entries);
+        if (error != 0) {
+            fail("read directory", path, error);
+        }
+
+        std::vector<std::string> subdirectories;
+        std::vector<std::vector<std::string>> batches;
+        for (auto& entry : entries) {
+            FsEntryType type = entry.type;
+            if (type == FsEntryType::Unknown) {
+                FsStat info;
+                type = statAt(fd, entry.name.c_str(), info, false) == 0 ? info.type : FsEntryType::Other;
+            }
+            if (type == FsEntryType::Directory) {
+                subdirectories.push_back(std::move(entry.name));
+                continue;
+            }
+            if (batches.empty() || batches.back().size() == REMOVE_BATCH) {
+                batches.emplace_back();
+                batches.back().reserve(REMOVE_BATCH);
+            }
+            batches.back().push_back(std::move(entry.name));
+        }
+
+        auto pending = std::make_shared<Pending>();
+        pending->remaining.store(subdirectories.size() + batches.size() + 1);
+        pending->parent = parent->pending;
+        const FdPtr parent_dir = parent->dir;
+        pending->done = [this, parent_dir, name, path]() {
+            if (unlinkat(parent_dir->get(), name.c_str(), AT_REMOVEDIR) != 0) {
+                fail("remove", path, errno);
+            } else {
+                directories.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+        RemovePtr directory = std::make_shared<const RemoveDirectory>(
+            RemoveDirectory{std::move(dir), path, pending});
+        for (auto& batch : batches) {
+            tasks.spawn([this, directory, batch = std::move(batch)]() {
+                for (const auto& file : batch) {
+                    if (unlinkat(directory->dir->get(), file.c_str(), 0) != 0) {
+                        fail("remove", join(directory->path, file), errno);
+                    } else {
+                        files.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                release(directory->pending);
+            });
+        }
+        for (auto& subdirectory : subdirectories) {
+            tasks.spawn([this, directory, subdirectory = std::move(subdirectory)]() {
+                removeDirectory(directory, subdirectory, join(directory->path, subdirectory));
+            });
+        }
+        release(pending);
+    }
+};
+
+FileOperations::FileOperations(FsContext& fs, FileOperationOptions options,
+                               std::shared_ptr<WorkStealingPool> pool)
+    : fs_(fs)
+    , options_(options)
+    , pool_(pool ? std::move(pool) : std::make_shared<WorkStealingPool>(options.threads)) {
+}
+
+FileOperationResult FileOperations::copy(const std::vector<std::string>& sources,
+                                         const std::string& destination,
+                                         const ProgressCallback& progress) {
+    Operation operation(options_, *pool_);
+    track(operation);
+    FsStat target;
+    const bool into_directory = fs_.stat(destination, target) == 0 && target.type == FsEntryType::Directory;
+    if (sources.size() > 1 && !into_directory) {
+        operation.fail("target '" + destination + "' is not a directory");
+    } else {
+        for (const auto& source : sources) {
+            const std::string name = baseName(fs_.absolute(source));
+            copyOne(operation, source, into_directory ? join(destination, name) : destination);
+        }
+    }
+    wait(operation, progress);
+    return collect(operation);
+}
+
+FileOperationResult FileOperations::move(const std::vector<std::string>& sources,
+                                         const std::string& destination,
+                                         const ProgressCallback& progress) {
+    Operation operation(options_, *pool_);
+    track(operation);
+    operation.options.recursive = true;
+    FsStat target;
+    const bool into_directory = fs_.stat(destination, target) == 0 && target.type == FsEntryType::Directory;
+    if (sources.size() > 1 && !into_directory) {
+        operation.fail("target '" + destination + "' is not a directory");
+        return collect(operation);
+    }
+
+    std::vector<std::pair<std::string, std::string>> across;   // Source, target
+    for (const auto& source : sources) {
+        if (operation.tasks.isCancelled()) {
+            break;
+        }
+        const std::string from = fs_.absolute(source);
+        const std::string to = into_directory ? join(fs_.absolute(destination), baseName(from))
+                                              : fs_.absolute(destination);
+        FsStat info;
+        int error = fs_.stat(from, info, false);
+        if (error == 0 && ::rename(from.c_str(), to.c_str()) != 0) {
+            error = errno;
+        }
+        if (error == EXDEV) {
+            across.emplace_back(source, to);
+        } else if (error != 0) {
+            operation.fail("move", displayPath(source), error);
+        } else if (info.type == FsEntryType::Directory) {
+            // Cached fds under the old name now point at the new one
+            fs_.invalidate(from);
+            fs_.invalidate(to);
+            operation.directories.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            operation.files.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (across.empty()) {
+        return collect(operation);
+    }
+
+    // Another filesystem: copy everything, then remove what was copied
+    const size_t errors_before = operation.errorCount();
+    for (const auto& [source, to] : across) {
+        copyOne(operation, source, to);
+    }
+    wait(operation, progress);
+    if (operation.errorCount() == errors_before && !operation.tasks.isCancelled()) {
+        const FileOperationProgress copied = operation.snapshot();
+        for (const auto& moved : across) {
+            removeOne(operation, moved.first);
+        }
+        wait(operation, progress);
+        for (const auto& moved : across) {
+            fs_.invalidate(moved.first);
+        }
+        // Report what was moved, not what was copied and removed
+        operation.files.store(copied.files);
+        operation.directories.store(copied.directories);
+    }
+    return collect(operation);
+}
+
+FileOperationResult FileOperations::remove(const std::vector<std::string>& paths,
+                                           const ProgressCallback& progress) {
+    Operation operation(options_, *pool_);
+    track(operation);
+    for (const auto& path : paths) {
+        removeOne(operation, path);
+    }
+    wait(operation, progress);
+    for (const auto& path : paths) {
+        fs_.invalidate(path);
+    }
+    return collect(operation);
+}
+
+void FileOperations::cancel() noexcept {
+    std::lock_guard lock(mutex_);
+    cancelled_ = true;
+    if (current_) {
+        current_->tasks.cancel();
+    }
+}
+
+void FileOperations::copyOne(Operation& operation, const std::string& source, const std::string& target) {
+    const std::string path = displayPath(source);
+    FsStat info;
+    int error = fs_.stat(source, info, false);
+    if (error != 0) {
+        operation.fail("stat", path, error);
+        return;
+    }
+    if (info.type == FsEntryType::Directory && !operation.options.recursive) {
+        operation.fail("-r not specified; omitting directory '" + path + "'");
+        return;
+    }
+    const std::string from = fs_.absolute(source);
+    const std::string to = fs_.absolute(target);
+    if (from == "/" || to == "/") {
+        operation.fail("copy", path, EINVAL);
+        return;
+    }
+    if (info.type == FsEntryType::Directory && (to == from || to.compare(0, from.size() + 1, from + "/") == 0)) {
+        operation.fail("cannot copy a directory, '" + path + "', into itself, '" + target + "'");
+        return;
+    }
+    FsStat existing;
+    if (fs_.stat(to, existing) == 0 && existing.inode == info.inode && existing.device == info.device) {
+        operation.fail("'" + path + "' and '" + target + "' are the same file");
+        return;
+    }
+
+    FdPtr source_parent = openDirectory(fs_, parentOf(from));
+    FdPtr target_parent = openDirectory(fs_, parentOf(to));
+    if (!source_parent || !target_parent) {
+        operation.fail("open", source_parent ? parentOf(to) : parentOf(from), errno);
+        return;
+    }
+    auto parent = std::make_shared<const Operation::CopyDirectory>(
+        Operation::CopyDirectory{std::move(source_parent), std::move(target_parent), "", nullptr});
+    const FsEntryType type = info.type;
+    operation.tasks.spawn([&operation, parent, name = baseName(from), target_name = baseName(to), type, path]() {
+        operation.copyEntry(parent, name, target_name, type, path);
+    });
+}
+
+void FileOperations::removeOne(Operation& operation, const std::string& path) {
+    const std::string display = displayPath(path);
+    FsStat info;
+    int error = fs_.stat(path, info, false);
+    if (error != 0) {
+        if (!(operation.options.force && error == ENOENT)) {
+            operation.fail("remove", display, error);
+        }
+        return;
+    }
+    const std::string absolute = fs_.absolute(path);
+    const std::string name = baseName(absolute);
+    if (absolute == "/" || name == "." || name == ".." || baseName(display) == "." || baseName(display) == "..") {
+        operation.fail("refusing to remove '.', '..' or '/': '" + display + "'");
+        return;
+    }
+    if (info.type == FsEntryType::Directory && !operation.options.recursive) {
+        operation.fail("remove", display, EISDIR);
+        return;
+    }
+    FdPtr parent_dir = openDirectory(fs_, parentOf(absolute));
+    if (!parent_dir) {
+        operation.fail("remove", display, errno);
+        return;
+    }
+    if (info.type != FsEntryType::Directory) {
+        if (unlinkat(parent_dir->get(), name.c_str(), 0) != 0) {
+            operation.fail("remove", display, errno);
+        } else {
+            operation.files.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    auto parent = std::make_shared<const Operation::RemoveDirectory>(
+        Operation::RemoveDirectory{std::move(parent_dir), "", nullptr});
+    operation.tasks.spawn([&operation, parent, name, display]() {
+        operation.removeDirectory(parent, name, display);
+    });
+}
+
+void FileOperations::track(Operation& operation) {
+    std::lock_guard lock(mutex_);
+    current_ = &operation;
+    if (cancelled_) {
+        operation.tasks.cancel();
+    }
+}
+
+void FileOperations::wait(Operation& operation, const ProgressCallback& progress) {
+    if (progress && options_.progress_interval_ms > 0) {
+        while (!operation.tasks.waitFor(options_.progress_interval_ms)) {
+            progress(operation.snapshot());
+        }
+    } else {
+        operation.tasks.wait();
+    }
+}
+
+FileOperationResult FileOperations::collect(Operation& operation) {
+    {
+        std::lock_guard lock(mutex_);
+        current_ = nullptr;
+    }
+    FileOperationResult result;
+    result.totals = operation.snapshot();
+    result.cancelled = operation.tasks.isCancelled();
+    std::lock_guard lock(operation.errors_mutex);
+    result.errors = std::move(operation.errors);
+    return result;
+}
+
+} // namespace core
+} // namespace cross_terminal
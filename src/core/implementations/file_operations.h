@@ -0,0 +1,135 @@
+#pragma once
+
+#include "core/implementations/fs_context.h"
+#include "core/implementations/work_stealing_pool.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file file_operations.h
+ * @brief Native cp -r, mv and rm -r
+ *
+ * Spawning the external tools costs a fork and exec, and Android's
+ * toolbox cp and rm handle one file at a time. These operations walk the
+ * tree on a WorkStealingPool, normally the one the session runtime
+ * shares between file builtins, each directory spawning a task per
+ * entry. They stay fd-relative throughout (openat, mkdirat, unlinkat), so
+ * no path is resolved twice.
+ *
+ * File contents are copied by the cheapest available means:
+ *   1. FICLONE: a reflink on btrfs, XFS and f2fs; no data moves
+ *   2. copy_file_range(): an in-kernel copy with no user-space buffer
+ *   3. read()/write() for everything else (some FUSE and sdcardfs mounts)
+ *
+ * A directory's mode is applied once its last entry is done (so a
+ * read-only source directory can still be filled), and rm -r removes a
+ * directory once its last entry is gone.
+ *
+ * @performance Bounded by the filesystem: files are copied in parallel,
+ *              with no per-file process and no per-path lookups
+ * @thread_safety One operation at a time per instance; cancel() may be
+ *                called from any thread
+ */
+
+namespace cross_terminal {
+namespace core {
+
+struct FileOperationOptions {
+    bool recursive = false;             ///< Descend into directories (-r)
+    bool force = false;                 ///< rm: ignore missing paths; cp: replace unwritable files
+    size_t threads = 0;                 ///< Workers of a private pool; 0 for WorkStealingPool's default
+    uint32_t progress_interval_ms = 500;
+};
+
+/**
+ * @brief Running totals, reported while an operation is in progress
+ */
+struct FileOperationProgress {
+    uint64_t files = 0;          ///< Files (and symlinks) copied, moved or removed
+    uint64_t directories = 0;
+    uint64_t bytes = 0;          ///< File data copied
+    uint64_t reflinked = 0;      ///< Files cloned with FICLONE
+};
+
+struct FileOperationResult {
+    FileOperationProgress totals;
+    std::vector<std::string> errors;   ///< "cannot ...: reason" messages, in no particular order
+    bool cancelled = false;
+
+    bool succeeded() const noexcept { return errors.empty() && !cancelled; }
+};
+
+class FileOperations {
+public:
+    /// Called on the calling thread every progress_interval_ms while an
+    /// operation runs; not called for operations that finish sooner
+    using ProgressCallback = std::function<void(const FileOperationProgress&)>;
+
+    /**
+     * @param fs Resolves the relative paths operations are given
+     * @param pool Workers shared with other operations; when null, a
+     *        private pool of options.threads is started
+     */
+    explicit FileOperations(FsContext& fs, FileOperationOptions options = {},
+                            std::shared_ptr<WorkStealingPool> pool = nullptr);
+
+    /**
+     * @brief cp [-r] sources... destination
+     *
+     * With one source and a destination that is not a directory, the
+     * source is copied to that name; otherwise each source is copied into
+     * the destination directory under its own name.
+     */
+    FileOperationResult copy(const std::vector<std::string>& sources,
+                             const std::string& destination,
+                             const ProgressCallback& progress = nullptr);
+
+    /**
+     * @brief mv sources... destination
+     *
+     * A rename where possible. Across filesystems the source is copied
+     * and then removed.
+     */
+    FileOperationResult move(const std::vector<std::string>& sources,
+                             const std::string& destination,
+                             const ProgressCallback& progress = nullptr);
+
+    /// @brief rm [-r] [-f] paths...
+    FileOperationResult remove(const std::vector<std::string>& paths,
+                               const ProgressCallback& progress = nullptr);
+
+    /**
+     * @brief Stop the running operation after the entries in progress
+     *
+     * Operations started afterwards are cancelled as they begin, so a
+     * cancel() that races with the start of one is not lost.
+     */
+    void cancel() noexcept;
+
+private:
+    struct Operation;
+
+    FsContext& fs_;
+    const FileOperationOptions options_;
+    std::shared_ptr<WorkStealingPool> pool_;
+    std::mutex mutex_;
+    Operation* current_ = nullptr;   // Guarded by mutex_, for cancel()
+    bool cancelled_ = false;         // Guarded by mutex_
+
+    // Make operation the one cancel() stops, until collect()
+    void track(Operation& operation);
+    // Check one top-level source or path and spawn its task
+    void copyOne(Operation& operation, const std::string& source, const std::string& target);
+    void removeOne(Operation& operation, const std::string& path);
+    // Wait for the spawned tasks, reporting progress meanwhile
+    void wait(Operation& operation, const ProgressCallback& progress);
+    FileOperationResult collect(Operation& operation);
+};
+
+} // namespace core
+} // namespace cross_terminal
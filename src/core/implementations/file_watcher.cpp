@@ -0,0 +1,309 @@
+#include "file_watcher.h"
+#include "fs_context.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+namespace {
+
+#ifdef __linux__
+// Content writes, metadata changes and entries coming and going
+constexpr uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE |
+                                  IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF |
+                                  IN_ONLYDIR | IN_EXCL_UNLINK;
+// Events per read(): enough for a burst, small enough for the stack
+constexpr size_t EVENT_BUFFER_SIZE = 16 * 1024;
+#endif
+
+std::string join(const std::string& directory, const std::string& name) {
+    return directory.back() == '/' ? directory + name : directory + "/" + name;
+}
+
+uint64_t steadyMs() noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+FileWatcher::FileWatcher(std::shared_ptr<IoReactor> reactor, FileWatchOptions options)
+    : reactor_(std::move(reactor))
+    , options_(options)
+    , fd_(-1)
+    , timer_(0)
+    , generation_(0)
+    , burst_start_ms_(0) {
+}
+
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+int FileWatcher::start(const std::vector<std::string>& paths, ChangeCallback callback) {
+#ifdef __linux__
+    int fd;
+    {
+        std::lock_guard lock(mutex_);
+        if (fd_ >= 0) {
+            return EBUSY;
+        }
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) {
+            return errno;
+        }
+        fd_ = fd;
+        metrics_ = {};
+        for (const auto& path : paths) {
+            struct stat info;
+            int error = ::stat(path.c_str(), &info) != 0 ? errno
+                      : S_ISDIR(info.st_mode)          ? addDirectory(path, options_.recursive)
+                                                       : addFile(path);
+            if (error != 0) {
+                watches_.clear();
+                by_path_.clear();
+                fd_ = -1;
+                ::close(fd);
+                return error;
+            }
+        }
+        roots_ = paths;
+        callback_ = std::move(callback);
+    }
+    // Outside mutex_, which fire() takes inside the guard; no timer can be
+    // pending before the fd is on the reactor
+    guard_.reset();
+    if (!reactor_->add(fd, IoReactor::Readable, [this](int, uint32_t) { handleEvents(); })) {
+        const int error = errno != 0 ? errno : EIO;
+        stop();
+        return error;
+    }
+    return 0;
+#else
+    (void)paths;
+    (void)callback;
+    return ENOSYS;
+#endif
+}
+
+void FileWatcher::stop() noexcept {
+    int fd;
+    {
+        std::lock_guard lock(mutex_);
+        fd = fd_;
+        fd_ = -1;
+        if (timer_ != 0) {
+            reactor_->cancel(timer_);
+            timer_ = 0;
+        }
+        watches_.clear();
+        by_path_.clear();
+        changed_.clear();
+    }
+    if (fd < 0) {
+        return;
+    }
+    reactor_->remove(fd);
+    guard_.invalidate();
+    ::close(fd);
+}
+
+bool FileWatcher::isRunning() const {
+    std::lock_guard lock(mutex_);
+    return fd_ >= 0;
+}
+
+FileWatchMetrics FileWatcher::getMetrics() const {
+    std::lock_guard lock(mutex_);
+    FileWatchMetrics metrics = metrics_;
+    metrics.watches = watches_.size();
+    return metrics;
+}
+
+int FileWatcher::addDirectory(const std::string& path, bool recursive) {
+#ifdef __linux__
+    const int wd = inotify_add_watch(fd_, path.c_str(), WATCH_EVENTS);
+    if (wd < 0) {
+        return errno;
+    }
+    Watch& watch = watches_[wd];
+    watch.path = path;
+    watch.all = true;
+    watch.names.clear();
+    by_path_[path] = wd;
+    if (!recursive) {
+        return 0;
+    }
+
+    std::vector<FsEntry> entries;
+    listDirectoryAt(AT_FDCWD, path.c_str(), entries);
+    for (const auto& entry : entries) {
+        FsEntryType type = entry.type;
+        const std::string child = join(path, entry.name);
+        if (type == FsEntryType::Unknown) {
+            FsStat info;
+            type = statAt(AT_FDCWD, child.c_str(), info, false) == 0 ? info.type : FsEntryType::Other;
+        }
+        // Unreadable subdirectories are skipped; running out of watches is not
+        if (type == FsEntryType::Directory && addDirectory(child, true) == ENOSPC) {
+            return ENOSPC;
+        }
+    }
+    return 0;
+#else
+    (void)path;
+    (void)recursive;
+    return ENOSYS;
+#endif
+}
+
+int FileWatcher::addFile(const std::string& path) {
+#ifdef __linux__
+    const size_t slash = path.rfind('/');
+    const std::string parent = slash == 0 || slash == std::string::npos ? "/" : path.substr(0, slash);
+    const std::string name = path.substr(slash + 1);
+    auto existing = by_path_.find(parent);
+    if (existing != by_path_.end()) {
+        Watch& watch = watches_[existing->second];
+        if (!watch.all) {
+            watch.names.insert(name);
+        }
+        return 0;
+    }
+    const int wd = inotify_add_watch(fd_, parent.c_str(), WATCH_EVENTS);
+    if (wd < 0) {
+        return errno;
+    }
+    Watch& watch = watches_[wd];
+    watch.path = parent;
+    watch.names.insert(name);
+    by_path_[parent] = wd;
+    return 0;
+#else
+    (void)path;
+    return ENOSYS;
+#endif
+}
+
+void FileWatcher::handleEvents() {
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[EVENT_BUFFER_SIZE];
+    std::lock_guard lock(mutex_);
+    bool changed = false;
+    while (fd_ >= 0) {
+        const ssize_t n = ::read(fd_, buffer, sizeof(buffer));
+        if (n <= 0) {
+            break;   // EAGAIN: drained
+        }
+        for (ssize_t offset = 0; offset < n;) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+            ++metrics_.events;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // Events were dropped: report the roots as changed
+                ++metrics_.overflows;
+                changed_.insert(roots_.begin(), roots_.end());
+                changed = true;
+                continue;
+            }
+            auto it = watches_.find(event->wd);
+            if (it == watches_.end()) {
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                // Removed, deleted or unmounted
+                auto path = by_path_.find(it->second.path);
+                if (path != by_path_.end() && path->second == event->wd) {
+                    by_path_.erase(path);
+                }
+                watches_.erase(it);
+                continue;
+            }
+            const Watch& watch = it->second;
+            if (event->len == 0) {
+                // The watched directory itself
+                if (watch.all) {
+                    changed = changed_.insert(watch.path).second || changed;
+                }
+                continue;
+            }
+            const std::string name = event->name;
+            if (!watch.all && watch.names.count(name) == 0) {
+                continue;
+            }
+            const std::string path = join(watch.path, name);
+            if ((event->mask & IN_ISDIR) && watch.all && options_.recursive) {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    addDirectory(path, true);
+                } else if (event->mask & IN_MOVED_FROM) {
+                    // The subtree's watches would report stale paths; a move
+                    // back in watches it again
+                    const std::string prefix = path + "/";
+                    for (const auto& [watched, wd] : by_path_) {
+                        if (watched == path || watched.compare(0, prefix.size(), prefix) == 0) {
+                            inotify_rm_watch(fd_, wd);
+                        }
+                    }
+                }
+            }
+            changed = changed_.insert(path).second || changed;
+        }
+    }
+    if (changed) {
+        debounce();
+    }
+#endif
+}
+
+void FileWatcher::debounce() {
+    const uint64_t now = steadyMs();
+    if (timer_ != 0) {
+        reactor_->cancel(timer_);
+    } else {
+        burst_start_ms_ = now;
+    }
+    // Quiet for debounce_ms, but no later than max_delay_ms into the burst
+    const uint64_t elapsed = now - burst_start_ms_;
+    uint64_t delay = options_.debounce_ms;
+    if (elapsed + delay > options_.max_delay_ms) {
+        delay = options_.max_delay_ms > elapsed ? options_.max_delay_ms - elapsed : 0;
+    }
+    const uint64_t generation = ++generation_;
+    timer_ = reactor_->schedule(static_cast<uint32_t>(delay),
+                                guard_.wrap([this, generation]() { fire(generation); }));
+}
+
+void FileWatcher::fire(uint64_t generation) {
+    std::vector<std::string> changed;
+    ChangeCallback callback;
+    {
+        std::lock_guard lock(mutex_);
+        // A timer replaced while it was already running has nothing to do
+        if (generation != generation_ || fd_ < 0) {
+            return;
+        }
+        timer_ = 0;
+        changed.assign(changed_.begin(), changed_.end());
+        changed_.clear();
+        ++metrics_.bursts;
+        callback = callback_;
+    }
+    std::sort(changed.begin(), changed.end());
+    if (callback && !changed.empty()) {
+        callback(changed);
+    }
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "core/implementations/io_reactor.h"
+#include "core/utils/callback_guard.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @file file_watcher.h
+ * @brief inotify watches on the shared reactor
+ *
+ * Replaces polling for changes: one inotify descriptor per watcher,
+ * multiplexed on the IoReactor like a process pipe, with no thread of its
+ * own. Directories are watched recursively; the watch descriptor of every
+ * directory is cached with its path, and directories created or moved in
+ * later are added as their events arrive. A file is watched through its
+ * parent directory, so editors that save by renaming a new file over the
+ * old one are still seen.
+ *
+ * Events are debounced: the change callback runs once a burst has been
+ * quiet for debounce_ms (or max_delay_ms after it began, if it never is),
+ * with every path that changed in it.
+ *
+ * @performance No wakeups while nothing changes; one read() per batch of
+ *              events
+ * @thread_safety All public methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+struct FileWatchOptions {
+    bool recursive = true;           ///< Watch subdirectories of watched directories
+    uint32_t debounce_ms = 100;      ///< Quiet time that ends a burst
+    uint32_t max_delay_ms = 1000;    ///< Longest a burst is held back
+};
+
+struct FileWatchMetrics {
+    uint64_t events = 0;       ///< inotify events read
+    uint64_t bursts = 0;       ///< Change callbacks run
+    uint64_t overflows = 0;    ///< Event queue overflows (changes may be missed)
+    size_t watches = 0;        ///< Directories watched
+};
+
+class FileWatcher {
+public:
+    /// Called on a reactor thread with the changed paths, sorted
+    using ChangeCallback = std::function<void(const std::vector<std::string>& changed)>;
+
+    explicit FileWatcher(std::shared_ptr<IoReactor> reactor, FileWatchOptions options = {});
+    ~FileWatcher();
+
+    // Non-copyable, non-movable
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief Start watching
+     * @param paths Absolute paths of files and directories
+     * @return 0 or an errno value (ENOSYS without inotify)
+     * @thread_safe Yes
+     */
+    int start(const std::vector<std::string>& paths, ChangeCallback callback);
+
+    /**
+     * @brief Remove the watches; no callback runs once this returns
+     * @thread_safe Yes - may be called from the change callback
+     */
+    void stop() noexcept;
+
+    bool isRunning() const;
+    FileWatchMetrics getMetrics() const;
+
+private:
+    // One watched directory: every entry, or only the named files in it
+    struct Watch {
+        std::string path;
+        bool all = false;
+        std::unordered_set<std::string> names;
+    };
+
+    std::shared_ptr<IoReactor> reactor_;
+    const FileWatchOptions options_;
+    CallbackGuard guard_;   // Debounce timers
+
+    mutable std::mutex mutex_;
+    int fd_;
+    ChangeCallback callback_;
+    std::unordered_map<int, Watch> watches_;          // By watch descriptor
+    std::unordered_map<std::string, int> by_path_;    // Directory path to watch descriptor
+    std::vector<std::string> roots_;
+    std::unordered_set<std::string> changed_;         // In the current burst
+    IoReactor::TimerId timer_;
+    uint64_t generation_;                             // Of the pending timer
+    uint64_t burst_start_ms_;
+    FileWatchMetrics metrics_;
+
+    // Watch directory (and, when recursive, everything below it); mutex_ held
+    int addDirectory(const std::string& path, bool recursive);
+    int addFile(const std::string& path);
+    void handleEvents();
+    void debounce();   // mutex_ held
+    void fire(uint64_t generation);
+};
+
+} // namespace core
+} // namespace cross_terminal
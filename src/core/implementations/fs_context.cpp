@@ -0,0 +1,544 @@
+#include "fs_context.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+namespace {
+
+// O_PATH directory fds need only search permission on the directory,
+// like chdir(); elsewhere fall back to a read-only open
+#ifdef O_PATH
+constexpr int DIR_OPEN_FLAGS = O_PATH | O_DIRECTORY | O_CLOEXEC;
+#else
+constexpr int DIR_OPEN_FLAGS = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+#endif
+
+constexpr size_t DENTS_BUFFER_SIZE = 32 * 1024;
+
+// statx where the C library has it (bionic from API 30)
+#if defined(STATX_BASIC_STATS) && (!defined(__ANDROID__) || __ANDROID_API__ >= 30)
+#define CT_HAVE_STATX 1
+#endif
+
+bool hasDotDot(const std::string& path) {
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos) {
+            end = path.size();
+        }
+        if (end - start == 2 && path.compare(start, 2, "..") == 0) {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+// A removed directory keeps its fd valid with no links; one recreated
+// under the same name is a different inode the cache must not serve
+bool isRemoved(int fd) {
+    struct stat info;
+    return ::fstat(fd, &info) != 0 || info.st_nlink == 0;
+}
+
+bool hasWildcard(const std::string& text) {
+    return text.find_first_of("*?[") != std::string::npos;
+}
+
+// True when no component is empty, "." or ".."; the common case, which
+// normalize() then handles with a single append
+bool isCanonical(const std::string& path, size_t start) {
+    const size_t length = path.size();
+    if (start >= length || path.back() == '/') {
+        return false;
+    }
+    for (size_t i = start; i < length; ++i) {
+        const bool componentStart = i == start || path[i - 1] == '/';
+        if (componentStart && (path[i] == '/' || path[i] == '.')) {
+            // A name that merely starts with a dot is still canonical
+            if (path[i] == '.' && i + 1 < length && path[i + 1] != '/' &&
+                !(path[i + 1] == '.' && (i + 2 == length || path[i + 2] == '/'))) {
+                continue;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+// Resolve path against base ("/"-rooted, normalized) by components:
+// empty and "." components vanish, ".." removes the previous one
+std::string normalize(const std::string& base, const std::string& path) {
+    const bool rooted = !path.empty() && path[0] == '/';
+    if (isCanonical(path, rooted ? 1 : 0)) {
+        if (rooted) {
+            return path;
+        }
+        std::string result;
+        result.reserve(base.size() + path.size() + 1);
+        result = base;
+        if (base != "/") {
+            result += '/';
+        }
+        result += path;
+        return result;
+    }
+
+    std::string result;
+    result.reserve(base.size() + path.size() + 1);   // One allocation per lookup
+    if (!rooted && base != "/") {
+        result = base;
+    }
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos) {
+            end = path.size();
+        }
+        const size_t length = end - start;
+        if (length == 0 || (length == 1 && path[start] == '.')) {
+            // Nothing
+        } else if (length == 2 && path.compare(start, 2, "..") == 0) {
+            size_t slash = result.rfind('/');
+            result.resize(slash == std::string::npos ? 0 : slash);
+        } else {
+            result += '/';
+            result.append(path, start, length);
+        }
+        start = end + 1;
+    }
+    return result.empty() ? std::string("/") : result;
+}
+
+std::string parentOf(const std::string& absolute) {
+    size_t slash = absolute.rfind('/');
+    return slash == 0 || slash == std::string::npos ? std::string("/") : absolute.substr(0, slash);
+}
+
+std::string join(const std::string& base, const std::string& name) {
+    if (base.empty()) {
+        return name;
+    }
+    return base.back() == '/' ? base + name : base + "/" + name;
+}
+
+FsEntryType typeFromMode(uint32_t mode) {
+    switch (mode & S_IFMT) {
+        case S_IFREG: return FsEntryType::Regular;
+        case S_IFDIR: return FsEntryType::Directory;
+        case S_IFLNK: return FsEntryType::Symlink;
+        default: return FsEntryType::Other;
+    }
+}
+
+FsEntryType typeFromDirent(unsigned char type) {
+    switch (type) {
+        case DT_REG: return FsEntryType::Regular;
+        case DT_DIR: return FsEntryType::Directory;
+        case DT_LNK: return FsEntryType::Symlink;
+        case DT_UNKNOWN: return FsEntryType::Unknown;
+        default: return FsEntryType::Other;
+    }
+}
+
+} // namespace
+
+int statAt(int dirfd, const char* name, FsStat& out, bool follow) {
+    const int flags = follow ? 0 : AT_SYMLINK_NOFOLLOW;
+#ifdef CT_HAVE_STATX
+    struct statx buffer;
+    const unsigned mask = STATX_TYPE | STATX_MODE | STATX_SIZE | STATX_INO | STATX_MTIME |
+                          STATX_BLOCKS | STATX_NLINK;
+    if (statx(dirfd, name, flags, mask, &buffer) != 0) {
+        return errno;
+    }
+    out.mode = buffer.stx_mode;
+    out.size = buffer.stx_size;
+    out.inode = buffer.stx_ino;
+    out.device = (static_cast<uint64_t>(buffer.stx_dev_major) << 32) | buffer.stx_dev_minor;
+    out.blocks = buffer.stx_blocks;
+    out.nlink = buffer.stx_nlink;
+    out.mtime_ns = static_cast<int64_t>(buffer.stx_mtime.tv_sec) * 1000000000 + buffer.stx_mtime.tv_nsec;
+#else
+    struct stat buffer;
+    if (fstatat(dirfd, name, &buffer, flags) != 0) {
+        return errno;
+    }
+    out.mode = buffer.st_mode;
+    out.size = static_cast<uint64_t>(buffer.st_size);
+    out.inode = buffer.st_ino;
+    out.device = buffer.st_dev;
+    out.blocks = static_cast<uint64_t>(buffer.st_blocks);
+    out.nlink = static_cast<uint32_t>(buffer.st_nlink);
+    out.mtime_ns = static_cast<int64_t>(buffer.st_mtim.tv_sec) * 1000000000 + buffer.st_mtim.tv_nsec;
+#endif
+    out.type = typeFromMode(out.mode);
+    return 0;
+}
+
+int listDirectoryAt(int dirfd, const char* name, std::vector<FsEntry>& out) {
+    int fd = openat(dirfd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return errno;
+    }
+    int result = 0;
+#ifdef __linux__
+    // The kernel's record layout; libc wrappers for it are not universal
+    struct LinuxDirent64 {
+        uint64_t d_ino;
+        int64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[1];
+    };
+    std::unique_ptr<char[]> buffer(new char[DENTS_BUFFER_SIZE]);
+    for (;;) {
+        long n = syscall(SYS_getdents64, fd, buffer.get(), DENTS_BUFFER_SIZE);
+        if (n <= 0) {
+            result = n < 0 ? errno : 0;
+            break;
+        }
+        for (long offset = 0; offset < n;) {
+            auto* entry = reinterpret_cast<const LinuxDirent64*>(buffer.get() + offset);
+            offset += entry->d_reclen;
+            const char* entryName = entry->d_name;
+            if (entryName[0] == '.' && (entryName[1] == '\0' || (entryName[1] == '.' && entryName[2] == '\0'))) {
+                continue;
+            }
+            out.push_back({entryName, typeFromDirent(entry->d_type), entry->d_ino});
+        }
+    }
+    ::close(fd);
+#else
+    DIR* dir = fdopendir(fd);
+    if (!dir) {
+        result = errno;
+        ::close(fd);
+        return result;
+    }
+    while (dirent* entry = readdir(dir)) {
+        const char* entryName = entry->d_name;
+        if (strcmp(entryName, ".") == 0 || strcmp(entryName, "..") == 0) {
+            continue;
+        }
+        out.push_back({entryName, typeFromDirent(entry->d_type), static_cast<uint64_t>(entry->d_ino)});
+    }
+    closedir(dir);
+#endif
+    return result;
+}
+
+FsContext::DirFd::~DirFd() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+FsContext::FsContext(const std::string& cwd, size_t capacity, uint32_t ttl_ms)
+    : capacity_(capacity)
+    , ttl_(ttl_ms) {
+    std::string initial = cwd;
+    if (initial.empty()) {
+        char buffer[PATH_MAX];
+        initial = getcwd(buffer, sizeof(buffer)) ? buffer : "/";
+    }
+    cwd_path_ = normalize("/", initial);
+    int fd = openat(AT_FDCWD, cwd_path_.c_str(), DIR_OPEN_FLAGS);
+    if (fd < 0) {
+        cwd_path_ = "/";
+        fd = openat(AT_FDCWD, "/", DIR_OPEN_FLAGS);
+    }
+    cwd_ = std::make_shared<DirFd>(fd);
+}
+
+FsContext::~FsContext() = default;
+
+std::string FsContext::currentDirectory() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cwd_path_;
+}
+
+std::string FsContext::absolute(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return normalize(cwd_path_, path);
+}
+
+int FsContext::changeDirectory(const std::string& path) {
+    if (path.empty()) {
+        return ENOENT;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::string target = normalize(cwd_path_, path);
+    DirPtr dir = lookupLocked(target);
+    if (!dir) {
+        return errno;
+    }
+    // An O_PATH open succeeds without search permission; cd must not
+    if (faccessat(dir->get(), ".", X_OK, 0) != 0) {
+        return errno;
+    }
+    if (capacity_ > 0 && cache_.find(cwd_path_) == cache_.end()) {
+        insertLocked(cwd_path_, cwd_);   // Likely to be revisited
+    }
+    cwd_ = std::move(dir);
+    cwd_path_ = target;
+    return 0;
+}
+
+int FsContext::stat(const std::string& path, FsStat& out, bool follow) {
+    std::string name;
+    DirPtr dir = resolveParent(path, name);
+    if (!dir) {
+        return errno;
+    }
+    return statAt(dir->get(), name.c_str(), out, follow);
+}
+
+bool FsContext::exists(const std::string& path) {
+    FsStat ignored;
+    return stat(path, ignored) == 0;
+}
+
+int FsContext::createDirectory(const std::string& path, mode_t mode) {
+    std::string name;
+    DirPtr dir = resolveParent(path, name);
+    if (!dir) {
+        return errno;
+    }
+    return mkdirat(dir->get(), name.c_str(), mode) == 0 ? 0 : errno;
+}
+
+int FsContext::listDirectory(const std::string& path, std::vector<FsEntry>& out) {
+    std::string name;
+    DirPtr dir = resolveParent(path, name);
+    if (!dir) {
+        return errno;
+    }
+    return listDirectoryAt(dir->get(), name.c_str(), out);
+}
+
+int FsContext::openFile(const std::string& path, int flags, mode_t mode) {
+    std::string name;
+    DirPtr dir = resolveParent(path, name);
+    if (!dir) {
+        return -1;
+    }
+    return openat(dir->get(), name.c_str(), flags | O_CLOEXEC, mode);
+}
+
+std::vector<std::string> FsContext::glob(const std::string& pattern) {
+    std::vector<std::string> matches;
+    if (!hasWildcard(pattern)) {
+        if (exists(pattern)) {
+            matches.push_back(pattern);
+        }
+        return matches;
+    }
+
+    std::vector<std::string> components;
+    size_t start = 0;
+    while (start <= pattern.size()) {
+        size_t end = pattern.find('/', start);
+        if (end == std::string::npos) {
+            end = pattern.size();
+        }
+        if (end > start) {
+            components.push_back(pattern.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    globInto(pattern[0] == '/' ? "/" : "", components, 0, matches);
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+void FsContext::globInto(const std::string& base, const std::vector<std::string>& components,
+                         size_t index, std::vector<std::string>& out) {
+    if (index == components.size()) {
+        out.push_back(base);
+        return;
+    }
+    const std::string& component = components[index];
+    const bool last = index + 1 == components.size();
+    if (!hasWildcard(component)) {
+        const std::string path = join(base, component);
+        if (!last || exists(path)) {
+            globInto(path, components, index + 1, out);
+        }
+        return;
+    }
+
+    std::vector<FsEntry> entries;
+    if (listDirectory(base.empty() ? "." : base, entries) != 0) {
+        return;
+    }
+    for (const auto& entry : entries) {
+        if (fnmatch(component.c_str(), entry.name.c_str(), FNM_PERIOD) != 0) {
+            continue;
+        }
+        // Only directories (or what may lead to one) can match a middle component
+        if (!last && entry.type != FsEntryType::Directory && entry.type != FsEntryType::Symlink &&
+            entry.type != FsEntryType::Unknown) {
+            continue;
+        }
+        globInto(join(base, entry.name), components, index + 1, out);
+    }
+}
+
+std::vector<std::string> FsContext::complete(const std::string& partial) {
+    std::vector<std::string> candidates;
+    const size_t slash = partial.rfind('/');
+    const std::string directory = slash == std::string::npos ? std::string() : partial.substr(0, slash + 1);
+    const std::string prefix = slash == std::string::npos ? partial : partial.substr(slash + 1);
+
+    std::vector<FsEntry> entries;
+    if (listDirectory(directory.empty() ? "." : directory, entries) != 0) {
+        return candidates;
+    }
+    const bool showHidden = !prefix.empty() && prefix[0] == '.';
+    for (const auto& entry : entries) {
+        if (entry.name.compare(0, prefix.size(), prefix) != 0 || (entry.name[0] == '.' && !showHidden)) {
+            continue;
+        }
+        bool isDirectory = entry.type == FsEntryType::Directory;
+        if (entry.type == FsEntryType::Symlink || entry.type == FsEntryType::Unknown) {
+            FsStat target;
+            isDirectory = stat(directory + entry.name, target) == 0 && target.type == FsEntryType::Directory;
+        }
+        candidates.push_back(directory + entry.name + (isDirectory ? "/" : ""));
+    }
+    std::sort(candidates.begin(), candidates.end());
+    return candidates;
+}
+
+void FsContext::invalidate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+    lru_.clear();
+}
+
+void FsContext::invalidate(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::string target = normalize(cwd_path_, path);
+    const std::string prefix = target == "/" ? target : target + "/";
+    for (auto it = cache_.begin(); it != cache_.end();) {
+        if (it->first == target || it->first.compare(0, prefix.size(), prefix) == 0) {
+            lru_.erase(it->second.lru);
+            it = cache_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+FsContextMetrics FsContext::getMetrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FsContextMetrics metrics = metrics_;
+    metrics.cached = cache_.size();
+    return metrics;
+}
+
+FsContext::DirPtr FsContext::resolveParent(const std::string& path, std::string& name) {
+    if (path.empty()) {
+        errno = ENOENT;
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (hasDotDot(path)) {
+        // Physical resolution by the kernel; an absolute path ignores the fd
+        name = path;
+        return cwd_;
+    }
+    std::string target = normalize(cwd_path_, path);
+    if (target == "/") {
+        name = ".";
+        return lookupLocked(target);
+    }
+    const size_t slash = target.rfind('/');
+    name.assign(target, slash + 1, std::string::npos);
+    target.resize(slash == 0 ? 1 : slash);   // Now the parent
+    return lookupLocked(target);
+}
+
+FsContext::DirPtr FsContext::lookupLocked(const std::string& dir) {
+    if (dir == cwd_path_) {
+        ++metrics_.cache_hits;
+        return cwd_;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    auto it = cache_.find(dir);
+    if (it != cache_.end()) {
+        if (now - it->second.opened < ttl_ && !isRemoved(it->second.dir->get())) {
+            ++metrics_.cache_hits;
+            lru_.splice(lru_.begin(), lru_, it->second.lru);
+            return it->second.dir;
+        }
+        evictLocked(it);
+    }
+    ++metrics_.cache_misses;
+
+    // Open from the nearest directory already held
+    DirPtr base;
+    std::string relative = dir.substr(1);
+    for (std::string ancestor = parentOf(dir); ; ancestor = parentOf(ancestor)) {
+        if (ancestor == cwd_path_) {
+            base = cwd_;
+        } else {
+            auto found = cache_.find(ancestor);
+            if (found != cache_.end() && now - found->second.opened < ttl_ &&
+                !isRemoved(found->second.dir->get())) {
+                base = found->second.dir;
+            }
+        }
+        if (base) {
+            relative = dir.substr(ancestor == "/" ? 1 : ancestor.size() + 1);
+            break;
+        }
+        if (ancestor == "/") {
+            break;
+        }
+    }
+    int fd = base ? openat(base->get(), relative.c_str(), DIR_OPEN_FLAGS)
+                  : openat(AT_FDCWD, dir.c_str(), DIR_OPEN_FLAGS);
+    if (fd < 0) {
+        return nullptr;
+    }
+    auto opened = std::make_shared<DirFd>(fd);
+    insertLocked(dir, opened);
+    return opened;
+}
+
+void FsContext::insertLocked(const std::string& dir, const DirPtr& fd) {
+    if (capacity_ == 0) {
+        return;
+    }
+    lru_.push_front(dir);
+    cache_[dir] = {fd, std::chrono::steady_clock::now(), lru_.begin()};
+    while (cache_.size() > capacity_) {
+        evictLocked(cache_.find(lru_.back()));
+    }
+}
+
+void FsContext::evictLocked(std::unordered_map<std::string, CacheEntry>::iterator it) {
+    lru_.erase(it->second.lru);
+    cache_.erase(it);
+    ++metrics_.evictions;
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file fs_context.h
+ * @brief Per-session filesystem access relative to cached directory fds
+ *
+ * Path-string APIs make the kernel walk every component of a deep path
+ * on every call, and chdir() makes the working directory process-global,
+ * shared by every session. FsContext keeps the session's working
+ * directory as an open directory fd plus its logical path, and caches
+ * fds for recently used directories. An operation on a/b/c/file
+ * resolves a/b/c to a cached fd and issues one *at() call
+ * (fstatat/statx, mkdirat, openat) on the last component. Listings use
+ * getdents64 and take entry types from d_type, with no stat per entry.
+ *
+ * Cached fds follow their directory if it is renamed. A hit checks the
+ * fd's link count, so a directory removed and recreated under the same
+ * name is reopened at once; entries also expire after a short TTL, and
+ * invalidate() drops the entries under a path the session renamed or
+ * removed.
+ *
+ * @performance One fstat plus one syscall per stat/open/mkdir on a
+ *              cached directory
+ * @thread_safety All public methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+enum class FsEntryType : uint8_t {
+    Unknown,
+    Regular,
+    Directory,
+    Symlink,
+    Other
+};
+
+/**
+ * @brief Directory entry as returned by getdents64
+ */
+struct FsEntry {
+    std::string name;
+    FsEntryType type = FsEntryType::Unknown;   ///< From d_type; Unknown on filesystems without it
+    uint64_t inode = 0;
+};
+
+/**
+ * @brief The stat fields the shell uses
+ */
+struct FsStat {
+    FsEntryType type = FsEntryType::Unknown;
+    uint32_t mode = 0;        ///< Permission bits and file type, as st_mode
+    uint64_t size = 0;
+    uint64_t inode = 0;
+    uint64_t device = 0;
+    uint64_t blocks = 0;      ///< 512-byte blocks allocated
+    uint32_t nlink = 0;
+    int64_t mtime_ns = 0;     ///< Nanoseconds since epoch
+};
+
+/**
+ * @brief Directory fd cache counters
+ */
+struct FsContextMetrics {
+    uint64_t cache_hits = 0;     ///< Lookups served by a cached directory fd
+    uint64_t cache_misses = 0;   ///< Lookups that opened a directory
+    uint64_t evictions = 0;      ///< Entries dropped for capacity or age
+    size_t cached = 0;           ///< Directory fds currently held
+};
+
+/**
+ * @brief statx()/fstatat() name relative to dirfd
+ * @return 0 or an errno value
+ * @thread_safe Yes
+ */
+int statAt(int dirfd, const char* name, FsStat& out, bool follow = true);
+
+/**
+ * @brief Append the entries of directory name (relative to dirfd) to out
+ *
+ * Uses getdents64 where available. "." and ".." are skipped.
+ *
+ * @return 0 or an errno value
+ * @thread_safe Yes
+ */
+int listDirectoryAt(int dirfd, const char* name, std::vector<FsEntry>& out);
+
+/**
+ * @brief Session working directory and directory fd cache
+ */
+class FsContext {
+public:
+    static constexpr size_t DEFAULT_CACHE_CAPACITY = 64;
+    static constexpr uint32_t DEFAULT_CACHE_TTL_MS = 2000;
+
+    /**
+     * @brief Constructor
+     * @param cwd Initial working directory; the process's when empty
+     * @param capacity Directory fds kept besides the working directory
+     * @param ttl_ms How long a cached directory fd is trusted
+     */
+    explicit FsContext(const std::string& cwd = "",
+                       size_t capacity = DEFAULT_CACHE_CAPACITY,
+                       uint32_t ttl_ms = DEFAULT_CACHE_TTL_MS);
+    ~FsContext();
+
+    // Non-copyable, non-movable
+    FsContext(const FsContext&) = delete;
+    FsContext& operator=(const FsContext&) = delete;
+
+    /// @brief Logical working directory, as shells report $PWD
+    std::string currentDirectory() const;
+
+    /**
+     * @brief Change the session's working directory
+     *
+     * ".." is applied to the logical path, as cd does by default. The
+     * process working directory is not touched.
+     *
+     * @return 0 or an errno value (ENOENT, ENOTDIR, EACCES)
+     * @thread_safe Yes
+     */
+    int changeDirectory(const std::string& path);
+
+    /// @brief Absolute, lexically normalized form of path
+    std::string absolute(const std::string& path) const;
+
+    /**
+     * @brief stat() path, following symlinks unless follow is false
+     * @return 0 or an errno value
+     * @performance One statx/fstatat on a cached parent directory
+     */
+    int stat(const std::string& path, FsStat& out, bool follow = true);
+
+    /// @brief Check whether path exists
+    bool exists(const std::string& path);
+
+    /// @return 0 or an errno value
+    int createDirectory(const std::string& path, mode_t mode = 0755);
+
+    /**
+     * @brief List a directory, excluding "." and ".."
+     * @return 0 or an errno value
+     * @performance One open and getdents64 per 32 KB of entries
+     */
+    int listDirectory(const std::string& path, std::vector<FsEntry>& out);
+
+    /**
+     * @brief open() path relative to its cached parent directory
+     * @return A new fd owned by the caller, or -1 with errno set
+     */
+    int openFile(const std::string& path, int flags, mode_t mode = 0);
+
+    /**
+     * @brief Expand * ? and [...] in each path component
+     *
+     * Dot files match only a component pattern that starts with a dot.
+     * Relative patterns give relative results.
+     *
+     * @return Sorted matches; empty if nothing matched
+     */
+    std::vector<std::string> glob(const std::string& pattern);
+
+    /**
+     * @brief Completions for the last component of a partial path
+     *
+     * Directories get a trailing slash. Dot files are offered only for a
+     * prefix that starts with a dot.
+     *
+     * @return Sorted candidates, each the full completed string
+     */
+    std::vector<std::string> complete(const std::string& partial);
+
+    /// @brief Drop every cached directory fd except the working directory
+    void invalidate();
+
+    /// @brief Drop the cached fds of path and every directory below it
+    void invalidate(const std::string& path);
+
+    FsContextMetrics getMetrics() const;
+
+private:
+    /// Owned directory fd, shared so a lookup can outlive its eviction
+    class DirFd {
+    public:
+        explicit DirFd(int fd) : fd_(fd) {}
+        ~DirFd();
+        DirFd(const DirFd&) = delete;
+        DirFd& operator=(const DirFd&) = delete;
+        int get() const noexcept { return fd_; }
+    private:
+        int fd_;
+    };
+    using DirPtr = std::shared_ptr<DirFd>;
+
+    struct CacheEntry {
+        DirPtr dir;
+        std::chrono::steady_clock::time_point opened;
+        std::list<std::string>::iterator lru;
+    };
+
+    const size_t capacity_;
+    const std::chrono::milliseconds ttl_;
+
+    mutable std::mutex mutex_;
+    std::string cwd_path_;
+    DirPtr cwd_;
+    std::unordered_map<std::string, CacheEntry> cache_;
+    std::list<std::string> lru_;   ///< Most recently used first
+    FsContextMetrics metrics_;
+
+    /**
+     * @brief Resolve path to a directory fd and the name within it
+     *
+     * name is "." when path names the directory itself. Paths with ".."
+     * components resolve physically, relative to the working directory
+     * fd, without the cache.
+     */
+    DirPtr resolveParent(const std::string& path, std::string& name);
+    /// Directory fd for an absolute normalized path, opened if not cached
+    DirPtr lookupLocked(const std::string& dir);
+    void insertLocked(const std::string& dir, const DirPtr& fd);
+    void evictLocked(std::unordered_map<std::string, CacheEntry>::iterator it);
+
+    void globInto(const std::string& base, const std::vector<std::string>& components,
+                  size_t index, std::vector<std::string>& out);
+};
+
+} // namespace core
+} // namespace cross_terminal
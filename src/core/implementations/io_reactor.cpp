@@ -0,0 +1,493 @@
+#include "io_reactor.h"
+#include "thread_registry.h"
+#include <algorithm>
+#include <chrono>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+namespace {
+
+constexpr int MAX_EVENTS = 64;
+
+#ifdef __linux__
+uint32_t toNative(uint32_t events) noexcept {
+    uint32_t native = 0;
+    if (events & IoReactor::Readable) native |= EPOLLIN | EPOLLRDHUP;
+    if (events & IoReactor::Writable) native |= EPOLLOUT;
+    if (events & IoReactor::Priority) native |= EPOLLPRI;
+    return native;
+}
+
+uint32_t fromNative(uint32_t native) noexcept {
+    uint32_t events = 0;
+    if (native & EPOLLIN) events |= IoReactor::Readable;
+    if (native & EPOLLOUT) events |= IoReactor::Writable;
+    if (native & EPOLLPRI) events |= IoReactor::Priority;
+    if (native & (EPOLLHUP | EPOLLRDHUP)) events |= IoReactor::HangUp;
+    if (native & EPOLLERR) events |= IoReactor::Error;
+    return events;
+}
+#else
+short toNative(uint32_t events) noexcept {
+    short native = 0;
+    if (events & IoReactor::Readable) native |= POLLIN;
+    if (events & IoReactor::Writable) native |= POLLOUT;
+    if (events & IoReactor::Priority) native |= POLLPRI;
+    return native;
+}
+
+uint32_t fromNative(short native) noexcept {
+    uint32_t events = 0;
+    if (native & POLLIN) events |= IoReactor::Readable;
+    if (native & POLLOUT) events |= IoReactor::Writable;
+    if (native & POLLPRI) events |= IoReactor::Priority;
+    if (native & POLLHUP) events |= IoReactor::HangUp;
+    if (native & (POLLERR | POLLNVAL)) events |= IoReactor::Error;
+    return events;
+}
+#endif
+
+} // namespace
+
+IoReactor::IoReactor(size_t thread_count)
+    : running_(false), next_timer_id_(1), next_loop_(0) {
+    thread_count = std::max<size_t>(thread_count, 1);
+    loops_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        loops_.push_back(std::make_unique<Loop>());
+    }
+}
+
+IoReactor::~IoReactor() {
+    stop();
+}
+
+bool IoReactor::start() {
+    if (running_.exchange(true)) {
+        return true; // Already running
+    }
+
+    for (auto& loop : loops_) {
+        if (!openLoop(*loop)) {
+            stop();
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < loops_.size(); ++i) {
+        Loop* raw = loops_[i].get();
+        raw->thread = std::thread([this, raw, i]() {
+            auto registration = ThreadRegistry::instance().enter(
+                ThreadRole::Reactor, "ct-reactor-" + std::to_string(i));
+            run(*raw);
+        });
+    }
+
+    return true;
+}
+
+void IoReactor::stop() noexcept {
+    running_.store(false);
+
+    for (auto& loop : loops_) {
+        wake(*loop);
+    }
+
+    for (auto& loop : loops_) {
+        if (loop->thread.joinable()) {
+            loop->thread.join();
+        }
+        closeLoop(*loop);
+    }
+}
+
+bool IoReactor::add(int fd, uint32_t events, EventHandler handler, int affinity) {
+    if (fd < 0 || !handler) {
+        return false;
+    }
+
+    auto registration = std::make_shared<Registration>();
+    registration->fd = fd;
+    registration->events = events;
+    registration->handler = std::move(handler);
+
+    const size_t key = static_cast<size_t>(affinity >= 0 ? affinity : fd);
+    Loop& loop = *loops_[key % loops_.size()];
+    {
+        std::unique_lock map_lock(fd_loops_mutex_);
+        if (!fd_loops_.emplace(fd, &loop).second) {
+            return false; // Already registered
+        }
+    }
+    {
+        std::lock_guard lock(loop.mutex);
+
+#ifdef __linux__
+        // Before start() the loop has no epoll instance yet; openLoop() adds it
+        struct epoll_event ev{};
+        ev.events = toNative(events);
+        ev.data.fd = fd;
+        if (loop.poll_fd >= 0 && epoll_ctl(loop.poll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            std::unique_lock map_lock(fd_loops_mutex_);
+            fd_loops_.erase(fd);
+            return false;
+        }
+#endif
+        loop.registrations.emplace(fd, std::move(registration));
+    }
+
+    wake(loop);
+    return true;
+}
+
+bool IoReactor::modify(int fd, uint32_t events) {
+    Loop* owner = loopFor(fd);
+    if (!owner) {
+        return false;
+    }
+
+    Loop& loop = *owner;
+    {
+        std::lock_guard lock(loop.mutex);
+        auto it = loop.registrations.find(fd);
+        if (it == loop.registrations.end()) {
+            return false;
+        }
+
+#ifdef __linux__
+        struct epoll_event ev{};
+        ev.events = toNative(events);
+        ev.data.fd = fd;
+        if (loop.poll_fd >= 0 && epoll_ctl(loop.poll_fd, EPOLL_CTL_MOD, fd, &ev) != 0) {
+            return false;
+        }
+#endif
+        it->second->events = events;
+    }
+
+    wake(loop);
+    return true;
+}
+
+bool IoReactor::setPriority(int fd, bool high) {
+    Loop* owner = loopFor(fd);
+    if (!owner) {
+        return false;
+    }
+
+    std::lock_guard lock(owner->mutex);
+    auto it = owner->registrations.find(fd);
+    if (it == owner->registrations.end()) {
+        return false;
+    }
+    it->second->high_priority.store(high);
+    return true;
+}
+
+void IoReactor::remove(int fd) noexcept {
+    Loop* owner = loopFor(fd);
+    if (!owner) {
+        return;
+    }
+
+    Loop& loop = *owner;
+    std::shared_ptr<Registration> registration;
+    {
+        std::unique_lock map_lock(fd_loops_mutex_);
+        fd_loops_.erase(fd);
+    }
+    {
+        std::lock_guard lock(loop.mutex);
+        auto it = loop.registrations.find(fd);
+        if (it == loop.registrations.end()) {
+            return;
+        }
+        registration = std::move(it->second);
+        loop.registrations.erase(it);
+
+#ifdef __linux__
+        if (loop.poll_fd >= 0) {
+            epoll_ctl(loop.poll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        }
+#endif
+    }
+
+    registration->active.store(false);
+
+    // Wait out a handler running concurrently on the owning loop
+    if (loop.thread_id.load() != std::this_thread::get_id()) {
+        std::lock_guard dispatch_lock(registration->dispatch_mutex);
+    }
+}
+
+void IoReactor::post(Task task) {
+    if (!task) {
+        return;
+    }
+
+    Loop& loop = *loops_[next_loop_.fetch_add(1, std::memory_order_relaxed) % loops_.size()];
+    {
+        std::lock_guard lock(loop.mutex);
+        loop.pending.push_back(std::move(task));
+    }
+    wake(loop);
+}
+
+IoReactor::TimerId IoReactor::schedule(uint32_t delay_ms, Task task) {
+    if (!task) {
+        return 0;
+    }
+
+    TimerId id = next_timer_id_.fetch_add(1, std::memory_order_relaxed);
+    Loop& loop = *loops_[id % loops_.size()];
+    {
+        std::lock_guard lock(loop.mutex);
+        loop.timers.push(Timer{nowMs() + delay_ms, id, std::move(task)});
+        loop.live_timers.insert(id);
+    }
+    wake(loop);
+    return id;
+}
+
+bool IoReactor::cancel(TimerId id) noexcept {
+    if (id == 0) {
+        return false;
+    }
+
+    Loop& loop = *loops_[id % loops_.size()];
+    std::lock_guard lock(loop.mutex);
+    return loop.live_timers.erase(id) > 0;
+}
+
+bool IoReactor::isReactorThread() const noexcept {
+    const auto self = std::this_thread::get_id();
+    for (const auto& loop : loops_) {
+        if (loop->thread_id.load() == self) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t IoReactor::registrationCount() const noexcept {
+    size_t count = 0;
+    for (const auto& loop : loops_) {
+        std::lock_guard lock(loop->mutex);
+        count += loop->registrations.size();
+    }
+    return count;
+}
+
+// Private methods
+IoReactor::Loop* IoReactor::loopFor(int fd) const noexcept {
+    std::shared_lock lock(fd_loops_mutex_);
+    auto it = fd_loops_.find(fd);
+    return it != fd_loops_.end() ? it->second : nullptr;
+}
+
+bool IoReactor::openLoop(Loop& loop) {
+    if (pipe(loop.wake_fds) != 0) {
+        return false;
+    }
+    for (int fd : loop.wake_fds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+#ifdef __linux__
+    loop.poll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop.poll_fd < 0) {
+        return false;
+    }
+
+    struct epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = loop.wake_fds[0];
+    if (epoll_ctl(loop.poll_fd, EPOLL_CTL_ADD, loop.wake_fds[0], &ev) != 0) {
+        return false;
+    }
+
+    // Descriptors registered before start()
+    std::lock_guard lock(loop.mutex);
+    for (const auto& [fd, registration] : loop.registrations) {
+        struct epoll_event reg_ev{};
+        reg_ev.events = toNative(registration->events);
+        reg_ev.data.fd = fd;
+        epoll_ctl(loop.poll_fd, EPOLL_CTL_ADD, fd, &reg_ev);
+    }
+#endif
+
+    return true;
+}
+
+void IoReactor::closeLoop(Loop& loop) noexcept {
+    if (loop.poll_fd >= 0) {
+        ::close(loop.poll_fd);
+        loop.poll_fd = -1;
+    }
+    for (int& fd : loop.wake_fds) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+void IoReactor::run(Loop& loop) {
+    loop.thread_id.store(std::this_thread::get_id());
+
+#ifdef __linux__
+    struct epoll_event events[MAX_EVENTS];
+#else
+    std::vector<struct pollfd> poll_fds;
+#endif
+    std::vector<ReadyEvent> ready_events;
+
+    while (running_.load()) {
+        int timeout = nextTimeout(loop);
+        ready_events.clear();
+
+#ifdef __linux__
+        int ready = epoll_wait(loop.poll_fd, events, MAX_EVENTS, timeout);
+        if (ready > 0) {
+            std::lock_guard lock(loop.mutex);
+            for (int i = 0; i < ready; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == loop.wake_fds[0]) {
+                    char drain[64];
+                    while (read(fd, drain, sizeof(drain)) > 0) {}
+                    continue;
+                }
+                auto it = loop.registrations.find(fd);
+                if (it != loop.registrations.end()) {
+                    ready_events.push_back({it->second, fromNative(events[i].events)});
+                }
+            }
+        }
+#else
+        poll_fds.clear();
+        poll_fds.push_back({loop.wake_fds[0], POLLIN, 0});
+        {
+            std::lock_guard lock(loop.mutex);
+            for (const auto& [fd, registration] : loop.registrations) {
+                poll_fds.push_back({fd, toNative(registration->events), 0});
+            }
+        }
+
+        int ready = poll(poll_fds.data(), poll_fds.size(), timeout);
+        if (ready > 0) {
+            if (poll_fds[0].revents & POLLIN) {
+                char drain[64];
+                while (read(loop.wake_fds[0], drain, sizeof(drain)) > 0) {}
+            }
+
+            std::lock_guard lock(loop.mutex);
+            for (size_t i = 1; i < poll_fds.size(); ++i) {
+                if (!poll_fds[i].revents) {
+                    continue;
+                }
+                auto it = loop.registrations.find(poll_fds[i].fd);
+                if (it != loop.registrations.end()) {
+                    ready_events.push_back({it->second, fromNative(poll_fds[i].revents)});
+                }
+            }
+        }
+#endif
+
+        dispatchReady(ready_events);
+        runDueTimers(loop);
+        runPending(loop);
+    }
+
+    loop.thread_id.store(std::thread::id());
+}
+
+void IoReactor::wake(Loop& loop) noexcept {
+    if (loop.wake_fds[1] >= 0) {
+        char byte = 1;
+        ssize_t ignored = write(loop.wake_fds[1], &byte, 1);
+        (void)ignored;
+    }
+}
+
+int IoReactor::nextTimeout(Loop& loop) {
+    std::lock_guard lock(loop.mutex);
+    if (!loop.pending.empty()) {
+        return 0;
+    }
+
+    // Drop cancelled timers sitting at the head of the queue
+    while (!loop.timers.empty() && !loop.live_timers.count(loop.timers.top().id)) {
+        loop.timers.pop();
+    }
+
+    if (loop.timers.empty()) {
+        return -1;
+    }
+
+    uint64_t now = nowMs();
+    uint64_t deadline = loop.timers.top().deadline_ms;
+    return deadline <= now ? 0 : static_cast<int>(deadline - now);
+}
+
+void IoReactor::runDueTimers(Loop& loop) {
+    std::vector<Task> due;
+    {
+        std::lock_guard lock(loop.mutex);
+        uint64_t now = nowMs();
+        while (!loop.timers.empty() && loop.timers.top().deadline_ms <= now) {
+            Timer timer = std::move(const_cast<Timer&>(loop.timers.top()));
+            loop.timers.pop();
+            if (loop.live_timers.erase(timer.id)) {
+                due.push_back(std::move(timer.task));
+            }
+        }
+    }
+
+    for (auto& task : due) {
+        task();
+    }
+}
+
+void IoReactor::runPending(Loop& loop) {
+    std::vector<Task> pending;
+    {
+        std::lock_guard lock(loop.mutex);
+        pending.swap(loop.pending);
+    }
+
+    for (auto& task : pending) {
+        task();
+    }
+}
+
+void IoReactor::dispatchReady(std::vector<ReadyEvent>& ready) {
+    // Latency-sensitive descriptors go first; the rest keep kernel order
+    std::stable_partition(ready.begin(), ready.end(), [](const ReadyEvent& event) {
+        return event.registration->high_priority.load(std::memory_order_relaxed);
+    });
+
+    for (auto& event : ready) {
+        std::lock_guard dispatch_lock(event.registration->dispatch_mutex);
+        if (event.registration->active.load()) {
+            event.registration->handler(event.registration->fd, event.events);
+        }
+    }
+}
+
+uint64_t IoReactor::nowMs() noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,565 @@
+#include "job_history.h"
+#include "memory/memory_budget.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cross_terminal {
+namespace core {
+
+namespace {
+
+constexpr uint32_t META_MAGIC = 0x484a5443;   // "CTJH"
+constexpr uint32_t META_VERSION = 1;
+constexpr size_t INITIAL_HEAP_SIZE = 1024 * 1024;
+constexpr size_t INITIAL_DICTIONARY_SIZE = 64 * 1024;
+
+struct MetaHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t count;             ///< Committed records
+    uint64_t details_size;      ///< Used bytes of the details heap
+    uint64_t dictionary_size;   ///< Used bytes of the command dictionary
+};
+
+uint64_t nowMs() noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint32_t clampU32(uint64_t value) noexcept {
+    return static_cast<uint32_t>(std::min<uint64_t>(value, UINT32_MAX));
+}
+
+void putString(std::string& out, std::string_view value) {
+    uint32_t length = static_cast<uint32_t>(value.size());
+    out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.append(value);
+}
+
+std::string_view getString(const char*& cursor) {
+    uint32_t length;
+    std::memcpy(&length, cursor, sizeof(length));
+    cursor += sizeof(length);
+    std::string_view value(cursor, length);
+    cursor += length;
+    return value;
+}
+
+} // namespace
+
+/**
+ * @brief Growable MAP_SHARED file mapping
+ */
+class JobHistory::MappedFile {
+public:
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& path, size_t min_size) {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd_, &st) != 0) {
+            return false;
+        }
+        return map(std::max(static_cast<size_t>(st.st_size), min_size));
+    }
+
+    bool resize(size_t size) {
+        return size <= size_ || map(size);
+    }
+
+    void sync() noexcept {
+        if (base_) {
+            msync(base_, size_, MS_ASYNC);
+        }
+    }
+
+    // Drop resident pages; dirty ones stay in the page cache for writeback
+    size_t release() noexcept {
+        if (base_ && madvise(base_, size_, MADV_DONTNEED) == 0) {
+            return size_;
+        }
+        return 0;
+    }
+
+    void close() noexcept {
+        if (base_) {
+            munmap(base_, size_);
+            memory::MemoryBudget::instance().release(memory::MemoryTag::History, size_);
+            base_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        size_ = 0;
+    }
+
+    template<typename T>
+    T* as() const noexcept { return reinterpret_cast<T*>(base_); }
+
+    size_t size() const noexcept { return size_; }
+
+private:
+    int fd_ = -1;
+    char* base_ = nullptr;
+    size_t size_ = 0;
+
+    // The current mapping is replaced only once the new one exists, so a
+    // failed grow leaves the file usable at its old size
+    bool map(size_t size) {
+        if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+            return false;
+        }
+        void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (base == MAP_FAILED) {
+            return false;
+        }
+        if (base_) {
+            munmap(base_, size_);
+            memory::MemoryBudget::instance().release(memory::MemoryTag::History, size_);
+        }
+        base_ = static_cast<char*>(base);
+        size_ = size;
+        memory::MemoryBudget::instance().charge(memory::MemoryTag::History, size_);
+        return true;
+    }
+};
+
+JobHistory::JobHistory()
+    : capacity_(0) {
+}
+
+JobHistory::~JobHistory() {
+    close();
+}
+
+bool JobHistory::open(const std::string& directory) {
+    std::unique_lock lock(mutex_);
+    if (meta_) {
+        return true; // Already open
+    }
+
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        return false;
+    }
+
+    auto openFile = [&](std::unique_ptr<MappedFile>& file, const char* name, size_t min_size) {
+        file = std::make_unique<MappedFile>();
+        return file->open(directory + "/" + name, min_size);
+    };
+
+    std::unique_ptr<MappedFile> meta;
+    if (!openFile(meta, "meta", sizeof(MetaHeader))) {
+        return false;
+    }
+    auto* header = meta->as<MetaHeader>();
+    if (header->magic == 0) {
+        header->magic = META_MAGIC;
+        header->version = META_VERSION;
+    } else if (header->magic != META_MAGIC || header->version != META_VERSION) {
+        return false;
+    }
+
+    capacity_ = std::max<size_t>(INITIAL_CAPACITY, header->count);
+    bool opened = openFile(end_time_, "end_time.col", capacity_ * sizeof(uint64_t)) &&
+                  openFile(duration_, "duration.col", capacity_ * sizeof(uint32_t)) &&
+                  openFile(exit_code_, "exit_code.col", capacity_ * sizeof(int32_t)) &&
+                  openFile(state_, "state.col", capacity_ * sizeof(uint8_t)) &&
+                  openFile(command_id_, "command.col", capacity_ * sizeof(uint32_t)) &&
+                  openFile(cpu_time_, "cpu_time.col", capacity_ * 2 * sizeof(uint32_t)) &&
+                  openFile(max_rss_, "max_rss.col", capacity_ * sizeof(uint32_t)) &&
+                  openFile(detail_offset_, "detail_offset.col", capacity_ * sizeof(uint64_t)) &&
+                  openFile(details_, "details.heap",
+                           std::max<size_t>(INITIAL_HEAP_SIZE, header->details_size)) &&
+                  openFile(dictionary_, "commands.dict",
+                           std::max<size_t>(INITIAL_DICTIONARY_SIZE, header->dictionary_size));
+    meta_ = std::move(meta);
+
+    if (!opened || !loadDictionary()) {
+        lock.unlock();
+        close();
+        return false;
+    }
+
+    const size_t records = count();
+    for (size_t record = 0; record < records; ++record) {
+        indexRecord(static_cast<uint32_t>(record));
+    }
+    return true;
+}
+
+void JobHistory::close() noexcept {
+    std::unique_lock lock(mutex_);
+    for (auto* file : {&meta_, &end_time_, &duration_, &exit_code_, &state_, &command_id_,
+                       &cpu_time_, &max_rss_, &detail_offset_, &details_, &dictionary_}) {
+        if (*file) {
+            (*file)->sync();
+            file->reset();
+        }
+    }
+
+    capacity_ = 0;
+    commands_.clear();
+    command_ids_.clear();
+    zones_.clear();
+    by_command_.clear();
+    by_exit_code_.clear();
+    failed_.clear();
+}
+
+bool JobHistory::isOpen() const noexcept {
+    std::shared_lock lock(mutex_);
+    return meta_ != nullptr;
+}
+
+bool JobHistory::append(const ProcessInfo& info) {
+    std::unique_lock lock(mutex_);
+    if (!meta_) {
+        return false;
+    }
+
+    const size_t record = count();
+    if (record >= UINT32_MAX || !reserve(record + 1)) {
+        return false;
+    }
+
+    std::string detail;
+    uint32_t argc = static_cast<uint32_t>(info.arguments.size());
+    detail.append(reinterpret_cast<const char*>(&argc), sizeof(argc));
+    for (const auto& argument : info.arguments) {
+        putString(detail, argument.view());
+    }
+    putString(detail, info.working_dir.view());
+
+    const uint64_t detail_offset = detailsSize();
+    if (detail_offset + detail.size() > details_->size() &&
+        !details_->resize(std::max(details_->size() * 2, detail_offset + detail.size()))) {
+        return false;
+    }
+    std::memcpy(details_->as<char>() + detail_offset, detail.data(), detail.size());
+
+    const uint64_t end_time = info.end_time ? info.end_time : nowMs();
+    const uint32_t command_id = internCommand(info.command);
+    if (command_id == UINT32_MAX) {
+        return false;
+    }
+
+    end_time_->as<uint64_t>()[record] = end_time;
+    duration_->as<uint32_t>()[record] =
+        clampU32(end_time > info.start_time && info.start_time ? end_time - info.start_time : 0);
+    exit_code_->as<int32_t>()[record] = info.exit_code;
+    state_->as<uint8_t>()[record] = static_cast<uint8_t>(info.state);
+    command_id_->as<uint32_t>()[record] = command_id;
+    cpu_time_->as<uint32_t>()[record * 2] = clampU32(info.user_time_ms);
+    cpu_time_->as<uint32_t>()[record * 2 + 1] = clampU32(info.system_time_ms);
+    max_rss_->as<uint32_t>()[record] = clampU32(info.max_rss_kb);
+    detail_offset_->as<uint64_t>()[record] = detail_offset;
+
+    commit(record + 1, detail_offset + detail.size());
+    indexRecord(static_cast<uint32_t>(record));
+    return true;
+}
+
+std::vector<JobRecord> JobHistory::query(const JobQuery& query) const {
+    std::shared_lock lock(mutex_);
+    std::vector<JobRecord> results;
+    if (!meta_) {
+        return results;
+    }
+
+    uint32_t command_id = UINT32_MAX;
+    if (!query.command.empty()) {
+        auto it = command_ids_.find(memory::InternedString(query.command));
+        if (it == command_ids_.end()) {
+            return results;
+        }
+        command_id = it->second;
+    }
+
+    // Drive the scan from the smallest posting list, if any filter has one
+    const std::vector<uint32_t>* postings = nullptr;
+    auto consider = [&postings](const std::vector<uint32_t>* candidate) {
+        if (!postings || candidate->size() < postings->size()) {
+            postings = candidate;
+        }
+    };
+    static const std::vector<uint32_t> empty;
+    if (command_id != UINT32_MAX) {
+        consider(&by_command_[command_id]);
+    }
+    if (query.match_exit_code) {
+        auto it = by_exit_code_.find(query.exit_code);
+        consider(it != by_exit_code_.end() ? &it->second : &empty);
+    }
+    if (query.failed_only) {
+        consider(&failed_);
+    }
+
+    const size_t first = firstRecordSince(query.since);
+    auto collect = [&](uint32_t record) {
+        if (matches(record, query, command_id)) {
+            results.push_back(materialize(record));
+        }
+        return query.limit == 0 || results.size() < query.limit;
+    };
+
+    if (postings) {
+        auto begin = std::lower_bound(postings->begin(), postings->end(), first);
+        for (auto it = postings->end(); it != begin;) {
+            if (!collect(*--it)) {
+                break;
+            }
+        }
+        return results;
+    }
+
+    // Time-only query: walk blocks newest first, skipping by zone map
+    for (size_t block = zones_.size(); block-- > first / BLOCK_SIZE;) {
+        const BlockZone& zone = zones_[block];
+        if (zone.max_end < query.since || zone.min_end > query.until) {
+            continue;
+        }
+        const size_t block_end = std::min(count(), (block + 1) * BLOCK_SIZE);
+        for (size_t record = block_end; record-- > block * BLOCK_SIZE;) {
+            if (!collect(static_cast<uint32_t>(record))) {
+                return results;
+            }
+        }
+    }
+    return results;
+}
+
+size_t JobHistory::size() const noexcept {
+    std::shared_lock lock(mutex_);
+    return meta_ ? count() : 0;
+}
+
+void JobHistory::flush() noexcept {
+    std::shared_lock lock(mutex_);
+    for (auto* file : {&meta_, &end_time_, &duration_, &exit_code_, &state_, &command_id_,
+                       &cpu_time_, &max_rss_, &detail_offset_, &details_, &dictionary_}) {
+        if (*file) {
+            (*file)->sync();
+        }
+    }
+}
+
+size_t JobHistory::releaseMemory() noexcept {
+    // Appends only touch the tail; concurrent readers fault pages back in
+    std::shared_lock lock(mutex_);
+    size_t released = 0;
+    for (auto* file : {&end_time_, &duration_, &exit_code_, &state_, &command_id_,
+                       &cpu_time_, &max_rss_, &detail_offset_, &details_, &dictionary_}) {
+        if (*file) {
+            released += (*file)->release();
+        }
+    }
+    return released;
+}
+
+bool JobHistory::parseDuration(const std::string& text, uint64_t& millis) noexcept {
+    size_t digits = 0;
+    uint64_t value = 0;
+    while (digits < text.size() && text[digits] >= '0' && text[digits] <= '9') {
+        value = value * 10 + static_cast<uint64_t>(text[digits] - '0');
+        if (value > UINT32_MAX) {
+            return false;
+        }
+        ++digits;
+    }
+    if (digits == 0) {
+        return false;
+    }
+
+    const std::string unit = text.substr(digits);
+    uint64_t scale;
+    if (unit == "ms") {
+        scale = 1;
+    } else if (unit.empty() || unit == "s") {
+        scale = 1000;
+    } else if (unit == "m") {
+        scale = 60 * 1000;
+    } else if (unit == "h") {
+        scale = 60 * 60 * 1000;
+    } else if (unit == "d") {
+        scale = 24 * 60 * 60 * 1000;
+    } else if (unit == "w") {
+        scale = 7 * 24 * 60 * 60 * 1000;
+    } else {
+        return false;
+    }
+
+    millis = value * scale;
+    return true;
+}
+
+size_t JobHistory::count() const noexcept {
+    return static_cast<size_t>(meta_->as<MetaHeader>()->count);
+}
+
+uint64_t JobHistory::detailsSize() const noexcept {
+    return meta_->as<MetaHeader>()->details_size;
+}
+
+void JobHistory::commit(size_t count, uint64_t details_size) noexcept {
+    // Column data is written before the count that makes it visible
+    auto* header = meta_->as<MetaHeader>();
+    header->details_size = details_size;
+    __atomic_store_n(&header->count, static_cast<uint64_t>(count), __ATOMIC_RELEASE);
+}
+
+bool JobHistory::reserve(size_t records) {
+    if (records <= capacity_) {
+        return true;
+    }
+
+    const size_t capacity = std::max(capacity_ * 2, records);
+
+    bool grown = end_time_->resize(capacity * sizeof(uint64_t)) &&
+                 duration_->resize(capacity * sizeof(uint32_t)) &&
+                 exit_code_->resize(capacity * sizeof(int32_t)) &&
+                 state_->resize(capacity * sizeof(uint8_t)) &&
+                 command_id_->resize(capacity * sizeof(uint32_t)) &&
+                 cpu_time_->resize(capacity * 2 * sizeof(uint32_t)) &&
+                 max_rss_->resize(capacity * sizeof(uint32_t)) &&
+                 detail_offset_->resize(capacity * sizeof(uint64_t));
+    if (grown) {
+        capacity_ = capacity;
+    }
+    return grown;
+}
+
+bool JobHistory::loadDictionary() {
+    const uint64_t used = meta_->as<MetaHeader>()->dictionary_size;
+    if (used > dictionary_->size()) {
+        return false;
+    }
+
+    const char* cursor = dictionary_->as<char>();
+    const char* end = cursor + used;
+    while (cursor < end) {
+        memory::InternedString command = getString(cursor);
+        command_ids_.emplace(command, static_cast<uint32_t>(commands_.size()));
+        commands_.push_back(std::move(command));
+    }
+    by_command_.resize(commands_.size());
+    return cursor == end;
+}
+
+uint32_t JobHistory::internCommand(const memory::InternedString& command) {
+    auto it = command_ids_.find(command);
+    if (it != command_ids_.end()) {
+        return it->second;
+    }
+
+    std::string entry;
+    putString(entry, command.view());
+
+    auto* header = meta_->as<MetaHeader>();
+    const uint64_t offset = header->dictionary_size;
+    if (offset + entry.size() > dictionary_->size() &&
+        !dictionary_->resize(std::max(dictionary_->size() * 2, offset + entry.size()))) {
+        return UINT32_MAX;
+    }
+    header = meta_->as<MetaHeader>();
+    std::memcpy(dictionary_->as<char>() + offset, entry.data(), entry.size());
+    header->dictionary_size = offset + entry.size();
+
+    const uint32_t id = static_cast<uint32_t>(commands_.size());
+    commands_.push_back(command);
+    command_ids_.emplace(command, id);
+    by_command_.emplace_back();
+    return id;
+}
+
+void JobHistory::indexRecord(uint32_t record) {
+    const uint64_t end_time = end_time_->as<uint64_t>()[record];
+    const size_t block = record / BLOCK_SIZE;
+    if (zones_.size() <= block) {
+        zones_.resize(block + 1);
+    }
+    zones_[block].min_end = std::min(zones_[block].min_end, end_time);
+    zones_[block].max_end = std::max(zones_[block].max_end, end_time);
+
+    const uint32_t command_id = command_id_->as<uint32_t>()[record];
+    if (command_id < by_command_.size()) {
+        by_command_[command_id].push_back(record);
+    }
+
+    by_exit_code_[exit_code_->as<int32_t>()[record]].push_back(record);
+    if (state_->as<uint8_t>()[record] != static_cast<uint8_t>(ProcessState::Completed)) {
+        failed_.push_back(record);
+    }
+}
+
+bool JobHistory::matches(uint32_t record, const JobQuery& query,
+                         uint32_t command_id) const noexcept {
+    const uint64_t end_time = end_time_->as<uint64_t>()[record];
+    if (end_time < query.since || end_time > query.until) {
+        return false;
+    }
+    if (command_id != UINT32_MAX && command_id_->as<uint32_t>()[record] != command_id) {
+        return false;
+    }
+    if (query.failed_only &&
+        state_->as<uint8_t>()[record] == static_cast<uint8_t>(ProcessState::Completed)) {
+        return false;
+    }
+    if (query.match_exit_code && exit_code_->as<int32_t>()[record] != query.exit_code) {
+        return false;
+    }
+    return true;
+}
+
+size_t JobHistory::firstRecordSince(uint64_t since) const noexcept {
+    // Records are appended in completion order, so end times only drift
+    // within a block; whole blocks before `since` can be skipped
+    for (size_t block = 0; block < zones_.size(); ++block) {
+        if (zones_[block].max_end >= since) {
+            return block * BLOCK_SIZE;
+        }
+    }
+    return zones_.size() * BLOCK_SIZE;
+}
+
+JobRecord JobHistory::materialize(uint32_t record) const {
+    JobRecord job;
+    job.end_time = end_time_->as<uint64_t>()[record];
+    job.start_time = job.end_time - duration_->as<uint32_t>()[record];
+    job.exit_code = exit_code_->as<int32_t>()[record];
+    job.state = static_cast<ProcessState>(state_->as<uint8_t>()[record]);
+    job.user_time_ms = cpu_time_->as<uint32_t>()[record * 2];
+    job.system_time_ms = cpu_time_->as<uint32_t>()[record * 2 + 1];
+    job.max_rss_kb = max_rss_->as<uint32_t>()[record];
+
+    const uint32_t command_id = command_id_->as<uint32_t>()[record];
+    if (command_id < commands_.size()) {
+        job.command = commands_[command_id];
+    }
+
+    const char* cursor = details_->as<char>() + detail_offset_->as<uint64_t>()[record];
+    uint32_t argc;
+    std::memcpy(&argc, cursor, sizeof(argc));
+    cursor += sizeof(argc);
+    job.arguments.reserve(argc);
+    for (uint32_t i = 0; i < argc; ++i) {
+        job.arguments.emplace_back(getString(cursor));
+    }
+    job.working_dir = getString(cursor);
+    return job;
+}
+
+} // namespace core
+} // namespace cross_terminal
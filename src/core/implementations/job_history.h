@@ -0,0 +1,193 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file job_history.h
+ * @brief Archived job history store
+ *
+ * Completed ProcessInfo records are appended to a columnar job log: one
+ * memory-mapped file per fixed-width column, a dictionary of command
+ * names and a heap for arguments and working directories. Queries touch
+ * only the columns they filter on and materialize just the result rows.
+ *
+ * @performance O(1) amortized append; queries use per-block time zone
+ *              maps and posting lists by command and exit code
+ * @thread_safety All public methods are thread-safe
+ * @memory_model Columns are MAP_SHARED mappings grown by doubling; the
+ *               record count in the meta file is the commit point
+ */
+
+namespace cross_terminal {
+namespace core {
+
+/**
+ * @brief One archived job
+ */
+struct JobRecord {
+    uint64_t start_time = 0;      ///< Milliseconds since epoch
+    uint64_t end_time = 0;        ///< Milliseconds since epoch
+    int exit_code = 0;
+    ProcessState state = ProcessState::Completed;
+    uint32_t user_time_ms = 0;
+    uint32_t system_time_ms = 0;
+    uint32_t max_rss_kb = 0;
+    memory::InternedString command;
+    std::vector<memory::InternedString> arguments;
+    memory::InternedString working_dir;
+
+    uint64_t getDuration() const noexcept {
+        return end_time > start_time ? end_time - start_time : 0;
+    }
+
+    bool isFailed() const noexcept {
+        return state != ProcessState::Completed;
+    }
+};
+
+/**
+ * @brief History query, all filters are combined with AND
+ */
+struct JobQuery {
+    uint64_t since = 0;                                      ///< Min end time (ms since epoch)
+    uint64_t until = std::numeric_limits<uint64_t>::max();   ///< Max end time (ms since epoch)
+    std::string command;        ///< Exact command name, empty for any
+    bool failed_only = false;   ///< Only jobs that did not complete successfully
+    bool match_exit_code = false;
+    int exit_code = 0;          ///< Used when match_exit_code is set
+    size_t limit = 0;           ///< Most recent N matches, 0 for all
+};
+
+/**
+ * @brief Memory-mapped columnar job log
+ */
+class JobHistory {
+public:
+    static constexpr size_t BLOCK_SIZE = 4096;               ///< Records per zone map entry
+    static constexpr size_t INITIAL_CAPACITY = 64 * 1024;    ///< Records
+
+    JobHistory();
+    ~JobHistory();
+
+    // Non-copyable, non-movable
+    JobHistory(const JobHistory&) = delete;
+    JobHistory& operator=(const JobHistory&) = delete;
+    JobHistory(JobHistory&&) = delete;
+    JobHistory& operator=(JobHistory&&) = delete;
+
+    /**
+     * @brief Open or create a job log
+     * @param directory Directory holding the column files (created if missing)
+     * @return true if the log is ready; indexes are rebuilt from the columns
+     * @thread_safe Yes
+     * @performance O(n) index rebuild
+     */
+    bool open(const std::string& directory);
+
+    /**
+     * @brief Flush mappings and close the log
+     * @exception_safety No-throw guarantee
+     */
+    void close() noexcept;
+
+    /// @brief Check if a log is open
+    bool isOpen() const noexcept;
+
+    /**
+     * @brief Archive a finished process
+     * @return false if the log is closed or could not grow
+     * @thread_safe Yes
+     * @performance O(1) amortized
+     */
+    bool append(const ProcessInfo& info);
+
+    /**
+     * @brief Find matching jobs, newest first
+     * @thread_safe Yes - concurrent with append()
+     * @performance Proportional to the smallest candidate set, not the log size
+     */
+    std::vector<JobRecord> query(const JobQuery& query) const;
+
+    /// @brief Number of archived jobs
+    size_t size() const noexcept;
+
+    /**
+     * @brief Write dirty pages back to storage
+     * @thread_safe Yes
+     */
+    void flush() noexcept;
+
+    /**
+     * @brief Drop the resident pages of all column mappings
+     *
+     * Pages are reloaded from the files on the next query. Used as a
+     * recomputable cache under memory pressure.
+     *
+     * @return Mapped bytes released
+     * @thread_safe Yes
+     */
+    size_t releaseMemory() noexcept;
+
+    /**
+     * @brief Parse a relative duration such as "90s", "15m", "1h" or "7d"
+     * @param text Number followed by an optional unit (default seconds)
+     * @param millis Parsed duration in milliseconds
+     * @return true on success
+     */
+    static bool parseDuration(const std::string& text, uint64_t& millis) noexcept;
+
+private:
+    class MappedFile;
+
+    struct BlockZone {
+        uint64_t min_end = std::numeric_limits<uint64_t>::max();
+        uint64_t max_end = 0;
+    };
+
+    // Fixed-width columns
+    std::unique_ptr<MappedFile> meta_;
+    std::unique_ptr<MappedFile> end_time_;       ///< uint64_t
+    std::unique_ptr<MappedFile> duration_;       ///< uint32_t, milliseconds
+    std::unique_ptr<MappedFile> exit_code_;      ///< int32_t
+    std::unique_ptr<MappedFile> state_;          ///< uint8_t
+    std::unique_ptr<MappedFile> command_id_;     ///< uint32_t
+    std::unique_ptr<MappedFile> cpu_time_;       ///< uint32_t pair: user, system ms
+    std::unique_ptr<MappedFile> max_rss_;        ///< uint32_t, KiB
+    std::unique_ptr<MappedFile> detail_offset_;  ///< uint64_t into details_
+    std::unique_ptr<MappedFile> details_;        ///< Arguments and working directory
+    std::unique_ptr<MappedFile> dictionary_;     ///< Length-prefixed command names
+
+    size_t capacity_;
+
+    // In-memory indexes, rebuilt on open()
+    std::vector<memory::InternedString> commands_;
+    std::unordered_map<memory::InternedString, uint32_t> command_ids_;
+    std::vector<BlockZone> zones_;
+    std::vector<std::vector<uint32_t>> by_command_;
+    std::unordered_map<int32_t, std::vector<uint32_t>> by_exit_code_;
+    std::vector<uint32_t> failed_;
+
+    mutable std::shared_mutex mutex_;
+
+    size_t count() const noexcept;
+    uint64_t detailsSize() const noexcept;
+    void commit(size_t count, uint64_t details_size) noexcept;
+
+    bool reserve(size_t records);
+    bool loadDictionary();
+    uint32_t internCommand(const memory::InternedString& command);
+    void indexRecord(uint32_t record);
+    bool matches(uint32_t record, const JobQuery& query, uint32_t command_id) const noexcept;
+    size_t firstRecordSince(uint64_t since) const noexcept;
+    JobRecord materialize(uint32_t record) const;
+};
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,492 @@
+#include "managed_process.h"
+#include <algorithm>
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <sys/wait.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <climits>
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+uint64_t ManagedProcess::steadyMicros() noexcept {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ManagedProcess::ManagedProcess(int pid, const std::string& command, 
+                              const ArgumentList& args,
+                              IoReactor* reactor,
+                              SessionIoContext* io_context)
+    : running_(false), io_thread_active_(false)
+    , reactor_(reactor), open_streams_(0)
+    , io_context_(io_context), deficit_(0), input_pending_since_us_(0)
+    , stdout_watched_(false), stderr_watched_(false) {
+    info_.pid = pid;
+    info_.command = command;
+    info_.arguments.assign(args.begin(), args.end());
+    info_.state = ProcessState::NotStarted;
+    info_.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+ManagedProcess::~ManagedProcess() {
+    teardown();
+}
+
+void ManagedProcess::teardown() noexcept {
+    if (running_.load()) {
+        terminate(true); // Force termination
+    }
+    
+    io_thread_active_.store(false);
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+    
+    reactor_guard_.invalidate();
+    detachFromReactor();
+    
+#ifndef _WIN32
+    // Never leave a zombie behind, even if a reap was still pending
+    if (handle_.pid > 0) {
+        kill(handle_.pid, SIGKILL);
+        waitpid(handle_.pid, nullptr, 0);
+        handle_.pid = -1;
+    }
+#endif
+}
+
+void ManagedProcess::recycle() noexcept {
+    teardown();
+    handle_.close();
+    io_.recycle();
+    
+    // info_ is kept until reuse(): a repeated command finds its strings
+    // still interned
+    running_.store(false);
+    open_streams_.store(0);
+    reactor_ = nullptr;
+    io_context_ = nullptr;
+    deficit_ = 0;
+    input_pending_since_us_.store(0);
+    output_callback_ = nullptr;
+    completion_callback_ = nullptr;
+    callback_channel_.reset();
+    stdout_watched_ = false;
+    stderr_watched_ = false;
+}
+
+void ManagedProcess::reuse(int pid, const std::string& command,
+                           const ArgumentList& args,
+                           IoReactor* reactor, SessionIoContext* io_context) {
+    reactor_guard_.reset();
+    reactor_ = reactor;
+    io_context_ = io_context;
+    
+    ProcessInfo info;
+    info.pid = pid;
+    info.command = command;
+    info.arguments = std::move(info_.arguments);   // Reuse the vector's storage
+    info.arguments.assign(args.begin(), args.end());
+    info.state = ProcessState::NotStarted;
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    info_ = std::move(info);
+}
+
+ManagedProcess::ManagedProcess(ManagedProcess&& other) noexcept
+    : handle_(std::move(other.handle_))
+    , info_(std::move(other.info_))
+    , io_(std::move(other.io_))
+    , running_(other.running_.load())
+    , io_thread_active_(other.io_thread_active_.load())
+    , io_thread_(std::move(other.io_thread_))
+    , reactor_(other.reactor_)
+    , open_streams_(other.open_streams_.load())
+    , io_context_(other.io_context_)
+    , deficit_(other.deficit_)
+    , input_pending_since_us_(other.input_pending_since_us_.load())
+    , output_callback_(std::move(other.output_callback_))
+    , completion_callback_(std::move(other.completion_callback_))
+    , callback_channel_(std::move(other.callback_channel_))
+    , stdout_watched_(other.stdout_watched_)
+    , stderr_watched_(other.stderr_watched_) {
+    
+    other.running_.store(false);
+    other.io_thread_active_.store(false);
+    other.open_streams_.store(0);
+}
+
+ManagedProcess& ManagedProcess::operator=(ManagedProcess&& other) noexcept {
+    if (this != &other) {
+        // Clean up current state
+        if (running_.load()) {
+            terminate(true);
+        }
+        if (io_thread_active_.load() && io_thread_.joinable()) {
+            io_thread_active_.store(false);
+            io_thread_.join();
+        }
+        detachFromReactor();
+        
+        // Move from other
+        handle_ = std::move(other.handle_);
+        info_ = std::move(other.info_);
+        io_ = std::move(other.io_);
+        running_.store(other.running_.load());
+        io_thread_active_.store(other.io_thread_active_.load());
+        io_thread_ = std::move(other.io_thread_);
+        reactor_ = other.reactor_;
+        open_streams_.store(other.open_streams_.load());
+        io_context_ = other.io_context_;
+        deficit_ = other.deficit_;
+        input_pending_since_us_.store(other.input_pending_since_us_.load());
+        output_callback_ = std::move(other.output_callback_);
+        completion_callback_ = std::move(other.completion_callback_);
+        callback_channel_ = std::move(other.callback_channel_);
+        stdout_watched_ = other.stdout_watched_;
+        stderr_watched_ = other.stderr_watched_;
+        
+        other.running_.store(false);
+        other.io_thread_active_.store(false);
+        other.open_streams_.store(0);
+    }
+    return *this;
+}
+
+bool ManagedProcess::start(const ExecutionOptions& options, const std::string& directory) {
+    if (running_.load()) {
+        return false; // Already running
+    }
+    
+    const std::string& working_dir = directory.empty() ? options.working_directory : directory;
+    if (!spawn(options, working_dir)) {
+        info_.state = ProcessState::Failed;
+        info_.exit_code = -1;
+        return false;
+    }
+    
+    info_.state = ProcessState::Running;
+    if (!working_dir.empty()) {
+        info_.working_dir = working_dir;
+    } else {
+#ifndef _WIN32
+        char cwd[PATH_MAX];
+        info_.working_dir = getcwd(cwd, sizeof(cwd)) ? cwd : "";
+#endif
+    }
+    running_.store(true);
+    
+    if (reactor_ && io_context_ && io_context_->callbacks &&
+        (output_callback_ || completion_callback_)) {
+        // Callbacks run on the session executor, off the reactor threads
+        callback_channel_ = std::make_shared<CallbackExecutor::Channel>();
+        callback_channel_->output = output_callback_;
+        callback_channel_->completion = completion_callback_;
+        callback_channel_->resume = reactor_guard_.wrap([this]() {
+            reactor_->post(reactor_guard_.wrap([this]() { resumeOutput(); }));
+        });
+    }
+    
+    if (reactor_) {
+        // Multiplex pipes on the shared reactor threads
+        attachToReactor();
+    } else {
+        // Start I/O monitoring thread
+        io_thread_active_.store(true);
+        io_thread_ = std::thread(&ManagedProcess::ioThreadFunction, this);
+    }
+    
+    return true;
+}
+
+bool ManagedProcess::terminate(bool force) noexcept {
+    if (!running_.load()) {
+        return true; // Already terminated
+    }
+    
+    bool success = false;
+    
+#ifdef _WIN32
+    if (handle_.isValid()) {
+        UINT exit_code = force ? 1 : 0;
+        success = TerminateProcess(handle_.process_handle, exit_code) != 0;
+    }
+#else
+    if (handle_.pid > 0) {
+        int signal = force ? SIGKILL : SIGTERM;
+        success = kill(handle_.pid, signal) == 0;
+    }
+#endif
+    
+    if (success) {
+        running_.store(false);
+        info_.state = ProcessState::Terminated;
+        info_.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        
+        // Stop I/O thread
+        if (io_thread_active_.load()) {
+            io_thread_active_.store(false);
+            if (io_thread_.joinable()) {
+                io_thread_.join();
+            }
+        }
+        
+        if (reactor_) {
+            detachFromReactor();
+            reapLater(); // Collect the zombie without blocking the caller
+        }
+        
+        notifyCompletion();
+    }
+    
+    return success;
+}
+
+bool ManagedProcess::suspend() {
+    if (!running_.load()) {
+        return false;
+    }
+    
+#ifdef _WIN32
+    // Windows doesn't have direct process suspension
+    return false;
+#else
+    if (handle_.pid > 0 && kill(handle_.pid, SIGSTOP) == 0) {
+        info_.state = ProcessState::Suspended;
+        return true;
+    }
+#endif
+    
+    return false;
+}
+
+bool ManagedProcess::resume() {
+    if (info_.state != ProcessState::Suspended) {
+        return false;
+    }
+    
+#ifdef _WIN32
+    return false;
+#else
+    if (handle_.pid > 0 && kill(handle_.pid, SIGCONT) == 0) {
+        info_.state = ProcessState::Running;
+        return true;
+    }
+#endif
+    
+    return false;
+}
+
+void ManagedProcess::setPriority(bool high) noexcept {
+    if (!reactor_) {
+        return;
+    }
+    
+    reactor_->setPriority(handle_.stdout_fd, high);
+    reactor_->setPriority(handle_.stderr_fd, high);
+}
+
+void ManagedProcess::beginShutdown() noexcept {
+    reactor_guard_.invalidate();
+    detachFromReactor();
+    io_thread_active_.store(false);
+}
+
+void ManagedProcess::finishIo() noexcept {
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+}
+
+bool ManagedProcess::terminateGroup(bool force) noexcept {
+#ifdef _WIN32
+    return handle_.isValid() && TerminateProcess(handle_.process_handle, 1) != 0;
+#else
+    if (handle_.pid <= 0) {
+        return false;
+    }
+    
+    // spawn() makes every child its own process group leader
+    const int signal = force ? SIGKILL : SIGTERM;
+    if (kill(-handle_.pid, signal) != 0 && kill(handle_.pid, signal) != 0) {
+        return false;
+    }
+    if (!force) {
+        kill(-handle_.pid, SIGCONT); // Stopped jobs must run to handle SIGTERM
+    }
+    return true;
+#endif
+}
+
+bool ManagedProcess::isReaped() const noexcept {
+#ifdef _WIN32
+    return !handle_.isValid();
+#else
+    return handle_.pid <= 0;
+#endif
+}
+
+int ManagedProcess::systemPid() const noexcept {
+#ifdef _WIN32
+    return static_cast<int>(handle_.process_id);
+#else
+    return handle_.pid;
+#endif
+}
+
+bool ManagedProcess::sendInput(const std::string& input) {
+    if (!running_.load()) {
+        return false;
+    }
+    
+#ifdef _WIN32
+    // Implementation for Windows
+    return false; // Simplified for now
+#else
+    if (handle_.stdin_fd >= 0) {
+        if (io_context_) {
+            // Only the first pending keystroke is timed until output arrives
+            uint64_t expected = 0;
+            input_pending_since_us_.compare_exchange_strong(expected, steadyMicros());
+        }
+        ssize_t written = write(handle_.stdin_fd, input.c_str(), input.length());
+        return written >= 0;
+    }
+#endif
+    
+    return false;
+}
+
+std::string ManagedProcess::readOutput(size_t max_bytes) {
+    if (max_bytes == 0) {
+        return io_.getAllOutput();
+    } else {
+        std::string output = io_.getAllOutput();
+        if (output.size() <= max_bytes) {
+            return output;
+        }
+        return output.substr(0, max_bytes);
+    }
+}
+
+bool ManagedProcess::hasOutput() const noexcept {
+    return io_.hasData();
+}
+
+ProcessInfo ManagedProcess::getInfo() const {
+    return info_;
+}
+
+bool ManagedProcess::isRunning() const noexcept {
+    return running_.load();
+}
+
+bool ManagedProcess::isComplete() const noexcept {
+    return info_.state == ProcessState::Completed || 
+           info_.state == ProcessState::Failed ||
+           info_.state == ProcessState::Terminated;
+}
+
+void ManagedProcess::setOutputCallback(IShell::OutputCallback callback) {
+    output_callback_ = callback;
+}
+
+void ManagedProcess::setCompletionCallback(IShell::CompletionCallback callback) {
+    completion_callback_ = callback;
+}
+
+bool ManagedProcess::spawn(const ExecutionOptions& options, const std::string& directory) {
+#ifdef _WIN32
+    return false; // Handled by ShellImpl::createWindowsProcess
+#else
+    // Build argv before fork(): only async-signal-safe calls in the child
+    std::vector<char*> argv;
+    argv.reserve(info_.arguments.size() + 2);
+    argv.push_back(const_cast<char*>(info_.command.c_str()));
+    for (const auto& arg : info_.arguments) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    
+    const char* working_dir = directory.empty() ? nullptr : directory.c_str();
+    
+    int in_pipe[2] = {-1, -1};
+    int out_pipe[2] = {-1, -1};
+    int err_pipe[2] = {-1, -1};
+    auto close_pipes = [&]() {
+        for (int fd : {in_pipe[0], in_pipe[1], out_pipe[0], out_pipe[1], err_pipe[0], err_pipe[1]}) {
+            if (fd >= 0) ::close(fd);
+        }
+    };
+    
+    if (pipe(in_pipe) != 0 || pipe(out_pipe) != 0 ||
+        (!options.merge_stderr && pipe(err_pipe) != 0)) {
+        close_pipes();
+        return false;
+    }
+    
+    pid_t child = fork();
+    if (child < 0) {
+        close_pipes();
+        return false;
+    }
+    
+    if (child == 0) {
+        // Own process group so job control signals reach the whole job
+        setpgid(0, 0);
+        dup2(in_pipe[0], STDIN_FILENO);
+        dup2(out_pipe[1], STDOUT_FILENO);
+        dup2(options.merge_stderr ? out_pipe[1] : err_pipe[1], STDERR_FILENO);
+        close_pipes();
+        
+        if (working_dir && chdir(working_dir) != 0) {
+            _exit(126);
+        }
+        if (options.priority != 0) {
+            setpriority(PRIO_PROCESS, 0, options.priority);
+        }
+        
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    
+    // Parent keeps its ends of the pipes
+    setpgid(child, child);
+    ::close(in_pipe[0]);
+    ::close(out_pipe[1]);
+    if (err_pipe[1] >= 0) ::close(err_pipe[1]);
+    
+    handle_.pid = child;
+    handle_.stdin_fd = in_pipe[1];
+    handle_.stdout_fd = out_pipe[0];
+    handle_.stderr_fd = err_pipe[0];
+    
+    for (int fd : {handle_.stdin_fd, handle_.stdout_fd, handle_.stderr_fd}) {
+        if (fd >= 0) {
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    }
+    for (int fd : {handle_.stdout_fd, handle_.stderr_fd}) {
+        if (fd >= 0) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+    }
+    
+    return true;
+#endif
+}
+
+} // namespace core
+} // namespace cross_terminal
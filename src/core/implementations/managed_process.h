@@ -0,0 +1,194 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+#include "core/implementations/callback_executor.h"
+#include "core/implementations/io_reactor.h"
+#include "core/implementations/process_io.h"
+#include "core/utils/callback_guard.h"
+#include "core/utils/latency_histogram.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+/**
+ * @file managed_process.h
+ * @brief One child process of a shell: spawn, I/O, termination and reaping
+ *
+ * Lifecycle and process control are in managed_process.cpp; pipe reading,
+ * on the shared reactor or a dedicated thread, and reaping are in
+ * managed_process_io.cpp.
+ *
+ * @thread_safety Control and status methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+/**
+ * @brief Per-session output scheduling state
+ *
+ * Shared by all processes of one session. Each readable event grants a
+ * process pipe one quantum of byte credit (deficit round-robin); a pipe
+ * that still has data once its credit is spent yields the reactor thread
+ * to the other ready descriptors and is resumed on the next iteration.
+ *
+ * @thread_safe Yes
+ */
+struct SessionIoContext {
+    static constexpr size_t BACKGROUND_QUANTUM = 16 * 1024;
+    static constexpr size_t FOREGROUND_QUANTUM = 64 * 1024;
+    
+    std::atomic<bool> foreground{false};
+    std::atomic<uint64_t> bytes_read{0};
+    std::atomic<uint64_t> budget_yields{0};
+    LatencyHistogram echo_latency;   ///< Input write to first output byte
+    
+    /// @brief Runs this session's callbacks (null: on the I/O thread)
+    std::shared_ptr<CallbackExecutor> callbacks;
+    
+    size_t quantum() const noexcept {
+        return foreground.load(std::memory_order_relaxed) ? FOREGROUND_QUANTUM
+                                                          : BACKGROUND_QUANTUM;
+    }
+};
+
+/**
+ * @brief Managed process wrapper
+ *
+ * With a reactor, the process pipes are multiplexed on the shared
+ * IoReactor threads; without one, a dedicated I/O thread is used.
+ */
+class ManagedProcess {
+private:
+    friend class ProcessPool;
+    
+    static constexpr uint32_t REAP_RETRY_MS = 20;
+    
+    static uint64_t steadyMicros() noexcept;
+    
+    ProcessHandle handle_;
+    ProcessInfo info_;
+    ProcessIO io_;
+    std::atomic<bool> running_;
+    std::atomic<bool> io_thread_active_;
+    std::thread io_thread_;
+    
+    // Reactor-driven I/O (null when using a dedicated I/O thread)
+    IoReactor* reactor_;
+    std::atomic<int> open_streams_;
+    CallbackGuard reactor_guard_;
+    
+    // Fair output scheduling (reactor mode only)
+    SessionIoContext* io_context_;
+    size_t deficit_;
+    std::atomic<uint64_t> input_pending_since_us_;
+    
+    IShell::OutputCallback output_callback_;
+    IShell::CompletionCallback completion_callback_;
+    
+    // Deferred callbacks (reactor mode with a session executor). While the
+    // executor is over its byte limit the pipes are unregistered, so the
+    // child blocks on a full pipe instead of the reactor buffering for it.
+    CallbackExecutor::ChannelPtr callback_channel_;
+    bool stdout_watched_;
+    bool stderr_watched_;
+    
+    // Process creation
+    bool spawn(const ExecutionOptions& options, const std::string& directory);
+    bool collectExitStatus(bool blocking = false) noexcept;
+    
+    // I/O monitoring
+    void ioThreadFunction();
+    void attachToReactor();
+    void detachFromReactor() noexcept;
+    bool watchStream(int fd);
+    void pauseOutput();
+    void resumeOutput();
+    void handleReadable(int fd);
+    void closeStream(int fd);
+    void reapLater();
+    void recordEcho() noexcept;
+    bool notifyOutput(const char* data, size_t size, bool is_error);
+    void notifyCompletion();
+    
+    // Lifecycle shared by the destructor and ProcessPool
+    void teardown() noexcept;
+    void recycle() noexcept;
+    void reuse(int pid, const std::string& command,
+               const ArgumentList& args,
+               IoReactor* reactor, SessionIoContext* io_context);
+    
+public:
+    ManagedProcess(int pid, const std::string& command, 
+                  const ArgumentList& args,
+                  IoReactor* reactor = nullptr,
+                  SessionIoContext* io_context = nullptr);
+    ~ManagedProcess();
+    
+    // Non-copyable, movable (only before start() when reactor-driven)
+    ManagedProcess(const ManagedProcess&) = delete;
+    ManagedProcess& operator=(const ManagedProcess&) = delete;
+    ManagedProcess(ManagedProcess&&) noexcept;
+    ManagedProcess& operator=(ManagedProcess&&) noexcept;
+    
+    // Process control. directory, when set, replaces
+    // options.working_directory (ShellImpl resolves it per session)
+    bool start(const ExecutionOptions& options, const std::string& directory = "");
+    bool terminate(bool force = false) noexcept;
+    bool suspend();
+    bool resume();
+    
+    /**
+     * @brief Serve this process's pipes ahead of other ready descriptors
+     * @thread_safe Yes
+     */
+    void setPriority(bool high) noexcept;
+    
+    // Coordinated shutdown (driven by ProcessTerminator)
+    
+    /// @brief Stop reactor/I-O-thread reaping; the caller reaps from now on
+    void beginShutdown() noexcept;
+    
+    /// @brief Join the dedicated I/O thread, if any
+    void finishIo() noexcept;
+    
+    /**
+     * @brief Signal the whole process group (SIGTERM, or SIGKILL if forced)
+     * @thread_safe Yes
+     */
+    bool terminateGroup(bool force) noexcept;
+    
+    /**
+     * @brief Collect the exit status of the child
+     * @param blocking Wait for the child instead of polling
+     * @return true if the child was reaped by this call
+     */
+    bool reap(bool blocking = false) noexcept { return collectExitStatus(blocking); }
+    
+    /// @brief True when no child remains to be reaped
+    bool isReaped() const noexcept;
+    
+    /// @brief Operating system process id, -1 once reaped
+    int systemPid() const noexcept;
+    
+    // I/O operations
+    bool sendInput(const std::string& input);
+    std::string readOutput(size_t max_bytes = 0);
+    bool hasOutput() const noexcept;
+    
+    /// @brief Shrink captured output to the newest keep_bytes per stream
+    size_t trimOutput(size_t keep_bytes) noexcept { return io_.trim(keep_bytes); }
+    
+    // Status queries
+    ProcessInfo getInfo() const;
+    bool isRunning() const noexcept;
+    bool isComplete() const noexcept;
+    
+    // Callbacks
+    void setOutputCallback(IShell::OutputCallback callback);
+    void setCompletionCallback(IShell::CompletionCallback callback);
+};
+
+} // namespace core
+} // namespace cross_terminal
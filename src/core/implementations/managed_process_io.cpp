@@ -0,0 +1,299 @@
+#include "managed_process.h"
+#include "thread_registry.h"
+#include <algorithm>
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+bool ManagedProcess::collectExitStatus(bool blocking) noexcept {
+#ifndef _WIN32
+    if (handle_.pid <= 0) {
+        return false;
+    }
+    
+    int status;
+    struct rusage usage;
+    pid_t result;
+    do {
+        result = wait4(handle_.pid, &status, blocking ? 0 : WNOHANG, &usage);
+    } while (result < 0 && errno == EINTR);
+    if (result <= 0) {
+        return false;
+    }
+    
+    handle_.pid = -1;
+    info_.user_time_ms = usage.ru_utime.tv_sec * 1000ULL + usage.ru_utime.tv_usec / 1000;
+    info_.system_time_ms = usage.ru_stime.tv_sec * 1000ULL + usage.ru_stime.tv_usec / 1000;
+#ifdef __APPLE__
+    info_.max_rss_kb = usage.ru_maxrss / 1024; // Bytes on macOS
+#else
+    info_.max_rss_kb = usage.ru_maxrss;
+#endif
+    
+    // A terminate() already recorded the final state
+    if (info_.state == ProcessState::Terminated) {
+        return true;
+    }
+    
+    running_.store(false);
+    info_.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    if (WIFEXITED(status)) {
+        info_.exit_code = WEXITSTATUS(status);
+        info_.state = (info_.exit_code == 0) ? ProcessState::Completed : ProcessState::Failed;
+    } else if (WIFSIGNALED(status)) {
+        info_.exit_code = WTERMSIG(status);
+        info_.state = ProcessState::Terminated;
+    }
+    
+    notifyCompletion();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ManagedProcess::ioThreadFunction() {
+    auto registration = ThreadRegistry::instance().enter(
+        ThreadRole::ProcessIo, "ct-io-" + std::to_string(info_.pid));
+    char buffer[4096];
+    
+    while (io_thread_active_.load()) {
+#ifndef _WIN32
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        
+        int max_fd = -1;
+        if (handle_.stdout_fd >= 0) {
+            FD_SET(handle_.stdout_fd, &read_fds);
+            max_fd = std::max(max_fd, handle_.stdout_fd);
+        }
+        if (handle_.stderr_fd >= 0) {
+            FD_SET(handle_.stderr_fd, &read_fds);
+            max_fd = std::max(max_fd, handle_.stderr_fd);
+        }
+        
+        if (max_fd < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+        
+        struct timeval timeout = {0, 100000}; // 100ms timeout
+        int result = select(max_fd + 1, &read_fds, nullptr, nullptr, &timeout);
+        
+        if (result > 0) {
+            if (handle_.stdout_fd >= 0 && FD_ISSET(handle_.stdout_fd, &read_fds)) {
+                ssize_t bytes_read = read(handle_.stdout_fd, buffer, sizeof(buffer));
+                if (bytes_read > 0) {
+                    io_.appendStdout(buffer, bytes_read);
+                    notifyOutput(buffer, bytes_read, false);
+                }
+            }
+            
+            if (handle_.stderr_fd >= 0 && FD_ISSET(handle_.stderr_fd, &read_fds)) {
+                ssize_t bytes_read = read(handle_.stderr_fd, buffer, sizeof(buffer));
+                if (bytes_read > 0) {
+                    io_.appendStderr(buffer, bytes_read);
+                    notifyOutput(buffer, bytes_read, true);
+                }
+            }
+        }
+        
+        // Check if process is still running
+        if (collectExitStatus()) {
+            break;
+        }
+#endif
+    }
+}
+
+void ManagedProcess::attachToReactor() {
+    // Counted before registering: a reactor thread may read a pipe to EOF
+    // and close it before add() returns
+    const int streams = (handle_.stdout_fd >= 0) + (handle_.stderr_fd >= 0);
+    open_streams_.store(streams);
+    bool reap = streams == 0;
+    for (int fd : {handle_.stdout_fd, handle_.stderr_fd}) {
+        if (fd >= 0 && !watchStream(fd) && open_streams_.fetch_sub(1) == 1) {
+            reap = true;
+        }
+    }
+    
+    if (io_context_ && io_context_->foreground.load()) {
+        setPriority(true);
+    }
+    
+    if (reap) {
+        reapLater();
+    }
+}
+
+void ManagedProcess::detachFromReactor() noexcept {
+    if (!reactor_) {
+        return;
+    }
+    
+    // Descriptors stay open until handle_ is closed, so their numbers
+    // cannot be reused by another registration in the meantime
+    reactor_->remove(handle_.stdout_fd);
+    reactor_->remove(handle_.stderr_fd);
+    open_streams_.store(0);
+    // A resume still queued from a paused channel must not register the
+    // pipes again
+    stdout_watched_ = false;
+    stderr_watched_ = false;
+}
+
+bool ManagedProcess::watchStream(int fd) {
+    // Marked before registering, for the same reason open_streams_ is
+    // counted first: closeStream() may run before add() returns
+    bool& watched = fd == handle_.stderr_fd ? stderr_watched_ : stdout_watched_;
+    watched = fd >= 0;
+    // Same affinity for both pipes: callbacks for one process stay serialized
+    if (watched && !reactor_->add(fd, IoReactor::Readable,
+            [this](int ready_fd, uint32_t) { handleReadable(ready_fd); },
+            handle_.stdout_fd)) {
+        watched = false;
+    }
+    return watched;
+}
+
+void ManagedProcess::pauseOutput() {
+    // Unregister rather than mask: a hung-up pipe would keep reporting
+    // HangUp even with an empty event mask
+    if (stdout_watched_) {
+        reactor_->remove(handle_.stdout_fd);
+    }
+    if (stderr_watched_) {
+        reactor_->remove(handle_.stderr_fd);
+    }
+    io_context_->callbacks->awaitDrain(callback_channel_);
+}
+
+void ManagedProcess::resumeOutput() {
+    if (stdout_watched_) {
+        watchStream(handle_.stdout_fd);
+    }
+    if (stderr_watched_) {
+        watchStream(handle_.stderr_fd);
+    }
+    if (io_context_ && io_context_->foreground.load()) {
+        setPriority(true);
+    }
+}
+
+void ManagedProcess::handleReadable(int fd) {
+    char buffer[4096];
+    
+    // Deficit round-robin: one quantum of credit per readiness event
+    deficit_ += io_context_ ? io_context_->quantum() : SIZE_MAX / 2;
+    
+    const bool is_error = (fd == handle_.stderr_fd);
+    while (deficit_ > 0) {
+        ssize_t bytes_read = read(fd, buffer, std::min(sizeof(buffer), deficit_));
+        if (bytes_read > 0) {
+            deficit_ -= static_cast<size_t>(bytes_read);
+            if (io_context_) {
+                io_context_->bytes_read.fetch_add(bytes_read, std::memory_order_relaxed);
+                recordEcho();
+            }
+            
+            if (is_error) {
+                io_.appendStderr(buffer, bytes_read);
+            } else {
+                io_.appendStdout(buffer, bytes_read);
+            }
+            if (!notifyOutput(buffer, static_cast<size_t>(bytes_read), is_error)) {
+                // Consumer is behind: stop reading until it catches up
+                deficit_ = 0;
+                pauseOutput();
+                return;
+            }
+            continue;
+        }
+        
+        if (bytes_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            deficit_ = 0; // Drained: an idle pipe does not bank credit
+            return;
+        }
+        
+        // EOF or hard error: the stream is finished
+        deficit_ = 0;
+        closeStream(fd);
+        return;
+    }
+    
+    // Credit spent with data left: the level-triggered registration fires
+    // again on the next loop iteration, after the other ready pipes
+    if (io_context_) {
+        io_context_->budget_yields.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void ManagedProcess::closeStream(int fd) {
+    reactor_->remove(fd);
+    bool& watched = fd == handle_.stderr_fd ? stderr_watched_ : stdout_watched_;
+    if (!watched) {
+        return;   // Detached already; no stream is left to count
+    }
+    watched = false;
+    
+    if (open_streams_.fetch_sub(1) == 1) {
+        reapLater();
+    }
+}
+
+void ManagedProcess::reapLater() {
+    // Pipes close slightly before the child becomes waitable
+    reactor_->schedule(REAP_RETRY_MS, reactor_guard_.wrap([this]() {
+        if (!collectExitStatus() && handle_.pid > 0) {
+            reapLater();
+        }
+    }));
+}
+
+void ManagedProcess::recordEcho() noexcept {
+    const uint64_t since = input_pending_since_us_.exchange(0, std::memory_order_relaxed);
+    if (since != 0) {
+        const uint64_t now = steadyMicros();
+        io_context_->echo_latency.record(now > since ? now - since : 0);
+    }
+}
+
+bool ManagedProcess::notifyOutput(const char* data, size_t size, bool is_error) {
+    if (callback_channel_) {
+        return io_context_->callbacks->postOutput(callback_channel_, data, size, is_error);
+    }
+    if (output_callback_) {
+        output_callback_(std::string(data, size), is_error);
+    }
+    return true;
+}
+
+void ManagedProcess::notifyCompletion() {
+    if (callback_channel_) {
+        io_context_->callbacks->postCompletion(callback_channel_, info_);
+        return;
+    }
+    if (completion_callback_) {
+        completion_callback_(info_);
+    }
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,242 @@
+#include "process_io.h"
+#include "memory/memory_budget.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+// ProcessHandle implementation
+ProcessHandle::ProcessHandle() {
+#ifdef _WIN32
+    process_handle = nullptr;
+    thread_handle = nullptr;
+    process_id = 0;
+    thread_id = 0;
+#else
+    pid = -1;
+    stdin_fd = -1;
+    stdout_fd = -1;
+    stderr_fd = -1;
+#endif
+}
+
+ProcessHandle::~ProcessHandle() {
+    close();
+}
+
+bool ProcessHandle::isValid() const noexcept {
+#ifdef _WIN32
+    return process_handle != nullptr && process_handle != INVALID_HANDLE_VALUE;
+#else
+    return pid > 0;
+#endif
+}
+
+void ProcessHandle::close() noexcept {
+#ifdef _WIN32
+    if (thread_handle && thread_handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(thread_handle);
+        thread_handle = nullptr;
+    }
+    if (process_handle && process_handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(process_handle);
+        process_handle = nullptr;
+    }
+#else
+    if (stdin_fd >= 0) {
+        ::close(stdin_fd);
+        stdin_fd = -1;
+    }
+    if (stdout_fd >= 0) {
+        ::close(stdout_fd);
+        stdout_fd = -1;
+    }
+    if (stderr_fd >= 0) {
+        ::close(stderr_fd);
+        stderr_fd = -1;
+    }
+#endif
+}
+
+// ProcessIO implementation
+ProcessIO::ProcessIO() 
+    : stdout_buffer_(std::make_unique<char[]>(BUFFER_SIZE))
+    , stderr_buffer_(std::make_unique<char[]>(BUFFER_SIZE))
+    , stdout_size_(0)
+    , stderr_size_(0)
+    , stdout_capacity_(BUFFER_SIZE)
+    , stderr_capacity_(BUFFER_SIZE) {
+    memory::MemoryBudget::instance().charge(memory::MemoryTag::Scrollback, 2 * BUFFER_SIZE);
+}
+
+ProcessIO::~ProcessIO() {
+    memory::MemoryBudget::instance().release(memory::MemoryTag::Scrollback,
+                                             stdout_capacity_ + stderr_capacity_);
+}
+
+ProcessIO::ProcessIO(ProcessIO&& other) noexcept
+    : stdout_buffer_(std::move(other.stdout_buffer_))
+    , stderr_buffer_(std::move(other.stderr_buffer_))
+    , stdout_size_(other.stdout_size_)
+    , stderr_size_(other.stderr_size_)
+    , stdout_capacity_(other.stdout_capacity_)
+    , stderr_capacity_(other.stderr_capacity_) {
+    other.stdout_size_ = 0;
+    other.stderr_size_ = 0;
+    other.stdout_capacity_ = 0;
+    other.stderr_capacity_ = 0;
+}
+
+ProcessIO& ProcessIO::operator=(ProcessIO&& other) noexcept {
+    if (this != &other) {
+        memory::MemoryBudget::instance().release(memory::MemoryTag::Scrollback,
+                                                 stdout_capacity_ + stderr_capacity_);
+        stdout_buffer_ = std::move(other.stdout_buffer_);
+        stderr_buffer_ = std::move(other.stderr_buffer_);
+        stdout_size_ = other.stdout_size_;
+        stderr_size_ = other.stderr_size_;
+        stdout_capacity_ = other.stdout_capacity_;
+        stderr_capacity_ = other.stderr_capacity_;
+        other.stdout_size_ = 0;
+        other.stderr_size_ = 0;
+        other.stdout_capacity_ = 0;
+        other.stderr_capacity_ = 0;
+    }
+    return *this;
+}
+
+void ProcessIO::append(std::unique_ptr<char[]>& buffer, size_t& size,
+                       size_t& capacity, const char* data, size_t length) {
+    if (size + length > MAX_RETAINED_SIZE) {
+        // Drop the oldest half so trimming stays rare
+        const size_t keep_new = std::min(length, MAX_RETAINED_SIZE / 2);
+        const size_t keep_old = std::min(size, MAX_RETAINED_SIZE / 2 - keep_new);
+        std::memmove(buffer.get(), buffer.get() + size - keep_old, keep_old);
+        size = keep_old;
+        data += length - keep_new;
+        length = keep_new;
+    }
+    
+    if (size + length > capacity) {
+        // Geometric growth keeps a flooding process at amortized O(1) per byte
+        size_t new_capacity = std::max({BUFFER_SIZE, capacity * 2, size + length});
+        auto new_buffer = std::make_unique<char[]>(new_capacity);
+        if (size > 0) {
+            std::memcpy(new_buffer.get(), buffer.get(), size);
+        }
+        buffer = std::move(new_buffer);
+        memory::MemoryBudget::instance().charge(memory::MemoryTag::Scrollback,
+                                                new_capacity - capacity);
+        capacity = new_capacity;
+    }
+    
+    std::memcpy(buffer.get() + size, data, length);
+    size += length;
+}
+
+void ProcessIO::appendStdout(const char* data, size_t size) {
+    std::unique_lock lock(io_mutex_);
+    append(stdout_buffer_, stdout_size_, stdout_capacity_, data, size);
+}
+
+void ProcessIO::appendStderr(const char* data, size_t size) {
+    std::unique_lock lock(io_mutex_);
+    append(stderr_buffer_, stderr_size_, stderr_capacity_, data, size);
+}
+
+std::string ProcessIO::getStdout() const {
+    std::shared_lock lock(io_mutex_);
+    return std::string(stdout_buffer_.get(), stdout_size_);
+}
+
+std::string ProcessIO::getStderr() const {
+    std::shared_lock lock(io_mutex_);
+    return std::string(stderr_buffer_.get(), stderr_size_);
+}
+
+std::string ProcessIO::getAllOutput() const {
+    std::shared_lock lock(io_mutex_);
+    std::string result;
+    result.reserve(stdout_size_ + stderr_size_);
+    result.append(stdout_buffer_.get(), stdout_size_);
+    result.append(stderr_buffer_.get(), stderr_size_);
+    return result;
+}
+
+void ProcessIO::clear() noexcept {
+    std::unique_lock lock(io_mutex_);
+    stdout_size_ = 0;
+    stderr_size_ = 0;
+}
+
+void ProcessIO::recycle() noexcept {
+    std::unique_lock lock(io_mutex_);
+    stdout_size_ = 0;
+    stderr_size_ = 0;
+    
+    // A flood's scrollback is not worth parking; fall back to the base size
+    auto shrink = [](std::unique_ptr<char[]>& buffer, size_t& capacity) {
+        if (capacity > MAX_RECYCLED_SIZE) {
+            if (char* small = new (std::nothrow) char[BUFFER_SIZE]) {
+                buffer.reset(small);
+                memory::MemoryBudget::instance().release(memory::MemoryTag::Scrollback,
+                                                         capacity - BUFFER_SIZE);
+                capacity = BUFFER_SIZE;
+            }
+        }
+    };
+    shrink(stdout_buffer_, stdout_capacity_);
+    shrink(stderr_buffer_, stderr_capacity_);
+}
+
+size_t ProcessIO::trim(size_t keep_bytes) noexcept {
+    std::unique_lock lock(io_mutex_);
+    size_t released = 0;
+    
+    auto trim_stream = [&](std::unique_ptr<char[]>& buffer, size_t& size, size_t& capacity) {
+        const size_t keep = std::min(size, keep_bytes);
+        const size_t target = std::max(BUFFER_SIZE, keep);
+        if (capacity <= target) {
+            return;
+        }
+        char* smaller = new (std::nothrow) char[target];
+        if (!smaller) {
+            return;
+        }
+        std::memcpy(smaller, buffer.get() + size - keep, keep);
+        buffer.reset(smaller);
+        size = keep;
+        released += capacity - target;
+        capacity = target;
+    };
+    trim_stream(stdout_buffer_, stdout_size_, stdout_capacity_);
+    trim_stream(stderr_buffer_, stderr_size_, stderr_capacity_);
+    
+    memory::MemoryBudget::instance().release(memory::MemoryTag::Scrollback, released);
+    return released;
+}
+
+bool ProcessIO::hasData() const noexcept {
+    std::shared_lock lock(io_mutex_);
+    return stdout_size_ > 0 || stderr_size_ > 0;
+}
+
+size_t ProcessIO::getStdoutSize() const noexcept {
+    std::shared_lock lock(io_mutex_);
+    return stdout_size_;
+}
+
+size_t ProcessIO::getStderrSize() const noexcept {
+    std::shared_lock lock(io_mutex_);
+    return stderr_size_;
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <sys/types.h>
+
+/**
+ * @file process_io.h
+ * @brief Child process handles and captured output buffers
+ *
+ * @thread_safety ProcessHandle is owned by one ManagedProcess; ProcessIO
+ *                is thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+/**
+ * @brief Platform-specific process handle wrapper
+ */
+struct ProcessHandle {
+#ifdef _WIN32
+    void* process_handle;
+    void* thread_handle;
+    unsigned long process_id;
+    unsigned long thread_id;
+#else
+    pid_t pid;
+    int stdin_fd;
+    int stdout_fd;
+    int stderr_fd;
+#endif
+    
+    ProcessHandle();
+    ~ProcessHandle();
+    
+    bool isValid() const noexcept;
+    void close() noexcept;
+};
+
+/**
+ * @brief Process I/O buffer management
+ *
+ * Keeps the most recent MAX_RETAINED_SIZE bytes of each stream; older
+ * output of a long-running flood is dropped instead of growing forever.
+ * Buffer capacity is charged to the Scrollback memory budget tag.
+ */
+class ProcessIO {
+private:
+    static constexpr size_t BUFFER_SIZE = 8192;
+    static constexpr size_t MAX_RETAINED_SIZE = 4 * 1024 * 1024;   ///< Per stream scrollback
+    static constexpr size_t MAX_RECYCLED_SIZE = 64 * 1024;         ///< Per stream, kept by recycle()
+    
+    std::unique_ptr<char[]> stdout_buffer_;
+    std::unique_ptr<char[]> stderr_buffer_;
+    size_t stdout_size_;
+    size_t stderr_size_;
+    size_t stdout_capacity_;
+    size_t stderr_capacity_;
+    mutable std::shared_mutex io_mutex_;
+    
+    static void append(std::unique_ptr<char[]>& buffer, size_t& size,
+                       size_t& capacity, const char* data, size_t length);
+    
+public:
+    ProcessIO();
+    ~ProcessIO();
+    
+    // Non-copyable, movable
+    ProcessIO(const ProcessIO&) = delete;
+    ProcessIO& operator=(const ProcessIO&) = delete;
+    ProcessIO(ProcessIO&&) noexcept;
+    ProcessIO& operator=(ProcessIO&&) noexcept;
+    
+    void appendStdout(const char* data, size_t size);
+    void appendStderr(const char* data, size_t size);
+    
+    std::string getStdout() const;
+    std::string getStderr() const;
+    std::string getAllOutput() const;
+    
+    void clear() noexcept;
+    
+    /// @brief Clear for reuse, shrinking buffers grown past MAX_RECYCLED_SIZE
+    void recycle() noexcept;
+    
+    /**
+     * @brief Drop all but the newest keep_bytes of each stream
+     * @return Bytes of buffer capacity released
+     */
+    size_t trim(size_t keep_bytes) noexcept;
+    
+    bool hasData() const noexcept;
+    size_t getStdoutSize() const noexcept;
+    size_t getStderrSize() const noexcept;
+};
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,122 @@
+#include "process_pool.h"
+#include "shell_impl.h"
+#include "memory/memory_budget.h"
+
+namespace cross_terminal {
+namespace core {
+
+ProcessPool* ProcessPool::instance_ = nullptr;
+std::once_flag ProcessPool::init_flag_;
+
+void ProcessRecycler::operator()(ManagedProcess* process) const noexcept {
+    if (!process) {
+        return;
+    }
+    if (pool) {
+        pool->release(process);
+    } else {
+        delete process;
+    }
+}
+
+ProcessPool::ProcessPool(size_t capacity)
+    : capacity_(capacity) {
+    idle_.reserve(capacity);
+}
+
+ProcessPool::~ProcessPool() {
+    trim();
+}
+
+ProcessPool& ProcessPool::instance() {
+    std::call_once(init_flag_, []() {
+        instance_ = new ProcessPool();
+        memory::MemoryBudget::instance().register_cache(
+            "process pool", memory::MemoryTag::ProcessPool, memory::CachePriority::Disposable,
+            [](memory::PressureLevel) { return instance_->trim() * sizeof(ManagedProcess); });
+    });
+    return *instance_;
+}
+
+ProcessPtr ProcessPool::acquire(int pid, const std::string& command,
+                                const ArgumentList& args,
+                                IoReactor* reactor,
+                                SessionIoContext* io_context) {
+    acquired_.fetch_add(1, std::memory_order_relaxed);
+
+    ManagedProcess* process = nullptr;
+    {
+        std::lock_guard lock(mutex_);
+        if (!idle_.empty()) {
+            process = idle_.back();
+            idle_.pop_back();
+        }
+    }
+
+    if (process) {
+        memory::MemoryBudget::instance().release(memory::MemoryTag::ProcessPool,
+                                                 sizeof(ManagedProcess));
+        reused_.fetch_add(1, std::memory_order_relaxed);
+        process->reuse(pid, command, args, reactor, io_context);
+    } else {
+        process = new ManagedProcess(pid, command, args, reactor, io_context);
+    }
+    return ProcessPtr(process, ProcessRecycler{this});
+}
+
+void ProcessPool::release(ManagedProcess* process) noexcept {
+    // Teardown may block on reactor callbacks, never hold the lock for it
+    process->recycle();
+
+    {
+        std::lock_guard lock(mutex_);
+        if (idle_.size() < capacity_) {
+            idle_.push_back(process);
+            memory::MemoryBudget::instance().charge(memory::MemoryTag::ProcessPool,
+                                                    sizeof(ManagedProcess));
+            return;
+        }
+    }
+
+    discarded_.fetch_add(1, std::memory_order_relaxed);
+    delete process;
+}
+
+void ProcessPool::setCapacity(size_t capacity) {
+    // Idle objects are already torn down, deleting them does not block
+    std::lock_guard lock(mutex_);
+    capacity_ = capacity;
+    while (idle_.size() > capacity_) {
+        delete idle_.back();
+        idle_.pop_back();
+        memory::MemoryBudget::instance().release(memory::MemoryTag::ProcessPool,
+                                                 sizeof(ManagedProcess));
+    }
+    // release() must be able to park without allocating
+    idle_.reserve(capacity_);
+}
+
+size_t ProcessPool::trim() noexcept {
+    std::lock_guard lock(mutex_);
+    const size_t freed = idle_.size();
+    for (auto* process : idle_) {
+        delete process;
+    }
+    idle_.clear();
+    memory::MemoryBudget::instance().release(memory::MemoryTag::ProcessPool,
+                                             freed * sizeof(ManagedProcess));
+    return freed;
+}
+
+ProcessPoolStats ProcessPool::getStats() const noexcept {
+    ProcessPoolStats stats;
+    stats.acquired = acquired_.load(std::memory_order_relaxed);
+    stats.reused = reused_.load(std::memory_order_relaxed);
+    stats.discarded = discarded_.load(std::memory_order_relaxed);
+    std::lock_guard lock(mutex_);
+    stats.idle = idle_.size();
+    return stats;
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "core/interfaces/i_shell.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file process_pool.h
+ * @brief Recycling pool for ManagedProcess objects
+ *
+ * Finished processes are torn down (reaped, pipes closed, callbacks
+ * dropped) and parked instead of freed. The next spawn takes a parked
+ * object back with its I/O capture buffers, argument vector and guard
+ * state still allocated, so short commands run without heap churn.
+ *
+ * The process-wide instance is registered with the memory budget as a
+ * disposable cache: memory pressure frees every parked object.
+ *
+ * @performance O(1) acquire and release
+ * @thread_safety All public methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+class IoReactor;
+class ManagedProcess;
+class ProcessPool;
+struct SessionIoContext;
+
+/**
+ * @brief unique_ptr deleter returning processes to their pool
+ */
+struct ProcessRecycler {
+    ProcessPool* pool = nullptr;   ///< Null for heap-owned processes
+
+    void operator()(ManagedProcess* process) const noexcept;
+};
+
+/// @brief Owning handle to a pooled process
+using ProcessPtr = std::unique_ptr<ManagedProcess, ProcessRecycler>;
+
+/**
+ * @brief Pool statistics
+ */
+struct ProcessPoolStats {
+    uint64_t acquired = 0;   ///< Total acquire() calls
+    uint64_t reused = 0;     ///< Acquisitions served from the idle list
+    uint64_t discarded = 0;  ///< Releases freed because the pool was full
+    size_t idle = 0;         ///< Objects currently parked
+};
+
+/**
+ * @brief Bounded free list of reset ManagedProcess objects
+ */
+class ProcessPool {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64;
+
+    /**
+     * @brief Constructor
+     * @param capacity Maximum number of idle objects kept for reuse
+     */
+    explicit ProcessPool(size_t capacity = DEFAULT_CAPACITY);
+    ~ProcessPool();
+
+    // Non-copyable, non-movable
+    ProcessPool(const ProcessPool&) = delete;
+    ProcessPool& operator=(const ProcessPool&) = delete;
+    ProcessPool(ProcessPool&&) = delete;
+    ProcessPool& operator=(ProcessPool&&) = delete;
+
+    /**
+     * @brief Process-wide pool shared by all shells
+     * @note Never destroyed, so handles may be released during exit
+     */
+    static ProcessPool& instance();
+
+    /**
+     * @brief Get a process in its freshly constructed state
+     * @thread_safe Yes
+     * @performance No allocation when an idle object is available
+     */
+    ProcessPtr acquire(int pid, const std::string& command,
+                       const ArgumentList& args,
+                       IoReactor* reactor = nullptr,
+                       SessionIoContext* io_context = nullptr);
+
+    /**
+     * @brief Change the number of idle objects kept, 0 disables pooling
+     * @thread_safe Yes
+     */
+    void setCapacity(size_t capacity);
+
+    /**
+     * @brief Free all idle objects
+     * @return Number of objects freed
+     */
+    size_t trim() noexcept;
+
+    /// @brief Snapshot of pool counters
+    ProcessPoolStats getStats() const noexcept;
+
+private:
+    friend struct ProcessRecycler;
+
+    std::vector<ManagedProcess*> idle_;
+    size_t capacity_;
+    mutable std::mutex mutex_;
+
+    std::atomic<uint64_t> acquired_{0};
+    std::atomic<uint64_t> reused_{0};
+    std::atomic<uint64_t> discarded_{0};
+
+    static ProcessPool* instance_;
+    static std::once_flag init_flag_;
+
+    void release(ManagedProcess* process) noexcept;
+};
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,210 @@
+#include "process_terminator.h"
+#include "shell_impl.h"
+#include "core/utils/callback_guard.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+namespace {
+
+// Descriptor that becomes readable when the process exits, -1 if unsupported
+int openPidFd(int pid) noexcept {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    if (pid > 0) {
+        return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    }
+#else
+    (void)pid;
+#endif
+    return -1;
+}
+
+void closePidFd(int pid_fd) noexcept {
+#ifndef _WIN32
+    close(pid_fd);
+#else
+    (void)pid_fd;
+#endif
+}
+
+} // namespace
+
+ProcessTerminator::ProcessTerminator(IoReactor* reactor)
+    : reactor_(reactor) {
+}
+
+ShutdownReport ProcessTerminator::terminate(const std::vector<ManagedProcess*>& processes,
+                                            uint32_t grace_ms) noexcept {
+    const auto started = std::chrono::steady_clock::now();
+    ShutdownReport report;
+
+    // Take reaping away from the reactor and I/O threads first
+    std::vector<ManagedProcess*> pending;
+    for (ManagedProcess* process : processes) {
+        if (process && !process->isReaped()) {
+            process->beginShutdown();
+            pending.push_back(process);
+        }
+    }
+    report.processes = pending.size();
+
+    // Every group gets the signal before anyone is waited on
+    for (ManagedProcess* process : pending) {
+        process->terminateGroup(false);
+    }
+
+    // Dedicated I/O threads wind down concurrently; join them before
+    // reaping so nobody else calls waitpid on these children
+    for (ManagedProcess* process : pending) {
+        process->finishIo();
+    }
+    size_t exited = 0;
+    for (auto it = pending.begin(); it != pending.end();) {
+        if ((*it)->isReaped()) {
+            ++exited;
+            it = pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (!pending.empty()) {
+        const bool use_reactor = reactor_ && reactor_->isRunning() &&
+                                 !reactor_->isReactorThread();
+        try {
+            exited += use_reactor ? waitOnReactor(pending, grace_ms)
+                                  : waitByPolling(pending, grace_ms);
+        } catch (...) {
+            // Out of memory while waiting: everything left is escalated
+        }
+    }
+    report.exited = exited;
+
+    // Escalate: kill all stragglers first, then reap them
+    for (ManagedProcess* process : pending) {
+        process->terminateGroup(true);
+    }
+    for (ManagedProcess* process : pending) {
+        process->reap(true);
+    }
+    report.killed = pending.size();
+
+    report.duration_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count();
+    return report;
+}
+
+size_t ProcessTerminator::waitOnReactor(std::vector<ManagedProcess*>& pending,
+                                        uint32_t grace_ms) {
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(grace_ms);
+
+    std::mutex mutex;
+    std::condition_variable all_exited;
+    std::unordered_set<ManagedProcess*> alive(pending.begin(), pending.end());
+
+    auto markExited = [&](ManagedProcess* process) {
+        std::lock_guard lock(mutex);
+        alive.erase(process);
+        if (alive.empty()) {
+            all_exited.notify_all();
+        }
+    };
+
+    // Exit notification per process where the kernel supports pidfd
+    std::vector<int> pid_fds;
+    std::vector<ManagedProcess*> polled;
+    for (ManagedProcess* process : pending) {
+        int pid_fd = openPidFd(process->systemPid());
+        if (pid_fd >= 0 && reactor_->add(pid_fd, IoReactor::Readable,
+                [this, process, &markExited](int fd, uint32_t) {
+                    if (process->reap()) {
+                        reactor_->remove(fd);
+                        markExited(process);
+                    }
+                })) {
+            pid_fds.push_back(pid_fd);
+        } else {
+            if (pid_fd >= 0) {
+                closePidFd(pid_fd);
+            }
+            polled.push_back(process);
+        }
+    }
+
+    // Everything else shares one reap timer
+    CallbackGuard guard;
+    std::function<void()> poll_tick = [&]() {
+        bool remaining = false;
+        for (ManagedProcess*& process : polled) {
+            if (process && process->reap()) {
+                markExited(process);
+                process = nullptr;
+            }
+            remaining = remaining || process;
+        }
+        if (remaining) {
+            reactor_->schedule(REAP_POLL_MS, guard.wrap([&poll_tick]() { poll_tick(); }));
+        }
+    };
+    if (!polled.empty()) {
+        reactor_->post(guard.wrap([&poll_tick]() { poll_tick(); }));
+    }
+
+    {
+        std::unique_lock lock(mutex);
+        all_exited.wait_until(lock, deadline, [&]() { return alive.empty(); });
+    }
+
+    // remove() waits for in-flight handlers, invalidate() for the timer
+    for (int pid_fd : pid_fds) {
+        reactor_->remove(pid_fd);
+    }
+    guard.invalidate();
+    for (int pid_fd : pid_fds) {
+        closePidFd(pid_fd);
+    }
+
+    const size_t exited = pending.size() - alive.size();
+    pending.assign(alive.begin(), alive.end());
+    return exited;
+}
+
+size_t ProcessTerminator::waitByPolling(std::vector<ManagedProcess*>& pending,
+                                        uint32_t grace_ms) noexcept {
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(grace_ms);
+
+    size_t exited = 0;
+    while (true) {
+        for (auto it = pending.begin(); it != pending.end();) {
+            if ((*it)->reap()) {
+                ++exited;
+                it = pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (pending.empty() || std::chrono::steady_clock::now() >= deadline) {
+            return exited;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(REAP_POLL_MS));
+    }
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "core/implementations/io_reactor.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file process_terminator.h
+ * @brief Parallel, deadline-bounded termination of process groups
+ *
+ * Signals every process group at once, waits for all exits concurrently
+ * on the reactor (pidfd where available, a shared reap timer otherwise)
+ * and escalates to SIGKILL for whatever is still alive at the deadline.
+ * Shutdown time is bounded by the grace period, not by the job count.
+ *
+ * @performance O(n) signals, one wakeup per exit
+ * @thread_safety A terminator instance is used by one caller at a time
+ */
+
+namespace cross_terminal {
+namespace core {
+
+class ManagedProcess;
+
+/**
+ * @brief Outcome of a coordinated shutdown
+ */
+struct ShutdownReport {
+    size_t processes = 0;       ///< Processes that were still alive
+    size_t exited = 0;          ///< Exited within the grace period
+    size_t killed = 0;          ///< Escalated to SIGKILL at the deadline
+    uint64_t duration_us = 0;   ///< Wall time from first signal to last reap
+};
+
+/**
+ * @brief Coordinates graceful termination of many processes
+ */
+class ProcessTerminator {
+public:
+    static constexpr uint32_t REAP_POLL_MS = 5;   ///< Fallback reap interval without pidfd
+
+    /**
+     * @brief Constructor
+     * @param reactor Reactor used to wait for exits, or nullptr to poll
+     *        on the calling thread
+     */
+    explicit ProcessTerminator(IoReactor* reactor = nullptr);
+
+    /**
+     * @brief Terminate processes and reap them
+     *
+     * Sends SIGTERM to every process group, waits up to grace_ms for
+     * all of them together, then sends SIGKILL to the stragglers and
+     * reaps them. On return no process in the list is left unreaped.
+     *
+     * @param processes Processes to stop; already reaped ones are skipped
+     * @param grace_ms Global deadline for graceful exit
+     * @return Counts and total duration
+     * @thread_safe No - must not be called from a reactor thread of the
+     *              same reactor (falls back to polling if it is)
+     * @exception_safety No-throw guarantee
+     */
+    ShutdownReport terminate(const std::vector<ManagedProcess*>& processes,
+                             uint32_t grace_ms) noexcept;
+
+private:
+    IoReactor* reactor_;
+
+    size_t waitOnReactor(std::vector<ManagedProcess*>& pending, uint32_t grace_ms);
+    size_t waitByPolling(std::vector<ManagedProcess*>& pending, uint32_t grace_ms) noexcept;
+};
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,608 @@
+#include "serial_session.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
+
+// termios2 carries the line speed as a plain integer (BOTHER), the only
+// way to program rates without a Bxxx constant. The kernel structure is
+// declared here because <asm/termbits.h> conflicts with <termios.h>; its
+// layout is shared by the architectures listed.
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__) || defined(__arm__) || \
+                           defined(__aarch64__) || defined(__riscv))
+#define CT_SERIAL_TERMIOS2 1
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+namespace {
+
+#ifdef CT_SERIAL_TERMIOS2
+struct KernelTermios2 {
+    tcflag_t c_iflag;
+    tcflag_t c_oflag;
+    tcflag_t c_cflag;
+    tcflag_t c_lflag;
+    cc_t c_line;
+    cc_t c_cc[19];
+    speed_t c_ispeed;
+    speed_t c_ospeed;
+};
+
+const unsigned long TERMIOS2_GET = _IOR('T', 0x2A, KernelTermios2);
+const unsigned long TERMIOS2_SET = _IOW('T', 0x2B, KernelTermios2);
+constexpr tcflag_t KERNEL_CBAUD = 0010017;
+constexpr tcflag_t KERNEL_BOTHER = 0010000;
+constexpr int KERNEL_IBSHIFT = 16;
+#endif
+
+struct SpeedEntry {
+    uint32_t rate;
+    speed_t code;
+};
+
+const SpeedEntry SPEEDS[] = {
+    {50, B50}, {75, B75}, {110, B110}, {134, B134}, {150, B150}, {200, B200},
+    {300, B300}, {600, B600}, {1200, B1200}, {1800, B1800}, {2400, B2400},
+    {4800, B4800}, {9600, B9600}, {19200, B19200}, {38400, B38400},
+    {57600, B57600}, {115200, B115200}, {230400, B230400},
+#ifdef B460800
+    {460800, B460800}, {500000, B500000}, {576000, B576000}, {921600, B921600},
+    {1000000, B1000000}, {1152000, B1152000}, {1500000, B1500000},
+    {2000000, B2000000}, {2500000, B2500000}, {3000000, B3000000},
+    {3500000, B3500000}, {4000000, B4000000},
+#endif
+};
+
+speed_t speedCode(uint32_t rate) {
+    for (const auto& entry : SPEEDS) {
+        if (entry.rate == rate) {
+            return entry.code;
+        }
+    }
+    return 0;
+}
+
+uint64_t steadyMicros() noexcept {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void setError(std::string* error, const std::string& message) {
+    if (error) {
+        *error = message;
+    }
+}
+
+bool applyBaudRate(int fd, termios& tio, uint32_t baud_rate, std::string* error) {
+    const speed_t code = speedCode(baud_rate);
+    if (code != 0) {
+        cfsetispeed(&tio, code);
+        cfsetospeed(&tio, code);
+        if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+            setError(error, std::string("tcsetattr: ") + strerror(errno));
+            return false;
+        }
+        return true;
+    }
+
+#ifdef CT_SERIAL_TERMIOS2
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        setError(error, std::string("tcsetattr: ") + strerror(errno));
+        return false;
+    }
+    KernelTermios2 tio2;
+    if (ioctl(fd, TERMIOS2_GET, &tio2) != 0) {
+        setError(error, std::string("TCGETS2: ") + strerror(errno));
+        return false;
+    }
+    tio2.c_cflag &= ~(KERNEL_CBAUD | (KERNEL_CBAUD << KERNEL_IBSHIFT));
+    tio2.c_cflag |= KERNEL_BOTHER | (KERNEL_BOTHER << KERNEL_IBSHIFT);
+    tio2.c_ispeed = baud_rate;
+    tio2.c_ospeed = baud_rate;
+    if (ioctl(fd, TERMIOS2_SET, &tio2) != 0) {
+        setError(error, "baud rate " + std::to_string(baud_rate) + ": " + strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    setError(error, "baud rate " + std::to_string(baud_rate) + " is not supported");
+    return false;
+#endif
+}
+
+bool configureLine(int fd, const SerialConfig& config, std::string* error) {
+    termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        setError(error, config.device + ": " + strerror(errno));
+        return false;
+    }
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSIZE | PARENB | PARODD | CSTOPB);
+    switch (config.data_bits) {
+        case 5: tio.c_cflag |= CS5; break;
+        case 6: tio.c_cflag |= CS6; break;
+        case 7: tio.c_cflag |= CS7; break;
+        case 8: tio.c_cflag |= CS8; break;
+        default:
+            setError(error, "invalid data bits: " + std::to_string(config.data_bits));
+            return false;
+    }
+    if (config.parity != SerialParity::None) {
+        tio.c_cflag |= PARENB | (config.parity == SerialParity::Odd ? PARODD : 0);
+        tio.c_iflag |= INPCK;
+    }
+    if (config.stop_bits == 2) {
+        tio.c_cflag |= CSTOPB;
+    }
+
+    tio.c_cflag &= ~CRTSCTS;
+    tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+    if (config.flow_control == SerialFlowControl::Hardware) {
+        tio.c_cflag |= CRTSCTS;
+    } else if (config.flow_control == SerialFlowControl::Software) {
+        tio.c_iflag |= IXON | IXOFF;
+    }
+
+    // The descriptor is non-blocking; these only matter to blocking readers
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+
+    return applyBaudRate(fd, tio, config.baud_rate, error);
+}
+
+} // namespace
+
+SerialSession::SerialSession(std::shared_ptr<IoReactor> reactor,
+                             std::shared_ptr<WorkerPool> workers)
+    : reactor_(std::move(reactor))
+    , workers_(std::move(workers))
+    , fd_(-1)
+    , write_watched_(false)
+    , deficit_(0)
+    , read_buffer_(new char[READ_CHUNK_SIZE]) {
+    if (workers_) {
+        io_context_.callbacks = std::make_shared<CallbackExecutor>(workers_);
+    }
+}
+
+SerialSession::~SerialSession() {
+    close();
+    if (io_context_.callbacks) {
+        io_context_.callbacks->drain();
+    }
+}
+
+bool SerialSession::open(const SerialConfig& config, std::string* error) {
+    std::unique_lock lock(mutex_);
+    if (fd_ >= 0) {
+        setError(error, "already open: " + config_.device);
+        return false;
+    }
+
+    int fd = ::open(config.device.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        setError(error, config.device + ": " + strerror(errno));
+        return false;
+    }
+
+    auto saved = std::make_unique<termios>();
+    if (tcgetattr(fd, saved.get()) != 0) {
+        setError(error, config.device + ": " + strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    if (config.exclusive && ioctl(fd, TIOCEXCL) != 0) {
+        setError(error, config.device + ": " + strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    if (!configureLine(fd, config, error)) {
+        tcsetattr(fd, TCSANOW, saved.get());
+        ::close(fd);
+        return false;
+    }
+    // Drop whatever the line received before we configured it
+    tcflush(fd, TCIOFLUSH);
+
+    fd_ = fd;
+    config_ = config;
+    saved_termios_ = std::move(saved);
+    pending_input_.clear();
+    write_watched_ = false;
+    deficit_ = 0;
+    io_.clear();
+    reactor_guard_.reset();
+
+    if (io_context_.callbacks) {
+        callback_channel_ = std::make_shared<CallbackExecutor::Channel>();
+        callback_channel_->output = output_callback_;
+        if (close_callback_) {
+            callback_channel_->completion = [callback = close_callback_](const ProcessInfo& info) {
+                callback(info.exit_code);
+            };
+        }
+        // Only reached with flow control: the line throttled the sender meanwhile
+        callback_channel_->resume = reactor_guard_.wrap([this]() {
+            std::lock_guard relock(mutex_);
+            if (fd_ >= 0) {
+                watch(fd_, IoReactor::Readable | (pending_input_.empty() ? 0u : IoReactor::Writable));
+            }
+        });
+    }
+
+    if (!watch(fd, IoReactor::Readable)) {
+        setError(error, "reactor registration failed");
+        fd_ = -1;
+        auto restore = std::move(saved_termios_);
+        lock.unlock();
+        tcsetattr(fd, TCSANOW, restore.get());
+        ::close(fd);
+        return false;
+    }
+    return true;
+}
+
+void SerialSession::close() noexcept {
+    int fd;
+    std::unique_ptr<termios> saved;
+    {
+        std::lock_guard lock(mutex_);
+        fd = fd_;
+        fd_ = -1;
+        saved = std::move(saved_termios_);
+        pending_input_.clear();
+        write_watched_ = false;
+    }
+    if (fd < 0) {
+        return;
+    }
+
+    reactor_guard_.invalidate();
+    reactor_->remove(fd);
+    if (saved) {
+        tcsetattr(fd, TCSANOW, saved.get());
+    }
+    ::close(fd);
+    if (io_context_.callbacks) {
+        io_context_.callbacks->drain();
+    }
+}
+
+bool SerialSession::isOpen() const noexcept {
+    std::lock_guard lock(mutex_);
+    return fd_ >= 0;
+}
+
+bool SerialSession::setBaudRate(uint32_t baud_rate) {
+    std::lock_guard lock(mutex_);
+    if (fd_ < 0) {
+        return false;
+    }
+    termios tio;
+    if (tcgetattr(fd_, &tio) != 0 || !applyBaudRate(fd_, tio, baud_rate, nullptr)) {
+        return false;
+    }
+    config_.baud_rate = baud_rate;
+    return true;
+}
+
+uint32_t SerialSession::getBaudRate() const {
+    std::lock_guard lock(mutex_);
+    if (fd_ < 0) {
+        return 0;
+    }
+#ifdef CT_SERIAL_TERMIOS2
+    KernelTermios2 tio2;
+    if (ioctl(fd_, TERMIOS2_GET, &tio2) == 0) {
+        return tio2.c_ospeed;
+    }
+#endif
+    termios tio;
+    if (tcgetattr(fd_, &tio) != 0) {
+        return 0;
+    }
+    const speed_t code = cfgetospeed(&tio);
+    for (const auto& entry : SPEEDS) {
+        if (entry.code == code) {
+            return entry.rate;
+        }
+    }
+    return 0;
+}
+
+bool SerialSession::sendInput(const std::string& input) {
+    std::lock_guard lock(mutex_);
+    if (fd_ < 0 || pending_input_.size() + input.size() > MAX_PENDING_INPUT) {
+        return false;
+    }
+    if (input.empty()) {
+        return true;
+    }
+
+    // Only the first pending keystroke is timed until the device answers
+    uint64_t expected = 0;
+    input_pending_since_us_.compare_exchange_strong(expected, steadyMicros());
+
+    size_t written = 0;
+    if (pending_input_.empty()) {
+        ssize_t n;
+        do {
+            n = ::write(fd_, input.data(), input.size());
+        } while (n < 0 && errno == EINTR);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+        written = n > 0 ? static_cast<size_t>(n) : 0;
+        bytes_written_.fetch_add(written, std::memory_order_relaxed);
+        if (written == input.size()) {
+            return true;
+        }
+    }
+
+    pending_input_.append(input, written, std::string::npos);
+    if (!write_watched_) {
+        // Fails while reading is paused; resuming re-adds Writable
+        write_watched_ = reactor_->modify(fd_, IoReactor::Readable | IoReactor::Writable);
+    }
+    return true;
+}
+
+bool SerialSession::sendBreak() {
+    std::lock_guard lock(mutex_);
+    return fd_ >= 0 && tcsendbreak(fd_, 0) == 0;
+}
+
+std::string SerialSession::readOutput(size_t max_bytes) const {
+    std::string output = io_.getStdout();
+    if (max_bytes != 0 && output.size() > max_bytes) {
+        output.resize(max_bytes);
+    }
+    return output;
+}
+
+bool SerialSession::hasOutput() const noexcept {
+    return io_.hasData();
+}
+
+void SerialSession::setOutputCallback(OutputCallback callback) {
+    std::lock_guard lock(mutex_);
+    output_callback_ = std::move(callback);
+    if (callback_channel_) {
+        // Replace the channel rather than mutate one the executor may be running
+        auto channel = std::make_shared<CallbackExecutor::Channel>(*callback_channel_);
+        channel->output = output_callback_;
+        callback_channel_ = std::move(channel);
+    }
+}
+
+void SerialSession::setCloseCallback(CloseCallback callback) {
+    std::lock_guard lock(mutex_);
+    close_callback_ = std::move(callback);
+    if (callback_channel_) {
+        auto channel = std::make_shared<CallbackExecutor::Channel>(*callback_channel_);
+        channel->completion = nullptr;
+        if (close_callback_) {
+            channel->completion = [callback = close_callback_](const ProcessInfo& info) {
+                callback(info.exit_code);
+            };
+        }
+        callback_channel_ = std::move(channel);
+    }
+}
+
+void SerialSession::setForeground(bool foreground) {
+    io_context_.foreground.store(foreground);
+}
+
+bool SerialSession::isForeground() const noexcept {
+    return io_context_.foreground.load();
+}
+
+SessionMetrics SerialSession::getSessionMetrics() const noexcept {
+    SessionMetrics metrics;
+    metrics.foreground = io_context_.foreground.load();
+    metrics.echo_samples = io_context_.echo_latency.count();
+    metrics.echo_p50_us = io_context_.echo_latency.percentile(50.0);
+    metrics.echo_p99_us = io_context_.echo_latency.percentile(99.0);
+    metrics.echo_max_us = io_context_.echo_latency.max();
+    metrics.bytes_read = io_context_.bytes_read.load();
+    metrics.budget_yields = io_context_.budget_yields.load();
+    if (io_context_.callbacks) {
+        metrics.callbacks = io_context_.callbacks->getMetrics();
+    }
+    return metrics;
+}
+
+SerialMetrics SerialSession::getSerialMetrics() const {
+    SerialMetrics metrics;
+    metrics.bytes_read = io_context_.bytes_read.load();
+    metrics.bytes_written = bytes_written_.load();
+    metrics.reads = reads_.load();
+    metrics.consumer_lags = consumer_lags_.load();
+
+#if defined(__linux__) && defined(TIOCGICOUNT)
+    std::lock_guard lock(mutex_);
+    serial_icounter_struct counters{};
+    // Not every driver keeps counters (ptys and many USB adapters do not)
+    if (fd_ >= 0 && ioctl(fd_, TIOCGICOUNT, &counters) == 0) {
+        metrics.overruns = static_cast<uint64_t>(counters.overrun) + counters.buf_overrun;
+        metrics.frame_errors = counters.frame;
+        metrics.parity_errors = counters.parity;
+        metrics.breaks = counters.brk;
+    }
+#endif
+    return metrics;
+}
+
+SerialConfig SerialSession::getConfig() const {
+    std::lock_guard lock(mutex_);
+    return config_;
+}
+
+bool SerialSession::watch(int fd, uint32_t events) {
+    if (!reactor_->add(fd, events, [this](int ready_fd, uint32_t ready) { handleEvents(ready_fd, ready); })) {
+        return false;
+    }
+    // A UART cannot be made to wait: serve it ahead of every pipe
+    reactor_->setPriority(fd, true);
+    write_watched_ = (events & IoReactor::Writable) != 0;
+    return true;
+}
+
+void SerialSession::handleEvents(int fd, uint32_t events) {
+    if (events & IoReactor::Writable) {
+        flushInput(fd);
+    }
+    if (events & (IoReactor::Readable | IoReactor::HangUp | IoReactor::Error)) {
+        handleReadable(fd);
+    }
+}
+
+void SerialSession::handleReadable(int fd) {
+    deficit_ += io_context_.quantum();
+
+    while (deficit_ > 0) {
+        ssize_t bytes_read = ::read(fd, read_buffer_.get(), std::min(READ_CHUNK_SIZE, deficit_));
+        if (bytes_read > 0) {
+            deficit_ -= static_cast<size_t>(bytes_read);
+            reads_.fetch_add(1, std::memory_order_relaxed);
+            io_context_.bytes_read.fetch_add(bytes_read, std::memory_order_relaxed);
+
+            const uint64_t since = input_pending_since_us_.exchange(0, std::memory_order_relaxed);
+            if (since != 0) {
+                const uint64_t now = steadyMicros();
+                io_context_.echo_latency.record(now > since ? now - since : 0);
+            }
+
+            io_.appendStdout(read_buffer_.get(), static_cast<size_t>(bytes_read));
+            if (!notifyOutput(fd, read_buffer_.get(), static_cast<size_t>(bytes_read))) {
+                deficit_ = 0;
+                return;
+            }
+            continue;
+        }
+
+        if (bytes_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            deficit_ = 0;
+            return;
+        }
+
+        // Hangup (adapter unplugged, pty peer closed) or a hard error
+        deficit_ = 0;
+        closeOnError(fd, bytes_read < 0 ? errno : 0);
+        return;
+    }
+
+    io_context_.budget_yields.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SerialSession::flushInput(int fd) {
+    std::lock_guard lock(mutex_);
+    if (fd_ != fd) {
+        return;
+    }
+    while (!pending_input_.empty()) {
+        ssize_t n = ::write(fd, pending_input_.data(), pending_input_.size());
+        if (n > 0) {
+            bytes_written_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+            pending_input_.erase(0, static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        return;   // Transmit buffer full (or an error the read side will report)
+    }
+    reactor_->modify(fd, IoReactor::Readable);
+    write_watched_ = false;
+}
+
+bool SerialSession::notifyOutput(int fd, const char* data, size_t size) {
+    CallbackExecutor::ChannelPtr channel;
+    OutputCallback callback;
+    bool flow_controlled;
+    {
+        std::lock_guard lock(mutex_);
+        channel = callback_channel_;
+        if (!channel) {
+            callback = output_callback_;
+        }
+        flow_controlled = config_.flow_control != SerialFlowControl::None;
+    }
+    if (!channel) {
+        // Called unlocked: the callback may write to or reconfigure the session
+        if (callback) {
+            callback(std::string(data, size), false);
+        }
+        return true;
+    }
+
+    if (io_context_.callbacks->postOutput(channel, data, size, false)) {
+        return true;
+    }
+    consumer_lags_.fetch_add(1, std::memory_order_relaxed);
+    if (!flow_controlled) {
+        return true;   // Keep reading: the kernel buffer would overflow instead
+    }
+    pauseOutput(fd);
+    return false;
+}
+
+void SerialSession::pauseOutput(int fd) {
+    // The unread input fills the tty buffer, which deasserts RTS or sends
+    // XOFF, until the consumer drains and resume re-registers the port
+    reactor_->remove(fd);
+    CallbackExecutor::ChannelPtr channel;
+    {
+        std::lock_guard lock(mutex_);
+        channel = callback_channel_;
+    }
+    io_context_.callbacks->awaitDrain(channel);
+}
+
+void SerialSession::closeOnError(int fd, int error) {
+    CallbackExecutor::ChannelPtr channel;
+    CloseCallback callback;
+    {
+        std::lock_guard lock(mutex_);
+        if (fd_ != fd) {
+            return;
+        }
+        fd_ = -1;
+        saved_termios_.reset();   // The device is gone or broken, nothing to restore
+        pending_input_.clear();
+        write_watched_ = false;
+        channel = callback_channel_;
+        callback = close_callback_;
+    }
+
+    reactor_->remove(fd);
+    ::close(fd);
+
+    if (channel) {
+        ProcessInfo info;
+        info.state = error ? ProcessState::Failed : ProcessState::Completed;
+        info.exit_code = error;
+        io_context_.callbacks->postCompletion(channel, info);
+    } else if (callback) {
+        callback(error);
+    }
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "core/implementations/callback_executor.h"
+#include "core/implementations/io_reactor.h"
+#include "core/implementations/shell_impl.h"
+#include "core/implementations/worker_pool.h"
+#include "core/utils/callback_guard.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+struct termios;
+
+/**
+ * @file serial_session.h
+ * @brief Serial console session on the shared reactor
+ *
+ * Attaches to a UART (/dev/ttyS*, /dev/ttyUSB*, /dev/ttyACM*) in raw
+ * mode and serves it like a process output stream: the descriptor is
+ * multiplexed on the IoReactor, received bytes land in the same bounded
+ * scrollback (ProcessIO) and reach the output callback through the
+ * session's CallbackExecutor. Arbitrary baud rates are programmed with
+ * termios2 (BOTHER) on Linux.
+ *
+ * Unlike a pipe, a UART without flow control cannot push back: bytes not
+ * read before the kernel's receive buffer fills are lost. The port is
+ * therefore always dispatched at high priority and keeps being read while
+ * the consumer lags; only with hardware or software flow control does a
+ * lagging consumer pause reading and let the line throttle the sender.
+ *
+ * @performance One read() per quantum, no extra threads
+ * @thread_safety All public methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+/**
+ * @brief Parity setting
+ */
+enum class SerialParity : uint8_t {
+    None = 0,
+    Even = 1,
+    Odd = 2
+};
+
+/**
+ * @brief Flow control setting
+ */
+enum class SerialFlowControl : uint8_t {
+    None = 0,
+    Hardware = 1,   ///< RTS/CTS
+    Software = 2    ///< XON/XOFF
+};
+
+/**
+ * @brief Port settings
+ */
+struct SerialConfig {
+    std::string device;                 ///< e.g. /dev/ttyUSB0
+    uint32_t baud_rate = 115200;        ///< Any rate the UART supports
+    uint8_t data_bits = 8;              ///< 5-8
+    SerialParity parity = SerialParity::None;
+    uint8_t stop_bits = 1;              ///< 1 or 2
+    SerialFlowControl flow_control = SerialFlowControl::None;
+    bool exclusive = true;              ///< Refuse other openers (TIOCEXCL)
+};
+
+/**
+ * @brief Snapshot of serial line metrics
+ */
+struct SerialMetrics {
+    uint64_t bytes_read = 0;
+    uint64_t bytes_written = 0;
+    uint64_t reads = 0;              ///< read() calls that returned data
+    uint64_t consumer_lags = 0;      ///< Chunks queued past the callback byte limit
+    uint64_t overruns = 0;           ///< Bytes lost by the UART or tty buffer (driver counters)
+    uint64_t frame_errors = 0;
+    uint64_t parity_errors = 0;
+    uint64_t breaks = 0;
+};
+
+/**
+ * @brief Serial console session
+ */
+class SerialSession {
+public:
+    using OutputCallback = IShell::OutputCallback;
+    /// @brief Invoked once when the port closes on its own (0, or the errno that ended it)
+    using CloseCallback = std::function<void(int error)>;
+
+    static constexpr size_t READ_CHUNK_SIZE = 16 * 1024;
+    static constexpr size_t MAX_PENDING_INPUT = 1024 * 1024;
+
+    /**
+     * @brief Constructor
+     * @param reactor Running reactor serving the port
+     * @param workers Pool running the output callback (null: on the reactor thread)
+     */
+    explicit SerialSession(std::shared_ptr<IoReactor> reactor,
+                           std::shared_ptr<WorkerPool> workers = nullptr);
+    ~SerialSession();
+
+    // Non-copyable, non-movable
+    SerialSession(const SerialSession&) = delete;
+    SerialSession& operator=(const SerialSession&) = delete;
+    SerialSession(SerialSession&&) = delete;
+    SerialSession& operator=(SerialSession&&) = delete;
+
+    /**
+     * @brief Open and configure the port, then start reading
+     * @param config Port settings
+     * @param error Receives the reason on failure (optional)
+     * @return true if the port is open and registered with the reactor
+     * @thread_safe Yes
+     */
+    bool open(const SerialConfig& config, std::string* error = nullptr);
+
+    /**
+     * @brief Stop reading, restore the port's previous settings and close it
+     * @thread_safe Yes - waits for a running read handler
+     * @exception_safety No-throw guarantee
+     */
+    void close() noexcept;
+
+    bool isOpen() const noexcept;
+
+    /**
+     * @brief Change the line speed of the open port
+     * @thread_safe Yes
+     */
+    bool setBaudRate(uint32_t baud_rate);
+
+    /// @brief Line speed reported by the driver, 0 if closed
+    uint32_t getBaudRate() const;
+
+    /**
+     * @brief Queue bytes for transmission
+     *
+     * Written immediately when the line is idle; the remainder is sent as
+     * the driver drains its transmit buffer.
+     *
+     * @return false if closed or more than MAX_PENDING_INPUT is queued
+     * @thread_safe Yes
+     * @performance Never blocks
+     */
+    bool sendInput(const std::string& input);
+
+    /// @brief Transmit a break condition
+    bool sendBreak();
+
+    /// @brief Received bytes still held in scrollback
+    std::string readOutput(size_t max_bytes = 0) const;
+    bool hasOutput() const noexcept;
+
+    /// @brief Callbacks for data read and for a hangup; may be replaced while open
+    void setOutputCallback(OutputCallback callback);
+    void setCloseCallback(CloseCallback callback);
+
+    /**
+     * @brief Mark this session as the one the user is interacting with
+     *
+     * Only affects the read quantum; the port is dispatched ahead of pipes
+     * either way.
+     *
+     * @thread_safe Yes
+     */
+    void setForeground(bool foreground);
+    bool isForeground() const noexcept;
+
+    /// @brief Scheduling and echo latency metrics, as for shell sessions
+    SessionMetrics getSessionMetrics() const noexcept;
+
+    /// @brief Line metrics, including the driver's error counters
+    SerialMetrics getSerialMetrics() const;
+
+    /// @brief Shrink scrollback to the newest keep_bytes
+    size_t trimOutput(size_t keep_bytes) noexcept { return io_.trim(keep_bytes); }
+
+    /// @brief Settings of the last open()
+    SerialConfig getConfig() const;
+
+private:
+    std::shared_ptr<IoReactor> reactor_;
+    std::shared_ptr<WorkerPool> workers_;
+    SessionIoContext io_context_;
+    ProcessIO io_;
+    CallbackGuard reactor_guard_;
+
+    mutable std::mutex mutex_;   // fd_, config_, saved settings, pending input
+    int fd_;
+    SerialConfig config_;
+    std::unique_ptr<::termios> saved_termios_;   // Settings to restore on close
+    std::string pending_input_;
+    bool write_watched_;
+
+    OutputCallback output_callback_;
+    CloseCallback close_callback_;
+    CallbackExecutor::ChannelPtr callback_channel_;
+
+    // Touched on the reactor thread only
+    size_t deficit_;
+    std::unique_ptr<char[]> read_buffer_;
+
+    std::atomic<uint64_t> bytes_written_{0};
+    std::atomic<uint64_t> reads_{0};
+    std::atomic<uint64_t> consumer_lags_{0};
+    std::atomic<uint64_t> input_pending_since_us_{0};
+
+    bool watch(int fd, uint32_t events);
+    void handleEvents(int fd, uint32_t events);
+    void handleReadable(int fd);
+    void flushInput(int fd);
+    void pauseOutput(int fd);
+    void closeOnError(int fd, int error);
+    bool notifyOutput(int fd, const char* data, size_t size);
+};
+
+} // namespace core
+} // namespace cross_terminal
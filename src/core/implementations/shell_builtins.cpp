@@ -0,0 +1,346 @@
+#include "shell_impl.h"
+#include "builtins/file_builtins.h"
+#include "builtins/job_builtins.h"
+#include "builtins/search_builtins.h"
+#include "builtins/thread_builtins.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <sstream>
+#include <unordered_set>
+
+namespace cross_terminal {
+namespace core {
+
+bool ShellImpl::isBuiltinCommand(const std::string& command) const noexcept {
+    static const std::unordered_set<std::string> builtins(std::begin(BUILTIN_COMMANDS),
+                                                          std::end(BUILTIN_COMMANDS));
+    
+    return builtins.find(command) != builtins.end();
+}
+
+bool ShellImpl::runsAsBuiltin(const ParsedCommand& parsed) const {
+    if (!isBuiltinCommand(parsed.executable)) {
+        return false;
+    }
+    std::vector<std::string> operands;
+    if (builtins::isFileOperation(parsed.executable)) {
+        FileOperationOptions ignored;
+        return builtins::parseFileOperationArguments(parsed.executable, parsed.arguments, ignored, operands);
+    }
+    if (parsed.executable == "find") {
+        FindOptions ignored;
+        return builtins::parseFindArguments(parsed.arguments, operands, ignored);
+    }
+    if (parsed.executable == "du") {
+        DiskUsageOptions ignored;
+        bool human = false;
+        return builtins::parseDiskUsageArguments(parsed.arguments, operands, ignored, human);
+    }
+    return true;
+}
+
+ProcessInfo ShellImpl::executeBuiltin(const std::string& command, 
+                                     const ArgumentList& args,
+                                     const ExecutionOptions& options,
+                                     const OutputCallback& output,
+                                     BuiltinJob* job) {
+    if (command == "cd") {
+        return executeBuiltinCd(args);
+    } else if (command == "pwd") {
+        return executeBuiltinPwd(args, output);
+    } else if (command == "echo") {
+        return executeBuiltinEcho(args, output);
+    } else if (command == "exit") {
+        return executeBuiltinExit(args);
+    } else if (command == "jobs") {
+        return executeBuiltinJobs(args, output);
+    } else if (command == "kill") {
+        return executeBuiltinKill(args);
+    } else if (command == "export") {
+        return executeBuiltinExport(args);
+    } else if (command == "threads") {
+        return builtins::runThreads(args, output);
+    } else if (builtins::isFileOperation(command)) {
+        return builtins::runFileOperation(command, args, fs_, filePool(), output, job);
+    } else if (command == "find" || command == "du") {
+        return builtins::runTreeSearch(command, args, fs_, filePool(), output, job);
+    } else if (command == "onchange") {
+        return watches_.start(args, fs_, sessionDirectory(options), options.merge_stderr, output, job);
+    }
+    
+    ProcessInfo info;
+    info.state = ProcessState::Failed;
+    info.exit_code = 1;
+    return info;
+}
+
+int ShellImpl::startBuiltinJob(ParsedCommand parsed, const ExecutionOptions& options,
+                               OutputCallback output, CompletionCallback completion) {
+    const int pid = next_pid_.fetch_add(1);
+    auto job = std::make_shared<BuiltinJob>(pid, parsed.executable,
+                                            [this, pid, completion](const ProcessInfo& info) {
+        {
+            std::lock_guard lock(builtin_jobs_mutex_);
+            builtin_jobs_.erase(pid);
+        }
+        if (completion) {
+            completion(info);
+        }
+    });
+    {
+        std::lock_guard lock(builtin_jobs_mutex_);
+        builtin_jobs_[pid] = job;
+    }
+    
+    // The directory and stderr merging the builtins read, as they were when
+    // the job was started
+    auto run = [this, job, parsed = std::move(parsed), directory = sessionDirectory(options),
+                merge_stderr = options.merge_stderr, output = std::move(output)]() {
+        if (!job->begin()) {
+            return;
+        }
+        ExecutionOptions options;
+        options.working_directory = directory;
+        options.merge_stderr = merge_stderr;
+        ProcessInfo info = executeBuiltin(parsed.executable, parsed.arguments, options, output, job.get());
+        if (info.state == ProcessState::Running) {
+            return;   // Kept running: the builtin completes the job itself
+        }
+        info.pid = job->id();
+        job->complete(info);
+    };
+    // Not behind runtime_guard_, which would hold up the cleanup sweep for
+    // the whole run: shutdown cancels the job and waits for it instead,
+    // and a job cancelled while queued never touches the shell
+    if (!workers_->submit(std::move(run))) {
+        job->cancel();
+    }
+    return pid;
+}
+
+void ShellImpl::cancelBuiltinJobs() noexcept {
+    std::unordered_map<int, std::shared_ptr<BuiltinJob>> jobs;
+    {
+        std::lock_guard lock(builtin_jobs_mutex_);
+        jobs.swap(builtin_jobs_);
+    }
+    for (auto& [pid, job] : jobs) {
+        job->cancel();
+    }
+    for (auto& [pid, job] : jobs) {
+        job->wait();
+    }
+}
+
+std::shared_ptr<WorkStealingPool> ShellImpl::filePool() {
+    std::lock_guard lock(file_pool_mutex_);
+    if (!file_pool_) {
+        file_pool_ = std::make_shared<WorkStealingPool>();
+    }
+    return file_pool_;
+}
+
+ProcessInfo ShellImpl::executeBuiltinCd(const ArgumentList& args) {
+    ProcessInfo info;
+    info.command = "cd";
+    info.arguments.assign(args.begin(), args.end());
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    std::string target_dir;
+    if (args.empty()) {
+        target_dir = environment_.get("HOME");
+        if (target_dir.empty()) {
+            target_dir = "/";
+        }
+    } else {
+        target_dir = args[0];
+    }
+    
+    if (setCurrentDirectory(target_dir)) {
+        info.state = ProcessState::Completed;
+        info.exit_code = 0;
+    } else {
+        info.state = ProcessState::Failed;
+        info.exit_code = 1;
+    }
+    
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    return info;
+}
+
+ProcessInfo ShellImpl::executeBuiltinPwd(const ArgumentList& args,
+                                        const OutputCallback& output) {
+    ProcessInfo info;
+    info.command = "pwd";
+    info.arguments.assign(args.begin(), args.end());
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    if (output) {
+        output(getCurrentDirectory() + "\n", false);
+    }
+    info.state = ProcessState::Completed;
+    info.exit_code = 0;
+    
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    return info;
+}
+
+ProcessInfo ShellImpl::executeBuiltinEcho(const ArgumentList& args,
+                                         const OutputCallback& output) {
+    ProcessInfo info;
+    info.command = "echo";
+    info.arguments.assign(args.begin(), args.end());
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    if (output) {
+        std::string line;
+        for (size_t i = 0; i < args.size(); ++i) {
+            line += (i ? " " : "") + args[i];
+        }
+        output(line + "\n", false);
+    }
+    info.state = ProcessState::Completed;
+    info.exit_code = 0;
+    
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    return info;
+}
+
+ProcessInfo ShellImpl::executeBuiltinExit(const ArgumentList& args) {
+    ProcessInfo info;
+    info.command = "exit";
+    info.arguments.assign(args.begin(), args.end());
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    int exit_code = 0;
+    if (!args.empty()) {
+        try {
+            exit_code = std::stoi(args[0]);
+        } catch (const std::exception&) {
+            exit_code = 1;
+        }
+    }
+    
+    info.state = ProcessState::Completed;
+    info.exit_code = exit_code;
+    
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    return info;
+}
+
+ProcessInfo ShellImpl::executeBuiltinJobs(const ArgumentList& args,
+                                         const OutputCallback& output) {
+    ProcessInfo info;
+    info.command = "jobs";
+    info.arguments.assign(args.begin(), args.end());
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    auto emit = [&output](const std::string& text, bool is_error) {
+        if (output) {
+            output(text, is_error);
+        }
+    };
+    
+    const bool history = std::find(args.begin(), args.end(), "--history") != args.end();
+    if (history) {
+        info.exit_code = builtins::listJobHistory(getJobHistory(), args, info.start_time, output);
+    } else {
+        std::ostringstream listing;
+        for (const auto& process : getAllProcesses()) {
+            listing << '[' << process.pid << "] "
+                    << (process.state == ProcessState::Suspended ? "Stopped" : "Running")
+                    << "  " << process.command;
+            for (const auto& argument : process.arguments) {
+                listing << ' ' << argument;
+            }
+            listing << '\n';
+        }
+        emit(listing.str(), false);
+        info.exit_code = 0;
+    }
+    
+    info.state = info.exit_code == 0 ? ProcessState::Completed : ProcessState::Failed;
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    return info;
+}
+
+void ShellImpl::setJobHistory(std::shared_ptr<JobHistory> history) {
+    std::lock_guard lock(history_mutex_);
+    history_ = std::move(history);
+}
+
+std::shared_ptr<JobHistory> ShellImpl::getJobHistory() const {
+    std::lock_guard lock(history_mutex_);
+    return history_;
+}
+
+ProcessInfo ShellImpl::executeBuiltinKill(const ArgumentList& args) {
+    ProcessInfo info;
+    info.command = "kill";
+    info.arguments.assign(args.begin(), args.end());
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    if (!args.empty()) {
+        try {
+            int pid = std::stoi(args[0]);
+            bool success = terminateProcess(pid, false);
+            info.exit_code = success ? 0 : 1;
+        } catch (const std::exception&) {
+            info.exit_code = 1;
+        }
+    } else {
+        info.exit_code = 1;
+    }
+    
+    info.state = (info.exit_code == 0) ? ProcessState::Completed : ProcessState::Failed;
+    
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    return info;
+}
+
+ProcessInfo ShellImpl::executeBuiltinExport(const ArgumentList& args) {
+    ProcessInfo info;
+    info.command = "export";
+    info.arguments.assign(args.begin(), args.end());
+    info.start_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    for (const auto& arg : args) {
+        size_t pos = arg.find('=');
+        if (pos != std::string::npos) {
+            std::string name = arg.substr(0, pos);
+            std::string value = arg.substr(pos + 1);
+            environment_.set(name, value);
+        }
+    }
+    
+    info.state = ProcessState::Completed;
+    info.exit_code = 0;
+    
+    info.end_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    return info;
+}
+
+} // namespace core
+} // namespace cross_terminal
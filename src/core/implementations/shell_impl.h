@@ -1,9 +1,27 @@
 #pragma once
 
 #include "core/interfaces/i_shell.h"
+#include "core/implementations/builtins/builtin_job.h"
+#include "core/implementations/builtins/watch_builtin.h"
+#include "core/implementations/callback_executor.h"
+#include "core/implementations/command_parser.h"
+#include "core/implementations/fs_context.h"
+#include "core/implementations/io_reactor.h"
+#include "core/implementations/job_history.h"
+#include "core/implementations/managed_process.h"
+#include "core/implementations/process_pool.h"
+#include "core/implementations/process_terminator.h"
+#include "core/implementations/work_stealing_pool.h"
+#include "core/implementations/worker_pool.h"
+#include "core/utils/callback_guard.h"
+#include "core/utils/latency_histogram.h"
+#include "memory/memory_budget.h"
 #include "memory/memory_manager.h"
+#include "memory/small_vector.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <atomic>
 #include <condition_variable>
@@ -25,114 +43,17 @@ namespace cross_terminal {
 namespace core {
 
 /**
- * @brief Platform-specific process handle wrapper
+ * @brief Snapshot of a session's output scheduling metrics
  */
-struct ProcessHandle {
-#ifdef _WIN32
-    void* process_handle;
-    void* thread_handle;
-    unsigned long process_id;
-    unsigned long thread_id;
-#else
-    pid_t pid;
-    int stdin_fd;
-    int stdout_fd;
-    int stderr_fd;
-#endif
-    
-    ProcessHandle();
-    ~ProcessHandle();
-    
-    bool isValid() const noexcept;
-    void close() noexcept;
-};
-
-/**
- * @brief Process I/O buffer management
- */
-class ProcessIO {
-private:
-    static constexpr size_t BUFFER_SIZE = 8192;
-    
-    std::unique_ptr<char[]> stdout_buffer_;
-    std::unique_ptr<char[]> stderr_buffer_;
-    size_t stdout_size_;
-    size_t stderr_size_;
-    mutable std::shared_mutex io_mutex_;
-    
-public:
-    ProcessIO();
-    ~ProcessIO() = default;
-    
-    // Non-copyable, movable
-    ProcessIO(const ProcessIO&) = delete;
-    ProcessIO& operator=(const ProcessIO&) = delete;
-    ProcessIO(ProcessIO&&) noexcept;
-    ProcessIO& operator=(ProcessIO&&) noexcept;
-    
-    void appendStdout(const char* data, size_t size);
-    void appendStderr(const char* data, size_t size);
-    
-    std::string getStdout() const;
-    std::string getStderr() const;
-    std::string getAllOutput() const;
-    
-    void clear() noexcept;
-    bool hasData() const noexcept;
-    size_t getStdoutSize() const noexcept;
-    size_t getStderrSize() const noexcept;
-};
-
-/**
- * @brief Managed process wrapper
- */
-class ManagedProcess {
-private:
-    ProcessHandle handle_;
-    ProcessInfo info_;
-    ProcessIO io_;
-    std::atomic<bool> running_;
-    std::atomic<bool> io_thread_active_;
-    std::thread io_thread_;
-    
-    IShell::OutputCallback output_callback_;
-    IShell::CompletionCallback completion_callback_;
-    
-    // I/O monitoring
-    void ioThreadFunction();
-    void notifyOutput(const std::string& output, bool is_error);
-    void notifyCompletion();
-    
-public:
-    ManagedProcess(int pid, const std::string& command, 
-                  const std::vector<std::string>& args);
-    ~ManagedProcess();
-    
-    // Non-copyable, movable
-    ManagedProcess(const ManagedProcess&) = delete;
-    ManagedProcess& operator=(const ManagedProcess&) = delete;
-    ManagedProcess(ManagedProcess&&) noexcept;
-    ManagedProcess& operator=(ManagedProcess&&) noexcept;
-    
-    // Process control
-    bool start(const ExecutionOptions& options);
-    bool terminate(bool force = false) noexcept;
-    bool suspend();
-    bool resume();
-    
-    // I/O operations
-    bool sendInput(const std::string& input);
-    std::string readOutput(size_t max_bytes = 0);
-    bool hasOutput() const noexcept;
-    
-    // Status queries
-    ProcessInfo getInfo() const;
-    bool isRunning() const noexcept;
-    bool isComplete() const noexcept;
-    
-    // Callbacks
-    void setOutputCallback(IShell::OutputCallback callback);
-    void setCompletionCallback(IShell::CompletionCallback callback);
+struct SessionMetrics {
+    bool foreground = false;
+    uint64_t echo_samples = 0;
+    uint64_t echo_p50_us = 0;
+    uint64_t echo_p99_us = 0;
+    uint64_t echo_max_us = 0;
+    uint64_t bytes_read = 0;
+    uint64_t budget_yields = 0;   ///< Times a pipe gave up its turn with data left
+    CallbackMetrics callbacks;    ///< Delivery of output and completion callbacks
 };
 
 /**
@@ -143,18 +64,17 @@ public:
  */
 class ShellImpl : public IShell {
 private:
-    // Memory management
-    using ProcessPool = memory::MemoryPool<ManagedProcess, 64>;
-    static ProcessPool process_pool_;
+    static constexpr uint32_t CLEANUP_INTERVAL_MS = 5000;
+    static constexpr uint32_t SHUTDOWN_GRACE_MS = 1000;
     
     // Process management
-    std::unordered_map<int, std::unique_ptr<ManagedProcess>> active_processes_;
+    std::unordered_map<int, ProcessPtr> active_processes_;
     mutable std::shared_mutex processes_mutex_;
     std::atomic<int> next_pid_;
     
     // Shell configuration
     std::string shell_path_;
-    std::string current_directory_;
+    mutable FsContext fs_;   // Session working directory; internally synchronized
     Environment environment_;
     
     // Terminal settings
@@ -167,36 +87,63 @@ private:
     
     mutable std::mutex terminal_mutex_;
     
-    // Background cleanup thread
+    // Shared runtime (null for a standalone shell)
+    std::shared_ptr<IoReactor> reactor_;
+    std::shared_ptr<WorkerPool> workers_;
+    std::shared_ptr<WorkStealingPool> file_pool_;   // Started on first use if not shared
+    std::mutex file_pool_mutex_;
+    IoReactor::TimerId cleanup_timer_;
+    CallbackGuard runtime_guard_;
+    SessionIoContext io_context_;
+    
+    ShutdownReport last_shutdown_report_;
+    mutable std::mutex shutdown_mutex_;
+    
+    // Builtins running as jobs on the workers, by id
+    std::unordered_map<int, std::shared_ptr<BuiltinJob>> builtin_jobs_;
+    std::mutex builtin_jobs_mutex_;
+    
+    // onchange jobs; each reruns its command on the workers
+    builtins::CommandWatches watches_;
+    
+    // Archive of completed jobs (optional, may be shared between shells)
+    std::shared_ptr<JobHistory> history_;
+    mutable std::mutex history_mutex_;
+    
+    // Background cleanup thread (standalone shell only)
     std::atomic<bool> cleanup_active_;
     std::thread cleanup_thread_;
-    std::condition_variable cleanup_condition_;
+    std::condition_variable_any cleanup_condition_;
     
     // Process lifecycle
     void cleanupCompletedProcesses();
     void cleanupThreadFunction();
-    std::unique_ptr<ManagedProcess> createProcess(const std::string& command,
-                                                const std::vector<std::string>& args);
+    void scheduleCleanup();
+    void archive(const ProcessInfo& info);
+    ProcessPtr createProcess(const std::string& command,
+                             const ArgumentList& args);
     
     // Command parsing
-    struct ParsedCommand {
-        std::string executable;
-        std::vector<std::string> arguments;
-        std::vector<std::string> input_redirections;
-        std::vector<std::string> output_redirections;
-        bool append_output = false;
-        bool run_in_background = false;
-        
-        bool isValid() const noexcept {
-            return !executable.empty();
-        }
-    };
+    using ParsedCommand = core::ParsedCommand;
     
     ParsedCommand parseCommand(const std::string& command) const;
     bool isBuiltinCommand(const std::string& command) const noexcept;
+    /// Builtin name, and for cp/mv/rm/find/du only flags the builtin implements
+    bool runsAsBuiltin(const ParsedCommand& parsed) const;
+    /// options.working_directory made absolute against the session directory
+    std::string sessionDirectory(const ExecutionOptions& options) const;
     ProcessInfo executeBuiltin(const std::string& command, 
-                             const std::vector<std::string>& args,
-                             const ExecutionOptions& options);
+                             const ArgumentList& args,
+                             const ExecutionOptions& options,
+                             const OutputCallback& output = nullptr,
+                             BuiltinJob* job = nullptr);
+    /// Run a builtin as a job on the workers; returns its id. A builtin
+    /// that returns ProcessState::Running completes the job itself
+    int startBuiltinJob(ParsedCommand parsed, const ExecutionOptions& options,
+                        OutputCallback output, CompletionCallback completion);
+    /// Cancel every builtin job and wait for each to complete
+    void cancelBuiltinJobs() noexcept;
+    std::shared_ptr<WorkStealingPool> filePool();
     
     // Platform-specific implementations
 #ifdef _WIN32
@@ -211,12 +158,67 @@ private:
     
 public:
     ShellImpl();
+    
+    /**
+     * @brief Construct a shell driven by a shared runtime
+     * @param reactor Reactor multiplexing process I/O for this shell
+     * @param workers Worker pool for blocking maintenance work and for
+     *        builtins that run as jobs
+     * @param file_pool Work-stealing pool the cp, mv, rm, find and du builtins
+     *        share with other sessions; one is started on first use if null
+     * @thread_safe Yes
+     */
+    ShellImpl(std::shared_ptr<IoReactor> reactor,
+              std::shared_ptr<WorkerPool> workers,
+              std::shared_ptr<WorkStealingPool> file_pool = nullptr);
     virtual ~ShellImpl();
     
     // IShell implementation
     bool initialize() override;
     void shutdown() noexcept override;
     
+    /**
+     * @brief Terminate all processes with a global deadline
+     *
+     * All process groups receive SIGTERM at once and are awaited
+     * concurrently; whatever is still alive after grace_ms is killed.
+     *
+     * @param grace_ms Time allowed for graceful exit
+     * @return Counts and duration of the shutdown
+     * @thread_safe Yes
+     * @performance Bounded by grace_ms, independent of process count
+     * @exception_safety No-throw guarantee
+     */
+    ShutdownReport shutdown(uint32_t grace_ms) noexcept;
+    
+    /// @brief Report of the most recent shutdown
+    ShutdownReport getLastShutdownReport() const;
+    
+    /**
+     * @brief Stop maintenance and hand over all processes
+     *
+     * Lets an owner of several shells terminate every process in one
+     * ProcessTerminator pass.
+     *
+     * @thread_safe Yes
+     */
+    std::unordered_map<int, ProcessPtr> releaseProcesses() noexcept;
+    
+    /**
+     * @brief Archive completed jobs into a history store
+     *
+     * Completed processes are appended when the cleanup sweep removes
+     * them, when executeSync() returns and on shutdown. Queried by the
+     * `jobs --history` builtin.
+     *
+     * @param history Open job log, or nullptr to stop archiving
+     * @thread_safe Yes
+     */
+    void setJobHistory(std::shared_ptr<JobHistory> history);
+    
+    /// @brief Current job history store, may be null
+    std::shared_ptr<JobHistory> getJobHistory() const;
+    
     ProcessInfo executeSync(const std::string& command,
                           const ExecutionOptions& options = {}) override;
     
@@ -248,88 +250,69 @@ public:
     bool setEcho(bool enable) override;
     bool setRawMode(bool raw_mode) override;
     
-private:
-    // Utility methods
-    std::string expandPath(const std::string& path) const;
-    bool validateCommand(const std::string& command) const noexcept;
-    void updateProcessState(int pid, ProcessState state, int exit_code = 0);
+    /**
+     * @brief Mark this session as the one the user is interacting with
+     *
+     * Foreground processes get a larger output quantum and are dispatched
+     * first by the reactor, keeping keystroke echo responsive while
+     * background sessions flood their pipes.
+     *
+     * @thread_safe Yes
+     */
+    void setForeground(bool foreground);
     
-    // Built-in commands
-    ProcessInfo executeBuiltinCd(const std::vector<std::string>& args);
-    ProcessInfo executeBuiltinPwd(const std::vector<std::string>& args);
-    ProcessInfo executeBuiltinEcho(const std::vector<std::string>& args);
-    ProcessInfo executeBuiltinExit(const std::vector<std::string>& args);
-    ProcessInfo executeBuiltinJobs(const std::vector<std::string>& args);
-    ProcessInfo executeBuiltinKill(const std::vector<std::string>& args);
-    ProcessInfo executeBuiltinExport(const std::vector<std::string>& args);
-};
-
-/**
- * @brief Command parser utility
- * 
- * Parses shell command strings into structured command objects
- * with support for arguments, redirections, and job control.
- */
-class CommandParser {
-private:
-    using TokenPool = memory::MemoryPool<std::string, 256>;
-    static TokenPool token_pool_;
-    
-    enum class TokenType {
-        Word,
-        Pipe,
-        Redirect,
-        Background,
-        Semicolon,
-        And,
-        Or
-    };
-    
-    struct Token {
-        TokenType type;
-        std::string value;
-        size_t position;
-        
-        Token(TokenType t, const std::string& v, size_t pos)
-            : type(t), value(v), position(pos) {}
-    };
-    
-    std::vector<Token> tokenize(const std::string& command) const;
-    bool isQuoted(const std::string& str) const noexcept;
-    std::string removeQuotes(const std::string& str) const;
-    std::string expandVariables(const std::string& str, const Environment& env) const;
+    /// @brief Check if this session is the foreground session
+    bool isForeground() const noexcept;
     
-public:
     /**
-     * @brief Parse command string into structured representation
-     * @param command Command string to parse
-     * @param env Environment for variable expansion
-     * @return Parsed command structure
+     * @brief Get output scheduling and echo latency metrics
      * @thread_safe Yes
-     * @performance O(n) where n is command length
+     * @performance O(1)
      */
-    ShellImpl::ParsedCommand parse(const std::string& command, 
-                                  const Environment& env) const;
+    SessionMetrics getSessionMetrics() const noexcept;
     
     /**
-     * @brief Validate command syntax
-     * @param command Command string to validate
-     * @return true if syntax is valid
+     * @brief Release captured output beyond the newest keep_bytes per stream
+     *
+     * Called under memory pressure; what is dropped is scrollback the
+     * user can no longer get back through readOutput().
+     *
+     * @return Bytes of buffer capacity released
      * @thread_safe Yes
-     * @performance O(n) where n is command length
      */
-    bool validate(const std::string& command) const noexcept;
+    size_t trimOutput(size_t keep_bytes) noexcept;
     
     /**
-     * @brief Get completion suggestions for partial command
-     * @param partial_command Incomplete command string
-     * @param env Environment for context
-     * @return Vector of completion suggestions
+     * @brief Completions for the last word of a partial command line
+     *
+     * A first word without a slash completes to builtin names; anything
+     * else completes as a path relative to the session directory.
+     *
+     * @return Sorted candidates, each replacing the whole last word
      * @thread_safe Yes
-     * @performance O(n) where n is number of available commands
      */
-    std::vector<std::string> getCompletions(const std::string& partial_command,
-                                          const Environment& env) const;
+    std::vector<std::string> getCompletions(const std::string& partial_command);
+    
+    /// @brief Session filesystem context used by cd, globbing and completion
+    FsContext& getFileSystem() noexcept;
+    
+private:
+    // Utility methods
+    std::string expandPath(const std::string& path) const;
+    bool validateCommand(const std::string& command) const noexcept;
+    void updateProcessState(int pid, ProcessState state, int exit_code = 0);
+    
+    // Built-in commands
+    ProcessInfo executeBuiltinCd(const ArgumentList& args);
+    ProcessInfo executeBuiltinPwd(const ArgumentList& args,
+                                  const OutputCallback& output);
+    ProcessInfo executeBuiltinEcho(const ArgumentList& args,
+                                   const OutputCallback& output);
+    ProcessInfo executeBuiltinExit(const ArgumentList& args);
+    ProcessInfo executeBuiltinJobs(const ArgumentList& args,
+                                   const OutputCallback& output);
+    ProcessInfo executeBuiltinKill(const ArgumentList& args);
+    ProcessInfo executeBuiltinExport(const ArgumentList& args);
 };
 
 } // namespace core
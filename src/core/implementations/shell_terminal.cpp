@@ -0,0 +1,90 @@
+#include "shell_impl.h"
+
+#ifndef _WIN32
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+void ShellImpl::setTerminalSize(int cols, int rows) noexcept {
+    std::lock_guard lock(terminal_mutex_);
+    terminal_settings_.cols = cols;
+    terminal_settings_.rows = rows;
+    
+    // Update environment variables
+    environment_.set("COLUMNS", std::to_string(cols));
+    environment_.set("LINES", std::to_string(rows));
+}
+
+bool ShellImpl::setEcho(bool enable) {
+    std::lock_guard lock(terminal_mutex_);
+    terminal_settings_.echo_enabled = enable;
+    
+#ifndef _WIN32
+    struct termios term;
+    if (tcgetattr(STDIN_FILENO, &term) == 0) {
+        if (enable) {
+            term.c_lflag |= ECHO;
+        } else {
+            term.c_lflag &= ~ECHO;
+        }
+        return tcsetattr(STDIN_FILENO, TCSANOW, &term) == 0;
+    }
+#endif
+    
+    return false;
+}
+
+bool ShellImpl::setRawMode(bool raw_mode) {
+    std::lock_guard lock(terminal_mutex_);
+    terminal_settings_.raw_mode = raw_mode;
+    
+#ifndef _WIN32
+    struct termios term;
+    if (tcgetattr(STDIN_FILENO, &term) == 0) {
+        if (raw_mode) {
+            term.c_lflag &= ~(ICANON | ECHO);
+            term.c_cc[VMIN] = 1;
+            term.c_cc[VTIME] = 0;
+        } else {
+            term.c_lflag |= (ICANON | ECHO);
+        }
+        return tcsetattr(STDIN_FILENO, TCSANOW, &term) == 0;
+    }
+#endif
+    
+    return false;
+}
+
+void ShellImpl::setForeground(bool foreground) {
+    io_context_.foreground.store(foreground);
+    
+    std::shared_lock lock(processes_mutex_);
+    for (auto& [pid, process] : active_processes_) {
+        process->setPriority(foreground);
+    }
+}
+
+bool ShellImpl::isForeground() const noexcept {
+    return io_context_.foreground.load();
+}
+
+SessionMetrics ShellImpl::getSessionMetrics() const noexcept {
+    SessionMetrics metrics;
+    metrics.foreground = io_context_.foreground.load();
+    metrics.echo_samples = io_context_.echo_latency.count();
+    metrics.echo_p50_us = io_context_.echo_latency.percentile(50.0);
+    metrics.echo_p99_us = io_context_.echo_latency.percentile(99.0);
+    metrics.echo_max_us = io_context_.echo_latency.max();
+    metrics.bytes_read = io_context_.bytes_read.load();
+    metrics.budget_yields = io_context_.budget_yields.load();
+    if (io_context_.callbacks) {
+        metrics.callbacks = io_context_.callbacks->getMetrics();
+    }
+    return metrics;
+}
+
+} // namespace core
+} // namespace cross_terminal
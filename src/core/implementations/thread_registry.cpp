@@ -0,0 +1,537 @@
+#include "thread_registry.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+namespace cross_terminal {
+namespace core {
+
+ThreadRegistry* ThreadRegistry::instance_ = nullptr;
+std::once_flag ThreadRegistry::init_flag_;
+
+namespace {
+
+const struct {
+    ThreadRole role;
+    const char* name;
+} ROLE_NAMES[] = {
+    {ThreadRole::Reactor, "reactor"},
+    {ThreadRole::Worker, "worker"},
+    {ThreadRole::ProcessIo, "process-io"},
+    {ThreadRole::Cleanup, "cleanup"},
+    {ThreadRole::Hardware, "hardware"},
+    {ThreadRole::Render, "render"},
+    {ThreadRole::Other, "other"},
+};
+
+const struct {
+    SchedPolicy policy;
+    const char* name;
+} POLICY_NAMES[] = {
+    {SchedPolicy::Inherit, "inherit"},
+    {SchedPolicy::Other, "other"},
+    {SchedPolicy::Batch, "batch"},
+    {SchedPolicy::Idle, "idle"},
+    {SchedPolicy::Fifo, "fifo"},
+    {SchedPolicy::RoundRobin, "rr"},
+};
+
+bool readNumber(const std::string& path, uint64_t& value) {
+    std::ifstream file(path);
+    return static_cast<bool>(file >> value);
+}
+
+// "0-3,6" -> {0, 1, 2, 3, 6}
+bool parseCpuList(const std::string& text, std::vector<int>& cpus) {
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        const size_t dash = range.find('-');
+        try {
+            size_t used = 0;
+            int first = std::stoi(range.substr(0, dash), &used);
+            if (used != (dash == std::string::npos ? range.size() : dash) || first < 0) {
+                return false;
+            }
+            int last = first;
+            if (dash != std::string::npos) {
+                const std::string tail = range.substr(dash + 1);
+                last = std::stoi(tail, &used);
+                if (used != tail.size() || last < first) {
+                    return false;
+                }
+            }
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return !cpus.empty();
+}
+
+// {0, 1, 2, 3, 6} -> "0-3,6"
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::ostringstream text;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        if (i > 0) {
+            text << ',';
+        }
+        text << cpus[i];
+        if (j > i) {
+            text << '-' << cpus[j];
+        }
+        i = j + 1;
+    }
+    return text.str();
+}
+
+std::vector<CpuInfo> readTopology(const std::string& cpu_root) {
+    std::vector<CpuInfo> cpus;
+    if (DIR* dir = opendir(cpu_root.c_str())) {
+        while (struct dirent* entry = readdir(dir)) {
+            int id = -1;
+            char trailing = 0;
+            if (std::sscanf(entry->d_name, "cpu%d%c", &id, &trailing) != 1 || id < 0) {
+                continue;
+            }
+
+            const std::string path = cpu_root + "/" + entry->d_name;
+            uint64_t online = 1;
+            if (readNumber(path + "/online", online) && online == 0) {
+                continue;
+            }
+
+            CpuInfo cpu;
+            cpu.id = id;
+            if (!readNumber(path + "/cpu_capacity", cpu.capacity)) {
+                readNumber(path + "/cpufreq/cpuinfo_max_freq", cpu.capacity);
+            }
+            cpus.push_back(cpu);
+        }
+        closedir(dir);
+    }
+    std::sort(cpus.begin(), cpus.end(), [](const CpuInfo& a, const CpuInfo& b) {
+        return a.id < b.id;
+    });
+
+    // Little = the lowest-capacity cluster, big = everything faster (on
+    // tri-cluster SoCs that is the mid and prime cores together)
+    if (!cpus.empty()) {
+        auto [lowest, highest] = std::minmax_element(cpus.begin(), cpus.end(),
+            [](const CpuInfo& a, const CpuInfo& b) { return a.capacity < b.capacity; });
+        const uint64_t min_capacity = lowest->capacity;
+        if (highest->capacity > min_capacity) {
+            for (auto& cpu : cpus) {
+                cpu.core_class = cpu.capacity == min_capacity ? CoreClass::Little : CoreClass::Big;
+            }
+        }
+    }
+    return cpus;
+}
+
+void appendError(std::string& errors, const char* what, int error) {
+    if (!errors.empty()) {
+        errors += "; ";
+    }
+    errors += what;
+    errors += ": ";
+    errors += std::strerror(error);
+}
+
+#ifdef __linux__
+// Affinity and scheduling a thread (or, for the process id, the main
+// thread) currently runs with
+void readSettings(pid_t tid, std::vector<int>& cpus, SchedPolicy& policy, int& priority) {
+    cpus.clear();
+    cpu_set_t effective;
+    CPU_ZERO(&effective);
+    if (sched_getaffinity(tid, sizeof(effective), &effective) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &effective)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+
+    policy = SchedPolicy::Other;
+    priority = 0;
+    const int current = sched_getscheduler(tid);
+    struct sched_param current_param {};
+    switch (current) {
+        case SCHED_BATCH: policy = SchedPolicy::Batch; break;
+        case SCHED_IDLE: policy = SchedPolicy::Idle; break;
+        case SCHED_FIFO: policy = SchedPolicy::Fifo; break;
+        case SCHED_RR: policy = SchedPolicy::RoundRobin; break;
+        default: break;
+    }
+    if (current == SCHED_FIFO || current == SCHED_RR) {
+        if (sched_getparam(tid, &current_param) == 0) {
+            priority = current_param.sched_priority;
+        }
+    } else {
+        errno = 0;
+        const int nice_value = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+        priority = errno == 0 ? nice_value : 0;
+    }
+}
+#endif
+
+} // namespace
+
+ThreadRegistry::ThreadRegistry() = default;
+
+ThreadRegistry& ThreadRegistry::instance() {
+    // Leaked: threads may still leave the registry during static destruction
+    std::call_once(init_flag_, []() { instance_ = new ThreadRegistry(); });
+    return *instance_;
+}
+
+ThreadRegistry::Scope::~Scope() {
+    if (tid_ != 0) {
+        ThreadRegistry::instance().leave(tid_);
+    }
+}
+
+ThreadRegistry::Scope ThreadRegistry::enter(ThreadRole role, const std::string& name) {
+    ThreadEntry entry;
+    entry.tid = currentTid();
+    entry.name = name.substr(0, MAX_NAME_LENGTH);
+    entry.role = role;
+
+#ifdef __linux__
+    pthread_setname_np(pthread_self(), entry.name.c_str());
+#elif defined(__APPLE__)
+    pthread_setname_np(entry.name.c_str());
+#endif
+
+    std::lock_guard lock(mutex_);
+    ensureTopology();
+    ensureBaseline();
+    const ThreadPolicy& policy = policies_[static_cast<size_t>(role)];
+    apply(entry, policy, resolveLocked(policy));
+    const int tid = entry.tid;
+    threads_[tid] = std::move(entry);
+    return Scope(tid);
+}
+
+void ThreadRegistry::leave(int tid) noexcept {
+    std::lock_guard lock(mutex_);
+    threads_.erase(tid);
+}
+
+void ThreadRegistry::setPolicy(ThreadRole role, const ThreadPolicy& policy) {
+    std::lock_guard lock(mutex_);
+    policies_[static_cast<size_t>(role)] = policy;
+}
+
+ThreadPolicy ThreadRegistry::getPolicy(ThreadRole role) const {
+    std::lock_guard lock(mutex_);
+    return policies_[static_cast<size_t>(role)];
+}
+
+bool ThreadRegistry::configure(const std::string& spec, std::string* error) {
+    ThreadPolicy staged[ROLE_COUNT];
+    {
+        std::lock_guard lock(mutex_);
+        std::copy(std::begin(policies_), std::end(policies_), std::begin(staged));
+    }
+
+    std::string normalized = spec;
+    std::replace(normalized.begin(), normalized.end(), ';', ' ');
+    std::istringstream stream(normalized);
+    std::string setting;
+    while (stream >> setting) {
+        const size_t dot = setting.find('.');
+        const size_t equals = setting.find('=');
+        bool valid = dot != std::string::npos && equals != std::string::npos && dot < equals;
+
+        ThreadPolicy* policy = nullptr;
+        if (valid) {
+            const std::string role = setting.substr(0, dot);
+            for (const auto& entry : ROLE_NAMES) {
+                if (role == entry.name) {
+                    policy = &staged[static_cast<size_t>(entry.role)];
+                }
+            }
+            valid = policy != nullptr;
+        }
+
+        if (valid) {
+            const std::string key = setting.substr(dot + 1, equals - dot - 1);
+            const std::string value = setting.substr(equals + 1);
+            if (key == "cores") {
+                policy->cpus.clear();
+                if (value == "any") {
+                    policy->core_class = CoreClass::Any;
+                } else if (value == "big") {
+                    policy->core_class = CoreClass::Big;
+                } else if (value == "little") {
+                    policy->core_class = CoreClass::Little;
+                } else {
+                    policy->core_class = CoreClass::Any;
+                    valid = parseCpuList(value, policy->cpus);
+                }
+            } else if (key == "policy") {
+                valid = false;
+                for (const auto& entry : POLICY_NAMES) {
+                    if (value == entry.name) {
+                        policy->policy = entry.policy;
+                        valid = true;
+                    }
+                }
+            } else if (key == "priority") {
+                try {
+                    size_t used = 0;
+                    policy->priority = std::stoi(value, &used);
+                    valid = used == value.size();
+                } catch (const std::exception&) {
+                    valid = false;
+                }
+            } else {
+                valid = false;
+            }
+        }
+
+        if (!valid) {
+            if (error) {
+                *error = setting;
+            }
+            return false;
+        }
+    }
+
+    std::lock_guard lock(mutex_);
+    std::copy(std::begin(staged), std::end(staged), std::begin(policies_));
+    return true;
+}
+
+size_t ThreadRegistry::reapply() {
+    std::lock_guard lock(mutex_);
+    ensureTopology();
+    ensureBaseline();
+    size_t applied = 0;
+    for (auto& [tid, entry] : threads_) {
+        const ThreadPolicy& policy = policies_[static_cast<size_t>(entry.role)];
+        apply(entry, policy, resolveLocked(policy));
+        if (entry.error.empty()) {
+            ++applied;
+        }
+    }
+    return applied;
+}
+
+std::vector<ThreadEntry> ThreadRegistry::snapshot() const {
+    std::vector<ThreadEntry> entries;
+    {
+        std::lock_guard lock(mutex_);
+        entries.reserve(threads_.size());
+        for (const auto& [tid, entry] : threads_) {
+            entries.push_back(entry);
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const ThreadEntry& a, const ThreadEntry& b) {
+        return a.role != b.role ? a.role < b.role : a.name < b.name;
+    });
+    return entries;
+}
+
+std::string ThreadRegistry::describe() const {
+    std::ostringstream text;
+
+    std::vector<int> big;
+    std::vector<int> little;
+    const auto cpus = topology();
+    for (const auto& cpu : cpus) {
+        if (cpu.core_class == CoreClass::Big) {
+            big.push_back(cpu.id);
+        } else if (cpu.core_class == CoreClass::Little) {
+            little.push_back(cpu.id);
+        }
+    }
+    if (big.empty() || little.empty()) {
+        text << "cpus: " << cpus.size() << " uniform\n";
+    } else {
+        text << "cpus: big " << formatCpuList(big) << ", little " << formatCpuList(little) << '\n';
+    }
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-11s %-7s %-16s %-10s %-8s %s\n",
+                  "ROLE", "TID", "NAME", "CPUS", "POLICY", "PRIO");
+    text << line;
+    for (const auto& entry : snapshot()) {
+        const std::string cpu_list = entry.cpus.empty() ? "-" : formatCpuList(entry.cpus);
+        std::snprintf(line, sizeof(line), "%-11s %-7d %-16s %-10s %-8s %d",
+                      roleName(entry.role), entry.tid, entry.name.c_str(), cpu_list.c_str(),
+                      policyName(entry.policy), entry.priority);
+        text << line;
+        if (!entry.error.empty()) {
+            text << "  (" << entry.error << ')';
+        }
+        text << '\n';
+    }
+    return text.str();
+}
+
+std::vector<CpuInfo> ThreadRegistry::topology() const {
+    std::lock_guard lock(mutex_);
+    ensureTopology();
+    return topology_;
+}
+
+void ThreadRegistry::loadTopology(const std::string& cpu_root) {
+    auto cpus = readTopology(cpu_root);
+    std::lock_guard lock(mutex_);
+    topology_ = std::move(cpus);
+    topology_loaded_ = true;
+}
+
+std::vector<int> ThreadRegistry::resolveCpus(const ThreadPolicy& policy) const {
+    std::lock_guard lock(mutex_);
+    ensureTopology();
+    return resolveLocked(policy);
+}
+
+std::vector<int> ThreadRegistry::resolveLocked(const ThreadPolicy& policy) const {
+    if (!policy.cpus.empty() || policy.core_class == CoreClass::Any) {
+        return policy.cpus;
+    }
+    // On a uniform CPU no core carries a class: the request is a no-op
+    std::vector<int> cpus;
+    for (const auto& cpu : topology_) {
+        if (cpu.core_class == policy.core_class) {
+            cpus.push_back(cpu.id);
+        }
+    }
+    return cpus;
+}
+
+void ThreadRegistry::ensureBaseline() {
+    if (baseline_loaded_) {
+        return;
+    }
+#ifdef __linux__
+    readSettings(getpid(), baseline_cpus_, baseline_policy_, baseline_priority_);
+#endif
+    baseline_loaded_ = true;
+}
+
+void ThreadRegistry::ensureTopology() const {
+    if (!topology_loaded_) {
+        topology_ = readTopology(DEFAULT_CPU_ROOT);
+        topology_loaded_ = true;
+    }
+}
+
+void ThreadRegistry::apply(ThreadEntry& entry, const ThreadPolicy& policy,
+                           const std::vector<int>& cpus) {
+    entry.error.clear();
+#ifdef __linux__
+    const pid_t tid = static_cast<pid_t>(entry.tid);
+    readSettings(tid, entry.cpus, entry.policy, entry.priority);
+
+    // Unrestricted and inherit mean the process's own settings, which also
+    // undoes an earlier pin or policy; unchanged settings are left alone
+    const std::vector<int>& target_cpus = cpus.empty() ? baseline_cpus_ : cpus;
+    if (!target_cpus.empty() && target_cpus != entry.cpus) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : target_cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        if (sched_setaffinity(tid, sizeof(set), &set) != 0) {
+            appendError(entry.error, "affinity", errno);
+        }
+    }
+
+    const bool inherit = policy.policy == SchedPolicy::Inherit;
+    const SchedPolicy target_policy = inherit ? baseline_policy_ : policy.policy;
+    const int target_priority = inherit ? baseline_priority_ : policy.priority;
+    if (target_policy != entry.policy || target_priority != entry.priority) {
+        int native = SCHED_OTHER;
+        switch (target_policy) {
+            case SchedPolicy::Batch: native = SCHED_BATCH; break;
+            case SchedPolicy::Idle: native = SCHED_IDLE; break;
+            case SchedPolicy::Fifo: native = SCHED_FIFO; break;
+            case SchedPolicy::RoundRobin: native = SCHED_RR; break;
+            default: break;
+        }
+        const bool realtime = native == SCHED_FIFO || native == SCHED_RR;
+        struct sched_param param {};
+        param.sched_priority = realtime ? target_priority : 0;
+        if (sched_setscheduler(tid, native, &param) != 0) {
+            appendError(entry.error, "policy", errno);
+        } else if ((native == SCHED_OTHER || native == SCHED_BATCH) &&
+                   setpriority(PRIO_PROCESS, static_cast<id_t>(tid), target_priority) != 0) {
+            appendError(entry.error, "nice", errno);
+        }
+    }
+
+    // Record what the kernel actually granted
+    readSettings(tid, entry.cpus, entry.policy, entry.priority);
+#else
+    // No per-thread affinity or policy control: only names are applied
+    (void)cpus;
+    entry.policy = policy.policy;
+    entry.priority = policy.priority;
+#endif
+}
+
+const char* ThreadRegistry::roleName(ThreadRole role) noexcept {
+    for (const auto& entry : ROLE_NAMES) {
+        if (entry.role == role) {
+            return entry.name;
+        }
+    }
+    return "other";
+}
+
+const char* ThreadRegistry::policyName(SchedPolicy policy) noexcept {
+    for (const auto& entry : POLICY_NAMES) {
+        if (entry.policy == policy) {
+            return entry.name;
+        }
+    }
+    return "inherit";
+}
+
+int ThreadRegistry::currentTid() noexcept {
+#ifdef __linux__
+    return static_cast<int>(syscall(SYS_gettid));
+#elif defined(__APPLE__)
+    uint64_t tid = 0;
+    pthread_threadid_np(nullptr, &tid);
+    return static_cast<int>(tid);
+#else
+    static std::atomic<int> next_id{1};
+    thread_local const int id = next_id.fetch_add(1);
+    return id;
+#endif
+}
+
+} // namespace core
+} // namespace cross_terminal
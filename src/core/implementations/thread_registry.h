@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file thread_registry.h
+ * @brief Names, pins and schedules the process's native threads
+ *
+ * Every long-lived thread (reactor loops, workers, process I/O threads,
+ * cleanup and hardware monitoring) enters the registry when it starts.
+ * Entering names the thread, then applies the CPU placement and
+ * scheduling policy configured for its role. On big.LITTLE devices the
+ * placement can name a core class ("big", "little") instead of a CPU
+ * list; classes are derived from cpu_capacity or cpuinfo_max_freq in
+ * sysfs. The `threads` shell builtin prints the resulting layout.
+ *
+ * Applying a policy is best effort: a refused request (e.g. real-time
+ * scheduling without CAP_SYS_NICE) is recorded on the thread's entry
+ * and the thread keeps running with its previous settings.
+ *
+ * @thread_safety All methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+/**
+ * @brief Purpose of a native thread
+ */
+enum class ThreadRole : uint8_t {
+    Reactor = 0,     ///< IoReactor event loop
+    Worker = 1,      ///< WorkerPool thread (callbacks, sweeps)
+    ProcessIo = 2,   ///< Dedicated I/O thread of a standalone process
+    Cleanup = 3,     ///< Standalone shell cleanup thread
+    Hardware = 4,    ///< Hardware monitoring thread
+    Render = 5,      ///< UI rendering thread
+    Other = 6
+};
+
+/**
+ * @brief CPU class a role may be restricted to
+ */
+enum class CoreClass : uint8_t {
+    Any = 0,      ///< The process's own affinity (or the explicit CPU list)
+    Big = 1,      ///< Highest-capacity cores
+    Little = 2    ///< Lowest-capacity cores
+};
+
+/**
+ * @brief Kernel scheduling policy
+ */
+enum class SchedPolicy : uint8_t {
+    Inherit = 0,   ///< The process's own policy and priority
+    Other = 1,     ///< SCHED_OTHER, priority is the nice value
+    Batch = 2,     ///< SCHED_BATCH, priority is the nice value
+    Idle = 3,      ///< SCHED_IDLE
+    Fifo = 4,      ///< SCHED_FIFO, priority is the real-time priority
+    RoundRobin = 5 ///< SCHED_RR, priority is the real-time priority
+};
+
+/**
+ * @brief Placement and scheduling for one role
+ */
+struct ThreadPolicy {
+    CoreClass core_class = CoreClass::Any;
+    std::vector<int> cpus;                     ///< Explicit CPUs, override core_class
+    SchedPolicy policy = SchedPolicy::Inherit;
+    int priority = 0;
+};
+
+/**
+ * @brief One CPU as seen by the registry
+ */
+struct CpuInfo {
+    int id = 0;
+    uint64_t capacity = 0;   ///< cpu_capacity, or max frequency in kHz
+    CoreClass core_class = CoreClass::Any;
+};
+
+/**
+ * @brief A live registered thread
+ */
+struct ThreadEntry {
+    int tid = 0;
+    std::string name;
+    ThreadRole role = ThreadRole::Other;
+    std::vector<int> cpus;   ///< Effective affinity after entering
+    SchedPolicy policy = SchedPolicy::Inherit;
+    int priority = 0;
+    std::string error;       ///< Settings the kernel refused, empty if none
+};
+
+/**
+ * @brief Process-wide thread registry
+ */
+class ThreadRegistry {
+public:
+    /// Linux limits thread names to 15 characters
+    static constexpr size_t MAX_NAME_LENGTH = 15;
+    static constexpr const char* DEFAULT_CPU_ROOT = "/sys/devices/system/cpu";
+
+    /**
+     * @brief Registration of the calling thread, undone on destruction
+     */
+    class Scope {
+    public:
+        Scope(Scope&& other) noexcept : tid_(other.tid_) { other.tid_ = 0; }
+        Scope& operator=(Scope&&) = delete;
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+    private:
+        friend class ThreadRegistry;
+        explicit Scope(int tid) noexcept : tid_(tid) {}
+        int tid_;
+    };
+
+    static ThreadRegistry& instance();
+
+    /**
+     * @brief Register, name and configure the calling thread
+     * @param role Role whose policy is applied
+     * @param name Thread name, truncated to MAX_NAME_LENGTH
+     * @return Scope to keep alive for the lifetime of the thread
+     * @thread_safe Yes
+     */
+    Scope enter(ThreadRole role, const std::string& name);
+
+    /**
+     * @brief Set the policy for a role
+     *
+     * Applies to threads entering afterwards; running threads of the role
+     * are reconfigured when reapply() is called.
+     *
+     * @thread_safe Yes
+     */
+    void setPolicy(ThreadRole role, const ThreadPolicy& policy);
+
+    /// @brief Policy configured for a role
+    ThreadPolicy getPolicy(ThreadRole role) const;
+
+    /**
+     * @brief Parse and install a layout specification
+     *
+     * Whitespace or ';' separated `role.key=value` settings, e.g.
+     * `reactor.cores=big reactor.policy=fifo reactor.priority=10
+     *  worker.cores=0-3,6 worker.policy=batch`.
+     * Keys: cores (any, big, little or a CPU list), policy (inherit, other,
+     * batch, idle, fifo, rr) and priority. Nothing is installed if any
+     * setting is invalid.
+     *
+     * @param spec Layout specification
+     * @param error Receives the offending setting on failure (optional)
+     * @return true if the whole specification was valid
+     * @thread_safe Yes
+     */
+    bool configure(const std::string& spec, std::string* error = nullptr);
+
+    /**
+     * @brief Re-apply role policies to the registered threads
+     * @return Number of threads reconfigured without error
+     * @thread_safe Yes
+     */
+    size_t reapply();
+
+    /// @brief Registered threads ordered by role, then name
+    std::vector<ThreadEntry> snapshot() const;
+
+    /// @brief Human-readable layout: CPU classes, then one line per thread
+    std::string describe() const;
+
+    /**
+     * @brief CPU classes, read from sysfs on first use
+     * @thread_safe Yes
+     */
+    std::vector<CpuInfo> topology() const;
+
+    /**
+     * @brief Re-read the CPU topology from a sysfs root (testing, hotplug)
+     * @param cpu_root Directory holding cpuN entries
+     */
+    void loadTopology(const std::string& cpu_root = DEFAULT_CPU_ROOT);
+
+    /// @brief Resolve a policy to the CPUs it allows (empty: unrestricted)
+    std::vector<int> resolveCpus(const ThreadPolicy& policy) const;
+
+    static const char* roleName(ThreadRole role) noexcept;
+    static const char* policyName(SchedPolicy policy) noexcept;
+
+    /// @brief Kernel id of the calling thread
+    static int currentTid() noexcept;
+
+private:
+    ThreadRegistry();
+
+    static constexpr size_t ROLE_COUNT = static_cast<size_t>(ThreadRole::Other) + 1;
+
+    mutable std::mutex mutex_;
+    ThreadPolicy policies_[ROLE_COUNT];
+    std::unordered_map<int, ThreadEntry> threads_;
+    mutable std::vector<CpuInfo> topology_;   // Loaded lazily under mutex_
+    mutable bool topology_loaded_ = false;
+    // The process's own settings, read when the first thread enters; what
+    // cores=any and policy=inherit restore
+    std::vector<int> baseline_cpus_;
+    SchedPolicy baseline_policy_ = SchedPolicy::Other;
+    int baseline_priority_ = 0;
+    bool baseline_loaded_ = false;
+
+    static ThreadRegistry* instance_;
+    static std::once_flag init_flag_;
+
+    void ensureTopology() const;
+    void ensureBaseline();
+    std::vector<int> resolveLocked(const ThreadPolicy& policy) const;
+    void apply(ThreadEntry& entry, const ThreadPolicy& policy, const std::vector<int>& cpus);
+    void leave(int tid) noexcept;
+};
+
+} // namespace core
+} // namespace cross_terminal
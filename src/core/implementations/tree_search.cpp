@@ -0,0 +1,431 @@
+#include "tree_search.h"
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <utility>
+
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <unistd.h>
+
+namespace cross_terminal {
+namespace core {
+
+namespace {
+
+class Fd {
+public:
+    explicit Fd(int fd) : fd_(fd) {}
+    ~Fd() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+    Fd(const Fd&) = delete;
+    Fd& operator=(const Fd&) = delete;
+    int get() const noexcept { return fd_; }
+private:
+    int fd_;
+};
+using FdPtr = std::shared_ptr<Fd>;
+
+constexpr int DIRECTORY_FLAGS = O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+
+std::string join(const std::string& directory, const std::string& name) {
+    return directory.back() == '/' ? directory + name : directory + "/" + name;
+}
+
+// Last component of a path as written: "src/" is "src", "/" stays "/"
+std::string lastComponent(const std::string& path) {
+    size_t end = path.find_last_not_of('/');
+    if (end == std::string::npos) {
+        return path.empty() ? path : "/";
+    }
+    const size_t slash = path.rfind('/', end);
+    const size_t start = slash == std::string::npos ? 0 : slash + 1;
+    return path.substr(start, end - start + 1);
+}
+
+std::string toLower(std::string text) {
+    for (auto& c : text) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return text;
+}
+
+bool compare(FindOptions::Compare comparison, int64_t actual, int64_t wanted) noexcept {
+    switch (comparison) {
+        case FindOptions::Compare::Less:    return actual < wanted;
+        case FindOptions::Compare::Equal:   return actual == wanted;
+        case FindOptions::Compare::Greater: return actual > wanted;
+        default:                            return true;
+    }
+}
+
+int64_t nowNs() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// What find and du share: the tasks, per-worker result batches and errors
+template <typename T>
+struct TreeSearch::Walk {
+    using Callback = std::function<void(const std::vector<T>&)>;
+
+    const size_t batch_size;
+    const Callback& callback;
+    std::vector<std::vector<T>> batches;   // One per worker, and the caller's last
+    std::mutex callback_mutex;
+    std::atomic<uint64_t> entries{0};
+    std::atomic<uint64_t> directories{0};
+    std::atomic<uint64_t> stats{0};
+    std::mutex errors_mutex;
+    std::vector<std::string> errors;
+    TaskGroup tasks;   // Last: its destructor waits for tasks using the rest
+
+    Walk(WorkStealingPool& pool, size_t batch, const Callback& cb)
+        : batch_size(batch > 0 ? batch : 1), callback(cb),
+          batches(pool.threadCount() + 1), tasks(pool) {}
+
+    void emit(T result) {
+        const int worker = tasks.pool().currentWorker();
+        auto& batch = batches[worker < 0 ? batches.size() - 1 : static_cast<size_t>(worker)];
+        batch.push_back(std::move(result));
+        if (batch.size() >= batch_size) {
+            deliver(batch);
+        }
+    }
+
+    void deliver(std::vector<T>& batch) {
+        {
+            std::lock_guard lock(callback_mutex);
+            if (callback) {
+                callback(batch);
+            }
+        }
+        batch.clear();
+    }
+
+    void fail(const char* action, const std::string& path, int error) {
+        std::lock_guard lock(errors_mutex);
+        errors.push_back(std::string("cannot ") + action + " '" + path + "': " + strerror(error));
+    }
+
+    // Once the tasks are done: hand over the partial batches
+    TreeSearchResult collect() {
+        for (auto& batch : batches) {
+            if (!batch.empty()) {
+                deliver(batch);
+            }
+        }
+        TreeSearchResult result;
+        result.metrics.entries = entries.load();
+        result.metrics.directories = directories.load();
+        result.metrics.stats = stats.load();
+        result.errors = std::move(errors);
+        result.cancelled = tasks.isCancelled();
+        return result;
+    }
+};
+
+struct TreeSearch::FindWalk : Walk<std::string> {
+    const FindOptions& options;
+    const std::string pattern;   // Lowered for -iname
+    const int64_t now_ns;
+
+    FindWalk(WorkStealingPool& pool, size_t batch, const PathCallback& cb, const FindOptions& opts)
+        : Walk(pool, batch, cb), options(opts),
+          pattern(opts.ignore_case ? toLower(opts.name) : opts.name), now_ns(nowNs()) {}
+
+    // info is only read when options.needsStat()
+    bool matches(const std::string& name, FsEntryType type, const FsStat& info) const {
+        if (options.type != FsEntryType::Unknown && type != options.type) {
+            return false;
+        }
+        if (!pattern.empty()) {
+            const std::string subject = options.ignore_case ? toLower(name) : name;
+            // No FNM_PERIOD: find's * matches a leading dot
+            if (fnmatch(pattern.c_str(), subject.c_str(), 0) != 0) {
+                return false;
+            }
+        }
+        if (options.size_compare != FindOptions::Compare::None) {
+            const uint64_t units = (info.size + options.size_unit - 1) / options.size_unit;
+            if (!compare(options.size_compare, static_cast<int64_t>(units), static_cast<int64_t>(options.size))) {
+                return false;
+            }
+        }
+        if (options.age_compare != FindOptions::Compare::None) {
+            // Whole units ago, rounded down, as find counts them
+            const int64_t unit_ns = static_cast<int64_t>(options.age_unit_s) * 1000000000;
+            const int64_t elapsed = now_ns - info.mtime_ns;
+            const int64_t age = elapsed >= 0 ? elapsed / unit_ns : -1;
+            if (!compare(options.age_compare, age, static_cast<int64_t>(options.age))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void visitDirectory(const FdPtr& parent, const std::string& name, const std::string& path, int depth) {
+        const int fd = openat(parent->get(), name.c_str(), DIRECTORY_FLAGS);
+        if (fd < 0) {
+            fail("open directory", path, errno);
+            return;
+        }
+        readDirectory(std::make_shared<Fd>(fd), path, depth);
+    }
+
+    void readDirectory(const FdPtr& dir, const std::string& path, int depth) {
+        directories.fetch_add(1, std::memory_order_relaxed);
+        std::vector<FsEntry> listing;
+        int error = listDirectoryAt(dir->get(), ".", listing);
+        if (error != 0) {
+            fail("read directory", path, error);
+        }
+        entries.fetch_add(listing.size(), std::memory_order_relaxed);
+
+        const int child_depth = depth + 1;
+        const bool report = child_depth >= options.min_depth;
+        const bool descend = options.max_depth < 0 || child_depth < options.max_depth;
+        uint64_t stat_calls = 0;
+        for (const auto& entry : listing) {
+            FsEntryType type = entry.type;
+            FsStat info;
+            const bool need_stat = type == FsEntryType::Unknown ? report || descend
+                                                                : report && options.needsStat();
+            if (need_stat) {
+                ++stat_calls;
+                error = statAt(dir->get(), entry.name.c_str(), info, false);
+                if (error != 0) {
+                    fail("stat", join(path, entry.name), error);
+                    continue;
+                }
+                type = info.type;
+            }
+            const bool matched = report && matches(entry.name, type, info);
+            const bool walk = descend && type == FsEntryType::Directory;
+            if (!matched && !walk) {
+                continue;
+            }
+            std::string child = join(path, entry.name);
+            if (walk) {
+                tasks.spawn([this, dir, name = entry.name, child, child_depth]() {
+                    visitDirectory(dir, name, child, child_depth);
+                });
+            }
+            if (matched) {
+                emit(std::move(child));
+            }
+        }
+        stats.fetch_add(stat_calls, std::memory_order_relaxed);
+    }
+};
+
+struct TreeSearch::UsageWalk : Walk<DiskUsageEntry> {
+    // A directory's running total; whoever finishes its last entry
+    // reports it and adds it to the parent's
+    struct Node {
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<size_t> remaining{1};
+        std::shared_ptr<Node> parent;
+        std::string path;
+        int depth = 0;
+    };
+    using NodePtr = std::shared_ptr<Node>;
+
+    const DiskUsageOptions& options;
+    std::mutex links_mutex;
+    std::set<std::pair<uint64_t, uint64_t>> links;   // Device, inode of files with several links
+
+    UsageWalk(WorkStealingPool& pool, size_t batch, const UsageCallback& cb, const DiskUsageOptions& opts)
+        : Walk(pool, batch, cb), options(opts) {}
+
+    uint64_t usage(const FsStat& info) const noexcept {
+        return options.apparent_size ? info.size : info.blocks * 512;
+    }
+
+    bool reported(int depth) const noexcept {
+        return options.max_depth < 0 || depth <= options.max_depth;
+    }
+
+    // False for the second and later links to the same file
+    bool firstLink(const FsStat& info) {
+        if (info.type == FsEntryType::Directory || info.nlink < 2) {
+            return true;
+        }
+        std::lock_guard lock(links_mutex);
+        return links.emplace(info.device, info.inode).second;
+    }
+
+    void release(NodePtr node) {
+        while (node && node->remaining.fetch_sub(1) == 1) {
+            const uint64_t total = node->bytes.load();
+            if (reported(node->depth)) {
+                emit({node->path, total});
+            }
+            if (node->parent) {
+                node->parent->bytes.fetch_add(total);
+            }
+            node = node->parent;
+        }
+    }
+
+    void visitDirectory(const FdPtr& parent, const std::string& name, const NodePtr& node) {
+        const int fd = openat(parent->get(), name.c_str(), DIRECTORY_FLAGS);
+        if (fd < 0) {
+            fail("read directory", node->path, errno);
+            release(node);
+            return;
+        }
+        readDirectory(std::make_shared<Fd>(fd), node);
+    }
+
+    void readDirectory(const FdPtr& dir, const NodePtr& node) {
+        directories.fetch_add(1, std::memory_order_relaxed);
+        std::vector<FsEntry> listing;
+        int error = listDirectoryAt(dir->get(), ".", listing);
+        if (error != 0) {
+            fail("read directory", node->path, error);
+        }
+        entries.fetch_add(listing.size(), std::memory_order_relaxed);
+        stats.fetch_add(listing.size(), std::memory_order_relaxed);
+
+        const int child_depth = node->depth + 1;
+        const bool report_files = options.all && reported(child_depth);
+        uint64_t files = 0;
+        for (const auto& entry : listing) {
+            FsStat info;
+            error = statAt(dir->get(), entry.name.c_str(), info, false);
+            if (error != 0) {
+                fail("stat", join(node->path, entry.name), error);
+                continue;
+            }
+            if (info.type == FsEntryType::Directory) {
+                auto child = std::make_shared<Node>();
+                child->bytes.store(usage(info));
+                child->parent = node;
+                child->path = join(node->path, entry.name);
+                child->depth = child_depth;
+                node->remaining.fetch_add(1);
+                tasks.spawn([this, dir, name = entry.name, child]() {
+                    visitDirectory(dir, name, child);
+                });
+            } else if (firstLink(info)) {
+                const uint64_t bytes = usage(info);
+                files += bytes;
+                if (report_files) {
+                    emit({join(node->path, entry.name), bytes});
+                }
+            }
+        }
+        node->bytes.fetch_add(files);
+        release(node);
+    }
+};
+
+TreeSearch::TreeSearch(FsContext& fs, size_t threads, size_t batch_size)
+    : TreeSearch(fs, std::make_shared<WorkStealingPool>(threads), batch_size) {
+}
+
+TreeSearch::TreeSearch(FsContext& fs, std::shared_ptr<WorkStealingPool> pool, size_t batch_size)
+    : fs_(fs), pool_(std::move(pool)), batch_size_(batch_size) {
+}
+
+TreeSearchResult TreeSearch::find(const std::vector<std::string>& roots, const FindOptions& options,
+                                  const PathCallback& callback) {
+    FindWalk walk(*pool_, batch_size_, callback, options);
+    track(walk.tasks);
+    for (const auto& root : roots) {
+        // Like find -P, a symlink given as the root is not followed,
+        // unless written with a trailing slash
+        const bool follow = !root.empty() && root.back() == '/';
+        FsStat info;
+        int error = fs_.stat(root, info, follow);
+        if (error != 0) {
+            walk.fail("stat", root, error);
+            continue;
+        }
+        if (options.min_depth <= 0 && walk.matches(lastComponent(root), info.type, info)) {
+            walk.emit(root);
+        }
+        if (info.type != FsEntryType::Directory || options.max_depth == 0) {
+            continue;
+        }
+        const int fd = fs_.openFile(root, O_RDONLY | O_DIRECTORY | (follow ? 0 : O_NOFOLLOW));
+        if (fd < 0) {
+            walk.fail("open directory", root, errno);
+            continue;
+        }
+        walk.tasks.spawn([&walk, dir = std::make_shared<Fd>(fd), root]() {
+            walk.readDirectory(dir, root, 0);
+        });
+    }
+    run(walk.tasks);
+    return walk.collect();
+}
+
+TreeSearchResult TreeSearch::diskUsage(const std::vector<std::string>& roots, const DiskUsageOptions& options,
+                                       const UsageCallback& callback) {
+    UsageWalk walk(*pool_, batch_size_, callback, options);
+    track(walk.tasks);
+    for (const auto& root : roots) {
+        const bool follow = !root.empty() && root.back() == '/';
+        FsStat info;
+        int error = fs_.stat(root, info, follow);
+        if (error != 0) {
+            walk.fail("access", root, error);
+            continue;
+        }
+        if (info.type != FsEntryType::Directory) {
+            if (walk.firstLink(info)) {
+                walk.emit({root, walk.usage(info)});
+            }
+            continue;
+        }
+        const int fd = fs_.openFile(root, O_RDONLY | O_DIRECTORY | (follow ? 0 : O_NOFOLLOW));
+        if (fd < 0) {
+            walk.fail("read directory", root, errno);
+            continue;
+        }
+        auto node = std::make_shared<UsageWalk::Node>();
+        node->bytes.store(walk.usage(info));
+        node->path = root;
+        walk.tasks.spawn([&walk, dir = std::make_shared<Fd>(fd), node]() {
+            walk.readDirectory(dir, node);
+        });
+    }
+    run(walk.tasks);
+    return walk.collect();
+}
+
+void TreeSearch::cancel() noexcept {
+    std::lock_guard lock(mutex_);
+    cancelled_ = true;
+    if (current_) {
+        current_->cancel();
+    }
+}
+
+void TreeSearch::track(TaskGroup& tasks) {
+    std::lock_guard lock(mutex_);
+    current_ = &tasks;
+    if (cancelled_) {
+        tasks.cancel();
+    }
+}
+
+void TreeSearch::run(TaskGroup& tasks) {
+    tasks.wait();
+    std::lock_guard lock(mutex_);
+    current_ = nullptr;
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "core/implementations/fs_context.h"
+#include "core/implementations/work_stealing_pool.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file tree_search.h
+ * @brief Native parallel find and du
+ *
+ * Both walk the tree on a WorkStealingPool, normally the one the session
+ * runtime shares between file builtins, one task per directory, with
+ * each directory read through getdents64 relative to its parent's fd.
+ *
+ * find takes entry types from d_type and calls statx() only when a
+ * predicate needs more (-size, -mtime, -mmin) or the filesystem leaves
+ * d_type unset, so a -name/-type search over a tree costs one getdents64
+ * per directory and nothing per file. du needs every entry's block count
+ * and stats everything; directory totals are summed bottom-up as the
+ * last entry of each directory finishes.
+ *
+ * Results are collected per worker and handed over in batches, in no
+ * particular order: the walk never waits for the consumer of one path.
+ *
+ * @performance Scales with workers until the device or the dentry cache
+ *              saturates; no per-entry locking
+ * @thread_safety One walk at a time per instance; cancel() may be called
+ *                from any thread
+ */
+
+namespace cross_terminal {
+namespace core {
+
+/**
+ * @brief find predicates, all of which must match (find's implicit -a)
+ */
+struct FindOptions {
+    /// Numeric comparison as find writes it: +n, -n or n
+    enum class Compare : uint8_t { None, Less, Equal, Greater };
+
+    std::string name;                   ///< -name/-iname glob on the last path component
+    bool ignore_case = false;           ///< -iname
+    FsEntryType type = FsEntryType::Unknown;   ///< -type; Unknown for any
+
+    Compare size_compare = Compare::None;      ///< -size
+    uint64_t size = 0;                  ///< In size_unit units, rounded up
+    uint64_t size_unit = 512;           ///< 1 (c), 512 (b), 1024 (k), ...
+
+    Compare age_compare = Compare::None;       ///< -mtime/-mmin
+    uint64_t age = 0;                   ///< In age_unit_s units, rounded down
+    uint64_t age_unit_s = 86400;        ///< 86400 (-mtime) or 60 (-mmin)
+
+    int min_depth = 0;                  ///< -mindepth
+    int max_depth = -1;                 ///< -maxdepth; -1 for no limit
+
+    /// True if a predicate needs more than the name and d_type
+    bool needsStat() const noexcept {
+        return size_compare != Compare::None || age_compare != Compare::None;
+    }
+};
+
+struct DiskUsageOptions {
+    bool apparent_size = false;   ///< -b: file sizes rather than allocated blocks
+    bool all = false;             ///< -a: report files as well as directories
+    int max_depth = -1;           ///< -d/-s: deepest directory reported; -1 for all
+};
+
+struct DiskUsageEntry {
+    std::string path;
+    uint64_t bytes = 0;   ///< Including everything below a directory
+};
+
+struct TreeSearchMetrics {
+    uint64_t entries = 0;       ///< Directory entries examined
+    uint64_t directories = 0;   ///< Directories read
+    uint64_t stats = 0;         ///< statx()/fstatat() calls made for entries
+};
+
+struct TreeSearchResult {
+    TreeSearchMetrics metrics;
+    std::vector<std::string> errors;   ///< "cannot ...: reason" messages, in no particular order
+    bool cancelled = false;
+
+    bool succeeded() const noexcept { return errors.empty() && !cancelled; }
+};
+
+class TreeSearch {
+public:
+    /// Default number of results per batch
+    static constexpr size_t DEFAULT_BATCH_SIZE = 256;
+
+    /// Called with each full batch from the worker that filled it, and
+    /// with the remainders from the calling thread; never concurrently
+    using PathCallback = std::function<void(const std::vector<std::string>&)>;
+    using UsageCallback = std::function<void(const std::vector<DiskUsageEntry>&)>;
+
+    /**
+     * @param fs Resolves the relative starting points
+     * @param threads Workers of a private pool; 0 for WorkStealingPool's default
+     */
+    explicit TreeSearch(FsContext& fs, size_t threads = 0, size_t batch_size = DEFAULT_BATCH_SIZE);
+
+    /**
+     * @param pool Workers shared with other operations
+     */
+    TreeSearch(FsContext& fs, std::shared_ptr<WorkStealingPool> pool, size_t batch_size = DEFAULT_BATCH_SIZE);
+
+    /**
+     * @brief find roots... predicates
+     *
+     * Matching paths are reported as the root was written plus the path
+     * below it, like find's. Symbolic links are not followed (find -P).
+     */
+    TreeSearchResult find(const std::vector<std::string>& roots, const FindOptions& options,
+                          const PathCallback& callback);
+
+    /**
+     * @brief du roots...
+     *
+     * Every directory down to max_depth is reported with its total, and
+     * files too with all. A file with several hard links is counted once.
+     */
+    TreeSearchResult diskUsage(const std::vector<std::string>& roots, const DiskUsageOptions& options,
+                               const UsageCallback& callback);
+
+    /**
+     * @brief Stop the running walk after the directories in progress
+     *
+     * Walks started afterwards are cancelled as they begin, so a cancel()
+     * that races with the start of one is not lost.
+     */
+    void cancel() noexcept;
+
+private:
+    template <typename T> struct Walk;
+    struct FindWalk;
+    struct UsageWalk;
+
+    FsContext& fs_;
+    std::shared_ptr<WorkStealingPool> pool_;
+    const size_t batch_size_;
+    std::mutex mutex_;
+    TaskGroup* current_ = nullptr;   // Guarded by mutex_, for cancel()
+    bool cancelled_ = false;         // Guarded by mutex_
+
+    // Make tasks the ones cancel() stops, until run() returns
+    void track(TaskGroup& tasks);
+    // Run the spawned tasks to completion
+    void run(TaskGroup& tasks);
+};
+
+} // namespace core
+} // namespace cross_terminal
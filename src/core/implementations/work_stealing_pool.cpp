@@ -0,0 +1,205 @@
+#include "work_stealing_pool.h"
+#include "thread_registry.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace cross_terminal {
+namespace core {
+
+namespace {
+
+// The pool and deque of the calling worker thread, if any
+thread_local WorkStealingPool* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                        MAX_DEFAULT_THREADS);
+    }
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    threads_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads_.emplace_back([this, i]() {
+            auto registration = ThreadRegistry::instance().enter(
+                ThreadRole::Worker, "ct-steal-" + std::to_string(i));
+            workerThreadFunction(i);
+        });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    cancel();
+    wait();
+    {
+        std::lock_guard lock(idle_mutex_);
+        stopping_.store(true);
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::spawn(Task task) {
+    if (!task) {
+        return;
+    }
+    pending_.fetch_add(1);
+    const size_t index = current_pool == this ? current_worker
+                                              : next_worker_.fetch_add(1) % workers_.size();
+    {
+        std::lock_guard lock(workers_[index]->mutex);
+        workers_[index]->tasks.push_back(std::move(task));
+    }
+    queued_.fetch_add(1);
+
+    // Pairs with the sleeping_ increment in workerThreadFunction(): either
+    // the worker sees queued_ or this sees it asleep
+    if (sleeping_.load() > 0) {
+        std::lock_guard lock(idle_mutex_);
+        wake_.notify_one();
+    }
+}
+
+int WorkStealingPool::currentWorker() const noexcept {
+    return current_pool == this ? static_cast<int>(current_worker) : -1;
+}
+
+bool WorkStealingPool::waitFor(uint32_t timeout_ms) {
+    std::unique_lock lock(idle_mutex_);
+    return done_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                          [this]() { return pending_.load() == 0; });
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock lock(idle_mutex_);
+    done_.wait(lock, [this]() { return pending_.load() == 0; });
+}
+
+void WorkStealingPool::cancel() noexcept {
+    cancelled_.store(true);
+}
+
+WorkStealingMetrics WorkStealingPool::getMetrics() const noexcept {
+    WorkStealingMetrics metrics;
+    metrics.executed = executed_.load(std::memory_order_relaxed);
+    metrics.stolen = stolen_.load(std::memory_order_relaxed);
+    return metrics;
+}
+
+bool WorkStealingPool::take(size_t index, Task& task) {
+    {
+        // Own deque, newest first: depth-first, cache-warm
+        Worker& own = *workers_[index];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < workers_.size(); ++i) {
+        // Others' deques, oldest first: the biggest unexplored pieces
+        Worker& victim = *workers_[(index + i) % workers_.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::finish() noexcept {
+    if (pending_.fetch_sub(1) == 1) {
+        std::lock_guard lock(idle_mutex_);
+        done_.notify_all();
+    }
+}
+
+void WorkStealingPool::workerThreadFunction(size_t index) {
+    current_pool = this;
+    current_worker = index;
+
+    while (true) {
+        Task task;
+        if (take(index, task)) {
+            queued_.fetch_sub(1);
+            if (!cancelled_.load(std::memory_order_relaxed)) {
+                task();
+                executed_.fetch_add(1, std::memory_order_relaxed);
+            }
+            task = nullptr;   // Release captures before the task counts as done
+            finish();
+            continue;
+        }
+
+        std::unique_lock lock(idle_mutex_);
+        sleeping_.fetch_add(1);
+        wake_.wait(lock, [this]() { return stopping_.load() || queued_.load() > 0; });
+        sleeping_.fetch_sub(1);
+        if (stopping_.load()) {
+            break;
+        }
+    }
+
+    current_pool = nullptr;
+}
+
+TaskGroup::TaskGroup(WorkStealingPool& pool)
+    : pool_(pool)
+    , state_(std::make_shared<State>()) {
+}
+
+TaskGroup::~TaskGroup() {
+    cancel();
+    wait();
+}
+
+void TaskGroup::spawn(Task task) {
+    if (!task) {
+        return;
+    }
+    state_->pending.fetch_add(1);
+    pool_.spawn([state = state_, task = std::move(task)]() mutable {
+        if (!state->cancelled.load(std::memory_order_relaxed)) {
+            task();
+        }
+        task = nullptr;   // Release captures before the task counts as done
+        if (state->pending.fetch_sub(1) == 1) {
+            std::lock_guard lock(state->mutex);
+            state->done.notify_all();
+        }
+    });
+}
+
+bool TaskGroup::waitFor(uint32_t timeout_ms) {
+    std::unique_lock lock(state_->mutex);
+    return state_->done.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                                 [this]() { return state_->pending.load() == 0; });
+}
+
+void TaskGroup::wait() {
+    std::unique_lock lock(state_->mutex);
+    state_->done.wait(lock, [this]() { return state_->pending.load() == 0; });
+}
+
+void TaskGroup::cancel() noexcept {
+    state_->cancelled.store(true);
+}
+
+bool TaskGroup::isCancelled() const noexcept {
+    return state_->cancelled.load(std::memory_order_relaxed);
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file work_stealing_pool.h
+ * @brief Per-operation thread pool for recursive, fan-out work
+ *
+ * WorkerPool's single FIFO suits independent callbacks, but a tree walk
+ * spawns its work as it goes: every directory yields tasks for its
+ * entries. Here each worker owns a deque. Tasks spawned from a worker go
+ * on its own deque and it takes them back newest first, so it works
+ * depth-first and keeps few directories open. An idle worker steals the
+ * oldest task from another worker, which is usually the root of a large
+ * untouched subtree.
+ *
+ * One pool serves every operation of a runtime (copies, removals,
+ * searches), each through its own TaskGroup: the group counts only its
+ * own tasks, so an operation waits for and cancels its work alone while
+ * the workers stay shared. The caller spawns the root tasks and waits,
+ * polling with waitFor() when it has progress to report.
+ *
+ * @performance One uncontended lock per spawn and per pop; stealing locks
+ *              only the victim's deque
+ * @thread_safety All public methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+struct WorkStealingMetrics {
+    uint64_t executed = 0;   ///< Tasks run
+    uint64_t stolen = 0;     ///< Tasks taken from another worker's deque
+};
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    /// Upper bound on the default thread count
+    static constexpr size_t MAX_DEFAULT_THREADS = 8;
+
+    /**
+     * @brief Start the workers
+     * @param thread_count Worker threads; 0 for the number of CPUs, up to
+     *        MAX_DEFAULT_THREADS
+     */
+    explicit WorkStealingPool(size_t thread_count = 0);
+
+    /// @brief Cancel what is still queued and join the workers
+    ~WorkStealingPool();
+
+    // Non-copyable, non-movable
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t threadCount() const noexcept { return threads_.size(); }
+
+    /**
+     * @brief Index of the calling worker, for per-worker state
+     * @return 0 to threadCount() - 1, or -1 if not called from this pool's workers
+     */
+    int currentWorker() const noexcept;
+
+    /**
+     * @brief Queue a task
+     *
+     * From one of this pool's workers the task goes on that worker's
+     * deque; from any other thread, on the workers' deques in turn.
+     *
+     * @thread_safe Yes
+     */
+    void spawn(Task task);
+
+    /**
+     * @brief Wait until every spawned task, and everything it spawned, has run
+     * @return true if idle, false if timeout_ms elapsed first
+     * @thread_safe Yes - must not be called from a worker
+     */
+    bool waitFor(uint32_t timeout_ms);
+    void wait();
+
+    /// @brief Discard queued tasks; running tasks finish normally
+    void cancel() noexcept;
+    bool isCancelled() const noexcept { return cancelled_.load(std::memory_order_relaxed); }
+
+    WorkStealingMetrics getMetrics() const noexcept;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<size_t> pending_{0};    ///< Spawned and not yet finished
+    std::atomic<size_t> queued_{0};     ///< Sitting in a deque
+    std::atomic<size_t> sleeping_{0};
+    std::atomic<size_t> next_worker_{0};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> stolen_{0};
+
+    std::mutex idle_mutex_;
+    std::condition_variable wake_;      ///< Work for a sleeping worker
+    std::condition_variable done_;      ///< pending_ reached zero
+
+    void workerThreadFunction(size_t index);
+    bool take(size_t index, Task& task);
+    void finish() noexcept;
+};
+
+/**
+ * @brief One operation's tasks on a shared WorkStealingPool
+ *
+ * Tasks spawned through the group, and those they spawn through it, are
+ * counted and cancelled apart from other groups on the same pool. The
+ * destructor cancels what is still queued and waits for the rest, so
+ * tasks may reference the group's owner.
+ */
+class TaskGroup {
+public:
+    using Task = WorkStealingPool::Task;
+
+    explicit TaskGroup(WorkStealingPool& pool);
+    ~TaskGroup();
+
+    // Non-copyable, non-movable
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    WorkStealingPool& pool() const noexcept { return pool_; }
+
+    /// @thread_safe Yes
+    void spawn(Task task);
+
+    /**
+     * @brief Wait until every task of this group has run
+     * @return true if idle, false if timeout_ms elapsed first
+     * @thread_safe Yes - must not be called from a worker
+     */
+    bool waitFor(uint32_t timeout_ms);
+    void wait();
+
+    /// @brief Discard this group's queued tasks; running tasks finish normally
+    void cancel() noexcept;
+    bool isCancelled() const noexcept;
+
+private:
+    // Shared with queued tasks, which finish after the group may be gone
+    struct State {
+        std::atomic<size_t> pending{0};
+        std::atomic<bool> cancelled{false};
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    WorkStealingPool& pool_;
+    std::shared_ptr<State> state_;
+};
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,95 @@
+#include "worker_pool.h"
+#include "thread_registry.h"
+#include <algorithm>
+#include <string>
+
+namespace cross_terminal {
+namespace core {
+
+WorkerPool::WorkerPool(size_t thread_count)
+    : thread_count_(std::max<size_t>(thread_count, 1)), running_(false) {
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+bool WorkerPool::start() {
+    if (running_.exchange(true)) {
+        return true; // Already running
+    }
+
+    threads_.reserve(thread_count_);
+    for (size_t i = 0; i < thread_count_; ++i) {
+        threads_.emplace_back([this, i]() {
+            auto registration = ThreadRegistry::instance().enter(
+                ThreadRole::Worker, "ct-worker-" + std::to_string(i));
+            workerThreadFunction();
+        });
+    }
+
+    return true;
+}
+
+void WorkerPool::stop() noexcept {
+    {
+        std::lock_guard lock(mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    condition_.notify_all();
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+bool WorkerPool::submit(Task task) {
+    if (!task) {
+        return false;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        if (!running_.load()) {
+            return false;
+        }
+        tasks_.push_back(std::move(task));
+    }
+    condition_.notify_one();
+    return true;
+}
+
+size_t WorkerPool::pending() const noexcept {
+    std::lock_guard lock(mutex_);
+    return tasks_.size();
+}
+
+void WorkerPool::workerThreadFunction() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock lock(mutex_);
+            condition_.wait(lock, [this]() {
+                return !running_.load() || !tasks_.empty();
+            });
+
+            // Drain remaining work before exiting
+            if (tasks_.empty()) {
+                return;
+            }
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        task();
+    }
+}
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file worker_pool.h
+ * @brief Fixed-size thread pool for blocking and CPU-bound work
+ *
+ * Companion to IoReactor: work that must not stall an event loop
+ * (process reaping sweeps, filesystem walks, user callbacks) is
+ * handed to a bounded set of worker threads shared by all sessions.
+ *
+ * @performance FIFO queue, one condition variable wakeup per task
+ * @thread_safety All public methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+/**
+ * @brief Shared worker thread pool
+ */
+class WorkerPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Constructor
+     * @param thread_count Number of worker threads (minimum 1)
+     */
+    explicit WorkerPool(size_t thread_count = 2);
+    ~WorkerPool();
+
+    // Non-copyable, non-movable
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    /**
+     * @brief Start worker threads
+     * @return true if workers are running
+     * @thread_safe Yes
+     */
+    bool start();
+
+    /**
+     * @brief Drain queued tasks and join all workers
+     * @thread_safe Yes - must not be called from a worker thread
+     * @exception_safety No-throw guarantee
+     */
+    void stop() noexcept;
+
+    /**
+     * @brief Queue a task for execution
+     * @return false if the pool is stopped
+     * @thread_safe Yes
+     * @performance O(1)
+     */
+    bool submit(Task task);
+
+    /// @brief Number of worker threads
+    size_t threadCount() const noexcept { return thread_count_; }
+
+    /// @brief Number of tasks waiting for a worker
+    size_t pending() const noexcept;
+
+    /// @brief Check if workers are running
+    bool isRunning() const noexcept { return running_.load(); }
+
+private:
+    const size_t thread_count_;
+    std::vector<std::thread> threads_;
+    std::deque<Task> tasks_;
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::atomic<bool> running_;
+
+    void workerThreadFunction();
+};
+
+} // namespace core
+} // namespace cross_terminal
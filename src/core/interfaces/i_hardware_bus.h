@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "memory/small_vector.h"
+
+/**
+ * @file i_hardware_bus.h
+ * @brief I2C and SPI bus interfaces
+ *
+ * Both interfaces expose the bus at the granularity the kernel executes
+ * atomically: a combined I2C transaction (messages joined by repeated
+ * starts, one I2C_RDWR ioctl on Linux) and an SPI message (transfers
+ * under one chip select assertion, one SPI_IOC_MESSAGE ioctl). Batching
+ * many register accesses into one call removes a syscall and a bus
+ * turnaround per access; I2CBatch and SPIBatch do the packing.
+ *
+ * @performance One kernel call per transfer()
+ * @thread_safety Implementations serialize transfer() calls per bus
+ */
+
+namespace cross_terminal {
+namespace hardware {
+
+/**
+ * @brief One segment of a combined I2C transaction
+ */
+struct I2CMessage {
+    uint16_t address = 0;     ///< 7-bit target address
+    bool read = false;        ///< true: read into data, false: write from data
+    uint8_t* data = nullptr;  ///< Source or destination buffer
+    uint16_t length = 0;      ///< Bytes to transfer
+};
+
+/**
+ * @brief I2C adapter
+ */
+class II2CBus {
+public:
+    virtual ~II2CBus() = default;
+
+    /**
+     * @brief Execute messages as one combined transaction
+     *
+     * A STOP is only issued after the last message, so a register write
+     * followed by a read cannot be interleaved with another master.
+     *
+     * @param messages Messages in bus order
+     * @param count Number of messages, at most maxMessagesPerTransfer()
+     * @return true if every message was acknowledged
+     * @thread_safe Yes
+     * @performance One kernel call
+     */
+    virtual bool transfer(I2CMessage* messages, size_t count) = 0;
+
+    /// @brief Largest message count transfer() accepts
+    virtual size_t maxMessagesPerTransfer() const noexcept = 0;
+
+    /**
+     * @brief Read consecutive registers: register write, repeated start, read
+     * @thread_safe Yes
+     */
+    bool readRegisters(uint16_t address, uint8_t reg, uint8_t* out, uint16_t length) {
+        I2CMessage messages[2];
+        messages[0].address = address;
+        messages[0].data = &reg;
+        messages[0].length = 1;
+        messages[1].address = address;
+        messages[1].read = true;
+        messages[1].data = out;
+        messages[1].length = length;
+        return transfer(messages, 2);
+    }
+
+    /**
+     * @brief Write consecutive registers starting at reg
+     * @thread_safe Yes
+     */
+    bool writeRegisters(uint16_t address, uint8_t reg, const uint8_t* data, uint16_t length) {
+        memory::SmallVector<uint8_t, 32> buffer;
+        buffer.resize(length + 1u);
+        buffer[0] = reg;
+        std::memcpy(buffer.data() + 1, data, length);
+        I2CMessage message;
+        message.address = address;
+        message.data = buffer.data();
+        message.length = static_cast<uint16_t>(buffer.size());
+        return transfer(&message, 1);
+    }
+};
+
+/**
+ * @brief SPI device settings
+ */
+struct SPIConfig {
+    uint8_t mode = 0;              ///< SPI mode 0-3 (CPOL/CPHA)
+    uint8_t bits_per_word = 8;
+    uint32_t speed_hz = 1000000;   ///< Default clock for transfers without their own
+};
+
+/**
+ * @brief One segment of an SPI message
+ */
+struct SPITransfer {
+    const uint8_t* tx = nullptr;   ///< Bytes to send (null: send zeros)
+    uint8_t* rx = nullptr;         ///< Bytes received (null: discard)
+    uint32_t length = 0;
+    uint32_t speed_hz = 0;         ///< 0: device default
+    uint16_t delay_us = 0;         ///< Delay after this transfer
+    bool cs_change = false;        ///< Release chip select after this transfer
+};
+
+/**
+ * @brief SPI device (one chip select on a controller)
+ */
+class ISPIDevice {
+public:
+    virtual ~ISPIDevice() = default;
+
+    /**
+     * @brief Apply mode, word size and default clock
+     * @return true if the controller accepted the settings
+     * @thread_safe Yes
+     */
+    virtual bool configure(const SPIConfig& config) = 0;
+
+    /**
+     * @brief Execute transfers as one message
+     *
+     * Chip select stays asserted across the transfers unless a transfer
+     * sets cs_change.
+     *
+     * @param transfers Transfers in bus order
+     * @param count At most maxTransfersPerMessage(), totalling at most
+     *        maxBytesPerMessage() bytes
+     * @return true on success
+     * @thread_safe Yes
+     * @performance One kernel call
+     */
+    virtual bool transfer(const SPITransfer* transfers, size_t count) = 0;
+
+    /// @brief Largest transfer count per message
+    virtual size_t maxTransfersPerMessage() const noexcept = 0;
+
+    /// @brief Largest total length per message (spidev's bufsiz)
+    virtual size_t maxBytesPerMessage() const noexcept = 0;
+};
+
+} // namespace hardware
+} // namespace cross_terminal
@@ -4,13 +4,16 @@
 #include <vector>
 #include <functional>
 #include <cstdint>
+#include "memory/small_vector.h"
+#include "core/interfaces/i_hardware_bus.h"
 
 /**
  * @file i_hardware_controller.h
  * @brief Hardware control interface for cross-platform hardware access
  * 
  * Provides unified API for hardware control across different platforms
- * including GPIO, sensors, system monitoring, and device control.
+ * including GPIO, I2C/SPI buses, sensors, system monitoring, and
+ * device control.
  * 
  * @performance Optimized for real-time hardware access
  * @thread_safety All methods are thread-safe unless explicitly noted
@@ -55,7 +58,7 @@ enum class SensorType : uint8_t {
  */
 struct SensorData {
     SensorType type;              ///< Sensor type identifier
-    std::vector<float> values;    ///< Sensor readings (axis-dependent)
+    memory::SmallVector<float, 3> values; ///< Sensor readings (axis-dependent, inline up to 3)
     uint64_t timestamp;           ///< Timestamp in milliseconds since epoch
     float accuracy;               ///< Reading accuracy/confidence [0.0-1.0]
     
@@ -185,6 +188,27 @@ public:
      */
     virtual bool readGPIO(int pin) = 0;
     
+    // Bus Access
+    
+    /**
+     * @brief Open an I2C adapter
+     * @param bus Adapter number (/dev/i2c-N on Linux)
+     * @return Bus handle, or null if the adapter is unavailable
+     * @thread_safe Yes
+     * @performance Opens the device node once; keep the handle for repeated use
+     */
+    virtual std::shared_ptr<II2CBus> openI2CBus(int bus) = 0;
+    
+    /**
+     * @brief Open an SPI device
+     * @param bus Controller number
+     * @param chip_select Chip select line (/dev/spidevB.C on Linux)
+     * @return Device handle, or null if the device is unavailable
+     * @thread_safe Yes
+     * @performance Opens the device node once; keep the handle for repeated use
+     */
+    virtual std::shared_ptr<ISPIDevice> openSPIDevice(int bus, int chip_select) = 0;
+    
     // Sensor Access
     
     /**
@@ -6,6 +6,8 @@
 #include <functional>
 #include <cstdint>
 #include "memory/memory_manager.h"
+#include "memory/small_vector.h"
+#include "memory/string_interner.h"
 
 /**
  * @file i_shell.h
@@ -34,6 +36,12 @@ enum class ProcessState : uint8_t {
     Suspended = 5     ///< Process suspended (job control)
 };
 
+/**
+ * @brief Argument vector sized for typical commands
+ * @performance No heap allocation for up to four arguments
+ */
+using ArgumentList = memory::SmallVector<std::string, 4>;
+
 /**
  * @brief Process information structure
  */
@@ -44,14 +52,18 @@ struct ProcessInfo {
     int exit_code;             ///< Exit code (valid when state is Completed/Failed)
     uint64_t start_time;       ///< Start time in milliseconds since epoch
     uint64_t end_time;         ///< End time in milliseconds since epoch
-    std::string command;       ///< Original command string
-    std::vector<std::string> arguments; ///< Command arguments
-    std::string working_dir;   ///< Working directory
+    memory::InternedString command;                           ///< Original command string
+    memory::SmallVector<memory::InternedString, 4> arguments; ///< Command arguments
+    memory::InternedString working_dir;                       ///< Working directory
+    uint64_t user_time_ms;     ///< User CPU time (valid once reaped)
+    uint64_t system_time_ms;   ///< System CPU time (valid once reaped)
+    uint64_t max_rss_kb;       ///< Peak resident set size (valid once reaped)
     
     /// @brief Default constructor
     ProcessInfo() 
         : pid(0), parent_pid(0), state(ProcessState::NotStarted)
-        , exit_code(0), start_time(0), end_time(0) {}
+        , exit_code(0), start_time(0), end_time(0)
+        , user_time_ms(0), system_time_ms(0), max_rss_kb(0) {}
     
     /// @brief Check if process is active
     bool isActive() const noexcept {
@@ -74,7 +86,7 @@ private:
  */
 class Environment {
 private:
-    std::unordered_map<std::string, std::string> variables_;
+    std::unordered_map<memory::InternedString, std::string> variables_;
     mutable std::shared_mutex mutex_;
     
 public:
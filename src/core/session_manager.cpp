@@ -0,0 +1,377 @@
+#include "session_manager.h"
+#include "core/implementations/thread_registry.h"
+
+namespace cross_terminal {
+namespace core {
+
+SessionManager::SessionManager(const SessionManagerConfig& config)
+    : reactor_(std::make_shared<IoReactor>(config.reactor_threads))
+    , workers_(std::make_shared<WorkerPool>(config.worker_threads))
+    , file_threads_(config.file_threads)
+    , shutdown_grace_ms_(config.shutdown_grace_ms)
+    , history_directory_(config.history_directory)
+    , next_session_id_(1)
+    , foreground_session_(-1)
+    , initialized_(false)
+    , memory_limit_(config.memory_limit)
+    , monitor_memory_pressure_(config.monitor_memory_pressure)
+    , thread_layout_(config.thread_layout) {
+}
+
+SessionManager::~SessionManager() {
+    shutdown();
+}
+
+bool SessionManager::initialize() {
+    if (initialized_.exchange(true)) {
+        return true; // Already initialized
+    }
+
+    // Role policies must be in place before the runtime threads enter
+    if (!thread_layout_.empty() && !ThreadRegistry::instance().configure(thread_layout_)) {
+        initialized_.store(false);
+        return false;
+    }
+
+    if (!reactor_->start() || !workers_->start()) {
+        shutdown();
+        return false;
+    }
+    file_pool_ = std::make_shared<WorkStealingPool>(file_threads_);
+
+    if (!history_directory_.empty()) {
+        auto history = std::make_shared<JobHistory>();
+        if (history->open(history_directory_)) {
+            history_ = std::move(history);
+        }
+    }
+
+    attachMemoryBudget();
+    return true;
+}
+
+void SessionManager::shutdown() noexcept {
+    if (!initialized_.exchange(false)) {
+        return;
+    }
+
+    std::unordered_map<SessionId, std::shared_ptr<ShellImpl>> sessions;
+    std::unordered_map<SessionId, std::shared_ptr<SerialSession>> serial_sessions;
+    {
+        std::unique_lock lock(sessions_mutex_);
+        sessions.swap(sessions_);
+        serial_sessions.swap(serial_sessions_);
+    }
+
+    detachMemoryBudget();
+
+    // Shells and ports must release their reactor registrations before it stops
+    terminateSessions(sessions);
+    sessions.clear();
+    for (const auto& [id, serial] : serial_sessions) {
+        serial->close();
+    }
+    serial_sessions.clear();
+    foreground_session_.store(-1);
+
+    file_pool_.reset();   // Joined by the last shell still holding it
+    workers_->stop();
+    reactor_->stop();
+
+    if (history_) {
+        history_->close();
+        history_.reset();
+    }
+}
+
+ShutdownReport SessionManager::getLastShutdownReport() const {
+    std::lock_guard lock(shutdown_mutex_);
+    return last_shutdown_report_;
+}
+
+ShutdownReport SessionManager::terminateSessions(
+        const std::unordered_map<SessionId, std::shared_ptr<ShellImpl>>& sessions) noexcept {
+    // One terminator pass over the processes of every session
+    std::vector<ProcessPtr> processes;
+    for (const auto& [id, session] : sessions) {
+        for (auto& [pid, process] : session->releaseProcesses()) {
+            processes.push_back(std::move(process));
+        }
+    }
+
+    std::vector<ManagedProcess*> targets;
+    targets.reserve(processes.size());
+    for (auto& process : processes) {
+        targets.push_back(process.get());
+    }
+    ProcessTerminator terminator(reactor_.get());
+    ShutdownReport report = terminator.terminate(targets, shutdown_grace_ms_);
+    if (history_) {
+        for (auto* process : targets) {
+            history_->append(process->getInfo());
+        }
+    }
+    processes.clear();
+
+    for (const auto& [id, session] : sessions) {
+        session->shutdown();
+    }
+
+    std::lock_guard lock(shutdown_mutex_);
+    last_shutdown_report_ = report;
+    return report;
+}
+
+SessionManager::SessionId SessionManager::createSession() {
+    if (!initialized_.load()) {
+        return -1;
+    }
+
+    auto shell = std::make_shared<ShellImpl>(reactor_, workers_, file_pool_);
+    shell->setJobHistory(history_);
+    if (!shell->initialize()) {
+        return -1;
+    }
+
+    SessionId id = next_session_id_.fetch_add(1);
+    {
+        std::unique_lock lock(sessions_mutex_);
+        sessions_[id] = std::move(shell);
+    }
+
+    return id;
+}
+
+SessionManager::SessionId SessionManager::createSerialSession(const SerialConfig& config,
+                                                             std::string* error) {
+    if (!initialized_.load()) {
+        if (error) {
+            *error = "session manager is not running";
+        }
+        return -1;
+    }
+
+    auto serial = std::make_shared<SerialSession>(reactor_, workers_);
+    if (!serial->open(config, error)) {
+        return -1;
+    }
+
+    SessionId id = next_session_id_.fetch_add(1);
+    {
+        std::unique_lock lock(sessions_mutex_);
+        serial_sessions_[id] = std::move(serial);
+    }
+
+    return id;
+}
+
+std::shared_ptr<SerialSession> SessionManager::getSerialSession(SessionId id) const {
+    std::shared_lock lock(sessions_mutex_);
+    auto it = serial_sessions_.find(id);
+    return it != serial_sessions_.end() ? it->second : nullptr;
+}
+
+ShutdownReport SessionManager::closeSessions(const std::vector<SessionId>& ids) {
+    std::unordered_map<SessionId, std::shared_ptr<ShellImpl>> sessions;
+    std::vector<std::shared_ptr<SerialSession>> serial_sessions;
+    {
+        std::unique_lock lock(sessions_mutex_);
+        for (SessionId id : ids) {
+            auto it = sessions_.find(id);
+            if (it != sessions_.end()) {
+                sessions.emplace(id, std::move(it->second));
+                sessions_.erase(it);
+            }
+            auto serial = serial_sessions_.find(id);
+            if (serial != serial_sessions_.end()) {
+                serial_sessions.push_back(std::move(serial->second));
+                serial_sessions_.erase(serial);
+            }
+        }
+    }
+
+    for (SessionId id : ids) {
+        SessionId expected = id;
+        foreground_session_.compare_exchange_strong(expected, -1);
+    }
+
+    for (const auto& serial : serial_sessions) {
+        serial->close();
+    }
+    return terminateSessions(sessions);
+}
+
+bool SessionManager::closeSession(SessionId id) {
+    std::shared_ptr<ShellImpl> session;
+    std::shared_ptr<SerialSession> serial;
+    {
+        std::unique_lock lock(sessions_mutex_);
+        auto it = sessions_.find(id);
+        if (it != sessions_.end()) {
+            session = std::move(it->second);
+            sessions_.erase(it);
+        } else {
+            auto serial_it = serial_sessions_.find(id);
+            if (serial_it == serial_sessions_.end()) {
+                return false;
+            }
+            serial = std::move(serial_it->second);
+            serial_sessions_.erase(serial_it);
+        }
+    }
+
+    SessionId expected = id;
+    foreground_session_.compare_exchange_strong(expected, -1);
+
+    if (session) {
+        session->shutdown();
+    } else {
+        serial->close();
+    }
+    return true;
+}
+
+std::shared_ptr<IShell> SessionManager::getSession(SessionId id) const {
+    std::shared_lock lock(sessions_mutex_);
+    auto it = sessions_.find(id);
+    return it != sessions_.end() ? it->second : nullptr;
+}
+
+bool SessionManager::setForegroundSession(SessionId id) {
+    // Exclusive: concurrent switches must not interleave promote/demote
+    std::unique_lock lock(sessions_mutex_);
+
+    auto next = sessions_.find(id);
+    auto next_serial = serial_sessions_.find(id);
+    if (id != -1 && next == sessions_.end() && next_serial == serial_sessions_.end()) {
+        return false;
+    }
+
+    const SessionId previous = foreground_session_.exchange(id);
+    if (previous == id) {
+        return true;
+    }
+
+    auto prev = sessions_.find(previous);
+    if (prev != sessions_.end()) {
+        prev->second->setForeground(false);
+    }
+    auto prev_serial = serial_sessions_.find(previous);
+    if (prev_serial != serial_sessions_.end()) {
+        prev_serial->second->setForeground(false);
+    }
+    if (next != sessions_.end()) {
+        next->second->setForeground(true);
+    }
+    if (next_serial != serial_sessions_.end()) {
+        next_serial->second->setForeground(true);
+    }
+    return true;
+}
+
+SessionMetrics SessionManager::getSessionMetrics(SessionId id) const {
+    std::shared_lock lock(sessions_mutex_);
+    auto it = sessions_.find(id);
+    if (it != sessions_.end()) {
+        return it->second->getSessionMetrics();
+    }
+    auto serial = serial_sessions_.find(id);
+    return serial != serial_sessions_.end() ? serial->second->getSessionMetrics() : SessionMetrics();
+}
+
+std::vector<SessionManager::SessionId> SessionManager::getSessionIds() const {
+    std::shared_lock lock(sessions_mutex_);
+    std::vector<SessionId> ids;
+    ids.reserve(sessions_.size() + serial_sessions_.size());
+    for (const auto& [id, session] : sessions_) {
+        ids.push_back(id);
+    }
+    for (const auto& [id, serial] : serial_sessions_) {
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+size_t SessionManager::getSessionCount() const {
+    std::shared_lock lock(sessions_mutex_);
+    return sessions_.size() + serial_sessions_.size();
+}
+
+SessionManager::Stats SessionManager::getStats() const {
+    Stats stats;
+    stats.sessions = getSessionCount();
+    stats.reactor_threads = reactor_->threadCount();
+    stats.worker_threads = workers_->threadCount();
+    // Session descriptors only, the PSI trigger is not per-session
+    stats.registered_fds = reactor_->registrationCount() - (psi_.is_open() ? 1 : 0);
+    stats.pending_work = workers_->pending();
+    stats.memory_usage = memory::MemoryBudget::instance().total_usage();
+    stats.pressure_monitoring = psi_.is_open();
+    return stats;
+}
+
+void SessionManager::attachMemoryBudget() {
+    auto& budget = memory::MemoryBudget::instance();
+    if (memory_limit_ != 0) {
+        budget.set_limit(memory_limit_);
+    }
+
+    // Shrink passes take cache locks, keep them off reactor and caller threads
+    budget.set_dispatcher([workers = workers_](std::function<void()> task) {
+        return workers->submit(std::move(task));
+    });
+
+    memory_caches_.push_back(budget.register_cache(
+        "session scrollback", memory::MemoryTag::Scrollback, memory::CachePriority::UserVisible,
+        [this](memory::PressureLevel) { return trimScrollback(CRITICAL_SCROLLBACK_BYTES); }));
+    if (history_) {
+        memory_caches_.push_back(budget.register_cache(
+            "job history", memory::MemoryTag::History, memory::CachePriority::Recomputable,
+            [history = history_](memory::PressureLevel) { return history->releaseMemory(); }));
+    }
+
+    if (monitor_memory_pressure_ && psi_.open()) {
+        const bool added = reactor_->add(psi_.fd(), IoReactor::Priority,
+            [this](int, uint32_t events) {
+                if (events & IoReactor::Priority) {
+                    memory::MemoryBudget::instance().on_pressure(psi_.read_level());
+                }
+            });
+        if (!added) {
+            psi_.close();
+        }
+    }
+}
+
+void SessionManager::detachMemoryBudget() noexcept {
+    if (psi_.is_open()) {
+        reactor_->remove(psi_.fd());
+        psi_.close();
+    }
+
+    auto& budget = memory::MemoryBudget::instance();
+    try {
+        budget.set_dispatcher(nullptr);
+        // Waits for a shrink pass that may still be inside one of our callbacks
+        for (auto id : memory_caches_) {
+            budget.unregister_cache(id);
+        }
+    } catch (...) {
+    }
+    memory_caches_.clear();
+}
+
+size_t SessionManager::trimScrollback(size_t keep_bytes) const noexcept {
+    std::shared_lock lock(sessions_mutex_);
+    size_t released = 0;
+    for (const auto& [id, session] : sessions_) {
+        released += session->trimOutput(keep_bytes);
+    }
+    for (const auto& [id, serial] : serial_sessions_) {
+        released += serial->trimOutput(keep_bytes);
+    }
+    return released;
+}
+
+} // namespace core
+} // namespace cross_terminal
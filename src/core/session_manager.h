@@ -0,0 +1,239 @@
+#pragma once
+
+#include "core/implementations/io_reactor.h"
+#include "core/implementations/serial_session.h"
+#include "core/implementations/shell_impl.h"
+#include "core/implementations/work_stealing_pool.h"
+#include "core/implementations/worker_pool.h"
+#include "core/interfaces/i_shell.h"
+#include "memory/memory_budget.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file session_manager.h
+ * @brief Multi-session engine sharing one reactor and worker pool
+ *
+ * Owns any number of shell sessions (terminal tabs) which all run on a
+ * fixed set of reactor and worker threads. Opening a session costs no
+ * native threads, only the descriptors of the processes it starts.
+ * Serial console sessions share the same runtime and id space, and the
+ * file builtins of every session share one work-stealing pool.
+ *
+ * The manager also wires the process-wide memory budget to the runtime:
+ * Linux PSI memory stalls are watched on the reactor, shrink passes run
+ * on the worker pool, and session scrollback and the job history are
+ * registered as shrinkable caches.
+ *
+ * @performance Thread count is O(1) in the number of sessions
+ * @thread_safety All methods are thread-safe
+ * @memory_model Sessions are shared_ptr owned; closing a session while a
+ *               caller still holds it defers destruction to that caller
+ */
+
+namespace cross_terminal {
+namespace core {
+
+/**
+ * @brief Session manager configuration
+ */
+struct SessionManagerConfig {
+    size_t reactor_threads = 2;   ///< Event loop threads shared by all sessions
+    size_t worker_threads = 2;    ///< Worker threads for blocking maintenance work
+    size_t file_threads = 0;      ///< Work-stealing threads for cp/mv/rm/find/du; 0 for the CPU count
+    uint32_t shutdown_grace_ms = 1000;   ///< Deadline for graceful process exit on shutdown
+    std::string history_directory;       ///< Job history store location, empty to disable
+    size_t memory_limit = 0;             ///< Soft budget for accounted memory in bytes, 0 for none
+    bool monitor_memory_pressure = true; ///< Shrink caches on PSI memory stalls (Linux)
+    std::string thread_layout;           ///< ThreadRegistry::configure() spec, empty for defaults
+};
+
+/**
+ * @brief Shared-runtime session manager
+ */
+class SessionManager {
+public:
+    using SessionId = int;
+
+    /**
+     * @brief Runtime statistics snapshot
+     */
+    struct Stats {
+        size_t sessions;              ///< Open sessions
+        size_t reactor_threads;       ///< Reactor thread count
+        size_t worker_threads;        ///< Worker thread count
+        size_t registered_fds;        ///< Session descriptors watched by the reactor
+        size_t pending_work;          ///< Tasks queued on the worker pool
+        size_t memory_usage;          ///< Bytes accounted by the memory budget
+        bool pressure_monitoring;     ///< PSI trigger registered on the reactor
+    };
+
+    /// Scrollback kept per process stream when pressure turns critical
+    static constexpr size_t CRITICAL_SCROLLBACK_BYTES = 64 * 1024;
+
+    explicit SessionManager(const SessionManagerConfig& config = SessionManagerConfig());
+    ~SessionManager();
+
+    // Non-copyable, non-movable
+    SessionManager(const SessionManager&) = delete;
+    SessionManager& operator=(const SessionManager&) = delete;
+    SessionManager(SessionManager&&) = delete;
+    SessionManager& operator=(SessionManager&&) = delete;
+
+    /**
+     * @brief Start the shared reactor and worker threads
+     * @return true if the runtime is running
+     * @thread_safe Yes
+     */
+    bool initialize();
+
+    /**
+     * @brief Close all sessions and stop the shared runtime
+     *
+     * Processes of all sessions are terminated in one pass: every process
+     * group is signalled at once, exits are awaited concurrently on the
+     * reactor, and stragglers are killed at the configured deadline.
+     *
+     * @thread_safe Yes
+     * @performance Bounded by shutdown_grace_ms, independent of job count
+     * @exception_safety No-throw guarantee
+     */
+    void shutdown() noexcept;
+
+    /// @brief Report of the most recent shutdown() or closeSessions()
+    ShutdownReport getLastShutdownReport() const;
+
+    /**
+     * @brief Open a new shell session on the shared runtime
+     * @return Session id, or -1 if the session could not be created
+     * @thread_safe Yes
+     * @performance O(1), no threads are created
+     */
+    SessionId createSession();
+
+    /**
+     * @brief Open a serial console session on the shared runtime
+     *
+     * The port is read on the reactor and its output delivered on the
+     * worker pool, like a process of a shell session. Foreground, metrics,
+     * scrollback trimming and close apply to it through its session id.
+     *
+     * @param config Port settings
+     * @param error Receives the reason on failure (optional)
+     * @return Session id, or -1 if the port could not be opened
+     * @thread_safe Yes
+     */
+    SessionId createSerialSession(const SerialConfig& config, std::string* error = nullptr);
+
+    /**
+     * @brief Get the serial port backing a session
+     * @return Serial session, or nullptr if the id is not a serial session
+     * @thread_safe Yes
+     */
+    std::shared_ptr<SerialSession> getSerialSession(SessionId id) const;
+
+    /**
+     * @brief Close a session and terminate its processes
+     * @return true if the session existed
+     * @thread_safe Yes
+     */
+    bool closeSession(SessionId id);
+
+    /**
+     * @brief Close several sessions with one parallel, deadline-bounded shutdown
+     * @param ids Sessions to close; unknown ids are ignored
+     * @return Report of the joint shutdown
+     * @thread_safe Yes
+     * @performance Bounded by shutdown_grace_ms, independent of job count
+     */
+    ShutdownReport closeSessions(const std::vector<SessionId>& ids);
+
+    /**
+     * @brief Get the shell backing a session
+     * @return Shell, or nullptr if the session does not exist
+     * @thread_safe Yes
+     * @performance O(1)
+     */
+    std::shared_ptr<IShell> getSession(SessionId id) const;
+
+    /**
+     * @brief Give a session interactive priority
+     *
+     * The previous foreground session is demoted. Foreground output is
+     * dispatched first and with a larger byte quantum, so its echo stays
+     * responsive while other sessions flood their pipes.
+     *
+     * @param id Session id, or -1 to clear the foreground session
+     * @return true if the session exists (always true for -1)
+     * @thread_safe Yes
+     */
+    bool setForegroundSession(SessionId id);
+
+    /// @brief Current foreground session id, -1 if none
+    SessionId getForegroundSession() const noexcept { return foreground_session_.load(); }
+
+    /**
+     * @brief Output scheduling and echo latency metrics of a session
+     * @return Metrics snapshot, default-constructed if the session does not exist
+     * @thread_safe Yes
+     */
+    SessionMetrics getSessionMetrics(SessionId id) const;
+
+    /// @brief Ids of all open sessions
+    std::vector<SessionId> getSessionIds() const;
+
+    /// @brief Number of open sessions
+    size_t getSessionCount() const;
+
+    /// @brief Runtime statistics snapshot
+    Stats getStats() const;
+
+    /// @brief Shared reactor, valid for the manager's lifetime
+    IoReactor& getReactor() noexcept { return *reactor_; }
+
+    /// @brief Job history shared by all sessions, null if disabled
+    std::shared_ptr<JobHistory> getJobHistory() const noexcept { return history_; }
+
+    /// @brief Shared worker pool, valid for the manager's lifetime
+    WorkerPool& getWorkers() noexcept { return *workers_; }
+
+private:
+    std::shared_ptr<IoReactor> reactor_;
+    std::shared_ptr<WorkerPool> workers_;
+    std::shared_ptr<WorkStealingPool> file_pool_;   // Started by initialize()
+    size_t file_threads_;
+    uint32_t shutdown_grace_ms_;
+    std::string history_directory_;
+    std::shared_ptr<JobHistory> history_;
+    ShutdownReport last_shutdown_report_;
+    mutable std::mutex shutdown_mutex_;
+
+    std::unordered_map<SessionId, std::shared_ptr<ShellImpl>> sessions_;
+    std::unordered_map<SessionId, std::shared_ptr<SerialSession>> serial_sessions_;
+    mutable std::shared_mutex sessions_mutex_;
+    std::atomic<SessionId> next_session_id_;
+    std::atomic<SessionId> foreground_session_;
+    std::atomic<bool> initialized_;
+
+    // Memory pressure handling
+    size_t memory_limit_;
+    bool monitor_memory_pressure_;
+    std::string thread_layout_;
+    memory::PsiMonitor psi_;
+    std::vector<memory::MemoryBudget::CacheId> memory_caches_;
+
+    void attachMemoryBudget();
+    void detachMemoryBudget() noexcept;
+    size_t trimScrollback(size_t keep_bytes) const noexcept;
+
+    ShutdownReport terminateSessions(
+        const std::unordered_map<SessionId, std::shared_ptr<ShellImpl>>& sessions) noexcept;
+};
+
+} // namespace core
+} // namespace cross_terminal
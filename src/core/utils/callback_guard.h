@@ -0,0 +1,96 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <utility>
+
+/**
+ * @file callback_guard.h
+ * @brief Lifetime guard for callbacks deferred to reactor or worker threads
+ *
+ * Objects that hand `this`-capturing closures to IoReactor timers or
+ * WorkerPool tasks wrap them through a CallbackGuard. Once the owner
+ * calls invalidate() (normally from its destructor), pending closures
+ * become no-ops, and invalidate() waits for a closure already running.
+ *
+ * @thread_safety All methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+class CallbackGuard {
+private:
+    struct State {
+        std::recursive_mutex mutex;
+        bool alive = true;
+    };
+
+    std::shared_ptr<State> state_;
+
+public:
+    CallbackGuard() : state_(std::make_shared<State>()) {}
+
+    ~CallbackGuard() {
+        invalidate();
+    }
+
+    // Non-copyable, non-movable
+    CallbackGuard(const CallbackGuard&) = delete;
+    CallbackGuard& operator=(const CallbackGuard&) = delete;
+    CallbackGuard(CallbackGuard&&) = delete;
+    CallbackGuard& operator=(CallbackGuard&&) = delete;
+
+    /**
+     * @brief Wrap a closure so it only runs while the owner is alive
+     * @thread_safe Yes
+     */
+    template<typename F>
+    auto wrap(F&& func) const {
+        return [state = state_, func = std::forward<F>(func)]() mutable {
+            std::lock_guard lock(state->mutex);
+            if (state->alive) {
+                func();
+            }
+        };
+    }
+
+    /**
+     * @brief Disable all wrapped closures
+     *
+     * Blocks while a wrapped closure runs on another thread. Safe to call
+     * from inside a wrapped closure.
+     *
+     * @exception_safety No-throw guarantee
+     */
+    void invalidate() noexcept {
+        std::lock_guard lock(state_->mutex);
+        state_->alive = false;
+    }
+
+    /**
+     * @brief Re-arm an invalidated guard for a new owner lifetime
+     *
+     * Closures wrapped before the last invalidate() stay disabled. The
+     * shared state is reused when no such closure is still queued.
+     *
+     * @thread_safe No - owner only, after invalidate()
+     */
+    void reset() {
+        if (state_.use_count() == 1) {
+            std::lock_guard lock(state_->mutex);
+            state_->alive = true;
+        } else {
+            state_ = std::make_shared<State>();
+        }
+    }
+
+    /// @brief Check if wrapped closures are still enabled
+    bool isAlive() const noexcept {
+        std::lock_guard lock(state_->mutex);
+        return state_->alive;
+    }
+};
+
+} // namespace core
+} // namespace cross_terminal
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @file latency_histogram.h
+ * @brief Lock-free log2 latency histogram
+ *
+ * Records microsecond samples into power-of-two buckets with relaxed
+ * atomics, so it can sit on the reactor hot path. Percentiles are
+ * reported as the upper bound of the bucket containing the rank.
+ *
+ * @performance O(1) record, O(buckets) percentile
+ * @thread_safety All methods are thread-safe
+ */
+
+namespace cross_terminal {
+namespace core {
+
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKET_COUNT = 32;   ///< Covers 1us .. ~35 minutes
+
+    /// @brief Record one sample in microseconds
+    void record(uint64_t micros) noexcept {
+        buckets_[bucketFor(micros)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t current_max = max_.load(std::memory_order_relaxed);
+        while (micros > current_max &&
+               !max_.compare_exchange_weak(current_max, micros, std::memory_order_relaxed)) {
+        }
+    }
+
+    /// @brief Number of recorded samples
+    uint64_t count() const noexcept {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Largest recorded sample
+    uint64_t max() const noexcept {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Approximate percentile
+     * @param percentile Value in [0, 100]
+     * @return Bucket upper bound in microseconds, 0 if no samples
+     */
+    uint64_t percentile(double percentile) const noexcept {
+        const uint64_t total = count();
+        if (total == 0) {
+            return 0;
+        }
+
+        const uint64_t rank = static_cast<uint64_t>(total * percentile / 100.0 + 0.5);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank && seen > 0) {
+                uint64_t upper = (uint64_t{1} << i);
+                return upper < max() ? upper : max();
+            }
+        }
+        return max();
+    }
+
+    /// @brief Drop all samples
+    void reset() noexcept {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> max_{0};
+
+    static size_t bucketFor(uint64_t micros) noexcept {
+        size_t bucket = 0;
+        while (bucket + 1 < BUCKET_COUNT && (uint64_t{1} << bucket) < micros) {
+            ++bucket;
+        }
+        return bucket;
+    }
+};
+
+} // namespace core
+} // namespace cross_terminal
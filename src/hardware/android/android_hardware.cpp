@@ -1,5 +1,8 @@
 #include "android_hardware.h"
+#include "core/implementations/thread_registry.h"
 #include <android/log.h>
+#include <cerrno>
+#include <cstring>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
@@ -17,13 +20,39 @@ static const char* GPIO_BASE_PATH = "/sys/class/gpio";
 static const char* GPIO_EXPORT_PATH = "/sys/class/gpio/export";
 static const char* GPIO_UNEXPORT_PATH = "/sys/class/gpio/unexport";
 
+// Metrics sampling interval. With uevents, battery changes wake the
+// monitor on their own and only CPU/memory load needs periodic sampling.
+static const auto MONITOR_INTERVAL = std::chrono::seconds(1);
+static const auto MONITOR_INTERVAL_EVENT_DRIVEN = std::chrono::seconds(5);
+
 AndroidHardwareController::AndroidHardwareController() 
-    : m_systemMonitoringActive(false) {
+    : m_deviceControl(DeviceControlClient::defaultCommand()),
+      m_tones(PcmSink::openDefault()),
+      m_systemMonitoringActive(false) {
+    m_capabilities.refresh();
+    m_capabilities.attach(m_uevents);
+    m_telemetry.open();
+    m_power.refresh();
+    m_power.attach(m_uevents);
+    m_power.setListener([this](const PowerState&) {
+        std::lock_guard<std::mutex> lock(m_monitoringMutex);
+        m_powerChanged = true;
+        m_monitoringWake.notify_one();
+    });
+    std::string error;
+    if (!m_uevents.start(&error)) {
+        // Apps without netlink access keep the startup scan
+        LOGD("Hotplug events unavailable (%s), sensor list is static", error.c_str());
+    }
     LOGD("AndroidHardwareController initialized");
 }
 
 AndroidHardwareController::~AndroidHardwareController() {
     stopSystemMonitoring();
+    m_uevents.stop();
+    m_telemetry.close();
+    m_power.detach();
+    m_capabilities.detach();
     LOGD("AndroidHardwareController destroyed");
 }
 
@@ -123,27 +152,51 @@ bool AndroidHardwareController::readGPIO(int pin) {
     return (value == '1');
 }
 
-std::vector<SensorType> AndroidHardwareController::getAvailableSensors() {
-    std::vector<SensorType> sensors;
-    
-    // Check for common Android sensor files
-    const std::map<std::string, SensorType> sensorPaths = {
-        {"/sys/class/sensors/accelerometer", SensorType::Accelerometer},
-        {"/sys/class/sensors/gyroscope", SensorType::Gyroscope},
-        {"/sys/class/sensors/magnetometer", SensorType::Magnetometer},
-        {"/sys/class/hwmon/hwmon0/temp1_input", SensorType::Temperature},
-        {"/sys/class/power_supply/battery/temp", SensorType::Temperature},
-        {"/proc/sys/kernel/brightness", SensorType::Light}
-    };
-    
-    struct stat st;
-    for (const auto& [path, sensorType] : sensorPaths) {
-        if (stat(path.c_str(), &st) == 0) {
-            sensors.push_back(sensorType);
-        }
+std::shared_ptr<cross_terminal::hardware::II2CBus> AndroidHardwareController::openI2CBus(int bus) {
+    if (bus < 0) {
+        return nullptr;
     }
-    
-    return sensors;
+    std::lock_guard<std::mutex> lock(m_busMutex);
+    auto& open = m_i2cBuses[bus];
+    if (auto existing = open.lock()) {
+        return existing;
+    }
+    std::string error;
+    std::shared_ptr<cross_terminal::hardware::II2CBus> handle =
+        cross_terminal::hardware::LinuxI2CBus::open("/dev/i2c-" + std::to_string(bus), &error);
+    if (!handle) {
+        LOGE("Cannot open I2C bus %d: %s", bus, error.c_str());
+        m_i2cBuses.erase(bus);
+        return nullptr;
+    }
+    open = handle;
+    return handle;
+}
+
+std::shared_ptr<cross_terminal::hardware::ISPIDevice> AndroidHardwareController::openSPIDevice(int bus, int chipSelect) {
+    if (bus < 0 || chipSelect < 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_busMutex);
+    auto& open = m_spiDevices[{bus, chipSelect}];
+    if (auto existing = open.lock()) {
+        return existing;
+    }
+    std::string error;
+    std::shared_ptr<cross_terminal::hardware::ISPIDevice> handle = cross_terminal::hardware::SpidevDevice::open(
+        "/dev/spidev" + std::to_string(bus) + "." + std::to_string(chipSelect), &error);
+    if (!handle) {
+        LOGE("Cannot open SPI device %d.%d: %s", bus, chipSelect, error.c_str());
+        m_spiDevices.erase({bus, chipSelect});
+        return nullptr;
+    }
+    open = handle;
+    return handle;
+}
+
+std::vector<SensorType> AndroidHardwareController::getAvailableSensors() {
+    // Served from the capability table; no filesystem access per call
+    return m_capabilities.getAvailableSensors();
 }
 
 bool AndroidHardwareController::enableSensor(SensorType type) {
@@ -208,6 +261,26 @@ SystemMetrics AndroidHardwareController::getSystemMetrics() {
     return metrics;
 }
 
+ExtendedSystemMetrics AndroidHardwareController::getExtendedSystemMetrics() {
+    ExtendedSystemMetrics metrics;
+    ThermalSample sample;
+    m_telemetry.sample(sample);
+    
+    metrics.basic.cpuUsage = getCPUUsage();
+    metrics.basic.memoryUsage = getMemoryUsage();
+    metrics.basic.storageUsage = getStorageUsage();
+    metrics.basic.temperature = sample.hottestZone >= 0 ? sample.maxTemperature : readTemperature();
+    auto batteryInfo = getBatteryInfo();
+    metrics.basic.batteryLevel = batteryInfo.first;
+    metrics.basic.isCharging = batteryInfo.second;
+    
+    metrics.thermalZones = std::move(sample.zones);
+    metrics.cpus = std::move(sample.cpus);
+    metrics.maxTemperature = metrics.basic.temperature;
+    metrics.hottestZone = sample.hottestZone;
+    return metrics;
+}
+
 void AndroidHardwareController::startSystemMonitoring(std::function<void(const SystemMetrics&)> callback) {
     if (m_systemMonitoringActive) {
         return;
@@ -217,18 +290,29 @@ void AndroidHardwareController::startSystemMonitoring(std::function<void(const S
     m_monitoringCallback = callback;
     
     m_monitoringThread = std::thread([this]() {
+        auto registration = cross_terminal::core::ThreadRegistry::instance().enter(
+            cross_terminal::core::ThreadRole::Hardware, "ct-hw-monitor");
         while (m_systemMonitoringActive) {
             SystemMetrics metrics = getSystemMetrics();
             if (m_monitoringCallback) {
                 m_monitoringCallback(metrics);
             }
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            const auto interval = m_uevents.isRunning() ? MONITOR_INTERVAL_EVENT_DRIVEN : MONITOR_INTERVAL;
+            std::unique_lock<std::mutex> lock(m_monitoringMutex);
+            m_monitoringWake.wait_for(lock, interval, [this]() {
+                return m_powerChanged || !m_systemMonitoringActive;
+            });
+            m_powerChanged = false;
         }
     });
 }
 
 void AndroidHardwareController::stopSystemMonitoring() {
-    m_systemMonitoringActive = false;
+    {
+        std::lock_guard<std::mutex> lock(m_monitoringMutex);
+        m_systemMonitoringActive = false;
+    }
+    m_monitoringWake.notify_all();
     if (m_monitoringThread.joinable()) {
         m_monitoringThread.join();
     }
@@ -274,16 +358,13 @@ float AndroidHardwareController::getScreenBrightness() {
 }
 
 bool AndroidHardwareController::enableWiFi(bool enable) {
-    // This would typically require system-level permissions
-    // For now, we'll attempt to toggle via sysfs
-    std::string command = enable ? "svc wifi enable" : "svc wifi disable";
-    return system(command.c_str()) == 0;
+    return runDeviceControl(DeviceControlOp::SetWiFi, enable, 0,
+                            enable ? "svc wifi enable" : "svc wifi disable");
 }
 
 bool AndroidHardwareController::enableBluetooth(bool enable) {
-    // Similar to WiFi, this requires system permissions
-    std::string command = enable ? "svc bluetooth enable" : "svc bluetooth disable";
-    return system(command.c_str()) == 0;
+    return runDeviceControl(DeviceControlOp::SetBluetooth, enable, 0,
+                            enable ? "svc bluetooth enable" : "svc bluetooth disable");
 }
 
 bool AndroidHardwareController::setSystemVolume(float level) {
@@ -293,8 +374,8 @@ bool AndroidHardwareController::setSystemVolume(float level) {
     
     // Convert to Android volume scale (typically 0-15 for media)
     int volume = static_cast<int>(level * 15);
-    std::string command = "media volume --stream 3 --set " + std::to_string(volume);
-    return system(command.c_str()) == 0;
+    return runDeviceControl(DeviceControlOp::SetVolume, volume, 0,
+                            "media volume --stream 3 --set " + std::to_string(volume));
 }
 
 float AndroidHardwareController::getSystemVolume() {
@@ -304,10 +385,30 @@ float AndroidHardwareController::getSystemVolume() {
 }
 
 bool AndroidHardwareController::playBeep(int frequency, int duration) {
-    // Generate a simple beep using the speaker
-    // This is a simplified implementation
-    std::string command = "echo -e '\\a'";
-    return system(command.c_str()) == 0;
+    if (frequency <= 0 || duration <= 0) {
+        return false;
+    }
+    if (m_tones.hasSink()) {
+        // Queued for the tone thread; returns before the beep is heard
+        ToneSegment tone;
+        tone.frequency = static_cast<float>(frequency);
+        tone.durationMs = static_cast<uint32_t>(duration);
+        return m_tones.play({tone});
+    }
+    // No AAudio (before Android 8.0): terminal bell
+    return runDeviceControl(DeviceControlOp::Beep, frequency, duration, "echo -e '\\a'");
+}
+
+bool AndroidHardwareController::runDeviceControl(DeviceControlOp op, int32_t arg0, int32_t arg1,
+                                                 const std::string& fallback) {
+    int status = m_deviceControl.call(op, arg0, arg1);
+    if (status != ENOTCONN) {
+        if (status != 0) {
+            LOGE("Device control request %d failed: %s", static_cast<int>(op), strerror(status));
+        }
+        return status == 0;
+    }
+    return system(fallback.c_str()) == 0;
 }
 
 float AndroidHardwareController::getCPUUsage() {
@@ -384,7 +485,15 @@ float AndroidHardwareController::getStorageUsage() {
 }
 
 float AndroidHardwareController::readTemperature() {
-    // Try reading from various temperature sensors
+    // Hottest thermal zone, so a throttling core is not hidden behind a
+    // cool battery or skin sensor
+    ThermalSample sample;
+    m_telemetry.sample(sample, true);
+    if (sample.hottestZone >= 0) {
+        return sample.maxTemperature;
+    }
+    
+    // No readable zones: try other temperature sensors
     const std::vector<std::string> tempPaths = {
         "/sys/class/hwmon/hwmon0/temp1_input",
         "/sys/class/thermal/thermal_zone0/temp",
@@ -406,6 +515,12 @@ float AndroidHardwareController::readTemperature() {
 }
 
 std::pair<float, bool> AndroidHardwareController::getBatteryInfo() {
+    if (m_uevents.isRunning()) {
+        // Kept current by power_supply uevents
+        PowerState state = m_power.getState();
+        return {state.batteryLevel, state.isCharging};
+    }
+    
     float level = 50.0f; // Default
     bool charging = false;
     
@@ -1,10 +1,19 @@
 #pragma once
 
 #include "../hardware_controller.h"
+#include "../device_capabilities.h"
+#include "../device_control_helper.h"
+#include "../hardware_bus.h"
+#include "../power_state_monitor.h"
+#include "../thermal_telemetry.h"
+#include "../tone_synth.h"
+#include "../uevent_monitor.h"
 #include <map>
 #include <set>
 #include <thread>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <sys/statvfs.h>
 
 class AndroidHardwareController : public HardwareController {
@@ -18,6 +27,10 @@ public:
     bool writeGPIO(int pin, bool high) override;
     bool readGPIO(int pin) override;
     
+    // Bus access through /dev/i2c-N and /dev/spidevB.C
+    std::shared_ptr<cross_terminal::hardware::II2CBus> openI2CBus(int bus) override;
+    std::shared_ptr<cross_terminal::hardware::ISPIDevice> openSPIDevice(int bus, int chipSelect) override;
+    
     // Sensor access
     std::vector<SensorType> getAvailableSensors() override;
     bool enableSensor(SensorType type) override;
@@ -28,6 +41,7 @@ public:
     SystemMetrics getSystemMetrics() override;
     void startSystemMonitoring(std::function<void(const SystemMetrics&)> callback) override;
     void stopSystemMonitoring() override;
+    ExtendedSystemMetrics getExtendedSystemMetrics() override;
     
     // Device control
     bool setScreenBrightness(float level) override;
@@ -44,12 +58,38 @@ private:
     std::map<int, GPIOMode> m_configuredPins;
     std::set<SensorType> m_enabledSensors;
     
+    // Open buses, shared by every caller until the last handle is dropped
+    std::map<int, std::weak_ptr<cross_terminal::hardware::II2CBus>> m_i2cBuses;
+    std::map<std::pair<int, int>, std::weak_ptr<cross_terminal::hardware::ISPIDevice>> m_spiDevices;
+    std::mutex m_busMutex;
+    
+    // Discovered once, refreshed on hotplug; battery state pushed by the
+    // kernel. The monitor is declared last so it stops before the state
+    // it feeds is destroyed.
+    DeviceCapabilityTable m_capabilities;
+    PowerStateMonitor m_power;
+    UeventMonitor m_uevents;
+    
+    // Thermal zones and cpufreq, attributes held open between samples
+    ThermalTelemetry m_telemetry;
+    
+    // Privileged helper for radio and volume control, started on first use
+    DeviceControlClient m_deviceControl;
+    
+    // Beeps synthesized in-process into AAudio
+    TonePlayer m_tones;
+    
     // System monitoring
     std::atomic<bool> m_systemMonitoringActive;
     std::thread m_monitoringThread;
     std::function<void(const SystemMetrics&)> m_monitoringCallback;
+    std::mutex m_monitoringMutex;
+    std::condition_variable m_monitoringWake;
+    bool m_powerChanged = false;   // Sample now instead of at the next interval
     
     // Helper methods
+    // Through the helper; one shell per call when no helper is installed
+    bool runDeviceControl(DeviceControlOp op, int32_t arg0, int32_t arg1, const std::string& fallback);
     float getCPUUsage();
     float getMemoryUsage();
     float getStorageUsage();
@@ -0,0 +1,313 @@
+#include "device_capabilities.h"
+#include "uevent_monitor.h"
+#include <algorithm>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr const char* SUBSYSTEM_NAMES[] = {"thermal", "power_supply", "hwmon", "iio", "sensors"};
+
+constexpr uint32_t bit(SensorType type) {
+    return 1u << static_cast<uint32_t>(type);
+}
+
+// Entries of a directory starting with prefix, sorted; empty if missing
+std::vector<std::string> listDirectory(const std::string& path, const char* prefix = "") {
+    std::vector<std::string> names;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return names;
+    }
+    const size_t prefixLength = strlen(prefix);
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.' && strncmp(entry->d_name, prefix, prefixLength) == 0) {
+            names.emplace_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool exists(const std::string& path) {
+    return access(path.c_str(), F_OK) == 0;
+}
+
+// First line of a small attribute file, without the newline
+std::string readLine(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::string();
+    }
+    char buffer[128];
+    ssize_t n = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    close(fd);
+    if (n <= 0) {
+        return std::string();
+    }
+    std::string line(buffer, static_cast<size_t>(n));
+    size_t newline = line.find('\n');
+    if (newline != std::string::npos) {
+        line.resize(newline);
+    }
+    return line;
+}
+
+// IIO channel attribute prefixes and the sensor each indicates
+const std::pair<const char*, SensorType> IIO_CHANNELS[] = {
+    {"in_accel_", SensorType::Accelerometer},
+    {"in_anglvel_", SensorType::Gyroscope},
+    {"in_magn_", SensorType::Magnetometer},
+    {"in_temp", SensorType::Temperature},
+    {"in_humidityrelative", SensorType::Humidity},
+    {"in_pressure", SensorType::Pressure},
+    {"in_illuminance", SensorType::Light},
+    {"in_intensity", SensorType::Light},
+    {"in_proximity", SensorType::Proximity},
+};
+
+// Vendor sensor class devices (/sys/class/sensors/<name>)
+const std::pair<const char*, SensorType> CLASS_SENSORS[] = {
+    {"accelerometer", SensorType::Accelerometer},
+    {"gyroscope", SensorType::Gyroscope},
+    {"magnetometer", SensorType::Magnetometer},
+    {"light", SensorType::Light},
+    {"proximity", SensorType::Proximity},
+    {"pressure", SensorType::Pressure},
+};
+
+} // namespace
+
+DeviceCapabilityTable::DeviceCapabilityTable(std::string sysfsRoot, std::string procRoot)
+    : m_sysfsRoot(std::move(sysfsRoot))
+    , m_procRoot(std::move(procRoot))
+    , m_snapshot(std::make_shared<DeviceCapabilities>()) {
+}
+
+DeviceCapabilityTable::~DeviceCapabilityTable() {
+    detach();
+}
+
+void DeviceCapabilityTable::refresh() {
+    std::shared_ptr<const DeviceCapabilities> published;
+    ChangeCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(m_scanMutex);
+        for (int subsystem = 0; subsystem < SubsystemCount; ++subsystem) {
+            scanLocked(static_cast<Subsystem>(subsystem));
+        }
+        // Display brightness control, reported as a light sensor since the
+        // first Android builds; not hotpluggable
+        m_staticBits = exists(m_procRoot + "/sys/kernel/brightness") ? bit(SensorType::Light) : 0;
+        published = publishLocked();
+        callback = m_changeCallback;
+    }
+    if (published && callback) {
+        callback(*published);
+    }
+}
+
+bool DeviceCapabilityTable::refresh(const std::string& subsystem) {
+    int index = subsystemIndex(subsystem);
+    if (index < 0) {
+        return false;
+    }
+    std::shared_ptr<const DeviceCapabilities> published;
+    ChangeCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(m_scanMutex);
+        scanLocked(static_cast<Subsystem>(index));
+        published = publishLocked();
+        callback = m_changeCallback;
+    }
+    if (published && callback) {
+        callback(*published);
+    }
+    return true;
+}
+
+std::shared_ptr<const DeviceCapabilities> DeviceCapabilityTable::snapshot() const {
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    return m_snapshot;
+}
+
+std::vector<SensorType> DeviceCapabilityTable::getAvailableSensors() const {
+    return snapshot()->sensors;
+}
+
+bool DeviceCapabilityTable::hasSensor(SensorType type) const {
+    auto table = snapshot();
+    return std::find(table->sensors.begin(), table->sensors.end(), type) != table->sensors.end();
+}
+
+void DeviceCapabilityTable::attach(UeventMonitor& monitor) {
+    detach();
+    // One subscription for all subsystems, so a resync rescans once
+    int id = monitor.subscribe("", [this](const UeventMessage& message) { onUevent(message); });
+    std::lock_guard<std::mutex> lock(m_scanMutex);
+    m_monitor = &monitor;
+    m_subscription = id;
+}
+
+void DeviceCapabilityTable::detach() {
+    UeventMonitor* monitor;
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(m_scanMutex);
+        monitor = m_monitor;
+        id = m_subscription;
+        m_monitor = nullptr;
+        m_subscription = 0;
+    }
+    if (monitor) {
+        monitor->unsubscribe(id);
+    }
+}
+
+void DeviceCapabilityTable::setChangeCallback(ChangeCallback callback) {
+    std::lock_guard<std::mutex> lock(m_scanMutex);
+    m_changeCallback = std::move(callback);
+}
+
+uint64_t DeviceCapabilityTable::getScanCount() const {
+    return m_scans;
+}
+
+void DeviceCapabilityTable::onUevent(const UeventMessage& message) {
+    if (message.action == UeventMonitor::RESYNC_ACTION) {
+        refresh();
+    } else if (message.changesTopology()) {
+        refresh(message.subsystem);   // Untracked subsystems are ignored
+    }
+}
+
+int DeviceCapabilityTable::subsystemIndex(const std::string& name) {
+    for (int i = 0; i < SubsystemCount; ++i) {
+        if (name == SUBSYSTEM_NAMES[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void DeviceCapabilityTable::scanLocked(Subsystem subsystem) {
+    ++m_scans;
+    uint32_t bits = 0;
+
+    switch (subsystem) {
+        case Thermal: {
+            const std::string root = m_sysfsRoot + "/class/thermal/";
+            m_thermalZones.clear();
+            for (const auto& name : listDirectory(root, "thermal_zone")) {
+                ThermalZoneInfo zone;
+                zone.index = atoi(name.c_str() + strlen("thermal_zone"));
+                zone.path = root + name;
+                zone.type = readLine(zone.path + "/type");
+                m_thermalZones.push_back(std::move(zone));
+            }
+            std::sort(m_thermalZones.begin(), m_thermalZones.end(),
+                      [](const ThermalZoneInfo& a, const ThermalZoneInfo& b) { return a.index < b.index; });
+            bits = m_thermalZones.empty() ? 0 : bit(SensorType::Temperature);
+            break;
+        }
+        case PowerSupply: {
+            const std::string root = m_sysfsRoot + "/class/power_supply/";
+            m_powerSupplies.clear();
+            for (const auto& name : listDirectory(root)) {
+                PowerSupplyInfo supply;
+                supply.name = name;
+                supply.path = root + name;
+                supply.type = readLine(supply.path + "/type");
+                supply.hasTemperature = exists(supply.path + "/temp");
+                if (supply.hasTemperature) {
+                    bits |= bit(SensorType::Temperature);
+                }
+                m_powerSupplies.push_back(std::move(supply));
+            }
+            break;
+        }
+        case Hwmon: {
+            const std::string root = m_sysfsRoot + "/class/hwmon/";
+            m_hwmonTemperatures.clear();
+            for (const auto& device : listDirectory(root, "hwmon")) {
+                for (const auto& attribute : listDirectory(root + device, "temp")) {
+                    const size_t length = attribute.size();
+                    if (length > 6 && attribute.compare(length - 6, 6, "_input") == 0) {
+                        m_hwmonTemperatures.push_back(root + device + "/" + attribute);
+                    }
+                }
+            }
+            bits = m_hwmonTemperatures.empty() ? 0 : bit(SensorType::Temperature);
+            break;
+        }
+        case IIO: {
+            const std::string root = m_sysfsRoot + "/bus/iio/devices/";
+            for (const auto& device : listDirectory(root, "iio:device")) {
+                for (const auto& attribute : listDirectory(root + device, "in_")) {
+                    for (const auto& channel : IIO_CHANNELS) {
+                        if (attribute.compare(0, strlen(channel.first), channel.first) == 0) {
+                            bits |= bit(channel.second);
+                        }
+                    }
+                }
+            }
+            break;
+        }
+        case SensorClass: {
+            const std::string root = m_sysfsRoot + "/class/sensors/";
+            for (const auto& name : listDirectory(root)) {
+                for (const auto& sensor : CLASS_SENSORS) {
+                    if (name.find(sensor.first) != std::string::npos) {
+                        bits |= bit(sensor.second);
+                    }
+                }
+            }
+            break;
+        }
+        case SubsystemCount:
+            break;
+    }
+
+    m_sensorBits[subsystem] = bits;
+}
+
+std::shared_ptr<const DeviceCapabilities> DeviceCapabilityTable::publishLocked() {
+    uint32_t bits = m_staticBits;
+    for (uint32_t subsystemBits : m_sensorBits) {
+        bits |= subsystemBits;
+    }
+
+    auto table = std::make_shared<DeviceCapabilities>();
+    for (uint32_t type = 0; type <= static_cast<uint32_t>(SensorType::Proximity); ++type) {
+        if (bits & (1u << type)) {
+            table->sensors.push_back(static_cast<SensorType>(type));
+        }
+    }
+    table->thermalZones = m_thermalZones;
+    table->powerSupplies = m_powerSupplies;
+    table->hwmonTemperatures = m_hwmonTemperatures;
+
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    const DeviceCapabilities& current = *m_snapshot;
+    auto sameZone = [](const ThermalZoneInfo& a, const ThermalZoneInfo& b) {
+        return a.index == b.index && a.type == b.type;
+    };
+    auto sameSupply = [](const PowerSupplyInfo& a, const PowerSupplyInfo& b) {
+        return a.name == b.name && a.type == b.type && a.hasTemperature == b.hasTemperature;
+    };
+    if (current.generation != 0 &&
+        table->sensors == current.sensors &&
+        table->hwmonTemperatures == current.hwmonTemperatures &&
+        std::equal(table->thermalZones.begin(), table->thermalZones.end(),
+                   current.thermalZones.begin(), current.thermalZones.end(), sameZone) &&
+        std::equal(table->powerSupplies.begin(), table->powerSupplies.end(),
+                   current.powerSupplies.begin(), current.powerSupplies.end(), sameSupply)) {
+        return nullptr;
+    }
+    table->generation = current.generation + 1;
+    m_snapshot = table;
+    return table;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "hardware_controller.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class UeventMonitor;
+struct UeventMessage;
+
+// Cached table of the sensors, thermal zones and power supplies a device
+// exposes through sysfs.
+//
+// Discovery walks /sys/class/{thermal,power_supply,hwmon,sensors} and
+// /sys/bus/iio/devices once, at startup. Readers get an immutable snapshot
+// (a shared_ptr copy, no filesystem access), so polling for available
+// sensors from the UI is free. Once attached to a UeventMonitor, an add or
+// remove event rescans only the affected subsystem and publishes a new
+// snapshot; state-only "change" events (battery level, trip crossings) are
+// ignored.
+
+struct ThermalZoneInfo {
+    int index = -1;          // N in thermal_zoneN
+    std::string type;        // e.g. cpu-0-0, battery, skin-therm
+    std::string path;        // Zone directory
+};
+
+struct PowerSupplyInfo {
+    std::string name;        // e.g. battery, usb, ac
+    std::string type;        // Battery, USB, Mains, Wireless, ...
+    std::string path;        // Supply directory
+    bool hasTemperature = false;
+};
+
+struct DeviceCapabilities {
+    std::vector<SensorType> sensors;              // Available types, each once, in enum order
+    std::vector<ThermalZoneInfo> thermalZones;    // By zone index
+    std::vector<PowerSupplyInfo> powerSupplies;   // By name
+    std::vector<std::string> hwmonTemperatures;   // temp*_input attribute paths
+    uint64_t generation = 0;                      // Incremented on every publish
+};
+
+class DeviceCapabilityTable {
+public:
+    using ChangeCallback = std::function<void(const DeviceCapabilities&)>;
+
+    explicit DeviceCapabilityTable(std::string sysfsRoot = "/sys", std::string procRoot = "/proc");
+    ~DeviceCapabilityTable();
+
+    DeviceCapabilityTable(const DeviceCapabilityTable&) = delete;
+    DeviceCapabilityTable& operator=(const DeviceCapabilityTable&) = delete;
+
+    // Rescan every tracked subsystem
+    void refresh();
+    // Rescan one subsystem (thermal, power_supply, hwmon, iio, sensors).
+    // Returns false if the subsystem is not tracked.
+    bool refresh(const std::string& subsystem);
+
+    // Current table; never null, cheap enough to call per frame
+    std::shared_ptr<const DeviceCapabilities> snapshot() const;
+    std::vector<SensorType> getAvailableSensors() const;
+    bool hasSensor(SensorType type) const;
+
+    // Follow hotplug events of the tracked subsystems. detach() (or
+    // destruction) ends it but does not wait for an event being handled,
+    // so stop the monitor before destroying an attached table.
+    void attach(UeventMonitor& monitor);
+    void detach();
+
+    // Called after a rescan publishes a table that differs from the last,
+    // on the thread that ran the rescan (the uevent thread when attached)
+    void setChangeCallback(ChangeCallback callback);
+
+    // Subsystem scans performed, for metrics and tests
+    uint64_t getScanCount() const;
+
+private:
+    enum Subsystem {
+        Thermal,
+        PowerSupply,
+        Hwmon,
+        IIO,
+        SensorClass,
+        SubsystemCount
+    };
+
+    const std::string m_sysfsRoot;
+    const std::string m_procRoot;
+
+    // Serializes scans; readers only take m_snapshotMutex
+    std::mutex m_scanMutex;
+    std::vector<ThermalZoneInfo> m_thermalZones;
+    std::vector<PowerSupplyInfo> m_powerSupplies;
+    std::vector<std::string> m_hwmonTemperatures;
+    uint32_t m_sensorBits[SubsystemCount] = {};   // 1 << SensorType, per subsystem
+    uint32_t m_staticBits = 0;                    // Non-hotpluggable sources
+    ChangeCallback m_changeCallback;
+
+    mutable std::mutex m_snapshotMutex;
+    std::shared_ptr<const DeviceCapabilities> m_snapshot;
+
+    UeventMonitor* m_monitor = nullptr;
+    int m_subscription = 0;
+    std::atomic<uint64_t> m_scans{0};
+
+    void scanLocked(Subsystem subsystem);
+    // Returns the new table, or null if it matches the published one
+    std::shared_ptr<const DeviceCapabilities> publishLocked();
+    void onUevent(const UeventMessage& message);
+    static int subsystemIndex(const std::string& name);
+};
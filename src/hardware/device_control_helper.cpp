@@ -0,0 +1,335 @@
+#include "device_control_helper.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+// How long a helper gets to exit after its socket closes before SIGKILL
+constexpr auto EXIT_GRACE = std::chrono::milliseconds(500);
+
+constexpr const char* HELPER_NAME = "libct_device_helper.so";
+constexpr const char* SU_PATHS[] = {"/system/bin/su", "/system/xbin/su", "/sbin/su"};
+
+// Run argv to completion without a shell. Called in the helper, which is
+// single-threaded, so a plain fork is safe.
+int runCommand(std::vector<std::string> args) {
+    std::vector<char*> argv;
+    argv.reserve(args.size() + 1);
+    for (auto& arg : args) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+
+    pid_t child = fork();
+    if (child < 0) {
+        return errno;
+    }
+    if (child == 0) {
+        // Keep the command off the request socket
+        int null = open("/dev/null", O_RDWR);
+        if (null >= 0) {
+            dup2(null, STDIN_FILENO);
+            dup2(null, STDOUT_FILENO);
+        }
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    int status = 0;
+    while (waitpid(child, &status, 0) < 0) {
+        if (errno != EINTR) {
+            return errno;
+        }
+    }
+    if (!WIFEXITED(status)) {
+        return EINTR;
+    }
+    switch (WEXITSTATUS(status)) {
+        case 0:
+            return 0;
+        case 127:
+            return ENOENT;
+        default:
+            return EIO;
+    }
+}
+
+int dispatch(const DeviceControlRequest& request, const DeviceControlHandlers& handlers) {
+    switch (static_cast<DeviceControlOp>(request.op)) {
+        case DeviceControlOp::Ping:
+            return 0;
+        case DeviceControlOp::SetWiFi:
+            return handlers.setWiFi ? handlers.setWiFi(request.arg0 != 0) : ENOSYS;
+        case DeviceControlOp::SetBluetooth:
+            return handlers.setBluetooth ? handlers.setBluetooth(request.arg0 != 0) : ENOSYS;
+        case DeviceControlOp::SetVolume:
+            return handlers.setVolume ? handlers.setVolume(request.arg0) : ENOSYS;
+        case DeviceControlOp::Beep:
+            return handlers.beep ? handlers.beep(request.arg0, request.arg1) : ENOSYS;
+    }
+    return ENOSYS;
+}
+
+} // namespace
+
+DeviceControlHandlers DeviceControlHandlers::commands() {
+    DeviceControlHandlers handlers;
+    handlers.setWiFi = [](bool enable) {
+        return runCommand({"svc", "wifi", enable ? "enable" : "disable"});
+    };
+    handlers.setBluetooth = [](bool enable) {
+        return runCommand({"svc", "bluetooth", enable ? "enable" : "disable"});
+    };
+    handlers.setVolume = [](int volume) {
+        if (volume < 0 || volume > 15) {
+            return EINVAL;
+        }
+        return runCommand({"media", "volume", "--stream", "3", "--set", std::to_string(volume)});
+    };
+    handlers.beep = [](int, int) {
+        // Terminal bell on the helper's inherited stderr, as before
+        return ::write(STDERR_FILENO, "\a", 1) == 1 ? 0 : errno;
+    };
+    return handlers;
+}
+
+int DeviceControlServer::serve(int fd, const DeviceControlHandlers& handlers) {
+    for (;;) {
+        DeviceControlRequest request = {};
+        ssize_t n = recv(fd, &request, sizeof(request), 0);
+        if (n == 0) {
+            return 0;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+
+        DeviceControlResponse response = {request.sequence, EPROTO};
+        if (n == static_cast<ssize_t>(sizeof(request)) && request.version == PROTOCOL_VERSION) {
+            response.status = dispatch(request, handlers);
+        }
+        if (send(fd, &response, sizeof(response), MSG_NOSIGNAL) < 0) {
+            return errno == EPIPE ? 0 : errno;
+        }
+    }
+}
+
+DeviceControlClient::DeviceControlClient(std::vector<std::string> helperCommand)
+    : m_command(std::move(helperCommand)) {
+}
+
+DeviceControlClient::~DeviceControlClient() {
+    stop();
+}
+
+bool DeviceControlClient::start(std::string* error) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_fd >= 0) {
+        return true;
+    }
+    m_launchFailed = false;
+    return launchLocked(error);
+}
+
+void DeviceControlClient::attach(int fd) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    closeLocked();
+    m_fd = fd;
+}
+
+void DeviceControlClient::stop() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    closeLocked();
+}
+
+bool DeviceControlClient::isRunning() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fd >= 0;
+}
+
+uint64_t DeviceControlClient::getRestarts() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_restarts;
+}
+
+int DeviceControlClient::call(DeviceControlOp op, int32_t arg0, int32_t arg1, int timeoutMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_fd < 0 && (m_launchFailed || !launchLocked(nullptr))) {
+        return ENOTCONN;
+    }
+    int status = transactLocked(op, arg0, arg1, timeoutMs);
+    if ((status == EPIPE || status == ECONNRESET) && !m_command.empty() && launchLocked(nullptr)) {
+        status = transactLocked(op, arg0, arg1, timeoutMs);
+    }
+    return status;
+}
+
+bool DeviceControlClient::launchLocked(std::string* error) {
+    auto fail = [this, error](const std::string& what) {
+        if (error) {
+            *error = what;
+        }
+        m_launchFailed = true;
+        return false;
+    };
+    if (m_command.empty()) {
+        return fail("no helper command");
+    }
+    closeLocked();
+
+    // Build argv before fork(): only async-signal-safe calls in the child
+    std::vector<char*> argv;
+    argv.reserve(m_command.size() + 1);
+    for (const auto& arg : m_command) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != 0) {
+        return fail(std::string("socketpair: ") + strerror(errno));
+    }
+    pid_t child = fork();
+    if (child < 0) {
+        int code = errno;
+        ::close(sockets[0]);
+        ::close(sockets[1]);
+        return fail(std::string("fork: ") + strerror(code));
+    }
+    if (child == 0) {
+        // dup2 clears close-on-exec on the copies
+        dup2(sockets[1], STDIN_FILENO);
+        dup2(sockets[1], STDOUT_FILENO);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    ::close(sockets[1]);
+    m_fd = sockets[0];
+    m_pid = child;
+
+    // A helper that failed to exec, or su that refused, closes the socket
+    int status = transactLocked(DeviceControlOp::Ping, 0, 0, LAUNCH_TIMEOUT_MS);
+    if (status != 0) {
+        closeLocked();
+        return fail(m_command[0] + " did not answer: " + strerror(status));
+    }
+    if (m_launched) {
+        ++m_restarts;
+    }
+    m_launched = true;
+    m_launchFailed = false;
+    return true;
+}
+
+int DeviceControlClient::transactLocked(DeviceControlOp op, int32_t arg0, int32_t arg1, int timeoutMs) {
+    if (m_fd < 0) {
+        return ENOTCONN;
+    }
+    DeviceControlRequest request = {};
+    request.version = DeviceControlServer::PROTOCOL_VERSION;
+    request.op = static_cast<uint16_t>(op);
+    request.sequence = ++m_sequence;
+    request.arg0 = arg0;
+    request.arg1 = arg1;
+
+    auto helperGone = [this](int code) {
+        closeLocked();
+        return code;
+    };
+    if (send(m_fd, &request, sizeof(request), MSG_NOSIGNAL) < 0) {
+        return errno == EPIPE || errno == ECONNRESET ? helperGone(EPIPE) : errno;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            return ETIMEDOUT;
+        }
+        pollfd fd = {m_fd, POLLIN, 0};
+        int ready = poll(&fd, 1, static_cast<int>(remaining));
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        if (ready == 0) {
+            return ETIMEDOUT;
+        }
+
+        DeviceControlResponse response = {};
+        ssize_t n = recv(m_fd, &response, sizeof(response), 0);
+        if (n == 0 || (n < 0 && errno == ECONNRESET)) {
+            return helperGone(EPIPE);
+        }
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            return errno;
+        }
+        if (n != static_cast<ssize_t>(sizeof(response))) {
+            return EPROTO;
+        }
+        if (response.sequence == request.sequence) {
+            return response.status;
+        }
+        // The late answer to a request that timed out; keep waiting
+    }
+}
+
+void DeviceControlClient::closeLocked() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    if (m_pid <= 0) {
+        return;
+    }
+    // The helper exits once it sees the socket close; one still running a
+    // command gets a short grace period
+    const auto deadline = std::chrono::steady_clock::now() + EXIT_GRACE;
+    while (waitpid(m_pid, nullptr, WNOHANG) == 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            kill(m_pid, SIGKILL);
+            waitpid(m_pid, nullptr, 0);
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    m_pid = -1;
+}
+
+std::vector<std::string> DeviceControlClient::defaultCommand() {
+    // The helper ships in the app's native library directory, next to the
+    // library containing this function
+    Dl_info info = {};
+    if (!dladdr(reinterpret_cast<void*>(&DeviceControlClient::defaultCommand), &info) || !info.dli_fname) {
+        return {};
+    }
+    std::string path(info.dli_fname);
+    size_t slash = path.rfind('/');
+    path = (slash == std::string::npos ? std::string(".") : path.substr(0, slash)) + "/" + HELPER_NAME;
+    if (access(path.c_str(), X_OK) != 0) {
+        return {};
+    }
+    for (const char* su : SU_PATHS) {
+        if (access(su, X_OK) == 0) {
+            return {su, "-c", path};
+        }
+    }
+    return {path};
+}
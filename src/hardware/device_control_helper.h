@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+// Device control requests served by a long-lived helper process.
+//
+// Toggling radios or the volume needs a command with system privileges.
+// Running each one through system() costs a /bin/sh fork+exec plus the
+// command itself per call (hundreds of ms on Android). Instead,
+// DeviceControlClient starts the helper once, through su where it
+// exists, and sends it fixed-size binary requests over a SOCK_SEQPACKET
+// socketpair. The helper (DeviceControlServer::serve(), all of
+// ct_device_helper's main) runs the request and answers with a status,
+// so a call costs one round trip plus the work itself.
+
+enum class DeviceControlOp : uint16_t {
+    Ping = 0,
+    SetWiFi = 1,        // arg0: enable
+    SetBluetooth = 2,   // arg0: enable
+    SetVolume = 3,      // arg0: media stream index, 0-15
+    Beep = 4            // arg0: frequency Hz, arg1: duration ms
+};
+
+struct DeviceControlRequest {
+    uint16_t version;
+    uint16_t op;
+    uint32_t sequence;
+    int32_t arg0;
+    int32_t arg1;
+};
+
+struct DeviceControlResponse {
+    uint32_t sequence;
+    int32_t status;     // 0 or an errno value
+};
+
+// What the helper does for each request; an unset handler answers ENOSYS.
+// Handlers return 0 or an errno value.
+struct DeviceControlHandlers {
+    std::function<int(bool enable)> setWiFi;
+    std::function<int(bool enable)> setBluetooth;
+    std::function<int(int volume)> setVolume;
+    std::function<int(int frequency, int duration)> beep;
+
+    // Handlers that run the platform's control commands (svc, media)
+    // directly with fork/exec, without a shell
+    static DeviceControlHandlers commands();
+};
+
+class DeviceControlServer {
+public:
+    static constexpr uint16_t PROTOCOL_VERSION = 1;
+
+    // Answer requests on fd until the client closes it. Returns 0 then,
+    // or the errno that ended the loop.
+    static int serve(int fd, const DeviceControlHandlers& handlers);
+};
+
+class DeviceControlClient {
+public:
+    static constexpr int DEFAULT_TIMEOUT_MS = 5000;
+    // First contact includes su's own startup and any grant prompt
+    static constexpr int LAUNCH_TIMEOUT_MS = 15000;
+
+    // helperCommand is the argv that starts the helper with the socket on
+    // its stdin/stdout; empty for a client that only attach()es
+    explicit DeviceControlClient(std::vector<std::string> helperCommand = {});
+    ~DeviceControlClient();
+
+    DeviceControlClient(const DeviceControlClient&) = delete;
+    DeviceControlClient& operator=(const DeviceControlClient&) = delete;
+
+    // Launch the helper and wait for it to answer a ping. call() does this
+    // on first use; a failed launch is not retried until start() is called.
+    bool start(std::string* error = nullptr);
+    // Use an already connected socket (an in-process or test helper);
+    // takes ownership of fd
+    void attach(int fd);
+    void stop();
+    bool isRunning() const;
+
+    // Send one request and wait for its answer. Returns 0 or an errno
+    // value: ENOTCONN without a helper, ETIMEDOUT if it did not answer in
+    // time (a late answer is discarded). A helper that died is relaunched
+    // once and the request resent; every op is idempotent.
+    int call(DeviceControlOp op, int32_t arg0 = 0, int32_t arg1 = 0,
+             int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    // Helpers launched after the first, for metrics and tests
+    uint64_t getRestarts() const;
+
+    // ct_device_helper installed next to this library, run through su when
+    // present; empty if the helper is not installed
+    static std::vector<std::string> defaultCommand();
+
+private:
+    const std::vector<std::string> m_command;
+
+    mutable std::mutex m_mutex;
+    int m_fd = -1;
+    pid_t m_pid = -1;
+    uint32_t m_sequence = 0;
+    bool m_launchFailed = false;
+    bool m_launched = false;
+    uint64_t m_restarts = 0;
+
+    bool launchLocked(std::string* error);
+    int transactLocked(DeviceControlOp op, int32_t arg0, int32_t arg1, int timeoutMs);
+    void closeLocked();
+};
@@ -0,0 +1,11 @@
+// ct_device_helper: the long-lived device control helper.
+//
+// Started by DeviceControlClient with its request socket on stdin and
+// stdout; serves requests until the client closes it.
+
+#include "device_control_helper.h"
+#include <unistd.h>
+
+int main() {
+    return DeviceControlServer::serve(STDIN_FILENO, DeviceControlHandlers::commands()) == 0 ? 0 : 1;
+}
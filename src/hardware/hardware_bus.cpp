@@ -0,0 +1,367 @@
+#include "hardware_bus.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <linux/spi/spidev.h>
+#include <sys/ioctl.h>
+#endif
+
+namespace cross_terminal {
+namespace hardware {
+
+namespace {
+
+#ifdef __linux__
+// SPI_IOC_MESSAGE(n) needs n at compile time; the size field holds
+// 14 bits, which bounds a message to 511 transfers
+constexpr size_t SPI_MAX_TRANSFERS = ((1u << _IOC_SIZEBITS) - 1) / sizeof(spi_ioc_transfer);
+
+unsigned long spiMessageRequest(size_t count) {
+    return _IOC(_IOC_WRITE, SPI_IOC_MAGIC, 0, count * sizeof(spi_ioc_transfer));
+}
+
+// spidev bounces every message through a buffer of this many bytes
+size_t spidevBufferSize() {
+    FILE* file = fopen("/sys/module/spidev/parameters/bufsiz", "r");
+    unsigned long size = 0;
+    if (file) {
+        if (fscanf(file, "%lu", &size) != 1) {
+            size = 0;
+        }
+        fclose(file);
+    }
+    return size ? size : 4096;
+}
+#endif
+
+int openNode(const std::string& path, std::string* error) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0 && error) {
+        *error = path + ": " + strerror(errno);
+    }
+    return fd;
+}
+
+} // namespace
+
+void I2CBatch::add(uint16_t address, bool read, uint8_t* data, uint16_t length) {
+    Pending pending;
+    pending.message.address = address;
+    pending.message.read = read;
+    pending.message.data = data;
+    pending.message.length = length;
+    messages_.push_back(pending);
+}
+
+void I2CBatch::addOwned(uint16_t address, uint8_t prefix, bool has_prefix,
+                        const uint8_t* data, uint16_t length) {
+    Pending pending;
+    pending.message.address = address;
+    pending.message.length = static_cast<uint16_t>(length + (has_prefix ? 1 : 0));
+    pending.offset = storage_.size();
+    pending.owned = true;
+    if (has_prefix) {
+        storage_.push_back(prefix);
+    }
+    storage_.insert(storage_.end(), data, data + length);
+    messages_.push_back(pending);
+}
+
+void I2CBatch::readRegisters(uint16_t address, uint8_t reg, uint8_t* out, uint16_t length) {
+    accesses_.push_back(messages_.size());
+    addOwned(address, reg, true, nullptr, 0);
+    add(address, true, out, length);
+}
+
+void I2CBatch::writeRegisters(uint16_t address, uint8_t reg, const uint8_t* data, uint16_t length) {
+    accesses_.push_back(messages_.size());
+    addOwned(address, reg, true, data, length);
+}
+
+void I2CBatch::read(uint16_t address, uint8_t* out, uint16_t length) {
+    accesses_.push_back(messages_.size());
+    add(address, true, out, length);
+}
+
+void I2CBatch::write(uint16_t address, const uint8_t* data, uint16_t length) {
+    accesses_.push_back(messages_.size());
+    addOwned(address, 0, false, data, length);
+}
+
+bool I2CBatch::execute(II2CBus& bus) {
+    completed_ = 0;
+    transactions_ = 0;
+
+    // storage_ no longer grows, so pointers into it are stable from here
+    resolved_.clear();
+    resolved_.reserve(messages_.size());
+    for (auto& pending : messages_) {
+        resolved_.push_back(pending.message);
+        if (pending.owned) {
+            resolved_.back().data = storage_.data() + pending.offset;
+        }
+    }
+
+    const size_t limit = bus.maxMessagesPerTransfer();
+    size_t access = 0;
+    while (access < accesses_.size()) {
+        // Pack whole accesses until the next one would exceed the limit
+        const size_t first = accesses_[access];
+        size_t end_access = access;
+        size_t end_message = first;
+        while (end_access < accesses_.size()) {
+            size_t next = end_access + 1 < accesses_.size() ? accesses_[end_access + 1] : messages_.size();
+            if (next - first > limit) {
+                break;
+            }
+            end_message = next;
+            ++end_access;
+        }
+        if (end_access == access) {
+            return false;   // A single access needs more messages than the bus allows
+        }
+
+        ++transactions_;
+        if (!bus.transfer(resolved_.data() + first, end_message - first)) {
+            return false;
+        }
+        completed_ += end_access - access;
+        access = end_access;
+    }
+    return true;
+}
+
+void I2CBatch::clear() noexcept {
+    messages_.clear();
+    accesses_.clear();
+    storage_.clear();
+    completed_ = 0;
+    transactions_ = 0;
+}
+
+void SPIBatch::add(const uint8_t* tx, uint8_t* rx, uint32_t length, uint32_t speed_hz) {
+    Pending pending;
+    pending.transfer.rx = rx;
+    pending.transfer.length = length;
+    pending.transfer.speed_hz = speed_hz;
+    if (tx) {
+        pending.offset = storage_.size();
+        pending.owned = true;
+        storage_.insert(storage_.end(), tx, tx + length);
+    }
+    transfers_.push_back(pending);
+}
+
+void SPIBatch::exchange(const uint8_t* tx, uint8_t* rx, uint32_t length, uint32_t speed_hz) {
+    frames_.push_back(transfers_.size());
+    add(tx, rx, length, speed_hz);
+}
+
+void SPIBatch::command(const uint8_t* tx, uint32_t tx_length, uint8_t* rx, uint32_t rx_length,
+                       uint32_t speed_hz) {
+    frames_.push_back(transfers_.size());
+    add(tx, nullptr, tx_length, speed_hz);
+    add(nullptr, rx, rx_length, speed_hz);
+}
+
+bool SPIBatch::execute(ISPIDevice& device) {
+    completed_ = 0;
+    messages_ = 0;
+
+    resolved_.clear();
+    resolved_.reserve(transfers_.size());
+    for (auto& pending : transfers_) {
+        resolved_.push_back(pending.transfer);
+        if (pending.owned) {
+            resolved_.back().tx = storage_.data() + pending.offset;
+        }
+    }
+    // Release chip select after every frame
+    for (size_t frame = 1; frame <= frames_.size(); ++frame) {
+        size_t last = (frame < frames_.size() ? frames_[frame] : transfers_.size()) - 1;
+        resolved_[last].cs_change = true;
+    }
+
+    const size_t max_transfers = device.maxTransfersPerMessage();
+    const size_t max_bytes = device.maxBytesPerMessage();
+    size_t frame = 0;
+    while (frame < frames_.size()) {
+        const size_t first = frames_[frame];
+        size_t end_frame = frame;
+        size_t end_transfer = first;
+        size_t bytes = 0;
+        while (end_frame < frames_.size()) {
+            size_t next = end_frame + 1 < frames_.size() ? frames_[end_frame + 1] : transfers_.size();
+            size_t frame_bytes = 0;
+            for (size_t i = end_transfer; i < next; ++i) {
+                frame_bytes += resolved_[i].length;
+            }
+            if (next - first > max_transfers || bytes + frame_bytes > max_bytes) {
+                break;
+            }
+            bytes += frame_bytes;
+            end_transfer = next;
+            ++end_frame;
+        }
+        if (end_frame == frame) {
+            return false;   // One frame exceeds the per-message limits
+        }
+
+        // cs_change on a message's last transfer would keep the chip
+        // selected after the message instead of releasing it
+        SPITransfer& last = resolved_[end_transfer - 1];
+        last.cs_change = false;
+        ++messages_;
+        bool ok = device.transfer(resolved_.data() + first, end_transfer - first);
+        last.cs_change = true;
+        if (!ok) {
+            return false;
+        }
+        completed_ += end_frame - frame;
+        frame = end_frame;
+    }
+    return true;
+}
+
+void SPIBatch::clear() noexcept {
+    transfers_.clear();
+    frames_.clear();
+    storage_.clear();
+    completed_ = 0;
+    messages_ = 0;
+}
+
+std::shared_ptr<LinuxI2CBus> LinuxI2CBus::open(const std::string& path, std::string* error) {
+#ifdef __linux__
+    int fd = openNode(path, error);
+    if (fd < 0) {
+        return nullptr;
+    }
+    return std::shared_ptr<LinuxI2CBus>(new LinuxI2CBus(fd));
+#else
+    if (error) {
+        *error = "I2C is not supported on this platform";
+    }
+    return nullptr;
+#endif
+}
+
+LinuxI2CBus::~LinuxI2CBus() {
+    ::close(fd_);
+}
+
+bool LinuxI2CBus::transfer(I2CMessage* messages, size_t count) {
+#ifdef __linux__
+    if (count == 0 || count > I2C_RDWR_IOCTL_MAX_MSGS) {
+        return false;
+    }
+    i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    for (size_t i = 0; i < count; ++i) {
+        msgs[i].addr = messages[i].address;
+        msgs[i].flags = messages[i].read ? I2C_M_RD : 0;
+        msgs[i].len = messages[i].length;
+        msgs[i].buf = messages[i].data;
+    }
+    i2c_rdwr_ioctl_data data;
+    data.msgs = msgs;
+    data.nmsgs = static_cast<__u32>(count);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ioctl(fd_, I2C_RDWR, &data) == static_cast<int>(count);
+#else
+    (void)messages;
+    (void)count;
+    return false;
+#endif
+}
+
+size_t LinuxI2CBus::maxMessagesPerTransfer() const noexcept {
+#ifdef __linux__
+    return I2C_RDWR_IOCTL_MAX_MSGS;
+#else
+    return 0;
+#endif
+}
+
+std::shared_ptr<SpidevDevice> SpidevDevice::open(const std::string& path, std::string* error) {
+#ifdef __linux__
+    int fd = openNode(path, error);
+    if (fd < 0) {
+        return nullptr;
+    }
+    return std::shared_ptr<SpidevDevice>(new SpidevDevice(fd, spidevBufferSize()));
+#else
+    if (error) {
+        *error = "SPI is not supported on this platform";
+    }
+    return nullptr;
+#endif
+}
+
+SpidevDevice::~SpidevDevice() {
+    ::close(fd_);
+}
+
+bool SpidevDevice::configure(const SPIConfig& config) {
+#ifdef __linux__
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint8_t mode = config.mode & 3;
+    uint8_t bits = config.bits_per_word;
+    uint32_t speed = config.speed_hz;
+    if (ioctl(fd_, SPI_IOC_WR_MODE, &mode) < 0 ||
+        ioctl(fd_, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(fd_, SPI_IOC_WR_MAX_SPEED_HZ, &speed) < 0) {
+        return false;
+    }
+    bits_per_word_ = bits;
+    return true;
+#else
+    (void)config;
+    return false;
+#endif
+}
+
+bool SpidevDevice::transfer(const SPITransfer* transfers, size_t count) {
+#ifdef __linux__
+    if (count == 0 || count > SPI_MAX_TRANSFERS) {
+        return false;
+    }
+    memory::SmallVector<spi_ioc_transfer, 16> ioc;
+    ioc.resize(count);
+    std::memset(ioc.data(), 0, count * sizeof(spi_ioc_transfer));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count; ++i) {
+        ioc[i].tx_buf = reinterpret_cast<uintptr_t>(transfers[i].tx);
+        ioc[i].rx_buf = reinterpret_cast<uintptr_t>(transfers[i].rx);
+        ioc[i].len = transfers[i].length;
+        ioc[i].speed_hz = transfers[i].speed_hz;
+        ioc[i].delay_usecs = transfers[i].delay_us;
+        ioc[i].bits_per_word = bits_per_word_;
+        ioc[i].cs_change = transfers[i].cs_change ? 1 : 0;
+    }
+    return ioctl(fd_, spiMessageRequest(count), ioc.data()) >= 0;
+#else
+    (void)transfers;
+    (void)count;
+    return false;
+#endif
+}
+
+size_t SpidevDevice::maxTransfersPerMessage() const noexcept {
+#ifdef __linux__
+    return SPI_MAX_TRANSFERS;
+#else
+    return 0;
+#endif
+}
+
+} // namespace hardware
+} // namespace cross_terminal
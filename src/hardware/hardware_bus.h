@@ -0,0 +1,185 @@
+#pragma once
+
+#include "core/interfaces/i_hardware_bus.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file hardware_bus.h
+ * @brief Batched I2C/SPI access and the Linux i2c-dev and spidev backends
+ *
+ * I2CBatch and SPIBatch collect many register accesses and execute them
+ * in as few kernel calls as the bus allows, without ever splitting one
+ * access (a register write and its read, or one chip select frame)
+ * across calls.
+ *
+ * @thread_safety Batches are not thread-safe; backends serialize transfers
+ */
+
+namespace cross_terminal {
+namespace hardware {
+
+/**
+ * @brief Queue of I2C accesses executed as combined transactions
+ *
+ * Read destinations must stay valid until execute(); write data is copied.
+ * A NACK fails the whole transaction it was packed into, so accesses
+ * before the failing transaction have completed and later ones have not
+ * been attempted.
+ */
+class I2CBatch {
+public:
+    /// @brief Queue a register read (write reg, repeated start, read)
+    void readRegisters(uint16_t address, uint8_t reg, uint8_t* out, uint16_t length);
+
+    /// @brief Queue a register write of length bytes starting at reg
+    void writeRegisters(uint16_t address, uint8_t reg, const uint8_t* data, uint16_t length);
+
+    /// @brief Queue a plain read
+    void read(uint16_t address, uint8_t* out, uint16_t length);
+
+    /// @brief Queue a plain write
+    void write(uint16_t address, const uint8_t* data, uint16_t length);
+
+    /**
+     * @brief Execute every queued access, in order
+     * @return true if every transaction was acknowledged
+     * @performance ceil(messages / bus.maxMessagesPerTransfer()) kernel calls
+     */
+    bool execute(II2CBus& bus);
+
+    /// @brief Drop queued accesses, keeping capacity for reuse
+    void clear() noexcept;
+
+    size_t size() const noexcept { return accesses_.size(); }
+    size_t messageCount() const noexcept { return messages_.size(); }
+
+    /// @brief Accesses completed by the last execute()
+    size_t completed() const noexcept { return completed_; }
+
+    /// @brief Transactions issued by the last execute()
+    size_t transactions() const noexcept { return transactions_; }
+
+private:
+    struct Pending {
+        I2CMessage message;
+        size_t offset = 0;    ///< Position in storage_ for owned write data
+        bool owned = false;
+    };
+
+    std::vector<Pending> messages_;
+    std::vector<size_t> accesses_;     ///< First message of each access
+    std::vector<uint8_t> storage_;     ///< Copied write data
+    std::vector<I2CMessage> resolved_; ///< Scratch for execute()
+    size_t completed_ = 0;
+    size_t transactions_ = 0;
+
+    void add(uint16_t address, bool read, uint8_t* data, uint16_t length);
+    void addOwned(uint16_t address, uint8_t prefix, bool has_prefix,
+                  const uint8_t* data, uint16_t length);
+};
+
+/**
+ * @brief Queue of SPI chip select frames executed as few messages
+ *
+ * Each frame is one chip select assertion; chip select is released
+ * between frames. Receive buffers must stay valid until execute(); send
+ * data is copied.
+ */
+class SPIBatch {
+public:
+    /// @brief Queue a full-duplex frame (rx may be null)
+    void exchange(const uint8_t* tx, uint8_t* rx, uint32_t length, uint32_t speed_hz = 0);
+
+    /// @brief Queue a frame that sends a command, then reads the response
+    void command(const uint8_t* tx, uint32_t tx_length, uint8_t* rx, uint32_t rx_length,
+                 uint32_t speed_hz = 0);
+
+    /**
+     * @brief Execute every queued frame, in order
+     * @return false on the first failed message, or if one frame exceeds
+     *         the device's per-message limits
+     */
+    bool execute(ISPIDevice& device);
+
+    void clear() noexcept;
+
+    size_t size() const noexcept { return frames_.size(); }
+    size_t completed() const noexcept { return completed_; }
+    size_t messages() const noexcept { return messages_; }
+
+private:
+    struct Pending {
+        SPITransfer transfer;
+        size_t offset = 0;   ///< Position in storage_ of the send data
+        bool owned = false;
+    };
+
+    std::vector<Pending> transfers_;
+    std::vector<size_t> frames_;        ///< First transfer of each frame
+    std::vector<uint8_t> storage_;
+    std::vector<SPITransfer> resolved_;
+    size_t completed_ = 0;
+    size_t messages_ = 0;
+
+    void add(const uint8_t* tx, uint8_t* rx, uint32_t length, uint32_t speed_hz);
+};
+
+/**
+ * @brief I2C adapter through /dev/i2c-N and I2C_RDWR
+ */
+class LinuxI2CBus : public II2CBus {
+public:
+    /**
+     * @brief Open an adapter
+     * @param path Device node, e.g. /dev/i2c-1
+     * @param error Receives the reason on failure (optional)
+     * @return Bus, or null if the node cannot be opened
+     */
+    static std::shared_ptr<LinuxI2CBus> open(const std::string& path, std::string* error = nullptr);
+
+    ~LinuxI2CBus() override;
+
+    bool transfer(I2CMessage* messages, size_t count) override;
+    size_t maxMessagesPerTransfer() const noexcept override;
+
+private:
+    explicit LinuxI2CBus(int fd) : fd_(fd) {}
+
+    const int fd_;
+    std::mutex mutex_;
+};
+
+/**
+ * @brief SPI device through /dev/spidevB.C and SPI_IOC_MESSAGE
+ */
+class SpidevDevice : public ISPIDevice {
+public:
+    /**
+     * @brief Open a device
+     * @param path Device node, e.g. /dev/spidev0.1
+     * @param error Receives the reason on failure (optional)
+     * @return Device, or null if the node cannot be opened
+     */
+    static std::shared_ptr<SpidevDevice> open(const std::string& path, std::string* error = nullptr);
+
+    ~SpidevDevice() override;
+
+    bool configure(const SPIConfig& config) override;
+    bool transfer(const SPITransfer* transfers, size_t count) override;
+    size_t maxTransfersPerMessage() const noexcept override;
+    size_t maxBytesPerMessage() const noexcept override { return max_bytes_; }
+
+private:
+    SpidevDevice(int fd, size_t max_bytes) : fd_(fd), max_bytes_(max_bytes) {}
+
+    const int fd_;
+    const size_t max_bytes_;
+    std::mutex mutex_;
+    uint8_t bits_per_word_ = 8;
+};
+
+} // namespace hardware
+} // namespace cross_terminal
@@ -29,4 +29,20 @@ std::unique_ptr<HardwareController> HardwareController::create() {
 #else
     return std::make_unique<LinuxHardwareController>();
 #endif
-}
\ No newline at end of file
+}
+
+ExtendedSystemMetrics HardwareController::getExtendedSystemMetrics() {
+    ExtendedSystemMetrics metrics;
+    metrics.basic = getSystemMetrics();
+    metrics.maxTemperature = metrics.basic.temperature;
+    metrics.hottestZone = -1;
+    return metrics;
+}
+
+std::shared_ptr<cross_terminal::hardware::II2CBus> HardwareController::openI2CBus(int) {
+    return nullptr;
+}
+
+std::shared_ptr<cross_terminal::hardware::ISPIDevice> HardwareController::openSPIDevice(int, int) {
+    return nullptr;
+}
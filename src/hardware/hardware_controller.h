@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include "core/interfaces/i_hardware_bus.h"
+#include "memory/small_vector.h"
 
 enum class GPIOMode {
     Input,
@@ -25,7 +27,7 @@ enum class SensorType {
 
 struct SensorData {
     SensorType type;
-    std::vector<float> values;
+    cross_terminal::memory::SmallVector<float, 3> values;   // 1-3 axes, stored inline
     uint64_t timestamp;
 };
 
@@ -38,6 +40,41 @@ struct SystemMetrics {
     bool isCharging;
 };
 
+struct ThermalTripPoint {
+    std::string type;       // passive, active, hot, critical
+    float temperature;      // Celsius
+};
+
+struct ThermalZoneReading {
+    int index;              // N in /sys/class/thermal/thermal_zoneN
+    std::string type;       // e.g. cpu-1-0, gpu-therm, battery
+    float temperature;      // Celsius
+    bool valid;             // False if the zone could not be read this sample
+    std::vector<ThermalTripPoint> trips;
+};
+
+struct CPUFrequencyReading {
+    int cpu;
+    bool online;
+    uint32_t currentKHz;    // 0 while offline
+    uint32_t minKHz;        // Policy limits (scaling_min/max_freq)
+    uint32_t maxKHz;
+    uint32_t hardwareMaxKHz; // cpuinfo_max_freq
+    std::string governor;
+    uint64_t throttleCount; // Thermal throttle events, where the CPU reports them
+    bool capped;            // Policy maximum held below the hardware maximum
+};
+
+// SystemMetrics plus every thermal zone and per-core frequency, to explain
+// throttling; more expensive to gather than getSystemMetrics()
+struct ExtendedSystemMetrics {
+    SystemMetrics basic;
+    std::vector<ThermalZoneReading> thermalZones;
+    std::vector<CPUFrequencyReading> cpus;
+    float maxTemperature;   // Hottest valid zone, Celsius
+    int hottestZone;        // Its index, -1 if none
+};
+
 class HardwareController {
 public:
     virtual ~HardwareController() = default;
@@ -50,6 +87,12 @@ public:
     virtual bool writeGPIO(int pin, bool high) = 0;
     virtual bool readGPIO(int pin) = 0;
     
+    // Bus access (I2C adapter N, SPI device B.C); null when the bus cannot
+    // be opened, which is always the case by default. Keep the handle for
+    // repeated transfers.
+    virtual std::shared_ptr<cross_terminal::hardware::II2CBus> openI2CBus(int bus);
+    virtual std::shared_ptr<cross_terminal::hardware::ISPIDevice> openSPIDevice(int bus, int chipSelect);
+    
     // Sensor access
     virtual std::vector<SensorType> getAvailableSensors() = 0;
     virtual bool enableSensor(SensorType type) = 0;
@@ -60,6 +103,8 @@ public:
     virtual SystemMetrics getSystemMetrics() = 0;
     virtual void startSystemMonitoring(std::function<void(const SystemMetrics&)> callback) = 0;
     virtual void stopSystemMonitoring() = 0;
+    // Defaults to the basic metrics with no zones or CPUs
+    virtual ExtendedSystemMetrics getExtendedSystemMetrics();
     
     // Device control
     virtual bool setScreenBrightness(float level) = 0;
@@ -1,4 +1,5 @@
 #import "macos_hardware.h"
+#include "core/implementations/thread_registry.h"
 #import <Foundation/Foundation.h>
 #import <AppKit/AppKit.h>
 #import <IOKit/IOKitLib.h>
@@ -128,6 +129,8 @@ void macOSHardwareController::startSystemMonitoring(std::function<void(const Sys
     m_monitoringCallback = callback;
     
     m_monitoringThread = std::thread([this]() {
+        auto registration = cross_terminal::core::ThreadRegistry::instance().enter(
+            cross_terminal::core::ThreadRole::Hardware, "ct-hw-monitor");
         while (m_systemMonitoringActive) {
             SystemMetrics metrics = getSystemMetrics();
             if (m_monitoringCallback) {
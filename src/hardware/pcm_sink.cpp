@@ -0,0 +1,335 @@
+#include "pcm_sink.h"
+#include <cstring>
+#include <dlfcn.h>
+
+namespace {
+
+constexpr uint32_t WAV_HEADER_BYTES = 44;
+
+void putLE(unsigned char* out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+// Entry points resolved from a library loaded on first use and kept for
+// the life of the process
+template <typename T>
+bool resolve(void* library, const char* name, T& function) {
+    function = reinterpret_cast<T>(dlsym(library, name));
+    return function != nullptr;
+}
+
+// AAudio, declared here because the NDK headers only provide it from
+// API 26 and the app supports older releases
+struct AAudioStreamBuilder;
+struct AAudioStream;
+
+constexpr int32_t AAUDIO_FORMAT_PCM_I16 = 1;
+constexpr int32_t AAUDIO_PERFORMANCE_MODE_LOW_LATENCY = 12;
+constexpr int64_t AAUDIO_WRITE_TIMEOUT_NS = 1000000000;
+
+struct AAudioApi {
+    int32_t (*createStreamBuilder)(AAudioStreamBuilder**) = nullptr;
+    void (*setFormat)(AAudioStreamBuilder*, int32_t) = nullptr;
+    void (*setChannelCount)(AAudioStreamBuilder*, int32_t) = nullptr;
+    void (*setSampleRate)(AAudioStreamBuilder*, int32_t) = nullptr;
+    void (*setPerformanceMode)(AAudioStreamBuilder*, int32_t) = nullptr;
+    int32_t (*openStream)(AAudioStreamBuilder*, AAudioStream**) = nullptr;
+    int32_t (*deleteBuilder)(AAudioStreamBuilder*) = nullptr;
+    int32_t (*requestStart)(AAudioStream*) = nullptr;
+    int32_t (*requestStop)(AAudioStream*) = nullptr;
+    int32_t (*write)(AAudioStream*, const void*, int32_t, int64_t) = nullptr;
+    int32_t (*close)(AAudioStream*) = nullptr;
+    bool loaded = false;
+
+    static const AAudioApi& get() {
+        static const AAudioApi api = load();
+        return api;
+    }
+
+private:
+    static AAudioApi load() {
+        AAudioApi api;
+        void* library = dlopen("libaaudio.so", RTLD_NOW | RTLD_LOCAL);
+        if (!library) {
+            return api;
+        }
+        api.loaded = resolve(library, "AAudio_createStreamBuilder", api.createStreamBuilder) &&
+                     resolve(library, "AAudioStreamBuilder_setFormat", api.setFormat) &&
+                     resolve(library, "AAudioStreamBuilder_setChannelCount", api.setChannelCount) &&
+                     resolve(library, "AAudioStreamBuilder_setSampleRate", api.setSampleRate) &&
+                     resolve(library, "AAudioStreamBuilder_setPerformanceMode", api.setPerformanceMode) &&
+                     resolve(library, "AAudioStreamBuilder_openStream", api.openStream) &&
+                     resolve(library, "AAudioStreamBuilder_delete", api.deleteBuilder) &&
+                     resolve(library, "AAudioStream_requestStart", api.requestStart) &&
+                     resolve(library, "AAudioStream_requestStop", api.requestStop) &&
+                     resolve(library, "AAudioStream_write", api.write) &&
+                     resolve(library, "AAudioStream_close", api.close);
+        return api;
+    }
+};
+
+class AAudioSink : public PcmSink {
+public:
+    AAudioSink(AAudioStream* stream, uint32_t sampleRate)
+        : m_stream(stream), m_sampleRate(sampleRate) {
+    }
+
+    ~AAudioSink() override {
+        AAudioApi::get().close(m_stream);
+    }
+
+    uint32_t sampleRate() const override {
+        return m_sampleRate;
+    }
+
+    bool write(const int16_t* samples, size_t count) override {
+        const AAudioApi& api = AAudioApi::get();
+        if (!m_started) {
+            if (api.requestStart(m_stream) != 0) {
+                return false;
+            }
+            m_started = true;
+        }
+        while (count > 0) {
+            int32_t written = api.write(m_stream, samples, static_cast<int32_t>(count), AAUDIO_WRITE_TIMEOUT_NS);
+            if (written <= 0) {
+                return false;
+            }
+            samples += written;
+            count -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    void drain() override {
+        // A stopping output stream plays out what is buffered first
+        if (m_started) {
+            AAudioApi::get().requestStop(m_stream);
+            m_started = false;
+        }
+    }
+
+private:
+    AAudioStream* m_stream;
+    const uint32_t m_sampleRate;
+    bool m_started = false;
+};
+
+// ALSA, loaded rather than linked so systems without it still run
+struct snd_pcm_t;
+
+constexpr int SND_PCM_STREAM_PLAYBACK = 0;
+constexpr int SND_PCM_FORMAT_S16_LE = 2;
+constexpr int SND_PCM_ACCESS_RW_INTERLEAVED = 3;
+constexpr unsigned ALSA_LATENCY_US = 50000;
+
+struct AlsaApi {
+    int (*open)(snd_pcm_t**, const char*, int, int) = nullptr;
+    int (*setParams)(snd_pcm_t*, int, int, unsigned, unsigned, int, unsigned) = nullptr;
+    long (*writei)(snd_pcm_t*, const void*, unsigned long) = nullptr;
+    int (*recover)(snd_pcm_t*, int, int) = nullptr;
+    int (*drain)(snd_pcm_t*) = nullptr;
+    int (*prepare)(snd_pcm_t*) = nullptr;
+    int (*close)(snd_pcm_t*) = nullptr;
+    bool loaded = false;
+
+    static const AlsaApi& get() {
+        static const AlsaApi api = load();
+        return api;
+    }
+
+private:
+    static AlsaApi load() {
+        AlsaApi api;
+        void* library = dlopen("libasound.so.2", RTLD_NOW | RTLD_LOCAL);
+        if (!library) {
+            return api;
+        }
+        api.loaded = resolve(library, "snd_pcm_open", api.open) &&
+                     resolve(library, "snd_pcm_set_params", api.setParams) &&
+                     resolve(library, "snd_pcm_writei", api.writei) &&
+                     resolve(library, "snd_pcm_recover", api.recover) &&
+                     resolve(library, "snd_pcm_drain", api.drain) &&
+                     resolve(library, "snd_pcm_prepare", api.prepare) &&
+                     resolve(library, "snd_pcm_close", api.close);
+        return api;
+    }
+};
+
+class AlsaSink : public PcmSink {
+public:
+    AlsaSink(snd_pcm_t* pcm, uint32_t sampleRate)
+        : m_pcm(pcm), m_sampleRate(sampleRate) {
+    }
+
+    ~AlsaSink() override {
+        AlsaApi::get().close(m_pcm);
+    }
+
+    uint32_t sampleRate() const override {
+        return m_sampleRate;
+    }
+
+    bool write(const int16_t* samples, size_t count) override {
+        const AlsaApi& api = AlsaApi::get();
+        while (count > 0) {
+            long written = api.writei(m_pcm, samples, count);
+            if (written < 0) {
+                // Underruns between beeps are expected; recover and retry
+                if (api.recover(m_pcm, static_cast<int>(written), 1) < 0) {
+                    return false;
+                }
+                continue;
+            }
+            samples += written;
+            count -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    void drain() override {
+        const AlsaApi& api = AlsaApi::get();
+        api.drain(m_pcm);
+        api.prepare(m_pcm);   // Drain leaves the device stopped
+    }
+
+private:
+    snd_pcm_t* m_pcm;
+    const uint32_t m_sampleRate;
+};
+
+} // namespace
+
+std::unique_ptr<PcmSink> PcmSink::openDefault(uint32_t sampleRate) {
+#if defined(__ANDROID__)
+    return openAAudioSink(sampleRate);
+#elif defined(__linux__)
+    return openAlsaSink(sampleRate);
+#else
+    (void)sampleRate;
+    return nullptr;
+#endif
+}
+
+NullPcmSink::NullPcmSink(uint32_t sampleRate)
+    : m_sampleRate(sampleRate) {
+}
+
+uint32_t NullPcmSink::sampleRate() const {
+    return m_sampleRate;
+}
+
+bool NullPcmSink::write(const int16_t*, size_t count) {
+    m_samples += count;
+    ++m_writes;
+    return true;
+}
+
+uint64_t NullPcmSink::samplesWritten() const {
+    return m_samples;
+}
+
+uint64_t NullPcmSink::writes() const {
+    return m_writes;
+}
+
+WavFileSink::WavFileSink(const std::string& path, uint32_t sampleRate)
+    : m_sampleRate(sampleRate) {
+    m_file = fopen(path.c_str(), "wb");
+    if (m_file && !writeHeader()) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+WavFileSink::~WavFileSink() {
+    close();
+}
+
+bool WavFileSink::isOpen() const {
+    return m_file != nullptr;
+}
+
+void WavFileSink::close() {
+    if (!m_file) {
+        return;
+    }
+    fseek(m_file, 0, SEEK_SET);
+    writeHeader();
+    fclose(m_file);
+    m_file = nullptr;
+}
+
+uint32_t WavFileSink::sampleRate() const {
+    return m_sampleRate;
+}
+
+bool WavFileSink::write(const int16_t* samples, size_t count) {
+    if (!m_file) {
+        return false;
+    }
+    // Samples are stored little-endian, as on every platform we build for
+    if (fwrite(samples, sizeof(int16_t), count, m_file) != count) {
+        return false;
+    }
+    m_dataBytes += static_cast<uint32_t>(count * sizeof(int16_t));
+    return true;
+}
+
+bool WavFileSink::writeHeader() {
+    unsigned char header[WAV_HEADER_BYTES];
+    memcpy(header, "RIFF", 4);
+    putLE(header + 4, WAV_HEADER_BYTES - 8 + m_dataBytes, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    putLE(header + 16, 16, 4);                    // fmt chunk size
+    putLE(header + 20, 1, 2);                     // PCM
+    putLE(header + 22, 1, 2);                     // Mono
+    putLE(header + 24, m_sampleRate, 4);
+    putLE(header + 28, m_sampleRate * 2, 4);      // Byte rate
+    putLE(header + 32, 2, 2);                     // Block align
+    putLE(header + 34, 16, 2);                    // Bits per sample
+    memcpy(header + 36, "data", 4);
+    putLE(header + 40, m_dataBytes, 4);
+    return fwrite(header, 1, sizeof(header), m_file) == sizeof(header);
+}
+
+std::unique_ptr<PcmSink> openAAudioSink(uint32_t sampleRate) {
+    const AAudioApi& api = AAudioApi::get();
+    if (!api.loaded) {
+        return nullptr;
+    }
+    AAudioStreamBuilder* builder = nullptr;
+    if (api.createStreamBuilder(&builder) != 0) {
+        return nullptr;
+    }
+    api.setFormat(builder, AAUDIO_FORMAT_PCM_I16);
+    api.setChannelCount(builder, 1);
+    api.setSampleRate(builder, static_cast<int32_t>(sampleRate));
+    api.setPerformanceMode(builder, AAUDIO_PERFORMANCE_MODE_LOW_LATENCY);
+    AAudioStream* stream = nullptr;
+    int32_t result = api.openStream(builder, &stream);
+    api.deleteBuilder(builder);
+    if (result != 0 || !stream) {
+        return nullptr;
+    }
+    return std::unique_ptr<PcmSink>(new AAudioSink(stream, sampleRate));
+}
+
+std::unique_ptr<PcmSink> openAlsaSink(uint32_t sampleRate) {
+    const AlsaApi& api = AlsaApi::get();
+    if (!api.loaded) {
+        return nullptr;
+    }
+    snd_pcm_t* pcm = nullptr;
+    if (api.open(&pcm, "default", SND_PCM_STREAM_PLAYBACK, 0) < 0) {
+        return nullptr;
+    }
+    if (api.setParams(pcm, SND_PCM_FORMAT_S16_LE, SND_PCM_ACCESS_RW_INTERLEAVED, 1, sampleRate, 1,
+                      ALSA_LATENCY_US) < 0) {
+        api.close(pcm);
+        return nullptr;
+    }
+    return std::unique_ptr<PcmSink>(new AlsaSink(pcm, sampleRate));
+}
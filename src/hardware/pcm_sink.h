@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// Destinations for 16-bit mono PCM.
+//
+// The platform sinks load their audio library with dlopen() when first
+// opened: AAudio (libaaudio.so, API 26+) on Android and ALSA
+// (libasound.so.2) on other Linux systems. The app therefore neither
+// links against them nor requires them; openDefault() returns null where
+// neither is present. WavFileSink and NullPcmSink make output observable
+// in tests and benchmarks.
+
+class PcmSink {
+public:
+    static constexpr uint32_t DEFAULT_SAMPLE_RATE = 48000;
+
+    virtual ~PcmSink() = default;
+
+    virtual uint32_t sampleRate() const = 0;
+    // Blocks until every sample is accepted; false if the device failed
+    virtual bool write(const int16_t* samples, size_t count) = 0;
+    // Wait for queued audio to finish playing
+    virtual void drain() {}
+
+    // The platform's audio output, or null if there is none
+    static std::unique_ptr<PcmSink> openDefault(uint32_t sampleRate = DEFAULT_SAMPLE_RATE);
+};
+
+// Accepts and discards everything, counting what it was given
+class NullPcmSink : public PcmSink {
+public:
+    explicit NullPcmSink(uint32_t sampleRate = DEFAULT_SAMPLE_RATE);
+
+    uint32_t sampleRate() const override;
+    bool write(const int16_t* samples, size_t count) override;
+
+    uint64_t samplesWritten() const;
+    uint64_t writes() const;
+
+private:
+    const uint32_t m_sampleRate;
+    uint64_t m_samples = 0;
+    uint64_t m_writes = 0;
+};
+
+// Writes a RIFF/WAVE file; the header sizes are filled in by close()
+class WavFileSink : public PcmSink {
+public:
+    WavFileSink(const std::string& path, uint32_t sampleRate = DEFAULT_SAMPLE_RATE);
+    ~WavFileSink() override;
+
+    WavFileSink(const WavFileSink&) = delete;
+    WavFileSink& operator=(const WavFileSink&) = delete;
+
+    bool isOpen() const;
+    void close();
+
+    uint32_t sampleRate() const override;
+    bool write(const int16_t* samples, size_t count) override;
+
+private:
+    const uint32_t m_sampleRate;
+    FILE* m_file = nullptr;
+    uint32_t m_dataBytes = 0;
+
+    bool writeHeader();
+};
+
+// AAudio output stream, Android 8.0 and later
+std::unique_ptr<PcmSink> openAAudioSink(uint32_t sampleRate);
+// ALSA "default" playback device
+std::unique_ptr<PcmSink> openAlsaSink(uint32_t sampleRate);
@@ -0,0 +1,219 @@
+#include "power_state_monitor.h"
+#include "uevent_monitor.h"
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr const char* ZONE_PREFIX = "thermal_zone";
+
+bool chargingStatus(const std::string& status) {
+    return status == "Charging" || status == "Full";
+}
+
+bool sameState(const PowerState& a, const PowerState& b) {
+    return a.batteryPresent == b.batteryPresent && a.batteryLevel == b.batteryLevel &&
+           a.isCharging == b.isCharging && a.batteryTemperature == b.batteryTemperature &&
+           a.thermalZone == b.thermalZone && a.thermalTemperature == b.thermalTemperature;
+}
+
+} // namespace
+
+PowerStateMonitor::PowerStateMonitor(std::string sysfsRoot)
+    : m_sysfsRoot(std::move(sysfsRoot)) {
+}
+
+PowerStateMonitor::~PowerStateMonitor() {
+    detach();
+}
+
+void PowerStateMonitor::refresh() {
+    Listener listener;
+    PowerState state;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // The battery is the first supply of type Battery, "battery" if
+        // there are several (some devices also list a fuel gauge or a pen)
+        m_batteryName.clear();
+        const std::string root = m_sysfsRoot + "/class/power_supply/";
+        if (DIR* dir = opendir(root.c_str())) {
+            while (dirent* entry = readdir(dir)) {
+                if (entry->d_name[0] == '.') {
+                    continue;
+                }
+                const std::string name = entry->d_name;
+                const bool battery = readAttributeLocked(name, "type") == "Battery";
+                if (battery && (m_batteryName.empty() || name == "battery")) {
+                    m_batteryName = name;
+                }
+            }
+            closedir(dir);
+        }
+
+        PowerState next = m_state;
+        readBatteryLocked(next);
+        listener = commitLocked(next);
+        state = m_state;
+    }
+    if (listener) {
+        listener(state);
+    }
+}
+
+void PowerStateMonitor::attach(UeventMonitor& monitor) {
+    detach();
+    int supplies = monitor.subscribe("power_supply", [this](const UeventMessage& message) {
+        onUevent(message);
+    });
+    // Both subscriptions see a resync; the power_supply one handles it
+    int thermal = monitor.subscribe("thermal", [this](const UeventMessage& message) {
+        if (message.action != UeventMonitor::RESYNC_ACTION) {
+            onUevent(message);
+        }
+    });
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_monitor = &monitor;
+    m_subscriptions[0] = supplies;
+    m_subscriptions[1] = thermal;
+}
+
+void PowerStateMonitor::detach() {
+    UeventMonitor* monitor;
+    int subscriptions[2];
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        monitor = m_monitor;
+        subscriptions[0] = m_subscriptions[0];
+        subscriptions[1] = m_subscriptions[1];
+        m_monitor = nullptr;
+    }
+    if (monitor) {
+        monitor->unsubscribe(subscriptions[0]);
+        monitor->unsubscribe(subscriptions[1]);
+    }
+}
+
+PowerState PowerStateMonitor::getState() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_state;
+}
+
+void PowerStateMonitor::setListener(Listener listener) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_listener = std::move(listener);
+}
+
+uint64_t PowerStateMonitor::getSysfsReads() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sysfsReads;
+}
+
+void PowerStateMonitor::onUevent(const UeventMessage& message) {
+    // Lost events or a supply added/removed: locate the battery again.
+    // Zones coming and going need no action here.
+    if (message.changesTopology()) {
+        if (message.subsystem != "thermal") {
+            refresh();
+        }
+        return;
+    }
+    if (message.action != "change") {
+        return;
+    }
+
+    Listener listener;
+    PowerState state;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        PowerState next = m_state;
+        bool force = false;
+
+        if (message.subsystem == "power_supply") {
+            if (message.deviceName() == m_batteryName) {
+                const std::string& capacity = message.get("POWER_SUPPLY_CAPACITY");
+                const std::string& status = message.get("POWER_SUPPLY_STATUS");
+                if (capacity.empty() || status.empty()) {
+                    readBatteryLocked(next);   // Driver sends a partial set
+                } else {
+                    next.batteryLevel = static_cast<float>(atoi(capacity.c_str()));
+                    next.isCharging = chargingStatus(status);
+                    const std::string& present = message.get("POWER_SUPPLY_PRESENT");
+                    next.batteryPresent = present.empty() || present != "0";
+                    const std::string& temp = message.get("POWER_SUPPLY_TEMP");
+                    if (!temp.empty()) {
+                        next.batteryTemperature = atoi(temp.c_str()) / 10.0f;   // Tenths of a degree
+                    }
+                }
+            } else if (!m_batteryName.empty()) {
+                // A charger came or went; the battery's own event may lag
+                next.isCharging = chargingStatus(readAttributeLocked(m_batteryName, "status"));
+            }
+        } else if (message.subsystem == "thermal") {
+            const std::string& temp = message.get("TEMP");
+            const std::string name = message.deviceName();
+            if (temp.empty() || name.compare(0, strlen(ZONE_PREFIX), ZONE_PREFIX) != 0) {
+                return;
+            }
+            next.thermalZone = atoi(name.c_str() + strlen(ZONE_PREFIX));
+            next.thermalTemperature = atoi(temp.c_str()) / 1000.0f;   // Millidegrees
+            force = true;   // Every trip crossing is news, even at a repeated value
+        }
+
+        listener = commitLocked(next, force);
+        state = m_state;
+    }
+    if (listener) {
+        listener(state);
+    }
+}
+
+PowerStateMonitor::Listener PowerStateMonitor::commitLocked(PowerState next, bool force) {
+    if (!force && sameState(next, m_state)) {
+        return nullptr;
+    }
+    next.updates = m_state.updates + 1;
+    m_state = next;
+    return m_listener;
+}
+
+std::string PowerStateMonitor::readAttributeLocked(const std::string& supply, const std::string& name) {
+    ++m_sysfsReads;
+    const std::string path = m_sysfsRoot + "/class/power_supply/" + supply + "/" + name;
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::string();
+    }
+    char buffer[64];
+    ssize_t n = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    close(fd);
+    if (n <= 0) {
+        return std::string();
+    }
+    std::string value(buffer, static_cast<size_t>(n));
+    size_t newline = value.find('\n');
+    if (newline != std::string::npos) {
+        value.resize(newline);
+    }
+    return value;
+}
+
+void PowerStateMonitor::readBatteryLocked(PowerState& state) {
+    if (m_batteryName.empty()) {
+        state.batteryPresent = false;
+        state.batteryLevel = 50.0f;
+        state.isCharging = false;
+        state.batteryTemperature = 0.0f;
+        return;
+    }
+    const std::string present = readAttributeLocked(m_batteryName, "present");
+    state.batteryPresent = present.empty() || present != "0";
+    const std::string capacity = readAttributeLocked(m_batteryName, "capacity");
+    state.batteryLevel = capacity.empty() ? 50.0f : static_cast<float>(atoi(capacity.c_str()));
+    state.isCharging = chargingStatus(readAttributeLocked(m_batteryName, "status"));
+    const std::string temp = readAttributeLocked(m_batteryName, "temp");
+    state.batteryTemperature = temp.empty() ? 0.0f : atoi(temp.c_str()) / 10.0f;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+class UeventMonitor;
+struct UeventMessage;
+
+// Battery, charger and thermal-trip state kept current by uevents.
+//
+// Power supply drivers announce every capacity or status change with a
+// "change" uevent that carries the full POWER_SUPPLY_* property set, so
+// once attached to a running UeventMonitor the cached state is exact
+// without reading sysfs. Thermal zones emit uevents only when a trip
+// point is crossed (their temperature between trips still has to be
+// sampled); those are recorded too, since they are worth pushing to the
+// UI immediately. The listener runs on every change, on the uevent thread.
+
+struct PowerState {
+    bool batteryPresent = false;
+    float batteryLevel = 50.0f;        // Percent; 50 when no battery is found
+    bool isCharging = false;           // Charging, or full on external power
+    float batteryTemperature = 0.0f;   // Celsius, 0 if the driver reports none
+    int thermalZone = -1;              // Zone of the last trip event
+    float thermalTemperature = 0.0f;   // Celsius, reported with that event
+    uint64_t updates = 0;              // Incremented on every change
+};
+
+class PowerStateMonitor {
+public:
+    using Listener = std::function<void(const PowerState&)>;
+
+    static constexpr const char* DEFAULT_SYSFS_ROOT = "/sys";
+
+    explicit PowerStateMonitor(std::string sysfsRoot = DEFAULT_SYSFS_ROOT);
+    ~PowerStateMonitor();
+
+    PowerStateMonitor(const PowerStateMonitor&) = delete;
+    PowerStateMonitor& operator=(const PowerStateMonitor&) = delete;
+
+    // Locate the battery and read its state from sysfs. Called once at
+    // startup, then again only if events were lost or supplies changed.
+    void refresh();
+
+    // Follow power_supply and thermal events. The monitor must outlive the
+    // attachment: detach(), which the destructor calls, unsubscribes from
+    // it. Stop the monitor before destroying an attached PowerStateMonitor.
+    void attach(UeventMonitor& monitor);
+    void detach();
+
+    PowerState getState() const;
+    void setListener(Listener listener);
+
+    // Attribute files read so far, for tests and metrics
+    uint64_t getSysfsReads() const;
+
+private:
+    const std::string m_sysfsRoot;
+
+    mutable std::mutex m_mutex;
+    std::string m_batteryName;   // Supply directory name, empty if none
+    PowerState m_state;
+    Listener m_listener;
+    uint64_t m_sysfsReads = 0;
+
+    UeventMonitor* m_monitor = nullptr;
+    int m_subscriptions[2] = {};
+
+    void onUevent(const UeventMessage& message);
+    // Swap in next if it differs (or always, if forced); returns the
+    // listener to call, if any
+    Listener commitLocked(PowerState next, bool force = false);
+    std::string readAttributeLocked(const std::string& supply, const std::string& name);
+    void readBatteryLocked(PowerState& state);
+};
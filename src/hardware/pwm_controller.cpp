@@ -0,0 +1,402 @@
+#include "pwm_controller.h"
+#include "core/implementations/thread_registry.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// After an export, udev may still be creating the channel directory and
+// fixing up its permissions
+constexpr int EXPORT_WAIT_ATTEMPTS = 50;
+constexpr auto EXPORT_WAIT_INTERVAL = std::chrono::milliseconds(2);
+
+bool writeFile(const std::string& path, const char* value) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    const size_t length = strlen(value);
+    const bool ok = ::write(fd, value, length) == static_cast<ssize_t>(length);
+    ::close(fd);
+    return ok;
+}
+
+uint64_t readValue(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 0;
+    }
+    char buffer[32] = {};
+    ssize_t n = ::pread(fd, buffer, sizeof(buffer) - 1, 0);
+    ::close(fd);
+    return n > 0 ? strtoull(buffer, nullptr, 10) : 0;
+}
+
+int openAttribute(const std::string& path) {
+    for (int attempt = 0; attempt < EXPORT_WAIT_ATTEMPTS; ++attempt) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+        if (fd >= 0 || (errno != ENOENT && errno != EACCES)) {
+            return fd;
+        }
+        std::this_thread::sleep_for(EXPORT_WAIT_INTERVAL);
+    }
+    return -1;
+}
+
+} // namespace
+
+PWMChannel::PWMChannel(int chip, int channel, std::string sysfsRoot)
+    : m_chip(chip)
+    , m_channel(channel)
+    , m_chipPath(sysfsRoot + "/pwmchip" + std::to_string(chip))
+    , m_path(m_chipPath + "/pwm" + std::to_string(channel)) {
+}
+
+PWMChannel::~PWMChannel() {
+    close();
+}
+
+bool PWMChannel::open() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_dutyFd >= 0) {
+        return true;
+    }
+
+    struct stat st;
+    if (stat(m_path.c_str(), &st) != 0) {
+        if (!writeFile(m_chipPath + "/export", std::to_string(m_channel).c_str())) {
+            return false;
+        }
+        m_exported = true;
+    }
+
+    for (auto attribute : {std::make_pair(&m_periodFd, "/period"),
+                           std::make_pair(&m_dutyFd, "/duty_cycle"),
+                           std::make_pair(&m_enableFd, "/enable")}) {
+        *attribute.first = openAttribute(m_path + attribute.second);
+        if (*attribute.first < 0) {
+            closeLocked();
+            return false;
+        }
+    }
+
+    m_period = readValue(m_path + "/period");
+    m_duty = readValue(m_path + "/duty_cycle");
+    m_enabled = readValue(m_path + "/enable") != 0;
+    return true;
+}
+
+void PWMChannel::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    closeLocked();
+}
+
+void PWMChannel::closeLocked() {
+    for (int* fd : {&m_periodFd, &m_dutyFd, &m_enableFd}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    if (m_exported) {
+        writeFile(m_chipPath + "/unexport", std::to_string(m_channel).c_str());
+        m_exported = false;
+    }
+}
+
+bool PWMChannel::isOpen() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dutyFd >= 0;
+}
+
+bool PWMChannel::writeLocked(int fd, uint64_t value) {
+    // Newline-terminated like `echo`; sysfs ignores the offset of a store,
+    // so the same fd is rewritten in place without seeking
+    char buffer[24];
+    int length = snprintf(buffer, sizeof(buffer), "%llu\n", static_cast<unsigned long long>(value));
+    ++m_writes;
+    return ::pwrite(fd, buffer, length, 0) == length;
+}
+
+bool PWMChannel::setPeriod(uint64_t periodNs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_periodFd < 0) {
+        return false;
+    }
+    if (periodNs == m_period) {
+        return true;
+    }
+    // The kernel rejects a period shorter than the duty cycle
+    if (m_duty > periodNs) {
+        if (!writeLocked(m_dutyFd, periodNs)) {
+            return false;
+        }
+        m_duty = periodNs;
+    }
+    if (!writeLocked(m_periodFd, periodNs)) {
+        return false;
+    }
+    m_period = periodNs;
+    return true;
+}
+
+bool PWMChannel::setDutyCycle(uint64_t dutyNs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_dutyFd < 0 || dutyNs > m_period) {
+        return false;
+    }
+    if (dutyNs == m_duty) {
+        return true;
+    }
+    if (!writeLocked(m_dutyFd, dutyNs)) {
+        return false;
+    }
+    m_duty = dutyNs;
+    return true;
+}
+
+bool PWMChannel::setDutyFraction(float fraction) {
+    fraction = std::min(std::max(fraction, 0.0f), 1.0f);
+    return setDutyCycle(static_cast<uint64_t>(getPeriod() * static_cast<double>(fraction) + 0.5));
+}
+
+bool PWMChannel::setPolarity(PWMPolarity polarity) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_dutyFd < 0) {
+        return false;
+    }
+    return writeFile(m_path + "/polarity", polarity == PWMPolarity::Normal ? "normal\n" : "inversed\n");
+}
+
+bool PWMChannel::enable(bool on) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_enableFd < 0) {
+        return false;
+    }
+    if (on == m_enabled) {
+        return true;
+    }
+    if (!writeLocked(m_enableFd, on ? 1 : 0)) {
+        return false;
+    }
+    m_enabled = on;
+    return true;
+}
+
+uint64_t PWMChannel::getPeriod() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_period;
+}
+
+uint64_t PWMChannel::getDutyCycle() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_duty;
+}
+
+bool PWMChannel::isEnabled() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_enabled;
+}
+
+uint64_t PWMChannel::getWriteCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_writes;
+}
+
+PWMRampScheduler::PWMRampScheduler(std::chrono::microseconds tick)
+    : m_tick(tick) {
+}
+
+PWMRampScheduler::~PWMRampScheduler() {
+    stop();
+}
+
+void PWMRampScheduler::start() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running) {
+        return;
+    }
+    m_running = true;
+    m_thread = std::thread(&PWMRampScheduler::run, this);
+}
+
+void PWMRampScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+    }
+    m_changed.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void PWMRampScheduler::ramp(std::shared_ptr<PWMChannel> channel, uint64_t targetNs,
+                            std::chrono::milliseconds duration, PWMEasing easing,
+                            std::function<void()> onDone) {
+    if (!channel) {
+        return;
+    }
+    Ramp ramp;
+    ramp.from = channel->getDutyCycle();
+    ramp.to = std::min(targetNs, channel->getPeriod());
+    ramp.last = ramp.from;
+    ramp.startTime = std::chrono::steady_clock::now();
+    ramp.duration = duration;
+    ramp.easing = easing;
+    ramp.onDone = std::move(onDone);
+    ramp.channel = std::move(channel);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto existing = std::find_if(m_ramps.begin(), m_ramps.end(), [&](const Ramp& r) {
+            return r.channel == ramp.channel;
+        });
+        if (existing != m_ramps.end()) {
+            *existing = std::move(ramp);
+        } else {
+            m_ramps.push_back(std::move(ramp));
+        }
+    }
+    m_changed.notify_all();
+}
+
+void PWMRampScheduler::fade(std::shared_ptr<PWMChannel> channel, float targetFraction,
+                            std::chrono::milliseconds duration, PWMEasing easing,
+                            std::function<void()> onDone) {
+    if (!channel) {
+        return;
+    }
+    targetFraction = std::min(std::max(targetFraction, 0.0f), 1.0f);
+    uint64_t target = static_cast<uint64_t>(channel->getPeriod() * static_cast<double>(targetFraction) + 0.5);
+    ramp(std::move(channel), target, duration, easing, std::move(onDone));
+}
+
+bool PWMRampScheduler::cancel(const PWMChannel* channel) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_ramps.begin(), m_ramps.end(), [channel](const Ramp& r) {
+        return r.channel.get() == channel;
+    });
+    if (it == m_ramps.end()) {
+        return false;
+    }
+    m_ramps.erase(it);
+    m_changed.notify_all();
+    return true;
+}
+
+void PWMRampScheduler::cancelAll() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ramps.clear();
+    m_changed.notify_all();
+}
+
+size_t PWMRampScheduler::activeRamps() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ramps.size();
+}
+
+bool PWMRampScheduler::waitIdle(std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_changed.wait_for(lock, timeout, [this]() { return m_ramps.empty(); });
+}
+
+size_t PWMRampScheduler::step(std::chrono::steady_clock::time_point now) {
+    std::vector<std::function<void()>> finished;
+    size_t writes = 0;
+    bool idle = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_metrics.ticks;
+        for (auto it = m_ramps.begin(); it != m_ramps.end();) {
+            Ramp& ramp = *it;
+            double progress = 1.0;
+            if (ramp.duration.count() > 0 && now < ramp.startTime + ramp.duration) {
+                progress = std::max(0.0, std::chrono::duration<double>(now - ramp.startTime).count() /
+                                         std::chrono::duration<double>(ramp.duration).count());
+            }
+            if (ramp.easing == PWMEasing::EaseInOut) {
+                progress = progress * progress * (3.0 - 2.0 * progress);
+            }
+
+            double span = static_cast<double>(ramp.to) - static_cast<double>(ramp.from);
+            uint64_t value = progress >= 1.0
+                ? ramp.to
+                : static_cast<uint64_t>(static_cast<double>(ramp.from) + span * progress + 0.5);
+
+            // Channels are only written when their value moves; a slow ramp
+            // on a coarse period leaves most ticks without a syscall
+            if (value != ramp.last) {
+                ++writes;
+                if (ramp.channel->setDutyCycle(value)) {
+                    ramp.last = value;
+                } else {
+                    ++m_metrics.failures;
+                }
+            }
+
+            if (progress >= 1.0) {
+                ++m_metrics.completed;
+                if (ramp.onDone) {
+                    finished.push_back(std::move(ramp.onDone));
+                }
+                it = m_ramps.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_metrics.writes += writes;
+        idle = m_ramps.empty();
+    }
+    if (idle) {
+        m_changed.notify_all();
+    }
+    for (auto& callback : finished) {
+        callback();
+    }
+    return writes;
+}
+
+PWMRampMetrics PWMRampScheduler::getMetrics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_metrics;
+}
+
+void PWMRampScheduler::run() {
+    auto registration = cross_terminal::core::ThreadRegistry::instance().enter(
+        cross_terminal::core::ThreadRole::Hardware, "ct-pwm-ramp");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto next = std::chrono::steady_clock::now();
+    while (m_running) {
+        if (m_ramps.empty()) {
+            // Idle until a ramp arrives; the first tick runs immediately
+            m_changed.wait(lock, [this]() { return !m_running || !m_ramps.empty(); });
+            next = std::chrono::steady_clock::now();
+            continue;
+        }
+        if (m_changed.wait_until(lock, next, [this]() { return !m_running; })) {
+            break;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - next > m_tick) {
+            ++m_metrics.overruns;
+            next = now;
+        }
+        next += m_tick;
+
+        lock.unlock();
+        step(now);
+        lock.lock();
+    }
+}
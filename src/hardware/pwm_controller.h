@@ -0,0 +1,159 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// PWM outputs (fans, LEDs, backlights) through the Linux sysfs interface:
+// /sys/class/pwm/pwmchipN/pwmM/{period,duty_cycle,polarity,enable}.
+//
+// A channel keeps its period, duty_cycle and enable attributes open and
+// updates them with a single pwrite(), so a duty update costs one syscall
+// instead of open/write/close. Writes of the value already programmed are
+// skipped. PWMRampScheduler drives ramps and fades on many channels from
+// one thread, one write per channel per tick.
+
+enum class PWMPolarity {
+    Normal,
+    Inversed
+};
+
+enum class PWMEasing {
+    Linear,
+    EaseInOut   // Smoothstep, gentler start and end for visible fades
+};
+
+class PWMChannel {
+public:
+    static constexpr const char* DEFAULT_SYSFS_ROOT = "/sys/class/pwm";
+
+    PWMChannel(int chip, int channel, std::string sysfsRoot = DEFAULT_SYSFS_ROOT);
+    ~PWMChannel();
+
+    PWMChannel(const PWMChannel&) = delete;
+    PWMChannel& operator=(const PWMChannel&) = delete;
+
+    // Export the channel if needed and open its attributes. The current
+    // period, duty cycle and enable state are read back from sysfs.
+    bool open();
+    // Close the attributes; unexports the channel if open() exported it
+    void close();
+    bool isOpen() const;
+
+    // All setters return false if the channel is closed or the kernel
+    // rejected the value. Times are in nanoseconds.
+    bool setPeriod(uint64_t periodNs);
+    bool setDutyCycle(uint64_t dutyNs);
+    bool setDutyFraction(float fraction);   // 0..1 of the period
+    bool setPolarity(PWMPolarity polarity); // Most drivers require the channel disabled
+    bool enable(bool on);
+
+    uint64_t getPeriod() const;
+    uint64_t getDutyCycle() const;
+    bool isEnabled() const;
+
+    int getChip() const { return m_chip; }
+    int getChannel() const { return m_channel; }
+    const std::string& getPath() const { return m_path; }
+
+    // pwrite() calls issued, for metrics and tests
+    uint64_t getWriteCount() const;
+
+private:
+    const int m_chip;
+    const int m_channel;
+    const std::string m_chipPath;
+    const std::string m_path;
+
+    mutable std::mutex m_mutex;
+    int m_periodFd = -1;
+    int m_dutyFd = -1;
+    int m_enableFd = -1;
+    bool m_exported = false;   // Exported by open(), unexported by close()
+    uint64_t m_period = 0;
+    uint64_t m_duty = 0;
+    bool m_enabled = false;
+    uint64_t m_writes = 0;
+
+    bool writeLocked(int fd, uint64_t value);
+    void closeLocked();
+};
+
+struct PWMRampMetrics {
+    uint64_t ticks = 0;
+    uint64_t writes = 0;       // Duty updates issued
+    uint64_t failures = 0;     // Duty updates rejected by the kernel
+    uint64_t completed = 0;    // Ramps that reached their target
+    uint64_t overruns = 0;     // Ticks started later than one period late
+};
+
+class PWMRampScheduler {
+public:
+    static constexpr std::chrono::microseconds DEFAULT_TICK{10000};   // 100 Hz
+
+    explicit PWMRampScheduler(std::chrono::microseconds tick = DEFAULT_TICK);
+    ~PWMRampScheduler();
+
+    PWMRampScheduler(const PWMRampScheduler&) = delete;
+    PWMRampScheduler& operator=(const PWMRampScheduler&) = delete;
+
+    // Start and stop the ramp thread. Without it, step() drives the ramps.
+    void start();
+    void stop();
+
+    // Move a channel's duty cycle from its current value to targetNs over
+    // duration. Replaces a ramp already running on the channel, starting
+    // from wherever that one got to. onDone runs on the ramp thread once
+    // the target is written, and is not called if the ramp is replaced
+    // or cancelled.
+    void ramp(std::shared_ptr<PWMChannel> channel, uint64_t targetNs,
+              std::chrono::milliseconds duration, PWMEasing easing = PWMEasing::Linear,
+              std::function<void()> onDone = nullptr);
+    // Same as ramp() with the target given as a fraction of the period
+    void fade(std::shared_ptr<PWMChannel> channel, float targetFraction,
+              std::chrono::milliseconds duration, PWMEasing easing = PWMEasing::EaseInOut,
+              std::function<void()> onDone = nullptr);
+
+    // Stop a channel's ramp, leaving it at its current duty cycle
+    bool cancel(const PWMChannel* channel);
+    void cancelAll();
+
+    size_t activeRamps() const;
+    // Wait until no ramp is running, false on timeout
+    bool waitIdle(std::chrono::milliseconds timeout) const;
+
+    // Advance every ramp to `now` and write the new duty cycles. Called by
+    // the ramp thread once per tick. Returns the number of writes issued.
+    size_t step(std::chrono::steady_clock::time_point now);
+
+    PWMRampMetrics getMetrics() const;
+
+private:
+    struct Ramp {
+        std::shared_ptr<PWMChannel> channel;
+        uint64_t from = 0;
+        uint64_t to = 0;
+        std::chrono::steady_clock::time_point startTime;
+        std::chrono::steady_clock::duration duration{};
+        PWMEasing easing = PWMEasing::Linear;
+        uint64_t last = 0;   // Last value written by this ramp
+        std::function<void()> onDone;
+    };
+
+    const std::chrono::microseconds m_tick;
+
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_changed;
+    std::vector<Ramp> m_ramps;
+    std::thread m_thread;
+    bool m_running = false;
+    PWMRampMetrics m_metrics;
+
+    void run();
+};
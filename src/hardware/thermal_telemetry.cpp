@@ -0,0 +1,312 @@
+#include "thermal_telemetry.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Zones outside this range report a disconnected or unsupported sensor
+// (-40, -273, 0x7fffffff are common) rather than a real temperature
+constexpr float MIN_PLAUSIBLE_CELSIUS = -50.0f;
+constexpr float MAX_PLAUSIBLE_CELSIUS = 200.0f;
+
+int openAttribute(const std::string& path) {
+    return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+void closeFd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+// Read once at open() time: values that do not change while running
+std::string readText(const std::string& path) {
+    int fd = openAttribute(path);
+    if (fd < 0) {
+        return std::string();
+    }
+    char buffer[128];
+    ssize_t n = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    ::close(fd);
+    if (n <= 0) {
+        return std::string();
+    }
+    std::string text(buffer, static_cast<size_t>(n));
+    size_t newline = text.find('\n');
+    if (newline != std::string::npos) {
+        text.resize(newline);
+    }
+    return text;
+}
+
+// Numbered entries (thermal_zone3, cpu12) of a directory, by number
+std::vector<int> numberedEntries(const std::string& path, const char* prefix) {
+    std::vector<int> numbers;
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return numbers;
+    }
+    const size_t length = strlen(prefix);
+    while (dirent* entry = readdir(dir)) {
+        const char* name = entry->d_name;
+        if (strncmp(name, prefix, length) != 0 || name[length] == '\0') {
+            continue;
+        }
+        char* end = nullptr;
+        long number = strtol(name + length, &end, 10);
+        if (*end == '\0' && number >= 0 && number <= INT_MAX) {
+            numbers.push_back(static_cast<int>(number));
+        }
+    }
+    closedir(dir);
+    std::sort(numbers.begin(), numbers.end());
+    return numbers;
+}
+
+std::string canonicalPath(const std::string& path) {
+    char resolved[PATH_MAX];
+    return realpath(path.c_str(), resolved) ? std::string(resolved) : std::string();
+}
+
+} // namespace
+
+ThermalTelemetry::ThermalTelemetry(std::string sysfsRoot)
+    : m_sysfsRoot(std::move(sysfsRoot)) {
+}
+
+ThermalTelemetry::~ThermalTelemetry() {
+    close();
+}
+
+bool ThermalTelemetry::open() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return openLocked();
+}
+
+void ThermalTelemetry::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    closeLocked();
+}
+
+size_t ThermalTelemetry::zoneCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_zones.size();
+}
+
+size_t ThermalTelemetry::cpuCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cpus.size();
+}
+
+size_t ThermalTelemetry::openDescriptors() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const auto& zone : m_zones) {
+        count += zone.tempFd >= 0;
+    }
+    for (const auto& policy : m_policies) {
+        count += (policy.curFd >= 0) + (policy.minFd >= 0) + (policy.maxFd >= 0) + (policy.governorFd >= 0);
+    }
+    for (const auto& cpu : m_cpus) {
+        count += (cpu.onlineFd >= 0) + (cpu.throttleFd >= 0);
+    }
+    return count;
+}
+
+uint64_t ThermalTelemetry::getReadCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_reads;
+}
+
+bool ThermalTelemetry::openLocked() {
+    closeLocked();
+
+    const std::string thermalRoot = m_sysfsRoot + "/class/thermal/thermal_zone";
+    for (int index : numberedEntries(m_sysfsRoot + "/class/thermal", "thermal_zone")) {
+        const std::string path = thermalRoot + std::to_string(index);
+        Zone zone;
+        zone.index = index;
+        zone.type = readText(path + "/type");
+        zone.tempFd = openAttribute(path + "/temp");
+        for (int trip = 0; ; ++trip) {
+            const std::string prefix = path + "/trip_point_" + std::to_string(trip);
+            const std::string temp = readText(prefix + "_temp");
+            if (temp.empty()) {
+                break;
+            }
+            zone.trips.push_back({readText(prefix + "_type"), atoi(temp.c_str()) / 1000.0f});
+        }
+        m_zones.push_back(std::move(zone));
+    }
+
+    const std::string cpuRoot = m_sysfsRoot + "/devices/system/cpu";
+    for (int number : numberedEntries(cpuRoot, "cpu")) {
+        const std::string path = cpuRoot + "/cpu" + std::to_string(number);
+        CPU cpu;
+        cpu.cpu = number;
+        cpu.onlineFd = openAttribute(path + "/online");
+        cpu.throttleFd = openAttribute(path + "/thermal_throttle/core_throttle_count");
+
+        // cpuN/cpufreq links to the policy shared by a cluster
+        const std::string policyPath = canonicalPath(path + "/cpufreq");
+        if (!policyPath.empty()) {
+            auto it = std::find_if(m_policies.begin(), m_policies.end(),
+                                   [&policyPath](const Policy& policy) { return policy.path == policyPath; });
+            if (it == m_policies.end()) {
+                Policy policy;
+                policy.path = policyPath;
+                policy.curFd = openAttribute(policyPath + "/scaling_cur_freq");
+                policy.minFd = openAttribute(policyPath + "/scaling_min_freq");
+                policy.maxFd = openAttribute(policyPath + "/scaling_max_freq");
+                policy.governorFd = openAttribute(policyPath + "/scaling_governor");
+                policy.hardwareMaxKHz = static_cast<uint32_t>(
+                    strtoul(readText(policyPath + "/cpuinfo_max_freq").c_str(), nullptr, 10));
+                m_policies.push_back(std::move(policy));
+                it = m_policies.end() - 1;
+            }
+            cpu.policy = static_cast<int>(it - m_policies.begin());
+        }
+        m_cpus.push_back(cpu);
+    }
+
+    m_policyReadings.resize(m_policies.size());
+    m_open = true;
+    m_stale = false;
+    return !m_zones.empty() || !m_policies.empty();
+}
+
+void ThermalTelemetry::closeLocked() {
+    for (auto& zone : m_zones) {
+        closeFd(zone.tempFd);
+    }
+    for (auto& policy : m_policies) {
+        closeFd(policy.curFd);
+        closeFd(policy.minFd);
+        closeFd(policy.maxFd);
+        closeFd(policy.governorFd);
+    }
+    for (auto& cpu : m_cpus) {
+        closeFd(cpu.onlineFd);
+        closeFd(cpu.throttleFd);
+    }
+    m_zones.clear();
+    m_policies.clear();
+    m_cpus.clear();
+    m_open = false;
+}
+
+ssize_t ThermalTelemetry::readLocked(int fd, char* buffer, size_t size) {
+    if (fd < 0) {
+        return -1;
+    }
+    ++m_reads;
+    ssize_t n = pread(fd, buffer, size - 1, 0);
+    if (n < 0) {
+        // The device behind the attribute was removed. Sensors that are
+        // merely not ready (EAGAIN, EINVAL) just miss this sample.
+        if (errno == ENODEV) {
+            m_stale = true;
+        }
+        return -1;
+    }
+    while (n > 0 && (buffer[n - 1] == '\n' || buffer[n - 1] == ' ')) {
+        --n;
+    }
+    buffer[n] = '\0';
+    return n;
+}
+
+bool ThermalTelemetry::readNumberLocked(int fd, int64_t& value) {
+    char buffer[32];
+    ssize_t n = readLocked(fd, buffer, sizeof(buffer));
+    if (n <= 0) {
+        return false;
+    }
+    char* end = nullptr;
+    value = strtoll(buffer, &end, 10);
+    return end != buffer;
+}
+
+void ThermalTelemetry::sample(ThermalSample& out, bool zonesOnly) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open || m_stale) {
+        openLocked();
+    }
+
+    out.zones.resize(m_zones.size());
+    out.maxTemperature = 0.0f;
+    out.hottestZone = -1;
+    for (size_t i = 0; i < m_zones.size(); ++i) {
+        const Zone& zone = m_zones[i];
+        ThermalZoneReading& reading = out.zones[i];
+        reading.index = zone.index;
+        reading.type = zone.type;
+        reading.trips = zone.trips;
+
+        int64_t milli = 0;
+        const bool read = readNumberLocked(zone.tempFd, milli);
+        reading.temperature = milli / 1000.0f;
+        reading.valid = read && reading.temperature > MIN_PLAUSIBLE_CELSIUS &&
+                        reading.temperature < MAX_PLAUSIBLE_CELSIUS;
+        if (reading.valid && (out.hottestZone < 0 || reading.temperature > out.maxTemperature)) {
+            out.maxTemperature = reading.temperature;
+            out.hottestZone = zone.index;
+        }
+    }
+
+    if (zonesOnly) {
+        out.cpus.clear();
+        return;
+    }
+
+    char governor[32];
+    for (size_t i = 0; i < m_policies.size(); ++i) {
+        const Policy& policy = m_policies[i];
+        PolicyReading& reading = m_policyReadings[i];
+        int64_t cur = 0, min = 0, max = 0;
+        // An inactive policy (all its CPUs offline) fails its reads
+        reading.valid = readNumberLocked(policy.curFd, cur);
+        readNumberLocked(policy.minFd, min);
+        readNumberLocked(policy.maxFd, max);
+        reading.cur = reading.valid ? static_cast<uint32_t>(cur) : 0;
+        reading.min = static_cast<uint32_t>(min);
+        reading.max = static_cast<uint32_t>(max);
+        if (readLocked(policy.governorFd, governor, sizeof(governor)) > 0) {
+            reading.governor.assign(governor);
+        } else {
+            reading.governor.clear();
+        }
+    }
+
+    out.cpus.resize(m_cpus.size());
+    for (size_t i = 0; i < m_cpus.size(); ++i) {
+        const CPU& cpu = m_cpus[i];
+        CPUFrequencyReading& reading = out.cpus[i];
+        reading.cpu = cpu.cpu;
+
+        int64_t value = 1;
+        reading.online = cpu.onlineFd < 0 || !readNumberLocked(cpu.onlineFd, value) || value != 0;
+        reading.throttleCount = cpu.throttleFd >= 0 && readNumberLocked(cpu.throttleFd, value)
+            ? static_cast<uint64_t>(value) : 0;
+
+        if (cpu.policy >= 0) {
+            const PolicyReading& policy = m_policyReadings[cpu.policy];
+            reading.currentKHz = reading.online ? policy.cur : 0;
+            reading.minKHz = policy.min;
+            reading.maxKHz = policy.max;
+            reading.hardwareMaxKHz = m_policies[cpu.policy].hardwareMaxKHz;
+            reading.governor = policy.governor;
+        } else {
+            reading.currentKHz = reading.minKHz = reading.maxKHz = reading.hardwareMaxKHz = 0;
+            reading.governor.clear();
+        }
+        reading.capped = reading.maxKHz != 0 && reading.maxKHz < reading.hardwareMaxKHz;
+    }
+}
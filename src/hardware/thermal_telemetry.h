@@ -0,0 +1,102 @@
+#pragma once
+
+#include "hardware_controller.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+// Thermal zone and cpufreq telemetry from sysfs.
+//
+// open() enumerates every /sys/class/thermal/thermal_zoneN (type and trip
+// points, which do not change) and every CPU's cpufreq policy, and keeps
+// the attributes that do change open. A sample is then one pread() per
+// zone and four per policy (cur/min/max/governor; CPUs sharing a policy
+// share its reads) plus a throttle counter per CPU where the hardware has
+// one. A descriptor that starts failing (a zone or policy removed) marks
+// its reading invalid, and the next sample re-enumerates.
+
+struct ThermalSample {
+    std::vector<ThermalZoneReading> zones;
+    std::vector<CPUFrequencyReading> cpus;
+    float maxTemperature = 0.0f;   // Hottest valid zone
+    int hottestZone = -1;
+};
+
+class ThermalTelemetry {
+public:
+    static constexpr const char* DEFAULT_SYSFS_ROOT = "/sys";
+
+    explicit ThermalTelemetry(std::string sysfsRoot = DEFAULT_SYSFS_ROOT);
+    ~ThermalTelemetry();
+
+    ThermalTelemetry(const ThermalTelemetry&) = delete;
+    ThermalTelemetry& operator=(const ThermalTelemetry&) = delete;
+
+    // Enumerate zones and CPUs and open their attributes. Returns false if
+    // neither thermal zones nor cpufreq are present.
+    bool open();
+    void close();
+
+    // Read every zone and, unless zonesOnly, every CPU. Reuses out's
+    // storage, so a caller sampling periodically into the same
+    // ThermalSample does not allocate.
+    void sample(ThermalSample& out, bool zonesOnly = false);
+
+    size_t zoneCount() const;
+    size_t cpuCount() const;
+    size_t openDescriptors() const;
+    // pread() calls issued, for metrics and tests
+    uint64_t getReadCount() const;
+
+private:
+    struct Zone {
+        int index = -1;
+        std::string type;
+        std::vector<ThermalTripPoint> trips;
+        int tempFd = -1;
+    };
+
+    struct Policy {
+        std::string path;
+        int curFd = -1;
+        int minFd = -1;
+        int maxFd = -1;
+        int governorFd = -1;
+        uint32_t hardwareMaxKHz = 0;
+    };
+
+    struct CPU {
+        int cpu = -1;
+        int policy = -1;        // Index into m_policies, -1 without cpufreq
+        int onlineFd = -1;      // cpu0 usually has no online attribute
+        int throttleFd = -1;    // x86 thermal_throttle/core_throttle_count
+    };
+
+    const std::string m_sysfsRoot;
+
+    mutable std::mutex m_mutex;
+    std::vector<Zone> m_zones;
+    std::vector<Policy> m_policies;
+    std::vector<CPU> m_cpus;
+    bool m_open = false;
+    bool m_stale = false;   // A read failed; re-enumerate before the next sample
+    uint64_t m_reads = 0;
+
+    // Scratch for policy reads, shared by the CPUs of each policy
+    struct PolicyReading {
+        bool valid = false;
+        uint32_t cur = 0;
+        uint32_t min = 0;
+        uint32_t max = 0;
+        std::string governor;
+    };
+    std::vector<PolicyReading> m_policyReadings;
+
+    bool openLocked();
+    void closeLocked();
+    // pread the whole attribute into buffer; returns its length, -1 on error
+    ssize_t readLocked(int fd, char* buffer, size_t size);
+    bool readNumberLocked(int fd, int64_t& value);
+};
@@ -0,0 +1,170 @@
+#include "tone_synth.h"
+#include "core/implementations/thread_registry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Longest single segment play() accepts
+constexpr uint32_t MAX_SEGMENT_MS = 10000;
+
+} // namespace
+
+ToneSynthesizer::ToneSynthesizer(uint32_t sampleRate)
+    : m_sampleRate(sampleRate) {
+}
+
+uint32_t ToneSynthesizer::sampleRate() const {
+    return m_sampleRate;
+}
+
+size_t ToneSynthesizer::frameCount(const ToneSegment& segment) const {
+    return static_cast<size_t>(static_cast<uint64_t>(segment.durationMs) * m_sampleRate / 1000);
+}
+
+void ToneSynthesizer::render(const std::vector<ToneSegment>& segments, std::vector<int16_t>& out) const {
+    size_t total = out.size();
+    for (const auto& segment : segments) {
+        total += frameCount(segment);
+    }
+    size_t offset = out.size();
+    out.resize(total);
+    for (const auto& segment : segments) {
+        render(segment, out.data() + offset);
+        offset += frameCount(segment);
+    }
+}
+
+void ToneSynthesizer::render(const ToneSegment& segment, int16_t* out) const {
+    const size_t frames = frameCount(segment);
+    if (segment.frequency <= 0.0f || segment.amplitude <= 0.0f) {
+        memset(out, 0, frames * sizeof(int16_t));
+        return;
+    }
+
+    const float increment = segment.frequency / static_cast<float>(m_sampleRate);   // Cycles per frame
+    const float gain = std::min(segment.amplitude, 1.0f) * 32767.0f;
+    const float ramp = static_cast<float>(std::max<size_t>(
+        1, std::min<size_t>(static_cast<size_t>(RAMP_MS) * m_sampleRate / 1000, frames / 2)));
+    const float total = static_cast<float>(frames);
+
+    // Branch-free loops over fixed blocks, so each one vectorizes
+    float phase[BLOCK_FRAMES];
+    float sample[BLOCK_FRAMES];
+    double start = 0.0;   // Phase at the block start, kept in [0, 1)
+    for (size_t block = 0; block < frames; block += BLOCK_FRAMES) {
+        const size_t n = std::min(BLOCK_FRAMES, frames - block);
+        const float base = static_cast<float>(start);
+        for (size_t i = 0; i < n; ++i) {
+            float p = base + static_cast<float>(i) * increment;
+            phase[i] = p - std::floor(p);
+        }
+        // sin(2*pi*p) = -sin(pi*t) with t = 2p - 1 in [-1, 1), from a
+        // parabola refined to within 0.1% of full scale
+        for (size_t i = 0; i < n; ++i) {
+            const float t = 2.0f * phase[i] - 1.0f;
+            const float s = 4.0f * t * (1.0f - std::fabs(t));
+            sample[i] = -s * (0.775f + 0.225f * std::fabs(s));
+        }
+        // Linear attack and release
+        for (size_t i = 0; i < n; ++i) {
+            const float position = static_cast<float>(block + i);
+            const float envelope = std::min(1.0f, std::min(position + 1.0f, total - position) / ramp);
+            out[block + i] = static_cast<int16_t>(sample[i] * envelope * gain);
+        }
+        start += static_cast<double>(n) * increment;
+        start -= std::floor(start);
+    }
+}
+
+TonePlayer::TonePlayer(std::unique_ptr<PcmSink> sink)
+    : m_sink(std::move(sink)),
+      m_synth(m_sink ? m_sink->sampleRate() : PcmSink::DEFAULT_SAMPLE_RATE) {
+}
+
+TonePlayer::~TonePlayer() {
+    stop();
+}
+
+bool TonePlayer::hasSink() const {
+    return m_sink != nullptr;
+}
+
+bool TonePlayer::play(std::vector<ToneSegment> segments) {
+    if (!m_sink || segments.empty()) {
+        return false;
+    }
+    const float nyquist = static_cast<float>(m_synth.sampleRate()) / 2.0f;
+    for (const auto& segment : segments) {
+        if (segment.durationMs > MAX_SEGMENT_MS || segment.frequency < 0.0f || segment.frequency >= nyquist) {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopping || m_queue.size() >= MAX_QUEUED) {
+        return false;
+    }
+    m_queue.push_back(std::move(segments));
+    if (!m_running) {
+        m_running = true;
+        m_thread = std::thread(&TonePlayer::run, this);
+    }
+    m_wake.notify_one();
+    return true;
+}
+
+void TonePlayer::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return (m_queue.empty() && !m_busy) || !m_running; });
+}
+
+void TonePlayer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_queue.clear();
+        m_wake.notify_one();
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = false;
+    m_stopping = false;
+    m_idle.notify_all();
+}
+
+void TonePlayer::run() {
+    auto registration = cross_terminal::core::ThreadRegistry::instance().enter(
+        cross_terminal::core::ThreadRole::Hardware, "ct-tone");
+
+    std::vector<int16_t> buffer;   // Reused; grows to the longest sequence
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+        if (m_stopping) {
+            break;
+        }
+        std::vector<ToneSegment> segments = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_busy = true;
+        lock.unlock();
+
+        buffer.clear();
+        m_synth.render(segments, buffer);
+        m_sink->write(buffer.data(), buffer.size());
+
+        lock.lock();
+        if (m_queue.empty()) {
+            // Back-to-back sequences play without a gap; drain only when idle
+            lock.unlock();
+            m_sink->drain();
+            lock.lock();
+        }
+        m_busy = false;
+        m_idle.notify_all();
+    }
+    m_busy = false;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "pcm_sink.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Tone synthesis for beeps and short notification sequences.
+//
+// ToneSynthesizer renders sine tones into 16-bit PCM in fixed blocks:
+// phases, a polynomial sine and a linear attack/release envelope are
+// computed over plain float arrays, which the compiler vectorizes (NEON
+// on arm64). A 200 ms beep at 48 kHz renders in microseconds. TonePlayer
+// feeds a PcmSink from its own thread, so play() only queues the request.
+
+struct ToneSegment {
+    float frequency = 0.0f;     // Hz; 0 is a rest
+    uint32_t durationMs = 0;
+    float amplitude = 0.5f;     // 0..1 of full scale
+};
+
+class ToneSynthesizer {
+public:
+    static constexpr size_t BLOCK_FRAMES = 256;
+    // Ramps at both ends of every tone; a hard start or stop clicks
+    static constexpr uint32_t RAMP_MS = 4;
+
+    explicit ToneSynthesizer(uint32_t sampleRate = PcmSink::DEFAULT_SAMPLE_RATE);
+
+    uint32_t sampleRate() const;
+    size_t frameCount(const ToneSegment& segment) const;
+
+    // Append the rendering of every segment to out
+    void render(const std::vector<ToneSegment>& segments, std::vector<int16_t>& out) const;
+    // Render one segment into exactly frameCount(segment) samples
+    void render(const ToneSegment& segment, int16_t* out) const;
+
+private:
+    const uint32_t m_sampleRate;
+};
+
+class TonePlayer {
+public:
+    static constexpr size_t MAX_QUEUED = 8;   // Further requests are refused
+
+    explicit TonePlayer(std::unique_ptr<PcmSink> sink);
+    ~TonePlayer();
+
+    TonePlayer(const TonePlayer&) = delete;
+    TonePlayer& operator=(const TonePlayer&) = delete;
+
+    bool hasSink() const;
+
+    // Queue a sequence and return; false without a sink, for an empty or
+    // invalid sequence, or when MAX_QUEUED sequences are already waiting
+    bool play(std::vector<ToneSegment> segments);
+    // Block until everything queued has been written and drained
+    void wait();
+    void stop();
+
+private:
+    const std::unique_ptr<PcmSink> m_sink;
+    const ToneSynthesizer m_synth;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::deque<std::vector<ToneSegment>> m_queue;
+    bool m_busy = false;
+    bool m_running = false;
+    bool m_stopping = false;
+    std::thread m_thread;
+
+    void run();
+};
@@ -0,0 +1,270 @@
+#include "uevent_monitor.h"
+#include "core/implementations/thread_registry.h"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#endif
+
+namespace {
+
+// A uevent datagram is bounded by the kernel's UEVENT_BUFFER_SIZE (2048)
+// plus the action@devpath header
+constexpr size_t MAX_UEVENT_SIZE = 8192;
+
+const std::string EMPTY;
+
+} // namespace
+
+const std::string& UeventMessage::get(const std::string& key) const {
+    for (const auto& property : properties) {
+        if (property.first == key) {
+            return property.second;
+        }
+    }
+    return EMPTY;
+}
+
+std::string UeventMessage::deviceName() const {
+    size_t slash = devpath.rfind('/');
+    return slash == std::string::npos ? devpath : devpath.substr(slash + 1);
+}
+
+bool UeventMessage::changesTopology() const {
+    return action == "add" || action == "remove" || action == "move" ||
+           action == "bind" || action == "unbind" || action == UeventMonitor::RESYNC_ACTION;
+}
+
+bool UeventMessage::parse(const char* data, size_t size, UeventMessage& out) {
+    // Header: "action@devpath", NUL-terminated. udev's own broadcasts start
+    // with "libudev" and carry a binary header instead.
+    const char* end = data + size;
+    const char* header_end = static_cast<const char*>(memchr(data, '\0', size));
+    if (!header_end) {
+        return false;
+    }
+    const char* at = static_cast<const char*>(memchr(data, '@', header_end - data));
+    if (!at || at == data) {
+        return false;
+    }
+
+    out.action.assign(data, at);
+    out.devpath.assign(at + 1, header_end);
+    out.subsystem.clear();
+    out.properties.clear();
+
+    for (const char* p = header_end + 1; p < end;) {
+        const char* entry_end = static_cast<const char*>(memchr(p, '\0', end - p));
+        if (!entry_end) {
+            entry_end = end;
+        }
+        const char* equals = static_cast<const char*>(memchr(p, '=', entry_end - p));
+        if (equals) {
+            out.properties.emplace_back(std::string(p, equals), std::string(equals + 1, entry_end));
+            if (out.properties.back().first == "SUBSYSTEM") {
+                out.subsystem = out.properties.back().second;
+            }
+        }
+        p = entry_end + 1;
+    }
+
+    // The properties repeat the header; prefer them where present
+    const std::string& action = out.get("ACTION");
+    if (!action.empty()) {
+        out.action = action;
+    }
+    const std::string& devpath = out.get("DEVPATH");
+    if (!devpath.empty()) {
+        out.devpath = devpath;
+    }
+    return true;
+}
+
+UeventMonitor::UeventMonitor() = default;
+
+UeventMonitor::~UeventMonitor() {
+    stop();
+}
+
+bool UeventMonitor::start(std::string* error) {
+    if (m_running) {
+        return true;
+    }
+#ifdef __linux__
+    auto fail = [error](const char* what) {
+        if (error) {
+            *error = std::string(what) + ": " + strerror(errno);
+        }
+        return false;
+    };
+
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) {
+        return fail("uevent socket");
+    }
+
+    // SO_RCVBUFFORCE exceeds rmem_max but needs CAP_NET_ADMIN
+    int size = RECEIVE_BUFFER_SIZE;
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) != 0) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    }
+
+    sockaddr_nl address = {};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1;   // Kernel broadcast group; group 2 is udev's rebroadcast
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        int saved = errno;
+        ::close(fd);
+        errno = saved;
+        return fail("uevent bind");
+    }
+
+    int wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake < 0) {
+        int saved = errno;
+        ::close(fd);
+        errno = saved;
+        return fail("eventfd");
+    }
+
+    m_socket = fd;
+    m_wakeFd = wake;
+    m_running = true;
+    m_thread = std::thread(&UeventMonitor::run, this);
+    return true;
+#else
+    if (error) {
+        *error = "uevents are not supported on this platform";
+    }
+    return false;
+#endif
+}
+
+void UeventMonitor::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    uint64_t one = 1;
+    ssize_t ignored = ::write(m_wakeFd, &one, sizeof(one));
+    (void)ignored;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    ::close(m_socket);
+    ::close(m_wakeFd);
+    m_socket = -1;
+    m_wakeFd = -1;
+}
+
+bool UeventMonitor::isRunning() const {
+    return m_running;
+}
+
+int UeventMonitor::subscribe(const std::string& subsystem, Handler handler) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int id = m_nextId++;
+    m_subscriptions.push_back({id, subsystem, std::make_shared<Handler>(std::move(handler))});
+    return id;
+}
+
+void UeventMonitor::unsubscribe(int id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto it = m_subscriptions.begin(); it != m_subscriptions.end(); ++it) {
+        if (it->id == id) {
+            m_subscriptions.erase(it);
+            return;
+        }
+    }
+}
+
+void UeventMonitor::dispatch(const UeventMessage& message) {
+    // Handlers run without the lock so they may subscribe or query freely;
+    // the shared_ptr keeps a handler alive if it is unsubscribed meanwhile
+    std::vector<std::shared_ptr<Handler>> handlers;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const bool resync = message.action == RESYNC_ACTION;
+        for (const auto& subscription : m_subscriptions) {
+            if (resync || subscription.subsystem.empty() || subscription.subsystem == message.subsystem) {
+                handlers.push_back(subscription.handler);
+            }
+        }
+    }
+    for (const auto& handler : handlers) {
+        (*handler)(message);
+    }
+    m_dispatched += handlers.size();
+}
+
+UeventMetrics UeventMonitor::getMetrics() const {
+    UeventMetrics metrics;
+    metrics.received = m_received;
+    metrics.dispatched = m_dispatched;
+    metrics.malformed = m_malformed;
+    metrics.overflows = m_overflows;
+    return metrics;
+}
+
+void UeventMonitor::run() {
+#ifdef __linux__
+    auto registration = cross_terminal::core::ThreadRegistry::instance().enter(
+        cross_terminal::core::ThreadRole::Hardware, "ct-uevent");
+
+    std::unique_ptr<char[]> buffer(new char[MAX_UEVENT_SIZE]);
+    UeventMessage message;   // Reused, keeps its string capacity
+
+    while (m_running) {
+        pollfd fds[2] = {{m_socket, POLLIN, 0}, {m_wakeFd, POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents) {
+            break;
+        }
+
+        // Drain everything queued before sleeping again
+        while (m_running) {
+            sockaddr_nl sender = {};
+            iovec iov = {buffer.get(), MAX_UEVENT_SIZE};
+            msghdr header = {};
+            header.msg_name = &sender;
+            header.msg_namelen = sizeof(sender);
+            header.msg_iov = &iov;
+            header.msg_iovlen = 1;
+
+            ssize_t n = recvmsg(m_socket, &header, 0);
+            if (n < 0) {
+                if (errno == ENOBUFS) {
+                    // The kernel dropped events; whatever they described is stale
+                    ++m_overflows;
+                    UeventMessage resync;
+                    resync.action = RESYNC_ACTION;
+                    dispatch(resync);
+                    continue;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;   // EAGAIN: drained
+            }
+            ++m_received;
+
+            // Only the kernel (port 0) may speak on the broadcast group
+            if (sender.nl_pid != 0 || (header.msg_flags & MSG_TRUNC) ||
+                !UeventMessage::parse(buffer.get(), static_cast<size_t>(n), message)) {
+                ++m_malformed;
+                continue;
+            }
+            dispatch(message);
+        }
+    }
+#endif
+}
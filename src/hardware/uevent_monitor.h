@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Kernel device events (uevents) received on a NETLINK_KOBJECT_UEVENT
+// socket: the same add/remove/change notifications udev acts on, without
+// depending on udev or polling sysfs.
+//
+// One thread blocks on the socket and hands each event to the handlers
+// subscribed to its subsystem. If the socket's receive buffer overflows,
+// events were lost; subscribers then get a synthetic RESYNC_ACTION event
+// and should rescan whatever state they derive from uevents.
+
+struct UeventMessage {
+    std::string action;      // add, remove, change, bind, unbind, move, online, offline
+    std::string devpath;     // Relative to /sys, e.g. /devices/.../power_supply/battery
+    std::string subsystem;   // power_supply, thermal, hwmon, iio, ...
+    std::vector<std::pair<std::string, std::string>> properties;   // KEY=VALUE pairs, in order
+
+    // Value of a property, empty if absent
+    const std::string& get(const std::string& key) const;
+
+    // Last path component of devpath: the device's name in /sys/class/<subsystem>
+    std::string deviceName() const;
+
+    // Whether the event can change which devices exist, as opposed to a
+    // state change of an existing device
+    bool changesTopology() const;
+
+    // Parse a kernel uevent datagram ("action@devpath\0KEY=VALUE\0...").
+    // Messages rebroadcast by udev (libudev header) are rejected.
+    static bool parse(const char* data, size_t size, UeventMessage& out);
+};
+
+struct UeventMetrics {
+    uint64_t received = 0;     // Datagrams read from the socket
+    uint64_t dispatched = 0;   // Handler invocations
+    uint64_t malformed = 0;    // Datagrams that failed to parse or did not come from the kernel
+    uint64_t overflows = 0;    // Receive buffer overruns (events lost, resync sent)
+};
+
+class UeventMonitor {
+public:
+    using Handler = std::function<void(const UeventMessage&)>;
+
+    static constexpr const char* RESYNC_ACTION = "resync";
+    static constexpr int RECEIVE_BUFFER_SIZE = 1024 * 1024;   // Absorbs coldplug bursts
+
+    UeventMonitor();
+    ~UeventMonitor();
+
+    UeventMonitor(const UeventMonitor&) = delete;
+    UeventMonitor& operator=(const UeventMonitor&) = delete;
+
+    // Open the netlink socket and start the listener thread. Fails where
+    // uevent sockets are not permitted (e.g. untrusted Android apps, some
+    // containers); callers then keep working from their startup scan.
+    bool start(std::string* error = nullptr);
+    void stop();
+    bool isRunning() const;
+
+    // Receive events of one subsystem, or of all with an empty subsystem.
+    // Handlers run on the listener thread; one already picked for an event
+    // in flight can still run after unsubscribe() returns.
+    int subscribe(const std::string& subsystem, Handler handler);
+    void unsubscribe(int id);
+
+    // Deliver an event as if it had been received, for tests and for
+    // replaying synthetic events
+    void dispatch(const UeventMessage& message);
+
+    UeventMetrics getMetrics() const;
+
+private:
+    struct Subscription {
+        int id;
+        std::string subsystem;
+        std::shared_ptr<Handler> handler;
+    };
+
+    mutable std::mutex m_mutex;
+    std::vector<Subscription> m_subscriptions;
+    int m_nextId = 1;
+
+    int m_socket = -1;
+    int m_wakeFd = -1;   // eventfd signalled by stop()
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+
+    std::atomic<uint64_t> m_received{0};
+    std::atomic<uint64_t> m_dispatched{0};
+    std::atomic<uint64_t> m_malformed{0};
+    std::atomic<uint64_t> m_overflows{0};
+
+    void run();
+};
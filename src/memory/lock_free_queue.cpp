@@ -0,0 +1,71 @@
+#include "lock_free_queue.h"
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#endif
+
+namespace cross_terminal {
+namespace memory {
+
+#if defined(__linux__)
+
+void FutexWait::wait(uint32_t observed) noexcept {
+    // Returns at once with EAGAIN if epoch_ already moved on; spurious
+    // wakeups and EINTR are handled by the caller's re-check
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE,
+            observed, nullptr, nullptr, 0);
+}
+
+void FutexWait::wake(int32_t count) noexcept {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAKE_PRIVATE,
+            count, nullptr, nullptr, 0);
+}
+
+#else
+
+namespace {
+
+// Parking table shared by all FutexWait instances on platforms without
+// a futex: waiters sleep on the bucket their epoch address hashes to
+struct ParkingBucket {
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+constexpr size_t PARKING_BUCKETS = 64;
+
+ParkingBucket& bucket_for(const void* address) {
+    static ParkingBucket buckets[PARKING_BUCKETS];
+    return buckets[std::hash<const void*>()(address) % PARKING_BUCKETS];
+}
+
+} // namespace
+
+void FutexWait::wait(uint32_t observed) noexcept {
+    ParkingBucket& bucket = bucket_for(&epoch_);
+    std::unique_lock lock(bucket.mutex);
+    bucket.condition.wait(lock, [&]() {
+        return epoch_.load(std::memory_order_seq_cst) != observed;
+    });
+}
+
+void FutexWait::wake(int32_t) noexcept {
+    ParkingBucket& bucket = bucket_for(&epoch_);
+    {
+        // Pairs with the predicate check under the lock in wait()
+        std::lock_guard lock(bucket.mutex);
+    }
+    // Buckets are shared, so a targeted wake could hit the wrong waiter
+    bucket.condition.notify_all();
+}
+
+#endif
+
+} // namespace memory
+} // namespace cross_terminal
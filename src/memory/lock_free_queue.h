@@ -0,0 +1,399 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace cross_terminal {
+namespace memory {
+
+// Lock-free hand-off queues:
+//   SpscRing   - bounded, one producer and one consumer thread
+//   MpscQueue  - unbounded intrusive, any producers, one consumer thread
+//   MpmcQueue  - bounded, any producers and consumers
+// None of them block. Pair a queue with SpinWait or FutexWait when the
+// consumer has to sleep until an element arrives.
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Keeps a hot index on its own cache line so that producer and consumer
+// updates do not invalidate each other
+template<typename T>
+struct alignas(CACHE_LINE_SIZE) CachePadded {
+    T value{};
+
+    CachePadded() = default;
+
+    template<typename Arg>
+    explicit CachePadded(Arg&& initial) : value(std::forward<Arg>(initial)) {}
+};
+
+// Busy-wait hint: lets the sibling hyperthread run and saves power
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+inline size_t round_up_pow2(size_t value) noexcept {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Bounded single-producer single-consumer ring. Each side caches the
+// other side's index and only reloads it when the ring looks full or
+// empty, so the steady state touches no shared cache line besides the
+// slots themselves.
+template<typename T>
+class SpscRing {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity)
+        : mask_(round_up_pow2(capacity) - 1)
+        , slots_(new Slot[mask_ + 1]) {
+    }
+
+    ~SpscRing() {
+        const size_t tail = producer_.value.tail.load(std::memory_order_acquire);
+        for (size_t head = consumer_.value.head.load(std::memory_order_relaxed); head != tail; ++head) {
+            reinterpret_cast<T*>(slots_[head & mask_].data)->~T();
+        }
+    }
+
+    // Non-copyable, non-movable
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    SpscRing(SpscRing&&) = delete;
+    SpscRing& operator=(SpscRing&&) = delete;
+
+    // Producer thread only
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        auto& producer = producer_.value;
+        const size_t tail = producer.tail.load(std::memory_order_relaxed);
+        if (tail - producer.cached_head > mask_) {
+            producer.cached_head = consumer_.value.head.load(std::memory_order_acquire);
+            if (tail - producer.cached_head > mask_) {
+                return false;
+            }
+        }
+        new (slots_[tail & mask_].data) T(std::forward<Args>(args)...);
+        producer.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value) { return try_emplace(value); }
+    bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+    // Consumer thread only
+    bool try_pop(T& out) {
+        auto& consumer = consumer_.value;
+        const size_t head = consumer.head.load(std::memory_order_relaxed);
+        if (head == consumer.cached_tail) {
+            consumer.cached_tail = producer_.value.tail.load(std::memory_order_acquire);
+            if (head == consumer.cached_tail) {
+                return false;
+            }
+        }
+        T* slot = reinterpret_cast<T*>(slots_[head & mask_].data);
+        out = std::move(*slot);
+        slot->~T();
+        consumer.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size_approx() const noexcept {
+        const size_t head = consumer_.value.head.load(std::memory_order_acquire);
+        const size_t tail = producer_.value.tail.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool empty() const noexcept { return size_approx() == 0; }
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    struct ProducerState {
+        std::atomic<size_t> tail{0};
+        size_t cached_head = 0;
+    };
+
+    struct ConsumerState {
+        std::atomic<size_t> head{0};
+        size_t cached_tail = 0;
+    };
+
+    CachePadded<ProducerState> producer_;
+    CachePadded<ConsumerState> consumer_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+};
+
+// Hook embedded in elements of an MpscQueue
+struct MpscNode {
+    std::atomic<MpscNode*> mpsc_next{nullptr};
+};
+
+// Unbounded intrusive multi-producer single-consumer queue (Vyukov).
+// push() is wait-free: one exchange and one store. The queue never
+// allocates and does not own its nodes; whoever pops a node owns it.
+// pop() can transiently return nullptr while a producer is between its
+// two steps; the element becomes visible once that push completes.
+template<typename Node>
+class MpscQueue {
+    static_assert(std::is_base_of<MpscNode, Node>::value, "Node must derive from MpscNode");
+
+public:
+    MpscQueue() noexcept : head_(&stub_), tail_(&stub_) {}
+
+    // Non-copyable, non-movable
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    MpscQueue(MpscQueue&&) = delete;
+    MpscQueue& operator=(MpscQueue&&) = delete;
+
+    // Any thread
+    void push(Node* node) noexcept {
+        enqueue(node);
+    }
+
+    // Consumer thread only
+    Node* pop() noexcept {
+        MpscNode* tail = tail_;
+        MpscNode* next = tail->mpsc_next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (!next) {
+                return nullptr;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->mpsc_next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail_ = next;
+            return static_cast<Node*>(tail);
+        }
+        if (tail != head_.value.load(std::memory_order_acquire)) {
+            return nullptr; // A producer has not linked its node yet
+        }
+        // tail is the last node: park the stub behind it to detach it
+        enqueue(&stub_);
+        next = tail->mpsc_next.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return static_cast<Node*>(tail);
+        }
+        return nullptr;
+    }
+
+    // Consumer thread only; may miss a push that is in progress
+    bool empty() const noexcept {
+        return tail_ == &stub_ && !stub_.mpsc_next.load(std::memory_order_acquire);
+    }
+
+private:
+    CachePadded<std::atomic<MpscNode*>> head_;   // Producers
+    alignas(CACHE_LINE_SIZE) MpscNode* tail_;    // Consumer
+    MpscNode stub_;
+
+    void enqueue(MpscNode* node) noexcept {
+        node->mpsc_next.store(nullptr, std::memory_order_relaxed);
+        MpscNode* previous = head_.value.exchange(node, std::memory_order_acq_rel);
+        previous->mpsc_next.store(node, std::memory_order_release);
+    }
+};
+
+// Bounded multi-producer multi-consumer queue (Vyukov). Every cell
+// carries a sequence number telling producers and consumers whose turn
+// it is, so each operation is one CAS on a padded position counter.
+template<typename T>
+class MpmcQueue {
+public:
+    // Capacity is rounded up to a power of two
+    explicit MpmcQueue(size_t capacity)
+        : mask_(round_up_pow2(capacity) - 1)
+        , cells_(new Cell[mask_ + 1]) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpmcQueue() {
+        const size_t tail = enqueue_position_.value.load(std::memory_order_acquire);
+        for (size_t head = dequeue_position_.value.load(std::memory_order_relaxed); head != tail; ++head) {
+            reinterpret_cast<T*>(cells_[head & mask_].data)->~T();
+        }
+    }
+
+    // Non-copyable, non-movable
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+    MpmcQueue(MpmcQueue&&) = delete;
+    MpmcQueue& operator=(MpmcQueue&&) = delete;
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_t position = enqueue_position_.value.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[position & mask_];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueue_position_.value.compare_exchange_weak(position, position + 1,
+                                                                   std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false; // Full
+            } else {
+                position = enqueue_position_.value.load(std::memory_order_relaxed);
+            }
+        }
+        new (cell->data) T(std::forward<Args>(args)...);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& value) { return try_emplace(value); }
+    bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+    bool try_pop(T& out) {
+        size_t position = dequeue_position_.value.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[position & mask_];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (difference == 0) {
+                if (dequeue_position_.value.compare_exchange_weak(position, position + 1,
+                                                                   std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false; // Empty
+            } else {
+                position = dequeue_position_.value.load(std::memory_order_relaxed);
+            }
+        }
+        T* element = reinterpret_cast<T*>(cell->data);
+        out = std::move(*element);
+        element->~T();
+        cell->sequence.store(position + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size_approx() const noexcept {
+        const size_t head = dequeue_position_.value.load(std::memory_order_acquire);
+        const size_t tail = enqueue_position_.value.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    CachePadded<std::atomic<size_t>> enqueue_position_;
+    CachePadded<std::atomic<size_t>> dequeue_position_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+};
+
+// Wait strategies. The consumer calls await() with a predicate that
+// tries to take an element; producers call notify_one() after a push.
+
+// Spins, then yields. Lowest latency, burns a core while idle.
+class SpinWait {
+public:
+    static constexpr uint32_t SPIN_LIMIT = 128;
+
+    template<typename Predicate>
+    void await(Predicate&& ready) {
+        for (uint32_t spins = 0; !ready(); ++spins) {
+            if (spins < SPIN_LIMIT) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void notify_one() noexcept {}
+    void notify_all() noexcept {}
+};
+
+// Spins briefly, then sleeps in the kernel (futex on Linux and Android,
+// a parking table elsewhere). Producers only make a syscall when a
+// consumer is actually asleep.
+class FutexWait {
+public:
+    static constexpr uint32_t SPIN_LIMIT = 64;
+
+    template<typename Predicate>
+    void await(Predicate&& ready) {
+        for (uint32_t spins = 0; spins < SPIN_LIMIT; ++spins) {
+            if (ready()) {
+                return;
+            }
+            cpu_relax();
+        }
+        for (;;) {
+            // Register before re-checking: a producer either sees us in
+            // waiters_ or its element is visible to the check below
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            const uint32_t epoch = epoch_.load(std::memory_order_seq_cst);
+            if (ready()) {
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            wait(epoch);
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+            if (ready()) {
+                return;
+            }
+        }
+    }
+
+    void notify_one() noexcept { notify(1); }
+    void notify_all() noexcept { notify(INT32_MAX); }
+
+private:
+    std::atomic<uint32_t> epoch_{0};
+    std::atomic<uint32_t> waiters_{0};
+
+    void notify(int32_t count) noexcept {
+        // Orders the caller's push before the waiters_ check; with no
+        // sleeper the notification costs no shared write at all
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) != 0) {
+            epoch_.fetch_add(1, std::memory_order_seq_cst);
+            wake(count);
+        }
+    }
+
+    // Sleep while epoch_ still equals the observed value
+    void wait(uint32_t observed) noexcept;
+    void wake(int32_t count) noexcept;
+};
+
+} // namespace memory
+} // namespace cross_terminal
@@ -0,0 +1,330 @@
+#include "memory_budget.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__GLIBC__) || defined(__BIONIC__)
+#include <malloc.h>
+#endif
+
+namespace cross_terminal {
+namespace memory {
+
+// Static member definitions
+MemoryBudget* MemoryBudget::instance_ = nullptr;
+std::once_flag MemoryBudget::init_flag_;
+
+namespace {
+
+// ComponentCallbacks2 trim levels
+constexpr int TRIM_MEMORY_RUNNING_MODERATE = 5;
+constexpr int TRIM_MEMORY_RUNNING_LOW = 10;
+constexpr int TRIM_MEMORY_RUNNING_CRITICAL = 15;
+constexpr int TRIM_MEMORY_UI_HIDDEN = 20;
+constexpr int TRIM_MEMORY_BACKGROUND = 40;
+constexpr int TRIM_MEMORY_MODERATE = 60;
+constexpr int TRIM_MEMORY_COMPLETE = 80;
+
+// Highest cache priority a pressure level may shrink
+CachePriority max_priority(PressureLevel level) noexcept {
+    switch (level) {
+        case PressureLevel::Moderate: return CachePriority::Disposable;
+        case PressureLevel::Severe: return CachePriority::Recomputable;
+        default: return CachePriority::UserVisible;
+    }
+}
+
+void release_heap_to_system() noexcept {
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#elif defined(__BIONIC__) && defined(M_PURGE)
+    mallopt(M_PURGE, 0);
+#endif
+}
+
+} // namespace
+
+const char* tag_name(MemoryTag tag) noexcept {
+    switch (tag) {
+        case MemoryTag::Scrollback: return "scrollback";
+        case MemoryTag::History: return "history";
+        case MemoryTag::DirectoryCache: return "directory-cache";
+        case MemoryTag::ProcessPool: return "process-pool";
+        case MemoryTag::Interner: return "interner";
+        case MemoryTag::Other: return "other";
+        default: return "unknown";
+    }
+}
+
+// MemoryBudget implementation
+MemoryBudget& MemoryBudget::instance() {
+    std::call_once(init_flag_, []() {
+        instance_ = new MemoryBudget();
+    });
+    return *instance_;
+}
+
+void MemoryBudget::charge(MemoryTag tag, size_t bytes) noexcept {
+    usage_[static_cast<size_t>(tag)].fetch_add(bytes, std::memory_order_relaxed);
+    const size_t total = total_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+    const size_t limit = limit_.load(std::memory_order_relaxed);
+    if (limit != 0 && total > limit && !enforce_pending_.exchange(true)) {
+        // Never shrink inline: the caller may hold the locks a cache needs
+        bool queued = false;
+        try {
+            queued = dispatch([this]() { enforce_limit(); });
+        } catch (...) {
+        }
+        if (!queued) {
+            enforce_pending_.store(false);
+        }
+    }
+}
+
+void MemoryBudget::release(MemoryTag tag, size_t bytes) noexcept {
+    usage_[static_cast<size_t>(tag)].fetch_sub(bytes, std::memory_order_relaxed);
+    total_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryBudget::usage(MemoryTag tag) const noexcept {
+    return usage_[static_cast<size_t>(tag)].load(std::memory_order_relaxed);
+}
+
+size_t MemoryBudget::total_usage() const noexcept {
+    return total_.load(std::memory_order_relaxed);
+}
+
+void MemoryBudget::set_limit(size_t bytes) noexcept {
+    limit_.store(bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryBudget::limit() const noexcept {
+    return limit_.load(std::memory_order_relaxed);
+}
+
+void MemoryBudget::set_dispatcher(Dispatcher dispatcher) {
+    std::lock_guard lock(dispatcher_mutex_);
+    dispatcher_ = std::move(dispatcher);
+}
+
+MemoryBudget::CacheId MemoryBudget::register_cache(std::string name, MemoryTag tag,
+                                                   CachePriority priority,
+                                                   ShrinkCallback shrink) {
+    std::unique_lock lock(caches_mutex_);
+    const CacheId id = next_cache_id_++;
+
+    // Keep the list ordered: stable within one priority class
+    auto position = std::upper_bound(caches_.begin(), caches_.end(), priority,
+        [](CachePriority value, const Cache& cache) { return value < cache.priority; });
+    caches_.insert(position, Cache{id, std::move(name), tag, priority, std::move(shrink)});
+    return id;
+}
+
+void MemoryBudget::unregister_cache(CacheId id) {
+    std::unique_lock lock(caches_mutex_);
+    caches_.erase(std::remove_if(caches_.begin(), caches_.end(),
+                                 [id](const Cache& cache) { return cache.id == id; }),
+                  caches_.end());
+}
+
+size_t MemoryBudget::shrink(PressureLevel level) {
+    if (level == PressureLevel::None) {
+        return 0;
+    }
+
+    std::lock_guard pass(shrink_mutex_);
+    enforce_pending_.store(false);
+    last_level_.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+
+    const CachePriority allowed = max_priority(level);
+    size_t reclaimed = 0;
+    {
+        std::shared_lock lock(caches_mutex_);
+        for (const auto& cache : caches_) {
+            if (cache.priority > allowed) {
+                break;
+            }
+            try {
+                reclaimed += cache.shrink(level);
+            } catch (...) {
+                // A failing cache must not stop the others from shrinking
+            }
+        }
+    }
+
+    release_heap_to_system();
+    shrink_passes_.fetch_add(1, std::memory_order_relaxed);
+    bytes_reclaimed_.fetch_add(reclaimed, std::memory_order_relaxed);
+    return reclaimed;
+}
+
+void MemoryBudget::on_pressure(PressureLevel level) {
+    if (level == PressureLevel::None) {
+        return;
+    }
+    if (!dispatch([this, level]() { shrink(level); })) {
+        shrink(level);
+    }
+}
+
+void MemoryBudget::on_trim_memory(int android_level) {
+    on_pressure(level_from_trim(android_level));
+}
+
+PressureLevel MemoryBudget::level_from_trim(int android_level) noexcept {
+    switch (android_level) {
+        case TRIM_MEMORY_RUNNING_MODERATE:
+        case TRIM_MEMORY_UI_HIDDEN:
+        case TRIM_MEMORY_BACKGROUND:
+            return PressureLevel::Moderate;
+        case TRIM_MEMORY_RUNNING_LOW:
+        case TRIM_MEMORY_MODERATE:
+            return PressureLevel::Severe;
+        case TRIM_MEMORY_RUNNING_CRITICAL:
+        case TRIM_MEMORY_COMPLETE:
+            return PressureLevel::Critical;
+        default:
+            // Unknown future levels: treat anything above the range as the worst
+            if (android_level > TRIM_MEMORY_COMPLETE) return PressureLevel::Critical;
+            return android_level >= TRIM_MEMORY_RUNNING_MODERATE ? PressureLevel::Moderate
+                                                                 : PressureLevel::None;
+    }
+}
+
+MemoryBudget::BudgetStats MemoryBudget::get_stats() const noexcept {
+    BudgetStats stats;
+    stats.total_usage = total_usage();
+    stats.limit = limit();
+    for (size_t i = 0; i < stats.tag_usage.size(); ++i) {
+        stats.tag_usage[i] = usage_[i].load(std::memory_order_relaxed);
+    }
+    {
+        std::shared_lock lock(caches_mutex_);
+        stats.caches = caches_.size();
+    }
+    stats.shrink_passes = shrink_passes_.load(std::memory_order_relaxed);
+    stats.bytes_reclaimed = bytes_reclaimed_.load(std::memory_order_relaxed);
+    stats.last_level = static_cast<PressureLevel>(last_level_.load(std::memory_order_relaxed));
+    return stats;
+}
+
+bool MemoryBudget::dispatch(std::function<void()> task) {
+    Dispatcher dispatcher;
+    {
+        std::lock_guard lock(dispatcher_mutex_);
+        dispatcher = dispatcher_;
+    }
+    return dispatcher && dispatcher(std::move(task));
+}
+
+void MemoryBudget::enforce_limit() {
+    // Soft limit: never touches user-visible state
+    for (auto level : {PressureLevel::Moderate, PressureLevel::Severe}) {
+        shrink(level);
+        const size_t limit = limit_.load(std::memory_order_relaxed);
+        if (limit == 0 || total_usage() <= limit) {
+            break;
+        }
+    }
+}
+
+// PsiMonitor implementation
+PsiMonitor::~PsiMonitor() {
+    close();
+}
+
+bool PsiMonitor::open(uint32_t stall_us, uint32_t window_us, const char* path) noexcept {
+    close();
+
+    int fd = ::open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    char trigger[64];
+    int length = std::snprintf(trigger, sizeof(trigger), "some %u %u", stall_us, window_us);
+    // The kernel expects the terminating NUL as part of the write
+    if (length <= 0 || write(fd, trigger, static_cast<size_t>(length) + 1) < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    return true;
+}
+
+void PsiMonitor::close() noexcept {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+PressureLevel PsiMonitor::read_level() noexcept {
+    if (fd_ < 0) {
+        return PressureLevel::None;
+    }
+
+    char buffer[256];
+    ssize_t length;
+    do {
+        length = pread(fd_, buffer, sizeof(buffer) - 1, 0);
+    } while (length < 0 && errno == EINTR);
+
+    PsiStats stats;
+    if (length <= 0 || !parse(std::string(buffer, static_cast<size_t>(length)), stats)) {
+        return PressureLevel::Moderate; // The trigger fired, the details are unknown
+    }
+    return classify(stats);
+}
+
+bool PsiMonitor::parse(const std::string& text, PsiStats& stats) noexcept {
+    // some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+    // full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+    bool has_some = false;
+    size_t line_start = 0;
+    while (line_start < text.size()) {
+        size_t line_end = text.find('\n', line_start);
+        if (line_end == std::string::npos) {
+            line_end = text.size();
+        }
+        const std::string line = text.substr(line_start, line_end - line_start);
+        line_start = line_end + 1;
+
+        char kind[8];
+        double avg10, avg60, avg300;
+        unsigned long long total;
+        if (std::sscanf(line.c_str(), "%7s avg10=%lf avg60=%lf avg300=%lf total=%llu",
+                        kind, &avg10, &avg60, &avg300, &total) != 5) {
+            continue;
+        }
+        if (std::strcmp(kind, "some") == 0) {
+            stats.some_avg10 = avg10;
+            stats.some_total = total;
+            has_some = true;
+        } else if (std::strcmp(kind, "full") == 0) {
+            stats.full_avg10 = avg10;
+            stats.full_total = total;
+        }
+    }
+    return has_some;
+}
+
+PressureLevel PsiMonitor::classify(const PsiStats& stats) noexcept {
+    // A fired trigger is at least moderate; "full" stalls mean the whole
+    // system is thrashing and the low-memory killer is close
+    if (stats.full_avg10 >= 10.0) {
+        return PressureLevel::Critical;
+    }
+    if (stats.full_avg10 >= 2.0 || stats.some_avg10 >= 20.0) {
+        return PressureLevel::Severe;
+    }
+    return PressureLevel::Moderate;
+}
+
+} // namespace memory
+} // namespace cross_terminal
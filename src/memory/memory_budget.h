@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace cross_terminal {
+namespace memory {
+
+// Subsystems whose memory is accounted against the global budget
+enum class MemoryTag : uint8_t {
+    Scrollback = 0,     // Process capture buffers
+    History,            // Job history indexes and mappings
+    DirectoryCache,     // Cached directory handles and listings
+    ProcessPool,        // Parked ManagedProcess objects
+    Interner,           // Interned strings
+    Other,
+    Count
+};
+
+const char* tag_name(MemoryTag tag) noexcept;
+
+// How hard the system is asking us to give memory back
+enum class PressureLevel : uint8_t {
+    None = 0,
+    Moderate,   // Drop what is free to rebuild
+    Severe,     // Also drop what can be reloaded from disk or the kernel
+    Critical    // Also drop user-visible state (old scrollback)
+};
+
+// Order in which registered caches are asked to shrink
+enum class CachePriority : uint8_t {
+    Disposable = 0,     // Idle pools, rebuilt on demand
+    Recomputable = 1,   // Reloadable: mapped files, directory caches
+    UserVisible = 2     // Losing it costs the user data
+};
+
+// Global memory budget: per-tag usage accounting, an optional soft limit
+// and pressure-driven shrinking of registered caches in priority order.
+// Pressure arrives from Linux PSI (PsiMonitor), Android onTrimMemory or
+// from crossing the soft limit.
+class MemoryBudget {
+public:
+    using CacheId = uint32_t;
+
+    // Returns an estimate of the bytes released
+    using ShrinkCallback = std::function<size_t(PressureLevel level)>;
+
+    // Queues shrink work away from the thread that noticed the pressure.
+    // Must not run the task inline; returns false if it was not queued.
+    using Dispatcher = std::function<bool(std::function<void()> task)>;
+
+    struct BudgetStats {
+        size_t total_usage;
+        size_t limit;
+        std::array<size_t, static_cast<size_t>(MemoryTag::Count)> tag_usage;
+        size_t caches;
+        uint64_t shrink_passes;
+        uint64_t bytes_reclaimed;
+        PressureLevel last_level;
+    };
+
+    MemoryBudget() = default;
+    ~MemoryBudget() = default;
+
+    // Non-copyable, non-movable
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+    MemoryBudget(MemoryBudget&&) = delete;
+    MemoryBudget& operator=(MemoryBudget&&) = delete;
+
+    static MemoryBudget& instance();
+
+    // Accounting, safe from any thread including allocation hot paths
+    void charge(MemoryTag tag, size_t bytes) noexcept;
+    void release(MemoryTag tag, size_t bytes) noexcept;
+    size_t usage(MemoryTag tag) const noexcept;
+    size_t total_usage() const noexcept;
+
+    // Soft limit on the accounted total, 0 for none. Crossing it schedules
+    // a shrink through the dispatcher, escalating up to Severe.
+    void set_limit(size_t bytes) noexcept;
+    size_t limit() const noexcept;
+
+    void set_dispatcher(Dispatcher dispatcher);
+
+    // Shrink callbacks run with the cache list locked: they must not
+    // register or unregister caches. unregister_cache() waits for a
+    // running shrink pass to finish.
+    CacheId register_cache(std::string name, MemoryTag tag, CachePriority priority,
+                           ShrinkCallback shrink);
+    void unregister_cache(CacheId id);
+
+    // Synchronously shrink every cache the level allows, lowest priority
+    // first, then return freed heap pages to the kernel
+    size_t shrink(PressureLevel level);
+
+    // Entry points for pressure signals; shrink via the dispatcher if set
+    void on_pressure(PressureLevel level);
+    void on_trim_memory(int android_level);
+
+    // ComponentCallbacks2.onTrimMemory level to pressure level
+    static PressureLevel level_from_trim(int android_level) noexcept;
+
+    BudgetStats get_stats() const noexcept;
+
+private:
+    struct Cache {
+        CacheId id;
+        std::string name;
+        MemoryTag tag;
+        CachePriority priority;
+        ShrinkCallback shrink;
+    };
+
+    std::array<std::atomic<size_t>, static_cast<size_t>(MemoryTag::Count)> usage_{};
+    std::atomic<size_t> total_{0};
+    std::atomic<size_t> limit_{0};
+    std::atomic<bool> enforce_pending_{false};
+
+    std::vector<Cache> caches_;   // Sorted by priority, then registration order
+    CacheId next_cache_id_ = 1;
+    mutable std::shared_mutex caches_mutex_;
+    std::mutex shrink_mutex_;     // One shrink pass at a time
+
+    Dispatcher dispatcher_;
+    mutable std::mutex dispatcher_mutex_;
+
+    std::atomic<uint64_t> shrink_passes_{0};
+    std::atomic<uint64_t> bytes_reclaimed_{0};
+    std::atomic<uint8_t> last_level_{0};
+
+    static MemoryBudget* instance_;
+    static std::once_flag init_flag_;
+
+    bool dispatch(std::function<void()> task);
+    void enforce_limit();
+};
+
+// Linux pressure stall information trigger on /proc/pressure/memory.
+// The descriptor reports POLLPRI (EPOLLPRI) whenever tasks stalled on
+// memory for more than the threshold within the window.
+class PsiMonitor {
+public:
+    static constexpr const char* DEFAULT_PATH = "/proc/pressure/memory";
+    // Unprivileged triggers need a window that is a multiple of 2s
+    static constexpr uint32_t DEFAULT_STALL_US = 200000;
+    static constexpr uint32_t DEFAULT_WINDOW_US = 2000000;
+
+    struct PsiStats {
+        double some_avg10 = 0.0;   // % of time at least one task stalled
+        double full_avg10 = 0.0;   // % of time all non-idle tasks stalled
+        uint64_t some_total = 0;   // Microseconds
+        uint64_t full_total = 0;
+    };
+
+    PsiMonitor() noexcept = default;
+    ~PsiMonitor();
+
+    // Non-copyable, non-movable
+    PsiMonitor(const PsiMonitor&) = delete;
+    PsiMonitor& operator=(const PsiMonitor&) = delete;
+    PsiMonitor(PsiMonitor&&) = delete;
+    PsiMonitor& operator=(PsiMonitor&&) = delete;
+
+    // False when PSI is unavailable (old kernel, SELinux, CONFIG_PSI=n)
+    bool open(uint32_t stall_us = DEFAULT_STALL_US,
+              uint32_t window_us = DEFAULT_WINDOW_US,
+              const char* path = DEFAULT_PATH) noexcept;
+    void close() noexcept;
+    bool is_open() const noexcept { return fd_ >= 0; }
+    int fd() const noexcept { return fd_; }
+
+    // Read the current averages after the descriptor fired
+    PressureLevel read_level() noexcept;
+
+    static bool parse(const std::string& text, PsiStats& stats) noexcept;
+    static PressureLevel classify(const PsiStats& stats) noexcept;
+
+private:
+    int fd_ = -1;
+};
+
+} // namespace memory
+} // namespace cross_terminal
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <bitset>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
+#include <new>
+#include <shared_mutex>
+#include <string>
 #include <type_traits>
 #include <vector>
 #include <unordered_map>
@@ -111,6 +117,13 @@ public:
         }
     }
     
+    bool owns(const void* ptr) const noexcept {
+        const auto storage_begin = reinterpret_cast<uintptr_t>(&storage_[0]);
+        const auto storage_end = reinterpret_cast<uintptr_t>(&storage_[PoolSize]);
+        const auto ptr_addr = reinterpret_cast<uintptr_t>(ptr);
+        return ptr_addr >= storage_begin && ptr_addr < storage_end;
+    }
+    
     // Pool statistics
     size_t allocated() const noexcept {
         return allocated_count_.load(std::memory_order_relaxed);
@@ -194,13 +207,23 @@ public:
     }
 };
 
+// Fixed-size block handed out by the MemoryManager size-class pools
+template<size_t Size>
+struct alignas(std::max_align_t) PoolBlock {
+    char data[Size];
+};
+
 // Memory manager with multiple allocation strategies
 class MemoryManager {
 private:
+    using SmallBlock = PoolBlock<64>;
+    using MediumBlock = PoolBlock<512>;
+    using LargeBlock = PoolBlock<4096>;
+    
     // Pool for different object types
-    MemoryPool<char, 4096> small_object_pool_;     // < 64 bytes
-    MemoryPool<char, 2048> medium_object_pool_;    // 64-512 bytes
-    MemoryPool<char, 1024> large_object_pool_;     // 512-4096 bytes
+    MemoryPool<SmallBlock, 4096> small_object_pool_;     // < 64 bytes
+    MemoryPool<MediumBlock, 2048> medium_object_pool_;   // 64-512 bytes
+    MemoryPool<LargeBlock, 1024> large_object_pool_;     // 512-4096 bytes
     
     // Stack allocator for temporary objects
     StackAllocator<16384> stack_allocator_;
@@ -243,7 +266,8 @@ private:
 public:
     static MemoryManager& instance() {
         std::call_once(init_flag_, []() {
-            instance_ = new MemoryManager();
+            // Default-initialized: pool storage stays untouched until used
+            instance_ = new MemoryManager;
         });
         return *instance_;
     }
@@ -252,15 +276,21 @@ public:
         void* ptr = nullptr;
         
         // Choose allocation strategy based on size
-        if (size <= 64) {
+        if (alignment > alignof(std::max_align_t)) {
+            // Pool blocks cannot honour over-aligned requests
+        } else if (size <= 64) {
             ptr = small_object_pool_.allocate();
         } else if (size <= 512) {
             ptr = medium_object_pool_.allocate();
         } else if (size <= 4096) {
             ptr = large_object_pool_.allocate();
-        } else {
+        }
+        
+        if (!ptr) {
             // Fall back to system allocator for very large allocations
-            ptr = std::aligned_alloc(alignment, size);
+            // and exhausted pools; aligned_alloc wants a size multiple
+            alignment = std::max(alignment, alignof(std::max_align_t));
+            ptr = std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
         }
         
         if (ptr) {
@@ -273,26 +303,19 @@ public:
     void deallocate(void* ptr, size_t size) noexcept {
         if (!ptr) return;
         
-        // Try pool deallocation first
-        bool deallocated = false;
-        
-        if (size <= 64) {
-            small_object_pool_.deallocate(static_cast<char*>(ptr));
-            deallocated = true;
-        } else if (size <= 512) {
-            medium_object_pool_.deallocate(static_cast<char*>(ptr));
-            deallocated = true;
-        } else if (size <= 4096) {
-            large_object_pool_.deallocate(static_cast<char*>(ptr));
-            deallocated = true;
+        // Try pool deallocation first; blocks served by the system
+        // allocator when a pool was exhausted are not inside any pool
+        if (small_object_pool_.owns(ptr)) {
+            small_object_pool_.deallocate(static_cast<SmallBlock*>(ptr));
+        } else if (medium_object_pool_.owns(ptr)) {
+            medium_object_pool_.deallocate(static_cast<MediumBlock*>(ptr));
+        } else if (large_object_pool_.owns(ptr)) {
+            large_object_pool_.deallocate(static_cast<LargeBlock*>(ptr));
         } else {
             std::free(ptr);
-            deallocated = true;
         }
         
-        if (deallocated) {
-            update_statistics(size, false);
-        }
+        update_statistics(size, false);
     }
     
     void* allocate_temp(size_t size, size_t alignment = alignof(std::max_align_t)) noexcept {
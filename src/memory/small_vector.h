@@ -0,0 +1,342 @@
+#pragma once
+
+#include "memory_manager.h"
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace cross_terminal {
+namespace memory {
+
+// Vector with inline storage for the first N elements. Growing past N
+// moves the elements to a block from MemoryManager; until then the
+// container never touches the heap. Iterators are plain pointers and are
+// invalidated by any growth, like std::vector.
+template<typename T, size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs at least one inline element");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t inline_capacity = N;
+
+    SmallVector() noexcept : data_(inline_data()) {}
+
+    SmallVector(size_t count, const T& value) : SmallVector() {
+        assign(count, value);
+    }
+
+    SmallVector(std::initializer_list<T> init) : SmallVector() {
+        assign(init.begin(), init.end());
+    }
+
+    template<typename InputIt,
+             typename = std::enable_if_t<!std::is_integral<InputIt>::value>>
+    SmallVector(InputIt first, InputIt last) : SmallVector() {
+        assign(first, last);
+    }
+
+    SmallVector(const SmallVector& other) : SmallVector() {
+        assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : SmallVector() {
+        take(std::move(other));
+    }
+
+    ~SmallVector() {
+        destroy_range(begin(), end());
+        release_heap();
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        if (this != &other) {
+            clear();
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(std::initializer_list<T> init) {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    void assign(size_t count, const T& value) {
+        clear();
+        reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            new (data_ + i) T(value);
+            ++size_;
+        }
+    }
+
+    template<typename InputIt,
+             typename = std::enable_if_t<!std::is_integral<InputIt>::value>>
+    void assign(InputIt first, InputIt last) {
+        // Assign over live elements first, like std::vector: they keep
+        // their own storage (string buffers, interned entries)
+        T* cursor = begin();
+        for (; first != last && cursor != end(); ++first, ++cursor) {
+            *cursor = *first;
+        }
+        if (cursor != end()) {
+            destroy_range(cursor, end());
+            size_ = static_cast<size_t>(cursor - data_);
+            return;
+        }
+
+        using category = typename std::iterator_traits<InputIt>::iterator_category;
+        if (std::is_base_of<std::forward_iterator_tag, category>::value) {
+            reserve(size_ + static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    void assign(std::initializer_list<T> init) {
+        assign(init.begin(), init.end());
+    }
+
+    // Element access
+    T& operator[](size_t index) noexcept { return data_[index]; }
+    const T& operator[](size_t index) const noexcept { return data_[index]; }
+
+    T& at(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return data_[index];
+    }
+
+    const T& at(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return data_[index];
+    }
+
+    T& front() noexcept { return data_[0]; }
+    const T& front() const noexcept { return data_[0]; }
+    T& back() noexcept { return data_[size_ - 1]; }
+    const T& back() const noexcept { return data_[size_ - 1]; }
+    T* data() noexcept { return data_; }
+    const T* data() const noexcept { return data_; }
+
+    // Iterators
+    iterator begin() noexcept { return data_; }
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator cbegin() const noexcept { return data_; }
+    iterator end() noexcept { return data_ + size_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+    const_iterator cend() const noexcept { return data_ + size_; }
+
+    // Capacity
+    bool empty() const noexcept { return size_ == 0; }
+    size_t size() const noexcept { return size_; }
+    size_t capacity() const noexcept { return capacity_; }
+    bool is_inline() const noexcept { return data_ == inline_data(); }
+
+    void reserve(size_t capacity) {
+        if (capacity > capacity_) {
+            reallocate(capacity);
+        }
+    }
+
+    // Modifiers
+    void clear() noexcept {
+        destroy_range(begin(), end());
+        size_ = 0;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ < capacity_) {
+            T* slot = new (data_ + size_) T(std::forward<Args>(args)...);
+            ++size_;
+            return *slot;
+        }
+        return grow_and_emplace(std::forward<Args>(args)...);
+    }
+
+    void pop_back() noexcept {
+        --size_;
+        data_[size_].~T();
+    }
+
+    iterator erase(const_iterator position) {
+        return erase(position, position + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        T* target = data_ + (first - data_);
+        const size_t count = static_cast<size_t>(last - first);
+        if (count > 0) {
+            T* new_end = std::move(target + count, end(), target);
+            destroy_range(new_end, end());
+            size_ -= count;
+        }
+        return target;
+    }
+
+    void resize(size_t count) {
+        resize_with(count, [](T* slot) { new (slot) T(); });
+    }
+
+    void resize(size_t count, const T& value) {
+        if (count > capacity_) {
+            // The value may live in the buffer that is about to move
+            const T copy(value);
+            resize_with(count, [&copy](T* slot) { new (slot) T(copy); });
+            return;
+        }
+        resize_with(count, [&value](T* slot) { new (slot) T(value); });
+    }
+
+    friend bool operator==(const SmallVector& lhs, const SmallVector& rhs) {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator!=(const SmallVector& lhs, const SmallVector& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    T* data_;
+    size_t size_ = 0;
+    size_t capacity_ = N;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+
+    T* inline_data() noexcept { return reinterpret_cast<T*>(inline_); }
+    const T* inline_data() const noexcept { return reinterpret_cast<const T*>(inline_); }
+
+    static void destroy_range(T* first, T* last) noexcept {
+        if (!std::is_trivially_destructible<T>::value) {
+            for (; first != last; ++first) {
+                first->~T();
+            }
+        }
+    }
+
+    static T* allocate(size_t capacity) {
+        void* block = MemoryManager::instance().allocate(capacity * sizeof(T), alignof(T));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(block);
+    }
+
+    void release_heap() noexcept {
+        if (!is_inline()) {
+            MemoryManager::instance().deallocate(data_, capacity_ * sizeof(T));
+        }
+    }
+
+    // Moves the elements of a buffer into fresh storage
+    static void relocate(T* from, size_t count, T* to) {
+        for (size_t i = 0; i < count; ++i) {
+            new (to + i) T(std::move_if_noexcept(from[i]));
+        }
+        destroy_range(from, from + count);
+    }
+
+    void adopt(T* storage, size_t capacity) noexcept {
+        release_heap();
+        data_ = storage;
+        capacity_ = capacity;
+    }
+
+    void reallocate(size_t capacity) {
+        T* storage = allocate(capacity);
+        try {
+            relocate(data_, size_, storage);
+        } catch (...) {
+            MemoryManager::instance().deallocate(storage, capacity * sizeof(T));
+            throw;
+        }
+        adopt(storage, capacity);
+    }
+
+    template<typename... Args>
+    T& grow_and_emplace(Args&&... args) {
+        const size_t capacity = capacity_ * 2;
+        T* storage = allocate(capacity);
+        // Construct first: the arguments may refer to elements being moved
+        try {
+            new (storage + size_) T(std::forward<Args>(args)...);
+        } catch (...) {
+            MemoryManager::instance().deallocate(storage, capacity * sizeof(T));
+            throw;
+        }
+        try {
+            relocate(data_, size_, storage);
+        } catch (...) {
+            storage[size_].~T();
+            MemoryManager::instance().deallocate(storage, capacity * sizeof(T));
+            throw;
+        }
+        adopt(storage, capacity);
+        return data_[size_++];
+    }
+
+    template<typename Construct>
+    void resize_with(size_t count, Construct construct) {
+        if (count < size_) {
+            destroy_range(data_ + count, end());
+            size_ = count;
+            return;
+        }
+        reserve(count);
+        while (size_ < count) {
+            construct(data_ + size_);
+            ++size_;
+        }
+    }
+
+    // Steals a heap buffer, or moves elements out of the inline one
+    void take(SmallVector&& other) {
+        if (!other.is_inline()) {
+            adopt(other.data_, other.capacity_);
+            size_ = other.size_;
+            other.data_ = other.inline_data();
+            other.capacity_ = N;
+            other.size_ = 0;
+            return;
+        }
+        reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i) {
+            new (data_ + i) T(std::move(other.data_[i]));
+            ++size_;
+        }
+        other.clear();
+    }
+};
+
+} // namespace memory
+} // namespace cross_terminal
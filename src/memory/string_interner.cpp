@@ -0,0 +1,148 @@
+#include "string_interner.h"
+#include "memory_budget.h"
+
+namespace cross_terminal {
+namespace memory {
+
+// Static member definitions
+StringInterner* StringInterner::instance_ = nullptr;
+std::once_flag StringInterner::init_flag_;
+
+namespace {
+
+const std::string& empty_string() noexcept {
+    static const std::string empty;
+    return empty;
+}
+
+} // namespace
+
+// InternedString implementation
+InternedString::InternedString(std::string_view text)
+    : InternedString(StringInterner::instance().intern(text)) {
+}
+
+InternedString::InternedString(const InternedString& other) noexcept
+    : entry_(other.entry_) {
+    if (entry_) {
+        // The source handle keeps the entry alive, no lock needed
+        entry_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+InternedString& InternedString::operator=(const InternedString& other) noexcept {
+    if (entry_ != other.entry_) {
+        InternedString copy(other);
+        std::swap(entry_, copy.entry_);
+    }
+    return *this;
+}
+
+InternedString& InternedString::operator=(InternedString&& other) noexcept {
+    if (this != &other) {
+        std::swap(entry_, other.entry_);
+    }
+    return *this;
+}
+
+InternedString::~InternedString() {
+    if (entry_) {
+        StringInterner::instance().release(entry_);
+    }
+}
+
+const std::string& InternedString::str() const noexcept {
+    return entry_ ? entry_->value : empty_string();
+}
+
+// StringInterner implementation
+StringInterner& StringInterner::instance() {
+    std::call_once(init_flag_, []() {
+        // Never destroyed: handles in static objects may outlive main()
+        instance_ = new StringInterner();
+    });
+    return *instance_;
+}
+
+InternedString StringInterner::intern(std::string_view text) {
+    if (text.empty()) {
+        return InternedString();
+    }
+
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    const size_t hash = std::hash<std::string_view>()(text);
+    const uint32_t shard_index = static_cast<uint32_t>((hash >> 7) % SHARD_COUNT);
+    Shard& shard = shards_[shard_index];
+
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.entries.find(text);
+    if (it != shard.entries.end()) {
+        // Entries in the table always hold at least one reference
+        it->second->refs.fetch_add(1, std::memory_order_relaxed);
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return InternedString(it->second);
+    }
+
+    auto* entry = new Entry{{1}, shard_index, std::string(text)};
+    shard.entries.emplace(std::string_view(entry->value), entry);
+    unique_strings_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(text.size(), std::memory_order_relaxed);
+    MemoryBudget::instance().charge(MemoryTag::Interner, sizeof(Entry) + entry->value.capacity());
+    return InternedString(entry);
+}
+
+InternedString StringInterner::find(std::string_view text) {
+    if (text.empty()) {
+        return InternedString();
+    }
+
+    const size_t hash = std::hash<std::string_view>()(text);
+    Shard& shard = shards_[(hash >> 7) % SHARD_COUNT];
+
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.entries.find(text);
+    if (it == shard.entries.end()) {
+        return InternedString();
+    }
+    it->second->refs.fetch_add(1, std::memory_order_relaxed);
+    return InternedString(it->second);
+}
+
+void StringInterner::release(Entry* entry) noexcept {
+    // Fast path: not the last reference
+    uint32_t refs = entry->refs.load(std::memory_order_relaxed);
+    while (refs > 1) {
+        if (entry->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    // Possibly the last reference: the 1 -> 0 transition only happens under
+    // the shard lock, where intern() cannot resurrect the entry
+    Shard& shard = shards_[entry->shard];
+    {
+        std::lock_guard lock(shard.mutex);
+        if (entry->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        shard.entries.erase(std::string_view(entry->value));
+    }
+
+    unique_strings_.fetch_sub(1, std::memory_order_relaxed);
+    bytes_.fetch_sub(entry->value.size(), std::memory_order_relaxed);
+    MemoryBudget::instance().release(MemoryTag::Interner, sizeof(Entry) + entry->value.capacity());
+    delete entry;
+}
+
+StringInterner::InternStats StringInterner::get_stats() const noexcept {
+    InternStats stats;
+    stats.unique_strings = unique_strings_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.lookups = lookups_.load(std::memory_order_relaxed);
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace memory
+} // namespace cross_terminal
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace cross_terminal {
+namespace memory {
+
+// Handle to a hash-consed, reference-counted immutable string.
+// Equal contents always share one entry, so equality and hashing are
+// pointer operations and copies are a single atomic increment.
+class InternedString {
+public:
+    InternedString() noexcept = default;
+    InternedString(std::string_view text);
+    InternedString(const std::string& text) : InternedString(std::string_view(text)) {}
+    InternedString(const char* text) : InternedString(std::string_view(text ? text : "")) {}
+
+    InternedString(const InternedString& other) noexcept;
+    InternedString(InternedString&& other) noexcept : entry_(other.entry_) {
+        other.entry_ = nullptr;
+    }
+    InternedString& operator=(const InternedString& other) noexcept;
+    InternedString& operator=(InternedString&& other) noexcept;
+    ~InternedString();
+
+    const std::string& str() const noexcept;
+    operator const std::string&() const noexcept { return str(); }
+    std::string_view view() const noexcept { return str(); }
+    const char* c_str() const noexcept { return str().c_str(); }
+    size_t size() const noexcept { return str().size(); }
+    bool empty() const noexcept { return entry_ == nullptr; }
+
+    // Identity hash: stable for the lifetime of the entry
+    size_t hash() const noexcept {
+        return std::hash<const void*>()(entry_);
+    }
+
+    friend bool operator==(const InternedString& a, const InternedString& b) noexcept {
+        return a.entry_ == b.entry_;
+    }
+    friend bool operator!=(const InternedString& a, const InternedString& b) noexcept {
+        return a.entry_ != b.entry_;
+    }
+    friend bool operator==(const InternedString& a, std::string_view b) noexcept {
+        return a.view() == b;
+    }
+    friend bool operator==(const InternedString& a, const std::string& b) noexcept {
+        return a.view() == b;
+    }
+    friend bool operator==(const InternedString& a, const char* b) noexcept {
+        return a.view() == std::string_view(b ? b : "");
+    }
+    template<typename T>
+    friend bool operator!=(const InternedString& a, const T& b) noexcept {
+        return !(a == b);
+    }
+    template<typename T>
+    friend bool operator==(const T& a, const InternedString& b) noexcept {
+        return b == a;
+    }
+    template<typename T>
+    friend bool operator!=(const T& a, const InternedString& b) noexcept {
+        return !(b == a);
+    }
+    friend bool operator<(const InternedString& a, const InternedString& b) noexcept {
+        return a.view() < b.view();
+    }
+    friend std::ostream& operator<<(std::ostream& out, const InternedString& text) {
+        return out << text.str();
+    }
+
+private:
+    friend class StringInterner;
+
+    struct Entry {
+        std::atomic<uint32_t> refs;
+        uint32_t shard;
+        std::string value;
+    };
+
+    explicit InternedString(Entry* entry) noexcept : entry_(entry) {}
+
+    Entry* entry_ = nullptr;
+};
+
+// Process-wide concurrent interner backing InternedString.
+// The table is split into independently locked shards; entries are
+// released when the last handle goes away.
+class StringInterner {
+public:
+    static constexpr size_t SHARD_COUNT = 32;
+
+    static StringInterner& instance();
+
+    InternedString intern(std::string_view text);
+
+    // Handle to text if it is already interned, else an empty handle;
+    // unlike intern() it never creates an entry
+    InternedString find(std::string_view text);
+
+    struct InternStats {
+        size_t unique_strings;
+        size_t bytes;
+        uint64_t lookups;
+        uint64_t hits;
+    };
+
+    InternStats get_stats() const noexcept;
+
+private:
+    using Entry = InternedString::Entry;
+    friend class InternedString;
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, Entry*> entries;
+    };
+
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<size_t> unique_strings_{0};
+    std::atomic<size_t> bytes_{0};
+    std::atomic<uint64_t> lookups_{0};
+    std::atomic<uint64_t> hits_{0};
+
+    static StringInterner* instance_;
+    static std::once_flag init_flag_;
+
+    StringInterner() = default;
+
+    void release(Entry* entry) noexcept;
+};
+
+} // namespace memory
+} // namespace cross_terminal
+
+namespace std {
+template<>
+struct hash<cross_terminal::memory::InternedString> {
+    size_t operator()(const cross_terminal::memory::InternedString& text) const noexcept {
+        return text.hash();
+    }
+};
+} // namespace std
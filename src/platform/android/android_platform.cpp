@@ -15,6 +15,10 @@
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
 AndroidPlatform::AndroidPlatform() {
+    std::string error;
+    if (!m_network.start(NetworkMonitor::DEFAULT_STATS_INTERVAL, &error)) {
+        LOGD("Network monitor unavailable (%s), using getifaddrs", error.c_str());
+    }
     LOGD("AndroidPlatform initialized");
 }
 
@@ -66,32 +70,25 @@ std::string AndroidPlatform::getDeviceModel() {
 }
 
 bool AndroidPlatform::fileExists(const std::string& path) {
-    struct stat buffer;
-    return (stat(path.c_str(), &buffer) == 0);
+    return m_files.exists(path);
 }
 
 bool AndroidPlatform::createDirectory(const std::string& path) {
-    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+    int error = m_files.createDirectory(path);
+    return error == 0 || error == EEXIST;
 }
 
 std::vector<std::string> AndroidPlatform::listDirectory(const std::string& path) {
     std::vector<std::string> files;
-    
-    DIR* dir = opendir(path.c_str());
-    if (dir == nullptr) {
+    std::vector<cross_terminal::core::FsEntry> entries;
+    if (m_files.listDirectory(path, entries) != 0) {
         LOGE("Failed to open directory: %s", path.c_str());
         return files;
     }
-    
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        std::string name(entry->d_name);
-        if (name != "." && name != "..") {
-            files.push_back(name);
-        }
+    files.reserve(entries.size());
+    for (auto& entry : entries) {
+        files.push_back(std::move(entry.name));
     }
-    
-    closedir(dir);
     return files;
 }
 
@@ -164,6 +161,10 @@ bool AndroidPlatform::requestHardwarePermissions() {
 }
 
 bool AndroidPlatform::hasNetworkAccess() {
+    if (m_network.isRunning()) {
+        return !m_network.getPrimaryIPv4().empty();
+    }
+
     struct ifaddrs* ifaddrs_ptr = nullptr;
     if (getifaddrs(&ifaddrs_ptr) == -1) {
         return false;
@@ -185,6 +186,10 @@ bool AndroidPlatform::hasNetworkAccess() {
 }
 
 std::string AndroidPlatform::getIPAddress() {
+    if (m_network.isRunning()) {
+        return m_network.getPrimaryIPv4();
+    }
+
     struct ifaddrs* ifaddrs_ptr = nullptr;
     if (getifaddrs(&ifaddrs_ptr) == -1) {
         return "";
@@ -206,6 +211,10 @@ std::string AndroidPlatform::getIPAddress() {
 }
 
 std::vector<std::string> AndroidPlatform::getNetworkInterfaces() {
+    if (m_network.isRunning()) {
+        return m_network.getInterfaceNames();
+    }
+
     std::vector<std::string> interfaces;
     
     struct ifaddrs* ifaddrs_ptr = nullptr;
@@ -224,4 +233,11 @@ std::vector<std::string> AndroidPlatform::getNetworkInterfaces() {
     
     freeifaddrs(ifaddrs_ptr);
     return interfaces;
-}
\ No newline at end of file
+}
+
+std::vector<NetworkInterfaceInfo> AndroidPlatform::getNetworkStatistics() {
+    if (m_network.isRunning()) {
+        return m_network.snapshot()->interfaces;
+    }
+    return Platform::getNetworkStatistics();
+}
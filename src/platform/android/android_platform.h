@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../platform.h"
+#include "../network_monitor.h"
+#include "core/implementations/fs_context.h"
 
 class AndroidPlatform : public Platform {
 public:
@@ -31,7 +33,12 @@ public:
     bool hasNetworkAccess() override;
     std::string getIPAddress() override;
     std::vector<std::string> getNetworkInterfaces() override;
+    std::vector<NetworkInterfaceInfo> getNetworkStatistics() override;
     
 private:
     void initializeAndroidSpecific();
+
+    // rtnetlink cache; the getifaddrs() paths are used when it is not running
+    NetworkMonitor m_network;
+    cross_terminal::core::FsContext m_files{"/"};   // Keeps fds for hot directories
 };
\ No newline at end of file
@@ -0,0 +1,505 @@
+#include "network_monitor.h"
+#include "core/implementations/thread_registry.h"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <linux/if_link.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#endif
+
+namespace {
+
+constexpr size_t RECEIVE_CHUNK = 32 * 1024;
+constexpr int DUMP_TIMEOUT_MS = 2000;
+
+// Counter updates closer together than this (a link event right after a
+// dump) keep the previous rate instead of dividing by a tiny interval
+constexpr auto MIN_RATE_INTERVAL = std::chrono::milliseconds(100);
+
+} // namespace
+
+NetworkMonitor::NetworkMonitor()
+    : m_snapshot(std::make_shared<NetworkSnapshot>()) {
+}
+
+NetworkMonitor::~NetworkMonitor() {
+    stop();
+}
+
+bool NetworkMonitor::isRunning() const {
+    return m_running;
+}
+
+std::shared_ptr<const NetworkSnapshot> NetworkMonitor::snapshot() const {
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    return m_snapshot;
+}
+
+std::vector<std::string> NetworkMonitor::getInterfaceNames() const {
+    return snapshot()->names;
+}
+
+std::string NetworkMonitor::getPrimaryIPv4() const {
+    return snapshot()->primaryIPv4;
+}
+
+bool NetworkMonitor::getInterface(const std::string& name, NetworkInterfaceInfo& out) const {
+    auto current = snapshot();
+    for (const auto& info : current->interfaces) {
+        if (info.name == name) {
+            out = info;
+            return true;
+        }
+    }
+    return false;
+}
+
+void NetworkMonitor::setChangeCallback(std::function<void(const NetworkSnapshot&)> callback) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_changeCallback = std::move(callback);
+}
+
+uint64_t NetworkMonitor::getStatsDumps() const {
+    return m_statsDumps;
+}
+
+void NetworkMonitor::publishLocked() {
+    auto next = std::make_shared<NetworkSnapshot>();
+    next->interfaces.reserve(m_interfaces.size());
+    next->names.reserve(m_interfaces.size());
+    for (const auto& entry : m_interfaces) {
+        const NetworkInterfaceInfo& info = entry.second;
+        if (info.name.empty()) {
+            continue;   // Address seen before its link; wait for the link
+        }
+        next->interfaces.push_back(info);
+        next->names.push_back(info.name);
+        if (next->primaryIPv4.empty() && !info.loopback) {
+            for (const auto& address : info.addresses) {
+                if (address.family == AF_INET && address.address != "127.0.0.1") {
+                    next->primaryIPv4 = address.address;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+    next->generation = m_snapshot->generation + 1;
+    m_snapshot = std::move(next);
+}
+
+#ifdef __linux__
+
+bool NetworkMonitor::start(std::chrono::milliseconds statsInterval, std::string* error) {
+    if (m_running) {
+        return true;
+    }
+    auto fail = [this, error](const char* what, int code) {
+        if (error) {
+            *error = std::string(what) + ": " + strerror(code);
+        }
+        if (m_socket >= 0) {
+            ::close(m_socket);
+            m_socket = -1;
+        }
+        m_dumpSequence = 0;
+        return false;
+    };
+
+    m_statsInterval = statsInterval;
+    m_socket = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    if (m_socket < 0) {
+        return fail("rtnetlink socket", errno);
+    }
+    int size = RECEIVE_BUFFER_SIZE;
+    setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+    sockaddr_nl address = {};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+    if (bind(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        return fail("rtnetlink bind", errno);
+    }
+
+    // Initial state: links first, so addresses find their interface.
+    // Only one dump may run on a socket at a time.
+    for (int type : {RTM_GETLINK, RTM_GETADDR}) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_dumpError = 0;
+            if (!requestDumpLocked(type)) {
+                return fail("rtnetlink dump request", errno);
+            }
+        }
+        if (!receiveDump()) {
+            return fail("rtnetlink dump", m_dumpError ? m_dumpError : ETIMEDOUT);
+        }
+    }
+
+    m_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakeFd < 0) {
+        return fail("eventfd", errno);
+    }
+    m_running = true;
+    m_thread = std::thread(&NetworkMonitor::run, this);
+    return true;
+}
+
+void NetworkMonitor::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    uint64_t one = 1;
+    ssize_t ignored = ::write(m_wakeFd, &one, sizeof(one));
+    (void)ignored;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    ::close(m_socket);
+    ::close(m_wakeFd);
+    m_socket = -1;
+    m_wakeFd = -1;
+}
+
+bool NetworkMonitor::requestDumpLocked(int type) {
+    if (m_socket < 0) {
+        return false;
+    }
+    struct {
+        nlmsghdr header;
+        rtgenmsg message;
+    } request = {};
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(rtgenmsg));
+    request.header.nlmsg_type = static_cast<uint16_t>(type);
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = ++m_sequence;
+    request.message.rtgen_family = AF_UNSPEC;
+
+    sockaddr_nl kernel = {};
+    kernel.nl_family = AF_NETLINK;
+    if (sendto(m_socket, &request, request.header.nlmsg_len, 0,
+               reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) < 0) {
+        return false;
+    }
+    m_dumpSequence = request.header.nlmsg_seq;
+    m_dumpStarted = std::chrono::steady_clock::now();
+    return true;
+}
+
+void NetworkMonitor::resyncLocked() {
+    if (m_dumpSequence != 0) {
+        return;
+    }
+    if (m_resyncLinks) {
+        m_resyncLinks = !requestDumpLocked(RTM_GETLINK);
+    } else if (m_resyncAddresses) {
+        m_resyncAddresses = !requestDumpLocked(RTM_GETADDR);
+    }
+}
+
+bool NetworkMonitor::receiveDump() {
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_dumpError != 0) {
+                return false;
+            }
+            if (m_dumpSequence == 0) {
+                return true;
+            }
+        }
+        if (!receiveOnce(DUMP_TIMEOUT_MS)) {
+            return false;
+        }
+    }
+}
+
+bool NetworkMonitor::receiveOnce(int timeoutMs) {
+    pollfd fd = {m_socket, POLLIN, 0};
+    int ready = poll(&fd, 1, timeoutMs);
+    if (ready <= 0) {
+        return ready == 0 ? false : errno == EINTR;
+    }
+
+    std::unique_ptr<char[]> buffer(new char[RECEIVE_CHUNK]);
+    for (;;) {
+        sockaddr_nl sender = {};
+        socklen_t length = sizeof(sender);
+        ssize_t n = recvfrom(m_socket, buffer.get(), RECEIVE_CHUNK, 0,
+                             reinterpret_cast<sockaddr*>(&sender), &length);
+        if (n < 0) {
+            if (errno == ENOBUFS) {
+                // Messages were dropped: reload links, then addresses, once
+                // the dump in flight (possibly missing its end) is over
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_resyncLinks = true;
+                m_resyncAddresses = true;
+                resyncLocked();
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        if (sender.nl_pid != 0) {
+            continue;   // Only the kernel speaks for rtnetlink
+        }
+        handleMessages(buffer.get(), static_cast<size_t>(n), std::chrono::steady_clock::now());
+    }
+}
+
+void NetworkMonitor::run() {
+    auto registration = cross_terminal::core::ThreadRegistry::instance().enter(
+        cross_terminal::core::ThreadRole::Hardware, "ct-netlink");
+
+    auto nextDump = std::chrono::steady_clock::now() + m_statsInterval;
+    while (m_running) {
+        auto now = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_dumpSequence != 0 && now - m_dumpStarted > std::chrono::milliseconds(DUMP_TIMEOUT_MS)) {
+                m_dumpSequence = 0;   // Its end was lost in an overflow
+            }
+            resyncLocked();
+            if (now >= nextDump) {
+                if (m_dumpSequence == 0 && requestDumpLocked(RTM_GETLINK)) {
+                    ++m_statsDumps;
+                }
+                nextDump = now + m_statsInterval;
+            }
+        }
+
+        const int timeout = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(nextDump - now).count()) + 1;
+        pollfd fds[2] = {{m_socket, POLLIN, 0}, {m_wakeFd, POLLIN, 0}};
+        if (poll(fds, 2, timeout) < 0 && errno != EINTR) {
+            break;
+        }
+        if (fds[1].revents) {
+            break;
+        }
+        if (fds[0].revents && !receiveOnce(0)) {
+            break;
+        }
+    }
+}
+
+void NetworkMonitor::handleMessages(const void* data, size_t size, std::chrono::steady_clock::time_point now) {
+    std::function<void(const NetworkSnapshot&)> callback;
+    std::shared_ptr<const NetworkSnapshot> published;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        int length = static_cast<int>(size);
+        for (auto* header = static_cast<const nlmsghdr*>(data); NLMSG_OK(header, length);
+             header = NLMSG_NEXT(header, length)) {
+            switch (header->nlmsg_type) {
+                case NLMSG_DONE:
+                    if (header->nlmsg_seq == m_dumpSequence) {
+                        m_dumpSequence = 0;
+                    }
+                    break;
+                case NLMSG_ERROR: {
+                    auto* failure = static_cast<const nlmsgerr*>(NLMSG_DATA(header));
+                    if (header->nlmsg_seq == m_dumpSequence && failure->error != 0) {
+                        m_dumpError = -failure->error;
+                        m_dumpSequence = 0;
+                    }
+                    break;
+                }
+                case RTM_NEWLINK:
+                case RTM_DELLINK:
+                    applyLinkLocked(header, header->nlmsg_type == RTM_DELLINK, now);
+                    break;
+                case RTM_NEWADDR:
+                case RTM_DELADDR:
+                    applyAddressLocked(header, header->nlmsg_type == RTM_DELADDR);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        resyncLocked();
+        publishLocked();
+        if (m_topologyChanged) {
+            m_topologyChanged = false;
+            callback = m_changeCallback;
+            std::lock_guard<std::mutex> snapshotLock(m_snapshotMutex);
+            published = m_snapshot;
+        }
+    }
+    if (callback && published) {
+        callback(*published);
+    }
+}
+
+void NetworkMonitor::applyLinkLocked(const void* message, bool removed, std::chrono::steady_clock::time_point now) {
+    auto* header = static_cast<const nlmsghdr*>(message);
+    auto* link = static_cast<const ifinfomsg*>(NLMSG_DATA(header));
+    const int index = link->ifi_index;
+
+    if (removed) {
+        m_interfaces.erase(index);
+        m_counters.erase(index);
+        m_topologyChanged = true;
+        return;
+    }
+
+    auto inserted = m_interfaces.emplace(index, NetworkInterfaceInfo());
+    NetworkInterfaceInfo& info = inserted.first->second;
+    if (inserted.second) {
+        info = NetworkInterfaceInfo{};
+        info.index = index;
+    }
+    const bool up = (link->ifi_flags & IFF_UP) != 0;
+    const bool running = (link->ifi_flags & IFF_RUNNING) != 0;
+    const bool loopback = (link->ifi_flags & IFF_LOOPBACK) != 0;
+
+    std::string name = info.name;
+    uint32_t mtu = info.mtu;
+    bool haveStats = false;
+    rtnl_link_stats64 stats = {};
+
+    int length = static_cast<int>(IFLA_PAYLOAD(header));
+    for (auto* attribute = IFLA_RTA(link); RTA_OK(attribute, length); attribute = RTA_NEXT(attribute, length)) {
+        switch (attribute->rta_type) {
+            case IFLA_IFNAME:
+                name = static_cast<const char*>(RTA_DATA(attribute));
+                break;
+            case IFLA_MTU:
+                memcpy(&mtu, RTA_DATA(attribute), sizeof(mtu));
+                break;
+            case IFLA_STATS64:
+                if (RTA_PAYLOAD(attribute) >= sizeof(stats)) {
+                    memcpy(&stats, RTA_DATA(attribute), sizeof(stats));
+                    haveStats = true;
+                }
+                break;
+            case IFLA_STATS:
+                if (!haveStats && RTA_PAYLOAD(attribute) >= sizeof(rtnl_link_stats)) {
+                    rtnl_link_stats stats32;
+                    memcpy(&stats32, RTA_DATA(attribute), sizeof(stats32));
+                    stats.rx_bytes = stats32.rx_bytes;
+                    stats.tx_bytes = stats32.tx_bytes;
+                    stats.rx_packets = stats32.rx_packets;
+                    stats.tx_packets = stats32.tx_packets;
+                    stats.rx_errors = stats32.rx_errors;
+                    stats.tx_errors = stats32.tx_errors;
+                    haveStats = true;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (inserted.second || name != info.name || up != info.up || running != info.running || mtu != info.mtu) {
+        m_topologyChanged = true;
+    }
+    info.name = name;
+    info.up = up;
+    info.running = running;
+    info.loopback = loopback;
+    info.mtu = mtu;
+
+    if (!haveStats) {
+        return;
+    }
+    info.rxBytes = stats.rx_bytes;
+    info.txBytes = stats.tx_bytes;
+    info.rxPackets = stats.rx_packets;
+    info.txPackets = stats.tx_packets;
+    info.rxErrors = stats.rx_errors;
+    info.txErrors = stats.tx_errors;
+
+    LinkCounters& counters = m_counters[index];
+    if (counters.sampled == std::chrono::steady_clock::time_point()) {
+        counters = {stats.rx_bytes, stats.tx_bytes, now};
+        return;
+    }
+    const auto elapsed = now - counters.sampled;
+    if (elapsed < MIN_RATE_INTERVAL) {
+        return;
+    }
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    // Counters restart when a driver is reloaded; report no traffic then
+    info.rxBytesPerSecond = stats.rx_bytes >= counters.rxBytes ? (stats.rx_bytes - counters.rxBytes) / seconds : 0.0;
+    info.txBytesPerSecond = stats.tx_bytes >= counters.txBytes ? (stats.tx_bytes - counters.txBytes) / seconds : 0.0;
+    counters = {stats.rx_bytes, stats.tx_bytes, now};
+}
+
+void NetworkMonitor::applyAddressLocked(const void* message, bool removed) {
+    auto* header = static_cast<const nlmsghdr*>(message);
+    auto* ifa = static_cast<const ifaddrmsg*>(NLMSG_DATA(header));
+    if (ifa->ifa_family != AF_INET && ifa->ifa_family != AF_INET6) {
+        return;
+    }
+
+    // IFA_LOCAL is the interface's own address on point-to-point links,
+    // where IFA_ADDRESS is the peer
+    const void* local = nullptr;
+    const void* address = nullptr;
+    int length = static_cast<int>(IFA_PAYLOAD(header));
+    for (auto* attribute = IFA_RTA(ifa); RTA_OK(attribute, length); attribute = RTA_NEXT(attribute, length)) {
+        if (attribute->rta_type == IFA_LOCAL) {
+            local = RTA_DATA(attribute);
+        } else if (attribute->rta_type == IFA_ADDRESS) {
+            address = RTA_DATA(attribute);
+        }
+    }
+    const void* raw = local ? local : address;
+    if (!raw) {
+        return;
+    }
+    char text[INET6_ADDRSTRLEN];
+    if (!inet_ntop(ifa->ifa_family, raw, text, sizeof(text))) {
+        return;
+    }
+
+    auto inserted = m_interfaces.emplace(static_cast<int>(ifa->ifa_index), NetworkInterfaceInfo());
+    NetworkInterfaceInfo& info = inserted.first->second;
+    if (inserted.second) {
+        info = NetworkInterfaceInfo{};
+        info.index = static_cast<int>(ifa->ifa_index);
+    }
+    auto& addresses = info.addresses;
+    for (auto it = addresses.begin(); it != addresses.end(); ++it) {
+        if (it->family == ifa->ifa_family && it->address == text) {
+            if (removed) {
+                addresses.erase(it);
+                m_topologyChanged = true;
+            } else if (it->prefixLength != ifa->ifa_prefixlen) {
+                it->prefixLength = ifa->ifa_prefixlen;
+                m_topologyChanged = true;
+            }
+            return;
+        }
+    }
+    if (!removed) {
+        addresses.push_back({ifa->ifa_family, text, ifa->ifa_prefixlen});
+        m_topologyChanged = true;
+    }
+}
+
+#else
+
+bool NetworkMonitor::start(std::chrono::milliseconds, std::string* error) {
+    if (error) {
+        *error = "rtnetlink is not available on this platform";
+    }
+    return false;
+}
+
+void NetworkMonitor::stop() {
+}
+
+void NetworkMonitor::handleMessages(const void*, size_t, std::chrono::steady_clock::time_point) {
+}
+
+#endif
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "platform.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Network interfaces, addresses and traffic counters cached from rtnetlink.
+//
+// start() dumps links and addresses once, then one thread follows the
+// RTM_NEWLINK/DELLINK/NEWADDR/DELADDR broadcasts, so interface and
+// address changes are applied as the kernel reports them. Link
+// broadcasts do not fire on traffic, so the thread also requests a link
+// dump (one sendmsg, a few KB back) every statistics interval and
+// derives per-interface rx/tx rates from consecutive counters.
+//
+// Readers get an immutable snapshot: interface lists, the primary IPv4
+// address and counters are plain reads of cached state, with no syscall.
+
+struct NetworkSnapshot {
+    std::vector<NetworkInterfaceInfo> interfaces;   // By interface index
+    std::vector<std::string> names;                 // Same order
+    std::string primaryIPv4;                        // First non-loopback IPv4, empty if none
+    uint64_t generation = 0;
+};
+
+class NetworkMonitor {
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_STATS_INTERVAL{1000};
+    static constexpr int RECEIVE_BUFFER_SIZE = 256 * 1024;
+
+    NetworkMonitor();
+    ~NetworkMonitor();
+
+    NetworkMonitor(const NetworkMonitor&) = delete;
+    NetworkMonitor& operator=(const NetworkMonitor&) = delete;
+
+    // Open the rtnetlink socket, load the current state and start the
+    // listener thread. Fails where link dumps are denied (Android apps
+    // targeting API 30 and later); callers then fall back to getifaddrs().
+    bool start(std::chrono::milliseconds statsInterval = DEFAULT_STATS_INTERVAL,
+               std::string* error = nullptr);
+    void stop();
+    bool isRunning() const;
+
+    // Cached state; never null
+    std::shared_ptr<const NetworkSnapshot> snapshot() const;
+    std::vector<std::string> getInterfaceNames() const;
+    std::string getPrimaryIPv4() const;
+    bool getInterface(const std::string& name, NetworkInterfaceInfo& out) const;
+
+    // Called on the listener thread after an update that added, removed
+    // or reconfigured an interface or address (not on counter updates)
+    void setChangeCallback(std::function<void(const NetworkSnapshot&)> callback);
+
+    // Apply a buffer of rtnetlink messages received at `now`. Used by the
+    // listener thread; exposed so message handling can be driven directly.
+    void handleMessages(const void* data, size_t size, std::chrono::steady_clock::time_point now);
+
+    // Link dumps requested for statistics, for metrics and tests
+    uint64_t getStatsDumps() const;
+
+private:
+    struct LinkCounters {
+        uint64_t rxBytes = 0;
+        uint64_t txBytes = 0;
+        std::chrono::steady_clock::time_point sampled;
+    };
+
+    std::chrono::milliseconds m_statsInterval{DEFAULT_STATS_INTERVAL};
+
+    // Listener state, also touched by start() before the thread runs
+    std::mutex m_mutex;
+    std::map<int, NetworkInterfaceInfo> m_interfaces;
+    std::map<int, LinkCounters> m_counters;
+    std::function<void(const NetworkSnapshot&)> m_changeCallback;
+    bool m_topologyChanged = false;
+    uint32_t m_dumpSequence = 0;    // Dump in flight (one per socket), 0 if none
+    std::chrono::steady_clock::time_point m_dumpStarted;
+    int m_dumpError = 0;            // errno of a failed dump, 0 if none
+    bool m_resyncLinks = false;     // Broadcasts were lost; reload everything
+    bool m_resyncAddresses = false;
+
+    mutable std::mutex m_snapshotMutex;
+    std::shared_ptr<const NetworkSnapshot> m_snapshot;
+
+    int m_socket = -1;
+    int m_wakeFd = -1;
+    uint32_t m_sequence = 0;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64_t> m_statsDumps{0};
+
+    bool requestDumpLocked(int type);
+    // Issue a queued resync dump if none is in flight
+    void resyncLocked();
+    // Receive until the dump in flight has finished; used by start()
+    bool receiveDump();
+    bool receiveOnce(int timeoutMs);
+    void run();
+    void applyLinkLocked(const void* message, bool removed, std::chrono::steady_clock::time_point now);
+    void applyAddressLocked(const void* message, bool removed);
+    void publishLocked();
+};
@@ -45,4 +45,8 @@ PlatformType Platform::getCurrentPlatform() {
 #else
     return PlatformType::Linux;
 #endif
-}
\ No newline at end of file
+}
+
+std::vector<NetworkInterfaceInfo> Platform::getNetworkStatistics() {
+    return {};
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,6 +22,30 @@ struct SystemInfo {
     uint64_t availableMemory;
 };
 
+struct NetworkAddress {
+    int family;             // AF_INET or AF_INET6
+    std::string address;    // Numeric form
+    uint8_t prefixLength;
+};
+
+struct NetworkInterfaceInfo {
+    int index;
+    std::string name;
+    bool up;                // Administratively up
+    bool running;           // Carrier present
+    bool loopback;
+    uint32_t mtu;
+    std::vector<NetworkAddress> addresses;
+    uint64_t rxBytes;
+    uint64_t txBytes;
+    uint64_t rxPackets;
+    uint64_t txPackets;
+    uint64_t rxErrors;
+    uint64_t txErrors;
+    double rxBytesPerSecond;   // Over the last statistics interval
+    double txBytesPerSecond;
+};
+
 class Platform {
 public:
     virtual ~Platform() = default;
@@ -52,6 +77,8 @@ public:
     virtual bool hasNetworkAccess() = 0;
     virtual std::string getIPAddress() = 0;
     virtual std::vector<std::string> getNetworkInterfaces() = 0;
+    // Per-interface counters and throughput; empty where not supported
+    virtual std::vector<NetworkInterfaceInfo> getNetworkStatistics();
     
 protected:
     Platform() = default;
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// Heap allocation counter shared by the benchmarks. The global operator
+// new replacement lives in allocation_counter.cpp; the other benchmarks
+// are unaffected apart from one relaxed increment per allocation.
+namespace benchmark_support {
+
+uint64_t allocationCount() noexcept;
+
+} // namespace benchmark_support
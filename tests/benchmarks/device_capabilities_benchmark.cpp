@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+#include "hardware/device_capabilities.h"
+#include "fake_sysfs.h"
+#include <map>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+
+// A phone-sized tree: a dozen thermal zones, a few supplies and IIO devices
+void populate(FakeSysfs& sysfs) {
+    for (int i = 0; i < 12; ++i) {
+        sysfs.write("sys/class/thermal/thermal_zone" + std::to_string(i) + "/type", "zone");
+    }
+    sysfs.write("sys/class/power_supply/battery/type", "Battery");
+    sysfs.write("sys/class/power_supply/battery/temp", "300");
+    sysfs.write("sys/class/power_supply/usb/type", "USB");
+    sysfs.write("sys/class/hwmon/hwmon0/temp1_input", "40000");
+    sysfs.write("sys/bus/iio/devices/iio:device0/in_accel_x_raw", "0");
+    sysfs.write("sys/bus/iio/devices/iio:device1/in_anglvel_x_raw", "0");
+}
+
+} // namespace
+
+// What getAvailableSensors() used to do on every call: build the candidate
+// map and stat() each path
+static void BM_AvailableSensorsStatPerCall(benchmark::State& state) {
+    FakeSysfs sysfs;
+    populate(sysfs);
+    const std::string root = sysfs.root();
+    for (auto _ : state) {
+        std::vector<SensorType> sensors;
+        const std::map<std::string, SensorType> sensorPaths = {
+            {root + "/sys/class/sensors/accelerometer", SensorType::Accelerometer},
+            {root + "/sys/class/sensors/gyroscope", SensorType::Gyroscope},
+            {root + "/sys/class/sensors/magnetometer", SensorType::Magnetometer},
+            {root + "/sys/class/hwmon/hwmon0/temp1_input", SensorType::Temperature},
+            {root + "/sys/class/power_supply/battery/temp", SensorType::Temperature},
+            {root + "/proc/sys/kernel/brightness", SensorType::Light}
+        };
+        struct stat st;
+        for (const auto& [path, sensorType] : sensorPaths) {
+            if (stat(path.c_str(), &st) == 0) {
+                sensors.push_back(sensorType);
+            }
+        }
+        benchmark::DoNotOptimize(sensors);
+    }
+}
+BENCHMARK(BM_AvailableSensorsStatPerCall);
+
+static void BM_AvailableSensorsCached(benchmark::State& state) {
+    FakeSysfs sysfs;
+    populate(sysfs);
+    DeviceCapabilityTable table(sysfs.path("sys"), sysfs.path("proc"));
+    table.refresh();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table.getAvailableSensors());
+    }
+}
+BENCHMARK(BM_AvailableSensorsCached);
+
+// Cost of one hotplug-triggered rescan, paid only when a device comes or goes
+static void BM_SubsystemRescan(benchmark::State& state) {
+    FakeSysfs sysfs;
+    populate(sysfs);
+    DeviceCapabilityTable table(sysfs.path("sys"), sysfs.path("proc"));
+    table.refresh();
+    for (auto _ : state) {
+        table.refresh("thermal");
+    }
+}
+BENCHMARK(BM_SubsystemRescan);
@@ -0,0 +1,38 @@
+#include <benchmark/benchmark.h>
+#include "hardware/device_control_helper.h"
+#include <cstdlib>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+// What each device control call cost before: a shell plus a command
+static void BM_DeviceControlSystem(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(system("true"));
+    }
+}
+BENCHMARK(BM_DeviceControlSystem)->Unit(benchmark::kMicrosecond);
+
+// One request round trip to a running helper (served on a thread here),
+// excluding whatever the request itself does
+static void BM_DeviceControlHelperRoundTrip(benchmark::State& state) {
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets) != 0) {
+        state.SkipWithError("socketpair failed");
+        return;
+    }
+    DeviceControlHandlers handlers;
+    handlers.setVolume = [](int) { return 0; };
+    std::thread helper([&handlers, fd = sockets[1]] {
+        DeviceControlServer::serve(fd, handlers);
+        ::close(fd);
+    });
+    DeviceControlClient client;
+    client.attach(sockets[0]);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(client.call(DeviceControlOp::SetVolume, 7));
+    }
+    client.stop();
+    helper.join();
+}
+BENCHMARK(BM_DeviceControlHelperRoundTrip)->Unit(benchmark::kMicrosecond);
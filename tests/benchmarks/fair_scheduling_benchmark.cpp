@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+#include "core/session_manager.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace cross_terminal::core;
+
+// One reactor thread serves a foreground `cat` session and N background
+// sessions running `yes`. Reports the foreground echo latency measured
+// by the session metrics, plus the background throughput, to show the
+// flood is throttled by its byte budget instead of starving the echo.
+static void BM_ForegroundEchoUnderFlood(benchmark::State& state) {
+    const int flood_sessions = static_cast<int>(state.range(0));
+
+    SessionManagerConfig config;
+    config.reactor_threads = 1;
+    config.worker_threads = 1;
+    SessionManager manager(config);
+    manager.initialize();
+
+    std::vector<int> flood_ids;
+    for (int i = 0; i < flood_sessions; ++i) {
+        auto id = manager.createSession();
+        manager.getSession(id)->executeAsync("yes", ExecutionOptions(), nullptr, nullptr);
+        flood_ids.push_back(id);
+    }
+
+    auto echo_id = manager.createSession();
+    auto echo = manager.getSession(echo_id);
+    manager.setForegroundSession(echo_id);
+
+    std::atomic<size_t> echoed{0};
+    int echo_pid = echo->executeAsync("cat", ExecutionOptions(),
+        [&echoed](const std::string& data, bool) { echoed.fetch_add(data.size()); },
+        nullptr);
+
+    auto started = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        size_t before = echoed.load();
+        echo->sendInput(echo_pid, "k\n");
+        while (echoed.load() <= before) {
+            std::this_thread::yield();
+        }
+    }
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - started).count();
+
+    auto metrics = manager.getSessionMetrics(echo_id);
+    uint64_t flood_bytes = 0;
+    uint64_t flood_yields = 0;
+    for (auto id : flood_ids) {
+        auto flood = manager.getSessionMetrics(id);
+        flood_bytes += flood.bytes_read;
+        flood_yields += flood.budget_yields;
+    }
+
+    state.counters["flood_sessions"] = flood_sessions;
+    state.counters["echo_p50_us"] = metrics.echo_p50_us;
+    state.counters["echo_p99_us"] = metrics.echo_p99_us;
+    state.counters["echo_max_us"] = metrics.echo_max_us;
+    state.counters["flood_mb_per_s"] = seconds > 0 ? flood_bytes / seconds / (1024.0 * 1024.0) : 0;
+    state.counters["flood_yields"] = flood_yields;
+
+    manager.shutdown();
+}
+BENCHMARK(BM_ForegroundEchoUnderFlood)->Arg(0)->Arg(1)->Arg(4)->Unit(benchmark::kMicrosecond)->Iterations(200);
@@ -0,0 +1,188 @@
+#include <benchmark/benchmark.h>
+#include "core/implementations/file_operations.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace cross_terminal::core;
+
+namespace {
+
+constexpr int TREE_DIRECTORIES = 40;
+constexpr int FILES_PER_DIRECTORY = 50;
+constexpr size_t FILE_SIZE = 16 * 1024;
+constexpr size_t LARGE_FILE_SIZE = 64 * 1024 * 1024;
+
+// Scratch directory on the filesystem under test: CT_BENCH_DIR, e.g.
+// /dev/shm for tmpfs or a directory on ext4/f2fs; /tmp by default
+class Scratch {
+public:
+    Scratch() {
+        const char* base = getenv("CT_BENCH_DIR");
+        std::string pattern = std::string(base ? base : "/tmp") + "/ct_fileops_XXXXXX";
+        root_ = mkdtemp(&pattern[0]) ? pattern : "";
+    }
+    ~Scratch() {
+        if (!root_.empty()) {
+            run("rm -rf '" + root_ + "'");
+        }
+    }
+    bool valid() const { return !root_.empty(); }
+    std::string path(const std::string& relative) const { return root_ + "/" + relative; }
+    static void run(const std::string& command) { benchmark::DoNotOptimize(system(command.c_str())); }
+private:
+    std::string root_;
+};
+
+void writeFile(const std::string& path, size_t size) {
+    std::vector<char> data(64 * 1024, 'x');
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    for (size_t written = 0; fd >= 0 && written < size;) {
+        ssize_t n = write(fd, data.data(), std::min(data.size(), size - written));
+        if (n <= 0) {
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+// TREE_DIRECTORIES x FILES_PER_DIRECTORY files of FILE_SIZE: a source tree
+void populate(const Scratch& scratch) {
+    for (int d = 0; d < TREE_DIRECTORIES; ++d) {
+        const std::string dir = scratch.path("src/d" + std::to_string(d));
+        Scratch::run("mkdir -p '" + dir + "'");
+        for (int f = 0; f < FILES_PER_DIRECTORY; ++f) {
+            writeFile(dir + "/f" + std::to_string(f), FILE_SIZE);
+        }
+    }
+}
+
+constexpr int64_t TREE_BYTES = static_cast<int64_t>(TREE_DIRECTORIES) * FILES_PER_DIRECTORY * FILE_SIZE;
+
+} // namespace
+
+static void BM_CopyTreeNative(benchmark::State& state) {
+    Scratch scratch;
+    if (!scratch.valid()) {
+        state.SkipWithError("no scratch directory");
+        return;
+    }
+    populate(scratch);
+    FsContext fs(scratch.path(""));
+    FileOperationOptions options;
+    options.recursive = true;
+    options.threads = static_cast<size_t>(state.range(0));
+    FileOperations operations(fs, options);
+    for (auto _ : state) {
+        auto result = operations.copy({"src"}, "copy");
+        if (!result.succeeded()) {
+            state.SkipWithError(result.errors.empty() ? "cancelled" : result.errors[0].c_str());
+            break;
+        }
+        state.PauseTiming();
+        Scratch::run("rm -rf '" + scratch.path("copy") + "'");
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * TREE_BYTES);
+    state.SetItemsProcessed(state.iterations() * TREE_DIRECTORIES * FILES_PER_DIRECTORY);
+}
+BENCHMARK(BM_CopyTreeNative)->Arg(1)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// What the shell did before: spawn the system cp
+static void BM_CopyTreeExternal(benchmark::State& state) {
+    Scratch scratch;
+    if (!scratch.valid()) {
+        state.SkipWithError("no scratch directory");
+        return;
+    }
+    populate(scratch);
+    const std::string command = "cp -r '" + scratch.path("src") + "' '" + scratch.path("copy") + "'";
+    for (auto _ : state) {
+        Scratch::run(command);
+        state.PauseTiming();
+        Scratch::run("rm -rf '" + scratch.path("copy") + "'");
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * TREE_BYTES);
+    state.SetItemsProcessed(state.iterations() * TREE_DIRECTORIES * FILES_PER_DIRECTORY);
+}
+BENCHMARK(BM_CopyTreeExternal)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_RemoveTreeNative(benchmark::State& state) {
+    Scratch scratch;
+    if (!scratch.valid()) {
+        state.SkipWithError("no scratch directory");
+        return;
+    }
+    populate(scratch);
+    FsContext fs(scratch.path(""));
+    FileOperationOptions options;
+    options.recursive = true;
+    options.threads = static_cast<size_t>(state.range(0));
+    FileOperations operations(fs, options);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Scratch::run("cp -r '" + scratch.path("src") + "' '" + scratch.path("copy") + "'");
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(operations.remove({"copy"}));
+    }
+    state.SetItemsProcessed(state.iterations() * TREE_DIRECTORIES * FILES_PER_DIRECTORY);
+}
+BENCHMARK(BM_RemoveTreeNative)->Arg(1)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_RemoveTreeExternal(benchmark::State& state) {
+    Scratch scratch;
+    if (!scratch.valid()) {
+        state.SkipWithError("no scratch directory");
+        return;
+    }
+    populate(scratch);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Scratch::run("cp -r '" + scratch.path("src") + "' '" + scratch.path("copy") + "'");
+        state.ResumeTiming();
+        Scratch::run("rm -rf '" + scratch.path("copy") + "'");
+    }
+    state.SetItemsProcessed(state.iterations() * TREE_DIRECTORIES * FILES_PER_DIRECTORY);
+}
+BENCHMARK(BM_RemoveTreeExternal)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// One large file: FICLONE or copy_file_range against the external cp
+static void BM_CopyLargeFileNative(benchmark::State& state) {
+    Scratch scratch;
+    if (!scratch.valid()) {
+        state.SkipWithError("no scratch directory");
+        return;
+    }
+    writeFile(scratch.path("large"), LARGE_FILE_SIZE);
+    FsContext fs(scratch.path(""));
+    FileOperations operations(fs);
+    uint64_t reflinked = 0;
+    for (auto _ : state) {
+        reflinked += operations.copy({"large"}, "large.copy").totals.reflinked;
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(LARGE_FILE_SIZE));
+    state.counters["reflinked"] = static_cast<double>(reflinked);
+}
+BENCHMARK(BM_CopyLargeFileNative)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_CopyLargeFileExternal(benchmark::State& state) {
+    Scratch scratch;
+    if (!scratch.valid()) {
+        state.SkipWithError("no scratch directory");
+        return;
+    }
+    writeFile(scratch.path("large"), LARGE_FILE_SIZE);
+    const std::string command = "cp '" + scratch.path("large") + "' '" + scratch.path("large.copy") + "'";
+    for (auto _ : state) {
+        Scratch::run(command);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(LARGE_FILE_SIZE));
+}
+BENCHMARK(BM_CopyLargeFileExternal)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+#include "core/implementations/fs_context.h"
+#include "fake_sysfs.h"
+#include <dirent.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+using namespace cross_terminal::core;
+
+namespace {
+
+constexpr int TREE_DEPTH = 12;
+constexpr int FILES_PER_LEAF = 64;
+
+// A project-like tree: a chain of TREE_DEPTH directories with
+// FILES_PER_LEAF files at the bottom
+std::string populate(FakeSysfs& tree, std::vector<std::string>& files) {
+    std::string leaf;
+    for (int level = 0; level < TREE_DEPTH; ++level) {
+        leaf += "level" + std::to_string(level) + "/";
+    }
+    for (int i = 0; i < FILES_PER_LEAF; ++i) {
+        files.push_back(leaf + "file" + std::to_string(i) + ".cpp");
+        tree.write(files.back(), "");
+    }
+    leaf.pop_back();
+    return leaf;
+}
+
+} // namespace
+
+// Path strings: the kernel walks all TREE_DEPTH components for every file
+static void BM_DeepTreeStatByPath(benchmark::State& state) {
+    FakeSysfs tree;
+    std::vector<std::string> files;
+    populate(tree, files);
+    for (auto& file : files) {
+        file = tree.path(file);
+    }
+    for (auto _ : state) {
+        struct stat st;
+        for (const auto& file : files) {
+            benchmark::DoNotOptimize(::stat(file.c_str(), &st));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * files.size());
+}
+BENCHMARK(BM_DeepTreeStatByPath);
+
+// The same stats through FsContext: one statx on the cached leaf fd each
+static void BM_DeepTreeStatFsContext(benchmark::State& state) {
+    FakeSysfs tree;
+    std::vector<std::string> files;
+    populate(tree, files);
+    FsContext fs(tree.root());
+    for (auto _ : state) {
+        FsStat info;
+        for (const auto& file : files) {
+            benchmark::DoNotOptimize(fs.stat(file, info));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * files.size());
+}
+BENCHMARK(BM_DeepTreeStatFsContext);
+
+// Listing with types: readdir plus a stat per entry, as ls -F or
+// completion did without d_type
+static void BM_DeepTreeListStatEach(benchmark::State& state) {
+    FakeSysfs tree;
+    std::vector<std::string> files;
+    const std::string leaf = tree.path(populate(tree, files));
+    for (auto _ : state) {
+        DIR* dir = opendir(leaf.c_str());
+        size_t directories = 0;
+        while (dirent* entry = readdir(dir)) {
+            struct stat st;
+            if (::stat((leaf + "/" + entry->d_name).c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+                ++directories;
+            }
+        }
+        closedir(dir);
+        benchmark::DoNotOptimize(directories);
+    }
+}
+BENCHMARK(BM_DeepTreeListStatEach);
+
+static void BM_DeepTreeListFsContext(benchmark::State& state) {
+    FakeSysfs tree;
+    std::vector<std::string> files;
+    const std::string leaf = populate(tree, files);
+    FsContext fs(tree.root());
+    std::vector<FsEntry> entries;
+    for (auto _ : state) {
+        entries.clear();
+        fs.listDirectory(leaf, entries);
+        size_t directories = 0;
+        for (const auto& entry : entries) {
+            directories += entry.type == FsEntryType::Directory;
+        }
+        benchmark::DoNotOptimize(directories);
+    }
+}
+BENCHMARK(BM_DeepTreeListFsContext);
+
+static void BM_DeepTreeGlob(benchmark::State& state) {
+    FakeSysfs tree;
+    std::vector<std::string> files;
+    const std::string leaf = populate(tree, files);
+    FsContext fs(tree.root());
+    const std::string pattern = leaf + "/file1*.cpp";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fs.glob(pattern));
+    }
+}
+BENCHMARK(BM_DeepTreeGlob);
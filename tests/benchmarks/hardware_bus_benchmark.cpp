@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include "hardware/hardware_bus.h"
+#include "fake_hardware_bus.h"
+#include <cstdint>
+#include <memory>
+
+using namespace cross_terminal::hardware;
+
+namespace {
+
+constexpr int SENSOR_COUNT = 16;
+constexpr uint16_t FIRST_ADDRESS = 0x40;
+constexpr uint64_t TRANSFER_OVERHEAD_NS = 60000;   // Syscall, driver setup and bus turnaround
+
+// Wall time measures the software path; bus_us_per_sweep is the modelled
+// time the sweep occupies a 400 kHz bus, where batching saves one
+// transaction overhead per sensor
+void reportBusTime(benchmark::State& state, uint64_t bus_time_ns) {
+    state.counters["bus_us_per_sweep"] = benchmark::Counter(
+        static_cast<double>(bus_time_ns) / 1000.0 / static_cast<double>(state.iterations()));
+    state.SetItemsProcessed(state.iterations() * SENSOR_COUNT);
+}
+
+FakeI2CBus* makeSensorBus() {
+    auto* bus = new FakeI2CBus(400000, TRANSFER_OVERHEAD_NS);
+    for (uint16_t i = 0; i < SENSOR_COUNT; ++i) {
+        bus->addDevice(FIRST_ADDRESS + i);
+    }
+    return bus;
+}
+
+} // namespace
+
+// One readRegisters() transaction per sensor, as an external tool would
+static void BM_I2CSweepPerAccess(benchmark::State& state) {
+    std::unique_ptr<FakeI2CBus> bus(makeSensorBus());
+    uint8_t readings[SENSOR_COUNT][6];
+    for (auto _ : state) {
+        for (uint16_t i = 0; i < SENSOR_COUNT; ++i) {
+            benchmark::DoNotOptimize(bus->readRegisters(FIRST_ADDRESS + i, 0x28, readings[i], 6));
+        }
+    }
+    reportBusTime(state, bus->stats().bus_time_ns);
+}
+BENCHMARK(BM_I2CSweepPerAccess);
+
+// The same sweep queued in a reused I2CBatch
+static void BM_I2CSweepBatched(benchmark::State& state) {
+    std::unique_ptr<FakeI2CBus> bus(makeSensorBus());
+    uint8_t readings[SENSOR_COUNT][6];
+    I2CBatch batch;
+    for (auto _ : state) {
+        batch.clear();
+        for (uint16_t i = 0; i < SENSOR_COUNT; ++i) {
+            batch.readRegisters(FIRST_ADDRESS + i, 0x28, readings[i], 6);
+        }
+        benchmark::DoNotOptimize(batch.execute(*bus));
+    }
+    reportBusTime(state, bus->stats().bus_time_ns);
+}
+BENCHMARK(BM_I2CSweepBatched);
+
+// SPI register reads, one message per command vs one message per batch
+static void BM_SPISweep(benchmark::State& state) {
+    const bool batched = state.range(0) != 0;
+    FakeSPIDevice device(TRANSFER_OVERHEAD_NS);
+    SPIConfig config;
+    config.speed_hz = 10000000;
+    device.configure(config);
+
+    uint8_t readings[SENSOR_COUNT][6];
+    SPIBatch batch;
+    for (auto _ : state) {
+        batch.clear();
+        for (uint8_t i = 0; i < SENSOR_COUNT; ++i) {
+            const uint8_t command = FakeSPIDevice::READ | i;
+            batch.command(&command, 1, readings[i], 6);
+            if (!batched) {
+                benchmark::DoNotOptimize(batch.execute(device));
+                batch.clear();
+            }
+        }
+        if (batched) {
+            benchmark::DoNotOptimize(batch.execute(device));
+        }
+    }
+    reportBusTime(state, device.stats().bus_time_ns);
+}
+BENCHMARK(BM_SPISweep)->Arg(0)->Arg(1);
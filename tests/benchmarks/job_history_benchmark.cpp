@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+#include "core/implementations/job_history.h"
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+using namespace cross_terminal::core;
+
+namespace {
+
+constexpr size_t RECORD_COUNT = 1000000;
+constexpr uint64_t SPAN_MS = 30ull * 24 * 60 * 60 * 1000;   // One month of jobs
+
+uint64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+ProcessInfo syntheticJob(size_t i, uint64_t end_time) {
+    static const char* commands[] = {"ls", "git", "make", "grep", "cat", "ssh", "vim", "python3"};
+    ProcessInfo info;
+    info.command = commands[i % 8];
+    info.arguments = {"--flag", std::to_string(i)};
+    info.working_dir = "/home/user/project";
+    info.exit_code = (i % 20 == 0) ? 1 : 0;   // 5% failures
+    info.state = info.exit_code ? ProcessState::Failed : ProcessState::Completed;
+    info.start_time = end_time - 100;
+    info.end_time = end_time;
+    return info;
+}
+
+// One million jobs spread over the last month, shared by all query benchmarks
+struct PopulatedHistory {
+    std::string directory;
+    JobHistory history;
+    uint64_t now;
+
+    PopulatedHistory() : now(nowMs()) {
+        char path[] = "/tmp/job_history_bench_XXXXXX";
+        directory = mkdtemp(path);
+        history.open(directory);
+        for (size_t i = 0; i < RECORD_COUNT; ++i) {
+            history.append(syntheticJob(i, now - SPAN_MS + i * (SPAN_MS / RECORD_COUNT)));
+        }
+    }
+
+    ~PopulatedHistory() {
+        history.close();
+        std::system(("rm -rf " + directory).c_str());
+    }
+
+    static PopulatedHistory& instance() {
+        static PopulatedHistory populated;
+        return populated;
+    }
+};
+
+} // namespace
+
+static void BM_JobHistoryAppend(benchmark::State& state) {
+    char path[] = "/tmp/job_history_append_XXXXXX";
+    std::string directory = mkdtemp(path);
+    JobHistory history;
+    history.open(directory);
+
+    const uint64_t now = nowMs();
+    size_t i = 0;
+    for (auto _ : state) {
+        history.append(syntheticJob(i++, now));
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    history.close();
+    std::system(("rm -rf " + directory).c_str());
+}
+BENCHMARK(BM_JobHistoryAppend);
+
+// jobs --history --failed --since 1h
+static void BM_JobHistoryFailedSinceHour(benchmark::State& state) {
+    auto& populated = PopulatedHistory::instance();
+    JobQuery query;
+    query.failed_only = true;
+    query.since = populated.now - 60 * 60 * 1000;
+
+    size_t matches = 0;
+    for (auto _ : state) {
+        matches = populated.history.query(query).size();
+        benchmark::DoNotOptimize(matches);
+    }
+    state.counters["records"] = populated.history.size();
+    state.counters["matches"] = matches;
+}
+BENCHMARK(BM_JobHistoryFailedSinceHour)->Unit(benchmark::kMicrosecond);
+
+// jobs --history --command make --limit 50
+static void BM_JobHistoryByCommand(benchmark::State& state) {
+    auto& populated = PopulatedHistory::instance();
+    JobQuery query;
+    query.command = "make";
+    query.limit = 50;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(populated.history.query(query));
+    }
+}
+BENCHMARK(BM_JobHistoryByCommand)->Unit(benchmark::kMicrosecond);
+
+// jobs --history --since 1d (all matches, zone-map scan)
+static void BM_JobHistorySinceDay(benchmark::State& state) {
+    auto& populated = PopulatedHistory::instance();
+    JobQuery query;
+    query.since = populated.now - 24 * 60 * 60 * 1000;
+
+    size_t matches = 0;
+    for (auto _ : state) {
+        matches = populated.history.query(query).size();
+        benchmark::DoNotOptimize(matches);
+    }
+    state.counters["matches"] = matches;
+}
+BENCHMARK(BM_JobHistorySinceDay)->Unit(benchmark::kMillisecond);
+
+// Index rebuild cost when reopening a log of one million jobs
+static void BM_JobHistoryOpen(benchmark::State& state) {
+    auto& populated = PopulatedHistory::instance();
+    populated.history.flush();
+
+    for (auto _ : state) {
+        JobHistory reopened;
+        benchmark::DoNotOptimize(reopened.open(populated.directory));
+    }
+}
+BENCHMARK(BM_JobHistoryOpen)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,191 @@
+#include <benchmark/benchmark.h>
+#include "memory/lock_free_queue.h"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace cross_terminal::memory;
+
+namespace {
+
+constexpr int ITEMS_PER_RUN = 1 << 16;
+constexpr size_t QUEUE_CAPACITY = 1024;
+
+// The mutex + container hand-off used before the lock-free queues
+template<typename T>
+class MutexQueue {
+public:
+    explicit MutexQueue(size_t capacity) : capacity_(capacity) {}
+
+    bool try_push(T value) {
+        std::lock_guard lock(mutex_);
+        if (items_.size() >= capacity_) {
+            return false;
+        }
+        items_.push_back(std::move(value));
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        std::lock_guard lock(mutex_);
+        if (items_.empty()) {
+            return false;
+        }
+        out = std::move(items_.front());
+        items_.pop_front();
+        return true;
+    }
+
+private:
+    std::deque<T> items_;
+    size_t capacity_;
+    std::mutex mutex_;
+};
+
+struct Item : MpscNode {
+    uint64_t value = 0;
+};
+
+// Adapts the intrusive MPSC queue to the try_push/try_pop shape; nodes
+// come from a preallocated pool, one slot per item of a run
+class MpscAdapter {
+public:
+    explicit MpscAdapter(size_t) : nodes_(new Item[ITEMS_PER_RUN]) {}
+
+    bool try_push(uint64_t value) {
+        Item* node = &nodes_[next_.fetch_add(1, std::memory_order_relaxed) % ITEMS_PER_RUN];
+        node->value = value;
+        queue_.push(node);
+        return true;
+    }
+
+    bool try_pop(uint64_t& out) {
+        Item* node = queue_.pop();
+        if (!node) {
+            return false;
+        }
+        out = node->value;
+        return true;
+    }
+
+private:
+    MpscQueue<Item> queue_;
+    std::unique_ptr<Item[]> nodes_;
+    std::atomic<size_t> next_{0};
+};
+
+// Moves ITEMS_PER_RUN values from P producers to C consumers
+template<typename Queue>
+void runTransfer(benchmark::State& state) {
+    const int producers = static_cast<int>(state.range(0));
+    const int consumers = static_cast<int>(state.range(1));
+    const int per_producer = ITEMS_PER_RUN / producers;
+    const int total = per_producer * producers;
+
+    for (auto _ : state) {
+        Queue queue(QUEUE_CAPACITY);
+        std::atomic<int> remaining{total};
+        std::vector<std::thread> threads;
+
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < per_producer; ++i) {
+                    while (!queue.try_push(static_cast<uint64_t>(i))) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (int c = 0; c < consumers; ++c) {
+            threads.emplace_back([&]() {
+                uint64_t value;
+                while (remaining.load(std::memory_order_relaxed) > 0) {
+                    if (queue.try_pop(value)) {
+                        benchmark::DoNotOptimize(value);
+                        remaining.fetch_sub(1, std::memory_order_relaxed);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * total);
+}
+
+// Round trip through two SPSC rings: request out, echo back
+template<typename Wait>
+void runPingPong(benchmark::State& state) {
+    SpscRing<uint64_t> requests(64);
+    SpscRing<uint64_t> replies(64);
+    Wait request_ready;
+    Wait reply_ready;
+    std::atomic<bool> stop{false};
+
+    std::thread echo([&]() {
+        uint64_t value = 0;
+        for (;;) {
+            request_ready.await([&]() { return requests.try_pop(value) || stop.load(); });
+            if (stop.load()) {
+                return;
+            }
+            replies.try_push(value);
+            reply_ready.notify_one();
+        }
+    });
+
+    uint64_t value = 0;
+    for (auto _ : state) {
+        requests.try_push(value);
+        request_ready.notify_one();
+        reply_ready.await([&]() { return replies.try_pop(value); });
+        ++value;
+    }
+
+    stop.store(true);
+    request_ready.notify_all();
+    echo.join();
+}
+
+} // namespace
+
+// Args: producers, consumers
+static void BM_Transfer_Mutex(benchmark::State& state) {
+    runTransfer<MutexQueue<uint64_t>>(state);
+}
+BENCHMARK(BM_Transfer_Mutex)
+    ->Args({1, 1})->Args({4, 1})->Args({4, 4})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_Transfer_SpscRing(benchmark::State& state) {
+    runTransfer<SpscRing<uint64_t>>(state);
+}
+BENCHMARK(BM_Transfer_SpscRing)->Args({1, 1})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_Transfer_MpscQueue(benchmark::State& state) {
+    runTransfer<MpscAdapter>(state);
+}
+BENCHMARK(BM_Transfer_MpscQueue)
+    ->Args({1, 1})->Args({4, 1})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_Transfer_MpmcQueue(benchmark::State& state) {
+    runTransfer<MpmcQueue<uint64_t>>(state);
+}
+BENCHMARK(BM_Transfer_MpmcQueue)
+    ->Args({1, 1})->Args({4, 1})->Args({4, 4})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Hand-off latency: one round trip per iteration
+static void BM_PingPong_SpinWait(benchmark::State& state) {
+    runPingPong<SpinWait>(state);
+}
+BENCHMARK(BM_PingPong_SpinWait)->UseRealTime();
+
+static void BM_PingPong_FutexWait(benchmark::State& state) {
+    runPingPong<FutexWait>(state);
+}
+BENCHMARK(BM_PingPong_FutexWait)->UseRealTime();
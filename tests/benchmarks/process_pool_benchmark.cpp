@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+#include "allocation_counter.h"
+#include "core/implementations/process_pool.h"
+#include "core/implementations/shell_impl.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace cross_terminal::core;
+using benchmark_support::allocationCount;
+
+namespace {
+
+void runToCompletion(ManagedProcess& process) {
+    std::atomic<bool> done{false};
+    process.setCompletionCallback([&done](const ProcessInfo&) { done.store(true); });
+    if (!process.start(ExecutionOptions())) {
+        return;
+    }
+    while (!done.load()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+} // namespace
+
+// Object churn only: acquire and release without spawning.
+// Arg: pool capacity (0 = no pooling, the previous make_unique behaviour)
+static void BM_ProcessAcquireRelease(benchmark::State& state) {
+    ProcessPool pool(static_cast<size_t>(state.range(0)));
+    const ArgumentList args = {"-la", "/tmp"};
+
+    pool.acquire(0, "ls", args).reset(); // Warm the idle list
+    const uint64_t before = allocationCount();
+    for (auto _ : state) {
+        auto process = pool.acquire(1, "ls", args);
+        benchmark::DoNotOptimize(process.get());
+    }
+    state.counters["allocs_per_op"] = benchmark::Counter(
+        static_cast<double>(allocationCount() - before) / state.iterations());
+}
+BENCHMARK(BM_ProcessAcquireRelease)->Arg(0)->Arg(64);
+
+// Full short-command lifecycle on a reactor: spawn /bin/echo, drain its
+// output, reap and release. Reports heap allocations per spawned command.
+static void BM_SpawnShortCommand(benchmark::State& state) {
+    IoReactor reactor(1);
+    reactor.start();
+    ProcessPool pool(static_cast<size_t>(state.range(0)));
+    const ArgumentList args = {"hello"};
+
+    {
+        auto warm = pool.acquire(0, "/bin/echo", args, &reactor);
+        runToCompletion(*warm);
+    }
+    const uint64_t before = allocationCount();
+    for (auto _ : state) {
+        auto process = pool.acquire(1, "/bin/echo", args, &reactor);
+        runToCompletion(*process);
+    }
+    state.counters["allocs_per_spawn"] = benchmark::Counter(
+        static_cast<double>(allocationCount() - before) / state.iterations());
+    state.counters["reused"] = static_cast<double>(pool.getStats().reused);
+
+    reactor.stop();
+}
+BENCHMARK(BM_SpawnShortCommand)->Arg(0)->Arg(64)->UseRealTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include "hardware/pwm_controller.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+
+constexpr int CHANNEL_COUNT = 64;
+constexpr uint64_t PERIOD_NS = 40000;   // 25 kHz, typical for 4-pin fans
+
+// Fake sysfs tree with CHANNEL_COUNT exported channels. Regular files are
+// cheaper to store into than real sysfs attributes, so the gap below is
+// the open/close overhead alone, a lower bound on the gain on hardware.
+struct FakePWMTree {
+    std::string root;
+
+    FakePWMTree() {
+        char path[] = "/tmp/pwm_bench_XXXXXX";
+        root = mkdtemp(path);
+        mkdir((root + "/pwmchip0").c_str(), 0755);
+        for (int i = 0; i < CHANNEL_COUNT; ++i) {
+            const std::string dir = channelPath(i);
+            mkdir(dir.c_str(), 0755);
+            std::ofstream(dir + "/period") << PERIOD_NS << "\n";
+            std::ofstream(dir + "/duty_cycle") << 0 << "\n";
+            std::ofstream(dir + "/enable") << 1 << "\n";
+        }
+    }
+
+    ~FakePWMTree() {
+        std::system(("rm -rf " + root).c_str());
+    }
+
+    std::string channelPath(int channel) const {
+        return root + "/pwmchip0/pwm" + std::to_string(channel);
+    }
+
+    static FakePWMTree& instance() {
+        static FakePWMTree tree;
+        return tree;
+    }
+};
+
+uint64_t dutyFor(uint64_t i) {
+    return (i * 97) % PERIOD_NS;   // Changes every update, so none is skipped
+}
+
+} // namespace
+
+// One duty update through an open channel: a single pwrite
+static void BM_PWMPersistentHandle(benchmark::State& state) {
+    PWMChannel channel(0, 0, FakePWMTree::instance().root);
+    channel.open();
+    uint64_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(channel.setDutyCycle(dutyFor(++i)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PWMPersistentHandle);
+
+// The previous approach: open, write and close the attribute per update
+static void BM_PWMReopenPerWrite(benchmark::State& state) {
+    const std::string path = FakePWMTree::instance().channelPath(0) + "/duty_cycle";
+    uint64_t i = 0;
+    for (auto _ : state) {
+        std::ofstream file(path);
+        file << dutyFor(++i) << "\n";
+        benchmark::DoNotOptimize(file.good());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PWMReopenPerWrite);
+
+// One scheduler tick over CHANNEL_COUNT ramping channels
+static void BM_PWMRampTick(benchmark::State& state) {
+    auto& tree = FakePWMTree::instance();
+    std::vector<std::shared_ptr<PWMChannel>> channels;
+    for (int i = 0; i < CHANNEL_COUNT; ++i) {
+        channels.push_back(std::make_shared<PWMChannel>(0, i, tree.root));
+        channels.back()->open();
+    }
+
+    PWMRampScheduler scheduler;
+    auto now = std::chrono::steady_clock::now();
+    const auto span = std::chrono::hours(1);
+    bool rising = true;
+    for (auto& channel : channels) {
+        scheduler.ramp(channel, PERIOD_NS, std::chrono::duration_cast<std::chrono::milliseconds>(span));
+    }
+    for (auto _ : state) {
+        // A microsecond step on an hour-long ramp moves every duty cycle by
+        // less than a nanosecond, so advance far enough to change each one
+        now += std::chrono::milliseconds(200);
+        if (scheduler.activeRamps() == 0) {
+            rising = !rising;
+            for (auto& channel : channels) {
+                scheduler.ramp(channel, rising ? PERIOD_NS : 0,
+                               std::chrono::duration_cast<std::chrono::milliseconds>(span));
+            }
+            now = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+        }
+        benchmark::DoNotOptimize(scheduler.step(now));
+    }
+    state.SetItemsProcessed(state.iterations() * CHANNEL_COUNT);
+}
+BENCHMARK(BM_PWMRampTick);
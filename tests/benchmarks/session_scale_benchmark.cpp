@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+#include "core/session_manager.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cross_terminal::core;
+
+namespace {
+
+// Reads a "Key:   value" field from /proc/self/status
+long readProcStatus(const std::string& key) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, key.size(), key) == 0 && line[key.size()] == ':') {
+            return std::stol(line.substr(key.size() + 1));
+        }
+    }
+    return -1;
+}
+
+uint64_t nowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Per-session probe: `cat` echoes timestamped lines back through the reactor
+struct SessionProbe {
+    std::shared_ptr<IShell> shell;
+    int pid = -1;
+    std::mutex mutex;
+    std::string partial;
+    std::vector<uint64_t> latencies;
+
+    void onOutput(const std::string& data) {
+        uint64_t now = nowMicros();
+        std::lock_guard lock(mutex);
+        partial += data;
+        size_t newline;
+        while ((newline = partial.find('\n')) != std::string::npos) {
+            uint64_t sent = std::stoull(partial.substr(0, newline));
+            latencies.push_back(now - sent);
+            partial.erase(0, newline + 1);
+        }
+    }
+};
+
+} // namespace
+
+// Opens N sessions, each running a chatty process, and reports the
+// native thread count, RSS and p99 output latency of the whole engine.
+static void BM_SessionScale(benchmark::State& state) {
+    const int session_count = static_cast<int>(state.range(0));
+    const long baseline_threads = readProcStatus("Threads");
+
+    SessionManagerConfig config;
+    config.reactor_threads = 2;
+    config.worker_threads = 2;
+    SessionManager manager(config);
+    manager.initialize();
+
+    std::vector<std::unique_ptr<SessionProbe>> probes;
+    for (int i = 0; i < session_count; ++i) {
+        auto probe = std::make_unique<SessionProbe>();
+        probe->shell = manager.getSession(manager.createSession());
+        SessionProbe* raw = probe.get();
+        probe->pid = probe->shell->executeAsync("cat", ExecutionOptions(),
+            [raw](const std::string& data, bool) { raw->onOutput(data); }, nullptr);
+        probes.push_back(std::move(probe));
+    }
+
+    for (auto _ : state) {
+        // One round: every session writes a line and waits for the echo
+        for (auto& probe : probes) {
+            probe->shell->sendInput(probe->pid, std::to_string(nowMicros()) + "\n");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    // Let in-flight echoes arrive before sampling
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::vector<uint64_t> latencies;
+    for (auto& probe : probes) {
+        std::lock_guard lock(probe->mutex);
+        latencies.insert(latencies.end(), probe->latencies.begin(), probe->latencies.end());
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    state.counters["sessions"] = session_count;
+    state.counters["threads"] = readProcStatus("Threads") - baseline_threads;
+    state.counters["rss_kb"] = readProcStatus("VmRSS");
+    state.counters["p99_latency_us"] = latencies.empty() ?
+        0 : latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+
+    probes.clear();
+    manager.shutdown();
+}
+BENCHMARK(BM_SessionScale)->Arg(10)->Arg(50)->Arg(100)->Unit(benchmark::kMillisecond)->Iterations(100);
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include "allocation_counter.h"
+#include "core/implementations/shell_impl.h"
+#include "core/interfaces/i_hardware_controller.h"
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace cross_terminal;
+using benchmark_support::allocationCount;
+
+namespace {
+
+// SensorData layout before inline storage, kept for comparison
+struct HeapSensorData {
+    hardware::SensorType type = hardware::SensorType::Temperature;
+    std::vector<float> values;
+    uint64_t timestamp = 0;
+    float accuracy = 1.0f;
+};
+
+// Shape of readSensor(): fill a reading, return it, keep the latest few
+template<typename Data>
+Data readSensor(hardware::SensorType type, uint64_t tick) {
+    Data data;
+    data.type = type;
+    const float axis = static_cast<float>(tick & 0xff);
+    if (type == hardware::SensorType::Temperature) {
+        data.values = {21.0f + axis / 256.0f};
+    } else {
+        data.values = {axis, -axis, 9.8f};
+    }
+    data.timestamp = tick;
+    return data;
+}
+
+template<typename Data>
+void runSensorReads(benchmark::State& state) {
+    const auto type = static_cast<hardware::SensorType>(state.range(0));
+    std::array<Data, 16> recent;
+    uint64_t tick = 1;
+
+    const uint64_t before = allocationCount();
+    for (auto _ : state) {
+        recent[tick % recent.size()] = readSensor<Data>(type, tick);
+        ++tick;
+    }
+    benchmark::DoNotOptimize(recent.data());
+    state.counters["allocs_per_read"] = benchmark::Counter(
+        static_cast<double>(allocationCount() - before) / state.iterations());
+}
+
+} // namespace
+
+// Arg: sensor type (0 = accelerometer, 3 axes; 3 = temperature, 1 value)
+static void BM_SensorRead_HeapVector(benchmark::State& state) {
+    runSensorReads<HeapSensorData>(state);
+}
+BENCHMARK(BM_SensorRead_HeapVector)->Arg(0)->Arg(3);
+
+static void BM_SensorRead_SmallVector(benchmark::State& state) {
+    runSensorReads<hardware::SensorData>(state);
+}
+BENCHMARK(BM_SensorRead_SmallVector)->Arg(0)->Arg(3);
+
+// Full parse of typical interactive commands into ParsedCommand
+static void BM_ParseCommand(benchmark::State& state) {
+    static const char* const commands[] = {
+        "ls -la /tmp",
+        "git status",
+        "grep -n --color=never main src/app.cpp",
+        "cd \"$HOME/projects\"",
+    };
+    const std::string command = commands[state.range(0)];
+    core::Environment env;
+    env.set("HOME", "/home/user");
+    core::CommandParser parser;
+
+    const uint64_t before = allocationCount();
+    for (auto _ : state) {
+        auto parsed = parser.parse(command, env);
+        if (!parsed.isValid()) {
+            // A rejected command would time the error path instead
+            state.SkipWithError("command rejected by the parser");
+            break;
+        }
+        benchmark::DoNotOptimize(parsed.executable.data());
+    }
+    state.SetLabel(command);
+    state.counters["allocs_per_parse"] = benchmark::Counter(
+        static_cast<double>(allocationCount() - before) / state.iterations());
+}
+BENCHMARK(BM_ParseCommand)->DenseRange(0, 3);
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include "hardware/thermal_telemetry.h"
+#include "fake_sysfs.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int ZONE_COUNT = 24;   // Typical for a recent phone SoC
+constexpr int CPU_COUNT = 8;
+
+// Two clusters of four cores, as on most big.LITTLE parts
+void populate(FakeSysfs& sysfs) {
+    for (int i = 0; i < ZONE_COUNT; ++i) {
+        const std::string dir = "sys/class/thermal/thermal_zone" + std::to_string(i);
+        sysfs.write(dir + "/type", "zone" + std::to_string(i));
+        sysfs.write(dir + "/temp", std::to_string(40000 + i * 500));
+    }
+    for (const char* policy : {"policy0", "policy4"}) {
+        const std::string dir = std::string("sys/devices/system/cpu/cpufreq/") + policy;
+        sysfs.write(dir + "/scaling_cur_freq", "1804800");
+        sysfs.write(dir + "/scaling_min_freq", "300000");
+        sysfs.write(dir + "/scaling_max_freq", "1804800");
+        sysfs.write(dir + "/cpuinfo_max_freq", "2841600");
+        sysfs.write(dir + "/scaling_governor", "schedutil");
+    }
+    for (int cpu = 0; cpu < CPU_COUNT; ++cpu) {
+        const std::string dir = "sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        sysfs.link(dir + "/cpufreq", cpu < 4 ? "sys/devices/system/cpu/cpufreq/policy0"
+                                             : "sys/devices/system/cpu/cpufreq/policy4");
+        if (cpu > 0) {
+            sysfs.write(dir + "/online", "1");
+        }
+    }
+}
+
+int readInt(const std::string& path) {
+    std::ifstream file(path);
+    int value = 0;
+    file >> value;
+    return value;
+}
+
+} // namespace
+
+// The same data gathered the way readTemperature() read its one zone:
+// an ifstream per attribute, per core
+static void BM_TelemetryReopenPerRead(benchmark::State& state) {
+    FakeSysfs sysfs;
+    populate(sysfs);
+    const std::string thermal = sysfs.path("sys/class/thermal/thermal_zone");
+    const std::string cpus = sysfs.path("sys/devices/system/cpu/cpu");
+    for (auto _ : state) {
+        int sum = 0;
+        for (int i = 0; i < ZONE_COUNT; ++i) {
+            sum += readInt(thermal + std::to_string(i) + "/temp");
+        }
+        for (int cpu = 0; cpu < CPU_COUNT; ++cpu) {
+            const std::string dir = cpus + std::to_string(cpu) + "/cpufreq/";
+            sum += readInt(dir + "scaling_cur_freq");
+            sum += readInt(dir + "scaling_min_freq");
+            sum += readInt(dir + "scaling_max_freq");
+            std::ifstream governor(dir + "scaling_governor");
+            std::string name;
+            governor >> name;
+            sum += static_cast<int>(name.size());
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(BM_TelemetryReopenPerRead);
+
+static void BM_TelemetryHeldDescriptors(benchmark::State& state) {
+    FakeSysfs sysfs;
+    populate(sysfs);
+    ThermalTelemetry telemetry(sysfs.path("sys"));
+    telemetry.open();
+    ThermalSample sample;
+    for (auto _ : state) {
+        telemetry.sample(sample);
+        benchmark::DoNotOptimize(sample.maxTemperature);
+    }
+    state.counters["preads_per_sample"] = benchmark::Counter(
+        static_cast<double>(telemetry.getReadCount()) / static_cast<double>(state.iterations()));
+}
+BENCHMARK(BM_TelemetryHeldDescriptors);
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include "hardware/tone_synth.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+ToneSegment beep(uint32_t durationMs) {
+    ToneSegment tone;
+    tone.frequency = 880.0f;
+    tone.durationMs = durationMs;
+    return tone;
+}
+
+} // namespace
+
+// Per-sample std::sin with a per-sample envelope branch, for comparison
+static void BM_ToneScalarSin(benchmark::State& state) {
+    const size_t frames = static_cast<size_t>(state.range(0)) * 48;
+    const size_t ramp = 192;
+    std::vector<int16_t> samples(frames);
+    for (auto _ : state) {
+        for (size_t i = 0; i < frames; ++i) {
+            float envelope = 1.0f;
+            if (i < ramp) {
+                envelope = static_cast<float>(i + 1) / ramp;
+            } else if (frames - i < ramp) {
+                envelope = static_cast<float>(frames - i) / ramp;
+            }
+            samples[i] = static_cast<int16_t>(
+                std::sin(2.0 * M_PI * 880.0 * static_cast<double>(i) / 48000.0) * envelope * 16383.0f);
+        }
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * frames));
+}
+BENCHMARK(BM_ToneScalarSin)->Arg(200)->Unit(benchmark::kMicrosecond);
+
+static void BM_ToneRender(benchmark::State& state) {
+    ToneSynthesizer synth(48000);
+    const std::vector<ToneSegment> segments = {beep(static_cast<uint32_t>(state.range(0)))};
+    std::vector<int16_t> samples;
+    for (auto _ : state) {
+        samples.clear();
+        synth.render(segments, samples);
+        benchmark::DoNotOptimize(samples.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * samples.size()));
+}
+BENCHMARK(BM_ToneRender)->Arg(200)->Unit(benchmark::kMicrosecond);
+
+// What play() costs the caller: validation and a queue push
+static void BM_TonePlayerEnqueue(benchmark::State& state) {
+    TonePlayer player{std::unique_ptr<PcmSink>(new NullPcmSink())};
+    const ToneSegment tone = beep(200);
+    for (auto _ : state) {
+        if (!player.play({tone})) {
+            state.PauseTiming();
+            player.wait();
+            state.ResumeTiming();
+        }
+    }
+    player.wait();
+}
+BENCHMARK(BM_TonePlayerEnqueue)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,153 @@
+#include <benchmark/benchmark.h>
+#include "core/implementations/tree_search.h"
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace cross_terminal::core;
+
+namespace {
+
+constexpr int TOP_DIRECTORIES = 20;
+constexpr int SUBDIRECTORIES = 10;
+constexpr int FILES_PER_DIRECTORY = 25;
+constexpr int TREE_ENTRIES = TOP_DIRECTORIES * (1 + SUBDIRECTORIES * (1 + FILES_PER_DIRECTORY));
+
+// A tree of empty files under CT_BENCH_DIR (/tmp by default), shared by
+// every benchmark in this file
+class SearchTree {
+public:
+    static const SearchTree& instance() {
+        static SearchTree tree;
+        return tree;
+    }
+    ~SearchTree() {
+        if (!root_.empty()) {
+            benchmark::DoNotOptimize(system(("rm -rf '" + root_ + "'").c_str()));
+        }
+    }
+    bool valid() const { return !root_.empty(); }
+    const std::string& root() const { return root_; }
+private:
+    std::string root_;
+
+    SearchTree() {
+        const char* base = getenv("CT_BENCH_DIR");
+        std::string pattern = std::string(base ? base : "/tmp") + "/ct_search_XXXXXX";
+        if (!mkdtemp(&pattern[0])) {
+            return;
+        }
+        root_ = pattern;
+        for (int t = 0; t < TOP_DIRECTORIES; ++t) {
+            const std::string top = root_ + "/t" + std::to_string(t);
+            mkdir(top.c_str(), 0755);
+            for (int s = 0; s < SUBDIRECTORIES; ++s) {
+                const std::string sub = top + "/s" + std::to_string(s);
+                mkdir(sub.c_str(), 0755);
+                for (int f = 0; f < FILES_PER_DIRECTORY; ++f) {
+                    const std::string file = sub + "/file" + std::to_string(f) + (f % 5 == 0 ? ".log" : ".txt");
+                    int fd = open(file.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+                    if (fd >= 0) {
+                        close(fd);
+                    }
+                }
+            }
+        }
+    }
+};
+
+} // namespace
+
+// find -name '*.log' on 1 to 8 workers: getdents64 only, no stat
+static void BM_FindByNameNative(benchmark::State& state) {
+    const auto& tree = SearchTree::instance();
+    if (!tree.valid()) {
+        state.SkipWithError("no scratch directory");
+        return;
+    }
+    FsContext fs(tree.root());
+    TreeSearch search(fs, static_cast<size_t>(state.range(0)));
+    FindOptions options;
+    options.name = "*.log";
+    size_t matches = 0;
+    for (auto _ : state) {
+        search.find({"."}, options, [&matches](const std::vector<std::string>& batch) {
+            matches += batch.size();
+        });
+    }
+    state.SetItemsProcessed(state.iterations() * TREE_ENTRIES);
+    benchmark::DoNotOptimize(matches);
+}
+BENCHMARK(BM_FindByNameNative)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// -size needs a statx() per entry
+static void BM_FindBySizeNative(benchmark::State& state) {
+    const auto& tree = SearchTree::instance();
+    if (!tree.valid()) {
+        state.SkipWithError("no scratch directory");
+        return;
+    }
+    FsContext fs(tree.root());
+    TreeSearch search(fs, static_cast<size_t>(state.range(0)));
+    FindOptions options;
+    options.size_compare = FindOptions::Compare::Greater;
+    options.size = 0;
+    for (auto _ : state) {
+        search.find({"."}, options, nullptr);
+    }
+    state.SetItemsProcessed(state.iterations() * TREE_ENTRIES);
+}
+BENCHMARK(BM_FindBySizeNative)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// What the shell did before: spawn the system find
+static void BM_FindByNameExternal(benchmark::State& state) {
+    const auto& tree = SearchTree::instance();
+    if (!tree.valid()) {
+        state.SkipWithError("no scratch directory");
+        return;
+    }
+    const std::string command = "find '" + tree.root() + "' -name '*.log' > /dev/null";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(system(command.c_str()));
+    }
+    state.SetItemsProcessed(state.iterations() * TREE_ENTRIES);
+}
+BENCHMARK(BM_FindByNameExternal)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_DiskUsageNative(benchmark::State& state) {
+    const auto& tree = SearchTree::instance();
+    if (!tree.valid()) {
+        state.SkipWithError("no scratch directory");
+        return;
+    }
+    FsContext fs(tree.root());
+    TreeSearch search(fs, static_cast<size_t>(state.range(0)));
+    DiskUsageOptions options;
+    options.max_depth = 0;
+    uint64_t total = 0;
+    for (auto _ : state) {
+        search.diskUsage({"."}, options, [&total](const std::vector<DiskUsageEntry>& batch) {
+            total = batch.back().bytes;
+        });
+    }
+    state.SetItemsProcessed(state.iterations() * TREE_ENTRIES);
+    benchmark::DoNotOptimize(total);
+}
+BENCHMARK(BM_DiskUsageNative)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_DiskUsageExternal(benchmark::State& state) {
+    const auto& tree = SearchTree::instance();
+    if (!tree.valid()) {
+        state.SkipWithError("no scratch directory");
+        return;
+    }
+    const std::string command = "du -s '" + tree.root() + "' > /dev/null";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(system(command.c_str()));
+    }
+    state.SetItemsProcessed(state.iterations() * TREE_ENTRIES);
+}
+BENCHMARK(BM_DiskUsageExternal)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "core/session_manager.h"
+#include "core/implementations/async_shell.h"
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if !defined(__cpp_impl_coroutine)
+#error "The C++20 tests need a compiler with coroutine support"
+#endif
+
+using namespace cross_terminal::core;
+
+class AsyncShellTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SessionManagerConfig config;
+        config.reactor_threads = 1;
+        config.worker_threads = 1;
+        manager = std::make_unique<SessionManager>(config);
+        ASSERT_TRUE(manager->initialize());
+        shell = manager->getSession(manager->createSession());
+        ASSERT_NE(shell, nullptr);
+        async = std::make_unique<AsyncShell>(*shell, manager->getReactor());
+    }
+
+    void TearDown() override {
+        async.reset();
+        shell.reset();
+        manager->shutdown();
+        manager.reset();
+    }
+
+    std::unique_ptr<SessionManager> manager;
+    std::shared_ptr<IShell> shell;
+    std::unique_ptr<AsyncShell> async;
+};
+
+TEST_F(AsyncShellTest, RunSequencesCommands) {
+    auto script = [this]() -> Task<std::string> {
+        auto first = co_await async->run("echo one");
+        if (!first.succeeded()) {
+            co_return "failed";
+        }
+        auto second = co_await async->run("echo two");
+        co_return first.output + second.output;
+    };
+
+    EXPECT_EQ(syncWait(script()), "one\ntwo\n");
+}
+
+TEST_F(AsyncShellTest, RunReportsFailureAndRejection) {
+    auto script = [this]() -> Task<std::vector<CommandResult>> {
+        std::vector<CommandResult> results;
+        results.push_back(co_await async->run("false"));
+        results.push_back(co_await async->run("echo |"));
+        co_return results;
+    };
+
+    auto results = syncWait(script());
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_TRUE(results[0].started);
+    EXPECT_FALSE(results[0].succeeded());
+    EXPECT_NE(results[0].info.exit_code, 0);
+    EXPECT_FALSE(results[1].started);
+}
+
+TEST_F(AsyncShellTest, LinesStreamsOutputThenExitStatus) {
+    auto script = [this]() -> Task<std::vector<std::string>> {
+        std::vector<std::string> lines;
+        auto stream = async->lines("seq 1 100");
+        while (auto line = co_await stream.next()) {
+            lines.push_back(*line);
+        }
+        EXPECT_TRUE(stream.result().succeeded());
+        co_return lines;
+    };
+
+    auto lines = syncWait(script());
+    ASSERT_EQ(lines.size(), 100u);
+    EXPECT_EQ(lines.front(), "1");
+    EXPECT_EQ(lines.back(), "100");
+}
+
+TEST_F(AsyncShellTest, SleepResumesOnTheReactor) {
+    const auto caller = std::this_thread::get_id();
+    auto script = [this]() -> Task<std::thread::id> {
+        co_await async->sleep(50);
+        co_return std::this_thread::get_id();
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto resumed_on = syncWait(script());
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+    EXPECT_NE(resumed_on, caller);
+}
+
+TEST_F(AsyncShellTest, TimeoutKillsTheCommand) {
+    auto script = [this]() -> Task<CommandResult> {
+        co_return co_await async->run("sleep 10", ExecutionOptions(), 100);
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    auto result = syncWait(script());
+    EXPECT_TRUE(result.timed_out);
+    EXPECT_FALSE(result.succeeded());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST_F(AsyncShellTest, LineStreamTimeoutEndsTheStream) {
+    auto script = [this]() -> Task<CommandResult> {
+        auto stream = async->lines("sleep 10", ExecutionOptions(), 100);
+        while (co_await stream.next()) {
+        }
+        co_return stream.result();
+    };
+
+    EXPECT_TRUE(syncWait(script()).timed_out);
+}
+
+TEST_F(AsyncShellTest, ExceptionsReachTheAwaiter) {
+    auto inner = [this]() -> Task<int> {
+        co_await async->sleep(1);
+        throw std::runtime_error("inner");
+    };
+    auto outer = [&inner]() -> Task<std::string> {
+        try {
+            co_await inner();
+        } catch (const std::runtime_error& error) {
+            co_return error.what();
+        }
+        co_return "no exception";
+    };
+
+    EXPECT_EQ(syncWait(outer()), "inner");
+    EXPECT_THROW(syncWait(inner()), std::runtime_error);
+}
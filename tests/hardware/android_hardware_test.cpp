@@ -134,6 +134,26 @@ TEST_F(AndroidHardwareTest, NetworkControl) {
     EXPECT_TRUE(true);
 }
 
+TEST_F(AndroidHardwareTest, BusAccess) {
+    // Invalid numbers never reach the device nodes
+    EXPECT_EQ(hardware->openI2CBus(-1), nullptr);
+    EXPECT_EQ(hardware->openSPIDevice(0, -1), nullptr);
+    
+    // Adapters need the device and permissions; whichever opens is shared
+    for (int bus = 0; bus < 8; ++bus) {
+        auto i2c = hardware->openI2CBus(bus);
+        if (i2c) {
+            EXPECT_EQ(hardware->openI2CBus(bus), i2c);
+            EXPECT_GT(i2c->maxMessagesPerTransfer(), 0u);
+        }
+        auto spi = hardware->openSPIDevice(bus, 0);
+        if (spi) {
+            EXPECT_EQ(hardware->openSPIDevice(bus, 0), spi);
+            EXPECT_GT(spi->maxBytesPerMessage(), 0u);
+        }
+    }
+}
+
 TEST_F(AndroidHardwareTest, EdgeCases) {
     // Test invalid brightness values
     EXPECT_FALSE(hardware->setScreenBrightness(-0.1f));
@@ -0,0 +1,155 @@
+#include "fake_hardware_bus.h"
+
+using cross_terminal::hardware::I2CMessage;
+using cross_terminal::hardware::SPIConfig;
+using cross_terminal::hardware::SPITransfer;
+
+FakeI2CBus::FakeI2CBus(uint32_t clock_hz, uint64_t transfer_overhead_ns)
+    : clock_hz_(clock_hz), transfer_overhead_ns_(transfer_overhead_ns) {
+}
+
+void FakeI2CBus::addDevice(uint16_t address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    devices_[address];
+}
+
+uint8_t FakeI2CBus::peek(uint16_t address, uint8_t reg) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = devices_.find(address);
+    return it == devices_.end() ? 0 : it->second.registers[reg];
+}
+
+void FakeI2CBus::poke(uint16_t address, uint8_t reg, uint8_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    devices_[address].registers[reg] = value;
+}
+
+FakeI2CBus::Stats FakeI2CBus::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::vector<size_t> FakeI2CBus::transferSizes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return transfer_sizes_;
+}
+
+bool FakeI2CBus::transfer(I2CMessage* messages, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count == 0 || count > max_messages_) {
+        return false;
+    }
+    ++stats_.transfers;
+    stats_.messages += count;
+    transfer_sizes_.push_back(count);
+
+    // (Repeated) start + address byte per message, 9 clocks per byte, stop
+    uint64_t clocks = 1;
+    bool ok = true;
+    for (size_t i = 0; i < count && ok; ++i) {
+        I2CMessage& message = messages[i];
+        clocks += 1 + 9;
+        auto device = devices_.find(message.address);
+        if (device == devices_.end()) {
+            ++stats_.nacks;
+            ok = false;   // Address NACK aborts the transaction
+            break;
+        }
+        Device& target = device->second;
+        for (uint16_t b = 0; b < message.length; ++b) {
+            if (message.read) {
+                message.data[b] = target.registers[target.pointer++];
+            } else if (b == 0) {
+                target.pointer = message.data[0];
+            } else {
+                target.registers[target.pointer++] = message.data[b];
+            }
+        }
+        clocks += 9ull * message.length;
+        stats_.bytes += message.length;
+    }
+    stats_.bus_time_ns += transfer_overhead_ns_ + clocks * 1000000000ull / clock_hz_;
+    return ok;
+}
+
+FakeSPIDevice::FakeSPIDevice(uint64_t message_overhead_ns, size_t max_transfers, size_t max_bytes)
+    : message_overhead_ns_(message_overhead_ns)
+    , max_transfers_(max_transfers)
+    , max_bytes_(max_bytes) {
+}
+
+uint8_t FakeSPIDevice::peek(uint8_t reg) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return registers_[reg & 0x7f];
+}
+
+void FakeSPIDevice::poke(uint8_t reg, uint8_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    registers_[reg & 0x7f] = value;
+}
+
+FakeSPIDevice::Stats FakeSPIDevice::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool FakeSPIDevice::configure(const SPIConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    return true;
+}
+
+bool FakeSPIDevice::transfer(const SPITransfer* transfers, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += transfers[i].length;
+    }
+    if (count == 0 || count > max_transfers_ || total > max_bytes_) {
+        return false;
+    }
+    ++stats_.messages;
+    stats_.transfers += count;
+    stats_.bytes += total;
+    if (transfers[count - 1].cs_change) {
+        ++stats_.cs_left_asserted;
+    }
+
+    // Frame state: position within the current chip select assertion
+    bool selected = false;
+    bool reading = false;
+    uint8_t reg = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const SPITransfer& t = transfers[i];
+        if (!selected) {
+            selected = true;
+            ++stats_.frames;
+            reading = false;
+            reg = 0xff;   // Expecting the command byte
+        }
+        for (uint32_t b = 0; b < t.length; ++b) {
+            uint8_t out = t.tx ? t.tx[b] : 0;
+            uint8_t in = 0;
+            if (reg == 0xff) {
+                reading = (out & READ) != 0;
+                reg = out & 0x7f;
+            } else if (reading) {
+                in = registers_[reg];
+                reg = (reg + 1) & 0x7f;
+            } else {
+                registers_[reg] = out;
+                reg = (reg + 1) & 0x7f;
+            }
+            if (t.rx) {
+                t.rx[b] = in;
+            }
+        }
+        uint32_t speed = t.speed_hz ? t.speed_hz : config_.speed_hz;
+        stats_.bus_time_ns += 8ull * t.length * 1000000000ull / (speed ? speed : 1) + t.delay_us * 1000ull;
+        if (t.cs_change) {
+            selected = false;
+        }
+    }
+    stats_.bus_time_ns += message_overhead_ns_;
+    return true;
+}
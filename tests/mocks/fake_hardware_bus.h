@@ -0,0 +1,91 @@
+#pragma once
+
+#include "core/interfaces/i_hardware_bus.h"
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// In-memory I2C and SPI backends for testing batching without hardware.
+// Devices are 256-byte register files with an auto-incrementing register
+// pointer, the access pattern of most sensors and EEPROMs. Both fakes
+// keep the counters a test needs to check how accesses were packed, and
+// model the bus time each transfer would take on the wire.
+
+class FakeI2CBus : public cross_terminal::hardware::II2CBus {
+public:
+    struct Stats {
+        uint64_t transfers = 0;
+        uint64_t messages = 0;
+        uint64_t bytes = 0;
+        uint64_t nacks = 0;
+        uint64_t bus_time_ns = 0;   // Modelled wire time plus per-transfer overhead
+    };
+
+    explicit FakeI2CBus(uint32_t clock_hz = 400000, uint64_t transfer_overhead_ns = 0);
+
+    // Attach a device; the first written byte of a message sets its
+    // register pointer, further bytes are written from there
+    void addDevice(uint16_t address);
+    uint8_t peek(uint16_t address, uint8_t reg) const;
+    void poke(uint16_t address, uint8_t reg, uint8_t value);
+
+    void setMaxMessages(size_t max_messages) { max_messages_ = max_messages; }
+    Stats stats() const;
+    std::vector<size_t> transferSizes() const;   // Message count of each transfer
+
+    bool transfer(cross_terminal::hardware::I2CMessage* messages, size_t count) override;
+    size_t maxMessagesPerTransfer() const noexcept override { return max_messages_; }
+
+private:
+    struct Device {
+        std::array<uint8_t, 256> registers{};
+        uint8_t pointer = 0;
+    };
+
+    const uint32_t clock_hz_;
+    const uint64_t transfer_overhead_ns_;
+    size_t max_messages_ = 42;
+    mutable std::mutex mutex_;
+    std::map<uint16_t, Device> devices_;
+    std::vector<size_t> transfer_sizes_;
+    Stats stats_;
+};
+
+class FakeSPIDevice : public cross_terminal::hardware::ISPIDevice {
+public:
+    struct Stats {
+        uint64_t messages = 0;
+        uint64_t transfers = 0;
+        uint64_t frames = 0;         // Chip select assertions
+        uint64_t bytes = 0;
+        uint64_t cs_left_asserted = 0;   // Messages ending with cs_change set
+        uint64_t bus_time_ns = 0;
+    };
+
+    // Frames start with a command byte: bit 7 set reads, clear writes, the
+    // low bits select the first register
+    static constexpr uint8_t READ = 0x80;
+
+    explicit FakeSPIDevice(uint64_t message_overhead_ns = 0, size_t max_transfers = 511,
+                           size_t max_bytes = 4096);
+
+    uint8_t peek(uint8_t reg) const;
+    void poke(uint8_t reg, uint8_t value);
+    Stats stats() const;
+
+    bool configure(const cross_terminal::hardware::SPIConfig& config) override;
+    bool transfer(const cross_terminal::hardware::SPITransfer* transfers, size_t count) override;
+    size_t maxTransfersPerMessage() const noexcept override { return max_transfers_; }
+    size_t maxBytesPerMessage() const noexcept override { return max_bytes_; }
+
+private:
+    const uint64_t message_overhead_ns_;
+    const size_t max_transfers_;
+    const size_t max_bytes_;
+    mutable std::mutex mutex_;
+    std::array<uint8_t, 128> registers_{};
+    cross_terminal::hardware::SPIConfig config_;
+    Stats stats_;
+};
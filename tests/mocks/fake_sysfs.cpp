@@ -0,0 +1,43 @@
+#include "fake_sysfs.h"
+#include <cstdlib>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+FakeSysfs::FakeSysfs() {
+    char root[] = "/tmp/ct_sysfsXXXXXX";
+    root_ = mkdtemp(root);
+}
+
+FakeSysfs::~FakeSysfs() {
+    std::system(("rm -rf '" + root_ + "'").c_str());
+}
+
+void FakeSysfs::write(const std::string& relative, const std::string& value) {
+    size_t slash = relative.rfind('/');
+    if (slash != std::string::npos) {
+        makeDirectory(relative.substr(0, slash));
+    }
+    std::ofstream(path(relative), std::ios::trunc) << value << "\n";
+}
+
+void FakeSysfs::makeDirectory(const std::string& relative) {
+    for (size_t slash = relative.find('/'); ; slash = relative.find('/', slash + 1)) {
+        mkdir(path(relative.substr(0, slash)).c_str(), 0755);
+        if (slash == std::string::npos) {
+            break;
+        }
+    }
+}
+
+void FakeSysfs::link(const std::string& relative, const std::string& target) {
+    size_t slash = relative.rfind('/');
+    if (slash != std::string::npos) {
+        makeDirectory(relative.substr(0, slash));
+    }
+    symlink(path(target).c_str(), path(relative).c_str());
+}
+
+void FakeSysfs::remove(const std::string& relative) {
+    std::system(("rm -rf '" + path(relative) + "'").c_str());
+}
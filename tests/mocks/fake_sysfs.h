@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+// Scratch directory standing in for /sys (or /proc) in tests. Attributes
+// are regular files, so code reading them with open/pread behaves as on a
+// real tree; the directory is removed on destruction.
+
+class FakeSysfs {
+public:
+    FakeSysfs();
+    ~FakeSysfs();
+
+    FakeSysfs(const FakeSysfs&) = delete;
+    FakeSysfs& operator=(const FakeSysfs&) = delete;
+
+    const std::string& root() const { return root_; }
+    std::string path(const std::string& relative) const { return root_ + "/" + relative; }
+
+    // Write an attribute, creating parent directories; a newline is appended
+    void write(const std::string& relative, const std::string& value);
+    void makeDirectory(const std::string& relative);
+    // Symlink relative -> target (both relative to the root), as sysfs
+    // links cpuN/cpufreq to its policy
+    void link(const std::string& relative, const std::string& target);
+    // Remove a file or directory tree
+    void remove(const std::string& relative);
+
+private:
+    std::string root_;
+};
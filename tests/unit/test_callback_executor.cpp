@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include "core/implementations/callback_executor.h"
+#include "core/session_manager.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace cross_terminal::core;
+
+namespace {
+
+template<typename Predicate>
+bool waitFor(Predicate predicate, int timeout_ms = 5000) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (predicate()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return predicate();
+}
+
+} // namespace
+
+class CallbackExecutorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        workers = std::make_shared<WorkerPool>(1);
+        ASSERT_TRUE(workers->start());
+    }
+
+    void TearDown() override {
+        workers->stop();
+    }
+
+    std::shared_ptr<WorkerPool> workers;
+};
+
+TEST_F(CallbackExecutorTest, CoalescesChunksWhileConsumerIsBusy) {
+    auto executor = std::make_shared<CallbackExecutor>(workers);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<bool> entered{false};
+    std::vector<std::string> received;
+
+    auto channel = std::make_shared<CallbackExecutor::Channel>();
+    channel->output = [&](const std::string& data, bool) {
+        received.push_back(data);
+        entered.store(true);
+        released.wait();
+    };
+
+    executor->postOutput(channel, "a", 1, false);
+    ASSERT_TRUE(waitFor([&]() { return entered.load(); }));
+    for (const char* chunk : {"b", "c", "d"}) {
+        EXPECT_TRUE(executor->postOutput(channel, chunk, 1, false));
+    }
+    executor->postOutput(channel, "e", 1, true);   // Other stream: not merged
+    release.set_value();
+    executor->drain();
+
+    EXPECT_EQ(received, (std::vector<std::string>{"a", "bcd", "e"}));
+    auto metrics = executor->getMetrics();
+    EXPECT_EQ(metrics.chunks, 5u);
+    EXPECT_EQ(metrics.invocations, 3u);
+    EXPECT_EQ(metrics.bytes, 5u);
+    EXPECT_EQ(executor->pendingBytes(), 0u);
+}
+
+TEST_F(CallbackExecutorTest, CompletionRunsAfterOutput) {
+    auto executor = std::make_shared<CallbackExecutor>(workers);
+    std::string order;
+
+    auto channel = std::make_shared<CallbackExecutor::Channel>();
+    channel->output = [&](const std::string& data, bool) { order += data; };
+    channel->completion = [&](const ProcessInfo& info) { order += std::to_string(info.exit_code); };
+
+    ProcessInfo info;
+    info.exit_code = 7;
+    executor->postOutput(channel, "xy", 2, false);
+    executor->postCompletion(channel, info);
+    executor->drain();
+
+    EXPECT_EQ(order, "xy7");
+    EXPECT_EQ(executor->getMetrics().completions, 1u);
+}
+
+TEST_F(CallbackExecutorTest, ByteLimitPausesProducerUntilDrained) {
+    auto executor = std::make_shared<CallbackExecutor>(workers, 8);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> resumed{0};
+
+    auto channel = std::make_shared<CallbackExecutor::Channel>();
+    channel->output = [&](const std::string&, bool) { released.wait(); };
+    channel->resume = [&]() { resumed.fetch_add(1); };
+
+    EXPECT_TRUE(executor->postOutput(channel, "12345678", 8, false));
+    EXPECT_FALSE(executor->postOutput(channel, "9", 1, false));
+    executor->awaitDrain(channel);
+    EXPECT_EQ(resumed.load(), 0);
+
+    release.set_value();
+    executor->drain();
+    EXPECT_EQ(resumed.load(), 1);
+    EXPECT_EQ(executor->getMetrics().pauses, 1u);
+}
+
+TEST(CallbackExecutorSessionTest, SlowCallbackDoesNotStallReading) {
+    SessionManagerConfig config;
+    config.reactor_threads = 1;
+    config.worker_threads = 1;
+    SessionManager manager(config);
+    ASSERT_TRUE(manager.initialize());
+    auto id = manager.createSession();
+    auto shell = manager.getSession(id);
+
+    constexpr size_t TOTAL = 256 * 1024;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<size_t> delivered{0};
+    std::atomic<bool> completed{false};
+
+    int pid = shell->executeAsync("head -c " + std::to_string(TOTAL) + " /dev/zero",
+        ExecutionOptions(),
+        [&](const std::string& data, bool) {
+            released.wait();
+            delivered.fetch_add(data.size());
+        },
+        [&](const ProcessInfo&) { completed.store(true); });
+    ASSERT_GT(pid, 0);
+
+    // The reactor keeps reading while the first callback is blocked
+    EXPECT_TRUE(waitFor([&]() { return manager.getSessionMetrics(id).bytes_read == TOTAL; }));
+    EXPECT_EQ(delivered.load(), 0u);
+
+    release.set_value();
+    EXPECT_TRUE(waitFor([&]() { return completed.load(); }));
+    EXPECT_EQ(delivered.load(), TOTAL);
+
+    auto metrics = manager.getSessionMetrics(id).callbacks;
+    EXPECT_EQ(metrics.bytes, TOTAL);
+    EXPECT_LT(metrics.invocations, metrics.chunks);
+    EXPECT_EQ(metrics.completions, 1u);
+
+    shell.reset();
+    manager.shutdown();
+}
+
+TEST(CallbackExecutorSessionTest, BacklogBeyondLimitPausesThePipe) {
+    SessionManagerConfig config;
+    config.reactor_threads = 1;
+    config.worker_threads = 1;
+    SessionManager manager(config);
+    ASSERT_TRUE(manager.initialize());
+    auto id = manager.createSession();
+    auto shell = manager.getSession(id);
+
+    constexpr size_t TOTAL = 2 * CallbackExecutor::DEFAULT_MAX_PENDING_BYTES;
+    std::atomic<size_t> delivered{0};
+    std::atomic<bool> completed{false};
+    // The consumer is held until the reactor has paused the pipe, so the
+    // backlog reaches the limit however fast either side runs
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+
+    int pid = shell->executeAsync("head -c " + std::to_string(TOTAL) + " /dev/zero",
+        ExecutionOptions(),
+        [&, released](const std::string& data, bool) {
+            released.wait();
+            delivered.fetch_add(data.size());
+        },
+        [&](const ProcessInfo&) { completed.store(true); });
+    ASSERT_GT(pid, 0);
+
+    const bool paused = waitFor([&]() { return manager.getSessionMetrics(id).callbacks.pauses > 0; }, 20000);
+    release.set_value();
+    EXPECT_TRUE(paused);
+    EXPECT_TRUE(waitFor([&]() { return completed.load(); }, 20000));
+    EXPECT_EQ(delivered.load(), TOTAL);
+
+    auto metrics = manager.getSessionMetrics(id).callbacks;
+    EXPECT_GT(metrics.pauses, 0u);
+    // One read quantum may land on top of the limit before the pipe pauses
+    EXPECT_LE(metrics.peak_pending_bytes,
+              CallbackExecutor::DEFAULT_MAX_PENDING_BYTES + SessionIoContext::FOREGROUND_QUANTUM);
+
+    shell.reset();
+    manager.shutdown();
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "core/session_manager.h"
+#include "core/implementations/command_operation.h"
+#include <chrono>
+#include <future>
+#include <vector>
+
+using namespace cross_terminal::core;
+
+class CommandOperationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SessionManagerConfig config;
+        config.reactor_threads = 1;
+        config.worker_threads = 1;
+        manager = std::make_unique<SessionManager>(config);
+        ASSERT_TRUE(manager->initialize());
+        shell = manager->getSession(manager->createSession());
+        ASSERT_NE(shell, nullptr);
+    }
+
+    void TearDown() override {
+        shell.reset();
+        manager->shutdown();
+        manager.reset();
+    }
+
+    // Blocks until the operation resumes its waiter, then returns the result
+    static CommandResult await(const std::shared_ptr<CommandOperation>& operation) {
+        std::promise<void> resumed;
+        auto future = resumed.get_future();
+        operation->onComplete([&resumed]() { resumed.set_value(); });
+        EXPECT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        return operation->takeResult();
+    }
+
+    std::unique_ptr<SessionManager> manager;
+    std::shared_ptr<IShell> shell;
+};
+
+TEST_F(CommandOperationTest, CollectsOutputAndExitStatus) {
+    auto operation = CommandOperation::start(*shell, manager->getReactor(), "echo operation");
+    auto result = await(operation);
+
+    EXPECT_TRUE(result.succeeded());
+    EXPECT_EQ(result.output, "operation\n");
+    EXPECT_FALSE(result.timed_out);
+}
+
+TEST_F(CommandOperationTest, RejectedCommandIsDoneImmediately) {
+    auto operation = CommandOperation::start(*shell, manager->getReactor(), "echo |");
+
+    EXPECT_TRUE(operation->isDone());
+    EXPECT_EQ(operation->pid(), -1);
+    auto result = await(operation);
+    EXPECT_FALSE(result.started);
+    EXPECT_FALSE(result.succeeded());
+}
+
+TEST_F(CommandOperationTest, TimeoutKillsProcess) {
+    auto start = std::chrono::steady_clock::now();
+    auto operation = CommandOperation::start(*shell, manager->getReactor(), "sleep 10",
+                                             ExecutionOptions(), 100);
+    auto result = await(operation);
+
+    EXPECT_TRUE(result.timed_out);
+    EXPECT_FALSE(result.succeeded());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST_F(CommandOperationTest, LineModeSplitsOutput) {
+    auto operation = CommandOperation::start(*shell, manager->getReactor(), "seq 1 3",
+                                             ExecutionOptions(), 0,
+                                             CommandOperation::OutputMode::Lines);
+    auto result = await(operation);
+    EXPECT_TRUE(result.succeeded());
+    EXPECT_TRUE(result.output.empty());
+
+    std::vector<std::string> lines;
+    std::string line;
+    while (operation->takeLine(line)) {
+        lines.push_back(line);
+    }
+    EXPECT_EQ(lines, (std::vector<std::string>{"1", "2", "3"}));
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include "core/implementations/shell_impl.h"
+
+using namespace cross_terminal::core;
+
+class CommandParserTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        env.set("HOME", "/home/user");
+        env.set("GREETING", "it's \"here\"");
+    }
+
+    Environment env;
+    CommandParser parser;
+};
+
+TEST_F(CommandParserTest, SplitsExecutableAndArguments) {
+    auto parsed = parser.parse("  ls -la   /tmp ", env);
+    EXPECT_EQ(parsed.executable, "ls");
+    EXPECT_EQ(parsed.arguments, (ArgumentList{"-la", "/tmp"}));
+    EXPECT_TRUE(parsed.arguments.is_inline());
+}
+
+TEST_F(CommandParserTest, HandlesQuotesEscapesAndVariables) {
+    auto parsed = parser.parse(R"(echo "$HOME/docs" '$HOME' a\ b ${HOME}x $GREETING)", env);
+    EXPECT_EQ(parsed.executable, "echo");
+    EXPECT_EQ(parsed.arguments,
+              (ArgumentList{"/home/user/docs", "$HOME", "a b", "/home/userx", "it's \"here\""}));
+}
+
+TEST_F(CommandParserTest, RejectsUnsupportedSyntax) {
+    EXPECT_FALSE(parser.parse("ls | wc -l", env).isValid());
+    EXPECT_FALSE(parser.parse("make && make install", env).isValid());
+    EXPECT_FALSE(parser.parse("sort < in.txt", env).isValid());
+    EXPECT_FALSE(parser.parse("ls >> out.txt", env).isValid());
+    EXPECT_FALSE(parser.parse("sleep 10 &", env).isValid());
+    EXPECT_FALSE(parser.parse("cat >", env).isValid());
+    EXPECT_FALSE(parser.parse("", env).isValid());
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "hardware/device_capabilities.h"
+#include "hardware/uevent_monitor.h"
+#include "fake_sysfs.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string datagram(const std::vector<std::string>& fields) {
+    std::string data;
+    for (const auto& field : fields) {
+        data += field;
+        data.push_back('\0');
+    }
+    return data;
+}
+
+UeventMessage event(const std::string& action, const std::string& subsystem, const std::string& devpath) {
+    UeventMessage message;
+    message.action = action;
+    message.subsystem = subsystem;
+    message.devpath = devpath;
+    return message;
+}
+
+} // namespace
+
+class DeviceCapabilitiesTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sysfs.write("sys/class/thermal/thermal_zone10/type", "gpu-therm");
+        sysfs.write("sys/class/thermal/thermal_zone2/type", "cpu-0-0");
+        sysfs.makeDirectory("sys/class/thermal/cooling_device0");
+        sysfs.write("sys/class/power_supply/battery/type", "Battery");
+        sysfs.write("sys/class/power_supply/battery/temp", "312");
+        sysfs.write("sys/class/power_supply/usb/type", "USB");
+        sysfs.write("sys/bus/iio/devices/iio:device0/in_accel_x_raw", "12");
+        sysfs.write("sys/bus/iio/devices/iio:device1/in_illuminance_input", "250");
+    }
+
+    FakeSysfs sysfs;
+};
+
+TEST(UeventMessageTest, ParsesKernelDatagrams) {
+    std::string data = datagram({"change@/devices/platform/battery/power_supply/battery",
+                                 "ACTION=change",
+                                 "DEVPATH=/devices/platform/battery/power_supply/battery",
+                                 "SUBSYSTEM=power_supply",
+                                 "POWER_SUPPLY_CAPACITY=87",
+                                 "SEQNUM=4121"});
+    UeventMessage message;
+    ASSERT_TRUE(UeventMessage::parse(data.data(), data.size(), message));
+    EXPECT_EQ(message.action, "change");
+    EXPECT_EQ(message.subsystem, "power_supply");
+    EXPECT_EQ(message.deviceName(), "battery");
+    EXPECT_EQ(message.get("POWER_SUPPLY_CAPACITY"), "87");
+    EXPECT_EQ(message.get("MISSING"), "");
+    EXPECT_FALSE(message.changesTopology());
+
+    std::string udev = datagram({"libudev", "\xfe\xed\xca\xfe"});
+    EXPECT_FALSE(UeventMessage::parse(udev.data(), udev.size(), message));
+    std::string garbage = "no header";
+    EXPECT_FALSE(UeventMessage::parse(garbage.data(), garbage.size(), message));
+}
+
+TEST_F(DeviceCapabilitiesTest, DiscoversTreeOnce) {
+    DeviceCapabilityTable table(sysfs.path("sys"), sysfs.path("proc"));
+    table.refresh();
+    auto scans = table.getScanCount();
+
+    auto caps = table.snapshot();
+    EXPECT_EQ(caps->sensors, (std::vector<SensorType>{SensorType::Accelerometer,
+                                                      SensorType::Temperature,
+                                                      SensorType::Light}));
+    ASSERT_EQ(caps->thermalZones.size(), 2u);
+    EXPECT_EQ(caps->thermalZones[0].index, 2);
+    EXPECT_EQ(caps->thermalZones[0].type, "cpu-0-0");
+    EXPECT_EQ(caps->thermalZones[1].index, 10);
+    ASSERT_EQ(caps->powerSupplies.size(), 2u);
+    EXPECT_EQ(caps->powerSupplies[0].name, "battery");
+    EXPECT_TRUE(caps->powerSupplies[0].hasTemperature);
+    EXPECT_EQ(caps->powerSupplies[1].type, "USB");
+    EXPECT_EQ(caps->generation, 1u);
+
+    // Queries are served from the snapshot
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(table.hasSensor(SensorType::Light));
+        EXPECT_EQ(table.getAvailableSensors().size(), 3u);
+    }
+    EXPECT_EQ(table.getScanCount(), scans);
+
+    // Rescanning an unchanged tree publishes nothing new
+    table.refresh();
+    EXPECT_EQ(table.snapshot(), caps);
+}
+
+TEST_F(DeviceCapabilitiesTest, HotplugRescansAffectedSubsystem) {
+    DeviceCapabilityTable table(sysfs.path("sys"), sysfs.path("proc"));
+    table.refresh();
+    UeventMonitor monitor;   // Events injected with dispatch()
+    table.attach(monitor);
+
+    std::vector<uint64_t> published;
+    table.setChangeCallback([&published](const DeviceCapabilities& caps) {
+        published.push_back(caps.generation);
+    });
+
+    const auto scans = table.getScanCount();
+    sysfs.write("sys/bus/iio/devices/iio:device2/in_pressure_raw", "1013");
+    monitor.dispatch(event("add", "iio", "/devices/i2c-1/1-0077/iio:device2"));
+    EXPECT_EQ(table.getScanCount(), scans + 1);
+    EXPECT_TRUE(table.hasSensor(SensorType::Pressure));
+    EXPECT_EQ(published, (std::vector<uint64_t>{2}));
+
+    // Battery level changes and unrelated subsystems cost nothing
+    monitor.dispatch(event("change", "power_supply", "/devices/platform/battery/power_supply/battery"));
+    monitor.dispatch(event("add", "input", "/devices/virtual/input/input9"));
+    EXPECT_EQ(table.getScanCount(), scans + 1);
+
+    sysfs.remove("sys/class/power_supply/usb");
+    monitor.dispatch(event("remove", "power_supply", "/devices/platform/usb/power_supply/usb"));
+    EXPECT_EQ(table.snapshot()->powerSupplies.size(), 1u);
+    EXPECT_EQ(published, (std::vector<uint64_t>{2, 3}));
+
+    // Lost events: everything is rescanned
+    sysfs.write("sys/class/hwmon/hwmon0/temp1_input", "41000");
+    UeventMessage resync;
+    resync.action = UeventMonitor::RESYNC_ACTION;
+    monitor.dispatch(resync);
+    EXPECT_EQ(table.snapshot()->hwmonTemperatures.size(), 1u);
+    EXPECT_EQ(published.back(), 4u);
+
+    table.detach();
+    sysfs.remove("sys/bus/iio/devices/iio:device2");
+    monitor.dispatch(event("remove", "iio", "/devices/i2c-1/1-0077/iio:device2"));
+    EXPECT_TRUE(table.hasSensor(SensorType::Pressure));   // No longer following
+}
+
+TEST(UeventMonitorTest, StartsAndStopsWhereNetlinkIsAllowed) {
+    UeventMonitor monitor;
+    std::string error;
+    if (monitor.start(&error)) {
+        EXPECT_TRUE(monitor.isRunning());
+        monitor.stop();
+    } else {
+        EXPECT_FALSE(error.empty());
+    }
+    EXPECT_FALSE(monitor.isRunning());
+    monitor.stop();   // Idempotent
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "hardware/device_control_helper.h"
+#include <cerrno>
+#include <chrono>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// A stand-in helper serving requests on a thread of the test process
+class DeviceControlHelperTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        handlers.setWiFi = [this](bool enable) {
+            calls.push_back(enable ? "wifi on" : "wifi off");
+            return 0;
+        };
+        handlers.setVolume = [this](int volume) {
+            calls.push_back("volume " + std::to_string(volume));
+            return volume > 15 ? EINVAL : 0;
+        };
+    }
+
+    void TearDown() override {
+        client.stop();   // The helper sees the socket close and returns
+        if (helper.joinable()) {
+            helper.join();
+        }
+    }
+
+    void startHelper() {
+        int sockets[2];
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets), 0);
+        helper = std::thread([this, fd = sockets[1]] {
+            served = DeviceControlServer::serve(fd, handlers);
+            ::close(fd);
+        });
+        client.attach(sockets[0]);
+    }
+
+    DeviceControlHandlers handlers;
+    std::vector<std::string> calls;   // Written by the helper thread only
+    DeviceControlClient client;
+    std::thread helper;
+    int served = -1;
+};
+
+TEST_F(DeviceControlHelperTest, RoundTripsRequests) {
+    startHelper();
+    EXPECT_EQ(client.call(DeviceControlOp::Ping), 0);
+    EXPECT_EQ(client.call(DeviceControlOp::SetWiFi, 1), 0);
+    EXPECT_EQ(client.call(DeviceControlOp::SetVolume, 7), 0);
+    EXPECT_EQ(client.call(DeviceControlOp::SetVolume, 40), EINVAL);
+    EXPECT_EQ(client.call(DeviceControlOp::Beep, 440, 100), ENOSYS);   // No handler
+
+    client.stop();
+    helper.join();
+    EXPECT_EQ(served, 0);
+    EXPECT_EQ(calls, (std::vector<std::string>{"wifi on", "volume 7", "volume 40"}));
+    EXPECT_EQ(client.call(DeviceControlOp::Ping), ENOTCONN);   // Nothing to relaunch
+}
+
+TEST_F(DeviceControlHelperTest, DiscardsLateAnswers) {
+    handlers.setBluetooth = [](bool) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        return 0;
+    };
+    startHelper();
+    EXPECT_EQ(client.call(DeviceControlOp::SetBluetooth, 1, 0, 20), ETIMEDOUT);
+    // The Bluetooth answer arrives first and is skipped
+    EXPECT_EQ(client.call(DeviceControlOp::SetVolume, 40), EINVAL);
+    EXPECT_TRUE(client.isRunning());
+}
+
+TEST_F(DeviceControlHelperTest, ReportsHelperThatExited) {
+    int sockets[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets), 0);
+    client.attach(sockets[0]);
+    ::close(sockets[1]);   // Helper gone before answering
+    EXPECT_EQ(client.call(DeviceControlOp::Ping), EPIPE);
+    EXPECT_FALSE(client.isRunning());
+}
+
+TEST(DeviceControlClientTest, LaunchFailureIsRemembered) {
+    DeviceControlClient missing({"/nonexistent/ct_device_helper"});
+    std::string error;
+    EXPECT_FALSE(missing.start(&error));
+    EXPECT_NE(error.find("did not answer"), std::string::npos);
+    EXPECT_EQ(missing.call(DeviceControlOp::Ping), ENOTCONN);   // Not relaunched per call
+
+    DeviceControlClient exits({"/bin/true"});
+    EXPECT_FALSE(exits.start());
+    EXPECT_FALSE(exits.isRunning());
+}
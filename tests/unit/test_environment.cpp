@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "core/interfaces/i_shell.h"
+#include <cstdlib>
+#include <string>
+
+using namespace cross_terminal::core;
+using cross_terminal::memory::StringInterner;
+
+TEST(EnvironmentTest, SetGetHasAndRemove) {
+    Environment env;
+    env.set("CT_ENV_NAME", "first");
+    env.set("CT_ENV_NAME", "second");
+    env.set("CT_ENV_OTHER", "");
+
+    EXPECT_EQ(env.get("CT_ENV_NAME"), "second");
+    EXPECT_TRUE(env.has("CT_ENV_OTHER"));
+    EXPECT_EQ(env.get("CT_ENV_OTHER"), "");
+
+    EXPECT_TRUE(env.remove("CT_ENV_NAME"));
+    EXPECT_FALSE(env.remove("CT_ENV_NAME"));
+    EXPECT_FALSE(env.has("CT_ENV_NAME"));
+
+    auto all = env.getAll();
+    ASSERT_EQ(all.size(), 1u);
+    EXPECT_EQ(all[0].first, "CT_ENV_OTHER");
+
+    env.clear();
+    EXPECT_TRUE(env.getAll().empty());
+}
+
+TEST(EnvironmentTest, LookupOfUnknownNameInternsNothing) {
+    Environment env;
+    env.set("CT_ENV_KNOWN", "1");
+
+    auto& interner = StringInterner::instance();
+    const size_t before = interner.get_stats().unique_strings;
+    EXPECT_EQ(env.get("CT_ENV_NEVER_SET"), "");
+    EXPECT_FALSE(env.has("CT_ENV_NEVER_SET"));
+    EXPECT_FALSE(env.remove("CT_ENV_NEVER_SET"));
+    EXPECT_TRUE(interner.find("CT_ENV_NEVER_SET").empty());
+    EXPECT_EQ(interner.get_stats().unique_strings, before);
+}
+
+TEST(EnvironmentTest, ImportsAndExportsTheSystemEnvironment) {
+    ASSERT_EQ(setenv("CT_ENV_IMPORTED", "a=b", 1), 0);
+
+    Environment env;
+    env.importFromSystem();
+    EXPECT_EQ(env.get("CT_ENV_IMPORTED"), "a=b");
+    EXPECT_EQ(env.get("PATH"), getenv("PATH") ? getenv("PATH") : "");
+
+    env.set("CT_ENV_EXPORTED", "exported");
+    env.exportToSystem();
+    ASSERT_NE(getenv("CT_ENV_EXPORTED"), nullptr);
+    EXPECT_STREQ(getenv("CT_ENV_EXPORTED"), "exported");
+
+    unsetenv("CT_ENV_IMPORTED");
+    unsetenv("CT_ENV_EXPORTED");
+}
@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+#include "core/implementations/file_operations.h"
+#include "core/implementations/shell_impl.h"
+#include "fake_sysfs.h"
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace cross_terminal::core;
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+bool exists(const std::string& path) {
+    struct stat info;
+    return lstat(path.c_str(), &info) == 0;
+}
+
+off_t fileSize(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? info.st_size : -1;
+}
+
+constexpr off_t BIG_SIZE = 3 * 1024 * 1024;
+
+// A few directories deep and wide, with a link and a large file
+void populate(FakeSysfs& tree) {
+    for (int d = 0; d < 4; ++d) {
+        for (int f = 0; f < 25; ++f) {
+            tree.write("src/dir" + std::to_string(d) + "/sub/file" + std::to_string(f),
+                       "contents " + std::to_string(d * 100 + f));
+        }
+    }
+    tree.write("src/big", "");
+    truncate(tree.path("src/big").c_str(), BIG_SIZE);   // Large without a large allocation
+    tree.link("src/link", "src/big");
+    tree.makeDirectory("src/empty");
+}
+
+} // namespace
+
+TEST(FileOperationsTest, CopiesTreesRecursively) {
+    FakeSysfs tree;
+    populate(tree);
+    chmod(tree.path("src/dir2").c_str(), 0555);   // Still filled, then made read-only
+    FsContext fs(tree.root());
+    FileOperationOptions options;
+    options.recursive = true;
+    options.threads = 4;
+    FileOperations operations(fs, options);
+
+    auto result = operations.copy({"src"}, "copy");
+    ASSERT_TRUE(result.succeeded()) << (result.errors.empty() ? "" : result.errors[0]);
+    EXPECT_EQ(result.totals.files, 102u);   // 100 files, big and the link
+    EXPECT_EQ(result.totals.directories, 10u);
+    EXPECT_EQ(result.totals.bytes, BIG_SIZE + 1265u);   // Contents lines are 11 to 13 bytes
+    EXPECT_EQ(readFile(tree.path("copy/dir3/sub/file7")), "contents 307\n");
+    EXPECT_EQ(fileSize(tree.path("copy/big")), BIG_SIZE);
+    char target[256] = {};
+    ASSERT_GT(readlink(tree.path("copy/link").c_str(), target, sizeof(target) - 1), 0);
+    EXPECT_STREQ(target, tree.path("src/big").c_str());
+    EXPECT_TRUE(exists(tree.path("copy/empty")));
+    struct stat info;
+    ASSERT_EQ(stat(tree.path("copy/dir2").c_str(), &info), 0);
+    EXPECT_EQ(info.st_mode & 0777, 0555u);
+    chmod(tree.path("src/dir2").c_str(), 0755);
+    chmod(tree.path("copy/dir2").c_str(), 0755);
+
+    // Into an existing directory, under the source's own name
+    tree.makeDirectory("into");
+    result = operations.copy({"src/dir0/sub/file1", "src/dir1"}, "into");
+    EXPECT_TRUE(result.succeeded());
+    EXPECT_EQ(readFile(tree.path("into/file1")), "contents 1\n");
+    EXPECT_EQ(readFile(tree.path("into/dir1/sub/file2")), "contents 102\n");
+}
+
+TEST(FileOperationsTest, ReportsCopyErrors) {
+    FakeSysfs tree;
+    populate(tree);
+    FsContext fs(tree.root());
+    FileOperations plain(fs);
+
+    auto result = plain.copy({"src"}, "copy");
+    ASSERT_EQ(result.errors.size(), 1u);
+    EXPECT_NE(result.errors[0].find("omitting directory 'src'"), std::string::npos);
+    EXPECT_FALSE(exists(tree.path("copy")));
+
+    result = plain.copy({"missing", "src/big"}, "src/big");
+    ASSERT_EQ(result.errors.size(), 1u);
+    EXPECT_NE(result.errors[0].find("not a directory"), std::string::npos);
+
+    result = plain.copy({"src/big"}, "src/big");
+    ASSERT_EQ(result.errors.size(), 1u);
+    EXPECT_NE(result.errors[0].find("are the same file"), std::string::npos);
+
+    FileOperationOptions recursive;
+    recursive.recursive = true;
+    FileOperations operations(fs, recursive);
+    result = operations.copy({"src"}, "src/dir0/inside");
+    ASSERT_EQ(result.errors.size(), 1u);
+    EXPECT_NE(result.errors[0].find("into itself"), std::string::npos);
+    result = operations.copy({"missing"}, "copy");
+    ASSERT_EQ(result.errors.size(), 1u);
+    EXPECT_EQ(result.errors[0], "cannot stat 'missing': No such file or directory");
+}
+
+TEST(FileOperationsTest, MovesAndRemoves) {
+    FakeSysfs tree;
+    populate(tree);
+    FsContext fs(tree.root());
+    FileOperationOptions options;
+    options.threads = 3;
+    FileOperations plain(fs, options);
+
+    auto result = plain.move({"src/dir0", "src/big"}, "src/empty");
+    EXPECT_TRUE(result.succeeded());
+    EXPECT_EQ(result.totals.files, 1u);
+    EXPECT_EQ(result.totals.directories, 1u);
+    EXPECT_EQ(readFile(tree.path("src/empty/dir0/sub/file3")), "contents 3\n");
+    EXPECT_FALSE(exists(tree.path("src/big")));
+
+    result = plain.remove({"src/dir1"});
+    ASSERT_EQ(result.errors.size(), 1u);
+    EXPECT_EQ(result.errors[0], "cannot remove 'src/dir1': Is a directory");
+    result = plain.remove({"src/link", "missing"});
+    EXPECT_EQ(result.totals.files, 1u);
+    EXPECT_EQ(result.errors.size(), 1u);
+    EXPECT_FALSE(plain.remove({"."}).succeeded());
+
+    options.recursive = true;
+    options.force = true;
+    FileOperations recursive(fs, options);
+    result = recursive.remove({"src/", "missing"});
+    EXPECT_TRUE(result.succeeded()) << (result.errors.empty() ? "" : result.errors[0]);
+    EXPECT_EQ(result.totals.files, 101u);
+    EXPECT_EQ(result.totals.directories, 10u);
+    EXPECT_FALSE(exists(tree.path("src")));
+}
+
+TEST(FileOperationsTest, ShellBuiltinsStreamErrorsAndFallBackForOtherFlags) {
+    FakeSysfs tree;
+    populate(tree);
+    ShellImpl shell;
+    ASSERT_TRUE(shell.setCurrentDirectory(tree.root()));
+
+    std::string output;
+    std::string errors;
+    auto collect = [&](const std::string& data, bool is_error) { (is_error ? errors : output) += data; };
+    int status = -1;
+    auto done = [&status](const ProcessInfo& info) { status = info.exit_code; };
+
+    shell.executeAsync("cp -r src copy", {}, collect, done);
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(readFile(tree.path("copy/dir1/sub/file4")), "contents 104\n");
+
+    shell.executeAsync("mv copy moved", {}, collect, done);
+    EXPECT_EQ(status, 0);
+    EXPECT_TRUE(exists(tree.path("moved/big")));
+
+    shell.executeAsync("rm moved", {}, collect, done);
+    EXPECT_EQ(status, 1);
+    EXPECT_EQ(errors, "rm: cannot remove 'moved': Is a directory\n");
+
+    shell.executeAsync("rm -rf moved", {}, collect, done);
+    EXPECT_EQ(status, 0);
+    EXPECT_FALSE(exists(tree.path("moved")));
+
+    errors.clear();
+    shell.executeAsync("cp", {}, collect, done);
+    EXPECT_EQ(status, 2);
+    EXPECT_EQ(errors, "usage: cp [-rf] SOURCE... DESTINATION\n");
+
+    // Flags the builtin lacks go to the real cp
+    ProcessInfo info = shell.executeSync("cp -p src/big preserved");
+    EXPECT_EQ(info.exit_code, 0);
+    EXPECT_TRUE(exists(tree.path("preserved")));
+    EXPECT_TRUE(output.empty());
+}
+
+TEST(FileOperationsTest, RuntimeShellRunsThemAsJobsThatKillCancels) {
+    FakeSysfs tree;
+    populate(tree);
+    auto reactor = std::make_shared<IoReactor>(1);
+    auto workers = std::make_shared<WorkerPool>(1);
+    ASSERT_TRUE(reactor->start());
+    ASSERT_TRUE(workers->start());
+    ShellImpl shell(reactor, workers, std::make_shared<WorkStealingPool>(2));
+    ASSERT_TRUE(shell.setCurrentDirectory(tree.root()));
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<ProcessInfo> finished;
+    auto done = [&](const ProcessInfo& info) {
+        std::lock_guard lock(mutex);
+        finished.push_back(info);
+        condition.notify_all();
+    };
+    auto waitForJobs = [&](size_t count) {
+        std::unique_lock lock(mutex);
+        return condition.wait_for(lock, std::chrono::seconds(5), [&]() { return finished.size() >= count; });
+    };
+
+    // The only worker is busy, so both copies queue and executeAsync() returns at once
+    std::promise<void> release;
+    std::shared_future<void> busy = release.get_future().share();
+    ASSERT_TRUE(workers->submit([busy]() { busy.wait(); }));
+    const int copy = shell.executeAsync("cp -r src copy", {}, nullptr, done);
+    const int killed = shell.executeAsync("cp -r src never", {}, nullptr, done);
+    ASSERT_GT(copy, 0);
+    ASSERT_GT(killed, copy);
+
+    // Killed while queued: complete at once, never run
+    EXPECT_TRUE(shell.terminateProcess(killed));
+    ASSERT_TRUE(waitForJobs(1));
+    EXPECT_EQ(finished[0].pid, killed);
+    EXPECT_EQ(finished[0].state, ProcessState::Terminated);
+    EXPECT_EQ(finished[0].exit_code, SIGTERM);
+    EXPECT_FALSE(exists(tree.path("copy")));
+
+    release.set_value();
+    ASSERT_TRUE(waitForJobs(2));
+    EXPECT_EQ(finished[1].pid, copy);
+    EXPECT_EQ(finished[1].state, ProcessState::Completed);
+    EXPECT_EQ(readFile(tree.path("copy/dir1/sub/file4")), "contents 104\n");
+    EXPECT_FALSE(exists(tree.path("never")));
+    EXPECT_FALSE(shell.terminateProcess(copy));
+
+    // A cancel that lands before the operation starts is not lost
+    FsContext fs(tree.root());
+    FileOperationOptions options;
+    options.recursive = true;
+    FileOperations operations(fs, options);
+    operations.cancel();
+    EXPECT_TRUE(operations.remove({"copy"}).cancelled);
+    EXPECT_TRUE(exists(tree.path("copy")));
+
+    shell.shutdown();
+    workers->stop();
+    reactor->stop();
+}
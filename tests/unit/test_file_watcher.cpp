@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include "core/implementations/file_watcher.h"
+#include "core/implementations/shell_impl.h"
+#include "fake_sysfs.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <mutex>
+#include <signal.h>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+using namespace cross_terminal::core;
+
+class FileWatcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        reactor = std::make_shared<IoReactor>(1);
+        ASSERT_TRUE(reactor->start());
+    }
+
+    void TearDown() override {
+        reactor->stop();
+    }
+
+    FileWatcher::ChangeCallback record() {
+        return [this](const std::vector<std::string>& changed) {
+            std::lock_guard lock(mutex);
+            bursts.push_back(changed);
+            condition.notify_all();
+        };
+    }
+
+    // Wait for the count-th burst; false on timeout
+    bool waitForBursts(size_t count, uint32_t timeout_ms = 3000) {
+        std::unique_lock lock(mutex);
+        return condition.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                                  [this, count]() { return bursts.size() >= count; });
+    }
+
+    bool burstContains(size_t index, const std::string& path) {
+        std::lock_guard lock(mutex);
+        const auto& changed = bursts.at(index);
+        return std::find(changed.begin(), changed.end(), path) != changed.end();
+    }
+
+    size_t burstCount() {
+        std::lock_guard lock(mutex);
+        return bursts.size();
+    }
+
+    std::shared_ptr<IoReactor> reactor;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::vector<std::string>> bursts;
+};
+
+TEST_F(FileWatcherTest, DebouncesBurstsAndFollowsNewDirectories) {
+    FakeSysfs tree;
+    tree.write("src/a.txt", "0");
+    tree.makeDirectory("src/sub/deeper");
+    FileWatchOptions options;
+    options.debounce_ms = 50;
+    FileWatcher watcher(reactor, options);
+    ASSERT_EQ(watcher.start({tree.path("src")}, record()), 0);
+    EXPECT_EQ(watcher.getMetrics().watches, 3u);
+
+    for (int i = 0; i < 20; ++i) {
+        tree.write("src/a.txt", std::to_string(i));
+    }
+    tree.write("src/sub/deeper/b.txt", "b");
+    ASSERT_TRUE(waitForBursts(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_EQ(burstCount(), 1u);   // One burst for all of it
+    EXPECT_TRUE(burstContains(0, tree.path("src/a.txt")));
+    EXPECT_TRUE(burstContains(0, tree.path("src/sub/deeper/b.txt")));
+
+    // A directory created after start() is watched as it appears
+    tree.makeDirectory("src/new");
+    ASSERT_TRUE(waitForBursts(2));
+    tree.write("src/new/c.txt", "c");
+    ASSERT_TRUE(waitForBursts(3));
+    EXPECT_TRUE(burstContains(2, tree.path("src/new/c.txt")));
+    EXPECT_EQ(watcher.getMetrics().watches, 4u);
+
+    watcher.stop();
+    tree.write("src/a.txt", "after");
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_EQ(burstCount(), 3u);
+    EXPECT_NE(watcher.start({tree.path("missing")}, record()), 0);
+}
+
+TEST_F(FileWatcherTest, WatchesFilesThroughTheirDirectory) {
+    FakeSysfs tree;
+    tree.write("etc/app.conf", "old");
+    tree.write("etc/other.conf", "other");
+    FileWatchOptions options;
+    options.debounce_ms = 20;
+    FileWatcher watcher(reactor, options);
+    ASSERT_EQ(watcher.start({tree.path("etc/app.conf")}, record()), 0);
+
+    // Unrelated entries in the same directory are ignored
+    tree.write("etc/other.conf", "changed");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(burstCount(), 0u);
+
+    // An editor's save: a new file renamed over the old
+    tree.write("etc/app.conf.tmp", "new");
+    ASSERT_EQ(rename(tree.path("etc/app.conf.tmp").c_str(), tree.path("etc/app.conf").c_str()), 0);
+    ASSERT_TRUE(waitForBursts(1));
+    std::lock_guard lock(mutex);
+    EXPECT_EQ(bursts[0], std::vector<std::string>{tree.path("etc/app.conf")});
+}
+
+TEST_F(FileWatcherTest, OnChangeRerunsAndEndsThePreviousRun) {
+    FakeSysfs tree;
+    tree.write("src/main.c", "int main;");
+    auto workers = std::make_shared<WorkerPool>(2);
+    ASSERT_TRUE(workers->start());
+    ShellImpl shell(reactor, workers);
+    ASSERT_TRUE(shell.setCurrentDirectory(tree.root()));
+
+    std::string output;
+    std::string errors;
+    auto collect = [this, &output, &errors](const std::string& data, bool is_error) {
+        std::lock_guard lock(mutex);
+        (is_error ? errors : output) += data;
+        condition.notify_all();
+    };
+    auto lines = [this, &output]() {
+        std::lock_guard lock(mutex);
+        std::vector<std::string> result;
+        size_t start = 0;
+        for (size_t end; (end = output.find('\n', start)) != std::string::npos; start = end + 1) {
+            result.push_back(output.substr(start, end - start));
+        }
+        return result;
+    };
+    auto waitForLines = [this, &lines](size_t count) {
+        std::unique_lock lock(mutex);
+        return condition.wait_for(lock, std::chrono::seconds(5), [&]() {
+            lock.unlock();
+            const bool enough = lines().size() >= count;
+            lock.lock();
+            return enough;
+        });
+    };
+    ProcessInfo status;
+    status.exit_code = -1;
+    auto done = [this, &status](const ProcessInfo& info) {
+        std::lock_guard lock(mutex);
+        status = info;
+        condition.notify_all();
+    };
+    auto exitCode = [this, &status]() {
+        std::lock_guard lock(mutex);
+        return status.exit_code;
+    };
+
+    // Each run prints its process id, then outlives the next change; the
+    // watch is a job that runs until it is killed
+    const int job = shell.executeAsync("onchange -d 30 src -- sh -c 'echo $$; exec sleep 10'", {},
+                                       collect, done);
+    ASSERT_GT(job, 0);
+    ASSERT_TRUE(waitForLines(1));   // The run up front
+    {
+        std::lock_guard lock(mutex);
+        int reported = -1;
+        ASSERT_EQ(sscanf(errors.c_str(), "onchange: job %d watching 1 directories", &reported), 1);
+        EXPECT_EQ(reported, job);
+    }
+    EXPECT_EQ(exitCode(), -1);
+
+    tree.write("src/main.c", "int main() {}");
+    ASSERT_TRUE(waitForLines(2));
+    const pid_t first = std::stoi(lines()[0]);
+    const pid_t second = std::stoi(lines()[1]);
+    EXPECT_NE(first, second);
+    // SIGTERM to the first run's group; the shell reaps it
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (kill(first, 0) == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_NE(kill(first, 0), 0);
+
+    // kill stops the watch and its current run, and completes the job
+    EXPECT_TRUE(shell.terminateProcess(job));
+    {
+        std::lock_guard lock(mutex);
+        EXPECT_EQ(status.pid, job);
+        EXPECT_EQ(status.state, ProcessState::Terminated);
+        EXPECT_EQ(status.exit_code, SIGTERM);
+    }
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (kill(second, 0) == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_NE(kill(second, 0), 0);
+    tree.write("src/main.c", "int main() { return 0; }");
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    EXPECT_EQ(lines().size(), 2u);
+    EXPECT_FALSE(shell.terminateProcess(job));
+
+    // A standalone shell has no reactor to drive the watch
+    ShellImpl standalone;
+    standalone.executeAsync("onchange src -- true", {}, collect, done);
+    EXPECT_EQ(exitCode(), 1);
+
+    // Shutdown ends a watch still running
+    shell.executeAsync("onchange src -- true", {}, collect, done);
+    shell.shutdown();
+    EXPECT_EQ(exitCode(), SIGTERM);
+    workers->stop();
+}
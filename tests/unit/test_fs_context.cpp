@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include "core/implementations/fs_context.h"
+#include "core/implementations/file_operations.h"
+#include "core/implementations/shell_impl.h"
+#include "fake_sysfs.h"
+#include <climits>
+#include <fcntl.h>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace cross_terminal::core;
+
+namespace {
+
+std::string processDirectory() {
+    char buffer[PATH_MAX];
+    return getcwd(buffer, sizeof(buffer)) ? buffer : "";
+}
+
+} // namespace
+
+TEST(FsContextTest, ChangesDirectoryWithoutTouchingTheProcess) {
+    FakeSysfs tree;
+    tree.write("a/b/file", "x");
+    const std::string before = processDirectory();
+
+    FsContext fs(tree.root());
+    EXPECT_EQ(fs.currentDirectory(), tree.root());
+    EXPECT_EQ(fs.changeDirectory("a/./b"), 0);
+    EXPECT_EQ(fs.currentDirectory(), tree.path("a/b"));
+    EXPECT_TRUE(fs.exists("file"));
+    EXPECT_EQ(fs.changeDirectory(".."), 0);
+    EXPECT_EQ(fs.currentDirectory(), tree.path("a"));
+    EXPECT_EQ(fs.absolute("b//file"), tree.path("a/b/file"));
+
+    EXPECT_EQ(fs.changeDirectory("missing"), ENOENT);
+    EXPECT_EQ(fs.changeDirectory("b/file"), ENOTDIR);
+    EXPECT_EQ(fs.currentDirectory(), tree.path("a"));
+    EXPECT_EQ(processDirectory(), before);
+}
+
+TEST(FsContextTest, StatsListsAndCreatesRelativeToCachedDirectories) {
+    FakeSysfs tree;
+    tree.write("deep/er/file", "1234");   // Five bytes with the newline
+    tree.link("deep/er/link", "deep/er/file");
+    FsContext fs(tree.root());
+
+    FsStat info;
+    ASSERT_EQ(fs.stat("deep/er/file", info), 0);
+    EXPECT_EQ(info.type, FsEntryType::Regular);
+    EXPECT_EQ(info.size, 5u);
+    EXPECT_GT(info.mtime_ns, 0);
+    ASSERT_EQ(fs.stat("deep/er/link", info, false), 0);
+    EXPECT_EQ(info.type, FsEntryType::Symlink);
+    ASSERT_EQ(fs.stat(tree.path("deep"), info), 0);
+    EXPECT_EQ(info.type, FsEntryType::Directory);
+    EXPECT_EQ(fs.stat("deep/../deep/er/file", info), 0);
+    EXPECT_EQ(fs.stat("deep/er/file/x", info), ENOTDIR);
+
+    EXPECT_EQ(fs.createDirectory("deep/er/sub"), 0);
+    EXPECT_EQ(fs.createDirectory("deep/er/sub"), EEXIST);
+    int fd = fs.openFile("deep/er/sub/new", O_WRONLY | O_CREAT, 0644);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+
+    std::vector<FsEntry> entries;
+    ASSERT_EQ(fs.listDirectory("deep/er", entries), 0);
+    std::map<std::string, FsEntryType> types;
+    for (const auto& entry : entries) {
+        types[entry.name] = entry.type;
+    }
+    ASSERT_EQ(types.size(), 3u);
+    EXPECT_EQ(types["file"], FsEntryType::Regular);
+    EXPECT_EQ(types["link"], FsEntryType::Symlink);
+    EXPECT_EQ(types["sub"], FsEntryType::Directory);
+    EXPECT_EQ(fs.listDirectory("deep/er/file", entries), ENOTDIR);
+}
+
+TEST(FsContextTest, GlobsAndCompletes) {
+    FakeSysfs tree;
+    tree.write("src/main.cpp", "");
+    tree.write("src/main.h", "");
+    tree.write("src/util.cpp", "");
+    tree.write("src/.hidden.cpp", "");
+    tree.write("test/main.cpp", "");
+    tree.write("notes.txt", "");
+    FsContext fs(tree.root());
+
+    EXPECT_EQ(fs.glob("src/*.cpp"), (std::vector<std::string>{"src/main.cpp", "src/util.cpp"}));
+    EXPECT_EQ(fs.glob("*/main.?pp"), (std::vector<std::string>{"src/main.cpp", "test/main.cpp"}));
+    EXPECT_EQ(fs.glob("src/.*.cpp"), (std::vector<std::string>{"src/.hidden.cpp"}));
+    EXPECT_EQ(fs.glob(tree.path("[n]*")), (std::vector<std::string>{tree.path("notes.txt")}));
+    EXPECT_TRUE(fs.glob("*.none").empty());
+
+    EXPECT_EQ(fs.complete("s"), (std::vector<std::string>{"src/"}));
+    EXPECT_EQ(fs.complete("src/ma"), (std::vector<std::string>{"src/main.cpp", "src/main.h"}));
+    EXPECT_EQ(fs.complete("src/."), (std::vector<std::string>{"src/.hidden.cpp"}));
+    EXPECT_EQ(fs.complete("").size(), 3u);
+}
+
+TEST(FsContextTest, CachesDirectoriesWithLruAndTtl) {
+    FakeSysfs tree;
+    for (int i = 0; i < 4; ++i) {
+        tree.write("d" + std::to_string(i) + "/f", "");
+    }
+    FsContext fs(tree.root(), 2, 60000);
+
+    EXPECT_TRUE(fs.exists("d0/f"));
+    EXPECT_TRUE(fs.exists("d0/f"));
+    auto metrics = fs.getMetrics();
+    EXPECT_EQ(metrics.cache_misses, 1u);
+    EXPECT_EQ(metrics.cached, 1u);
+
+    EXPECT_TRUE(fs.exists("d1/f"));
+    EXPECT_TRUE(fs.exists("d2/f"));   // Evicts d0
+    metrics = fs.getMetrics();
+    EXPECT_EQ(metrics.cached, 2u);
+    EXPECT_EQ(metrics.evictions, 1u);
+    EXPECT_TRUE(fs.exists("d0/f"));
+    EXPECT_EQ(fs.getMetrics().cache_misses, 4u);
+
+    // A directory replaced behind the cache is found again once invalidated
+    tree.remove("d1");
+    tree.write("d1/g", "");
+    fs.invalidate();
+    EXPECT_EQ(fs.getMetrics().cached, 0u);
+    EXPECT_TRUE(fs.exists("d1/g"));
+
+    FsContext expiring(tree.root(), 8, 0);
+    EXPECT_TRUE(expiring.exists("d3/f"));
+    EXPECT_TRUE(expiring.exists("d3/f"));
+    EXPECT_EQ(expiring.getMetrics().cache_misses, 2u);
+}
+
+TEST(FsContextTest, DropsDirectoriesRemovedOrRenamedWithinTheTtl) {
+    FakeSysfs tree;
+    tree.write("build/old.o", "");
+    tree.write("src/main.c", "");
+    FsContext fs(tree.root(), 8, 60000);
+    EXPECT_TRUE(fs.exists("build/old.o"));
+
+    // rm -r build; mkdir build: the cached fd is of the removed directory
+    tree.remove("build");
+    tree.write("build/new.o", "");
+    EXPECT_TRUE(fs.exists("build/new.o"));
+    EXPECT_FALSE(fs.exists("build/old.o"));
+    int fd = fs.openFile("build/out.o", O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    EXPECT_EQ(access(tree.path("build/out.o").c_str(), F_OK), 0);
+
+    // mv src old; mkdir src: the fd followed the rename, the move drops it
+    EXPECT_TRUE(fs.exists("src/main.c"));
+    FileOperations operations(fs);
+    ASSERT_TRUE(operations.move({"src"}, "old").succeeded());
+    EXPECT_EQ(fs.createDirectory("src"), 0);
+    EXPECT_FALSE(fs.exists("src/main.c"));
+    EXPECT_TRUE(fs.exists("old/main.c"));
+}
+
+TEST(FsContextTest, ShellUsesSessionDirectoryForCdGlobsAndCompletion) {
+    FakeSysfs tree;
+    tree.write("work/a.log", "");
+    tree.write("work/b.log", "");
+    const std::string before = processDirectory();
+
+    ShellImpl shell;
+    ASSERT_TRUE(shell.setCurrentDirectory(tree.path("work")));
+    EXPECT_EQ(shell.getCurrentDirectory(), tree.path("work"));
+    EXPECT_EQ(processDirectory(), before);
+
+    std::string output;
+    auto collect = [&output](const std::string& data, bool) { output += data; };
+    shell.executeAsync("echo *.log '*.log' *.none", {}, collect, nullptr);
+    EXPECT_EQ(output, "a.log b.log *.log *.none\n");
+
+    // Children start in the session directory
+    ProcessInfo info = shell.executeSync("test -f a.log");
+    EXPECT_EQ(info.exit_code, 0);
+
+    EXPECT_EQ(shell.getCompletions("ca"), std::vector<std::string>{});
+    EXPECT_EQ(shell.getCompletions("p"), (std::vector<std::string>{"pwd"}));
+    EXPECT_EQ(shell.getCompletions("cat a"), (std::vector<std::string>{"a.log"}));
+    EXPECT_EQ(shell.getCompletions("cd ../w"), (std::vector<std::string>{"../work/"}));
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "hardware/hardware_bus.h"
+#include "fake_hardware_bus.h"
+#include <cstdint>
+#include <vector>
+
+using namespace cross_terminal::hardware;
+
+TEST(HardwareBusTest, RegisterHelpersUseCombinedTransactions) {
+    FakeI2CBus bus;
+    bus.addDevice(0x48);
+    const uint8_t config[] = {0x60, 0xa0};
+    ASSERT_TRUE(bus.writeRegisters(0x48, 0x01, config, 2));
+    EXPECT_EQ(bus.peek(0x48, 0x01), 0x60);
+    EXPECT_EQ(bus.peek(0x48, 0x02), 0xa0);
+
+    uint8_t out[2] = {};
+    ASSERT_TRUE(bus.readRegisters(0x48, 0x01, out, 2));
+    EXPECT_EQ(out[0], 0x60);
+    EXPECT_EQ(out[1], 0xa0);
+    EXPECT_EQ(bus.transferSizes(), (std::vector<size_t>{1, 2}));
+    EXPECT_FALSE(bus.readRegisters(0x50, 0x00, out, 1));   // Nothing at 0x50
+}
+
+TEST(HardwareBusTest, I2CBatchPacksWholeAccesses) {
+    FakeI2CBus bus;
+    bus.setMaxMessages(5);
+    for (uint16_t address = 0x10; address < 0x18; ++address) {
+        bus.addDevice(address);
+        bus.poke(address, 0x20, static_cast<uint8_t>(address));
+        bus.poke(address, 0x21, static_cast<uint8_t>(address + 0x80));
+    }
+
+    I2CBatch batch;
+    uint8_t readings[8][2] = {};
+    for (uint16_t i = 0; i < 8; ++i) {
+        batch.readRegisters(0x10 + i, 0x20, readings[i], 2);
+    }
+    const uint8_t value = 0x5a;
+    batch.writeRegisters(0x17, 0x30, &value, 1);
+    EXPECT_EQ(batch.size(), 9u);
+    EXPECT_EQ(batch.messageCount(), 17u);
+
+    ASSERT_TRUE(batch.execute(bus));
+    // Two register reads (4 messages) per transaction: a fifth message
+    // would split the next read from its register write
+    EXPECT_EQ(bus.transferSizes(), (std::vector<size_t>{4, 4, 4, 5}));
+    EXPECT_EQ(batch.transactions(), 4u);
+    EXPECT_EQ(batch.completed(), 9u);
+    for (uint16_t i = 0; i < 8; ++i) {
+        EXPECT_EQ(readings[i][0], 0x10 + i);
+        EXPECT_EQ(readings[i][1], 0x90 + i);
+    }
+    EXPECT_EQ(bus.peek(0x17, 0x30), 0x5a);
+}
+
+TEST(HardwareBusTest, I2CBatchStopsAtFailedTransaction) {
+    FakeI2CBus bus;
+    bus.setMaxMessages(2);
+    bus.addDevice(0x10);
+    bus.addDevice(0x12);
+
+    I2CBatch batch;
+    uint8_t a = 0, b = 0, c = 0;
+    batch.readRegisters(0x10, 0, &a, 1);
+    batch.readRegisters(0x11, 0, &b, 1);   // Missing device
+    batch.readRegisters(0x12, 0, &c, 1);
+    EXPECT_FALSE(batch.execute(bus));
+    EXPECT_EQ(batch.completed(), 1u);
+    EXPECT_EQ(bus.stats().transfers, 2u);   // The third read is never attempted
+
+    // A single access larger than the bus limit cannot be executed
+    batch.clear();
+    bus.setMaxMessages(1);
+    batch.readRegisters(0x10, 0, &a, 1);
+    EXPECT_FALSE(batch.execute(bus));
+    EXPECT_EQ(batch.transactions(), 0u);
+}
+
+TEST(HardwareBusTest, SPIBatchFramesCommandsAndRespectsLimits) {
+    FakeSPIDevice device(0, 4, 16);
+    ASSERT_TRUE(device.configure(SPIConfig()));
+    for (uint8_t reg = 0; reg < 16; ++reg) {
+        device.poke(reg, static_cast<uint8_t>(0xc0 + reg));
+    }
+
+    SPIBatch batch;
+    uint8_t readings[4][3] = {};
+    for (uint8_t i = 0; i < 4; ++i) {
+        const uint8_t command = FakeSPIDevice::READ | static_cast<uint8_t>(i * 3);
+        batch.command(&command, 1, readings[i], 3);   // Command byte is copied
+    }
+    const uint8_t write[] = {0x40, 0x11, 0x22};
+    batch.exchange(write, nullptr, sizeof(write));
+
+    ASSERT_TRUE(batch.execute(device));
+    for (uint8_t i = 0; i < 4; ++i) {
+        for (uint8_t j = 0; j < 3; ++j) {
+            EXPECT_EQ(readings[i][j], 0xc0 + i * 3 + j);
+        }
+    }
+    EXPECT_EQ(device.peek(0x40), 0x11);
+    EXPECT_EQ(device.peek(0x41), 0x22);
+
+    // Four transfers per message: two commands, two commands, the write
+    auto stats = device.stats();
+    EXPECT_EQ(stats.messages, 3u);
+    EXPECT_EQ(batch.messages(), 3u);
+    EXPECT_EQ(stats.frames, 5u);
+    EXPECT_EQ(stats.cs_left_asserted, 0u);
+
+    // A frame longer than the device's buffer is rejected up front
+    batch.clear();
+    std::vector<uint8_t> large(32, 0);
+    batch.exchange(large.data(), nullptr, static_cast<uint32_t>(large.size()));
+    EXPECT_FALSE(batch.execute(device));
+    EXPECT_EQ(device.stats().messages, 3u);
+}
+
+TEST(HardwareBusTest, LinuxBackendsReportMissingNodes) {
+    std::string error;
+    EXPECT_EQ(LinuxI2CBus::open("/dev/i2c-does-not-exist", &error), nullptr);
+    EXPECT_NE(error.find("/dev/i2c-does-not-exist"), std::string::npos);
+    EXPECT_EQ(SpidevDevice::open("/dev/spidev-does-not-exist", &error), nullptr);
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "core/implementations/job_history.h"
+#include "core/implementations/shell_impl.h"
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+using namespace cross_terminal::core;
+
+namespace {
+
+uint64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+ProcessInfo makeJob(const std::string& command, int exit_code, uint64_t end_time,
+                    std::vector<std::string> args = {}) {
+    ProcessInfo info;
+    info.command = command;
+    info.arguments.assign(args.begin(), args.end());
+    info.working_dir = "/tmp";
+    info.exit_code = exit_code;
+    info.state = exit_code == 0 ? ProcessState::Completed : ProcessState::Failed;
+    info.start_time = end_time - 250;
+    info.end_time = end_time;
+    info.user_time_ms = 12;
+    info.max_rss_kb = 2048;
+    return info;
+}
+
+} // namespace
+
+class JobHistoryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/job_history_XXXXXX";
+        ASSERT_NE(mkdtemp(path), nullptr);
+        directory = path;
+        ASSERT_TRUE(history.open(directory));
+    }
+
+    void TearDown() override {
+        history.close();
+        std::system(("rm -rf " + directory).c_str());
+    }
+
+    std::string directory;
+    JobHistory history;
+};
+
+TEST_F(JobHistoryTest, AppendAndQueryNewestFirst) {
+    const uint64_t now = nowMs();
+    ASSERT_TRUE(history.append(makeJob("make", 0, now - 2000, {"-j8", "all"})));
+    ASSERT_TRUE(history.append(makeJob("ls", 0, now - 1000)));
+
+    auto jobs = history.query(JobQuery());
+    ASSERT_EQ(jobs.size(), 2);
+    EXPECT_EQ(jobs[0].command, "ls");
+    EXPECT_EQ(jobs[1].command, "make");
+    EXPECT_EQ(jobs[1].arguments, (std::vector<cross_terminal::memory::InternedString>{"-j8", "all"}));
+    EXPECT_EQ(jobs[1].working_dir, "/tmp");
+    EXPECT_EQ(jobs[1].getDuration(), 250);
+    EXPECT_EQ(jobs[1].user_time_ms, 12);
+    EXPECT_EQ(jobs[1].max_rss_kb, 2048);
+}
+
+TEST_F(JobHistoryTest, FiltersCombine) {
+    const uint64_t now = nowMs();
+    const uint64_t hour = 60 * 60 * 1000;
+    history.append(makeJob("make", 2, now - 3 * hour));
+    history.append(makeJob("make", 0, now - 2 * hour));
+    history.append(makeJob("make", 1, now - 10 * 60 * 1000));
+    history.append(makeJob("grep", 1, now - 5 * 60 * 1000));
+    history.append(makeJob("ls", 0, now - 60 * 1000));
+
+    JobQuery failed_recent;
+    failed_recent.failed_only = true;
+    failed_recent.since = now - hour;
+    auto jobs = history.query(failed_recent);
+    ASSERT_EQ(jobs.size(), 2);
+    EXPECT_EQ(jobs[0].command, "grep");
+    EXPECT_EQ(jobs[1].command, "make");
+
+    JobQuery make_failures;
+    make_failures.command = "make";
+    make_failures.failed_only = true;
+    EXPECT_EQ(history.query(make_failures).size(), 2);
+
+    JobQuery exit_two;
+    exit_two.match_exit_code = true;
+    exit_two.exit_code = 2;
+    ASSERT_EQ(history.query(exit_two).size(), 1);
+
+    JobQuery limited;
+    limited.limit = 3;
+    EXPECT_EQ(history.query(limited).size(), 3);
+
+    JobQuery unknown;
+    unknown.command = "does-not-exist";
+    EXPECT_TRUE(history.query(unknown).empty());
+}
+
+TEST_F(JobHistoryTest, PersistsAcrossReopen) {
+    const uint64_t now = nowMs();
+    for (int i = 0; i < 100; ++i) {
+        history.append(makeJob(i % 2 ? "odd" : "even", i % 3, now - 100 + i));
+    }
+    history.close();
+
+    JobHistory reopened;
+    ASSERT_TRUE(reopened.open(directory));
+    EXPECT_EQ(reopened.size(), 100);
+
+    JobQuery odd;
+    odd.command = "odd";
+    EXPECT_EQ(reopened.query(odd).size(), 50);
+    reopened.close();
+}
+
+TEST_F(JobHistoryTest, GrowsBeyondInitialCapacity) {
+    const uint64_t now = nowMs();
+    const size_t records = JobHistory::INITIAL_CAPACITY + 10;
+    for (size_t i = 0; i < records; ++i) {
+        ASSERT_TRUE(history.append(makeJob("job" + std::to_string(i % 100), 0, now)));
+    }
+    EXPECT_EQ(history.size(), records);
+
+    JobQuery one_command;
+    one_command.command = "job7";
+    EXPECT_EQ(history.query(one_command).size(), records / 100 + (7 < records % 100 ? 1 : 0));
+}
+
+TEST(JobHistoryDurationTest, ParsesUnits) {
+    uint64_t millis = 0;
+    EXPECT_TRUE(JobHistory::parseDuration("1h", millis));
+    EXPECT_EQ(millis, 3600000u);
+    EXPECT_TRUE(JobHistory::parseDuration("15m", millis));
+    EXPECT_EQ(millis, 900000u);
+    EXPECT_TRUE(JobHistory::parseDuration("90", millis));
+    EXPECT_EQ(millis, 90000u);
+    EXPECT_TRUE(JobHistory::parseDuration("2d", millis));
+    EXPECT_EQ(millis, 172800000u);
+    EXPECT_FALSE(JobHistory::parseDuration("h", millis));
+    EXPECT_FALSE(JobHistory::parseDuration("5y", millis));
+}
+
+TEST_F(JobHistoryTest, JobsBuiltinListsHistory) {
+    auto shared = std::make_shared<JobHistory>();
+    ASSERT_TRUE(shared->open(directory + "/shell"));
+    const uint64_t now = nowMs();
+    shared->append(makeJob("make", 2, now - 5000, {"test"}));
+    shared->append(makeJob("ls", 0, now - 4000));
+
+    ShellImpl shell;
+    ASSERT_TRUE(shell.initialize());
+    shell.setJobHistory(shared);
+
+    std::string output;
+    ProcessInfo result;
+    int pid = shell.executeAsync("jobs --history --failed --since 1h", ExecutionOptions(),
+        [&](const std::string& data, bool) { output += data; },
+        [&](const ProcessInfo& info) { result = info; });
+
+    ASSERT_GT(pid, 0);
+    EXPECT_EQ(result.exit_code, 0);
+    EXPECT_NE(output.find("exit 2  make test"), std::string::npos);
+    EXPECT_EQ(output.find("ls"), std::string::npos);
+
+    // A negative limit is an error, not an unlimited query
+    output.clear();
+    shell.executeAsync("jobs --history --limit -1", ExecutionOptions(),
+        [&](const std::string& data, bool) { output += data; },
+        [&](const ProcessInfo& info) { result = info; });
+    EXPECT_EQ(result.exit_code, 2);
+    EXPECT_NE(output.find("invalid value for --limit"), std::string::npos);
+
+    shell.shutdown();
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include "memory/lock_free_queue.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace cross_terminal::memory;
+
+namespace {
+
+struct Message : MpscNode {
+    int producer = 0;
+    int sequence = 0;
+};
+
+// Producer id in the high bits, per-producer sequence in the low bits
+constexpr uint64_t encode(int producer, int sequence) {
+    return (static_cast<uint64_t>(producer) << 32) | static_cast<uint32_t>(sequence);
+}
+
+} // namespace
+
+TEST(LockFreeQueueTest, SpscRingBoundsAndOrder) {
+    SpscRing<int> ring(3);
+    EXPECT_EQ(ring.capacity(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(4));
+    EXPECT_EQ(ring.size_approx(), 4u);
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.try_pop(value));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(LockFreeQueueTest, SpscRingTransfersAcrossThreads) {
+    constexpr int COUNT = 100000;
+    SpscRing<int> ring(64);
+    FutexWait not_empty;
+
+    std::thread producer([&]() {
+        for (int i = 0; i < COUNT; ++i) {
+            while (!ring.try_push(i)) {
+                cpu_relax();
+            }
+            not_empty.notify_one();
+        }
+    });
+
+    int expected = 0;
+    int value = 0;
+    while (expected < COUNT) {
+        not_empty.await([&]() { return ring.try_pop(value); });
+        ASSERT_EQ(value, expected);
+        ++expected;
+    }
+    producer.join();
+}
+
+TEST(LockFreeQueueTest, QueuesDestroyUnconsumedElements) {
+    auto tracked = std::make_shared<int>(7);
+    {
+        SpscRing<std::shared_ptr<int>> ring(4);
+        MpmcQueue<std::shared_ptr<int>> queue(4);
+        ring.try_push(tracked);
+        queue.try_push(tracked);
+        queue.try_push(tracked);
+        EXPECT_EQ(tracked.use_count(), 4);
+    }
+    EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST(LockFreeQueueTest, MpscQueueKeepsPerProducerOrder) {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 50000;
+    MpscQueue<Message> queue;
+    std::vector<std::unique_ptr<Message[]>> storage;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        storage.emplace_back(new Message[PER_PRODUCER]);
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                Message* message = &storage[p][i];
+                message->producer = p;
+                message->sequence = i;
+                queue.push(message);
+            }
+        });
+    }
+
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        Message* message = queue.pop();
+        if (!message) {
+            cpu_relax();
+            continue;
+        }
+        ASSERT_EQ(message->sequence, next[message->producer]);
+        ++next[message->producer];
+        ++received;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_EQ(queue.pop(), nullptr);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(LockFreeQueueTest, MpmcQueueDeliversEveryElementOnce) {
+    constexpr int PRODUCERS = 4;
+    constexpr int CONSUMERS = 4;
+    constexpr int PER_PRODUCER = 50000;
+    MpmcQueue<uint64_t> queue(256);
+    std::atomic<int> remaining{PRODUCERS * PER_PRODUCER};
+    std::vector<std::vector<uint8_t>> seen(PRODUCERS, std::vector<uint8_t>(PER_PRODUCER, 0));
+    std::vector<std::vector<uint64_t>> taken(CONSUMERS);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        threads.emplace_back([&, p]() {
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                while (!queue.try_push(encode(p, i))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < CONSUMERS; ++c) {
+        threads.emplace_back([&, c]() {
+            uint64_t value;
+            uint64_t last[PRODUCERS];
+            std::fill(std::begin(last), std::end(last), UINT64_MAX);
+            while (remaining.load(std::memory_order_relaxed) > 0) {
+                if (!queue.try_pop(value)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                // A single consumer sees each producer's values in order
+                const auto producer = static_cast<size_t>(value >> 32);
+                EXPECT_TRUE(last[producer] == UINT64_MAX || last[producer] < value);
+                last[producer] = value;
+                taken[c].push_back(value);
+                remaining.fetch_sub(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& values : taken) {
+        for (uint64_t value : values) {
+            auto& flag = seen[value >> 32][value & 0xffffffffu];
+            EXPECT_EQ(flag, 0);
+            flag = 1;
+        }
+    }
+    for (const auto& flags : seen) {
+        for (uint8_t flag : flags) {
+            ASSERT_EQ(flag, 1);
+        }
+    }
+}
+
+TEST(LockFreeQueueTest, FutexWaitSleepsUntilNotified) {
+    FutexWait wait;
+    std::atomic<bool> ready{false};
+    std::atomic<bool> woke{false};
+
+    std::thread waiter([&]() {
+        wait.await([&]() { return ready.load(); });
+        woke.store(true);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(woke.load());
+    ready.store(true);
+    wait.notify_all();
+    waiter.join();
+    EXPECT_TRUE(woke.load());
+}
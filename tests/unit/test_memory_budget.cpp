@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include "memory/memory_budget.h"
+#include "core/session_manager.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace cross_terminal::memory;
+
+namespace {
+
+size_t residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Cache holding one large, fully touched allocation
+struct BlobCache {
+    std::unique_ptr<char[]> blob;
+    size_t size = 0;
+
+    void fill(size_t bytes) {
+        blob.reset(new char[bytes]);
+        std::memset(blob.get(), 0x5a, bytes);
+        size = bytes;
+    }
+
+    size_t drop() {
+        size_t released = size;
+        blob.reset();
+        size = 0;
+        return released;
+    }
+};
+
+} // namespace
+
+TEST(MemoryBudgetTest, AccountsUsageByTag) {
+    MemoryBudget budget;
+    budget.charge(MemoryTag::Scrollback, 4096);
+    budget.charge(MemoryTag::History, 1000);
+    budget.release(MemoryTag::Scrollback, 1024);
+
+    EXPECT_EQ(budget.usage(MemoryTag::Scrollback), 3072u);
+    EXPECT_EQ(budget.usage(MemoryTag::History), 1000u);
+    EXPECT_EQ(budget.total_usage(), 4072u);
+    EXPECT_STREQ(tag_name(MemoryTag::DirectoryCache), "directory-cache");
+}
+
+TEST(MemoryBudgetTest, ShrinksInPriorityOrderUpToLevel) {
+    MemoryBudget budget;
+    std::vector<std::string> calls;
+    auto record = [&calls](const char* name) {
+        return [&calls, name](PressureLevel) { calls.push_back(name); return size_t(1); };
+    };
+    budget.register_cache("visible", MemoryTag::Scrollback, CachePriority::UserVisible,
+                          record("visible"));
+    budget.register_cache("pool", MemoryTag::ProcessPool, CachePriority::Disposable,
+                          record("pool"));
+    auto mapped = budget.register_cache("mapped", MemoryTag::History,
+                                        CachePriority::Recomputable, record("mapped"));
+
+    EXPECT_EQ(budget.shrink(PressureLevel::Moderate), 1u);
+    EXPECT_EQ(calls, (std::vector<std::string>{"pool"}));
+
+    calls.clear();
+    EXPECT_EQ(budget.shrink(PressureLevel::Critical), 3u);
+    EXPECT_EQ(calls, (std::vector<std::string>{"pool", "mapped", "visible"}));
+
+    calls.clear();
+    budget.unregister_cache(mapped);
+    budget.shrink(PressureLevel::Severe);
+    EXPECT_EQ(calls, (std::vector<std::string>{"pool"}));
+    EXPECT_EQ(budget.get_stats().shrink_passes, 3u);
+}
+
+TEST(MemoryBudgetTest, MapsAndroidTrimLevels) {
+    EXPECT_EQ(MemoryBudget::level_from_trim(0), PressureLevel::None);
+    EXPECT_EQ(MemoryBudget::level_from_trim(5), PressureLevel::Moderate);    // RUNNING_MODERATE
+    EXPECT_EQ(MemoryBudget::level_from_trim(10), PressureLevel::Severe);     // RUNNING_LOW
+    EXPECT_EQ(MemoryBudget::level_from_trim(15), PressureLevel::Critical);   // RUNNING_CRITICAL
+    EXPECT_EQ(MemoryBudget::level_from_trim(20), PressureLevel::Moderate);   // UI_HIDDEN
+    EXPECT_EQ(MemoryBudget::level_from_trim(60), PressureLevel::Severe);     // MODERATE
+    EXPECT_EQ(MemoryBudget::level_from_trim(80), PressureLevel::Critical);   // COMPLETE
+}
+
+TEST(MemoryBudgetTest, ParsesPressureStallInformation) {
+    const std::string text =
+        "some avg10=24.50 avg60=3.10 avg300=0.80 total=123456\n"
+        "full avg10=1.25 avg60=0.40 avg300=0.10 total=4567\n";
+    PsiMonitor::PsiStats stats;
+    ASSERT_TRUE(PsiMonitor::parse(text, stats));
+    EXPECT_DOUBLE_EQ(stats.some_avg10, 24.5);
+    EXPECT_DOUBLE_EQ(stats.full_avg10, 1.25);
+    EXPECT_EQ(stats.some_total, 123456u);
+    EXPECT_EQ(stats.full_total, 4567u);
+    EXPECT_EQ(PsiMonitor::classify(stats), PressureLevel::Severe);
+
+    stats.full_avg10 = 12.0;
+    EXPECT_EQ(PsiMonitor::classify(stats), PressureLevel::Critical);
+    EXPECT_FALSE(PsiMonitor::parse("garbage", stats));
+}
+
+TEST(MemoryBudgetTest, CrossingLimitDispatchesShrink) {
+    MemoryBudget budget;
+    std::vector<std::function<void()>> queued;
+    budget.set_dispatcher([&queued](std::function<void()> task) {
+        queued.push_back(std::move(task));
+        return true;
+    });
+
+    size_t cached = 8192;
+    budget.charge(MemoryTag::DirectoryCache, cached);
+    budget.register_cache("dirs", MemoryTag::DirectoryCache, CachePriority::Recomputable,
+        [&](PressureLevel) {
+            budget.release(MemoryTag::DirectoryCache, cached);
+            return std::exchange(cached, 0);
+        });
+
+    budget.set_limit(16384);
+    budget.charge(MemoryTag::Scrollback, 4096);
+    EXPECT_TRUE(queued.empty());
+
+    budget.charge(MemoryTag::Scrollback, 8192);
+    budget.charge(MemoryTag::Scrollback, 8192);
+    ASSERT_EQ(queued.size(), 1u);   // One pending pass, not one per charge
+
+    queued.front()();
+    EXPECT_EQ(budget.usage(MemoryTag::DirectoryCache), 0u);
+    EXPECT_LE(budget.total_usage(), 20480u);
+}
+
+TEST(MemoryBudgetTest, SimulatedPressureReleasesResidentMemory) {
+    constexpr size_t BLOB_SIZE = 64 * 1024 * 1024;
+    MemoryBudget budget;
+    BlobCache cache;
+    cache.fill(BLOB_SIZE);
+    budget.charge(MemoryTag::Other, BLOB_SIZE);
+    budget.register_cache("blob", MemoryTag::Other, CachePriority::Recomputable,
+        [&](PressureLevel) {
+            size_t released = cache.drop();
+            budget.release(MemoryTag::Other, released);
+            return released;
+        });
+
+    const size_t before = residentBytes();
+    budget.on_pressure(PressureLevel::Moderate);   // Disposable only: blob survives
+    EXPECT_EQ(cache.size, BLOB_SIZE);
+
+    budget.on_pressure(PressureLevel::Severe);
+    const size_t after = residentBytes();
+
+    EXPECT_EQ(cache.size, 0u);
+    EXPECT_EQ(budget.usage(MemoryTag::Other), 0u);
+    EXPECT_GE(before - std::min(before, after), BLOB_SIZE * 3 / 4);
+    EXPECT_EQ(budget.get_stats().bytes_reclaimed, BLOB_SIZE);
+}
+
+TEST(MemoryBudgetTest, CriticalPressureTrimsSessionScrollback) {
+    using namespace cross_terminal::core;
+    SessionManagerConfig config;
+    config.monitor_memory_pressure = false;
+    SessionManager manager(config);
+    ASSERT_TRUE(manager.initialize());
+
+    auto shell = manager.getSession(manager.createSession());
+    ASSERT_NE(shell, nullptr);
+
+    std::atomic<bool> done{false};
+    int pid = shell->executeAsync("head -c 3000000 /dev/zero", ExecutionOptions(), nullptr,
+                                  [&done](const ProcessInfo&) { done.store(true); });
+    ASSERT_GT(pid, 0);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!done.load() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(done.load());
+
+    auto& budget = MemoryBudget::instance();
+    const size_t scrollback = budget.usage(MemoryTag::Scrollback);
+    const size_t rss = residentBytes();
+    ASSERT_GE(scrollback, 3000000u);
+
+    budget.shrink(PressureLevel::Critical);
+
+    EXPECT_LE(budget.usage(MemoryTag::Scrollback) + 2000000, scrollback);
+    EXPECT_LT(residentBytes(), rss);
+    EXPECT_EQ(shell->readOutput(pid).size(), SessionManager::CRITICAL_SCROLLBACK_BYTES);
+
+    manager.shutdown();
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "platform/network_monitor.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstring>
+#include <linux/if_link.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Builds a buffer of rtnetlink messages as the kernel would send them
+class NetlinkBuffer {
+public:
+    NetlinkBuffer& link(int type, int index, const std::string& name, unsigned flags,
+                        uint64_t rxBytes = 0, uint64_t txBytes = 0) {
+        size_t start = begin(type, sizeof(ifinfomsg));
+        ifinfomsg info = {};
+        info.ifi_family = AF_UNSPEC;
+        info.ifi_index = index;
+        info.ifi_flags = flags;
+        memcpy(&m_data[start + NLMSG_HDRLEN], &info, sizeof(info));
+        attribute(start, IFLA_IFNAME, name.c_str(), name.size() + 1);
+        uint32_t mtu = 1500;
+        attribute(start, IFLA_MTU, &mtu, sizeof(mtu));
+        rtnl_link_stats64 stats = {};
+        stats.rx_bytes = rxBytes;
+        stats.tx_bytes = txBytes;
+        attribute(start, IFLA_STATS64, &stats, sizeof(stats));
+        return *this;
+    }
+
+    NetlinkBuffer& address(int type, int index, int family, const std::string& text, uint8_t prefix) {
+        size_t start = begin(type, sizeof(ifaddrmsg));
+        ifaddrmsg ifa = {};
+        ifa.ifa_family = static_cast<uint8_t>(family);
+        ifa.ifa_prefixlen = prefix;
+        ifa.ifa_index = static_cast<uint32_t>(index);
+        memcpy(&m_data[start + NLMSG_HDRLEN], &ifa, sizeof(ifa));
+        unsigned char raw[16];
+        inet_pton(family, text.c_str(), raw);
+        attribute(start, IFA_ADDRESS, raw, family == AF_INET ? 4 : 16);
+        return *this;
+    }
+
+    void deliver(NetworkMonitor& monitor, Clock::time_point now) {
+        monitor.handleMessages(m_data.data(), m_data.size(), now);
+        m_data.clear();
+    }
+
+private:
+    std::vector<char> m_data;
+
+    size_t begin(int type, size_t payload) {
+        size_t start = m_data.size();
+        m_data.resize(start + NLMSG_SPACE(payload));
+        auto* header = reinterpret_cast<nlmsghdr*>(&m_data[start]);
+        header->nlmsg_len = static_cast<uint32_t>(NLMSG_LENGTH(payload));
+        header->nlmsg_type = static_cast<uint16_t>(type);
+        return start;
+    }
+
+    void attribute(size_t start, int type, const void* data, size_t size) {
+        size_t offset = m_data.size();
+        m_data.resize(offset + RTA_SPACE(size));
+        auto* rta = reinterpret_cast<rtattr*>(&m_data[offset]);
+        rta->rta_type = static_cast<uint16_t>(type);
+        rta->rta_len = static_cast<uint16_t>(RTA_LENGTH(size));
+        memcpy(RTA_DATA(rta), data, size);
+        reinterpret_cast<nlmsghdr*>(&m_data[start])->nlmsg_len = static_cast<uint32_t>(m_data.size() - start);
+    }
+};
+
+} // namespace
+
+TEST(NetworkMonitorTest, FollowsLinksAndAddresses) {
+    NetworkMonitor monitor;
+    int changes = 0;
+    monitor.setChangeCallback([&changes](const NetworkSnapshot&) { ++changes; });
+    const auto now = Clock::now();
+
+    NetlinkBuffer()
+        .link(RTM_NEWLINK, 1, "lo", IFF_UP | IFF_RUNNING | IFF_LOOPBACK)
+        .link(RTM_NEWLINK, 3, "wlan0", IFF_UP | IFF_RUNNING)
+        .address(RTM_NEWADDR, 1, AF_INET, "127.0.0.1", 8)
+        .address(RTM_NEWADDR, 3, AF_INET6, "fe80::1", 64)
+        .address(RTM_NEWADDR, 3, AF_INET, "192.168.1.20", 24)
+        .deliver(monitor, now);
+    EXPECT_EQ(changes, 1);   // One callback per batch
+
+    EXPECT_EQ(monitor.getInterfaceNames(), (std::vector<std::string>{"lo", "wlan0"}));
+    EXPECT_EQ(monitor.getPrimaryIPv4(), "192.168.1.20");
+    NetworkInterfaceInfo wlan;
+    ASSERT_TRUE(monitor.getInterface("wlan0", wlan));
+    EXPECT_EQ(wlan.index, 3);
+    EXPECT_EQ(wlan.mtu, 1500u);
+    ASSERT_EQ(wlan.addresses.size(), 2u);
+    EXPECT_EQ(wlan.addresses[1].prefixLength, 24);
+
+    // Losing the address, then the interface
+    NetlinkBuffer().address(RTM_DELADDR, 3, AF_INET, "192.168.1.20", 24).deliver(monitor, now);
+    EXPECT_EQ(monitor.getPrimaryIPv4(), "");
+    NetlinkBuffer().link(RTM_DELLINK, 3, "wlan0", 0).deliver(monitor, now);
+    EXPECT_EQ(monitor.getInterfaceNames(), std::vector<std::string>{"lo"});
+    EXPECT_FALSE(monitor.getInterface("wlan0", wlan));
+    EXPECT_EQ(changes, 3);
+}
+
+TEST(NetworkMonitorTest, DerivesRatesFromCounterDumps) {
+    NetworkMonitor monitor;
+    int changes = 0;
+    monitor.setChangeCallback([&changes](const NetworkSnapshot&) { ++changes; });
+    const auto start = Clock::now();
+
+    NetlinkBuffer().link(RTM_NEWLINK, 2, "eth0", IFF_UP | IFF_RUNNING, 1000, 500).deliver(monitor, start);
+    const uint64_t generation = monitor.snapshot()->generation;
+    NetlinkBuffer()
+        .link(RTM_NEWLINK, 2, "eth0", IFF_UP | IFF_RUNNING, 3000, 1500)
+        .deliver(monitor, start + std::chrono::seconds(2));
+    EXPECT_EQ(changes, 1);   // Counter updates publish without a callback
+    EXPECT_GT(monitor.snapshot()->generation, generation);
+
+    NetworkInterfaceInfo eth;
+    ASSERT_TRUE(monitor.getInterface("eth0", eth));
+    EXPECT_EQ(eth.rxBytes, 3000u);
+    EXPECT_DOUBLE_EQ(eth.rxBytesPerSecond, 1000.0);
+    EXPECT_DOUBLE_EQ(eth.txBytesPerSecond, 500.0);
+
+    // An update right after a dump keeps the last rate
+    NetlinkBuffer()
+        .link(RTM_NEWLINK, 2, "eth0", IFF_UP | IFF_RUNNING, 3010, 1500)
+        .deliver(monitor, start + std::chrono::milliseconds(2010));
+    ASSERT_TRUE(monitor.getInterface("eth0", eth));
+    EXPECT_DOUBLE_EQ(eth.rxBytesPerSecond, 1000.0);
+
+    // A reset counter (driver reload) is not a huge negative rate
+    NetlinkBuffer()
+        .link(RTM_NEWLINK, 2, "eth0", IFF_UP, 10, 10)
+        .deliver(monitor, start + std::chrono::seconds(3));
+    ASSERT_TRUE(monitor.getInterface("eth0", eth));
+    EXPECT_DOUBLE_EQ(eth.rxBytesPerSecond, 0.0);
+    EXPECT_FALSE(eth.running);
+    EXPECT_EQ(changes, 2);
+}
+
+TEST(NetworkMonitorTest, LoadsLiveInterfaces) {
+    NetworkMonitor monitor;
+    std::string error;
+    if (!monitor.start(std::chrono::milliseconds(100), &error)) {
+        GTEST_SKIP() << "rtnetlink unavailable: " << error;
+    }
+    auto names = monitor.getInterfaceNames();
+    EXPECT_NE(std::find(names.begin(), names.end(), "lo"), names.end());
+
+    // Statistics dumps keep coming without any interface change
+    const auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (monitor.getStatsDumps() < 2 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT_GE(monitor.getStatsDumps(), 2u);
+    monitor.stop();
+    EXPECT_FALSE(monitor.isRunning());
+}
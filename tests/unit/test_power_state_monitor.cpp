@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "hardware/power_state_monitor.h"
+#include "hardware/uevent_monitor.h"
+#include "fake_sysfs.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+UeventMessage supplyChange(const std::string& name,
+                           std::vector<std::pair<std::string, std::string>> properties) {
+    UeventMessage message;
+    message.action = "change";
+    message.subsystem = "power_supply";
+    message.devpath = "/devices/platform/soc/power_supply/" + name;
+    message.properties = std::move(properties);
+    return message;
+}
+
+} // namespace
+
+class PowerStateMonitorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        sysfs.write("sys/class/power_supply/usb/type", "USB");
+        sysfs.write("sys/class/power_supply/bms/type", "Battery");   // Fuel gauge, not "battery"
+        sysfs.write("sys/class/power_supply/battery/type", "Battery");
+        sysfs.write("sys/class/power_supply/battery/capacity", "64");
+        sysfs.write("sys/class/power_supply/battery/status", "Discharging");
+        sysfs.write("sys/class/power_supply/battery/temp", "287");
+    }
+
+    FakeSysfs sysfs;
+};
+
+TEST_F(PowerStateMonitorTest, ReadsInitialStateFromSysfs) {
+    PowerStateMonitor power(sysfs.path("sys"));
+    power.refresh();
+    PowerState state = power.getState();
+    EXPECT_TRUE(state.batteryPresent);
+    EXPECT_FLOAT_EQ(state.batteryLevel, 64.0f);
+    EXPECT_FALSE(state.isCharging);
+    EXPECT_FLOAT_EQ(state.batteryTemperature, 28.7f);
+    EXPECT_EQ(state.updates, 1u);
+
+    // No battery at all: the defaults getBatteryInfo() always reported
+    FakeSysfs desktop;
+    desktop.write("sys/class/power_supply/AC/type", "Mains");
+    PowerStateMonitor mains(desktop.path("sys"));
+    mains.refresh();
+    EXPECT_FALSE(mains.getState().batteryPresent);
+    EXPECT_FLOAT_EQ(mains.getState().batteryLevel, 50.0f);
+}
+
+TEST_F(PowerStateMonitorTest, AppliesBatteryEventsWithoutReadingSysfs) {
+    PowerStateMonitor power(sysfs.path("sys"));
+    power.refresh();
+    UeventMonitor monitor;
+    power.attach(monitor);
+
+    std::vector<PowerState> pushed;
+    power.setListener([&pushed](const PowerState& state) { pushed.push_back(state); });
+    const uint64_t reads = power.getSysfsReads();
+
+    monitor.dispatch(supplyChange("battery", {{"POWER_SUPPLY_STATUS", "Charging"},
+                                              {"POWER_SUPPLY_CAPACITY", "65"},
+                                              {"POWER_SUPPLY_TEMP", "301"}}));
+    ASSERT_EQ(pushed.size(), 1u);
+    EXPECT_TRUE(pushed[0].isCharging);
+    EXPECT_FLOAT_EQ(pushed[0].batteryLevel, 65.0f);
+    EXPECT_FLOAT_EQ(pushed[0].batteryTemperature, 30.1f);
+    EXPECT_EQ(power.getSysfsReads(), reads);
+
+    // A repeat of the same values is not a change
+    monitor.dispatch(supplyChange("battery", {{"POWER_SUPPLY_STATUS", "Charging"},
+                                              {"POWER_SUPPLY_CAPACITY", "65"},
+                                              {"POWER_SUPPLY_TEMP", "301"}}));
+    EXPECT_EQ(pushed.size(), 1u);
+
+    // Charger unplugged: its event triggers one status read
+    sysfs.write("sys/class/power_supply/battery/status", "Discharging");
+    monitor.dispatch(supplyChange("usb", {{"POWER_SUPPLY_ONLINE", "0"}}));
+    ASSERT_EQ(pushed.size(), 2u);
+    EXPECT_FALSE(pushed[1].isCharging);
+    EXPECT_EQ(power.getSysfsReads(), reads + 1);
+
+    power.detach();
+    monitor.dispatch(supplyChange("battery", {{"POWER_SUPPLY_STATUS", "Full"},
+                                              {"POWER_SUPPLY_CAPACITY", "100"}}));
+    EXPECT_EQ(pushed.size(), 2u);
+}
+
+TEST_F(PowerStateMonitorTest, PushesThermalTripsAndResyncs) {
+    UeventMonitor monitor;
+    PowerStateMonitor power(sysfs.path("sys"));
+    power.refresh();
+    power.attach(monitor);
+    int calls = 0;
+    power.setListener([&calls](const PowerState&) { ++calls; });
+
+    UeventMessage trip;
+    trip.action = "change";
+    trip.subsystem = "thermal";
+    trip.devpath = "/devices/virtual/thermal/thermal_zone7";
+    trip.properties = {{"NAME", "cpu-1-0"}, {"TEMP", "95000"}, {"TRIP", "1"}};
+    monitor.dispatch(trip);
+    monitor.dispatch(trip);   // Crossing the same trip again is still pushed
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(power.getState().thermalZone, 7);
+    EXPECT_FLOAT_EQ(power.getState().thermalTemperature, 95.0f);
+
+    // After lost events the state is reread once, however many subscriptions see it
+    sysfs.write("sys/class/power_supply/battery/capacity", "12");
+    const uint64_t reads = power.getSysfsReads();
+    UeventMessage resync;
+    resync.action = UeventMonitor::RESYNC_ACTION;
+    monitor.dispatch(resync);
+    EXPECT_FLOAT_EQ(power.getState().batteryLevel, 12.0f);
+    EXPECT_EQ(calls, 3);
+    EXPECT_EQ(power.getSysfsReads(), reads + 3 + 4);   // Three type probes, four battery attributes
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "core/implementations/process_pool.h"
+#include "core/implementations/shell_impl.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace cross_terminal::core;
+
+namespace {
+
+bool runToCompletion(ManagedProcess& process, int timeout_ms = 5000) {
+    std::atomic<bool> done{false};
+    process.setCompletionCallback([&done](const ProcessInfo&) { done.store(true); });
+    if (!process.start(ExecutionOptions())) {
+        return false;
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!done.load() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return done.load();
+}
+
+} // namespace
+
+TEST(ProcessPoolTest, ReleasedObjectIsReused) {
+    ProcessPool pool(4);
+    ManagedProcess* first = nullptr;
+    {
+        auto process = pool.acquire(1, "true", {"a", "b"});
+        first = process.get();
+    }
+    EXPECT_EQ(pool.getStats().idle, 1u);
+
+    auto process = pool.acquire(2, "false", {});
+    EXPECT_EQ(process.get(), first);
+
+    auto stats = pool.getStats();
+    EXPECT_EQ(stats.acquired, 2u);
+    EXPECT_EQ(stats.reused, 1u);
+    EXPECT_EQ(stats.idle, 0u);
+
+    ProcessInfo info = process->getInfo();
+    EXPECT_EQ(info.pid, 2);
+    EXPECT_EQ(info.command, "false");
+    EXPECT_TRUE(info.arguments.empty());
+    EXPECT_EQ(info.state, ProcessState::NotStarted);
+}
+
+TEST(ProcessPoolTest, CapacityBoundsIdleObjects) {
+    ProcessPool pool(2);
+    {
+        auto a = pool.acquire(1, "a", {});
+        auto b = pool.acquire(2, "b", {});
+        auto c = pool.acquire(3, "c", {});
+    }
+    auto stats = pool.getStats();
+    EXPECT_EQ(stats.idle, 2u);
+    EXPECT_EQ(stats.discarded, 1u);
+
+    pool.setCapacity(0);
+    EXPECT_EQ(pool.getStats().idle, 0u);
+    pool.acquire(4, "d", {}).reset();
+    EXPECT_EQ(pool.getStats().idle, 0u);
+}
+
+TEST(ProcessPoolTest, RecycledProcessStartsClean) {
+    IoReactor reactor(1);
+    ASSERT_TRUE(reactor.start());
+    ProcessPool pool(1);
+    {
+        auto process = pool.acquire(1, "/bin/echo", {"first"}, &reactor);
+        ASSERT_TRUE(runToCompletion(*process));
+        EXPECT_EQ(process->readOutput(), "first\n");
+    }
+
+    for (int i = 2; i < 5; ++i) {
+        auto process = pool.acquire(i, "/bin/echo", {"next"}, &reactor);
+        EXPECT_FALSE(process->hasOutput());
+        ASSERT_TRUE(runToCompletion(*process));
+        EXPECT_EQ(process->readOutput(), "next\n");
+        EXPECT_EQ(process->getInfo().exit_code, 0);
+    }
+    EXPECT_EQ(pool.getStats().reused, 3u);
+
+    reactor.stop();
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "core/implementations/process_terminator.h"
+#include "core/implementations/shell_impl.h"
+#include "core/session_manager.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace cross_terminal::core;
+
+class ProcessTerminatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        reactor = std::make_unique<IoReactor>(2);
+        ASSERT_TRUE(reactor->start());
+    }
+
+    void TearDown() override {
+        processes.clear();
+        reactor->stop();
+    }
+
+    ManagedProcess* spawn(const std::string& command, const ArgumentList& args) {
+        auto process = std::make_unique<ManagedProcess>(
+            static_cast<int>(processes.size()) + 1, command, args, reactor.get());
+        EXPECT_TRUE(process->start(ExecutionOptions()));
+        processes.push_back(std::move(process));
+        return processes.back().get();
+    }
+
+    std::vector<ManagedProcess*> targets() const {
+        std::vector<ManagedProcess*> result;
+        for (const auto& process : processes) {
+            result.push_back(process.get());
+        }
+        return result;
+    }
+
+    std::unique_ptr<IoReactor> reactor;
+    std::vector<std::unique_ptr<ManagedProcess>> processes;
+};
+
+TEST_F(ProcessTerminatorTest, TerminatesAllProcessesConcurrently) {
+    constexpr int PROCESS_COUNT = 20;
+    for (int i = 0; i < PROCESS_COUNT; ++i) {
+        spawn("sleep", {"30"});
+    }
+
+    ProcessTerminator terminator(reactor.get());
+    auto report = terminator.terminate(targets(), 2000);
+
+    EXPECT_EQ(report.processes, PROCESS_COUNT);
+    EXPECT_EQ(report.exited, PROCESS_COUNT);
+    EXPECT_EQ(report.killed, 0);
+    EXPECT_LT(report.duration_us, 1000000u);
+
+    for (const auto& process : processes) {
+        EXPECT_TRUE(process->isReaped());
+        EXPECT_EQ(process->getInfo().state, ProcessState::Terminated);
+    }
+}
+
+TEST_F(ProcessTerminatorTest, KillsStragglersAtDeadline) {
+    std::atomic<bool> ready{false};
+    auto* stubborn = spawn("sh", {"-c", "trap '' TERM; echo ready; sleep 30"});
+    stubborn->setOutputCallback([&](const std::string&, bool) { ready.store(true); });
+    spawn("sleep", {"30"});
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!ready.load() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_TRUE(ready.load());
+
+    ProcessTerminator terminator(reactor.get());
+    auto report = terminator.terminate(targets(), 200);
+
+    EXPECT_EQ(report.processes, 2);
+    EXPECT_EQ(report.exited, 1);
+    EXPECT_EQ(report.killed, 1);
+    EXPECT_GE(report.duration_us, 200000u);
+    EXPECT_LT(report.duration_us, 1500000u);
+    EXPECT_TRUE(stubborn->isReaped());
+}
+
+TEST_F(ProcessTerminatorTest, PollsWithoutReactor) {
+    spawn("sleep", {"30"});
+    spawn("sleep", {"30"});
+
+    ProcessTerminator terminator;
+    auto report = terminator.terminate(targets(), 2000);
+
+    EXPECT_EQ(report.processes, 2);
+    EXPECT_EQ(report.exited, 2);
+    EXPECT_EQ(report.killed, 0);
+}
+
+TEST_F(ProcessTerminatorTest, SkipsAlreadyReapedProcesses) {
+    auto* process = spawn("true", {});
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!process->isReaped() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_TRUE(process->isReaped());
+
+    ProcessTerminator terminator(reactor.get());
+    auto report = terminator.terminate(targets(), 1000);
+
+    EXPECT_EQ(report.processes, 0);
+    EXPECT_EQ(report.killed, 0);
+}
+
+TEST(SessionManagerShutdownTest, ShutdownTimeIndependentOfJobCount) {
+    SessionManagerConfig config;
+    config.shutdown_grace_ms = 2000;
+    SessionManager manager(config);
+    ASSERT_TRUE(manager.initialize());
+
+    for (int session = 0; session < 5; ++session) {
+        auto shell = manager.getSession(manager.createSession());
+        for (int job = 0; job < 10; ++job) {
+            ASSERT_GT(shell->executeAsync("sleep 30", ExecutionOptions(), nullptr, nullptr), 0);
+        }
+    }
+
+    manager.shutdown();
+    auto report = manager.getLastShutdownReport();
+
+    EXPECT_EQ(report.processes, 50);
+    EXPECT_EQ(report.exited, 50);
+    EXPECT_LT(report.duration_us, 1000000u);
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "hardware/pwm_controller.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+
+class PWMControllerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char root[] = "/tmp/ct_pwmXXXXXX";
+        sysfs_root = mkdtemp(root);
+        mkdir((sysfs_root + "/pwmchip0").c_str(), 0755);
+        std::ofstream(sysfs_root + "/pwmchip0/export");
+        std::ofstream(sysfs_root + "/pwmchip0/unexport");
+    }
+
+    void TearDown() override {
+        std::system(("rm -rf " + sysfs_root).c_str());
+    }
+
+    // Regular files standing in for an exported channel's attributes
+    void makeChannel(int channel, uint64_t period, uint64_t duty) {
+        const std::string dir = channelPath(channel);
+        mkdir(dir.c_str(), 0755);
+        std::ofstream(dir + "/period") << period << "\n";
+        std::ofstream(dir + "/duty_cycle") << duty << "\n";
+        std::ofstream(dir + "/enable") << "0\n";
+        std::ofstream(dir + "/polarity") << "normal\n";
+    }
+
+    std::string channelPath(int channel) const {
+        return sysfs_root + "/pwmchip0/pwm" + std::to_string(channel);
+    }
+
+    // First line only: in-place rewrites of a regular file leave the tail
+    // of longer previous values behind the newline
+    std::string attribute(const std::string& path) const {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    std::string sysfs_root;
+};
+
+TEST_F(PWMControllerTest, WritesThroughPersistentHandles) {
+    makeChannel(0, 40000, 0);
+    PWMChannel channel(0, 0, sysfs_root);
+    ASSERT_TRUE(channel.open());
+    EXPECT_EQ(channel.getPeriod(), 40000u);
+
+    EXPECT_TRUE(channel.setPeriod(20000));
+    EXPECT_TRUE(channel.setDutyCycle(15000));
+    EXPECT_TRUE(channel.setPolarity(PWMPolarity::Inversed));
+    EXPECT_TRUE(channel.enable(true));
+    EXPECT_EQ(attribute(channelPath(0) + "/period"), "20000");
+    EXPECT_EQ(attribute(channelPath(0) + "/duty_cycle"), "15000");
+    EXPECT_EQ(attribute(channelPath(0) + "/polarity"), "inversed");
+    EXPECT_EQ(attribute(channelPath(0) + "/enable"), "1");
+
+    // Repeating the programmed value costs no write
+    const uint64_t writes = channel.getWriteCount();
+    EXPECT_TRUE(channel.setDutyCycle(15000));
+    EXPECT_TRUE(channel.enable(true));
+    EXPECT_EQ(channel.getWriteCount(), writes);
+
+    EXPECT_TRUE(channel.setDutyFraction(0.25f));
+    EXPECT_EQ(channel.getDutyCycle(), 5000u);
+    EXPECT_FALSE(channel.setDutyCycle(30000));   // Longer than the period
+
+    // Shrinking the period below the duty cycle clamps the duty cycle first
+    EXPECT_TRUE(channel.setPeriod(4000));
+    EXPECT_EQ(channel.getDutyCycle(), 4000u);
+    EXPECT_EQ(attribute(channelPath(0) + "/duty_cycle"), "4000");
+}
+
+TEST_F(PWMControllerTest, ExportsMissingChannel) {
+    PWMChannel channel(0, 3, sysfs_root);
+    EXPECT_FALSE(channel.open());   // Nothing creates pwm3 in the fake tree
+    EXPECT_EQ(attribute(sysfs_root + "/pwmchip0/export"), "3");
+    EXPECT_EQ(attribute(sysfs_root + "/pwmchip0/unexport"), "3");
+    EXPECT_FALSE(channel.setDutyCycle(0));
+
+    makeChannel(1, 1000, 0);
+    PWMChannel existing(0, 1, sysfs_root);
+    std::ofstream(sysfs_root + "/pwmchip0/unexport", std::ios::trunc);
+    ASSERT_TRUE(existing.open());
+    existing.close();
+    EXPECT_EQ(attribute(sysfs_root + "/pwmchip0/unexport"), "");   // Not ours to unexport
+}
+
+TEST_F(PWMControllerTest, RampStepsManyChannels) {
+    PWMRampScheduler scheduler;
+    std::vector<std::shared_ptr<PWMChannel>> channels;
+    for (int i = 0; i < 8; ++i) {
+        makeChannel(i, 1000, 0);
+        channels.push_back(std::make_shared<PWMChannel>(0, i, sysfs_root));
+        ASSERT_TRUE(channels.back()->open());
+    }
+
+    int done = 0;
+    for (auto& channel : channels) {
+        scheduler.ramp(channel, 1000, std::chrono::milliseconds(100), PWMEasing::Linear,
+                       [&done]() { ++done; });
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(scheduler.step(start + std::chrono::milliseconds(50)), 8u);
+    for (auto& channel : channels) {
+        EXPECT_NEAR(static_cast<double>(channel->getDutyCycle()), 500.0, 20.0);
+    }
+
+    // Replacing a ramp continues from where the old one got to
+    scheduler.ramp(channels[0], 0, std::chrono::milliseconds(0));
+    EXPECT_EQ(scheduler.activeRamps(), 8u);
+
+    EXPECT_EQ(scheduler.step(start + std::chrono::milliseconds(200)), 8u);
+    EXPECT_EQ(scheduler.activeRamps(), 0u);
+    EXPECT_EQ(done, 7);
+    EXPECT_EQ(channels[0]->getDutyCycle(), 0u);
+    EXPECT_EQ(attribute(channelPath(7) + "/duty_cycle"), "1000");
+
+    auto metrics = scheduler.getMetrics();
+    EXPECT_EQ(metrics.writes, 16u);
+    EXPECT_EQ(metrics.completed, 8u);
+    EXPECT_EQ(metrics.failures, 0u);
+}
+
+TEST_F(PWMControllerTest, RampThreadReachesTarget) {
+    makeChannel(0, 255, 0);
+    auto channel = std::make_shared<PWMChannel>(0, 0, sysfs_root);
+    ASSERT_TRUE(channel->open());
+
+    PWMRampScheduler scheduler(std::chrono::milliseconds(1));
+    scheduler.start();
+    scheduler.fade(channel, 1.0f, std::chrono::milliseconds(30));
+    ASSERT_TRUE(scheduler.waitIdle(std::chrono::seconds(5)));
+    EXPECT_EQ(channel->getDutyCycle(), 255u);
+
+    scheduler.fade(channel, 0.0f, std::chrono::seconds(10));
+    EXPECT_TRUE(scheduler.cancel(channel.get()));
+    EXPECT_FALSE(scheduler.cancel(channel.get()));
+    scheduler.stop();
+    EXPECT_GT(scheduler.getMetrics().ticks, 0u);
+}
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include "core/implementations/serial_session.h"
+#include "core/session_manager.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace cross_terminal::core;
+
+// A pty pair stands in for the UART: the slave is the "device" the
+// session opens, the master is the far end of the line
+class SerialSessionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        ASSERT_GE(master, 0);
+        ASSERT_EQ(grantpt(master), 0);
+        ASSERT_EQ(unlockpt(master), 0);
+        device = ptsname(master);
+    }
+
+    void TearDown() override {
+        if (master >= 0) {
+            close(master);
+        }
+    }
+
+    SerialConfig config(uint32_t baud_rate) const {
+        SerialConfig serial;
+        serial.device = device;
+        serial.baud_rate = baud_rate;
+        return serial;
+    }
+
+    std::string readMaster(size_t size) {
+        std::string data;
+        char buffer[4096];
+        while (data.size() < size) {
+            ssize_t n = read(master, buffer, sizeof(buffer));
+            if (n <= 0) {
+                break;
+            }
+            data.append(buffer, n);
+        }
+        return data;
+    }
+
+    int master = -1;
+    std::string device;
+};
+
+TEST_F(SerialSessionTest, StreamsLargeTransferWithoutLoss) {
+    SessionManagerConfig runtime;
+    runtime.monitor_memory_pressure = false;
+    SessionManager manager(runtime);
+    ASSERT_TRUE(manager.initialize());
+
+    std::string error;
+    auto id = manager.createSerialSession(config(3000000), &error);
+    ASSERT_GE(id, 0) << error;
+    auto serial = manager.getSerialSession(id);
+    ASSERT_NE(serial, nullptr);
+    EXPECT_EQ(serial->getBaudRate(), 3000000u);
+    EXPECT_EQ(manager.getSession(id), nullptr);
+    EXPECT_EQ(manager.getSessionCount(), 1u);
+    EXPECT_TRUE(manager.setForegroundSession(id));
+    EXPECT_TRUE(serial->isForeground());
+
+    std::mutex mutex;
+    std::condition_variable received;
+    std::string output;
+    serial->setOutputCallback([&](const std::string& data, bool) {
+        std::lock_guard<std::mutex> lock(mutex);
+        output += data;
+        received.notify_all();
+    });
+
+    // 1 MiB with a position-dependent pattern, so loss or reordering shows
+    std::string payload(1024 * 1024, '\0');
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>((i * 131) ^ (i >> 8));
+    }
+    std::thread writer([&]() {
+        size_t offset = 0;
+        while (offset < payload.size()) {
+            ssize_t n = write(master, payload.data() + offset, std::min<size_t>(8192, payload.size() - offset));
+            if (n <= 0) {
+                break;
+            }
+            offset += static_cast<size_t>(n);
+        }
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        received.wait_for(lock, std::chrono::seconds(20), [&]() { return output.size() >= payload.size(); });
+    }
+    writer.join();
+    ASSERT_EQ(output.size(), payload.size());
+    EXPECT_TRUE(output == payload);
+    EXPECT_TRUE(serial->readOutput() == payload);   // Same bytes in scrollback
+
+    // Keystrokes go the other way
+    EXPECT_TRUE(serial->sendInput("AT+RESET\r"));
+    EXPECT_EQ(readMaster(9), "AT+RESET\r");
+
+    auto metrics = serial->getSerialMetrics();
+    EXPECT_EQ(metrics.bytes_read, payload.size());
+    EXPECT_EQ(metrics.bytes_written, 9u);
+    EXPECT_EQ(manager.getSessionMetrics(id).bytes_read, payload.size());
+
+    EXPECT_TRUE(manager.closeSession(id));
+    EXPECT_FALSE(serial->isOpen());
+    EXPECT_EQ(manager.getSessionCount(), 0u);
+}
+
+TEST_F(SerialSessionTest, ProgramsNonStandardBaudRates) {
+    auto reactor = std::make_shared<IoReactor>(1);
+    ASSERT_TRUE(reactor->start());
+    SerialSession serial(reactor);
+
+    std::string error;
+    ASSERT_TRUE(serial.open(config(250000), &error)) << error;   // DMX: no Bxxx constant
+#ifdef __linux__
+    EXPECT_EQ(serial.getBaudRate(), 250000u);
+#endif
+    EXPECT_TRUE(serial.setBaudRate(921600));
+    EXPECT_EQ(serial.getBaudRate(), 921600u);
+    EXPECT_EQ(serial.getConfig().baud_rate, 921600u);
+    EXPECT_FALSE(serial.open(config(9600), &error));   // Already open
+
+    serial.close();
+    EXPECT_FALSE(serial.isOpen());
+    EXPECT_FALSE(serial.sendInput("x"));
+    reactor->stop();
+}
+
+TEST_F(SerialSessionTest, StandaloneCallbackMayWriteBack) {
+    auto reactor = std::make_shared<IoReactor>(1);
+    ASSERT_TRUE(reactor->start());
+    {
+        // No workers: the callback runs on the reactor thread
+        SerialSession serial(reactor);
+        serial.setOutputCallback([&serial](const std::string& data, bool) {
+            serial.sendInput(data);   // A loopback; takes the session lock
+        });
+        ASSERT_TRUE(serial.open(config(115200)));
+
+        ASSERT_EQ(write(master, "ping", 4), 4);
+        pollfd ready{master, POLLIN, 0};
+        ASSERT_EQ(poll(&ready, 1, 5000), 1);
+        EXPECT_EQ(readMaster(4), "ping");
+    }
+    reactor->stop();
+}
+
+TEST_F(SerialSessionTest, HangupClosesSessionAndReportsIt) {
+    auto reactor = std::make_shared<IoReactor>(1);
+    auto workers = std::make_shared<WorkerPool>(1);
+    ASSERT_TRUE(reactor->start());
+    ASSERT_TRUE(workers->start());
+
+    std::atomic<bool> closed{false};
+    {
+        SerialSession serial(reactor, workers);
+        serial.setCloseCallback([&closed](int) { closed = true; });
+        ASSERT_TRUE(serial.open(config(115200)));
+
+        close(master);   // Far end goes away, like an unplugged adapter
+        master = -1;
+        for (int i = 0; i < 400 && !closed; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        EXPECT_TRUE(closed);
+        EXPECT_FALSE(serial.isOpen());
+    }
+    workers->stop();
+    reactor->stop();
+}
+
+TEST_F(SerialSessionTest, RejectsInvalidSettings) {
+    auto reactor = std::make_shared<IoReactor>(1);
+    ASSERT_TRUE(reactor->start());
+    SerialSession serial(reactor);
+
+    std::string error;
+    SerialConfig bad = config(115200);
+    bad.data_bits = 9;
+    EXPECT_FALSE(serial.open(bad, &error));
+    EXPECT_NE(error.find("data bits"), std::string::npos);
+
+    EXPECT_TRUE(serial.open(config(115200)));   // A rejected open leaves the session usable
+    serial.close();
+
+    SerialConfig missing = config(115200);
+    missing.device = "/dev/ttyDOESNOTEXIST";
+    EXPECT_FALSE(serial.open(missing, &error));
+    EXPECT_NE(error.find("/dev/ttyDOESNOTEXIST"), std::string::npos);
+
+    SerialConfig not_a_tty = config(115200);
+    not_a_tty.device = "/dev/null";
+    EXPECT_FALSE(serial.open(not_a_tty, &error));
+    reactor->stop();
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "core/session_manager.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace cross_terminal::core;
+
+class SessionManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        SessionManagerConfig config;
+        config.reactor_threads = 2;
+        config.worker_threads = 2;
+        manager = std::make_unique<SessionManager>(config);
+        ASSERT_TRUE(manager->initialize());
+    }
+
+    void TearDown() override {
+        manager->shutdown();
+        manager.reset();
+    }
+
+    template<typename Predicate>
+    static bool waitFor(Predicate predicate, int timeout_ms = 2000) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (predicate()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return predicate();
+    }
+
+    std::unique_ptr<SessionManager> manager;
+};
+
+TEST_F(SessionManagerTest, CreateAndCloseSessions) {
+    auto first = manager->createSession();
+    auto second = manager->createSession();
+
+    EXPECT_GT(first, 0);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(manager->getSessionCount(), 2);
+    EXPECT_NE(manager->getSession(first), nullptr);
+
+    EXPECT_TRUE(manager->closeSession(first));
+    EXPECT_FALSE(manager->closeSession(first));
+    EXPECT_EQ(manager->getSession(first), nullptr);
+    EXPECT_EQ(manager->getSessionCount(), 1);
+}
+
+TEST_F(SessionManagerTest, ThreadCountIndependentOfSessionCount) {
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_GT(manager->createSession(), 0);
+    }
+
+    auto stats = manager->getStats();
+    EXPECT_EQ(stats.sessions, 50);
+    EXPECT_EQ(stats.reactor_threads, 2);
+    EXPECT_EQ(stats.worker_threads, 2);
+}
+
+TEST_F(SessionManagerTest, ProcessOutputDeliveredThroughSharedReactor) {
+    auto id = manager->createSession();
+    auto shell = manager->getSession(id);
+    ASSERT_NE(shell, nullptr);
+
+    std::atomic<bool> completed{false};
+    std::string output;
+    std::mutex output_mutex;
+
+    // An external command: the echo builtin would answer inline
+    int pid = shell->executeAsync("/bin/echo shared-reactor", ExecutionOptions(),
+        [&](const std::string& data, bool) {
+            std::lock_guard lock(output_mutex);
+            output += data;
+        },
+        [&](const ProcessInfo& info) {
+            EXPECT_EQ(info.exit_code, 0);
+            completed.store(true);
+        });
+
+    ASSERT_GT(pid, 0);
+    EXPECT_TRUE(waitFor([&]() { return completed.load(); }));
+
+    std::lock_guard lock(output_mutex);
+    EXPECT_EQ(output, "shared-reactor\n");
+    EXPECT_EQ(manager->getSessionMetrics(id).bytes_read, output.size());
+}
+
+TEST_F(SessionManagerTest, ClosingSessionReleasesReactorRegistrations) {
+    auto id = manager->createSession();
+    auto shell = manager->getSession(id);
+    ASSERT_NE(shell, nullptr);
+
+    int pid = shell->executeAsync("sleep 10", ExecutionOptions(), nullptr, nullptr);
+    ASSERT_GT(pid, 0);
+    EXPECT_GT(manager->getStats().registered_fds, 0);
+
+    shell.reset();
+    EXPECT_TRUE(manager->closeSession(id));
+    EXPECT_EQ(manager->getStats().registered_fds, 0);
+}
+
+TEST_F(SessionManagerTest, ForegroundSessionSwitching) {
+    auto first = manager->createSession();
+    auto second = manager->createSession();
+
+    EXPECT_EQ(manager->getForegroundSession(), -1);
+    EXPECT_TRUE(manager->setForegroundSession(first));
+    EXPECT_TRUE(manager->getSessionMetrics(first).foreground);
+
+    EXPECT_TRUE(manager->setForegroundSession(second));
+    EXPECT_FALSE(manager->getSessionMetrics(first).foreground);
+    EXPECT_TRUE(manager->getSessionMetrics(second).foreground);
+
+    EXPECT_FALSE(manager->setForegroundSession(12345));
+    EXPECT_EQ(manager->getForegroundSession(), second);
+
+    EXPECT_TRUE(manager->closeSession(second));
+    EXPECT_EQ(manager->getForegroundSession(), -1);
+}
+
+TEST_F(SessionManagerTest, ForegroundEchoStaysResponsiveUnderFlood) {
+    auto flood_id = manager->createSession();
+    auto echo_id = manager->createSession();
+    auto flood = manager->getSession(flood_id);
+    auto echo = manager->getSession(echo_id);
+    ASSERT_TRUE(manager->setForegroundSession(echo_id));
+
+    std::atomic<size_t> echoed{0};
+    int flood_pid = flood->executeAsync("yes", ExecutionOptions(), nullptr, nullptr);
+    int echo_pid = echo->executeAsync("cat", ExecutionOptions(),
+        [&](const std::string& data, bool) { echoed.fetch_add(data.size()); },
+        nullptr);
+    ASSERT_GT(flood_pid, 0);
+    ASSERT_GT(echo_pid, 0);
+
+    constexpr int KEYSTROKES = 20;
+    for (int i = 0; i < KEYSTROKES; ++i) {
+        size_t before = echoed.load();
+        ASSERT_TRUE(echo->sendInput(echo_pid, "k\n"));
+        ASSERT_TRUE(waitFor([&]() { return echoed.load() > before; }));
+    }
+
+    auto echo_metrics = manager->getSessionMetrics(echo_id);
+    auto flood_metrics = manager->getSessionMetrics(flood_id);
+    EXPECT_EQ(echo_metrics.echo_samples, KEYSTROKES);
+    EXPECT_LT(echo_metrics.echo_p99_us, 100000u);
+
+    // The flood was throttled by its budget, not starved
+    EXPECT_GT(flood_metrics.bytes_read, 0u);
+    EXPECT_GT(flood_metrics.budget_yields, 0u);
+
+    flood->terminateProcess(flood_pid, true);
+    echo->terminateProcess(echo_pid, true);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "memory/small_vector.h"
+#include <memory>
+#include <string>
+
+using namespace cross_terminal::memory;
+
+TEST(SmallVectorTest, StaysInlineUpToCapacity) {
+    SmallVector<float, 3> values = {0.0f, 0.0f, 9.8f};
+    EXPECT_TRUE(values.is_inline());
+    EXPECT_EQ(values.size(), 3u);
+    EXPECT_EQ(values.capacity(), 3u);
+    EXPECT_FLOAT_EQ(values[2], 9.8f);
+
+    values = {21.5f};
+    EXPECT_TRUE(values.is_inline());
+    EXPECT_EQ(values.size(), 1u);
+    EXPECT_FLOAT_EQ(values.front(), 21.5f);
+}
+
+TEST(SmallVectorTest, OverflowMovesToManagedStorage) {
+    SmallVector<std::string, 2> words;
+    for (int i = 0; i < 10; ++i) {
+        words.push_back("word-" + std::to_string(i));
+    }
+    EXPECT_FALSE(words.is_inline());
+    ASSERT_EQ(words.size(), 10u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(words[i], "word-" + std::to_string(i));
+    }
+
+    // Growing from an element of the same vector must not read freed memory
+    SmallVector<std::string, 2> copies = {"a long string that is not stored inline", "b"};
+    copies.push_back(copies[0]);
+    EXPECT_EQ(copies[2], copies[0]);
+}
+
+TEST(SmallVectorTest, MoveStealsHeapAndMovesInline) {
+    SmallVector<std::unique_ptr<int>, 2> small;
+    small.emplace_back(new int(1));
+    SmallVector<std::unique_ptr<int>, 2> moved(std::move(small));
+    EXPECT_TRUE(small.empty());
+    EXPECT_TRUE(moved.is_inline());
+    EXPECT_EQ(*moved[0], 1);
+
+    SmallVector<std::unique_ptr<int>, 2> large;
+    for (int i = 0; i < 5; ++i) {
+        large.emplace_back(new int(i));
+    }
+    const auto* buffer = large.data();
+    moved = std::move(large);
+    EXPECT_EQ(moved.data(), buffer);
+    EXPECT_EQ(moved.size(), 5u);
+    EXPECT_TRUE(large.empty());
+    EXPECT_TRUE(large.is_inline());
+}
+
+TEST(SmallVectorTest, EraseResizeAndCompare) {
+    SmallVector<int, 4> numbers = {1, 2, 3, 4, 5, 6};
+    numbers.erase(numbers.begin() + 1, numbers.begin() + 3);
+    EXPECT_EQ(numbers, (SmallVector<int, 4>{1, 4, 5, 6}));
+
+    numbers.erase(numbers.begin());
+    numbers.pop_back();
+    EXPECT_EQ(numbers, (SmallVector<int, 4>{4, 5}));
+
+    numbers.resize(4, 7);
+    EXPECT_EQ(numbers, (SmallVector<int, 4>{4, 5, 7, 7}));
+    numbers.resize(1);
+    EXPECT_EQ(numbers.size(), 1u);
+    EXPECT_THROW(numbers.at(1), std::out_of_range);
+}
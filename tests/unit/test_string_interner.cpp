@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "memory/string_interner.h"
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace cross_terminal::memory;
+
+TEST(StringInternerTest, EqualContentsShareOneEntry) {
+    std::string built = "/usr/";
+    built += "bin";
+
+    InternedString a("/usr/bin");
+    InternedString b(built);
+    InternedString c("/usr/lib");
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.c_str(), b.c_str());
+    EXPECT_NE(a, c);
+    EXPECT_EQ(a.hash(), b.hash());
+    EXPECT_EQ(a, "/usr/bin");
+    EXPECT_EQ(std::string("/usr/bin"), a);
+    EXPECT_EQ(a.size(), 8u);
+}
+
+TEST(StringInternerTest, EmptyStringNeedsNoEntry) {
+    InternedString empty("");
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty, InternedString());
+    EXPECT_STREQ(empty.c_str(), "");
+}
+
+TEST(StringInternerTest, LastHandleReleasesEntry) {
+    auto& interner = StringInterner::instance();
+    const size_t before = interner.get_stats().unique_strings;
+    {
+        InternedString first("interner-release-test");
+        InternedString copy = first;
+        InternedString moved = std::move(copy);
+        EXPECT_EQ(interner.get_stats().unique_strings, before + 1);
+        first = InternedString();
+        EXPECT_EQ(interner.get_stats().unique_strings, before + 1);
+        EXPECT_EQ(moved, "interner-release-test");
+    }
+    EXPECT_EQ(interner.get_stats().unique_strings, before);
+}
+
+TEST(StringInternerTest, WorksAsHashKey) {
+    std::unordered_set<InternedString> seen;
+    seen.insert("git");
+    seen.insert(std::string("git"));
+    seen.insert("make");
+    EXPECT_EQ(seen.size(), 2u);
+    EXPECT_EQ(seen.count(InternedString("make")), 1u);
+}
+
+TEST(StringInternerTest, ConcurrentInterningConverges) {
+    constexpr int THREADS = 8;
+    constexpr int ITERATIONS = 20000;
+    std::vector<std::vector<const char*>> addresses(THREADS);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t, &addresses]() {
+            for (int i = 0; i < ITERATIONS; ++i) {
+                // Churn short-lived entries alongside one shared, long-lived key
+                InternedString transient("transient-" + std::to_string(i % 64));
+                InternedString shared("shared-key");
+                if (i == ITERATIONS - 1) {
+                    addresses[t].push_back(shared.c_str());
+                }
+            }
+        });
+    }
+    InternedString held("shared-key");
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& per_thread : addresses) {
+        ASSERT_EQ(per_thread.size(), 1u);
+        EXPECT_EQ(per_thread[0], held.c_str());
+    }
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "hardware/thermal_telemetry.h"
+#include "fake_sysfs.h"
+#include <string>
+
+class ThermalTelemetryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        zone(0, "battery", "31000");
+        zone(1, "cpu-1-0", "78500");
+        sysfs.write("sys/class/thermal/thermal_zone1/trip_point_0_type", "passive");
+        sysfs.write("sys/class/thermal/thermal_zone1/trip_point_0_temp", "75000");
+        sysfs.write("sys/class/thermal/thermal_zone1/trip_point_1_type", "critical");
+        sysfs.write("sys/class/thermal/thermal_zone1/trip_point_1_temp", "115000");
+        zone(2, "pa-therm", "-273000");   // Sensor not fitted
+
+        // Little cluster (cpu0-1) and big cluster (cpu2) policies
+        policy("policy0", 1804800, 300000, 1804800, 1804800, "schedutil");
+        policy("policy2", 1209600, 825600, 1497600, 2841600, "schedutil");   // Thermally capped
+        sysfs.link("sys/devices/system/cpu/cpu0/cpufreq", "sys/devices/system/cpu/cpufreq/policy0");
+        sysfs.link("sys/devices/system/cpu/cpu1/cpufreq", "sys/devices/system/cpu/cpufreq/policy0");
+        sysfs.link("sys/devices/system/cpu/cpu2/cpufreq", "sys/devices/system/cpu/cpufreq/policy2");
+        sysfs.write("sys/devices/system/cpu/cpu1/online", "0");
+        sysfs.write("sys/devices/system/cpu/cpu2/online", "1");
+        sysfs.write("sys/devices/system/cpu/cpu2/thermal_throttle/core_throttle_count", "17");
+        sysfs.makeDirectory("sys/devices/system/cpu/cpuidle");   // Not a CPU
+    }
+
+    void zone(int index, const std::string& type, const std::string& temp) {
+        const std::string dir = "sys/class/thermal/thermal_zone" + std::to_string(index);
+        sysfs.write(dir + "/type", type);
+        sysfs.write(dir + "/temp", temp);
+    }
+
+    void policy(const std::string& name, uint32_t cur, uint32_t min, uint32_t max, uint32_t hardwareMax,
+                const std::string& governor) {
+        const std::string dir = "sys/devices/system/cpu/cpufreq/" + name;
+        sysfs.write(dir + "/scaling_cur_freq", std::to_string(cur));
+        sysfs.write(dir + "/scaling_min_freq", std::to_string(min));
+        sysfs.write(dir + "/scaling_max_freq", std::to_string(max));
+        sysfs.write(dir + "/cpuinfo_max_freq", std::to_string(hardwareMax));
+        sysfs.write(dir + "/scaling_governor", governor);
+    }
+
+    FakeSysfs sysfs;
+};
+
+TEST_F(ThermalTelemetryTest, ReportsEveryZoneAndCore) {
+    ThermalTelemetry telemetry(sysfs.path("sys"));
+    ASSERT_TRUE(telemetry.open());
+    EXPECT_EQ(telemetry.zoneCount(), 3u);
+    EXPECT_EQ(telemetry.cpuCount(), 3u);
+
+    ThermalSample sample;
+    telemetry.sample(sample);
+    ASSERT_EQ(sample.zones.size(), 3u);
+    EXPECT_EQ(sample.hottestZone, 1);   // Not zone 0, the first one found
+    EXPECT_FLOAT_EQ(sample.maxTemperature, 78.5f);
+    ASSERT_EQ(sample.zones[1].trips.size(), 2u);
+    EXPECT_EQ(sample.zones[1].trips[1].type, "critical");
+    EXPECT_FLOAT_EQ(sample.zones[1].trips[0].temperature, 75.0f);
+    EXPECT_FALSE(sample.zones[2].valid);
+
+    ASSERT_EQ(sample.cpus.size(), 3u);
+    EXPECT_EQ(sample.cpus[0].currentKHz, 1804800u);
+    EXPECT_FALSE(sample.cpus[0].capped);
+    EXPECT_FALSE(sample.cpus[1].online);
+    EXPECT_EQ(sample.cpus[1].currentKHz, 0u);
+    EXPECT_EQ(sample.cpus[1].maxKHz, 1804800u);
+    EXPECT_EQ(sample.cpus[2].governor, "schedutil");
+    EXPECT_EQ(sample.cpus[2].hardwareMaxKHz, 2841600u);
+    EXPECT_TRUE(sample.cpus[2].capped);
+    EXPECT_EQ(sample.cpus[2].throttleCount, 17u);
+}
+
+TEST_F(ThermalTelemetryTest, SamplesThroughHeldDescriptors) {
+    ThermalTelemetry telemetry(sysfs.path("sys"));
+    ASSERT_TRUE(telemetry.open());
+    // 3 zones, 2 policies x 4, 2 online attributes, 1 throttle counter
+    EXPECT_EQ(telemetry.openDescriptors(), 14u);
+
+    ThermalSample sample;
+    telemetry.sample(sample);
+    const uint64_t perSample = telemetry.getReadCount();
+    EXPECT_EQ(perSample, 14u);   // One pread per held attribute, shared per policy
+
+    // New values are picked up without reopening
+    sysfs.write("sys/class/thermal/thermal_zone0/temp", "96000");
+    sysfs.write("sys/devices/system/cpu/cpufreq/policy2/scaling_cur_freq", "825600");
+    telemetry.sample(sample);
+    EXPECT_EQ(telemetry.getReadCount(), 2 * perSample);
+    EXPECT_EQ(sample.hottestZone, 0);
+    EXPECT_EQ(sample.cpus[2].currentKHz, 825600u);
+
+    telemetry.sample(sample, true);
+    EXPECT_EQ(telemetry.getReadCount(), 2 * perSample + 3);
+    EXPECT_TRUE(sample.cpus.empty());
+
+    telemetry.close();
+    EXPECT_EQ(telemetry.openDescriptors(), 0u);
+    telemetry.sample(sample);   // Reopens on demand
+    EXPECT_EQ(sample.zones.size(), 3u);
+}
+
+TEST(ThermalTelemetryEmptyTest, ReportsMissingTelemetry) {
+    FakeSysfs sysfs;
+    ThermalTelemetry telemetry(sysfs.path("sys"));
+    EXPECT_FALSE(telemetry.open());
+    ThermalSample sample;
+    telemetry.sample(sample);
+    EXPECT_TRUE(sample.zones.empty());
+    EXPECT_EQ(sample.hottestZone, -1);
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include "core/implementations/thread_registry.h"
+#include "core/session_manager.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sched.h>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace cross_terminal::core;
+
+class ThreadRegistryTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        auto& registry = ThreadRegistry::instance();
+        for (int role = 0; role <= static_cast<int>(ThreadRole::Other); ++role) {
+            registry.setPolicy(static_cast<ThreadRole>(role), ThreadPolicy());
+        }
+        registry.loadTopology();
+        if (!sysfs_root.empty()) {
+            std::system(("rm -rf " + sysfs_root).c_str());
+        }
+    }
+
+    // Fake cpuN/cpu_capacity tree: capacities in CPU order
+    std::string makeTopology(const std::vector<int>& capacities) {
+        char root[] = "/tmp/ct_cpusXXXXXX";
+        sysfs_root = mkdtemp(root);
+        for (size_t i = 0; i < capacities.size(); ++i) {
+            const std::string dir = sysfs_root + "/cpu" + std::to_string(i);
+            mkdir(dir.c_str(), 0755);
+            std::ofstream(dir + "/cpu_capacity") << capacities[i];
+        }
+        mkdir((sysfs_root + "/cpufreq").c_str(), 0755);   // Not a CPU
+        return sysfs_root;
+    }
+
+    static std::string threadName(int tid) {
+        std::ifstream comm("/proc/self/task/" + std::to_string(tid) + "/comm");
+        std::string name;
+        std::getline(comm, name);
+        return name;
+    }
+
+    std::string sysfs_root;
+};
+
+TEST_F(ThreadRegistryTest, ClassifiesBigAndLittleCores) {
+    auto& registry = ThreadRegistry::instance();
+    registry.loadTopology(makeTopology({160, 160, 160, 160, 512, 512, 1024, 1024}));
+
+    auto cpus = registry.topology();
+    ASSERT_EQ(cpus.size(), 8u);
+    EXPECT_EQ(cpus[0].core_class, CoreClass::Little);
+    EXPECT_EQ(cpus[4].core_class, CoreClass::Big);
+    EXPECT_EQ(cpus[7].core_class, CoreClass::Big);
+
+    ThreadPolicy little;
+    little.core_class = CoreClass::Little;
+    EXPECT_EQ(registry.resolveCpus(little), (std::vector<int>{0, 1, 2, 3}));
+
+    ThreadPolicy big;
+    big.core_class = CoreClass::Big;
+    EXPECT_EQ(registry.resolveCpus(big), (std::vector<int>{4, 5, 6, 7}));
+    EXPECT_NE(registry.describe().find("big 4-7, little 0-3"), std::string::npos);
+}
+
+TEST_F(ThreadRegistryTest, UniformCoresLeaveClassRequestsUnrestricted) {
+    auto& registry = ThreadRegistry::instance();
+    registry.loadTopology(makeTopology({1024, 1024}));
+
+    ThreadPolicy big;
+    big.core_class = CoreClass::Big;
+    EXPECT_TRUE(registry.resolveCpus(big).empty());
+}
+
+TEST_F(ThreadRegistryTest, EnterNamesPinsAndUnregistersThread) {
+    auto& registry = ThreadRegistry::instance();
+    ThreadPolicy policy;
+    policy.cpus = {0};
+    policy.policy = SchedPolicy::Batch;
+    registry.setPolicy(ThreadRole::Render, policy);
+
+    int tid = 0;
+    ThreadEntry entry;
+    std::string name;
+    std::thread([&]() {
+        auto registration = registry.enter(ThreadRole::Render, "ct-render-test-long-name");
+        tid = ThreadRegistry::currentTid();
+        name = threadName(tid);
+        for (const auto& candidate : registry.snapshot()) {
+            if (candidate.tid == tid) {
+                entry = candidate;
+            }
+        }
+    }).join();
+
+    EXPECT_EQ(name, "ct-render-test-");
+    EXPECT_EQ(entry.tid, tid);
+    EXPECT_EQ(entry.role, ThreadRole::Render);
+    EXPECT_EQ(entry.cpus, (std::vector<int>{0}));
+    EXPECT_EQ(entry.policy, SchedPolicy::Batch);
+    EXPECT_TRUE(entry.error.empty()) << entry.error;
+
+    auto live = registry.snapshot();
+    EXPECT_TRUE(std::none_of(live.begin(), live.end(),
+                             [tid](const ThreadEntry& e) { return e.tid == tid; }));
+}
+
+TEST_F(ThreadRegistryTest, AnyAndInheritUndoEarlierSettings) {
+    auto& registry = ThreadRegistry::instance();
+    cpu_set_t process_set;
+    ASSERT_EQ(sched_getaffinity(getpid(), sizeof(process_set), &process_set), 0);
+    std::vector<int> process_cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &process_set)) {
+            process_cpus.push_back(cpu);
+        }
+    }
+
+    auto entryOf = [&registry](int tid) {
+        for (const auto& entry : registry.snapshot()) {
+            if (entry.tid == tid) {
+                return entry;
+            }
+        }
+        return ThreadEntry();
+    };
+
+    ThreadEntry pinned;
+    ThreadEntry unpinned;
+    std::thread([&]() {
+        ASSERT_TRUE(registry.configure("other.cores=" + std::to_string(process_cpus.back()) +
+                                       " other.policy=batch"));
+        auto registration = registry.enter(ThreadRole::Other, "ct-pin-test");
+        const int tid = ThreadRegistry::currentTid();
+        pinned = entryOf(tid);
+
+        ASSERT_TRUE(registry.configure("other.cores=any other.policy=inherit"));
+        registry.reapply();
+        unpinned = entryOf(tid);
+    }).join();
+
+    EXPECT_EQ(pinned.cpus, (std::vector<int>{process_cpus.back()}));
+    EXPECT_EQ(pinned.policy, SchedPolicy::Batch);
+    EXPECT_TRUE(pinned.error.empty()) << pinned.error;
+    EXPECT_EQ(unpinned.cpus, process_cpus);
+    EXPECT_EQ(unpinned.policy, SchedPolicy::Other);
+    EXPECT_TRUE(unpinned.error.empty()) << unpinned.error;
+}
+
+TEST_F(ThreadRegistryTest, ConfigureIsAllOrNothing) {
+    auto& registry = ThreadRegistry::instance();
+
+    EXPECT_TRUE(registry.configure("reactor.cores=0-2,5; reactor.policy=rr reactor.priority=7 "
+                                   "worker.cores=little"));
+    auto reactor = registry.getPolicy(ThreadRole::Reactor);
+    EXPECT_EQ(reactor.cpus, (std::vector<int>{0, 1, 2, 5}));
+    EXPECT_EQ(reactor.policy, SchedPolicy::RoundRobin);
+    EXPECT_EQ(reactor.priority, 7);
+    EXPECT_EQ(registry.getPolicy(ThreadRole::Worker).core_class, CoreClass::Little);
+
+    std::string error;
+    EXPECT_FALSE(registry.configure("worker.policy=idle gpu.cores=big", &error));
+    EXPECT_EQ(error, "gpu.cores=big");
+    EXPECT_EQ(registry.getPolicy(ThreadRole::Worker).policy, SchedPolicy::Inherit);
+
+    EXPECT_FALSE(registry.configure("worker.cores=3-1", &error));
+    EXPECT_FALSE(registry.configure("worker.priority=high", &error));
+}
+
+TEST_F(ThreadRegistryTest, ThreadsBuiltinListsRuntimeThreads) {
+    SessionManagerConfig config;
+    config.reactor_threads = 2;
+    config.worker_threads = 1;
+    config.thread_layout = "worker.policy=batch";
+    SessionManager manager(config);
+    ASSERT_TRUE(manager.initialize());
+    auto shell = manager.getSession(manager.createSession());
+
+    // Runtime threads register once they are scheduled
+    auto registered = [](const char* name) {
+        auto threads = ThreadRegistry::instance().snapshot();
+        return std::any_of(threads.begin(), threads.end(),
+                           [name](const ThreadEntry& e) { return e.name == name; });
+    };
+    for (int i = 0; i < 400 && !(registered("ct-reactor-1") && registered("ct-worker-0")); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::string output;
+    auto info = shell->executeSync("threads", ExecutionOptions());
+    shell->executeAsync("threads", ExecutionOptions(),
+        [&output](const std::string& data, bool) { output += data; }, nullptr);
+
+    EXPECT_EQ(info.exit_code, 0);
+    EXPECT_NE(output.find("ct-reactor-0"), std::string::npos);
+    EXPECT_NE(output.find("ct-reactor-1"), std::string::npos);
+    EXPECT_NE(output.find("ct-worker-0"), std::string::npos);
+    EXPECT_NE(output.find("batch"), std::string::npos);
+
+    auto rejected = shell->executeSync("threads set worker.cores=huge", ExecutionOptions());
+    EXPECT_NE(rejected.exit_code, 0);
+    manager.shutdown();
+
+    SessionManagerConfig invalid;
+    invalid.thread_layout = "reactor.policy=turbo";
+    SessionManager misconfigured(invalid);
+    EXPECT_FALSE(misconfigured.initialize());
+}
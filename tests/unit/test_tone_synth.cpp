@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "hardware/tone_synth.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+int zeroCrossings(const std::vector<int16_t>& samples, size_t begin, size_t end) {
+    int crossings = 0;
+    for (size_t i = begin + 1; i < end; ++i) {
+        crossings += (samples[i - 1] < 0) != (samples[i] < 0);
+    }
+    return crossings;
+}
+
+int peak(const std::vector<int16_t>& samples, size_t begin, size_t end) {
+    int largest = 0;
+    for (size_t i = begin; i < end; ++i) {
+        largest = std::max(largest, std::abs(static_cast<int>(samples[i])));
+    }
+    return largest;
+}
+
+} // namespace
+
+TEST(ToneSynthesizerTest, RendersFrequencyAndEnvelope) {
+    ToneSynthesizer synth(48000);
+    ToneSegment tone;
+    tone.frequency = 440.0f;
+    tone.durationMs = 500;
+    tone.amplitude = 0.5f;
+    std::vector<int16_t> samples;
+    synth.render({tone}, samples);
+    ASSERT_EQ(samples.size(), 24000u);
+
+    // 220 cycles, two crossings each
+    EXPECT_NEAR(zeroCrossings(samples, 0, samples.size()), 440, 2);
+    EXPECT_NEAR(peak(samples, 1000, 23000), 16383, 80);
+
+    // Ramped in and out instead of starting and stopping at full level
+    EXPECT_LT(std::abs(samples.front()), 200);
+    EXPECT_LT(std::abs(samples.back()), 200);
+    EXPECT_LT(peak(samples, 0, 24), 4000);
+
+    // Matches a reference sine once past the attack
+    for (size_t i = 1000; i < 1100; ++i) {
+        const double expected = 16383.5 * std::sin(2.0 * M_PI * 440.0 * i / 48000.0);
+        EXPECT_NEAR(samples[i], expected, 40) << "at sample " << i;
+    }
+}
+
+TEST(ToneSynthesizerTest, RendersSequencesWithRests) {
+    ToneSynthesizer synth(8000);
+    ToneSegment high;
+    high.frequency = 1000.0f;
+    high.durationMs = 100;
+    ToneSegment rest;
+    rest.durationMs = 50;
+    std::vector<int16_t> samples;
+    synth.render({high, rest, high}, samples);
+    ASSERT_EQ(samples.size(), 800u + 400u + 800u);
+    EXPECT_EQ(peak(samples, 800, 1200), 0);
+    EXPECT_GT(peak(samples, 0, 800), 10000);
+    EXPECT_GT(peak(samples, 1200, 2000), 10000);
+}
+
+TEST(PcmSinkTest, WritesWavFile) {
+    char path[] = "/tmp/ct_tone_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+    {
+        WavFileSink sink(path, 16000);
+        ASSERT_TRUE(sink.isOpen());
+        std::vector<int16_t> samples(1600, 1234);
+        EXPECT_TRUE(sink.write(samples.data(), samples.size()));
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    unlink(path);
+    ASSERT_EQ(bytes.size(), 44u + 3200u);
+    auto le32 = [&bytes](size_t at) {
+        return bytes[at] | bytes[at + 1] << 8 | bytes[at + 2] << 16 | bytes[at + 3] << 24;
+    };
+    EXPECT_EQ(std::string(bytes.begin(), bytes.begin() + 4), "RIFF");
+    EXPECT_EQ(le32(4), 36 + 3200);
+    EXPECT_EQ(le32(24), 16000);
+    EXPECT_EQ(le32(40), 3200);
+    EXPECT_EQ(bytes[44] | bytes[45] << 8, 1234);
+}
+
+TEST(TonePlayerTest, PlaysQueuedSequencesOnItsThread) {
+    auto* sink = new NullPcmSink(8000);
+    TonePlayer player{std::unique_ptr<PcmSink>(sink)};
+    ASSERT_TRUE(player.hasSink());
+
+    ToneSegment beep;
+    beep.frequency = 880.0f;
+    beep.durationMs = 100;
+    EXPECT_TRUE(player.play({beep}));
+    EXPECT_TRUE(player.play({beep, beep}));
+    player.wait();
+    EXPECT_EQ(sink->samplesWritten(), 3u * 800u);
+
+    ToneSegment ultrasonic;
+    ultrasonic.frequency = 5000.0f;   // Above Nyquist at 8 kHz
+    ultrasonic.durationMs = 10;
+    EXPECT_FALSE(player.play({ultrasonic}));
+    EXPECT_FALSE(player.play({}));
+
+    TonePlayer silent(nullptr);
+    EXPECT_FALSE(silent.hasSink());
+    EXPECT_FALSE(silent.play({beep}));
+}
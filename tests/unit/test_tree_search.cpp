@@ -0,0 +1,264 @@
+#include <gtest/gtest.h>
+#include "core/implementations/tree_search.h"
+#include "core/implementations/shell_impl.h"
+#include "fake_sysfs.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <fcntl.h>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace cross_terminal::core;
+
+namespace {
+
+// 3 directories of 30 files each, sizes 1 to 30 bytes plus the newline
+void populate(FakeSysfs& tree) {
+    for (int d = 0; d < 3; ++d) {
+        for (int f = 0; f < 30; ++f) {
+            tree.write("root/dir" + std::to_string(d) + "/deep/file" + std::to_string(f) + ".txt",
+                       std::string(f, 'x'));
+        }
+    }
+    tree.write("root/notes.md", "notes");
+    tree.link("root/link.txt", "root/notes.md");
+    tree.makeDirectory("root/empty");
+}
+
+std::vector<std::string> find(FsContext& fs, const FindOptions& options, TreeSearchResult* result = nullptr,
+                              const std::vector<std::string>& roots = {"root"}) {
+    TreeSearch search(fs, 4, 8);
+    std::vector<std::string> paths;
+    auto done = search.find(roots, options, [&paths](const std::vector<std::string>& batch) {
+        EXPECT_LE(batch.size(), 8u);
+        paths.insert(paths.end(), batch.begin(), batch.end());
+    });
+    if (result) {
+        *result = done;
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+uint64_t apparentSize(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+}
+
+} // namespace
+
+TEST(TreeSearchTest, FindsByNameAndTypeFromDirentsAlone) {
+    FakeSysfs tree;
+    populate(tree);
+    FsContext fs(tree.root());
+
+    FindOptions options;
+    options.name = "file2?.TXT";
+    options.ignore_case = true;
+    TreeSearchResult result;
+    auto paths = find(fs, options, &result);
+    ASSERT_TRUE(result.succeeded());
+    ASSERT_EQ(paths.size(), 30u);
+    EXPECT_EQ(paths[0], "root/dir0/deep/file20.txt");
+    EXPECT_EQ(result.metrics.directories, 8u);
+    EXPECT_EQ(result.metrics.entries, 99u);
+    EXPECT_EQ(result.metrics.stats, 0u);   // d_type said enough
+
+    options = {};
+    options.name = "*.txt";
+    options.type = FsEntryType::Symlink;
+    EXPECT_EQ(find(fs, options), std::vector<std::string>{"root/link.txt"});
+
+    options = {};
+    options.type = FsEntryType::Directory;
+    options.max_depth = 1;
+    EXPECT_EQ(find(fs, options, nullptr, {"root/"}),
+              (std::vector<std::string>{"root/", "root/dir0", "root/dir1", "root/dir2", "root/empty"}));
+    options.min_depth = 2;
+    options.max_depth = -1;
+    EXPECT_EQ(find(fs, options).size(), 3u);
+
+    find(fs, options, &result, {"missing"});
+    ASSERT_EQ(result.errors.size(), 1u);
+    EXPECT_EQ(result.errors[0], "cannot stat 'missing': No such file or directory");
+}
+
+TEST(TreeSearchTest, FindsBySizeAndAgeWithStat) {
+    FakeSysfs tree;
+    populate(tree);
+    FsContext fs(tree.root());
+
+    // Two days old
+    struct timespec times[2];
+    clock_gettime(CLOCK_REALTIME, &times[0]);
+    times[0].tv_sec -= 2 * 86400 + 60;
+    times[1] = times[0];
+    ASSERT_EQ(utimensat(AT_FDCWD, tree.path("root/dir1/deep/file3.txt").c_str(), times, 0), 0);
+
+    FindOptions options;
+    options.type = FsEntryType::Regular;
+    options.size_compare = FindOptions::Compare::Greater;
+    options.size = 28;
+    options.size_unit = 1;
+    TreeSearchResult result;
+    auto paths = find(fs, options, &result);
+    EXPECT_EQ(paths.size(), 6u);   // 29 and 30 bytes, in each directory
+    EXPECT_GT(result.metrics.stats, 90u);
+
+    options = {};
+    options.age_compare = FindOptions::Compare::Greater;
+    options.age = 1;
+    EXPECT_EQ(find(fs, options), std::vector<std::string>{"root/dir1/deep/file3.txt"});
+    options.age_compare = FindOptions::Compare::Equal;
+    options.age = 2;
+    EXPECT_EQ(find(fs, options).size(), 1u);
+    options.age_compare = FindOptions::Compare::Less;
+    options.age = 1;
+    EXPECT_EQ(find(fs, options).size(), 99u);   // Everything else, root and directories too
+}
+
+TEST(TreeSearchTest, SumsDiskUsageBottomUpCountingHardLinksOnce) {
+    FakeSysfs tree;
+    populate(tree);
+    ASSERT_EQ(link(tree.path("root/notes.md").c_str(), tree.path("root/dir0/notes.md").c_str()), 0);
+    FsContext fs(tree.root());
+    TreeSearch search(fs, 3, 2);
+
+    DiskUsageOptions options;
+    options.apparent_size = true;
+    std::map<std::string, uint64_t> totals;
+    auto collect = [&totals](const std::vector<DiskUsageEntry>& batch) {
+        for (const auto& entry : batch) {
+            totals[entry.path] = entry.bytes;
+        }
+    };
+    auto result = search.diskUsage({"root"}, options, collect);
+    ASSERT_TRUE(result.succeeded());
+    ASSERT_EQ(totals.size(), 8u);   // Directories only
+
+    uint64_t deep = apparentSize(tree.path("root/dir1/deep"));
+    for (int f = 0; f < 30; ++f) {
+        deep += f + 1;
+    }
+    EXPECT_EQ(totals["root/dir1/deep"], deep);
+    EXPECT_EQ(totals["root/dir1"], deep + apparentSize(tree.path("root/dir1")));
+    uint64_t expected = apparentSize(tree.path("root")) + apparentSize(tree.path("root/empty")) +
+                        6 + tree.path("root/notes.md").size();   // notes.md once; the link is its target
+    for (int d = 0; d < 3; ++d) {
+        expected += totals["root/dir" + std::to_string(d)];
+    }
+    EXPECT_EQ(totals["root"], expected);
+    EXPECT_EQ(totals["root/dir0"], totals["root/dir1"]);   // The second link is not counted
+
+    totals.clear();
+    options.all = true;
+    options.max_depth = 1;
+    search.diskUsage({"root", "root/notes.md"}, options, collect);
+    EXPECT_EQ(totals.size(), 7u);   // root, its 6 entries; notes.md is not counted again
+    EXPECT_EQ(totals["root/notes.md"], 6u);
+}
+
+TEST(TreeSearchTest, ShellFindAndDuStreamBatchesAndFallBack) {
+    FakeSysfs tree;
+    populate(tree);
+    ShellImpl shell;
+    ASSERT_TRUE(shell.setCurrentDirectory(tree.root()));
+
+    std::string output;
+    std::string errors;
+    auto collect = [&](const std::string& data, bool is_error) { (is_error ? errors : output) += data; };
+    int status = -1;
+    auto done = [&status](const ProcessInfo& info) { status = info.exit_code; };
+
+    shell.executeAsync("find root -name 'file1?.txt' -type f -size -12c", {}, collect, done);
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(std::count(output.begin(), output.end(), '\n'), 3);   // file10.txt, 11 bytes
+    EXPECT_NE(output.find("root/dir2/deep/file10.txt\n"), std::string::npos);
+
+    output.clear();
+    shell.executeAsync("du -sb root/dir0/deep", {}, collect, done);
+    EXPECT_EQ(status, 0);
+    const uint64_t deep = apparentSize(tree.path("root/dir0/deep")) + 465;
+    EXPECT_EQ(output, std::to_string(deep) + "\troot/dir0/deep\n");
+
+    shell.executeAsync("du -s missing", {}, collect, done);
+    EXPECT_EQ(status, 1);
+    EXPECT_EQ(errors, "du: cannot access 'missing': No such file or directory\n");
+
+    // Expressions the builtin lacks go to the real find
+    output.clear();
+    ProcessInfo info = shell.executeSync("find root -name notes.md -o -name link.txt");
+    EXPECT_EQ(info.exit_code, 0);
+    EXPECT_TRUE(output.empty());
+}
+
+TEST(TreeSearchTest, RuntimeShellRunsThemAsJobsOnTheSharedPool) {
+    FakeSysfs tree;
+    populate(tree);
+    auto reactor = std::make_shared<IoReactor>(1);
+    auto workers = std::make_shared<WorkerPool>(2);
+    ASSERT_TRUE(reactor->start());
+    ASSERT_TRUE(workers->start());
+    auto pool = std::make_shared<WorkStealingPool>(2);
+    ShellImpl shell(reactor, workers, pool);
+    ASSERT_TRUE(shell.setCurrentDirectory(tree.root()));
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::string found;
+    std::string usage;
+    std::map<int, ProcessInfo> finished;
+    auto done = [&](const ProcessInfo& info) {
+        std::lock_guard lock(mutex);
+        finished[info.pid] = info;
+        condition.notify_all();
+    };
+    auto waitForJobs = [&](size_t count) {
+        std::unique_lock lock(mutex);
+        return condition.wait_for(lock, std::chrono::seconds(5), [&]() { return finished.size() >= count; });
+    };
+
+    // Both workers are busy, so every walk queues and executeAsync() returns at once
+    std::promise<void> release;
+    std::shared_future<void> busy = release.get_future().share();
+    ASSERT_TRUE(workers->submit([busy]() { busy.wait(); }));
+    ASSERT_TRUE(workers->submit([busy]() { busy.wait(); }));
+    const int search = shell.executeAsync("find root -name 'file2?.txt'", {},
+        [&](const std::string& data, bool) { std::lock_guard lock(mutex); found += data; }, done);
+    const int total = shell.executeAsync("du -sb root/dir0/deep", {},
+        [&](const std::string& data, bool) { std::lock_guard lock(mutex); usage += data; }, done);
+    const int killed = shell.executeAsync("find root", {}, nullptr, done);
+    ASSERT_GT(search, 0);
+    ASSERT_GT(total, search);
+    ASSERT_GT(killed, total);
+    EXPECT_TRUE(shell.terminateProcess(killed));
+    ASSERT_TRUE(waitForJobs(1));
+    EXPECT_EQ(finished[killed].state, ProcessState::Terminated);
+    EXPECT_EQ(finished[killed].exit_code, SIGTERM);
+
+    // The find and du that run side by side on the pool each see only their own walk
+    release.set_value();
+    ASSERT_TRUE(waitForJobs(3));
+    EXPECT_EQ(finished[search].state, ProcessState::Completed);
+    EXPECT_EQ(finished[total].state, ProcessState::Completed);
+    EXPECT_EQ(std::count(found.begin(), found.end(), '\n'), 30);
+    EXPECT_EQ(usage, std::to_string(apparentSize(tree.path("root/dir0/deep")) + 465) + "\troot/dir0/deep\n");
+
+    // A cancel that lands before the walk starts is not lost
+    FsContext fs(tree.root());
+    TreeSearch cancelled(fs, pool);
+    cancelled.cancel();
+    EXPECT_TRUE(cancelled.find({"root"}, {}, nullptr).cancelled);
+
+    shell.shutdown();
+    workers->stop();
+    reactor->stop();
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "core/implementations/work_stealing_pool.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+using namespace cross_terminal::core;
+
+TEST(WorkStealingPoolTest, RunsRecursivelySpawnedTasksAcrossWorkers) {
+    WorkStealingPool pool(4);
+    ASSERT_EQ(pool.threadCount(), 4u);
+
+    // A binary tree of tasks, 2^12 leaves, spawned from a single root
+    std::atomic<int> leaves{0};
+    std::function<void(int)> branch = [&](int depth) {
+        if (depth == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+            leaves.fetch_add(1);
+            return;
+        }
+        pool.spawn([&branch, depth]() { branch(depth - 1); });
+        pool.spawn([&branch, depth]() { branch(depth - 1); });
+    };
+    pool.spawn([&branch]() { branch(12); });
+    pool.wait();
+
+    EXPECT_EQ(leaves.load(), 4096);
+    auto metrics = pool.getMetrics();
+    EXPECT_EQ(metrics.executed, 8191u);
+    EXPECT_GT(metrics.stolen, 0u);   // Only one deque had work to start with
+}
+
+TEST(WorkStealingPoolTest, WaitForTimesOutAndCancelDropsQueuedTasks) {
+    WorkStealingPool pool(1);
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    std::atomic<int> ran{0};
+    pool.spawn([&]() {
+        started.store(true);
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ran.fetch_add(1);
+    });
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 10; ++i) {
+        pool.spawn([&]() { ran.fetch_add(1); });
+    }
+    EXPECT_FALSE(pool.waitFor(20));
+
+    pool.cancel();
+    release.store(true);
+    EXPECT_TRUE(pool.waitFor(5000));
+    EXPECT_TRUE(pool.isCancelled());
+    EXPECT_EQ(ran.load(), 1);
+}